@@ -52,6 +52,7 @@ typedef enum CBErrors
    ERR_POR_PDR_RESET                                           = 0x00000009,
    ERR_PIN_RESET                                               = 0x0000000A,
    ERR_BOR_RESET                                               = 0x0000000B,
+   ERR_ETH_INIT_FAILED                                         = 0x0000000C,
 
    /* Memory error category                      0x00010000 - 0x0001FFFF */
    ERR_MEM_NULL_VALUE                                          = 0x00010000,
@@ -66,6 +67,8 @@ typedef enum CBErrors
    ERR_COMM_UNKNOWN_MSG_SOURCE                                 = 0x00040000,
    ERR_COMM_INVALID_MSG_LEN                                    = 0x00040001,
    ERR_COMM_UNIMPLEMENTED_MSG                                  = 0x00040002,
+   ERR_COMM_RPC_BUSY                                           = 0x00040003,
+   ERR_COMM_RPC_TIMEOUT                                        = 0x00040004,
 
    /* MENU error category                        0x00050000 - 0x0005FFFF */
    ERR_MENU_NODE_STORAGE_ALLOC_NULL                            = 0x00050000,
@@ -91,6 +94,12 @@ typedef enum CBErrors
    ERR_I2CBUS_RXNE_FLAG_TIMEOUT                                = 0x0006000D,
    ERR_I2CBUS_STOP_BIT_TIMEOUT                                 = 0x0006000E,
    ERR_I2CBUS_WRITE_BYTE_TIMEOUT                               = 0x0006000F,
+   ERR_I2CBUS_INVALID_XFER                                     = 0x00060010,
+   ERR_I2CBUS_NACK                                             = 0x00060011,
+   ERR_I2CBUS_BUS_ERROR                                        = 0x00060012,
+   ERR_I2CBUS_ARB_LOST                                         = 0x00060013,
+   ERR_I2CBUS_OVERRUN                                          = 0x00060014,
+   ERR_I2CBUS_XFER_TIMEOUT                                     = 0x00060015,
 
    /* I2C1Dev error category                     0x00070000 - 0x0007FFFF */
    ERR_I2C1DEV_CHECK_BUS_TIMEOUT                               = 0x00070000,
@@ -110,11 +119,32 @@ typedef enum CBErrors
    ERR_DB_VER_MISMATCH                                         = 0x00080001,
    ERR_DB_ELEM_NOT_FOUND                                       = 0x00080002,
    ERR_DB_ELEM_IS_READ_ONLY                                    = 0x00080003,
+   ERR_DB_WRONG_ACCESS_TYPE                                    = 0x00080004,
+   ERR_DB_NO_SPACE                                             = 0x00080005,
+   ERR_DB_BUSY                                                 = 0x00080006,
 
    /* I2C Device general error category           0x00090000 - 0x0009FFFF */
    ERR_I2C_DEV_INVALID_DEVICE                                  = 0x00090000,
    ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY                        = 0x00090001,
    ERR_I2C_DEV_IS_READ_ONLY                                    = 0x00090002,
+   ERR_I2C_DEV_REPLY_TIMEOUT                                   = 0x00090003,
+
+   /* Application image error category            0x000A0000 - 0x000AFFFF */
+   ERR_APP_IMG_NOT_FOUND                                       = 0x000A0000,
+   ERR_APP_IMG_BAD_VECTORS                                     = 0x000A0001,
+   ERR_APP_IMG_CRC_MISMATCH                                    = 0x000A0002,
+   ERR_APP_IMG_MARK_WRITE_FAILED                               = 0x000A0003,
+   ERR_APP_IMG_LAUNCH_HELD                                     = 0x000A0004,
+
+   /* Ethernet simulator error category           0x000B0000 - 0x000BFFFF */
+   ERR_ETH_SIM_RX_STOPPED                                      = 0x000B0000,
+   ERR_ETH_SIM_NO_RX_DESC                                      = 0x000B0001,
+   ERR_ETH_SIM_FRAME_TOO_BIG                                   = 0x000B0002,
+   ERR_ETH_SIM_PCAP_OPEN_FAILED                                = 0x000B0003,
+   ERR_ETH_SIM_PCAP_BAD_FORMAT                                 = 0x000B0004,
+   ERR_ETH_SIM_PCAP_END                                        = 0x000B0005,
+   ERR_ETH_SIM_PCAP_IO                                         = 0x000B0006,
+   ERR_ETH_SIM_TCP_NOT_READY                                   = 0x000B0007,
 
    /* Reserved errors                            0xFFFFFFFE - 0xFFFFFFFF */
    ERR_UNIMPLEMENTED                                           = 0xFFFFFFFE,
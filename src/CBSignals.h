@@ -36,6 +36,9 @@ enum FirstSignal {
 enum CommStackSignals {
    MSG_SEND_OUT_SIG = FIRST_SIG, /** This signal must start at the previous category max signal */
    MSG_RECEIVED_SIG,
+   MSG_FRAME_RECEIVED_SIG,
+   MSG_RPC_DONE_SIG,
+   MSG_RPC_TIMER_SIG,
    TIME_TEST_SIG,
    MSG_MAX_SIG,
 };
@@ -48,6 +51,7 @@ enum SerialMgrSignals {
    UART_DMA_DONE_SIG,
    UART_DMA_TIMEOUT_SIG,
    UART_DMA_DBG_TOGGLE_SIG,
+   UART_DMA_B64_START_SIG,
    UART_DMA_MAX_SIG
 };
 
@@ -55,18 +59,7 @@ enum SerialMgrSignals {
  * @enum Signals used by I2CMgr
  */
 enum I2CMgrSignals {
-   I2C_READ_START_SIG = UART_DMA_MAX_SIG, /** This signal must start at the previous category max signal */
-   I2C_READ_DONE_SIG,
-   I2C_WRITE_START_SIG,
-   I2C_WRITE_DONE_SIG,
-   I2C_TIMEOUT_SIG,
-   I2C_CHECK_EV_SIG,
-   I2C_DMA_TIMEOUT_SIG,
-   I2C_EV_MASTER_MODE_SELECT_SIG,
-   I2C_EV_MASTER_TX_MODE_SELECTED_SIG,
-   I2C_SENT_MSB_ADDR_SIG,
-   I2C_SENT_LSB_ADDR_SIG,
-   I2C_RECOVERY_TIMEOUT_SIG,
+   I2C_CHECK_EV_SIG = UART_DMA_MAX_SIG, /** This signal must start at the previous category max signal */
    I2C_MAX_SIG
 };
 
@@ -79,42 +72,32 @@ enum I2CBusMgrSignals {
    I2C_BUS_GLOBAL_TOUT_SIG,
    I2C_BUS_OP_TOUT_SIG,
    I2C_BUS_SETTLE_TIMER_SIG,
-   I2C_BUS_START_BIT_SIG,
-   I2C_BUS_STOP_BIT_SIG,
-   I2C_BUS_SELECT_MASTER_SIG,
-   I2C_BUS_SET_DIR_TX,
-   I2C_BUS_SET_DIR_RX,
-   I2C_BUS_SEND_7BIT_ADDR_SIG,
-   I2C_BUS_SEND_10BIT_ADDR_SIG,
-   I2C_BUS_SEND_DEV_ADDR_SIG,
-   I2C_BUS_READ_MEM_SIG,
-   I2C_BUS_WRITE_MEM_SIG,
-   I2C_BUS_DMA_DONE_SIG,
-   I2C_BUS_ACK_EN_SIG,
-   I2C_BUS_ACK_DIS_SIG,
+   I2C_BUS_XFER_SIG,
+   I2C_BUS_XFER_DONE_SIG,
    I2C_BUS_DONE_SIG,
    I2C_BUS_MAX_SIG
 };
 
 /**
- * @enum Signals used by I2C1DevMgr
+ * @enum Signals used by I2CDevMgr
  */
-enum I2C1DevMgrSignals {
-   I2C1_DEV_TIMEOUT_SIG = I2C_BUS_MAX_SIG, /** This signal must start at the previous category max signal */
-   I2C1_DEV_OP_TIMEOUT_SIG,
-   I2C1_DEV_RAW_MEM_READ_SIG,
-   I2C1_DEV_RAW_MEM_WRITE_SIG,
-   I2C1_DEV_POST_WRITE_TIMER_SIG,
-   I2C1_DEV_READ_DONE_SIG,
-   I2C1_DEV_WRITE_DONE_SIG,
-   I2C1_DEV_MAX_SIG
+enum I2CDevMgrSignals {
+   I2C_DEV_TIMEOUT_SIG = I2C_BUS_MAX_SIG, /** This signal must start at the previous category max signal */
+   I2C_DEV_OP_TIMEOUT_SIG,
+   I2C_DEV_RAW_MEM_READ_SIG,
+   I2C_DEV_RAW_MEM_WRITE_SIG,
+   I2C_DEV_POST_WRITE_TIMER_SIG,
+   I2C_DEV_READ_DONE_SIG,
+   I2C_DEV_WRITE_DONE_SIG,
+   I2C_DEV_CANCEL_SIG,
+   I2C_DEV_MAX_SIG
 };
 
 /**
  * @enum Signals used by DbgMgr
  */
 enum DbgMgrSignals {
-   DBG_MENU_REQ_SIG = I2C1_DEV_MAX_SIG, /** This signal must start at the previous category max signal */
+   DBG_MENU_REQ_SIG = I2C_DEV_MAX_SIG, /** This signal must start at the previous category max signal */
    DBG_LOG_SIG,
    DBG_MENU_SIG,
    DBG_MAX_SIG
@@ -130,6 +113,10 @@ enum CplrSignals {
    /* ... insert signals here */
    /* Signals that use the EthEvt type event tag - end */
 
+   /* Signals that use the CommRpcEvt type event tag - start */
+   CPLR_RPC_REQ_SIG,
+   /* Signals that use the CommRpcEvt type event tag - end */
+
    CPLR_MAX_SIG
 };
 
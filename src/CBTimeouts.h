@@ -64,10 +64,11 @@
    #define LL_MAX_TOUT_SEC_I2C_MEM_WRITE        ( LL_MAX_TOUT_SEC_I2C_BASIC_OP * 3 )
    #define LL_MAX_TOUT_SEC_I2C_READ_OP          ( LL_MAX_TOUT_SEC_I2C_BASIC_OP * 4 )
    #define LL_MAX_TOUT_SEC_I2C_WRITE_OP         ( LL_MAX_TOUT_SEC_I2C_BASIC_OP * 4 )
+   #define LL_MAX_TOUT_SEC_I2C_XFER             ( LL_MAX_TOUT_SEC_I2C_BASIC_OP )      /**< Whole ISR driven transfer */
    /*@} I2C Timeouts */
 
    /** \name I2C Dev Timeouts and Times.
-    * These are the timeouts used by the higher level I2C1DevMgr AO.
+    * These are the timeouts used by the higher level I2CDevMgr AO.
     * These should be based on the LL I2CBusMgr timeouts.
     *@{*/
    #define HL_MAX_TOUT_SEC_I2C_DEV_OP                                         0.3
@@ -79,6 +80,7 @@
    #define HL_MAX_TOUT_SEC_I2C_READ             ( HL_MAX_TOUT_SEC_I2C_DEV_OP * 1.3 )
    #define HL_MAX_TOUT_SEC_I2C_WRITE            ( HL_MAX_TOUT_SEC_I2C_DEV_OP * 3 )
    #define HL_MAX_TIME_MS_I2C_POST_WRITE                                      5.0 // 5ms post write wait on the I2C EEPROM.
+   #define HL_MAX_TOUT_SEC_I2C_FRT_WAIT         ( HL_MAX_TOUT_SEC_I2C_DEV_REQ * 2 )   /**< FreeRTOS thread waiting for a reply.  Covers a request queued behind another */
    /*@} I2C1Dev Timeouts and Times. */
 
    /** \name ETH Timeouts and Times.
@@ -74,7 +74,9 @@ enum AO_Priorities {
    DBG_MGR_PRIORITY,                             /**< Priority of MenuMgr AO. */
    COMM_MGR_PRIORITY,                       /**< Priority of CommStackMgr AO. */
 
-   I2C1DEVMGR_PRIORITY,                       /**< Priority of I2C1DevMgr AO. */
+   I2CDEVMGR_PRIORITY,                        /**< Priority of I2CDevMgr AO. */
+   /* Same as for I2CBUS1MGR_PRIORITY below.  There is one I2CDevMgr AO per I2C
+    * bus and they take up consecutive priorities starting here. */
    SERIAL_MGR_PRIORITY,                        /**< Priority of SerialMgr AO. */
 
 
@@ -38,11 +38,12 @@
 #include "CommStackMgr.h"
 #include "project_includes.h"           /* Includes common to entire project. */
 #include "bsp.h"                              /* For time to ticks conversion */
-#include "I2C1DevMgr.h"                                  /* For I2C Evt types */
+#include "I2CDevMgr.h"                                   /* For I2C Evt types */
 #include "time.h"
 #include "stm32f4x7_eth.h"
 #include "nor.h"
 #include "menu.h"
+#include "comm.h"                             /* For binary frame dispatch */
 /* Compile-time called macros ------------------------------------------------*/
 Q_DEFINE_THIS_FILE;                 /* For QSPY to know the name of this file */
 DBG_DEFINE_THIS_MODULE( DBG_MODL_COMM );/* For debug system to ID this module */
@@ -61,6 +62,9 @@ typedef struct {
 
     /**< Local timer for testing the clock. */
     QTimeEvt timeTestTimerEvt;
+
+    /**< Periodic timer used to time out pending requests. */
+    QTimeEvt rpcTimerEvt;
 } CommStackMgr;
 
 /* protected: */
@@ -110,6 +114,7 @@ void CommStackMgr_ctor(void) {
     CommStackMgr *me = &l_CommStackMgr;
     QActive_ctor(&me->super, (QStateHandler)&CommStackMgr_initial);
     QTimeEvt_ctor(&me->timeTestTimerEvt, TIME_TEST_SIG);
+    QTimeEvt_ctor(&me->rpcTimerEvt, MSG_RPC_TIMER_SIG);
 }
 
 /**
@@ -128,7 +133,9 @@ static QState CommStackMgr_initial(CommStackMgr * const me, QEvt const * const e
 
     QActive_subscribe((QActive *)me, MSG_SEND_OUT_SIG);
     QActive_subscribe((QActive *)me, MSG_RECEIVED_SIG);
+    QActive_subscribe((QActive *)me, MSG_FRAME_RECEIVED_SIG);
     QActive_subscribe((QActive *)me, TIME_TEST_SIG);
+
     return Q_TRAN(&CommStackMgr_Active);
 }
 
@@ -154,6 +161,13 @@ static QState CommStackMgr_Active(CommStackMgr * const me, QEvt const * const e)
                 (QActive *)me,
                 SEC_TO_TICKS( 5 )
             );
+
+            /* Check for binary requests that are taking too long */
+            QTimeEvt_postEvery(
+                &me->rpcTimerEvt,
+                (QActive *)me,
+                MS_TO_TICKS( COMM_RPC_TICK_MS )
+            );
             status_ = Q_HANDLED();
             break;
         }
@@ -168,75 +182,31 @@ static QState CommStackMgr_Active(CommStackMgr * const me, QEvt const * const e)
             status_ = Q_HANDLED();
             break;
         }
+        /* ${AOs::CommStackMgr::SM::Active::MSG_FRAME_RECEIVED} */
+        case MSG_FRAME_RECEIVED_SIG: {
+            COMM_dispatchFrame((CommFrameEvt const *)e);
+            status_ = Q_HANDLED();
+            break;
+        }
+        /* ${AOs::CommStackMgr::SM::Active::MSG_RPC_DONE, I2C_DEV_READ_DONE, I2C_DEV_WRITE_DONE} */
+        case MSG_RPC_DONE_SIG: /* intentionally fall through */
+        case I2C_DEV_READ_DONE_SIG: /* intentionally fall through */
+        case I2C_DEV_WRITE_DONE_SIG: {
+            COMM_handleRpcDone(e);
+            status_ = Q_HANDLED();
+            break;
+        }
+        /* ${AOs::CommStackMgr::SM::Active::MSG_RPC_TIMER} */
+        case MSG_RPC_TIMER_SIG: {
+            COMM_expireRpcs();
+            status_ = Q_HANDLED();
+            break;
+        }
         /* ${AOs::CommStackMgr::SM::Active::TIME_TEST} */
         case TIME_TEST_SIG: {
             DBG_printf("I2C write/read test\n");
 
 
-            /* Create event to request i2c data and publish it. */
-
-            /* Write some data to the i2c EEPROM.  Note that after each write,
-             * there's a 5ms write time delay on the eeprom.  The I2CMgr AO doesn't
-             * handle that since it's device specific and will be handled by the
-             * AO that handles the I2CBus1 devices. */
-
-            /*
-            I2CMemReadReqEvt *i2cMemReadReqEvt = Q_NEW(I2CMemReadReqEvt, EEPROM_RAW_MEM_READ_SIG);
-            i2cMemReadReqEvt->addr = 0x00;
-            i2cMemReadReqEvt->bytes  = 10;
-            QF_PUBLISH((QEvent *)i2cMemReadReqEvt, AO_CommStackMgr);
-            */
-            /*
-            I2CDataEvt *i2cDataEvt = Q_NEW(I2CDataEvt, I2C_WRITE_START_SIG);
-            i2cDataEvt->i2cDevice = EEPROM;
-            i2cDataEvt->wAddr = 0x00;
-            i2cDataEvt->wDataLen  = 17;
-            i2cDataEvt->bufData[0] = 0x00;
-            i2cDataEvt->bufData[1] = 0x01;
-            i2cDataEvt->bufData[2] = 0x02;
-            i2cDataEvt->bufData[3] = 0x03;
-            i2cDataEvt->bufData[4] = 0x04;
-            i2cDataEvt->bufData[5] = 0x05;
-            i2cDataEvt->bufData[6] = 0x06;
-            i2cDataEvt->bufData[7] = 0x07;
-            i2cDataEvt->bufData[8] = 0x08;
-            i2cDataEvt->bufData[9] = 0x09;
-            i2cDataEvt->bufData[10] =0x0A;
-            i2cDataEvt->bufData[11] =0x0B;
-            i2cDataEvt->bufData[12] =0x0C;
-            i2cDataEvt->bufData[13] =0x0D;
-            i2cDataEvt->bufData[14] =0x0E;
-            i2cDataEvt->bufData[15] =0x0F;
-            i2cDataEvt->bufData[16] =0x10;
-            QF_PUBLISH((QEvent *)i2cDataEvt, AO_CommStackMgr);
-            */
-
-            /*
-            I2CDataEvt *i2cDataEvt1 = Q_NEW(I2CDataEvt, I2C_WRITE_START_SIG);
-            i2cDataEvt1->i2cDevice = EEPROM;
-            i2cDataEvt1->wAddr = 0x00;
-            i2cDataEvt1->wDataLen  = 2;
-            i2cDataEvt1->bufData[0] = 0x00;
-            i2cDataEvt1->bufData[1] = 0x01;
-            QF_PUBLISH((QEvent *)i2cDataEvt1, AO_CommStackMgr);
-            */
-
-            /*
-            I2CEvt *i2cEvt = Q_NEW(I2CEvt, I2C_READ_START_SIG);
-            i2cEvt->i2cDevice = EEPROM;
-            i2cEvt->wAddr = 0x00;
-            i2cEvt->wDataLen  = 20;
-            QF_PUBLISH((QEvent *)i2cEvt, AO_CommStackMgr);
-
-
-
-            I2CEvt *i2cEvt1 = Q_NEW(I2CEvt, I2C_READ_START_SIG);
-            i2cEvt1->i2cDevice = SN_ROM;
-            i2cEvt1->wAddr = 0x80;
-            i2cEvt1->wDataLen  = 16;
-            QF_PUBLISH((QEvent *)i2cEvt1, AO_CommStackMgr);
-            */
-
             /*
             DBG_printf("Starting destructive NOR Flash test\n");
             NOR_TestDestructive();
@@ -249,8 +219,6 @@ static QState CommStackMgr_Active(CommStackMgr * const me, QEvt const * const e)
             DBG_printf("Finished destructive SDRAM test\n");
             */
 
-            /* KTREE_fakeMenuTest(); */
-
             /*
             DBG_printf("Starting SDRAM/NOR interation test\n");
             NOR_SDRAMTestInteraction();
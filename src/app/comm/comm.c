@@ -1,6 +1,7 @@
 /**
  * @file    comm.c
- * @brief   Parser for various messages that come over any communication busses.
+ * @brief   Handlers for the binary command frames that come over any
+ *          communication busses.
  *
  * @date    09/29/2014
  * @author  Harry Rostovtsev
@@ -15,97 +16,481 @@
 #include "comm.h"
 #include "qp_port.h"                                        /* for QP support */
 #include "project_includes.h"
+#include "CommStackMgr.h"                            /* For AO_CommStackMgr */
+#include "LWIPMgr.h"                             /* For ETH_SYS_TCP_SEND_SIG */
+#include "I2CDevMgr.h"                                   /* For I2C Evt types */
+#include "i2c_dev.h"                                 /* For I2C functionality */
+#include "cplr.h"  /* for access to the raw queue used to talk to CPLR task */
 
 /* Compile-time called macros ------------------------------------------------*/
 Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
 DBG_DEFINE_THIS_MODULE( DBG_MODL_COMM );/* For debug system to ID this module */
 
 /* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * @brief Handler for a single frame type.
+ * @param [in] *e: CommFrameEvt pointer to the received frame.
+ * @param [in] tag: uint16_t tag of the pending request for this frame.
+ * @return: CBErrorCode.  Anything other than ERR_NONE is sent back as a NAK.
+ * On success the handler is responsible for eventually finishing the request,
+ * either by calling COMM_completeRpc() right away or by passing the tag to
+ * whoever will call COMM_postRpcDone() later.
+ */
+typedef CBErrorCode (*CommFrameCmdHandler)(
+      CommFrameEvt const *e,
+      uint16_t tag
+);
+
+/**
+ * \struct CommRpcSlot_t
+ * A single entry of the pending request table.
+ */
+typedef struct CommRpcSlot {
+   uint16_t tag;          /**< Tag of the request or COMM_RPC_TAG_NONE if free */
+   uint16_t seq;                      /**< Sequence number of the request */
+   uint8_t  type;                              /**< Type of the request */
+   MsgSrc   src;                        /**< Where to send the response */
+   uint16_t ticks;       /**< Number of COMM_RPC_TICK_MS it's been pending */
+} CommRpcSlot_t;
+
 /* Private defines -----------------------------------------------------------*/
+
+/**< Low bits of a tag that pick the slot in the pending request table */
+#define COMM_RPC_SLOT_MASK                         (COMM_RPC_MAX_PENDING - 1)
+
+/**< Bit mask with a bit set for every slot of the pending request table */
+#define COMM_RPC_ALL_SLOTS       (0xFFFFFFFFUL >> (32 - COMM_RPC_MAX_PENDING))
+
+/**< Number of COMM_RPC_TICK_MS after which a pending request is NAKed */
+#define COMM_RPC_TIMEOUT_TICKS          (COMM_RPC_TIMEOUT_MS / COMM_RPC_TICK_MS)
+
+/**< Size of the I2C_READ request payload: dev (1), offset (2), len (2) */
+#define COMM_I2C_READ_REQ_LEN                                                5
+
+/**< Size of the I2C_WRITE request header: dev (1), offset (2) */
+#define COMM_I2C_WRITE_HDR_LEN                                               3
+
 /* Private macros ------------------------------------------------------------*/
-/* Private variables and Local objects ---------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Handle COMM_FRAME_TYPE_PING by echoing the payload back.
+ * @param [in] *e: CommFrameEvt pointer to the received frame.
+ * @param [in] tag: uint16_t tag of the pending request.
+ * @return: CBErrorCode ERR_NONE
+ */
+static CBErrorCode COMM_handlePing( CommFrameEvt const *e, uint16_t tag );
+
+/**
+ * @brief   Handle the requests that run in the coupler task.
+ *
+ * Copies the payload into a CommRpcEvt and queues it for the CPLR task, which
+ * sends the response back with COMM_postRpcDone() once it's done.
+ *
+ * @param [in] *e: CommFrameEvt pointer to the received frame.
+ * @param [in] tag: uint16_t tag of the pending request.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: if the request was queued
+ *    @arg ERR_COMM_RPC_BUSY: the task's queue is full
+ */
+static CBErrorCode COMM_handleCplrReq( CommFrameEvt const *e, uint16_t tag );
+
+/**
+ * @brief   Handle COMM_FRAME_TYPE_I2C_READ.
+ *
+ * Payload is dev (1), offset (2), and number of bytes to read (2).  The read
+ * is queued up with the I2CDevMgr AO and the response carries the data.
+ *
+ * @param [in] *e: CommFrameEvt pointer to the received frame.
+ * @param [in] tag: uint16_t tag of the pending request.
+ * @return: CBErrorCode status of issuing the read.
+ */
+static CBErrorCode COMM_handleI2CRead( CommFrameEvt const *e, uint16_t tag );
+
+/**
+ * @brief   Handle COMM_FRAME_TYPE_I2C_WRITE.
+ *
+ * Payload is dev (1) and offset (2) followed by the data to write.  The write
+ * is queued up with the I2CDevMgr AO and the response carries the number of
+ * bytes written (2).
+ *
+ * @param [in] *e: CommFrameEvt pointer to the received frame.
+ * @param [in] tag: uint16_t tag of the pending request.
+ * @return: CBErrorCode status of issuing the write.
+ */
+static CBErrorCode COMM_handleI2CWrite( CommFrameEvt const *e, uint16_t tag );
+
+/**
+ * @brief   Give a received frame a slot in the pending request table.
+ * @param [in] *e: CommFrameEvt pointer to the received frame.
+ * @return: uint16_t tag of the new pending request or COMM_RPC_TAG_NONE if
+ * the table is full.
+ */
+static uint16_t COMM_startRpc( CommFrameEvt const *e );
+
+/**
+ * @brief   Find the pending request a tag names.
+ * @param [in] tag: uint16_t tag to look up.
+ * @return: CommRpcSlot_t pointer to the slot or NULL if the request is no
+ * longer pending.
+ */
+static CommRpcSlot_t* COMM_findRpc( uint16_t tag );
+
+/**
+ * @brief   Send a NAK frame with a CBErrorCode as the payload.
+ * @param [in] dst: MsgSrc where to send the frame.
+ * @param [in] seq: uint16_t sequence number of the request being NAKed.
+ * @param [in] status: CBErrorCode reason for the NAK.
+ * @return: None
+ */
+static void COMM_sendNak( MsgSrc dst, uint16_t seq, CBErrorCode status );
+
+/* Private variables and Local objects ---------------------------------------*/
+
+/**< Frame handlers indexed by CommFrameType_t.  NULL entries are unimplemented. */
+static const CommFrameCmdHandler comm_frameHandlers[COMM_FRAME_TYPE_MAX] = {
+   [COMM_FRAME_TYPE_PING]      = COMM_handlePing,
+   [COMM_FRAME_TYPE_CPLR_TEST] = COMM_handleCplrReq,
+   [COMM_FRAME_TYPE_I2C_READ]  = COMM_handleI2CRead,
+   [COMM_FRAME_TYPE_I2C_WRITE] = COMM_handleI2CWrite,
+   [COMM_FRAME_TYPE_NOR_READ]  = COMM_handleCplrReq,
+};
+
+static CommRpcSlot_t  comm_rpcSlots[COMM_RPC_MAX_PENDING]; /**< Pending table */
+static uint32_t       comm_rpcFreeSlots = COMM_RPC_ALL_SLOTS;/**< 1 = free slot */
+static uint16_t       comm_rpcNextTag;  /**< Bumped for every new request */
+static CommRpcStats_t comm_rpcStats;          /**< Pending table counters */
+
 /* Private functions ---------------------------------------------------------*/
 
 /******************************************************************************/
-CBErrorCode COMM_parseMsg( uint8_t *pBuffer, uint16_t bufferLen, MsgSrc msgSource )
+static CBErrorCode COMM_handlePing( CommFrameEvt const *e, uint16_t tag )
 {
-   CBErrorCode status = ERR_NONE; /* Clear initial error and set it if it happens */
-
-   if ( SERIAL_CON == msgSource ) {
-      /* The message originated from the serial console.  Based on that
-       * information we can assume:
-       * A. It's plain text
-       * B. It has to be a menu command of some sort
-       */
-      switch( bufferLen ) {
-         case 1:
-            if ( pBuffer[0] == '?') {
-
-            } else {
-               status = ERR_COMM_UNIMPLEMENTED_MSG;
-               WRN_printf(
-                     "ErrCode 0x%08x: ERR_COMM_UNIMPLEMENTED_MSG (%c) from source: %d\n",
-                     status,
-                     pBuffer[0],
-                     msgSource
-               );
-            }
-
-            break;
-         case 0:
-         default:
-            status = ERR_COMM_INVALID_MSG_LEN;
-            WRN_printf(
-                  "ErrCode 0x%08x: Ignoring message of 0 len from source: %d\n",
-                  status,
-                  msgSource
-            );
-            //TODO: error handle better here. maybe write it to the EEPROM?
+   COMM_completeRpc( tag, ERR_NONE, e->dataBuf, e->dataLen );
+   return( ERR_NONE );
+}
 
-            break;
+/******************************************************************************/
+static CBErrorCode COMM_handleCplrReq( CommFrameEvt const *e, uint16_t tag )
+{
+   CommRpcEvt *rpcEvt = Q_NEW( CommRpcEvt, CPLR_RPC_REQ_SIG );
+   rpcEvt->tag     = tag;
+   rpcEvt->type    = e->type;
+   rpcEvt->status  = ERR_NONE;
+   rpcEvt->dataLen = e->dataLen;
+   MEMCPY( rpcEvt->dataBuf, e->dataBuf, e->dataLen );
+
+   /* Post directly to the "raw" queue for FreeRTOS task to read.  Leave one
+    * spot free for a reply the task may be waiting on from an AO. */
+   if ( !QEQueue_post( &CPLR_evtQueue, (QEvt *)rpcEvt, 1 ) ) {
+      QF_gc( (QEvt *)rpcEvt );
+      return( ERR_COMM_RPC_BUSY );
+   }
+   CPLR_wake();
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+static CBErrorCode COMM_handleI2CRead( CommFrameEvt const *e, uint16_t tag )
+{
+   if ( COMM_I2C_READ_REQ_LEN != e->dataLen ) {
+      return( ERR_COMM_INVALID_MSG_LEN );
+   }
+
+   uint16_t offset = e->dataBuf[1] | (e->dataBuf[2] << 8);
+   uint16_t bytes  = e->dataBuf[3] | (e->dataBuf[4] << 8);
+   if ( bytes > MAX_I2C_READ_LEN ) {
+      return( ERR_COMM_INVALID_MSG_LEN );
+   }
+
+   return(
+         I2C_readDevMemEVT(
+               (I2C_Dev_t)e->dataBuf[0],                  // I2C_Dev_t iDev,
+               offset,                                    // uint16_t offset,
+               bytes,                                     // uint16_t bytesToRead,
+               ACCESS_QPC,                                // AccessType_t accType,
+               AO_CommStackMgr,                           // QActive* callingAO
+               NULL,                                      // uint8_t *pBuffer
+               tag                                        // uint16_t tag
+         )
+   );
+}
+
+/******************************************************************************/
+static CBErrorCode COMM_handleI2CWrite( CommFrameEvt const *e, uint16_t tag )
+{
+   if ( e->dataLen <= COMM_I2C_WRITE_HDR_LEN
+         || e->dataLen - COMM_I2C_WRITE_HDR_LEN > MAX_I2C_WRITE_LEN ) {
+      return( ERR_COMM_INVALID_MSG_LEN );
+   }
+
+   return(
+         I2C_writeDevMemEVT(
+               (I2C_Dev_t)e->dataBuf[0],                  // I2C_Dev_t iDev,
+               e->dataBuf[1] | (e->dataBuf[2] << 8),      // uint16_t offset,
+               e->dataLen - COMM_I2C_WRITE_HDR_LEN,       // uint16_t bytesToWrite,
+               ACCESS_QPC,                                // AccessType_t accType,
+               AO_CommStackMgr,                           // QActive* callingAO
+               (uint8_t *)&e->dataBuf[COMM_I2C_WRITE_HDR_LEN],// uint8_t *pBuffer
+               tag                                        // uint16_t tag
+         )
+   );
+}
+
+/******************************************************************************/
+static uint16_t COMM_startRpc( CommFrameEvt const *e )
+{
+   if ( 0 == comm_rpcFreeSlots ) {
+      comm_rpcStats.nBusy++;
+      return( COMM_RPC_TAG_NONE );
+   }
+
+   /* Lowest free slot.  The upper bits of the tag count up with every request
+    * so a late answer to an old request can't be mistaken for an answer to a
+    * new request that got the same slot. */
+   uint8_t idx = (uint8_t)__builtin_ctz( comm_rpcFreeSlots );
+   uint16_t tag;
+   do {
+      comm_rpcNextTag += COMM_RPC_MAX_PENDING;
+      tag = comm_rpcNextTag | idx;
+   } while ( COMM_RPC_TAG_NONE == tag );
+
+   CommRpcSlot_t *slot = &comm_rpcSlots[idx];
+   slot->tag   = tag;
+   slot->seq   = e->seq;
+   slot->type  = e->type;
+   slot->src   = e->src;
+   slot->ticks = 0;
+
+   comm_rpcFreeSlots &= ~(1UL << idx);
+   comm_rpcStats.nStarted++;
+   if ( ++comm_rpcStats.nPending > comm_rpcStats.maxPending ) {
+      comm_rpcStats.maxPending = comm_rpcStats.nPending;
+   }
+   return( tag );
+}
+
+/******************************************************************************/
+static CommRpcSlot_t* COMM_findRpc( uint16_t tag )
+{
+   CommRpcSlot_t *slot = &comm_rpcSlots[tag & COMM_RPC_SLOT_MASK];
+   if ( COMM_RPC_TAG_NONE == tag || slot->tag != tag ) {
+      return( NULL );
+   }
+   return( slot );
+}
+
+/******************************************************************************/
+static void COMM_sendNak( MsgSrc dst, uint16_t seq, CBErrorCode status )
+{
+   uint8_t nak[sizeof(uint32_t)] = {
+         (uint8_t)status,
+         (uint8_t)(status >> 8),
+         (uint8_t)(status >> 16),
+         (uint8_t)(status >> 24)
+   };
+   COMM_sendFrame( dst, COMM_FRAME_TYPE_NAK, seq, nak, sizeof(nak) );
+}
+
+/******************************************************************************/
+CBErrorCode COMM_dispatchFrame( CommFrameEvt const *e )
+{
+   CBErrorCode status = ERR_COMM_UNIMPLEMENTED_MSG;
+
+   if ( e->type < COMM_FRAME_TYPE_MAX
+         && NULL != comm_frameHandlers[ e->type ] ) {
+      uint16_t tag = COMM_startRpc( e );
+      if ( COMM_RPC_TAG_NONE == tag ) {
+         /* The client has too many requests in flight.  Don't log this since
+          * it happens at link rate and the client is expected to back off. */
+         COMM_sendNak( e->src, e->seq, ERR_COMM_RPC_BUSY );
+         return( ERR_COMM_RPC_BUSY );
       }
 
+      status = comm_frameHandlers[ e->type ]( e, tag );
+      if ( ERR_NONE != status ) {
+         /* Handlers only fail before they hand the tag off to anyone so the
+          * request is still pending.  This NAKs it and frees the slot. */
+         COMM_completeRpc( tag, status, NULL, 0 );
+      }
    } else {
-      status = ERR_COMM_UNKNOWN_MSG_SOURCE;
+      COMM_sendNak( e->src, e->seq, status );
+   }
+
+   if ( ERR_NONE != status ) {
       WRN_printf(
-            "ErrCode 0x%08x: Ignoring message is from an unimplemented source: %d\n",
+            "ErrCode 0x%08x handling frame type 0x%02x seq %d from source: %d\n",
             status,
-            msgSource
+            e->type,
+            e->seq,
+            e->src
       );
-      //TODO: error handle better here. maybe write it to the EEPROM?
    }
 
    return( status );
 }
 
 /******************************************************************************/
-CBErrorCode COMM_parseMsgOfLen1(
-      uint8_t *pBuffer,
-      uint16_t bufferLen,
-      MsgSrc msgSource
+void COMM_completeRpc(
+      uint16_t tag,
+      CBErrorCode status,
+      const uint8_t *payload,
+      uint16_t len
 )
 {
-   CBErrorCode status = ERR_NONE; /* Clear initial error and set it if it happens */
+   CommRpcSlot_t *slot = COMM_findRpc( tag );
+   if ( NULL == slot ) {
+      comm_rpcStats.nStale++;
+      return;
+   }
 
-   switch( pBuffer[0] ) {
-      case '?':
+   if ( ERR_NONE == status ) {
+      status = COMM_sendFrame(
+            slot->src,
+            slot->type | COMM_FRAME_RSP_BIT,
+            slot->seq,
+            payload,
+            len
+      );
+   }
+   if ( ERR_NONE != status ) {
+      COMM_sendNak( slot->src, slot->seq, status );
+   }
 
-         break;
+   slot->tag = COMM_RPC_TAG_NONE;
+   comm_rpcFreeSlots |= 1UL << (tag & COMM_RPC_SLOT_MASK);
+   comm_rpcStats.nPending--;
+   comm_rpcStats.nCompleted++;
+}
+
+/******************************************************************************/
+void COMM_postRpcDone(
+      uint16_t tag,
+      CBErrorCode status,
+      const uint8_t *payload,
+      uint16_t len,
+      void const *sender
+)
+{
+   if ( len > COMM_FRAME_MAX_PAYLOAD ) {
+      len = COMM_FRAME_MAX_PAYLOAD;
+   }
+
+   CommRpcEvt *rpcEvt = Q_NEW( CommRpcEvt, MSG_RPC_DONE_SIG );
+   rpcEvt->tag     = tag;
+   rpcEvt->type    = COMM_FRAME_TYPE_NONE;    /* CommStackMgr remembers it */
+   rpcEvt->status  = status;
+   rpcEvt->dataLen = len;
+   MEMCPY( rpcEvt->dataBuf, payload, len );
+   QACTIVE_POST( AO_CommStackMgr, (QEvt *)rpcEvt, sender );
+}
 
+/******************************************************************************/
+void COMM_handleRpcDone( QEvt const *e )
+{
+   switch( e->sig ) {
+      case MSG_RPC_DONE_SIG: {
+         CommRpcEvt const *rpcEvt = (CommRpcEvt const *)e;
+         COMM_completeRpc(
+               rpcEvt->tag,
+               rpcEvt->status,
+               rpcEvt->dataBuf,
+               rpcEvt->dataLen
+         );
+         break;
+      }
+      case I2C_DEV_READ_DONE_SIG: {
+         I2CReadDoneEvt const *i2cEvt = (I2CReadDoneEvt const *)e;
+         if ( COMM_RPC_TAG_NONE != i2cEvt->tag ) {
+            COMM_completeRpc(
+                  i2cEvt->tag,
+                  i2cEvt->status,
+                  i2cEvt->dataBuf,
+                  i2cEvt->bytes
+            );
+         }
+         break;
+      }
+      case I2C_DEV_WRITE_DONE_SIG: {
+         I2CWriteDoneEvt const *i2cEvt = (I2CWriteDoneEvt const *)e;
+         if ( COMM_RPC_TAG_NONE != i2cEvt->tag ) {
+            uint8_t rsp[sizeof(uint16_t)] = {
+                  (uint8_t)i2cEvt->bytes,
+                  (uint8_t)(i2cEvt->bytes >> 8)
+            };
+            COMM_completeRpc( i2cEvt->tag, i2cEvt->status, rsp, sizeof(rsp) );
+         }
+         break;
+      }
       default:
-         status = ERR_COMM_UNIMPLEMENTED_MSG;
+         break;
+   }
+}
+
+/******************************************************************************/
+void COMM_expireRpcs( void )
+{
+   uint32_t pending = ~comm_rpcFreeSlots & COMM_RPC_ALL_SLOTS;
+   while ( 0 != pending ) {
+      uint8_t idx = (uint8_t)__builtin_ctz( pending );
+      pending &= pending - 1;
+
+      CommRpcSlot_t *slot = &comm_rpcSlots[idx];
+      if ( ++slot->ticks >= COMM_RPC_TIMEOUT_TICKS ) {
          WRN_printf(
-            "ErrCode 0x%08x: Ignoring unimplemented message %c from source: %d.\n",
-            pBuffer[0],
-            msgSource
+               "Frame type 0x%02x seq %d timed out\n",
+               slot->type,
+               slot->seq
          );
-         //TODO: error handle better here. maybe write it to the EEPROM?
-         break;
+         comm_rpcStats.nTimeouts++;
+         COMM_completeRpc( slot->tag, ERR_COMM_RPC_TIMEOUT, NULL, 0 );
+      }
    }
+}
 
-   return( status );
+/******************************************************************************/
+const CommRpcStats_t* COMM_getRpcStats( void )
+{
+   return( &comm_rpcStats );
 }
+
+/******************************************************************************/
+CBErrorCode COMM_sendFrame(
+      MsgSrc dst,
+      uint8_t type,
+      uint16_t seq,
+      const uint8_t *payload,
+      uint16_t len
+)
+{
+   QSignal sig;
+   switch ( dst ) {
+      case ETH_PORT_SYS: sig = ETH_SYS_TCP_SEND_SIG;   break;
+      case SERIAL_CON:   sig = UART_DMA_B64_START_SIG; break; /* Text only */
+      default:           return( ERR_COMM_UNKNOWN_MSG_SOURCE );
+   }
+
+   if ( len > COMM_FRAME_MAX_PAYLOAD ) {
+      return( ERR_COMM_INVALID_MSG_LEN );
+   }
+
+   LrgDataEvt *evt = Q_NEW( LrgDataEvt, sig );
+   evt->src     = NA_SRC_DST;
+   evt->dst     = dst;
+   evt->dataLen = CommFrame_encode(
+         evt->dataBuf,
+         sizeof(evt->dataBuf),
+         type,
+         seq,
+         payload,
+         len
+   );
+   QF_PUBLISH( (QEvt *)evt, AO_CommStackMgr );
+
+   return( ERR_NONE );
+}
+
 /**
  * @}
  * end addtogroup groupComm
@@ -1,6 +1,7 @@
 /**
  * @file 	comm.h
- * @brief   Parser for various messages that come over any communication busses.
+ * @brief   Handlers for the binary command frames that come over any
+ *          communication busses.
  *
  * @date   	09/29/2014
  * @author 	Harry Rostovtsev
@@ -9,6 +10,34 @@
  *
  * @addtogroup groupComm
  * @{
+ *
+ * Frames are received and checked by the comm_frame.c parser in the context
+ * of whichever AO owns the bus.  Good frames are published as CommFrameEvt
+ * events with MSG_FRAME_RECEIVED_SIG and CommStackMgr hands them to
+ * COMM_dispatchFrame(), which picks the handler for the frame type out of a
+ * constant table with a single index.
+ *
+ * A response has the type of the request with COMM_FRAME_RSP_BIT set and the
+ * same sequence number as the request.  A request that can't be handled gets
+ * a COMM_FRAME_TYPE_NAK response with the CBErrorCode as its payload.
+ *
+ * # Pipelined requests
+ * A client doesn't have to wait for a response before sending the next
+ * request.  Every request that is accepted takes a slot in a small table of
+ * pending requests and gets a 16 bit tag that names the slot.  The handler
+ * either answers right away or hands the tag to whoever does the work (another
+ * AO, or the CPLR task) and returns.  Whoever finishes the work sends the tag
+ * back to CommStackMgr with the result, either in a CommRpcEvt with
+ * MSG_RPC_DONE_SIG or in the tag field of an I2C done event, and the response
+ * goes out right then with the sequence number of the original request.  The
+ * slowest request therefore never holds up the others and responses can come
+ * back in a different order than the requests were sent.
+ *
+ * The table is only ever touched by CommStackMgr so it needs no locking.  If it
+ * is full, the request is NAKed with ERR_COMM_RPC_BUSY and the client should
+ * back off.  A request whose backend never answers is NAKed with
+ * ERR_COMM_RPC_TIMEOUT after COMM_RPC_TIMEOUT_MS so its slot isn't lost, and any
+ * answer that shows up after that is dropped.
  */
 
 /* Define to prevent recursive inclusion -------------------------------------*/
@@ -22,25 +51,209 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx.h"                                 /* For STM32F4 support */
 #include "Shared.h"
+#include "comm_frame.h"
 
 /* Exported defines ----------------------------------------------------------*/
+
+/**< Largest payload whose frame still fits into a LrgDataEvt */
+#define COMM_FRAME_MAX_PAYLOAD           (MAX_MSG_LEN - COMM_FRAME_OVERHEAD)
+
+/**< Set in the type of every response */
+#define COMM_FRAME_RSP_BIT                                                0x80
+
+/**< Max number of requests that can be in progress at the same time.  Has to
+ * be a power of 2 and no more than 32. */
+#define COMM_RPC_MAX_PENDING                                                16
+
+/**< How often CommStackMgr checks for requests that have taken too long */
+#define COMM_RPC_TICK_MS                                                   100
+
+/**< How long a request may stay pending before it's NAKed */
+#define COMM_RPC_TIMEOUT_MS                                               2000
+
+/**< Tag that never names a pending request.  Requests that don't come from
+ * the RPC layer (e.g. I2C reads issued by the menu) carry this tag. */
+#define COMM_RPC_TAG_NONE                                                    0
+
 /* Exported types ------------------------------------------------------------*/
+
+/**
+ * \enum CommFrameType_t
+ * Types of binary command frames.  Values index the dispatch table so they
+ * should stay dense.
+ */
+typedef enum CommFrameType {
+   COMM_FRAME_TYPE_NONE       = 0x00,                   /**< Never valid */
+   COMM_FRAME_TYPE_PING       = 0x01,       /**< Payload is echoed back */
+   COMM_FRAME_TYPE_CPLR_TEST  = 0x02,    /**< Run the coupler task test */
+   COMM_FRAME_TYPE_I2C_READ   = 0x03,        /**< Read an I2C device's memory */
+   COMM_FRAME_TYPE_I2C_WRITE  = 0x04,       /**< Write an I2C device's memory */
+   COMM_FRAME_TYPE_NOR_READ   = 0x05,               /**< Read the NOR flash */
+
+   /* ... insert new request types here */
+   COMM_FRAME_TYPE_MAX,                 /**< Size of the dispatch table */
+
+   COMM_FRAME_TYPE_NAK        = 0x7F,/**< Request couldn't be handled */
+} CommFrameType_t;
+
+/**
+ * \struct CommFrameEvt
+ * Event that carries a single received frame to CommStackMgr.
+ */
+typedef struct CommFrameEvtTag {
+/* protected: */
+    QEvt     super;
+    MsgSrc   src;                /**< Where the frame came from and goes back */
+    uint8_t  type;                                   /**< CommFrameType_t */
+    uint16_t seq;               /**< Sequence number to echo in the response */
+    uint16_t dataLen;                   /**< Length of the data in dataBuf */
+    uint8_t  dataBuf[COMM_FRAME_MAX_PAYLOAD];            /**< Frame payload */
+} CommFrameEvt;
+
+/**
+ * \struct CommRpcEvt
+ * Event that carries a pending request to whoever does the work
+ * (CPLR_RPC_REQ_SIG) and carries the result back to CommStackMgr
+ * (MSG_RPC_DONE_SIG).
+ */
+typedef struct CommRpcEvtTag {
+/* protected: */
+    QEvt        super;
+    uint16_t    tag;               /**< Tag of the pending request */
+    uint8_t     type;                      /**< CommFrameType_t of the request */
+    CBErrorCode status;           /**< Result.  Only used in MSG_RPC_DONE_SIG */
+    uint16_t    dataLen;                /**< Length of the data in dataBuf */
+    uint8_t     dataBuf[COMM_FRAME_MAX_PAYLOAD];/**< Request or response data */
+} CommRpcEvt;
+
+/**
+ * \struct CommRpcStats_t
+ * Counters kept by the pending request table.
+ */
+typedef struct CommRpcStats {
+   uint32_t nStarted;               /**< Requests that were given a slot */
+   uint32_t nCompleted;                    /**< Requests that were answered */
+   uint32_t nBusy;              /**< Requests NAKed because the table was full */
+   uint32_t nTimeouts;                  /**< Requests NAKed for taking too long */
+   uint32_t nStale;     /**< Answers whose request was no longer pending */
+   uint8_t  nPending;                    /**< Requests pending right now */
+   uint8_t  maxPending;          /**< Most requests ever pending at once */
+} CommRpcStats_t;
+
 /* Exported macros -----------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
 
 /**
- * @brief   Initialize specified I2C bus
+ * @brief   Run the handler for a received frame.
+ *
+ * Looks up the handler by frame type in a constant table.  Unknown types and
+ * handlers that fail are answered with a COMM_FRAME_TYPE_NAK frame.
+ *
+ * @param [in] *e: CommFrameEvt pointer to the received frame.
+ * @return: CBErrorCode status of the handler.
+ *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_COMM_UNIMPLEMENTED_MSG: no handler for this frame type
+ *    other error codes returned by the handler
+ */
+CBErrorCode COMM_dispatchFrame( CommFrameEvt const *e );
+
+/**
+ * @brief   Finish a pending request and send its response.
+ *
+ * Must only be called from CommStackMgr.  Other AOs and threads use
+ * COMM_postRpcDone() instead.  Does nothing if @a tag no longer names a
+ * pending request, e.g. because the request already timed out.
+ *
+ * @param [in] tag: uint16_t tag that was handed to the request handler.
+ * @param [in] status: CBErrorCode result.  Anything other than ERR_NONE is
+ * sent as a NAK and @a payload is ignored.
+ * @param [in] *payload: pointer to the response payload.  May be NULL if
+ * @a len is 0.
+ * @param [in] len: uint16_t length of the response payload.
+ * @return: None
+ */
+void COMM_completeRpc(
+      uint16_t tag,
+      CBErrorCode status,
+      const uint8_t *payload,
+      uint16_t len
+);
+
+/**
+ * @brief   Send the result of a pending request to CommStackMgr.
+ *
+ * Safe to call from any AO or FreeRTOS thread.
+ *
+ * @param [in] tag: uint16_t tag of the request.
+ * @param [in] status: CBErrorCode result of the request.
+ * @param [in] *payload: pointer to the response payload.  May be NULL if
+ * @a len is 0.
+ * @param [in] len: uint16_t length of the response payload.  Anything over
+ * COMM_FRAME_MAX_PAYLOAD is cut off.
+ * @param [in] *sender: void pointer to the sender for QS.  NULL if called from
+ * a FreeRTOS thread.
+ * @return: None
+ */
+void COMM_postRpcDone(
+      uint16_t tag,
+      CBErrorCode status,
+      const uint8_t *payload,
+      uint16_t len,
+      void const *sender
+);
+
+/**
+ * @brief   Handle an event that finishes a pending request.
+ *
+ * Takes a CommRpcEvt with MSG_RPC_DONE_SIG or an I2C done event and sends
+ * the response for the request named by its tag.  I2C done events with
+ * COMM_RPC_TAG_NONE belong to someone else and are ignored.
+ *
+ * @param [in] *e: QEvt pointer to the event.
+ * @return: None
+ */
+void COMM_handleRpcDone( QEvt const *e );
+
+/**
+ * @brief   Age the pending requests and NAK the ones that took too long.
  *
- * This function initializes GPIO, clocks, and all the associated hardware for
- * a specified I2C bus interface.
+ * Should be called by CommStackMgr every COMM_RPC_TICK_MS.
  *
- * @param [in]  iBus: I2C_Bus_t identifier for I2C bus to initialize
- *    @arg
+ * @param  None
  * @return: None
  */
-CBErrorCode COMM_parseMsg( uint8_t *pBuffer, uint16_t bufferLen, MsgSrc msgSource );
+void COMM_expireRpcs( void );
+
+/**
+ * @brief   Get the counters of the pending request table.
+ * @param  None
+ * @return: CommRpcStats_t pointer to the counters.
+ */
+const CommRpcStats_t* COMM_getRpcStats( void );
+
+/**
+ * @brief   Frame a payload and send it out.
+ *
+ * @param [in] dst: MsgSrc where to send the frame.  ETH_PORT_SYS gets the
+ * frame as is.  SERIAL_CON gets it base64 encoded on a line of its own.
+ * @param [in] type: uint8_t frame type.
+ * @param [in] seq: uint16_t sequence number.
+ * @param [in] *payload: pointer to the payload.  May be NULL if @a len is 0.
+ * @param [in] len: uint16_t length of the payload.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_COMM_UNKNOWN_MSG_SOURCE: @a dst can't take frames
+ *    @arg ERR_COMM_INVALID_MSG_LEN: @a len is over COMM_FRAME_MAX_PAYLOAD
+ */
+CBErrorCode COMM_sendFrame(
+      MsgSrc dst,
+      uint8_t type,
+      uint16_t seq,
+      const uint8_t *payload,
+      uint16_t len
+);
 
 /**
  * @}
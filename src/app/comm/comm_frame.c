@@ -0,0 +1,459 @@
+/**
+ * @file   comm_frame.c
+ * @brief  Definitions for the framed binary command protocol parser.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupComm
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "comm_frame.h"
+#include "base64_stream.h"
+#include <string.h>
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#define COMM_FRAME_CRC_INIT                                             0xFFFF
+
+/**< Base64 characters decoded at a time by CommFrame_feedBase64() */
+#define COMM_FRAME_B64_CHUNK                                                64
+
+/**< How deep bad frames found while rescanning a bad frame get rescanned */
+#define COMM_FRAME_MAX_RESCANS                                               4
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+
+/**< Table for CRC-16/CCITT-FALSE, one byte at a time */
+static const uint16_t commFrame_crcLUT[256] =
+{
+   0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+   0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+   0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+   0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+   0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+   0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+   0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+   0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+   0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+   0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+   0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+   0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+   0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+   0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+   0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+   0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+   0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+   0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+   0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+   0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+   0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+   0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+   0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+   0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+   0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+   0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+   0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+   0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+   0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+   0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+   0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+   0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Finish off the current frame and go back to hunting for sync.
+ * @param [in,out] *parser: CommFrameParser_t pointer to the parser.
+ * @param [in] rxCrc: uint16_t crc received at the end of the frame.
+ * @return: uint16_t 1 if a good frame was handed to the handler, 0 otherwise.
+ */
+static uint16_t CommFrame_finish( CommFrameParser_t *parser, uint16_t rxCrc );
+
+/**
+ * @brief   Run a contiguous chunk of bytes through the parser state machine.
+ *
+ * Same as CommFrame_feed() but doesn't count the bytes as new input, so it
+ * can also be used to go over bytes again.
+ *
+ * @param [in,out] *parser: CommFrameParser_t pointer to the parser.
+ * @param [in] *data: pointer to the chunk.
+ * @param [in] len: length of the chunk.
+ * @return: uint16_t number of good frames handed to the handler.
+ */
+static uint16_t CommFrame_scan(
+      CommFrameParser_t *parser,
+      const uint8_t *data,
+      uint16_t len
+);
+
+/**
+ * @brief   Go back over the bytes of a frame that turned out to be bad.
+ *
+ * The sync marker of a bad frame may have been noise in front of a real frame
+ * that starts somewhere in the bytes consumed as its header, payload, or crc.
+ * Those bytes are run through the parser again, starting right after the
+ * sync marker.  Any frame found in them may continue in the input that
+ * follows.
+ *
+ * @param [in,out] *parser: CommFrameParser_t pointer to the parser.
+ * @param [in] *hdr: pointer to the COMM_FRAME_HDR_LEN - 2 header bytes.
+ * @param [in] *payload: pointer to the payload or NULL if there's none.
+ * @param [in] payloadLen: uint16_t length of the payload.
+ * @param [in] *crc: pointer to the crc bytes or NULL if there are none.
+ * @return: uint16_t number of good frames handed to the handler.
+ */
+static uint16_t CommFrame_rescan(
+      CommFrameParser_t *parser,
+      const uint8_t *hdr,
+      const uint8_t *payload,
+      uint16_t payloadLen,
+      const uint8_t *crc
+);
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint16_t CommFrame_finish( CommFrameParser_t *parser, uint16_t rxCrc )
+{
+   parser->state = COMM_FRAME_ST_SYNC0;
+
+   if ( NULL == parser->payload ) {
+      return( 0 );
+   }
+
+   if ( rxCrc == parser->crc ) {
+      parser->nFrames++;
+      parser->handler( parser->ctx, &parser->hdr, parser->payload, true );
+      parser->payload = NULL;
+      return( 1 );
+   }
+
+   /* The rescan reuses the parser so take everything it needs out of it
+    * first.  The payload buffer is only released once it's been rescanned. */
+   parser->nCrcErrors++;
+   CommFrameHdr_t hdr     = parser->hdr;
+   uint8_t       *payload = parser->payload;
+   uint8_t        raw[COMM_FRAME_HDR_LEN - 2];
+   uint8_t        crc[COMM_FRAME_CRC_LEN];
+
+   raw[0] = (uint8_t)hdr.len;
+   raw[1] = (uint8_t)(hdr.len >> 8);
+   raw[2] = hdr.type;
+   raw[3] = (uint8_t)hdr.seq;
+   raw[4] = (uint8_t)(hdr.seq >> 8);
+   crc[0] = (uint8_t)rxCrc;
+   crc[1] = (uint8_t)(rxCrc >> 8);
+   parser->payload = NULL;
+
+   uint16_t nGood = CommFrame_rescan( parser, raw, payload, hdr.len, crc );
+   parser->handler( parser->ctx, &hdr, payload, false );
+   return( nGood );
+}
+
+/******************************************************************************/
+static uint16_t CommFrame_rescan(
+      CommFrameParser_t *parser,
+      const uint8_t *hdr,
+      const uint8_t *payload,
+      uint16_t payloadLen,
+      const uint8_t *crc
+)
+{
+   uint16_t nGood = 0;
+   uint16_t nCrc  = ( NULL != crc ) ? COMM_FRAME_CRC_LEN : 0;
+
+   /* The sync marker itself was noise */
+   parser->nSkipped += 2;
+
+   /* Every level holds on to a payload buffer, so bound how many bad frames
+    * found inside bad frames get rescanned.  Past that they're only noise. */
+   if ( parser->nRescans >= COMM_FRAME_MAX_RESCANS ) {
+      parser->nSkipped += COMM_FRAME_HDR_LEN - 2 + payloadLen + nCrc;
+      return( 0 );
+   }
+
+   parser->nRescans++;
+   nGood += CommFrame_scan( parser, hdr, COMM_FRAME_HDR_LEN - 2 );
+   nGood += CommFrame_scan( parser, payload, payloadLen );
+   nGood += CommFrame_scan( parser, crc, nCrc );
+   parser->nRescans--;
+
+   return( nGood );
+}
+
+/******************************************************************************/
+static uint16_t CommFrame_scan(
+      CommFrameParser_t *parser,
+      const uint8_t *data,
+      uint16_t len
+)
+{
+   uint16_t nGood = 0;
+   uint16_t i     = 0;
+
+   while ( i < len ) {
+      switch ( parser->state ) {
+
+         case COMM_FRAME_ST_SYNC0: {
+            /* Skip straight to the next possible start of a frame */
+            const uint8_t *pSync = memchr( &data[i], COMM_FRAME_SYNC0, len - i );
+            if ( NULL == pSync ) {
+               parser->nSkipped += len - i;
+               i = len;
+            } else {
+               parser->nSkipped += (uint16_t)(pSync - &data[i]);
+               i = (uint16_t)(pSync - data) + 1;
+               parser->state = COMM_FRAME_ST_SYNC1;
+            }
+            break;
+         }
+
+         case COMM_FRAME_ST_SYNC1:
+            if ( COMM_FRAME_SYNC1 == data[i] ) {
+               parser->state = COMM_FRAME_ST_HDR;
+               parser->nRaw  = 0;
+               i++;
+            } else {
+               /* The first sync byte was noise.  Don't consume this byte
+                * since it may be the start of the real frame. */
+               parser->nSkipped++;
+               parser->state = COMM_FRAME_ST_SYNC0;
+            }
+            break;
+
+         case COMM_FRAME_ST_HDR:
+            parser->raw[ parser->nRaw++ ] = data[i++];
+            if ( parser->nRaw < sizeof(parser->raw) ) {
+               break;
+            }
+
+            parser->hdr.len  = (uint16_t)parser->raw[0] | ((uint16_t)parser->raw[1] << 8);
+            parser->hdr.type = parser->raw[2];
+            parser->hdr.seq  = (uint16_t)parser->raw[3] | ((uint16_t)parser->raw[4] << 8);
+            parser->nRaw     = 0;
+
+            if ( parser->hdr.len > parser->maxPayload ) {
+               /* Can't be a real frame but a real one may start in the
+                * header bytes, so go back over them. */
+               uint8_t raw[COMM_FRAME_HDR_LEN - 2];
+               memcpy( raw, parser->raw, sizeof(raw) );
+               parser->nLenErrors++;
+               parser->state = COMM_FRAME_ST_SYNC0;
+               nGood += CommFrame_rescan( parser, raw, NULL, 0, NULL );
+               break;
+            }
+
+            parser->crc = CommFrame_crc16(
+                  COMM_FRAME_CRC_INIT,
+                  parser->raw,
+                  sizeof(parser->raw)
+            );
+            parser->payload  = parser->getBuffer( parser->ctx, &parser->hdr );
+            parser->nPayload = 0;
+            if ( NULL == parser->payload ) {
+               parser->nNoBuffer++;
+            }
+            parser->state = ( 0 == parser->hdr.len ) ?
+                  COMM_FRAME_ST_CRC : COMM_FRAME_ST_PAYLOAD;
+            break;
+
+         case COMM_FRAME_ST_PAYLOAD: {
+            /* Copy as much of the payload as this chunk has in one go */
+            uint16_t n = parser->hdr.len - parser->nPayload;
+            if ( n > len - i ) {
+               n = len - i;
+            }
+            if ( NULL != parser->payload ) {
+               memcpy( &parser->payload[ parser->nPayload ], &data[i], n );
+               parser->crc = CommFrame_crc16( parser->crc, &data[i], n );
+            }
+            parser->nPayload += n;
+            i += n;
+            if ( parser->nPayload == parser->hdr.len ) {
+               parser->state = COMM_FRAME_ST_CRC;
+            }
+            break;
+         }
+
+         case COMM_FRAME_ST_CRC:
+            parser->raw[ parser->nRaw++ ] = data[i++];
+            if ( COMM_FRAME_CRC_LEN == parser->nRaw ) {
+               parser->nRaw = 0;
+               nGood += CommFrame_finish(
+                     parser,
+                     (uint16_t)parser->raw[0] | ((uint16_t)parser->raw[1] << 8)
+               );
+            }
+            break;
+
+         default:
+            CommFrame_reset( parser );
+            break;
+      }
+   }
+
+   return( nGood );
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/******************************************************************************/
+void CommFrame_init(
+      CommFrameParser_t *parser,
+      uint16_t maxPayload,
+      CommFrameBufferHandler getBuffer,
+      CommFrameHandler handler,
+      void *ctx
+)
+{
+   memset( parser, 0, sizeof(*parser) );
+   parser->state      = COMM_FRAME_ST_SYNC0;
+   parser->maxPayload = maxPayload;
+   parser->getBuffer  = getBuffer;
+   parser->handler    = handler;
+   parser->ctx        = ctx;
+}
+
+/******************************************************************************/
+void CommFrame_reset( CommFrameParser_t *parser )
+{
+   if ( NULL != parser->payload ) {
+      parser->handler( parser->ctx, &parser->hdr, parser->payload, false );
+      parser->payload = NULL;
+   }
+   parser->state = COMM_FRAME_ST_SYNC0;
+   parser->nRaw  = 0;
+}
+
+/******************************************************************************/
+uint16_t CommFrame_feed(
+      CommFrameParser_t *parser,
+      const uint8_t *data,
+      uint16_t len
+)
+{
+   parser->nBytes += len;
+   return( CommFrame_scan( parser, data, len ) );
+}
+
+/******************************************************************************/
+uint16_t CommFrame_feedRing(
+      CommFrameParser_t *parser,
+      const uint8_t *ring,
+      uint16_t ringSize,
+      uint16_t readPos,
+      uint16_t writePos
+)
+{
+   uint16_t nGood = 0;
+
+   /* A position at the very end of the ring is the same as the start */
+   if ( readPos >= ringSize ) {
+      readPos = 0;
+   }
+   if ( writePos >= ringSize ) {
+      writePos = 0;
+   }
+
+   if ( writePos >= readPos ) {
+      nGood += CommFrame_feed( parser, &ring[readPos], writePos - readPos );
+   } else {
+      nGood += CommFrame_feed( parser, &ring[readPos], ringSize - readPos );
+      nGood += CommFrame_feed( parser, &ring[0], writePos );
+   }
+
+   return( nGood );
+}
+
+/******************************************************************************/
+uint16_t CommFrame_feedBase64(
+      CommFrameParser_t *parser,
+      B64S_DecState *b64,
+      const char *text,
+      uint16_t len
+)
+{
+   uint8_t  decoded[ B64S_DECODED_MAX(COMM_FRAME_B64_CHUNK + 3) ];
+   uint16_t nGood = 0;
+
+   /* Decode a small piece at a time and hand it straight to the parser so
+    * the text never has to be decoded into a buffer of its own. */
+   while ( len > 0 ) {
+      uint16_t n = ( len > COMM_FRAME_B64_CHUNK ) ? COMM_FRAME_B64_CHUNK : len;
+      int nDecoded = B64S_decodeChunk( b64, text, n, decoded, sizeof(decoded) );
+      if ( nDecoded < 0 ) {
+         /* Not base64 after all.  Whatever was decoded so far is useless. */
+         parser->nSkipped += len;
+         CommFrame_reset( parser );
+         B64S_decodeInit( b64 );
+         break;
+      }
+
+      nGood += CommFrame_feed( parser, decoded, (uint16_t)nDecoded );
+      text  += n;
+      len   -= n;
+   }
+
+   return( nGood );
+}
+
+/******************************************************************************/
+uint16_t CommFrame_encode(
+      uint8_t *buf,
+      uint16_t bufSize,
+      uint8_t type,
+      uint16_t seq,
+      const uint8_t *payload,
+      uint16_t len
+)
+{
+   if ( (uint32_t)len + COMM_FRAME_OVERHEAD > bufSize ) {
+      return( 0 );
+   }
+
+   buf[0] = COMM_FRAME_SYNC0;
+   buf[1] = COMM_FRAME_SYNC1;
+   buf[2] = (uint8_t)len;
+   buf[3] = (uint8_t)(len >> 8);
+   buf[4] = type;
+   buf[5] = (uint8_t)seq;
+   buf[6] = (uint8_t)(seq >> 8);
+   if ( len > 0 ) {
+      memmove( &buf[COMM_FRAME_HDR_LEN], payload, len );
+   }
+
+   /* The crc covers everything except the sync bytes */
+   uint16_t crc = CommFrame_crc16(
+         COMM_FRAME_CRC_INIT,
+         &buf[2],
+         COMM_FRAME_HDR_LEN - 2 + len
+   );
+   buf[COMM_FRAME_HDR_LEN + len]     = (uint8_t)crc;
+   buf[COMM_FRAME_HDR_LEN + len + 1] = (uint8_t)(crc >> 8);
+
+   return( len + COMM_FRAME_OVERHEAD );
+}
+
+/******************************************************************************/
+uint16_t CommFrame_crc16( uint16_t crc, const uint8_t *data, uint16_t len )
+{
+   while ( len-- ) {
+      crc = (uint16_t)(crc << 8) ^ commFrame_crcLUT[ (uint8_t)(crc >> 8) ^ *data++ ];
+   }
+   return( crc );
+}
+
+/**
+ * @}
+ * end addtogroup groupComm
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,284 @@
+/**
+ * @file   comm_frame.h
+ * @brief  Declarations for the framed binary command protocol parser.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupComm
+ * @{
+ *
+ * Every binary command and response is sent as a single frame:
+ *
+ *    | 0xA5 | 0x5A | len (2) | type (1) | seq (2) | payload (len) | crc (2) |
+ *
+ *    - len: number of payload bytes, not including header or crc.
+ *    - type: command/response type.  Picks the handler in CommStackMgr.
+ *    - seq: sequence number chosen by the sender and echoed in the response
+ *      so a client can have many requests outstanding at once.
+ *    - crc: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over len, type, seq,
+ *      and the payload.
+ *
+ * All multi-byte fields are little endian.
+ *
+ * The parser is incremental.  It can be fed any number of bytes at a time, so
+ * a frame may be split across several pbufs, TCP segments, or DMA ring
+ * wraps, and a single chunk may contain several frames.  Once the header of a
+ * frame has been checked, the owner is asked for a buffer (normally the
+ * payload buffer of a freshly allocated event) and the payload is copied
+ * straight from the input into it.  Nothing is staged in between.
+ *
+ * A sync marker can show up in the middle of noise or of a frame the parser
+ * joined late.  When the frame it starts turns out to be bad (len too large
+ * or crc mismatch) the parser goes back to hunting for sync from the byte
+ * right after that marker, rescanning the header, payload, and crc bytes it
+ * had already consumed, so a real frame starting in them isn't lost.
+ *
+ * This module has no hardware or RTOS dependencies so it can be compiled on a
+ * host and fuzzed with arbitrary byte streams.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMM_FRAME_H_
+#define COMM_FRAME_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "base64_stream.h"                            /* For B64S_DecState */
+
+/* Exported defines ----------------------------------------------------------*/
+#define COMM_FRAME_SYNC0                                                  0xA5
+#define COMM_FRAME_SYNC1                                                  0x5A
+
+/**< Size of the header: sync (2), len (2), type (1), seq (2) */
+#define COMM_FRAME_HDR_LEN                                                   7
+
+/**< Size of the trailing CRC */
+#define COMM_FRAME_CRC_LEN                                                   2
+
+/**< Total number of bytes a frame adds on top of its payload */
+#define COMM_FRAME_OVERHEAD            (COMM_FRAME_HDR_LEN + COMM_FRAME_CRC_LEN)
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct CommFrameHdr_t
+ * Decoded header of a frame.
+ */
+typedef struct CommFrameHdr
+{
+   uint16_t len;                                  /**< Payload length */
+   uint8_t  type;                                   /**< Frame type */
+   uint16_t seq;                               /**< Sequence number */
+} CommFrameHdr_t;
+
+/**
+ * @brief Callback invoked once the header of a frame has been checked.
+ * @param [in] *ctx: owner context passed to CommFrame_init().
+ * @param [in] *hdr: CommFrameHdr_t pointer to the header of the frame.
+ * @return: pointer to at least hdr->len bytes where the payload should be
+ * written, or NULL to skip the frame (e.g. no memory available).
+ */
+typedef uint8_t* (*CommFrameBufferHandler)(
+      void *ctx,
+      const CommFrameHdr_t *hdr
+);
+
+/**
+ * @brief Callback invoked at the end of every frame that got a buffer.
+ * @param [in] *ctx: owner context passed to CommFrame_init().
+ * @param [in] *hdr: CommFrameHdr_t pointer to the header of the frame.
+ * @param [in] *payload: buffer returned by the CommFrameBufferHandler.
+ * @param [in] isValid: true if the CRC matched.  If false, the owner should
+ * release the buffer and ignore the contents.
+ */
+typedef void (*CommFrameHandler)(
+      void *ctx,
+      const CommFrameHdr_t *hdr,
+      uint8_t *payload,
+      bool isValid
+);
+
+/**
+ * \enum CommFrameState_t
+ * Where in a frame the parser currently is.
+ */
+typedef enum CommFrameState
+{
+   COMM_FRAME_ST_SYNC0 = 0,             /**< Hunting for the first sync byte */
+   COMM_FRAME_ST_SYNC1,                /**< Expecting the second sync byte */
+   COMM_FRAME_ST_HDR,               /**< Collecting len, type, and seq bytes */
+   COMM_FRAME_ST_PAYLOAD,                      /**< Copying the payload */
+   COMM_FRAME_ST_CRC,                         /**< Collecting the crc bytes */
+} CommFrameState_t;
+
+/**
+ * \struct CommFrameParser_t
+ * State of an incremental frame parser.
+ */
+typedef struct CommFrameParser
+{
+   CommFrameState_t        state;                    /**< Parser state */
+   uint8_t                 raw[COMM_FRAME_HDR_LEN - 2];/**< Header bytes */
+   uint8_t                 nRaw;   /**< Header or crc bytes collected so far */
+   CommFrameHdr_t          hdr;               /**< Header of current frame */
+   uint8_t                *payload;   /**< Where the payload goes or NULL */
+   uint16_t                nPayload;   /**< Payload bytes consumed so far */
+   uint16_t                crc;                       /**< Running crc */
+   uint16_t                maxPayload;/**< Largest payload that is accepted */
+   uint8_t                 nRescans;   /**< Bad frames being rescanned now */
+
+   CommFrameBufferHandler  getBuffer;         /**< Supplies payload buffers */
+   CommFrameHandler        handler;         /**< Called at end of each frame */
+   void                   *ctx;             /**< Passed to both callbacks */
+
+   uint32_t                nBytes;               /**< Total bytes consumed */
+   uint32_t                nFrames;     /**< Good frames handed to handler */
+   uint32_t                nCrcErrors;       /**< Frames with a bad crc */
+   uint32_t                nLenErrors;/**< Headers with len over maxPayload */
+   uint32_t                nNoBuffer;/**< Frames skipped for lack of buffer */
+   uint32_t                nSkipped;/**< Bytes thrown away hunting for sync */
+} CommFrameParser_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Initialize a frame parser.
+ *
+ * @param [out] *parser: CommFrameParser_t pointer to the parser to initialize.
+ * @param [in] maxPayload: uint16_t largest payload to accept.  Frames with a
+ * larger len are treated as noise and the parser goes back to hunting for
+ * sync right after their sync marker.
+ * @param [in] getBuffer: CommFrameBufferHandler that supplies payload buffers.
+ * @param [in] handler: CommFrameHandler called at the end of every frame.
+ * @param [in] *ctx: void pointer passed to both callbacks.
+ * @return: None
+ */
+void CommFrame_init(
+      CommFrameParser_t *parser,
+      uint16_t maxPayload,
+      CommFrameBufferHandler getBuffer,
+      CommFrameHandler handler,
+      void *ctx
+);
+
+/**
+ * @brief   Throw away any partially parsed frame and start hunting for sync.
+ *
+ * If a buffer had already been handed out for the partial frame, the handler
+ * is called with isValid set to false so it can be released.
+ *
+ * @param [in,out] *parser: CommFrameParser_t pointer to the parser.
+ * @return: None
+ */
+void CommFrame_reset( CommFrameParser_t *parser );
+
+/**
+ * @brief   Run a contiguous chunk of bytes through the parser.
+ *
+ * @param [in,out] *parser: CommFrameParser_t pointer to the parser.
+ * @param [in] *data: pointer to the chunk.
+ * @param [in] len: length of the chunk.
+ * @return: uint16_t number of good frames handed to the handler.
+ */
+uint16_t CommFrame_feed(
+      CommFrameParser_t *parser,
+      const uint8_t *data,
+      uint16_t len
+);
+
+/**
+ * @brief   Run the new bytes of a circular buffer through the parser.
+ *
+ * Processes all bytes from @a readPos up to (but not including) @a writePos,
+ * handling a wrap around the end of the ring.
+ *
+ * @param [in,out] *parser: CommFrameParser_t pointer to the parser.
+ * @param [in] *ring: pointer to the circular buffer.
+ * @param [in] ringSize: size of the circular buffer.
+ * @param [in] readPos: first position in the ring that hasn't been consumed.
+ * @param [in] writePos: current write position in the ring.
+ * @return: uint16_t number of good frames handed to the handler.
+ */
+uint16_t CommFrame_feedRing(
+      CommFrameParser_t *parser,
+      const uint8_t *ring,
+      uint16_t ringSize,
+      uint16_t readPos,
+      uint16_t writePos
+);
+
+/**
+ * @brief   Run base64 text through the parser.
+ *
+ * For links that can only carry text, e.g. the serial console, where each
+ * line is one or more frames base64 encoded as a whole.  The text is decoded
+ * a small piece at a time straight into the parser and may be split across
+ * calls anywhere.  '\r' and '\n' are skipped.  A character that isn't base64
+ * throws away the rest of @a text, any partial frame, and the state of
+ * @a b64.
+ *
+ * @param [in,out] *parser: CommFrameParser_t pointer to the parser.
+ * @param [in,out] *b64: B64S_DecState pointer to the decoder state.  Start
+ * each new stream with B64S_decodeInit().
+ * @param [in] *text: pointer to the base64 characters.
+ * @param [in] len: number of characters.
+ * @return: uint16_t number of good frames handed to the handler.
+ */
+uint16_t CommFrame_feedBase64(
+      CommFrameParser_t *parser,
+      B64S_DecState *b64,
+      const char *text,
+      uint16_t len
+);
+
+/**
+ * @brief   Build a complete frame into a buffer.
+ *
+ * @param [out] *buf: pointer to where to write the frame.
+ * @param [in] bufSize: size of @a buf.
+ * @param [in] type: uint8_t frame type.
+ * @param [in] seq: uint16_t sequence number.
+ * @param [in] *payload: pointer to the payload.  May be NULL if @a len is 0.
+ * @param [in] len: uint16_t length of the payload.
+ * @return: uint16_t total length of the frame or 0 if it doesn't fit.
+ */
+uint16_t CommFrame_encode(
+      uint8_t *buf,
+      uint16_t bufSize,
+      uint8_t type,
+      uint16_t seq,
+      const uint8_t *payload,
+      uint16_t len
+);
+
+/**
+ * @brief   Update a CRC-16/CCITT-FALSE with a block of data.
+ *
+ * @param [in] crc: uint16_t crc so far.  Start with 0xFFFF.
+ * @param [in] *data: pointer to the data.
+ * @param [in] len: length of the data.
+ * @return: uint16_t updated crc.
+ */
+uint16_t CommFrame_crc16( uint16_t crc, const uint8_t *data, uint16_t len );
+
+/**
+ * @}
+ * end addtogroup groupComm
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* COMM_FRAME_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -18,6 +18,13 @@
 #include "cplr.h"
 #include "LWIPMgr.h"
 #include "i2c_dev.h"                                 /* For I2C functionality */
+#include "comm.h"                               /* For binary request results */
+#include "nor.h"                                     /* For NOR functionality */
+#include "db.h"                                   /* For settings DB upkeep */
+#include "time.h"                                   /* For LSI calibration */
+#include "boot_prof.h"                         /* For the boot time profiler */
+#include "cpu_load.h"                           /* For the CPU load windows */
+#include "semphr.h"                         /* For the wake up semaphore */
 
 /* Compile-time called macros ------------------------------------------------*/
 Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
@@ -25,14 +32,271 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_CPLR );/* For debug system to ID this module */
 
 /* Private typedefs ----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
+
+/**< Size of the NOR_READ request payload: addr (4), len (2) */
+#define CPLR_NOR_READ_REQ_LEN                                                6
+
+/**< Number of bytes read from the EEPROM by the CPLR_TEST request */
+#define CPLR_TEST_READ_LEN                                                  17
+
+/**< Number of bytes read from the EEPROM by the I2C read benchmark (all of it) */
+#define CPLR_BENCH_READ_LEN                                                256
+
+/**< Longest the task sleeps when nothing is queued for it.  Bounds how late the
+ * settings DB upkeep and the CPU load windows can get. */
+#define CPLR_IDLE_MS                                                       100
+
 /* Private macros ------------------------------------------------------------*/
 /* Private variables and Local objects ---------------------------------------*/
 QEQueue CPLR_evtQueue;         /**< raw queue to talk between FreeRTOS and QP */
 
+/**< Given by CPLR_wake() when a request is queued up.  NULL until the task has
+ * started. */
+static SemaphoreHandle_t CPLR_wakeSem = NULL;
+
 TaskHandle_t xHandle_CPLR;                       /**< Handle to the CPLR task */
+
+/**< Response data of the request being run.  Only used by the CPLR task. */
+static uint16_t CPLR_rpcBuf[COMM_FRAME_MAX_PAYLOAD / sizeof(uint16_t)];
+
+/**< EEPROM contents read by the I2C read benchmark.  [0] is read with a single
+ * call and [1] in MAX_I2C_READ_LEN chunks. */
+static uint8_t CPLR_benchBuf[2][CPLR_BENCH_READ_LEN];
+
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Run a binary request that was handed to this task by CommStackMgr
+ * and send the result back.
+ *
+ * @param [in] *e: CommRpcEvt pointer to the request.
+ * @return: None
+ */
+static void CPLR_runRpc( CommRpcEvt const *e );
+
+/**
+ * @brief   Time reading the whole EEPROM with a single call against reading it
+ * MAX_I2C_READ_LEN bytes at a time and print the results.
+ *
+ * Blocks the task until both reads are done.
+ *
+ * @param   None
+ * @return: None
+ */
+static void CPLR_benchI2CRead( void );
+
+/**
+ * @brief   Validate the settings DB, write a default one if needed, and print
+ * the stored network settings.
+ *
+ * Done here instead of in main() so the EEPROM reads overlap the rest of the
+ * startup instead of holding it up.
+ *
+ * @param   None
+ * @return: None
+ */
+static void CPLR_loadDB( void );
+
+/**
+ * @brief   Print one line of the boot timeline.
+ * @param [in] *line: const char pointer to the line without a newline.
+ * @return: None
+ */
+static void CPLR_printBootLine( const char *line );
+
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+static void CPLR_runRpc( CommRpcEvt const *e )
+{
+   CBErrorCode status = ERR_NONE;
+   uint16_t len = 0;
+
+   switch( e->type ) {
+      case COMM_FRAME_TYPE_NOR_READ: {
+         /* Payload is the address (4) and number of bytes (2) to read.  The
+          * NOR is 16 bits wide so both have to be even. */
+         if ( CPLR_NOR_READ_REQ_LEN != e->dataLen ) {
+            status = ERR_COMM_INVALID_MSG_LEN;
+            break;
+         }
+         uint32_t addr = (uint32_t)e->dataBuf[0]
+               | ((uint32_t)e->dataBuf[1] << 8)
+               | ((uint32_t)e->dataBuf[2] << 16)
+               | ((uint32_t)e->dataBuf[3] << 24);
+         len = e->dataBuf[4] | (e->dataBuf[5] << 8);
+         if ( (addr & 1) || (len & 1) || len > sizeof(CPLR_rpcBuf) ) {
+            status = ERR_COMM_INVALID_MSG_LEN;
+            len = 0;
+            break;
+         }
+         NOR_ReadBuffer( CPLR_rpcBuf, addr, len / sizeof(uint16_t) );
+         break;
+      }
+      case COMM_FRAME_TYPE_CPLR_TEST:
+         /* Read the start of the EEPROM through the I2CDevMgr AO.  This
+          * blocks the task but not the AO so other requests keep going. */
+         status = I2C_readDevMemFRT(
+               EEPROM,                          // I2C_Dev_t iDev,
+               0x00,                            // uint16_t offset,
+               (uint8_t *)CPLR_rpcBuf,          // uint8_t *pBuffer,
+               sizeof(CPLR_rpcBuf),             // uint16_t nBufferSize,
+               &len,                            // uint16_t *pBytesRead,
+               CPLR_TEST_READ_LEN               // uint16_t nBytesToRead
+         );
+         break;
+      default:
+         status = ERR_COMM_UNIMPLEMENTED_MSG;
+         break;
+   }
+
+   COMM_postRpcDone(
+         e->tag,
+         status,
+         (const uint8_t *)CPLR_rpcBuf,
+         len,
+         NULL
+   );
+}
+
+/******************************************************************************/
+static void CPLR_benchI2CRead( void )
+{
+   CBErrorCode status = ERR_NONE;
+   uint16_t bytesRead = 0;
+   uint16_t nChunks = 0;
+   uint32_t cyclesOneCall = 0;
+   uint32_t cyclesChunked = 0;
+
+   /* The whole EEPROM with one request and one bus transfer */
+   uint32_t start = QF_RTC_CYCLES();
+   status = I2C_readDevMemFRT(
+         EEPROM,                                   // I2C_Dev_t iDev,
+         0x00,                                     // uint16_t offset,
+         CPLR_benchBuf[0],                         // uint8_t *pBuffer,
+         sizeof(CPLR_benchBuf[0]),                 // uint16_t nBufferSize,
+         &bytesRead,                               // uint16_t *pBytesRead,
+         CPLR_BENCH_READ_LEN                       // uint16_t nBytesToRead
+   );
+   cyclesOneCall = QF_RTC_CYCLES() - start;
+   if ( ERR_NONE != status ) {
+      goto CPLR_benchI2CRead_ERR_HANDLER;  /* Stop and jump to error handling */
+   }
+
+   /* The same data the way callers had to read it before, one full
+    * transaction per MAX_I2C_READ_LEN bytes. */
+   start = QF_RTC_CYCLES();
+   for ( uint16_t offset = 0; offset < CPLR_BENCH_READ_LEN; offset += MAX_I2C_READ_LEN ) {
+      uint16_t len = CPLR_BENCH_READ_LEN - offset;
+      if ( len > MAX_I2C_READ_LEN ) {
+         len = MAX_I2C_READ_LEN;
+      }
+      status = I2C_readDevMemFRT(
+            EEPROM,                                // I2C_Dev_t iDev,
+            offset,                                // uint16_t offset,
+            &CPLR_benchBuf[1][offset],             // uint8_t *pBuffer,
+            len,                                   // uint16_t nBufferSize,
+            &bytesRead,                            // uint16_t *pBytesRead,
+            len                                    // uint16_t nBytesToRead
+      );
+      if ( ERR_NONE != status ) {
+         goto CPLR_benchI2CRead_ERR_HANDLER;  /* Stop and jump to error handling */
+      }
+      nChunks++;
+   }
+   cyclesChunked = QF_RTC_CYCLES() - start;
+
+   LOG_printf(
+         "EEPROM read of %d bytes: 1 call %lu us, %d calls %lu us, data %s\n",
+         CPLR_BENCH_READ_LEN,
+         cyclesOneCall / (SystemCoreClock / 1000000),
+         nChunks,
+         cyclesChunked / (SystemCoreClock / 1000000),
+         memcmp( CPLR_benchBuf[0], CPLR_benchBuf[1], CPLR_BENCH_READ_LEN ) ?
+               "DIFFERS" : "matches"
+   );
+
+CPLR_benchI2CRead_ERR_HANDLER:    /* Handle any error that may have occurred. */
+   ERR_COND_OUTPUT(
+         status,
+         ACCESS_FREERTOS,
+         "Error 0x%08x running the I2C read benchmark\n",
+         status
+   );
+}
+
+/******************************************************************************/
+static void CPLR_loadDB( void )
+{
+   LOG_printf("Checking settings DB validity...\n");
+   CBErrorCode status = DB_isValid( ACCESS_FREERTOS );
+   if ( ERR_NONE != status ) {
+      WRN_printf("Settings DB validity check returned: 0x%08x\n", status);
+      WRN_printf("Attempting to write default DB to EEPROM...\n");
+      status = DB_initToDefault( ACCESS_FREERTOS );
+      if ( ERR_NONE != status ) {
+         ERR_printf("Unable to write default DB to EEPROM. Error: 0x%08x\n", status);
+      } else {
+         LOG_printf("Wrote default DB to EEPROM. Attempting to validate...\n");
+         status = DB_isValid( ACCESS_FREERTOS );
+         if ( ERR_NONE != status ) {
+            ERR_printf("DB validity check returned: 0x%08x\n", status);
+            ERR_printf("Unable to fix DB in EEPROM\n");
+         } else {
+            LOG_printf("A default DB has been successfully written to EEPROM\n");
+         }
+      }
+   } else {
+      LOG_printf("Valid settings DB found.\n");
+   }
+
+   DBG_printf("Reading the MAC address from the settings DB...\n");
+   uint8_t macAddrBuffer[6];
+   memset(macAddrBuffer, 0, sizeof(macAddrBuffer));
+
+   status = DB_getElemBLK(
+         DB_MAC_ADDR,
+         macAddrBuffer,
+         sizeof(macAddrBuffer),
+         ACCESS_FREERTOS
+   );
+   if ( ERR_NONE != status ) {
+      ERR_printf("Unable to read stored MAC address, error: 0x%08x\n", status);
+   } else {
+      LOG_printf(
+            "Read MAC address from settings DB: %02x:%02x:%02x:%02x:%02x:%02x\n",
+            macAddrBuffer[0], macAddrBuffer[1], macAddrBuffer[2],
+            macAddrBuffer[3], macAddrBuffer[4], macAddrBuffer[5]
+      );
+   }
+
+   /* Read the stored IP address from DB */
+   DBG_printf("Reading the IP address from the settings DB...\n");
+   uint8_t ipAddrBuffer[4];
+   memset(ipAddrBuffer, 0, sizeof(ipAddrBuffer));
+   status = DB_getElemBLK(
+         DB_IP_ADDR,
+         ipAddrBuffer,
+         sizeof(ipAddrBuffer),
+         ACCESS_FREERTOS
+   );
+
+   if ( ERR_NONE != status ) {
+      ERR_printf("Unable to read stored IP address, error: 0x%08x\n", status);
+   } else {
+      LOG_printf(
+            "Read IP address from settings DB: %d:%d:%d:%d\n",
+            ipAddrBuffer[0], ipAddrBuffer[1], ipAddrBuffer[2], ipAddrBuffer[3]
+      );
+   }
+}
+
+/******************************************************************************/
+static void CPLR_printBootLine( const char *line )
+{
+   LOG_printf("%s\n", line);
+}
+
 /******************************************************************************/
 void CPLR_Task( void* pvParameters )
 {
@@ -49,11 +313,31 @@ void CPLR_Task( void* pvParameters )
                                      to something other than ERR_NONE, it will
                                      be printed out at the end of the for loop*/
 
+   bool bBootReported = false;    /* Boot timeline gets printed only once */
+
+   /* First time this task runs is as good a mark as any that the scheduler is
+    * up.  The slow startup work that doesn't need to hold up the AOs is done
+    * here and in the network bring up task. */
+   BOOT_end( BOOT_STEP_SCHED );
+
+   BOOT_begin( BOOT_STEP_LSI_CAL );
+   uint32_t lsiFreq = TIME_calibrateLSI();
+   BOOT_end( BOOT_STEP_LSI_CAL );
+   DBG_printf("RTC calibrated to a measured LSI of %lu Hz\n", lsiFreq);
+
+   BOOT_begin( BOOT_STEP_DB_LOAD );
+   CPLR_loadDB();
+   BOOT_end( BOOT_STEP_DB_LOAD );
+
+   /* Anything queued up before this exists is handled on the first pass */
+   CPLR_wakeSem = xSemaphoreCreateBinary();
+
    for (;;) {                         /* Beginning of the thread forever loop */
       /* Check if there's data in the queue and process it if there. */
 
-      evt = QEQueue_get(&CPLR_evtQueue);
-      if ( evt != (QEvt *)0 ) { /* Check whether an event is present in queue */
+      /* Handle everything that's queued up before going back to sleep so a
+       * burst of requests doesn't take a tick per request. */
+      while ( (evt = QEQueue_get(&CPLR_evtQueue)) != (QEvt *)0 ) {
 
          switch( evt->sig ) {        /* Identify the event by its signal enum */
             case CPLR_ETH_SYS_TEST_SIG:
@@ -70,7 +354,9 @@ void CPLR_Task( void* pvParameters )
                      0x00,                                           // uint16_t offset,
                      17,                                             // uint16_t bytesToRead,
                      ACCESS_FREERTOS,                                // AccessType_t accType,
-                     NULL                                            // QActive* callingAO
+                     NULL,                                           // QActive* callingAO
+                     NULL,                                           // uint8_t *pBuffer
+                     0                                               // uint16_t tag
                );
                if ( ERR_NONE != status ) {
                   ERR_printf("Error calling I2C_readDevMemEVT()\n");
@@ -97,8 +383,8 @@ void CPLR_Task( void* pvParameters )
                   ERR_printf("Timed out waiting for an event\n");
                } else {
                   switch( evtI2CDone->sig ) {
-                     case I2C1_DEV_READ_DONE_SIG:
-                        DBG_printf("Got I2C1_DEV_READ_DONE_SIG\n");
+                     case I2C_DEV_READ_DONE_SIG:
+                        DBG_printf("Got I2C_DEV_READ_DONE_SIG\n");
                         break;
                      default:
                         WRN_printf("Unknown signal %d\n", evtI2CDone->sig);
@@ -134,6 +420,18 @@ void CPLR_Task( void* pvParameters )
                      true                                 // bPrintX
                );
                DBG_printf("I2C_readDevMemFRT() returned having read %d bytes: %s\n", bytesRead, tmp);
+
+               CPLR_benchI2CRead();
+               break;
+
+            case CPLR_RPC_REQ_SIG:
+               CPLR_runRpc( (CommRpcEvt const *)evt );
+               break;
+
+            case I2C_DEV_READ_DONE_SIG:             /* Intentionally fall through */
+            case I2C_DEV_WRITE_DONE_SIG:
+               /* Reply to an I2C request that this thread gave up waiting on */
+               WRN_printf("Dropping late I2C reply %d\n", evt->sig);
                break;
 
             default:
@@ -160,12 +458,41 @@ CPLR_Task_ERR_HANDLE:             /* Handle any error that may have occurred. */
                         be referenced. */
       }
 
-//      vTaskSuspend(NULL);
-      vTaskDelay(1); /* Always task-delay so this thread can go to sleep while
-                        other threads/AOs can process their data */
+      /* Keep room in the settings journal for the AOs, which can't compact it
+       * themselves.  Returns right away unless the active bank is low.  Any
+       * error is already printed by DB_maintain(). */
+      DB_maintain( ACCESS_FREERTOS );
+
+      /* This task runs at least every CPLR_IDLE_MS and above most AOs, so it
+       * keeps closing the CPU load windows on time even when the CPU is nearly
+       * saturated */
+      CPU_LOAD_poll();
+
+      /* The network comes up last so wait for it before printing the boot
+       * timeline */
+      if ( !bBootReported && BOOT_isDone() ) {
+         bBootReported = true;
+         BOOT_report( SystemCoreClock, CPLR_printBootLine );
+      }
+
+      /* Sleep until a request comes in instead of waking up every tick, so
+       * the tickless idle gets to stop the tick while the system is quiet */
+      if ( NULL != CPLR_wakeSem ) {
+         xSemaphoreTake( CPLR_wakeSem, CPLR_IDLE_MS / portTICK_PERIOD_MS );
+      } else {
+         vTaskDelay( CPLR_IDLE_MS / portTICK_PERIOD_MS );
+      }
    }                                        /* End of the thread forever loop */
 }
 
+/******************************************************************************/
+void CPLR_wake( void )
+{
+   if ( NULL != CPLR_wakeSem ) {
+      xSemaphoreGive( CPLR_wakeSem );
+   }
+}
+
 /**
  * @}
  * end addtogroup groupCoupler
@@ -34,6 +34,17 @@ extern TaskHandle_t xHandle_CPLR; /**< Globally accessible handle to the CPLR ta
  */
 void CPLR_Task( void* pvParameters );
 
+/**
+ * @brief   Wake the CPLR task up to look at its queue.
+ *
+ * Call from task context right after posting to CPLR_evtQueue.  Replies the
+ * task is waiting on don't need it since it polls for those.
+ *
+ * @param   None
+ * @return: None
+ */
+void CPLR_wake( void );
+
 #ifdef __cplusplus
 }
 #endif
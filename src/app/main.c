@@ -17,8 +17,9 @@
 #include "SerialMgr.h"                           /* for starting SerialMgr AO */
 #include "DbgMgr.h"                                 /* for starting DbgMgr AO */
 #include "I2CBusMgr.h"                           /* for starting I2CBusMgr AO */
-#include "I2C1DevMgr.h"                         /* for starting I2C1DevMgr AO */
+#include "I2CDevMgr.h"                           /* for starting I2CDevMgr AO */
 #include "cplr.h"                               /* for starting the CPLR task */
+#include "comm.h"                    /* for CommFrameEvt and CommRpcEvt size */
 
 #include "project_includes.h"           /* Includes common to entire project. */
 #include "Shared.h"
@@ -29,26 +30,134 @@
 #include "bsp_defs.h"
 #include "bsp.h"
 #include "db.h"                                       /* for settings support */
+#include "telemetry.h"                              /* for telemetry channels */
+#include "serial.h"                                   /* for serial counters */
+#include "i2c.h"                                         /* for I2C counters */
+#include "stm32f4x7_eth_bsp.h"                      /* for ETH_BSP_Config() */
+#include "boot_prof.h"                          /* for boot time profiling */
+#include "stack_mon.h"                   /* for task stack sizes and usage */
+#include "cpu_load.h"                               /* for CPU load per task */
+#include "tickless.h"                            /* for tickless idle counters */
+#include "con_fmt.h"                                    /* For FMT_snprintf() */
+#include "evt_rec.h"                                 /* for the event recorder */
 
 /* Compile-time called macros ------------------------------------------------*/
 Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
 DBG_DEFINE_THIS_MODULE( DBG_MODL_GENERAL ); /* For debug system to ID this module */
 
 /* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \enum MainTask_t
+ * Index of every task in l_stackCfg.  The I2C AOs get one entry per bus.
+ */
+typedef enum MainTasks {
+    MAIN_TASK_SERIAL_MGR = 0,
+    MAIN_TASK_LWIP_MGR,
+    MAIN_TASK_DBG_MGR,
+    MAIN_TASK_I2CBUS_MGR,
+    MAIN_TASK_I2CDEV_MGR = MAIN_TASK_I2CBUS_MGR + MAX_I2C_BUS,
+    MAIN_TASK_COMM_MGR   = MAIN_TASK_I2CDEV_MGR + MAX_I2C_BUS,
+    MAIN_TASK_CPLR,
+    MAIN_TASK_NET_UP,
+    MAIN_TASK_IDLE,                 /**< Created by FreeRTOS, only watched */
+    MAIN_TASK_MAX
+} MainTask_t;
+
 /* Private defines -----------------------------------------------------------*/
-#define THREAD_STACK_SIZE  1024U * 2
+
+/**< Priority of the task that brings up the network.  Below every AO (the
+ * lowest one, DbgMgr, runs at tskIDLE_PRIORITY + 1) so the seconds spent
+ * polling the PHY only use up time nothing else wants. */
+#define NET_UP_TASK_PRIORITY  ( tskIDLE_PRIORITY )
+
+/**< Stack size, in bytes, of each I2CBusMgr and I2CDevMgr AO instance */
+#define MAIN_I2C_STACK_SIZE   2048
+
+/**< Room for the task and telemetry channel names of one I2C bus */
+#define MAIN_I2C_NAME_BYTES   384
 
 /* Private macros ------------------------------------------------------------*/
+
+/**
+ * @brief   Register the event queue and RTC step telemetry channels of an AO.
+ *
+ * The priority is passed in instead of read from the AO since some AOs (like
+ * LWIPMgr) are started after the channels are registered.
+ *
+ * @param [in] ao_: QActive pointer to the AO.
+ * @param [in] prio_: priority the AO is started at.
+ * @param [in] name_: string literal prefix for the channel names.
+ */
+#define MAIN_TLM_ADD_AO( ao_, prio_, name_ ) do { \
+    TLM_ADD_VAR(name_ ".q.free",  TLM_GAUGE,   (ao_)->eQueue.nFree); \
+    TLM_ADD_VAR(name_ ".q.min",   TLM_GAUGE,   (ao_)->eQueue.nMin); \
+    TLM_ADD_VAR(name_ ".rtc.n",   TLM_COUNTER, QF_rtcStats[(prio_)].nSteps); \
+    TLM_ADD_VAR(name_ ".rtc.cyc", TLM_COUNTER, QF_rtcStats[(prio_)].cycles); \
+    TLM_ADD_VAR(name_ ".rtc.max", TLM_GAUGE,   QF_rtcStats[(prio_)].maxCycles); \
+} while (0)
+
+/**
+ * @brief   Same as MAIN_TLM_ADD_AO() for the AO instance of an I2C bus, with
+ * the bus number filled into the channel names.
+ *
+ * @param [in] ao_: QActive pointer to the AO.
+ * @param [in] prio_: priority the AO is started at.
+ * @param [in] bus_: I2C_Bus_t of the bus.
+ * @param [in] name_: string literal format of the prefix, with a %u for the
+ * bus number.
+ */
+#define MAIN_TLM_ADD_I2C_AO( ao_, prio_, bus_, name_ ) do { \
+    TLM_ADD_VAR(MAIN_i2cName(name_ ".q.free",  (bus_)), TLM_GAUGE,   (ao_)->eQueue.nFree); \
+    TLM_ADD_VAR(MAIN_i2cName(name_ ".q.min",   (bus_)), TLM_GAUGE,   (ao_)->eQueue.nMin); \
+    TLM_ADD_VAR(MAIN_i2cName(name_ ".rtc.n",   (bus_)), TLM_COUNTER, QF_rtcStats[(prio_)].nSteps); \
+    TLM_ADD_VAR(MAIN_i2cName(name_ ".rtc.cyc", (bus_)), TLM_COUNTER, QF_rtcStats[(prio_)].cycles); \
+    TLM_ADD_VAR(MAIN_i2cName(name_ ".rtc.max", (bus_)), TLM_GAUGE,   QF_rtcStats[(prio_)].maxCycles); \
+} while (0)
+
+/* Each I2C bus runs its own I2CBusMgr and I2CDevMgr AO instance at consecutive
+ * priorities starting at I2CBUS1MGR_PRIORITY and I2CDEVMGR_PRIORITY.  Make sure
+ * the loops that start them don't run into the priority of the next AO. */
+Q_ASSERT_COMPILE(I2CDEVMGR_PRIORITY + MAX_I2C_BUS <= SERIAL_MGR_PRIORITY);
+Q_ASSERT_COMPILE(I2CBUS1MGR_PRIORITY + MAX_I2C_BUS <= ETH_PRIORITY);
+
 /* Private variables and Local objects ---------------------------------------*/
-static QEvt const    *l_CommStackMgrQueueSto[30];  /**< Storage for CommStackMgr event Queue */
+static QEvt const    *l_CommStackMgrQueueSto[50];  /**< Storage for CommStackMgr event Queue */
 static QEvt const    *l_LWIPMgrQueueSto[200];       /**< Storage for LWIPMgr event Queue */
 static QEvt const    *l_SerialMgrQueueSto[200];     /**< Storage for SerialMgr event Queue */
-static QEvt const    *l_I2CBusMgrQueueSto[30][MAX_I2C_BUS];    /**< Storage for I2CBusMgr event Queue */
-static QEvt const    *l_I2C1DevMgrQueueSto[30];    /**< Storage for I2C1DevMgr event Queue */
+static QEvt const    *l_I2CBusMgrQueueSto[MAX_I2C_BUS][30]; /**< Storage for I2CBusMgr event Queues, one per bus */
+static QEvt const    *l_I2CDevMgrQueueSto[MAX_I2C_BUS][30]; /**< Storage for I2CDevMgr event Queues, one per bus */
 static QEvt const    *l_DbgMgrQueueSto[30];        /**< Storage for DbgMgr event Queue */
 static QSubscrList   l_subscrSto[MAX_PUB_SIG];      /**< Storage for subscribe/publish event Queue */
 
-static QEvt const    *l_CPLRQueueSto[10]; /**< Storage for raw QE queue for communicating with CPLR task */
+static QEvt const    *l_CPLRQueueSto[COMM_RPC_MAX_PENDING + 4]; /**< Storage for raw QE queue for communicating with CPLR task */
+static TaskHandle_t  l_netUpTask;           /**< Handle to the network bring up task */
+
+/**< Names of the I2C AO instances and the telemetry channels of every bus.
+ * They are made up at startup by MAIN_i2cName() and have to stay valid
+ * forever. */
+static char          l_i2cNameSto[MAX_I2C_BUS * MAIN_I2C_NAME_BYTES];
+static uint16_t      l_i2cNameLen;          /**< Bytes of l_i2cNameSto used */
+
+/**
+ * @brief   Stack sizes, in bytes, of all the tasks.
+ *
+ * Every task is started with its size from here and STK_MON reports how much
+ * of it each one really uses (DBG->STK menu and the stk.* telemetry channels)
+ * along with the size it recommends.  Adjust the sizes here after looking at
+ * those.  The names are also the task names CPU_LOAD reports the load under.
+ * The entries of the I2C AO instances are filled in for every bus by
+ * MAIN_initI2CStackCfg() (MAIN_I2C_STACK_SIZE each).
+ */
+static StackCfg_t l_stackCfg[MAIN_TASK_MAX] = {
+    [MAIN_TASK_SERIAL_MGR] = { "SerialMgr", 2048 },
+    [MAIN_TASK_LWIP_MGR]   = { "LWIPMgr",   2048 },
+    [MAIN_TASK_DBG_MGR]    = { "DbgMgr",    2048 },
+    [MAIN_TASK_COMM_MGR]   = { "CommMgr",   2048 },
+    [MAIN_TASK_CPLR]       = { "CPLRTask",  8192 },
+    [MAIN_TASK_NET_UP]     = { "NetUpTask", 8192 },
+    [MAIN_TASK_IDLE]       = { "IDLE", configMINIMAL_STACK_SIZE * sizeof(StackType_t) },
+};
 /**
  * \union Small Events.
  * This union is a storage for small sized events.
@@ -57,7 +166,6 @@ static union SmallEvents {
     void   *e0;                                       /* minimum event size */
     uint8_t e1[sizeof(QEvt)];
     uint8_t e2[sizeof(I2CStatusEvt)];
-    uint8_t e3[sizeof(I2CReadReqEvt)];
 } l_smlPoolSto[50];                     /* storage for the small event pool */
 
 /**
@@ -68,7 +176,7 @@ static union MediumEvents {
     void   *e0;                                       /* minimum event size */
     uint8_t e1[sizeof(MenuEvt)];
     uint8_t e2[sizeof(I2CAddrEvt)];
-    uint8_t e3[sizeof(I2CReadMemReqEvt)];
+    uint8_t e3[sizeof(I2CReadReqEvt)];
 } l_medPoolSto[50];                    /* storage for the medium event pool */
 
 /**
@@ -81,10 +189,241 @@ static union LargeEvents {
     uint8_t e2[sizeof(EthEvt)];
     uint8_t e3[sizeof(LrgDataEvt)];
     uint8_t e4[sizeof(I2CWriteReqEvt)];
+    uint8_t e5[sizeof(CommFrameEvt)];
+    uint8_t e6[sizeof(CommRpcEvt)];
+    uint8_t e7[sizeof(LogEvt)];
 } l_lrgPoolSto[100];                    /* storage for the large event pool */
 
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Telemetry sampler for the number of free blocks in an event pool.
+ * @param [in] poolId: uint32_t QF event pool id (1 based).
+ * @return: uint32_t free blocks in the pool right now.
+ */
+static uint32_t MAIN_tlmPoolFree( uint32_t poolId );
+
+/**
+ * @brief   Telemetry sampler for the fewest free blocks an event pool has had.
+ * @param [in] poolId: uint32_t QF event pool id (1 based).
+ * @return: uint32_t low watermark of free blocks in the pool.
+ */
+static uint32_t MAIN_tlmPoolMin( uint32_t poolId );
+
+/**
+ * @brief   Make up a name for one I2C bus.
+ *
+ * Names are kept in l_i2cNameSto so they can be handed to the telemetry and
+ * the task creation, which both hold on to them.
+ *
+ * @param [in] *fmt: const char* format of the name with a %u for the bus
+ * number, which counts from 1 the way the buses are named (i2c1).
+ * @param [in] bus: I2C_Bus_t of the bus.
+ * @return: const char* name.
+ */
+static const char* MAIN_i2cName( const char *fmt, I2C_Bus_t bus );
+
+/**
+ * @brief   Fill in the l_stackCfg entries of the I2CBusMgr and I2CDevMgr AO
+ * instances of every I2C bus.
+ * @param   None
+ * @return: None
+ */
+static void MAIN_initI2CStackCfg( void );
+
+/**
+ * @brief   Register the telemetry channels of the framework and the drivers.
+ *
+ * Must be called after all the AOs have been started (so their priorities are
+ * known) and before QF_run().
+ *
+ * @param   None
+ * @return: None
+ */
+static void MAIN_registerTelemetry( void );
+
+/**
+ * @brief   Attach a task that was just created to the stack monitor and the
+ * CPU load accounting.
+ * @param [in] idx: MainTask_t of the task.
+ * @param [in] task: TaskHandle_t of the task.
+ * @return: None
+ */
+static void MAIN_attachTask( MainTask_t idx, TaskHandle_t task );
+
+/**
+ * @brief   Bring up the ethernet PHY and MAC and then start the LWIPMgr AO.
+ *
+ * ETH_BSP_Config() waits for the link and auto-negotiation, which takes
+ * seconds, so it runs in its own low priority task once the scheduler is up
+ * instead of holding up the rest of the startup.  The task deletes itself when
+ * done.  If the PHY can't be brought up, LWIPMgr is never started and the
+ * rest of the system runs without a network.
+ *
+ * @param [in] pvParameters: unused.
+ * @return: None
+ */
+static void MAIN_netUpTask( void* pvParameters );
+
 /* Private functions ---------------------------------------------------------*/
+/*............................................................................*/
+static uint32_t MAIN_tlmPoolFree( uint32_t poolId )
+{
+    return( QF_getPoolFree((uint_fast8_t)poolId) );
+}
+
+/*............................................................................*/
+static uint32_t MAIN_tlmPoolMin( uint32_t poolId )
+{
+    return( QF_getPoolMin((uint_fast8_t)poolId) );
+}
+
+/*............................................................................*/
+static const char* MAIN_i2cName( const char *fmt, I2C_Bus_t bus )
+{
+    char *name = &l_i2cNameSto[l_i2cNameLen];
+    int len = FMT_snprintf(name, sizeof(l_i2cNameSto) - l_i2cNameLen, fmt,
+          (unsigned)bus + 1);
+    Q_ASSERT(len >= 0 && (size_t)(l_i2cNameLen + len) < sizeof(l_i2cNameSto));
+    l_i2cNameLen += len + 1;
+    return( name );
+}
+
+/*............................................................................*/
+static void MAIN_initI2CStackCfg( void )
+{
+    for( uint8_t i = 0; i < MAX_I2C_BUS; ++i ) {
+        l_stackCfg[MAIN_TASK_I2CBUS_MGR + i].name = MAIN_i2cName("I2CBusMgr%u", i);
+        l_stackCfg[MAIN_TASK_I2CBUS_MGR + i].size = MAIN_I2C_STACK_SIZE;
+        l_stackCfg[MAIN_TASK_I2CDEV_MGR + i].name = MAIN_i2cName("I2CDevMgr%u", i);
+        l_stackCfg[MAIN_TASK_I2CDEV_MGR + i].size = MAIN_I2C_STACK_SIZE;
+    }
+}
+
+/*............................................................................*/
+static void MAIN_registerTelemetry( void )
+{
+    /* Event pools, in the order they were initialized */
+    TLM_addFn("pool.sml.free", TLM_GAUGE, MAIN_tlmPoolFree, 1);
+    TLM_addFn("pool.sml.min",  TLM_GAUGE, MAIN_tlmPoolMin,  1);
+    TLM_addFn("pool.med.free", TLM_GAUGE, MAIN_tlmPoolFree, 2);
+    TLM_addFn("pool.med.min",  TLM_GAUGE, MAIN_tlmPoolMin,  2);
+    TLM_addFn("pool.lrg.free", TLM_GAUGE, MAIN_tlmPoolFree, 3);
+    TLM_addFn("pool.lrg.min",  TLM_GAUGE, MAIN_tlmPoolMin,  3);
+
+    /* Event queues and dispatch times of the AOs */
+    MAIN_TLM_ADD_AO(AO_SerialMgr,    SERIAL_MGR_PRIORITY, "SerialMgr");
+    MAIN_TLM_ADD_AO(AO_LWIPMgr,      ETH_PRIORITY,        "LWIPMgr");
+    MAIN_TLM_ADD_AO(AO_DbgMgr,       DBG_MGR_PRIORITY,    "DbgMgr");
+    MAIN_TLM_ADD_AO(AO_CommStackMgr, COMM_MGR_PRIORITY,   "CommStackMgr");
+    TLM_ADD_VAR("CPLR.q.free", TLM_GAUGE, CPLR_evtQueue.nFree);
+    TLM_ADD_VAR("CPLR.q.min",  TLM_GAUGE, CPLR_evtQueue.nMin);
+
+    /* Drivers.  Both AOs and the driver counters of every I2C bus. */
+    for( uint8_t i = 0; i < MAX_I2C_BUS; ++i ) {
+        const I2C_Stats_t *i2c = I2C_getStats(i);
+        MAIN_TLM_ADD_I2C_AO(AO_I2CBusMgr[i], I2CBUS1MGR_PRIORITY + i, i, "i2c%u.bus");
+        MAIN_TLM_ADD_I2C_AO(AO_I2CDevMgr[i], I2CDEVMGR_PRIORITY + i,  i, "i2c%u.dev");
+        TLM_ADD_VAR(MAIN_i2cName("i2c%u.reads",    i), TLM_COUNTER, i2c->nReads);
+        TLM_ADD_VAR(MAIN_i2cName("i2c%u.writes",   i), TLM_COUNTER, i2c->nWrites);
+        TLM_ADD_VAR(MAIN_i2cName("i2c%u.rdBytes",  i), TLM_COUNTER, i2c->nBytesRead);
+        TLM_ADD_VAR(MAIN_i2cName("i2c%u.wrBytes",  i), TLM_COUNTER, i2c->nBytesWritten);
+        TLM_ADD_VAR(MAIN_i2cName("i2c%u.errors",   i), TLM_COUNTER, i2c->nErrors);
+        TLM_ADD_VAR(MAIN_i2cName("i2c%u.timeouts", i), TLM_COUNTER, i2c->nTimeouts);
+    }
+
+    const DBJ_Stats_t *db = DB_getStats();
+    TLM_ADD_VAR("db.appends",     TLM_COUNTER, db->nAppends);
+    TLM_ADD_VAR("db.compactions", TLM_COUNTER, db->nCompactions);
+    TLM_ADD_VAR("db.migrations",  TLM_COUNTER, db->nMigrations);
+    TLM_ADD_VAR("db.wrBytes",     TLM_COUNTER, db->nBytesWritten);
+
+    const Serial_Stats_t *ser = Serial_getStats(SERIAL_UART1);
+    const SerialRxParser_t *serRx = Serial_getRxParser(SERIAL_UART1);
+    TLM_ADD_VAR("uart1.txBytes",  TLM_COUNTER, ser->nTxBytes);
+    TLM_ADD_VAR("uart1.txTmo",    TLM_COUNTER, ser->nTxTimeouts);
+    TLM_ADD_VAR("uart1.rxBytes",  TLM_COUNTER, serRx->nBytes);
+    TLM_ADD_VAR("uart1.rxOvf",    TLM_COUNTER, serRx->nOverflows);
+
+    /* Deepest use of every stack so far, in bytes */
+    TLM_addFn("stk.SerialMgr", TLM_GAUGE, STK_MON_getUsed, MAIN_TASK_SERIAL_MGR);
+    TLM_addFn("stk.LWIPMgr",   TLM_GAUGE, STK_MON_getUsed, MAIN_TASK_LWIP_MGR);
+    TLM_addFn("stk.DbgMgr",    TLM_GAUGE, STK_MON_getUsed, MAIN_TASK_DBG_MGR);
+    for( uint8_t i = 0; i < MAX_I2C_BUS; ++i ) {
+        TLM_addFn(MAIN_i2cName("stk.i2c%u.bus", i), TLM_GAUGE, STK_MON_getUsed,
+              MAIN_TASK_I2CBUS_MGR + i);
+        TLM_addFn(MAIN_i2cName("stk.i2c%u.dev", i), TLM_GAUGE, STK_MON_getUsed,
+              MAIN_TASK_I2CDEV_MGR + i);
+    }
+    TLM_addFn("stk.CommMgr",   TLM_GAUGE, STK_MON_getUsed, MAIN_TASK_COMM_MGR);
+    TLM_addFn("stk.CPLR",      TLM_GAUGE, STK_MON_getUsed, MAIN_TASK_CPLR);
+    TLM_addFn("stk.NetUp",     TLM_GAUGE, STK_MON_getUsed, MAIN_TASK_NET_UP);
+    TLM_addFn("stk.IDLE",      TLM_GAUGE, STK_MON_getUsed, MAIN_TASK_IDLE);
+
+    /* CPU load over the last window, in tenths of a percent */
+    TLM_addFn("cpu.busy",      TLM_GAUGE, CPU_LOAD_getBusyLast, 0);
+    TLM_addFn("cpu.SerialMgr", TLM_GAUGE, CPU_LOAD_getLast, MAIN_TASK_SERIAL_MGR);
+    TLM_addFn("cpu.LWIPMgr",   TLM_GAUGE, CPU_LOAD_getLast, MAIN_TASK_LWIP_MGR);
+    TLM_addFn("cpu.DbgMgr",    TLM_GAUGE, CPU_LOAD_getLast, MAIN_TASK_DBG_MGR);
+    for( uint8_t i = 0; i < MAX_I2C_BUS; ++i ) {
+        TLM_addFn(MAIN_i2cName("cpu.i2c%u.bus", i), TLM_GAUGE, CPU_LOAD_getLast,
+              MAIN_TASK_I2CBUS_MGR + i);
+        TLM_addFn(MAIN_i2cName("cpu.i2c%u.dev", i), TLM_GAUGE, CPU_LOAD_getLast,
+              MAIN_TASK_I2CDEV_MGR + i);
+    }
+    TLM_addFn("cpu.CommMgr",   TLM_GAUGE, CPU_LOAD_getLast, MAIN_TASK_COMM_MGR);
+    TLM_addFn("cpu.CPLR",      TLM_GAUGE, CPU_LOAD_getLast, MAIN_TASK_CPLR);
+
+#if configUSE_TICKLESS_IDLE == 1
+    /* How much the tick was stopped for */
+    const TicklessStats_t *idle = TICKLESS_getStats();
+    TLM_ADD_VAR("idle.sleeps",    TLM_COUNTER, idle->nSleeps);
+    TLM_ADD_VAR("idle.skipped",   TLM_COUNTER, idle->nTicksSkipped);
+    TLM_ADD_VAR("idle.early",     TLM_COUNTER, idle->nEarlyWakes);
+    TLM_ADD_VAR("idle.aborts",    TLM_COUNTER, idle->nAborts);
+#endif                                         /* configUSE_TICKLESS_IDLE == 1 */
+}
+
+/*............................................................................*/
+static void MAIN_attachTask( MainTask_t idx, TaskHandle_t task )
+{
+    STK_MON_attach(idx, task);
+    CPU_LOAD_attach(idx, task, l_stackCfg[idx].name);
+}
+
+/*............................................................................*/
+static void MAIN_netUpTask( void* pvParameters )
+{
+    (void) pvParameters;
+
+    /* The idle task only exists once the scheduler runs */
+    MAIN_attachTask(MAIN_TASK_IDLE, xTaskGetIdleTaskHandle());
+
+    BOOT_begin(BOOT_STEP_ETH_PHY);
+    CBErrorCode status = ETH_BSP_Config();
+    BOOT_end(BOOT_STEP_ETH_PHY);
+
+    BOOT_begin(BOOT_STEP_NET_UP);
+    if ( ERR_NONE != status ) {
+        ERR_printf("Ethernet init failed (0x%08x). Running without network.\n", status);
+    } else {
+        QACTIVE_START(AO_LWIPMgr,
+              ETH_PRIORITY,                                           /* priority */
+              l_LWIPMgrQueueSto, Q_DIM(l_LWIPMgrQueueSto),           /* evt queue */
+              (void *)0, l_stackCfg[MAIN_TASK_LWIP_MGR].size, /* stack size */
+              (QEvt *)0,                               /* no initialization event */
+              l_stackCfg[MAIN_TASK_LWIP_MGR].name             /* Name of the task */
+        );
+        MAIN_attachTask(MAIN_TASK_LWIP_MGR, AO_LWIPMgr->thread);
+        LOG_printf("Network is up\n");
+    }
+    BOOT_end(BOOT_STEP_NET_UP);
+
+    STK_MON_retire(MAIN_TASK_NET_UP);
+
+    vTaskDelete(NULL);
+}
+
 /*............................................................................*/
 int main(void)
 {
@@ -111,86 +450,39 @@ int main(void)
     DBG_ENABLE_DEBUG_FOR_MODULE(DBG_MODL_COMM);
     DBG_ENABLE_DEBUG_FOR_MODULE(DBG_MODL_CPLR);
 
-    /* initialize the Board Support Package */
+    /* initialize the Board Support Package.  This also zeroes the cycle counter
+     * so the boot timeline starts here. */
     BSP_init();
 
-    dbg_slow_printf("Initialized BSP\n");
-    log_slow_printf("Starting Bootloader version %s built on %s\n", FW_VER, BUILD_DATE);
-
-    log_slow_printf("Checking settings DB validity...\n");
-    CBErrorCode status = DB_isValid( ACCESS_BARE_METAL );
-    if ( ERR_NONE != status ) {
-       wrn_slow_printf("Settings DB validity check returned: 0x%08x\n", status);
-       wrn_slow_printf("Attempting to write default DB to EEPROM...\n");
-       status = DB_initToDefault( ACCESS_BARE_METAL );
-       if ( ERR_NONE != status ) {
-          err_slow_printf("Unable to write default DB to EEPROM. Error: 0x%08x\n", status);
-       } else {
-          log_slow_printf("Wrote default DB to EEPROM. Attempting to validate...\n");
-          status = DB_isValid( ACCESS_BARE_METAL );
-          if ( ERR_NONE != status ) {
-             err_slow_printf("DB validity check returned: 0x%08x\n", status);
-             err_slow_printf("Unable to fix DB in EEPROM\n");
-          } else {
-             log_slow_printf("A default DB has been successfully written to EEPROM\n");
-          }
-       }
-    } else {
-       log_slow_printf("Valid settings DB found.\n");
+    /* initialize QS software tracing (does nothing unless this is a spy build) */
+    if ( !QS_INIT((void *)0) ) {
+       Q_ERROR();
     }
 
-    dbg_slow_printf("Reading the MAC address from the settings DB...\n");
-    uint8_t macAddrBuffer[6];
-    memset(macAddrBuffer, 0, sizeof(macAddrBuffer));
+    dbg_slow_printf("Initialized BSP\n");
+    log_slow_printf("Starting Bootloader version %s built on %s\n", FW_VER, BUILD_DATE);
 
-    status = DB_getElemBLK(
-          DB_MAC_ADDR,
-          macAddrBuffer,
-          sizeof(macAddrBuffer),
-          ACCESS_BARE_METAL
-    );
-    if ( ERR_NONE != status ) {
-       err_slow_printf("Unable to read stored MAC address, error: 0x%08x\n", status);
-    } else {
-       log_slow_printf(
-             "Read MAC address from settings DB: %02x:%02x:%02x:%02x:%02x:%02x\n",
-             macAddrBuffer[0], macAddrBuffer[1], macAddrBuffer[2],
-             macAddrBuffer[3], macAddrBuffer[4], macAddrBuffer[5]
-       );
-    }
+    /* The settings DB is checked and read by the CPLR task and the network is
+     * brought up by MAIN_netUpTask() once the scheduler is running so neither
+     * holds up the startup of the AOs. */
 
-    /* Read the stored IP address from DB */
-    dbg_slow_printf("Reading the IP address from the settings DB...\n");
-    uint8_t ipAddrBuffer[4];
-    memset(ipAddrBuffer, 0, sizeof(ipAddrBuffer));
-    status = DB_getElemBLK(
-          DB_IP_ADDR,
-          ipAddrBuffer,
-          sizeof(ipAddrBuffer),
-          ACCESS_BARE_METAL
-    );
-
-    if ( ERR_NONE != status ) {
-       err_slow_printf("Unable to read stored IP address, error: 0x%08x\n", status);
-    } else {
-       log_slow_printf(
-             "Read IP address from settings DB: %d:%d:%d:%d\n",
-             ipAddrBuffer[0], ipAddrBuffer[1], ipAddrBuffer[2], ipAddrBuffer[3]
-       );
-    }
+    /* Start with an empty telemetry channel table.  LWIPMgr registers the
+     * network channels when it starts and the rest are registered below. */
+    TLM_init();
 
     /* Instantiate the Active objects by calling their "constructors"         */
+    BOOT_begin(BOOT_STEP_QF_INIT);
     dbg_slow_printf("Initializing AO constructors\n");
     SerialMgr_ctor();
     LWIPMgr_ctor();
 
     /* Iterate though the available I2C busses on the system and call the ctor()
-     * for each instance of the I2CBusMgr AO for each bus. */
+     * for each instance of the I2CBusMgr and I2CDevMgr AOs for each bus. */
     for( uint8_t i = 0; i < MAX_I2C_BUS; ++i ) {
        I2CBusMgr_ctor( i );      /* Start this instance of AO for this bus. */
+       I2CDevMgr_ctor( i );      /* Start this instance of AO for this bus. */
     }
 
-    I2C1DevMgr_ctor();
     CommStackMgr_ctor();
     DbgMgr_ctor();                           /* This AO should start up last */
 
@@ -205,7 +497,7 @@ int main(void)
     QS_OBJ_DICTIONARY(l_SerialMgrQueueSto);
     QS_OBJ_DICTIONARY(l_LWIPMgrQueueSto);
     QS_OBJ_DICTIONARY(l_I2CBusMgrQueueSto);
-    QS_OBJ_DICTIONARY(l_I2C1DevMgrQueueSto);
+    QS_OBJ_DICTIONARY(l_I2CDevMgrQueueSto);
     QS_OBJ_DICTIONARY(l_CommStackMgrQueueSto);
     QS_OBJ_DICTIONARY(l_DbgMgrQueueSto);
 
@@ -220,32 +512,42 @@ int main(void)
     /* initialize the raw queues */
     QEQueue_init(&CPLR_evtQueue, l_CPLRQueueSto, Q_DIM(l_CPLRQueueSto));
 
+    BOOT_end(BOOT_STEP_QF_INIT);
+
     /* Start Active objects */
+    BOOT_begin(BOOT_STEP_AO_START);
     dbg_slow_printf("Starting Active Objects\n");
 
+    /* Every task below takes its stack size from l_stackCfg and is attached to
+     * the stack monitor and the CPU load accounting right after it's created. */
+    MAIN_initI2CStackCfg();
+    STK_MON_init(l_stackCfg, MAIN_TASK_MAX);
+    CPU_LOAD_init(MAIN_TASK_MAX);
+
+#ifdef QF_EVT_REC
+    /* Before the first AO starts so a replay gets every initial transition */
+    EVT_REC_start(EVT_REC_MODE_ONCE, SystemCoreClock);
+#endif                                                          /* QF_EVT_REC */
+
     QACTIVE_START(AO_SerialMgr,
           SERIAL_MGR_PRIORITY,                                    /* priority */
           l_SerialMgrQueueSto, Q_DIM(l_SerialMgrQueueSto),       /* evt queue */
-          (void *)0, THREAD_STACK_SIZE,              /* per-thread stack size */
+          (void *)0, l_stackCfg[MAIN_TASK_SERIAL_MGR].size,     /* stack size */
           (QEvt *)0,                               /* no initialization event */
-          "SerialMgr"                                     /* Name of the task */
+          l_stackCfg[MAIN_TASK_SERIAL_MGR].name           /* Name of the task */
     );
+    MAIN_attachTask(MAIN_TASK_SERIAL_MGR, AO_SerialMgr->thread);
 
-    QACTIVE_START(AO_LWIPMgr,
-          ETH_PRIORITY,                                           /* priority */
-          l_LWIPMgrQueueSto, Q_DIM(l_LWIPMgrQueueSto),           /* evt queue */
-          (void *)0, THREAD_STACK_SIZE,              /* per-thread stack size */
-          (QEvt *)0,                               /* no initialization event */
-          "LWIPMgr"                                       /* Name of the task */
-    );
+    /* LWIPMgr is started by MAIN_netUpTask() once the PHY is up */
 
     QACTIVE_START(AO_DbgMgr,
           DBG_MGR_PRIORITY,                                       /* priority */
           l_DbgMgrQueueSto, Q_DIM(l_DbgMgrQueueSto),             /* evt queue */
-          (void *)0, THREAD_STACK_SIZE,         /* per-thread stack size */
+          (void *)0, l_stackCfg[MAIN_TASK_DBG_MGR].size,        /* stack size */
           (QEvt *)0,                               /* no initialization event */
-          "DbgMgr"                                        /* Name of the task */
+          l_stackCfg[MAIN_TASK_DBG_MGR].name              /* Name of the task */
     );
+    MAIN_attachTask(MAIN_TASK_DBG_MGR, AO_DbgMgr->thread);
 
     /* Iterate though the available I2C busses on the system and start an
      * instance of the I2CBusMgr AO for each bus.
@@ -256,38 +558,62 @@ int main(void)
     QACTIVE_START(AO_I2CBusMgr[i],
           I2CBUS1MGR_PRIORITY + i,                                /* priority */
           l_I2CBusMgrQueueSto[i], Q_DIM(l_I2CBusMgrQueueSto[i]), /* evt queue */
-          (void *)0, THREAD_STACK_SIZE,              /* per-thread stack size */
+          (void *)0, l_stackCfg[MAIN_TASK_I2CBUS_MGR + i].size, /* stack size */
           (QEvt *)0,                               /* no initialization event */
-          "I2CBusMgr"                                     /* Name of the task */
+          l_stackCfg[MAIN_TASK_I2CBUS_MGR + i].name       /* Name of the task */
     );
+    MAIN_attachTask(MAIN_TASK_I2CBUS_MGR + i, AO_I2CBusMgr[i]->thread);
     }
 
-    QACTIVE_START(AO_I2C1DevMgr,
-          I2C1DEVMGR_PRIORITY,                                    /* priority */
-          l_I2C1DevMgrQueueSto, Q_DIM(l_I2C1DevMgrQueueSto),     /* evt queue */
-          (void *)0, THREAD_STACK_SIZE,              /* per-thread stack size */
+    /* Same for the I2CDevMgr AO instances.  Each one has its own queue so a
+     * slow device on one bus never holds up requests for another bus. */
+    for( uint8_t i = 0; i < MAX_I2C_BUS; ++i ) {
+    QACTIVE_START(AO_I2CDevMgr[i],
+          I2CDEVMGR_PRIORITY + i,                                 /* priority */
+          l_I2CDevMgrQueueSto[i], Q_DIM(l_I2CDevMgrQueueSto[i]), /* evt queue */
+          (void *)0, l_stackCfg[MAIN_TASK_I2CDEV_MGR + i].size, /* stack size */
           (QEvt *)0,                               /* no initialization event */
-          "I2CDevMgr"                                     /* Name of the task */
+          l_stackCfg[MAIN_TASK_I2CDEV_MGR + i].name       /* Name of the task */
     );
+    MAIN_attachTask(MAIN_TASK_I2CDEV_MGR + i, AO_I2CDevMgr[i]->thread);
+    }
 
     QACTIVE_START(AO_CommStackMgr,
           COMM_MGR_PRIORITY,                                      /* priority */
           l_CommStackMgrQueueSto, Q_DIM(l_CommStackMgrQueueSto), /* evt queue */
-          (void *)0, THREAD_STACK_SIZE,              /* per-thread stack size */
+          (void *)0, l_stackCfg[MAIN_TASK_COMM_MGR].size,       /* stack size */
           (QEvt *)0,                               /* no initialization event */
-          "CommMgr"                                       /* Name of the task */
+          l_stackCfg[MAIN_TASK_COMM_MGR].name             /* Name of the task */
     );
+    MAIN_attachTask(MAIN_TASK_COMM_MGR, AO_CommStackMgr->thread);
 
+    /* Unlike QACTIVE_START(), xTaskCreate() takes the stack size in words */
     xTaskCreate(
           CPLR_Task,
-          ( const char * ) "CPLRTask",                    /* Name of the task */
-          THREAD_STACK_SIZE,                         /* per-thread stack size */
+          l_stackCfg[MAIN_TASK_CPLR].name,                /* Name of the task */
+          l_stackCfg[MAIN_TASK_CPLR].size / sizeof(StackType_t), /* stack size */
           NULL,                             /* arguments to the task function */
           CPLR_PRIORITY,                                          /* priority */
           ( xTaskHandle * ) &xHandle_CPLR                      /* Task handle */
     );
+    MAIN_attachTask(MAIN_TASK_CPLR, xHandle_CPLR);
+
+    xTaskCreate(
+          MAIN_netUpTask,
+          l_stackCfg[MAIN_TASK_NET_UP].name,              /* Name of the task */
+          l_stackCfg[MAIN_TASK_NET_UP].size / sizeof(StackType_t), /* stack size */
+          NULL,                             /* arguments to the task function */
+          NET_UP_TASK_PRIORITY,                                   /* priority */
+          ( xTaskHandle * ) &l_netUpTask                       /* Task handle */
+    );
+    MAIN_attachTask(MAIN_TASK_NET_UP, l_netUpTask);
+    BOOT_end(BOOT_STEP_AO_START);
+
+    MAIN_registerTelemetry();
+    dbg_slow_printf("Registered %d telemetry channels\n", TLM_getNChannels());
 
     log_slow_printf("Starting QPC. All logging from here on out shouldn't show 'SLOW'!!!\n\n");
+    BOOT_begin(BOOT_STEP_SCHED);                /* Ended by the CPLR task */
     QF_run();                                       /* run the QF application */
 
     return(0);
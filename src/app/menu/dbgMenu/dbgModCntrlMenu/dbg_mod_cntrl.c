@@ -25,54 +25,44 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_DBG );/* For debug system to ID this module */
 /* Private macros ------------------------------------------------------------*/
 /* Private variables and Local objects ---------------------------------------*/
 
-treeNode_t menuDbgModCntrl;
-char *const menuDbgModCntrl_TitleTxt = "Debug Module Control Menu";
-char *const menuDbgModCntrl_SelectKey = "MOD";
+const char menuDbgModCntrl_TitleTxt[] = "Debug Module Control Menu";
+const char menuDbgModCntrl_SelectKey[] = "MOD";
 
-treeNode_t menuDbgModCntrlItem_toggleModGen;
-char *const menuDbgModCntrlItem_toggleModGenTxt =
+const char menuDbgModCntrlItem_toggleModGenTxt[] =
       "Toggle GENERAL module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModGenSelectKey = "GEN";
+const char menuDbgModCntrlItem_toggleModGenSelectKey[] = "GEN";
 
-treeNode_t menuDbgModCntrlItem_toggleModSer;
-char *const menuDbgModCntrlItem_toggleModSerTxt =
+const char menuDbgModCntrlItem_toggleModSerTxt[] =
       "Toggle SERIAL module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModSerSelectKey = "SER";
+const char menuDbgModCntrlItem_toggleModSerSelectKey[] = "SER";
 
-treeNode_t menuDbgModCntrlItem_toggleModTime;
-char *const menuDbgModCntrlItem_toggleModTimeTxt =
+const char menuDbgModCntrlItem_toggleModTimeTxt[] =
       "Toggle TIME module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModTimeSelectKey = "TIM";
+const char menuDbgModCntrlItem_toggleModTimeSelectKey[] = "TIM";
 
-treeNode_t menuDbgModCntrlItem_toggleModEth;
-char *const menuDbgModCntrlItem_toggleModEthTxt =
+const char menuDbgModCntrlItem_toggleModEthTxt[] =
       "Toggle ETHERNET module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModEthSelectKey = "ETH";
+const char menuDbgModCntrlItem_toggleModEthSelectKey[] = "ETH";
 
-treeNode_t menuDbgModCntrlItem_toggleModI2C;
-char *const menuDbgModCntrlItem_toggleModI2CTxt =
+const char menuDbgModCntrlItem_toggleModI2CTxt[] =
       "Toggle I2C module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModI2CSelectKey = "I2C";
+const char menuDbgModCntrlItem_toggleModI2CSelectKey[] = "I2C";
 
-treeNode_t menuDbgModCntrlItem_toggleModNOR;
-char *const menuDbgModCntrlItem_toggleModNORTxt =
+const char menuDbgModCntrlItem_toggleModNORTxt[] =
       "Toggle NOR module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModNORSelectKey = "NOR";
+const char menuDbgModCntrlItem_toggleModNORSelectKey[] = "NOR";
 
-treeNode_t menuDbgModCntrlItem_toggleModSDR;
-char *const menuDbgModCntrlItem_toggleModSDRTxt =
+const char menuDbgModCntrlItem_toggleModSDRTxt[] =
       "Toggle SDRAM module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModSDRSelectKey = "SDR";
+const char menuDbgModCntrlItem_toggleModSDRSelectKey[] = "SDR";
 
-treeNode_t menuDbgModCntrlItem_toggleModDBG;
-char *const menuDbgModCntrlItem_toggleModDBGTxt =
+const char menuDbgModCntrlItem_toggleModDBGTxt[] =
       "Toggle DBG module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModDBGSelectKey = "DBG";
+const char menuDbgModCntrlItem_toggleModDBGSelectKey[] = "DBG";
 
-treeNode_t menuDbgModCntrlItem_toggleModCOMM;
-char *const menuDbgModCntrlItem_toggleModCOMMTxt =
+const char menuDbgModCntrlItem_toggleModCOMMTxt[] =
       "Toggle COMM module debugging ON/OFF";
-char *const menuDbgModCntrlItem_toggleModCOMMSelectKey = "COM";
+const char menuDbgModCntrlItem_toggleModCOMMSelectKey[] = "COM";
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -29,45 +29,35 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
 
-extern treeNode_t menuDbgModCntrl;
-extern char *const menuDbgModCntrl_TitleTxt;
-extern char *const menuDbgModCntrl_SelectKey;
+extern const char menuDbgModCntrl_TitleTxt[];
+extern const char menuDbgModCntrl_SelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModGen;
-extern char *const menuDbgModCntrlItem_toggleModGenTxt;
-extern char *const menuDbgModCntrlItem_toggleModGenSelectKey;
+extern const char menuDbgModCntrlItem_toggleModGenTxt[];
+extern const char menuDbgModCntrlItem_toggleModGenSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModSer;
-extern char *const menuDbgModCntrlItem_toggleModSerTxt;
-extern char *const menuDbgModCntrlItem_toggleModSerSelectKey;
+extern const char menuDbgModCntrlItem_toggleModSerTxt[];
+extern const char menuDbgModCntrlItem_toggleModSerSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModTime;
-extern char *const menuDbgModCntrlItem_toggleModTimeTxt;
-extern char *const menuDbgModCntrlItem_toggleModTimeSelectKey;
+extern const char menuDbgModCntrlItem_toggleModTimeTxt[];
+extern const char menuDbgModCntrlItem_toggleModTimeSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModEth;
-extern char *const menuDbgModCntrlItem_toggleModEthTxt;
-extern char *const menuDbgModCntrlItem_toggleModEthSelectKey;
+extern const char menuDbgModCntrlItem_toggleModEthTxt[];
+extern const char menuDbgModCntrlItem_toggleModEthSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModI2C;
-extern char *const menuDbgModCntrlItem_toggleModI2CTxt;
-extern char *const menuDbgModCntrlItem_toggleModI2CSelectKey;
+extern const char menuDbgModCntrlItem_toggleModI2CTxt[];
+extern const char menuDbgModCntrlItem_toggleModI2CSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModNOR;
-extern char *const menuDbgModCntrlItem_toggleModNORTxt;
-extern char *const menuDbgModCntrlItem_toggleModNORSelectKey;
+extern const char menuDbgModCntrlItem_toggleModNORTxt[];
+extern const char menuDbgModCntrlItem_toggleModNORSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModSDR;
-extern char *const menuDbgModCntrlItem_toggleModSDRTxt;
-extern char *const menuDbgModCntrlItem_toggleModSDRSelectKey;
+extern const char menuDbgModCntrlItem_toggleModSDRTxt[];
+extern const char menuDbgModCntrlItem_toggleModSDRSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModDBG;
-extern char *const menuDbgModCntrlItem_toggleModDBGTxt;
-extern char *const menuDbgModCntrlItem_toggleModDBGSelectKey;
+extern const char menuDbgModCntrlItem_toggleModDBGTxt[];
+extern const char menuDbgModCntrlItem_toggleModDBGSelectKey[];
 
-extern treeNode_t menuDbgModCntrlItem_toggleModCOMM;
-extern char *const menuDbgModCntrlItem_toggleModCOMMTxt;
-extern char *const menuDbgModCntrlItem_toggleModCOMMSelectKey;
+extern const char menuDbgModCntrlItem_toggleModCOMMTxt[];
+extern const char menuDbgModCntrlItem_toggleModCOMMSelectKey[];
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -25,19 +25,16 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_DBG );/* For debug system to ID this module */
 /* Private macros ------------------------------------------------------------*/
 /* Private variables and Local objects ---------------------------------------*/
 
-treeNode_t menuDbgOutCntrl;
-char *const menuDbgOutCntrl_TitleTxt = "Debug Output Control Menu";
-char *const menuDbgOutCntrl_SelectKey = "OUT";
+const char menuDbgOutCntrl_TitleTxt[] = "Debug Output Control Menu";
+const char menuDbgOutCntrl_SelectKey[] = "OUT";
 
-treeNode_t menuDbgOutCntrlItem_toggleSerialDebug;
-char *const menuDbgOutCntrlItem_toggleSerialDebugTxt =
+const char menuDbgOutCntrlItem_toggleSerialDebugTxt[] =
       "Toggle debugging over serial port ON/OFF";
-char *const menuDbgOutCntrlItem_toggleSerialDebugSelectKey = "S";
+const char menuDbgOutCntrlItem_toggleSerialDebugSelectKey[] = "S";
 
-treeNode_t menuDbgOutCntrlItem_toggleEthDebug;
-char *const menuDbgOutCntrlItem_toggleEthDebugTxt =
+const char menuDbgOutCntrlItem_toggleEthDebugTxt[] =
       "Toggle debugging over ethernet port ON/OFF";
-char *const menuDbgOutCntrlItem_toggleEthDebugSelectKey = "E";
+const char menuDbgOutCntrlItem_toggleEthDebugSelectKey[] = "E";
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -28,17 +28,14 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
 
-extern treeNode_t menuDbgOutCntrl;
-extern char *const menuDbgOutCntrl_TitleTxt;
-extern char *const menuDbgOutCntrl_SelectKey;
+extern const char menuDbgOutCntrl_TitleTxt[];
+extern const char menuDbgOutCntrl_SelectKey[];
 
-extern treeNode_t menuDbgOutCntrlItem_toggleSerialDebug;
-extern char *const menuDbgOutCntrlItem_toggleSerialDebugTxt;
-extern char *const menuDbgOutCntrlItem_toggleSerialDebugSelectKey;
+extern const char menuDbgOutCntrlItem_toggleSerialDebugTxt[];
+extern const char menuDbgOutCntrlItem_toggleSerialDebugSelectKey[];
 
-extern treeNode_t menuDbgOutCntrlItem_toggleEthDebug;
-extern char *const menuDbgOutCntrlItem_toggleEthDebugTxt;
-extern char *const menuDbgOutCntrlItem_toggleEthDebugSelectKey;
+extern const char menuDbgOutCntrlItem_toggleEthDebugTxt[];
+extern const char menuDbgOutCntrlItem_toggleEthDebugSelectKey[];
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -14,6 +14,9 @@
 #include "qp_port.h"                                        /* for QP support */
 #include "project_includes.h"
 #include "debug_menu.h"
+#include "stack_mon.h"                               /* for stack usage info */
+#include "cpu_load.h"                                  /* for CPU load info */
+#include "evt_rec.h"                               /* for event recorder info */
 
 /* Compile-time called macros ------------------------------------------------*/
 Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
@@ -22,16 +25,143 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_DBG );/* For debug system to ID this module */
 /* Private typedefs ----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
+
+/**< Splits tenths of a percent into the two arguments of a "%u.%u" */
+#define MENU_PERMILLE_ARGS( x_ )                        (x_) / 10, (x_) % 10
+
 /* Private variables and Local objects ---------------------------------------*/
 
-treeNode_t menuDbg;
-char *const menuDbg_TitleTxt = "Debug Menu";
-char *const menuDbg_SelectKey = "DBG";
+const char menuDbg_TitleTxt[] = "Debug Menu";
+const char menuDbg_SelectKey[] = "DBG";
+
+const char menuDbgItem_printStackUsageTxt[] =
+      "Print stack usage of every task";
+const char menuDbgItem_printStackUsageSelectKey[] = "STK";
+
+const char menuDbgItem_printCpuLoadTxt[] =
+      "Print CPU load of every task";
+const char menuDbgItem_printCpuLoadSelectKey[] = "CPU";
+
+const char menuDbgItem_printEvtRecTxt[] =
+      "Print event recorder status";
+const char menuDbgItem_printEvtRecSelectKey[] = "EVT";
 
 /* Private function prototypes -----------------------------------------------*/
 
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+void MENU_printStackUsageAction(
+      const char* dataBuf,
+      uint16_t dataLen,
+      MsgSrc dst
+)
+{
+   MenuRender_t render;
+   StackInfo_t info;
+   uint32_t totalSize = 0;
+   uint32_t totalRec = 0;
+
+   STK_MON_sampleAll();
+
+   MENU_renderInit(&render, dst);
+   MENU_renderPrintf(&render, "%-16s %6s %6s %5s %6s\n",
+         "Task", "Size", "Used", "Use%", "Rec");
+   for ( uint8_t i = 0; STK_MON_getInfo( i, &info ); i++ ) {
+      MENU_renderPrintf(&render, "%-16s %6u %6u %4u%% %6u%s\n",
+            info.name, info.size, info.used, info.used * 100 / info.size,
+            info.recommended,
+            info.bRunning ? "" : ( 0 == info.used ? "  not started" : "  exited" ));
+
+      /* Only tasks that have run say anything about what can be saved */
+      if ( 0 != info.recommended ) {
+         totalSize += info.size;
+         totalRec  += info.recommended;
+      }
+   }
+   MENU_renderPrintf(&render, "%-16s %6u %6s %5s %6u\n",
+         "Total", totalSize, "", "", totalRec);
+   MENU_renderPrintf(&render,
+         "Rec is the deepest use so far plus %u%%.  Only paths taken since "
+         "boot count.\n", STK_MON_MARGIN_PCT);
+   MENU_renderFlush(&render);
+}
+
+/******************************************************************************/
+void MENU_printCpuLoadAction(
+      const char* dataBuf,
+      uint16_t dataLen,
+      MsgSrc dst
+)
+{
+   MenuRender_t render;
+   CpuLoadInfo_t info;
+
+   if ( 0 == CPU_LOAD_getBusy( &info ) ) {
+      MENU_printf(dst, "No CPU load window has closed yet.\n");
+      return;
+   }
+
+   MENU_renderInit(&render, dst);
+   MENU_renderPrintf(&render, "%-16s %7s %7s %7s\n",
+         "Task", "Last", "Avg", "Peak");
+   MENU_renderPrintf(&render, "%-16s %4u.%u%% %4u.%u%% %4u.%u%%\n",
+         "Busy", MENU_PERMILLE_ARGS(info.last), MENU_PERMILLE_ARGS(info.avg),
+         MENU_PERMILLE_ARGS(info.peak));
+   for ( uint8_t i = 0; CPU_LOAD_getInfo( i, &info ); i++ ) {
+      MENU_renderPrintf(&render, "%-16s %4u.%u%% %4u.%u%% %4u.%u%%%s\n",
+            NULL != info.name ? info.name : "?",
+            MENU_PERMILLE_ARGS(info.last), MENU_PERMILLE_ARGS(info.avg),
+            MENU_PERMILLE_ARGS(info.peak),
+            info.bRunning ? "" : ( NULL == info.name ? "  not started" : "  exited" ));
+   }
+   MENU_renderPrintf(&render,
+         "Last is the last %u ms, Avg the last %u of those, Peak the highest "
+         "since boot.\n", CPU_LOAD_WINDOW_MS, CPU_LOAD_N_WINDOWS);
+   MENU_renderFlush(&render);
+}
+
+/******************************************************************************/
+void MENU_printEvtRecAction(
+      const char* dataBuf,
+      uint16_t dataLen,
+      MsgSrc dst
+)
+{
+   MenuRender_t render;
+   uint32_t nKind[EVT_REC_DATA + 1] = { 0 };
+   uint32_t first;
+
+   const EvtRecHdr_t *hdr = EVT_REC_getRing();
+   if ( NULL == hdr ) {
+      MENU_printf(dst, "Event recorder not built in (make EVT_REC=1).\n");
+      return;
+   }
+
+   uint32_t n = EVT_REC_span( hdr, &first );
+   for ( uint32_t i = 0; i < n; i++ ) {
+      uint8_t kind = EVT_REC_slot( hdr, first + i )->kind;
+      if ( kind <= EVT_REC_DATA ) {
+         nKind[kind]++;
+      }
+   }
+
+   MENU_renderInit(&render, dst);
+   MENU_renderPrintf(&render, "Recording %s, %s ring of %u slots, %u used, "
+         "%u records lost\n",
+         EVT_REC_isRecording() ? "on" : "off",
+         EVT_REC_MODE_ONCE == hdr->mode ? "one shot" : "wrapping",
+         hdr->nSlots, n, hdr->nLost);
+   MENU_renderPrintf(&render, "Posts %u (LIFO %u, dropped %u), dispatches %u, "
+         "initial transitions %u\n",
+         nKind[EVT_REC_POST] + nKind[EVT_REC_POST_LIFO], nKind[EVT_REC_POST_LIFO],
+         nKind[EVT_REC_DROP], nKind[EVT_REC_DISPATCH], nKind[EVT_REC_INIT]);
+   MENU_renderPrintf(&render, "Save it with gdb: dump binary memory rec.bin "
+         "0x%08x 0x%08x\n", (uint32_t)hdr,
+         (uint32_t)hdr + sizeof(EvtRecHdr_t) + hdr->nSlots * hdr->slotSize);
+   MENU_renderFlush(&render);
+}
+
 /**
  * @}
  * end addtogroup groupMenu
@@ -27,12 +27,68 @@ extern "C" {
 /* Exported macros -----------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
-extern treeNode_t menuDbg;
-extern char *const menuDbg_TitleTxt;
-extern char *const menuDbg_SelectKey;
+extern const char menuDbg_TitleTxt[];
+extern const char menuDbg_SelectKey[];
+
+extern const char menuDbgItem_printStackUsageTxt[];
+extern const char menuDbgItem_printStackUsageSelectKey[];
+
+extern const char menuDbgItem_printCpuLoadTxt[];
+extern const char menuDbgItem_printCpuLoadSelectKey[];
+
+extern const char menuDbgItem_printEvtRecTxt[];
+extern const char menuDbgItem_printEvtRecSelectKey[];
 
 /* Exported functions --------------------------------------------------------*/
 
+/**
+ * @brief Called by the menu item to print how much of its stack every task
+ * has used so far and the size recommended for it.
+ * @param [in] dataBuf: const char* pointer to the data passed in by the user at
+ * cmd line
+ * @param [in] dataLen: uint16_t length of data in the dataBuf.
+ * @param [in] dst: MsgSrc destination so MENU_printf() knows were to direct the
+ * output.
+ * @return: None
+ */
+void MENU_printStackUsageAction(
+      const char* dataBuf,
+      uint16_t dataLen,
+      MsgSrc dst
+);
+
+/**
+ * @brief Called by the menu item to print the share of the CPU every task got
+ * over the last window, averaged over the windows kept, and at its highest.
+ * @param [in] dataBuf: const char* pointer to the data passed in by the user at
+ * cmd line
+ * @param [in] dataLen: uint16_t length of data in the dataBuf.
+ * @param [in] dst: MsgSrc destination so MENU_printf() knows were to direct the
+ * output.
+ * @return: None
+ */
+void MENU_printCpuLoadAction(
+      const char* dataBuf,
+      uint16_t dataLen,
+      MsgSrc dst
+);
+
+/**
+ * @brief Called by the menu item to print what the event recorder has taken
+ * so far and where to save it from.
+ * @param [in] dataBuf: const char* pointer to the data passed in by the user at
+ * cmd line
+ * @param [in] dataLen: uint16_t length of data in the dataBuf.
+ * @param [in] dst: MsgSrc destination so MENU_printf() knows were to direct the
+ * output.
+ * @return: None
+ */
+void MENU_printEvtRecAction(
+      const char* dataBuf,
+      uint16_t dataLen,
+      MsgSrc dst
+);
+
 /**
  * @}
  * end addtogroup groupMenu
@@ -1,7 +1,7 @@
 /**
  * @file    ktree.h
- * @brief   Implementation of a statically allocated k-ary tree structure that
- * is used by the menu.
+ * @brief   Implementation of a constant, flash resident k-ary tree structure
+ * that is used by the menu.
  *
  * @date    09/29/2014
  * @author  Harry Rostovtsev
@@ -9,106 +9,42 @@
  * Copyright (C) 2014 Harry Rostovtsev. All rights reserved.
  *
  * # Design of the KTREE algorithm
- * The Menu is built around a k-ary tree (k-tree) which is implemented as a
- * binary tree (b-tree). Unlike a regular k-tree where a node can have multiple
- * children which would make sense for a menu system, since the system is memory
- * and resource constrained, a binary tree makes more since.  It allows for
- * statically allocated nodes without using fixed sized arrays to store child
- * nodes. This implementation is a little confusing at first but is actually
- * used in several resource sensitive systems such as the Linux kernel.
+ * The Menu is built around a k-ary tree (k-tree) that is entirely described at
+ * compile time as a single const array of nodes.  Since the array is const, the
+ * linker places it in flash and it takes up no RAM and no time to build at
+ * startup.
  *
- * A regular k-tree is represented as:
- * struct t {
- *    int n;
- *    int numKids;
- *    struct t **kids;
- * }
+ * Each node has a pointer to its parent and to the first of its children.  All
+ * the children of a node are stored next to each other in the array, so the
+ * k children of a node are simply firstChildNode[0] to firstChildNode[k-1]:
  *
- * and the resulting tree struture looks like:
+ *  [0] TOP         parent: NULL    children: [1]..[2]  depth: 0
+ *  [1] Menu 1      parent: [0]     children: [3]..[4]  depth: 1
+ *  [2] Menu 2      parent: [0]     children: [5]..[5]  depth: 1
+ *  [3] Item 1.1    parent: [1]     children: none      depth: 2
+ *  [4] Item 1.2    parent: [1]     children: none      depth: 2
+ *  [5] Item 2.1    parent: [2]     children: none      depth: 2
+ *
+ * Where the tree represented is:
  *
  *  TOP
  *  |
  *  [ list of kids ]
- *  |     |      |
- *  k1    k2     k3
- *  |
- *  |
- *  [list of kids]
- *  |     |     |
- *  k1.1  k1.2  k1.3
- *
- * This representation works if you have things like malloc but on an embedded
- * system where using malloc is anathema, if you want to add another child, use
- * a static array of limited length in addition to having to record the number
- * of kids in the array in the structure.
- *
- * Instead, the following structure is used:
- * struct t {
- *    int n;
- *    struct t *firstChildNode;
- *    struct t *firstSiblingNode;
- *    struct t *trueParentNode;
- *    struct t *fakeParentNode;
- * };
- *
- * and the tree representation looks like:
- *
- * ___________
- * [TOP NODE ] <-
- * -----------   \
- * ^|  ^          \
- * ||  |           \ fP
- * ||  |tP, fP      \
- * ||  |_______  fS  \__________     fS
- * ||  [NODE 2]------>[NODE 2.1]---------->NULL
- * ||  ------- <------ ---------
- * ||       |      tP      |
- * ||       |fC            |fC
- * ||fC     V              V
- * ||      NULL          NULL
- * ||
- * |tP, fP
- * ||
- * |V_____
- * [NODE1]
- * -------
- *    ^
- *    |tP, fp
- *    |_________   fS
- *    [NODE 1.1] -----> NULL
- *        |
- *        |fC
- *        |
- *        V
- *      NULL
- *
- * Where:
- * fP = fakeParentNode - this pointer is used to figure out where the actual
- * parent as it would appear in a classical k-ary tree.
- * tP = trueParentNode - this pointer is used to show where this node is actually
- * attached since it could be either a child node of another node or a sibling.
- * fC = firstChildNode - pointer to the first child node.
- * fS = firstSiblingNode - pointer to the first sibling node.
- *
- * From any node, you can only access the first child or the first sibling,
- * making this a classical b-tree. From that first child, you can access it's
- * children and siblings.  Likewise for the first sibling pointer. This way all
- * the nodes are stored in a list which can be comprised of statically allocated
- * structures.  The true and fake Parent pointers are for easily tracing the
- * ancestry of each child node.  The fake parent pointer is used to map a
- * classical k-tree structure over this b-tree.
- *
- * There are several advantages to this seemingly confusing approach:
- * - Each node is a fixed size and can be statically allocated.
- * - No arrays are needed for representing child nodes.
- * - Many algorithms can be easily expressed since it's just a b-tree.
- *
- * This implementation of the menu is limited in that the functionality to remove
- * nodes is not present since this doesn't seem to be a necessary feature for a
- * menu.  To add a menu or menu item is very simple.  See example in menu_top.c
- *
- * This design was inspired by
- * https://blog.mozilla.org/nnethercote/2012/03/07/n-ary-trees-in-c/
+ *  |          |
+ *  Menu 1     Menu 2
+ *  |          |
+ *  [kids]     [kids]
+ *  |     |    |
+ *  1.1   1.2  2.1
+ *
+ * The children of every node are stored sorted by their selector string so a
+ * selector can be found with a binary search instead of walking a list and
+ * comparing strings one by one.  The depth of every node is also stored in the
+ * table so the ancestry of a node can be found by following the parent pointers
+ * without any searching or recursion.
+ *
+ * These rules can't be checked by the compiler so KTREE_validate() should be
+ * called once at startup to make sure that the hand written table is correct.
  *
  * @addtogroup groupMenu
  * @{
@@ -135,97 +71,63 @@ typedef void (*pMenuFunction) (
       MsgSrc dst
 );
 
+/**
+ * @brief   A single node of the constant menu tree.
+ */
 typedef struct treeNode {
-   struct treeNode *fakeParentNode;
-   struct treeNode *trueParentNode;
-   struct treeNode *firstChildNode;
-   struct treeNode *firstSiblingNode;
-   char *text;
-   char *selector;
-   pMenuFunction actionToTake;
+   const char *text;                          /**< Text displayed for the node */
+   const char *selector;       /**< Text the user types to select this node */
+   pMenuFunction actionToTake;    /**< Action to run when selected or NULL */
+   const struct treeNode *parentNode;     /**< Parent node or NULL for root */
+   const struct treeNode *firstChildNode;   /**< First child or NULL if none */
+   uint8_t nChildren;    /**< Number of children stored from firstChildNode */
+   uint8_t depth;                /**< Number of ancestors, 0 for the root */
 } treeNode_t;
 
-
 /* Exported macros -----------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
 
-
 /**
- * @brief   Initialize the menu memory space with the contents of the menu
+ * @brief   Find the child of a node with a matching selector.
  *
- * This function initializes the menu application.
+ * Does a binary search of the children of the passed in node.  The selector
+ * has to match exactly.  A prefix of a selector is not a match.
  *
- * @param [in]  iBus: I2C_Bus_t identifier for I2C bus to initialize
- *    @arg
- * @return: None
+ * @param [in] *node: treeNode_t pointer to the node whose children to search.
+ * @param [in] *selector: const char pointer to the selector to look for.  Does
+ * not need to be NULL terminated.
+ * @param [in] selectorLen: uint16_t length of the selector.
+ * @return: treeNode_t* pointer to the matching child or NULL if not found.
  */
-void KTREE_nodeCtor( treeNode_t *node );
-
-/**
- * @brief   Counts the depth (via fakeParentNode pointer) of the passed in
- * pointer to a node.
- *
- * Recursive function that counts it's own depth by traversing the tree up via
- * the fakeParentNode pointer and counting.
- *
- * @param [in]  *node: treeNode_t pointer to the node
- * @parem [in] currDepth: uint8_t value of the current depth.  Unless you want
- * to for some reason offset where you start counting from, pass in 0 here.
- * @return: uint8_t depth of the current node.
- */
-uint8_t KTREE_findDepth( treeNode_t *node, uint8_t currDepth );
-
-/**
- * @brief   Adds a child node to a passed in parent node.
- *
- * This function adds a child node to a passed in parent node after doing some
- * initial checking of both nodes.
- *
- * @param [in] childNode: treeNode_t* pointer to the node to be added as a child
- * @parem [in] trueParentNone: treeNode_t* pointer to the node that the child
- * node will be directly attached to because it may appear as a sibling node or
- * an actual child node.
- * @parem [in] fakeParentNone: treeNode_t* pointer to the node that indicates
- * the "regular" tree depth of this child node.
- * @return: None
- */
-void KTREE_addChild(
-      treeNode_t *childToAdd,
-      treeNode_t *trueParentNode,
-      treeNode_t *fakeParentNode
+const treeNode_t* KTREE_findChild(
+      const treeNode_t *node,
+      const char *selector,
+      uint16_t selectorLen
 );
 
 /**
- * @brief   Adds a sibling node to a passed in parent node.
- *
- * This function adds a sibling node to a passed in parent node by checking if
- * the child node of the trueParentNode is used up and if it is, it recursively
- * calls itself with the used node as a trueParentNode parameter until it finds
- * the last sibling.  It then adds the sibling node there and sets the
- * fakeParentNode.
- *
- * @param [in] childNode: treeNode_t* pointer to the node to be added as a child
- * @parem [in] trueParentNone: treeNode_t* pointer to the node that the child
- * node will be directly attached to because it may appear as a sibling node or
- * an actual child node.
- * @parem [in] fakeParentNone: treeNode_t* pointer to the node that indicates
- * the "regular" tree depth of this child node.
- * @return: None
+ * @brief   Validate a tree table.
+ *
+ * Checks that every node but the first has a parent, that every node is
+ * within the children of its parent, that the depths are consistent, that the
+ * depth doesn't exceed maxDepth, and that the children of every node are
+ * sorted by selector with no duplicates.
+ *
+ * @param [in] *tree: treeNode_t pointer to the table.  The first entry is the
+ * root of the tree.
+ * @param [in] nNodes: uint16_t number of nodes in the table.
+ * @param [in] maxDepth: uint8_t max depth allowed.
+ * @return: treeNode_t* pointer to the first node found to be incorrect or
+ * NULL if the whole table is correct.
  */
-void KTREE_addNextSibling(
-      treeNode_t *siblingToAdd,
-      treeNode_t *trueParentNode,
-      treeNode_t *fakeParentNode
+const treeNode_t* KTREE_validate(
+      const treeNode_t *tree,
+      uint16_t nNodes,
+      uint8_t maxDepth
 );
 
-void KTREE_printTree( treeNode_t *node, uint8_t level );
-
-void KTREE_printNode( treeNode_t *node, uint8_t level );
-
-void KTREE_fakeMenuTest( void );
-
 /**
  * @}
  * end addtogroup groupMenu
@@ -1,7 +1,7 @@
 /**
  * @file    menu.h
- * @brief   Implementation of the munu application using a statically allocated
- * k-ary tree structure.
+ * @brief   Implementation of the munu application using a constant k-ary tree
+ * structure.
  *
  * @date    09/29/2014
  * @author  Harry Rostovtsev
@@ -29,20 +29,6 @@ extern "C" {
 #define MENU_MAX_DEPTH                       20
 
 /* Exported types ------------------------------------------------------------*/
-/**
- * @brief   Structure to keep track of where we are in the menu tree and how
- * to get to the topmost node.
- */
-typedef struct menuNavigationTag {
-   /**< Array of pointers to treeNode_t types that will hold the path from
-    * the currently selected node to the topmost parent via the fakeParentNode
-    * pointers. This array is arranged from the child to the top so has to be
-    * traversed backwards to get back to the child. */
-   treeNode_t* pathToTop[MENU_MAX_DEPTH];
-   /**< Index into the pathToTop array. */
-   uint8_t pathToTopIndex;
-} menuNav_t;
-
 /* Exported macros -----------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
@@ -95,25 +81,11 @@ typedef struct menuNavigationTag {
  *       Menu 1.3
  *    Menu 2
  *
+ * @param [in] *node: treeNode_t pointer to the currently selected node.
  * @param [in] msgSrc: MsgSrc var that specifies where to print out to.
  * @return  None
  */
-void MENU_printMenuExpandedAtCurrNode( treeNode_t* node, MsgSrc msgSrc );
-
-/**
- * @brief   Initializes the top level of the menu.
- * @param [in|out] *node: treeNode_t pointer to the node that will become the root node.
- * @param [in] *menuTxt: const char pointer to the storage of the text that will
- * be pointed to by the node being initialized.
- * @param [in] *menuSelectTxt: const char pointer to the storage of the selector
- * text that will be pointed by the node being initialized.
- * @return  treeNode_t*: pointer to the top level node of the menu.
- */
-treeNode_t* MENU_initTopLevel(
-      treeNode_t* node,
-      const char* menuTxt,
-      const char* menuSelectTxt
-);
+void MENU_printMenuExpandedAtCurrNode( const treeNode_t* node, MsgSrc msgSrc );
 
 /**
  * @brief   Parse the raw data of the command coming to the menu only for the
@@ -128,7 +100,7 @@ treeNode_t* MENU_initTopLevel(
  * selected node stays the same since it makes no sense to descend into a leaf
  * node.  Otherwise, the returned node is the child node of the current node.
  *
- * @param [in|out] *node: treeNode_t pointer to the submenu currently pointed to
+ * @param [in] *node: treeNode_t pointer to the submenu currently pointed to
  * @param [in] pBuffer: const char*  pointer to the storage of the buffer where the
  * command data resides
  * @param [in] bufferLen: uint16_t length of the data in the command buffer.
@@ -137,85 +109,16 @@ treeNode_t* MENU_initTopLevel(
  * pointing to.
  * @note: this can be different than the passed in node.
  */
-treeNode_t* MENU_parseCurrLevelMenuItems(
-      treeNode_t* node,
+const treeNode_t* MENU_parseCurrLevelMenuItems(
+      const treeNode_t* node,
       const char* pBuffer,
       uint16_t bufferLen,
       MsgSrc msgSrc
 );
 
 /**
- * @brief   Add a sub-menu to an existing menu node.
- *
- * This function should be called by the user to add a new menu to the existing
- * menu tree. It takes in a menu node to add as well as a parent node to which
- * the new menu will be attached to as a "child" node.
- *
- * @note 1: This function is just a wrapper around MENU_addChild() which does the
- * actual manipulation of the tree.
- *
- * @note 2: "child" is in quotes because the menu implementation is actually a
- * k-tree that is implemented as a binary tree.  See notes at the top of ktree.h
- * header file for details.
- *
- * @param [in|out] *node: treeNode_t pointer to the submenu that is to be added.
- * @param [in|out] *parent: treeNode_t pointer to the menu where the new submenu
- * will be added.
- * @param [in] *menuTxt: const char pointer to the storage of the text that will
- * be pointed to by the submenu being added.
- * @param [in] *menuSelectTxt: const char pointer to the storage of the selector
- * text that will be pointed by the node being added.
- * @param [in] pMenuFunction function pointer to the action function that will be
- * pointed by the node being added.  This action is what will execute when that
- * submenu is selected.  Can be NULL if no action is to be taken.
- * @return  treeNode_t*: pointer to the added submenu.
- */
-treeNode_t* MENU_addSubMenu(
-      treeNode_t* node,
-      treeNode_t* parent,
-      const char* menuTxt,
-      const char* menuSelectTxt,
-      pMenuFunction action
-);
-
-/**
- * @brief   Add a menu item to an existing sub-menu node.
- *
- * This function should be called by the user to add a new menu item to the
- * existing menu tree. It takes in a menu item node to add as well as a parent
- * node (the sub-menu where the menu item will live) to which the new menu item
- * will be attached to as a "child" node.
- *
- * @note 1: This function is just a wrapper around MENU_addChild() which does the
- * actual manipulation of the tree.
- *
- * @note 2: "child" is in quotes because the menu implementation is actually a
- * k-tree that is implemented as a binary tree.  See notes at the top of ktree.h
- * header file for details.
- *
- * @param [in|out] *node: treeNode_t pointer to the menu item that is to be added.
- * @param [in|out] *parent: treeNode_t pointer to the menu where the new menu
- * item will be added.
- * @param [in] *menuTxt: const char pointer to the storage of the text that will
- * be pointed to by the menu item being added.
- * @param [in] *menuSelectTxt: const char pointer to the storage of the selector
- * text that will be pointed by the menu item being added.
- * @param [in] pMenuFunction function pointer to the action function that will be
- * pointed by the node being added.  This action is what will execute when that
- * submenu is selected.  Can be NULL if no action is to be taken though this
- * probaly makes no sense for a menu item.
- * @return  treeNode_t*: pointer to the added menu item.
- */
-treeNode_t* MENU_addMenuItem(
-      treeNode_t* node,
-      treeNode_t* parent,
-      const char* menuTxt,
-      const char* menuSelectTxt,
-      pMenuFunction action
-);
-
-/**
- * @brief   Prints the entire expanded menu tree.
+ * @brief   Prints the entire expanded menu tree, framed by a line of stars above
+ * and below.
  *
  * @param [in] node: a treeNode_t* pointer to the node from which to start the
  * printing from.
@@ -223,7 +126,7 @@ treeNode_t* MENU_addMenuItem(
  *
  * @return: None
  */
-void MENU_printMenuTree( treeNode_t* node, MsgSrc msgSrc );
+void MENU_printMenuTree( const treeNode_t* node, MsgSrc msgSrc );
 
 /**
  * @}
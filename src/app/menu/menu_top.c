@@ -28,26 +28,242 @@ Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
 DBG_DEFINE_THIS_MODULE( DBG_MODL_DBG );/* For debug system to ID this module */
 
 /* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * @brief   Indices of all the nodes in the menu tree table.
+ *
+ * The rules of ktree.h apply: all the children of a menu have to be listed
+ * next to each other and in order of their selectors.  The order here is the
+ * order in which they are printed.
+ */
+typedef enum MenuIdx {
+   MENU_IDX_TOP = 0,                                   /**< Root of the menu */
+
+   /* Children of the root menu */
+   MENU_IDX_DBG,
+   MENU_IDX_SYSTEST,
+
+   /* Children of the DEBUG menu */
+   MENU_IDX_DBG_CPU,
+   MENU_IDX_DBG_EVT,
+   MENU_IDX_DBG_MOD,
+   MENU_IDX_DBG_OUT,
+   MENU_IDX_DBG_STK,
+
+   /* Children of the SYSTEST menu */
+   MENU_IDX_SYSTEST_I2C,
+
+   /* Children of the Debug Module Control menu */
+   MENU_IDX_DBG_MOD_COMM,
+   MENU_IDX_DBG_MOD_DBG,
+   MENU_IDX_DBG_MOD_ETH,
+   MENU_IDX_DBG_MOD_GEN,
+   MENU_IDX_DBG_MOD_I2C,
+   MENU_IDX_DBG_MOD_NOR,
+   MENU_IDX_DBG_MOD_SDR,
+   MENU_IDX_DBG_MOD_SER,
+   MENU_IDX_DBG_MOD_TIME,
+
+   /* Children of the Debug Output Control menu */
+   MENU_IDX_DBG_OUT_ETH,
+   MENU_IDX_DBG_OUT_SERIAL,
+
+   /* Children of the I2C system test menu */
+   MENU_IDX_SYSTEST_I2C_EEPROM_READ,
+   MENU_IDX_SYSTEST_I2C_EEPROM_WRITE,
+   MENU_IDX_SYSTEST_I2C_SN_READ,
+   MENU_IDX_SYSTEST_I2C_EUI64_READ,
+
+   MENU_IDX_MAX                           /**< Number of nodes in the menu */
+} MenuIdx_t;
+
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
-/* Private variables and Local objects ---------------------------------------*/
 
 /**
- * @brief   Storage for the root of the menu.  MenuMgr has a pointer to this.
+ * @brief   Define a menu or a menu item in the menu tree table.
+ *
+ * @param [in] txt: text displayed for the node.
+ * @param [in] sel: selector the user types to pick the node.
+ * @param [in] action: pMenuFunction run when the node is selected or NULL.
+ * @param [in] parentIdx: MenuIdx_t of the parent or MENU_IDX_MAX for the root.
+ * @param [in] firstChildIdx: MenuIdx_t of the first child if nKids > 0.
+ * @param [in] nKids: number of children.
+ * @param [in] lvl: depth of the node.
  */
-treeNode_t menu;
+#define MENU_NODE( txt, sel, action, parentIdx, firstChildIdx, nKids, lvl ) \
+   {                                                                        \
+      (txt),                                                                \
+      (sel),                                                                \
+      (action),                                                             \
+      (MENU_IDX_MAX == (parentIdx)) ? NULL : &menuTree[(parentIdx)],        \
+      (0 == (nKids)) ? NULL : &menuTree[(firstChildIdx)],                   \
+      (nKids),                                                              \
+      (lvl)                                                                 \
+   }
+
+/* Private variables and Local objects ---------------------------------------*/
 
 /**
  * @brief   Text of the main menu.  Displayed when the menu gets printed.
  */
-char *const menu_TitleTxt = "Coupler Board Menu";
+static const char menu_TitleTxt[] = "Coupler Board Menu";
 
 /**
  * @brief   Selector key for the top of the menu.
  * This is the letter sequence that the user inputs to jump back to the top of
  * the menu.
  */
-char *const menu_SelectKey = "T";
+static const char menu_SelectKey[] = "T";
+
+/**
+ * @brief   The entire menu tree.  MenuMgr has a pointer into this.
+ *
+ * To add a menu or menu item, add its index to MenuIdx_t, add its entry here at
+ * the same position, and update the first child and number of children of its
+ * parent.  The text, selectors, and actions are defined in their respective c
+ * files and declared "extern" so they can be accessed from here.
+ */
+static const treeNode_t menuTree[MENU_IDX_MAX] = {
+   [MENU_IDX_TOP] = MENU_NODE(
+         menu_TitleTxt, menu_SelectKey, NULL,
+         MENU_IDX_MAX, MENU_IDX_DBG, 2, 0
+   ),
+
+   [MENU_IDX_DBG] = MENU_NODE(
+         menuDbg_TitleTxt, menuDbg_SelectKey, NULL,
+         MENU_IDX_TOP, MENU_IDX_DBG_CPU, 5, 1
+   ),
+   [MENU_IDX_SYSTEST] = MENU_NODE(
+         menuSysTest_TitleTxt, menuSysTest_SelectKey, NULL,
+         MENU_IDX_TOP, MENU_IDX_SYSTEST_I2C, 1, 1
+   ),
+
+   [MENU_IDX_DBG_CPU] = MENU_NODE(
+         menuDbgItem_printCpuLoadTxt,
+         menuDbgItem_printCpuLoadSelectKey,
+         MENU_printCpuLoadAction,
+         MENU_IDX_DBG, 0, 0, 2
+   ),
+   [MENU_IDX_DBG_EVT] = MENU_NODE(
+         menuDbgItem_printEvtRecTxt,
+         menuDbgItem_printEvtRecSelectKey,
+         MENU_printEvtRecAction,
+         MENU_IDX_DBG, 0, 0, 2
+   ),
+   [MENU_IDX_DBG_MOD] = MENU_NODE(
+         menuDbgModCntrl_TitleTxt, menuDbgModCntrl_SelectKey, NULL,
+         MENU_IDX_DBG, MENU_IDX_DBG_MOD_COMM, 9, 2
+   ),
+   [MENU_IDX_DBG_OUT] = MENU_NODE(
+         menuDbgOutCntrl_TitleTxt, menuDbgOutCntrl_SelectKey, NULL,
+         MENU_IDX_DBG, MENU_IDX_DBG_OUT_ETH, 2, 2
+   ),
+   [MENU_IDX_DBG_STK] = MENU_NODE(
+         menuDbgItem_printStackUsageTxt,
+         menuDbgItem_printStackUsageSelectKey,
+         MENU_printStackUsageAction,
+         MENU_IDX_DBG, 0, 0, 2
+   ),
+
+   [MENU_IDX_SYSTEST_I2C] = MENU_NODE(
+         menuSysTest_I2C_TitleTxt, menuSysTest_I2C_SelectKey, NULL,
+         MENU_IDX_SYSTEST, MENU_IDX_SYSTEST_I2C_EEPROM_READ, 4, 2
+   ),
+
+   [MENU_IDX_DBG_MOD_COMM] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModCOMMTxt,
+         menuDbgModCntrlItem_toggleModCOMMSelectKey,
+         MENU_toggleDbgModCOMMAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_DBG] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModDBGTxt,
+         menuDbgModCntrlItem_toggleModDBGSelectKey,
+         MENU_toggleDbgModDBGAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_ETH] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModEthTxt,
+         menuDbgModCntrlItem_toggleModEthSelectKey,
+         MENU_toggleDbgModEthAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_GEN] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModGenTxt,
+         menuDbgModCntrlItem_toggleModGenSelectKey,
+         MENU_toggleDbgModGeneralAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_I2C] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModI2CTxt,
+         menuDbgModCntrlItem_toggleModI2CSelectKey,
+         MENU_toggleDbgModI2CAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_NOR] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModNORTxt,
+         menuDbgModCntrlItem_toggleModNORSelectKey,
+         MENU_toggleDbgModNORAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_SDR] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModSDRTxt,
+         menuDbgModCntrlItem_toggleModSDRSelectKey,
+         MENU_toggleDbgModSDRAMAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_SER] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModSerTxt,
+         menuDbgModCntrlItem_toggleModSerSelectKey,
+         MENU_toggleDbgModSerialAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_MOD_TIME] = MENU_NODE(
+         menuDbgModCntrlItem_toggleModTimeTxt,
+         menuDbgModCntrlItem_toggleModTimeSelectKey,
+         MENU_toggleDbgModTimeAction,
+         MENU_IDX_DBG_MOD, 0, 0, 3
+   ),
+
+   [MENU_IDX_DBG_OUT_ETH] = MENU_NODE(
+         menuDbgOutCntrlItem_toggleEthDebugTxt,
+         menuDbgOutCntrlItem_toggleEthDebugSelectKey,
+         MENU_toggleEthDebugAction,
+         MENU_IDX_DBG_OUT, 0, 0, 3
+   ),
+   [MENU_IDX_DBG_OUT_SERIAL] = MENU_NODE(
+         menuDbgOutCntrlItem_toggleSerialDebugTxt,
+         menuDbgOutCntrlItem_toggleSerialDebugSelectKey,
+         MENU_toggleSerialDebugAction,
+         MENU_IDX_DBG_OUT, 0, 0, 3
+   ),
+
+   [MENU_IDX_SYSTEST_I2C_EEPROM_READ] = MENU_NODE(
+         menuSysTest_runI2CEEPROMReadTest_Txt,
+         menuSysTest_runI2CEEPROMReadTest_SelectKey,
+         MENU_i2cEEPROMReadTestAction,
+         MENU_IDX_SYSTEST_I2C, 0, 0, 3
+   ),
+   [MENU_IDX_SYSTEST_I2C_EEPROM_WRITE] = MENU_NODE(
+         menuSysTest_runI2CEEPROMWriteTest_Txt,
+         menuSysTest_runI2CEEPROMWriteTest_SelectKey,
+         MENU_i2cEEPROMWriteTestAction,
+         MENU_IDX_SYSTEST_I2C, 0, 0, 3
+   ),
+   [MENU_IDX_SYSTEST_I2C_SN_READ] = MENU_NODE(
+         menuSysTest_runI2CSNReadTest_Txt,
+         menuSysTest_runI2CSNReadTest_SelectKey,
+         MENU_i2cSNReadTestAction,
+         MENU_IDX_SYSTEST_I2C, 0, 0, 3
+   ),
+   [MENU_IDX_SYSTEST_I2C_EUI64_READ] = MENU_NODE(
+         menuSysTest_runI2CEUI64ReadTest_Txt,
+         menuSysTest_runI2CEUI64ReadTest_SelectKey,
+         MENU_i2cEUI64ReadTestAction,
+         MENU_IDX_SYSTEST_I2C, 0, 0, 3
+   ),
+};
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -61,230 +277,42 @@ static void MENU_printHelp( volatile MsgSrc msgSrc );
 
 /**
  * @brief   Prints out the entire expanded menu tree
- * This is just a wrapper around the recursive function that prints the entire
- * menu tree with some pretty-print code added in to make it obvious where the
- * previous menu was printed and where the new one was.
+ * This is just a wrapper around MENU_printMenuTree() that always starts from
+ * the root of the menu.
  *
- * @param [in] node: treeNode_t* pointer to the root of the menu.
  * @param [in] msgSrc: MsgSrc var that specifies where to print out to.
  * @return  None
  */
-static void MENU_printEntireExpandedMenu( volatile treeNode_t* node, volatile MsgSrc msgSrc );
+static void MENU_printEntireExpandedMenu( volatile MsgSrc msgSrc );
 
 /* Private functions ---------------------------------------------------------*/
 
 /******************************************************************************/
-treeNode_t* MENU_init( void )
+const treeNode_t* MENU_init( void )
 {
-   /* 1. This has to get called first.  It initializes the top level of the menu */
-   MENU_initTopLevel( &menu, menu_TitleTxt, menu_SelectKey );
-
-   /* 2. At this point, submenus and their items can be added.  The nodes, text,
-    * actions, etc have to be defined in their respective c files and the vars
-    * declared "extern" so they can be accessed from here. The menus and menu
-    * items will appear in the order in which they are added here. */
-
-   /* Add the DEBUG menu */
-   MENU_addSubMenu(
-         &menuDbg,                                      /**< Menu being added */
-         &menu,                           /**< Parent of the menu being added */
-         menuDbg_TitleTxt,                   /**< Menu being added title text */
-         menuDbg_SelectKey,               /**< Menu being added selection key */
-         NULL                         /**< Action taken when menu is selected */
-   );
-
-      /* Add a Debug Output Control sub-menu under the DEBUG menu */
-      MENU_addSubMenu(
-            &menuDbgOutCntrl,                              /**< Menu being added */
-            &menuDbg,                        /**< Parent of the menu being added */
-            menuDbgOutCntrl_TitleTxt,           /**< Menu being added title text */
-            menuDbgOutCntrl_SelectKey,       /**< Menu being added selection key */
-            NULL                         /**< Action taken when menu is selected */
-      );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgOutCntrlItem_toggleSerialDebug,   /**< Menu item being added */
-               &menuDbgOutCntrl,                   /**< Parent of the menu item being added */
-               menuDbgOutCntrlItem_toggleSerialDebugTxt,  /**< Menu item title text */
-               menuDbgOutCntrlItem_toggleSerialDebugSelectKey, /**< Menu item selection key */
-               MENU_toggleSerialDebugAction /**< Action taken when menu item is selected */
-         );
-
-         MENU_addMenuItem(
-               &menuDbgOutCntrlItem_toggleEthDebug,      /**< Menu item being added */
-               &menuDbgOutCntrl,                   /**< Parent of the menu item being added */
-               menuDbgOutCntrlItem_toggleEthDebugTxt,     /**< Menu item title text */
-               menuDbgOutCntrlItem_toggleEthDebugSelectKey, /**< Menu item selection key */
-               MENU_toggleEthDebugAction  /**< Action taken when menu item is selected */
-         );
-
-      /* Add a Debug Module Control sub-menu under the DEBUG menu */
-      MENU_addSubMenu(
-            &menuDbgModCntrl,                              /**< Menu being added */
-            &menuDbg,                        /**< Parent of the menu being added */
-            menuDbgModCntrl_TitleTxt,           /**< Menu being added title text */
-            menuDbgModCntrl_SelectKey,       /**< Menu being added selection key */
-            NULL                         /**< Action taken when menu is selected */
-      );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModGen,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModGenTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModGenSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModGeneralAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModSer,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModSerTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModSerSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModSerialAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModTime,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModTimeTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModTimeSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModTimeAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModEth,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModEthTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModEthSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModEthAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModI2C,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModI2CTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModI2CSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModI2CAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModNOR,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModNORTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModNORSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModNORAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModSDR,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModSDRTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModSDRSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModSDRAMAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModDBG,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModDBGTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModDBGSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModDBGAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuDbgModCntrlItem_toggleModCOMM,   /**< Menu item being added */
-               &menuDbgModCntrl,                   /**< Parent of the menu item being added */
-               menuDbgModCntrlItem_toggleModCOMMTxt,  /**< Menu item title text */
-               menuDbgModCntrlItem_toggleModCOMMSelectKey, /**< Menu item selection key */
-               MENU_toggleDbgModCOMMAction /**< Action taken when menu item is selected */
-         );
-
-   /* Add the SYSTEST menu */
-   MENU_addSubMenu(
-         &menuSysTest,                                  /**< Menu being added */
-         &menu,                           /**< Parent of the menu being added */
-         menuSysTest_TitleTxt,               /**< Menu being added title text */
-         menuSysTest_SelectKey,           /**< Menu being added selection key */
-         NULL                         /**< Action taken when menu is selected */
-   );
-
-      /* Add an I2C system test menu under the SYSTEST menu */
-      MENU_addSubMenu(
-            &menuSysTest_I2C,                           /**< Menu being added */
-            &menuSysTest,                 /**< Parent of the menu being added */
-            menuSysTest_I2C_TitleTxt,        /**< Menu being added title text */
-            menuSysTest_I2C_SelectKey,    /**< Menu being added selection key */
-            NULL                      /**< Action taken when menu is selected */
-      );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuItem_runI2CEEPROMReadTest,     /**< Menu item being added */
-               &menuSysTest_I2C,     /**< Parent of the menu item being added */
-               menuSysTest_runI2CEEPROMReadTest_Txt,  /**< Menu item title text */
-               menuSysTest_runI2CEEPROMReadTest_SelectKey, /**< Menu item selection key */
-               MENU_i2cEEPROMReadTestAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuItem_runI2CSNReadTest,         /**< Menu item being added */
-               &menuSysTest_I2C,     /**< Parent of the menu item being added */
-               menuSysTest_runI2CSNReadTest_Txt,    /**< Menu item title text */
-               menuSysTest_runI2CSNReadTest_SelectKey, /**< Menu item selection key */
-               MENU_i2cSNReadTestAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuItem_runI2CEUI64ReadTest,      /**< Menu item being added */
-               &menuSysTest_I2C,     /**< Parent of the menu item being added */
-               menuSysTest_runI2CEUI64ReadTest_Txt, /**< Menu item title text */
-               menuSysTest_runI2CEUI64ReadTest_SelectKey, /**< Menu item selection key */
-               MENU_i2cEUI64ReadTestAction /**< Action taken when menu item is selected */
-         );
-
-         /* Add menu items for this menu */
-         MENU_addMenuItem(
-               &menuItem_runI2CEEPROMWriteTest,     /**< Menu item being added */
-               &menuSysTest_I2C,     /**< Parent of the menu item being added */
-               menuSysTest_runI2CEEPROMWriteTest_Txt,  /**< Menu item title text */
-               menuSysTest_runI2CEEPROMWriteTest_SelectKey, /**< Menu item selection key */
-               MENU_i2cEEPROMWriteTestAction /**< Action taken when menu item is selected */
-         );
-
-   /* Uncomment to print the entire tree with node addresses (for debugging only) */
-//   KTREE_printTree(&menu, 0);
-
-   return( &menu ); /* return a pointer to the top level of the menu tree */
+   /* The menu tree is a constant table so there's nothing to build.  Just make
+    * sure that it was written correctly since the compiler can't check that. */
+   Q_ASSERT( NULL == KTREE_validate( menuTree, MENU_IDX_MAX, MENU_MAX_DEPTH - 1 ) );
+
+   return( &menuTree[MENU_IDX_TOP] ); /* return a pointer to the top level of the menu tree */
 }
 
 /******************************************************************************/
-treeNode_t* MENU_parse(
-      treeNode_t* node,
+const treeNode_t* MENU_parse(
+      const treeNode_t* node,
       const char* pBuffer,
       uint16_t bufferLen,
       volatile MsgSrc msgSrc
 )
 {
-   treeNode_t *newNode = node;
+   const treeNode_t *newNode = node;
 
    /* Sanity check. If the passed in node is null, set to the top of the menu
     * and inform user. This really shouldn't happen and if it does, it is a bug
     * in the menu handling application. */
    if ( NULL == node ) {
       WRN_printf("Passed in a null node.  Setting to top of menu\n");
-      newNode = &menu;
+      newNode = &menuTree[MENU_IDX_TOP];
       MENU_printMenuExpandedAtCurrNode( newNode, msgSrc );
       return( newNode );
    }
@@ -293,17 +321,17 @@ treeNode_t* MENU_parse(
    if ( 0 == strncmp((const char *)pBuffer, "?", 1 ) && 1 == bufferLen-1 ) {
       MENU_printHelp( msgSrc );
    } else if ( 0 == strncmp((const char *)pBuffer, "T", 1 ) && 1 == bufferLen-1 ) {
-      newNode = &menu;
+      newNode = &menuTree[MENU_IDX_TOP];
       MENU_printMenuExpandedAtCurrNode( newNode, msgSrc );
    } else if ( 0 == strncmp((const char *)pBuffer, "P", 1 ) && 1 == bufferLen-1 ) {
       MENU_printMenuExpandedAtCurrNode(newNode, msgSrc );
    } else if ( 0 == strncmp((const char *)pBuffer, "A", 1 ) && 1 == bufferLen-1 ) {
-      /* Have to pass in the root of the menu to make sure to get the whole menu
-       * and not forget where we are currently at. */
-      MENU_printEntireExpandedMenu( &menu, msgSrc );
+      /* Always prints from the root of the menu without forgetting where we are
+       * currently at. */
+      MENU_printEntireExpandedMenu( msgSrc );
    } else if ( 0 == strncmp((const char *)pBuffer, "U", 1 ) && 1 == bufferLen-1 ) {
-      if ( NULL != node->fakeParentNode ) {
-         newNode = node->fakeParentNode;
+      if ( NULL != node->parentNode ) {
+         newNode = node->parentNode;
       } else {
          LOG_printf("Already at the top of the menu\n");
       }
@@ -321,24 +349,27 @@ treeNode_t* MENU_parse(
 /******************************************************************************/
 static void MENU_printHelp( volatile MsgSrc msgSrc )
 {
-   MENU_printf(msgSrc, "******************************************************************************\n");
-   MENU_printf(msgSrc, "*****                           Menu Help                                *****\n");
-   MENU_printf(msgSrc, "***** Type the following commands:                                       *****\n");
-   MENU_printf(msgSrc, "***** '?': menu help                                                     *****\n");
-   MENU_printf(msgSrc, "***** 'P': print currently selected menu                                 *****\n");
-   MENU_printf(msgSrc, "***** 'A': print entire expanded menu tree                               *****\n");
-   MENU_printf(msgSrc, "***** 'T': go to the top of the menu                                     *****\n");
-   MENU_printf(msgSrc, "***** 'U': go up one level from where you're currently at                *****\n");
-   MENU_printf(msgSrc, "***** any identifier to select the submenu or menu item on your level    *****\n");
-   MENU_printf(msgSrc, "******************************************************************************\n");
+   MenuRender_t render;
+   MENU_renderInit( &render, msgSrc );
+
+   MENU_renderPrintf(&render, "******************************************************************************\n");
+   MENU_renderPrintf(&render, "*****                           Menu Help                                *****\n");
+   MENU_renderPrintf(&render, "***** Type the following commands:                                       *****\n");
+   MENU_renderPrintf(&render, "***** '?': menu help                                                     *****\n");
+   MENU_renderPrintf(&render, "***** 'P': print currently selected menu                                 *****\n");
+   MENU_renderPrintf(&render, "***** 'A': print entire expanded menu tree                               *****\n");
+   MENU_renderPrintf(&render, "***** 'T': go to the top of the menu                                     *****\n");
+   MENU_renderPrintf(&render, "***** 'U': go up one level from where you're currently at                *****\n");
+   MENU_renderPrintf(&render, "***** any identifier to select the submenu or menu item on your level    *****\n");
+   MENU_renderPrintf(&render, "******************************************************************************\n");
+
+   MENU_renderFlush( &render );
 }
 
 /******************************************************************************/
-static void MENU_printEntireExpandedMenu( volatile treeNode_t* node, volatile MsgSrc msgSrc )
+static void MENU_printEntireExpandedMenu( volatile MsgSrc msgSrc )
 {
-   MENU_printf(msgSrc, "******************************************************************************\n");
-   MENU_printMenuTree(&menu, msgSrc );
-   MENU_printf(msgSrc, "******************************************************************************\n\n");
+   MENU_printMenuTree( &menuTree[MENU_IDX_TOP], msgSrc );
 }
 /**
  * @}
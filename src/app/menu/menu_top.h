@@ -32,14 +32,15 @@ extern "C" {
 /* Exported functions --------------------------------------------------------*/
 
 /**
- * @brief   Initialize and arrange the menu.
- * This function is used to compose all the sub-menus and menu items that exist
- * in the menu system.
+ * @brief   Initialize the menu.
+ * All the sub-menus and menu items that exist in the menu system are defined
+ * in a constant table in menu_top.c.  This function checks that the table is
+ * consistent and returns its root.
  *
  * @param   None
  * @return  treeNode_t*: pointer to the root of the menu.
  */
-treeNode_t* MENU_init( void );
+const treeNode_t* MENU_init( void );
 
 /**
  * @brief   Parse the raw data of the command coming to the menu.
@@ -51,7 +52,7 @@ treeNode_t* MENU_init( void );
  * 3. The input needs to be parsed only at the level of the sub menu where the
  * system is pointing to currently.
  *
- * @param [in|out] node: treeNode_t* pointer to the submenu currently pointed to
+ * @param [in] node: treeNode_t* pointer to the submenu currently pointed to
  * @param [in] pBuffer: const char*  pointer to the storage of the buffer where the
  * command data resides
  * @param [in] bufferLen: uint16_t length of the data in the command buffer.
@@ -60,8 +61,8 @@ treeNode_t* MENU_init( void );
  * pointing to.
  * @note: this can be different than the passed in node.
  */
-treeNode_t* MENU_parse(
-      treeNode_t *node,
+const treeNode_t* MENU_parse(
+      const treeNode_t *node,
       const char* pBuffer,
       uint16_t bufferLen,
       volatile MsgSrc msgSrc
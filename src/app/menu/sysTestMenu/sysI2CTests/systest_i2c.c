@@ -15,7 +15,7 @@
 #include "systest_i2c.h"
 #include "qp_port.h"                                        /* for QP support */
 #include "project_includes.h"
-#include "I2C1DevMgr.h"
+#include "I2CDevMgr.h"
 #include "DbgMgr.h"
 #include "i2c_dev.h"
 
@@ -29,21 +29,17 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_DBG );/* For debug system to ID this module */
 /* Private variables and Local objects ---------------------------------------*/
 
 /* Variables to define all the menu items in this submenu */
-treeNode_t menuItem_runI2CEEPROMReadTest;
-char *const menuSysTest_runI2CEEPROMReadTest_Txt = "Run I2C EEPROM Read test.";
-char *const menuSysTest_runI2CEEPROMReadTest_SelectKey = "EER";
+const char menuSysTest_runI2CEEPROMReadTest_Txt[] = "Run I2C EEPROM Read test.";
+const char menuSysTest_runI2CEEPROMReadTest_SelectKey[] = "EER";
 
-treeNode_t menuItem_runI2CSNReadTest;
-char *const menuSysTest_runI2CSNReadTest_Txt = "Run I2C Serial Number Read test.";
-char *const menuSysTest_runI2CSNReadTest_SelectKey = "SNR";
+const char menuSysTest_runI2CSNReadTest_Txt[] = "Run I2C Serial Number Read test.";
+const char menuSysTest_runI2CSNReadTest_SelectKey[] = "SNR";
 
-treeNode_t menuItem_runI2CEUI64ReadTest;
-char *const menuSysTest_runI2CEUI64ReadTest_Txt = "Run I2C EUI64 Read test.";
-char *const menuSysTest_runI2CEUI64ReadTest_SelectKey = "UIR";
+const char menuSysTest_runI2CEUI64ReadTest_Txt[] = "Run I2C EUI64 Read test.";
+const char menuSysTest_runI2CEUI64ReadTest_SelectKey[] = "UIR";
 
-treeNode_t menuItem_runI2CEEPROMWriteTest;
-char *const menuSysTest_runI2CEEPROMWriteTest_Txt = "Run I2C EEPROM Write test.";
-char *const menuSysTest_runI2CEEPROMWriteTest_SelectKey = "EEW";
+const char menuSysTest_runI2CEEPROMWriteTest_Txt[] = "Run I2C EEPROM Write test.";
+const char menuSysTest_runI2CEEPROMWriteTest_SelectKey[] = "EEW";
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
@@ -59,12 +55,6 @@ void MENU_i2cEEPROMReadTestAction(
    uint16_t memAddr = 0x00;
    uint8_t bytes = 16;
 
-   /* Subscribe to the signal of the event that is expected to be returned. This
-    * is not subscribed to by default to avoid printing out every single I2C
-    * read request sent to the I2C1DevMgr.  As soon as the signal handler for
-    * this event gets triggered in DbgMgr AO, it will un-subscribe from it. */
-   QActive_subscribe(AO_DbgMgr, I2C1_DEV_READ_DONE_SIG);
-
    MENU_printf(
          dst,
          "--- Test Start --- Running an EEPROM read test. Reading %d bytes from 0x%02x\n",
@@ -78,7 +68,9 @@ void MENU_i2cEEPROMReadTestAction(
       memAddr,                                        // uint16_t offset,
       bytes,                                          // uint16_t bytesToRead,
       ACCESS_QPC,                                     // AccessType_t accType,
-      AO_DbgMgr                                       // QActive* callingAO
+      AO_DbgMgr,                                      // QActive* callingAO
+      NULL,                                           // uint8_t *pBuffer
+      0                                               // uint16_t tag
    );
 
    /* Print error if exists */
@@ -101,12 +93,6 @@ void MENU_i2cSNReadTestAction(
    CB_UNUSED_ARG(dataLen);
    uint16_t memAddr = 0x00;
    uint8_t bytes = 16;
-   /* Subscribe to the signal of the event that is expected to be returned. This
-    * is not subscribed to by default to avoid printing out every single I2C
-    * read request sent to the I2C1DevMgr.  As soon as the signal handler for
-    * this event gets triggered in DbgMgr AO, it will un-subscribe from it. */
-   QActive_subscribe(AO_DbgMgr, I2C1_DEV_READ_DONE_SIG);
-
    MENU_printf(
          dst,
          "--- Test Start --- Running an SN_ROM read test. Reading %d bytes from 0x%02x\n",
@@ -120,7 +106,9 @@ void MENU_i2cSNReadTestAction(
       memAddr,                                        // uint16_t offset,
       bytes,                                          // uint16_t bytesToRead,
       ACCESS_QPC,                                     // AccessType_t accType,
-      AO_DbgMgr                                       // QActive* callingAO
+      AO_DbgMgr,                                      // QActive* callingAO
+      NULL,                                           // uint8_t *pBuffer
+      0                                               // uint16_t tag
    );
 
    /* Print error if exists */
@@ -145,12 +133,6 @@ void MENU_i2cEUI64ReadTestAction(
    uint16_t memAddr = 0x00;
    uint8_t bytes = 8;
 
-   /* Subscribe to the signal of the event that is expected to be returned. This
-    * is not subscribed to by default to avoid printing out every single I2C
-    * read request sent to the I2C1DevMgr.  As soon as the signal handler for
-    * this event gets triggered in DbgMgr AO, it will un-subscribe from it. */
-   QActive_subscribe(AO_DbgMgr, I2C1_DEV_READ_DONE_SIG);
-
    MENU_printf(
          dst,
          "--- Test Start --- Running an EUI_ROM read test. Reading %d bytes from 0x%02x\n",
@@ -164,7 +146,9 @@ void MENU_i2cEUI64ReadTestAction(
          memAddr,                                        // uint16_t offset,
          bytes,                                          // uint16_t bytesToRead,
          ACCESS_QPC,                                     // AccessType_t accType,
-         AO_DbgMgr                                       // QActive* callingAO
+         AO_DbgMgr,                                      // QActive* callingAO
+         NULL,                                           // uint8_t *pBuffer
+         0                                               // uint16_t tag
    );
 
    /* Print error if exists */
@@ -186,12 +170,6 @@ void MENU_i2cEEPROMWriteTestAction(
    CB_UNUSED_ARG(dataBuf);
    CB_UNUSED_ARG(dataLen);
 
-   /* Subscribe to the signal of the event that is expected to be returned. This
-    * is not subscribed to by default to avoid printing out every single I2C
-    * read request sent to the I2C1DevMgr.  As soon as the signal handler for
-    * this event gets triggered in DbgMgr AO, it will un-subscribe from it. */
-   QActive_subscribe(AO_DbgMgr, I2C1_DEV_WRITE_DONE_SIG);
-
    uint16_t memAddr = 0x00;
    uint8_t bytes = 16;
    uint8_t tmp[bytes];
@@ -214,7 +192,8 @@ void MENU_i2cEEPROMWriteTestAction(
       bytes,                                       // uint16_t bytesToWrite,
       ACCESS_QPC,                                  // AccessType_t accType,
       AO_DbgMgr,                                   // QActive* callingAO
-      tmp                                          // uint8_t *pBuffer,
+      tmp,                                         // uint8_t *pBuffer,
+      0                                            // uint16_t tag
    );
 
    /* Print error if exists */
@@ -31,21 +31,17 @@ extern "C" {
 /* Exported variables --------------------------------------------------------*/
 
 /* Variables to define all the menu items in this submenu */
-extern treeNode_t menuItem_runI2CEEPROMReadTest;
-extern char *const menuSysTest_runI2CEEPROMReadTest_Txt;
-extern char *const menuSysTest_runI2CEEPROMReadTest_SelectKey;
+extern const char menuSysTest_runI2CEEPROMReadTest_Txt[];
+extern const char menuSysTest_runI2CEEPROMReadTest_SelectKey[];
 
-extern treeNode_t menuItem_runI2CSNReadTest;
-extern char *const menuSysTest_runI2CSNReadTest_Txt;
-extern char *const menuSysTest_runI2CSNReadTest_SelectKey;
+extern const char menuSysTest_runI2CSNReadTest_Txt[];
+extern const char menuSysTest_runI2CSNReadTest_SelectKey[];
 
-extern treeNode_t menuItem_runI2CEUI64ReadTest;
-extern char *const menuSysTest_runI2CEUI64ReadTest_Txt;
-extern char *const menuSysTest_runI2CEUI64ReadTest_SelectKey;
+extern const char menuSysTest_runI2CEUI64ReadTest_Txt[];
+extern const char menuSysTest_runI2CEUI64ReadTest_SelectKey[];
 
-extern treeNode_t menuItem_runI2CEEPROMWriteTest;
-extern char *const menuSysTest_runI2CEEPROMWriteTest_Txt;
-extern char *const menuSysTest_runI2CEEPROMWriteTest_SelectKey;
+extern const char menuSysTest_runI2CEEPROMWriteTest_Txt[];
+extern const char menuSysTest_runI2CEEPROMWriteTest_SelectKey[];
 
 /* Exported functions --------------------------------------------------------*/
 /**
@@ -26,14 +26,12 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_DBG );/* For debug system to ID this module */
 /* Private variables and Local objects ---------------------------------------*/
 
 /* Variables to define this submenu */
-treeNode_t menuSysTest;
-char *const menuSysTest_TitleTxt = "System Test Menu";
-char *const menuSysTest_SelectKey = "SYS";
+const char menuSysTest_TitleTxt[] = "System Test Menu";
+const char menuSysTest_SelectKey[] = "SYS";
 
 /* All the submenus available in the above submenu */
-treeNode_t menuSysTest_I2C;
-char *const menuSysTest_I2C_TitleTxt = "I2C Test Menu";
-char *const menuSysTest_I2C_SelectKey = "I2C";
+const char menuSysTest_I2C_TitleTxt[] = "I2C Test Menu";
+const char menuSysTest_I2C_SelectKey[] = "I2C";
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
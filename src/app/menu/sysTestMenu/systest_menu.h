@@ -29,13 +29,11 @@ extern "C" {
 /* Exported macros -----------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
-extern treeNode_t menuSysTest;
-extern char *const menuSysTest_TitleTxt;
-extern char *const menuSysTest_SelectKey;
+extern const char menuSysTest_TitleTxt[];
+extern const char menuSysTest_SelectKey[];
 
-extern treeNode_t menuSysTest_I2C;
-extern char *const menuSysTest_I2C_TitleTxt;
-extern char *const menuSysTest_I2C_SelectKey;
+extern const char menuSysTest_I2C_TitleTxt[];
+extern const char menuSysTest_I2C_SelectKey[];
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -0,0 +1,210 @@
+/**
+ * @file   app_launch.c
+ * @brief  Definitions for handing the processor over to the application.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupAppImg
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_launch.h"
+#include "stm32f4xx.h"                                 /* For STM32F4 support */
+#include "stm32f4xx_rcc.h"                           /* For STM32 clk support */
+#include "stm32f4xx_rtc.h"               /* For STM32 RTC backup registers */
+#include "stm32f4xx_flash.h"                       /* For STM32 flash support */
+#include "stm32f4xx_usart.h"                       /* For STM32 UART support */
+#include "crc32compat.h"                              /* For CRC32_Calc() */
+#include "project_includes.h"                      /* For debug printing */
+
+/* Compile-time called macros ------------------------------------------------*/
+DBG_DEFINE_THIS_MODULE( DBG_MODL_GENERAL ); /* For debug system to ID this module */
+
+/* Private typedefs ----------------------------------------------------------*/
+
+/**< Reset handler of the application */
+typedef void (*LAUNCH_EntryFn)( void );
+
+/* Private defines -----------------------------------------------------------*/
+
+/**< Loops to wait for the last byte of the log to go out before the jump */
+#define LAUNCH_UART_DRAIN_TOUT                                          100000
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   APP_IMG_CrcFn that runs on the CRC unit.
+ * @param [in] *data: const uint8_t pointer to word aligned data.
+ * @param [in] len: uint32_t number of bytes.
+ * @return: uint32_t CRC32.
+ */
+static uint32_t LAUNCH_crc( const uint8_t *data, uint32_t len );
+
+/**
+ * @brief   Program the verified mark into its erased spot in flash.
+ * @param [in] *pMark: const AppImgMark_t pointer to the mark to write.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: mark written and read back.
+ *    @arg ERR_APP_IMG_MARK_WRITE_FAILED: otherwise.
+ */
+static CBErrorCode LAUNCH_writeMark( const AppImgMark_t *pMark );
+
+/**
+ * @brief   Undo what the bootloader has started and jump to the application.
+ * @param [in] addr: uint32_t address of the vector table of the application.
+ * @return: Never
+ */
+static void LAUNCH_jump( uint32_t addr ) __attribute__((noreturn));
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint32_t LAUNCH_crc( const uint8_t *data, uint32_t len )
+{
+   return( CRC32_Calc( (char *)data, (int)len ) );
+}
+
+/******************************************************************************/
+static CBErrorCode LAUNCH_writeMark( const AppImgMark_t *pMark )
+{
+   CBErrorCode status = ERR_NONE;
+   const uint32_t *pWords = (const uint32_t *)pMark;
+
+   FLASH_Unlock();
+   FLASH_ClearFlag(
+         FLASH_FLAG_PGSERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGAERR |
+         FLASH_FLAG_WRPERR | FLASH_FLAG_OPERR | FLASH_FLAG_EOP
+   );
+
+   /* A write that gets cut short leaves a mark that doesn't match anything,
+    * which only costs a full check on every boot until the next image. */
+   for ( uint8_t i = 0; i < sizeof(AppImgMark_t) / sizeof(uint32_t); i++ ) {
+      uint32_t addr = APP_IMG_MARK_ADDR + i * sizeof(uint32_t);
+      if ( FLASH_COMPLETE != FLASH_ProgramWord( addr, pWords[i] ) ||
+            *(__IO uint32_t *)addr != pWords[i] ) {
+         status = ERR_APP_IMG_MARK_WRITE_FAILED;
+         break;
+      }
+   }
+
+   FLASH_Lock();
+   return( status );
+}
+
+/******************************************************************************/
+static void LAUNCH_jump( uint32_t addr )
+{
+   uint32_t sp = *(__IO uint32_t *)addr;
+   LAUNCH_EntryFn entry = (LAUNCH_EntryFn)( *(__IO uint32_t *)(addr + 4) );
+
+   /* Let the last byte of the log out before turning off the UART */
+   uint32_t timeout = LAUNCH_UART_DRAIN_TOUT;
+   while ( RESET == USART_GetFlagStatus( USART1, USART_FLAG_TC ) && --timeout ) {
+   }
+
+   __disable_irq();
+
+   /* Only the console UART with its DMA and the RTC are running by now.  The
+    * RTC is left alone since it lives in the backup domain anyway.  Put the
+    * rest back in reset state and make sure no interrupt is left enabled or
+    * pending. */
+   SysTick->CTRL = 0;
+   for ( uint8_t i = 0; i < sizeof(NVIC->ICER) / sizeof(NVIC->ICER[0]); i++ ) {
+      NVIC->ICER[i] = 0xFFFFFFFF;
+      NVIC->ICPR[i] = 0xFFFFFFFF;
+   }
+
+   RCC_APB2PeriphResetCmd( RCC_APB2Periph_USART1, ENABLE );
+   RCC_APB2PeriphResetCmd( RCC_APB2Periph_USART1, DISABLE );
+   RCC_APB2PeriphClockCmd( RCC_APB2Periph_USART1, DISABLE );
+
+   RCC_AHB1PeriphResetCmd( RCC_AHB1Periph_DMA2, ENABLE );
+   RCC_AHB1PeriphResetCmd( RCC_AHB1Periph_DMA2, DISABLE );
+   RCC_AHB1PeriphClockCmd( RCC_AHB1Periph_DMA2 | RCC_AHB1Periph_CRC, DISABLE );
+
+   /* Hand over the vector table and the stack.  Interrupts are enabled at
+    * reset so the application gets them that way too. */
+   SCB->VTOR = addr;
+   __set_MSP( sp );
+   __enable_irq();
+   entry();
+
+   for (;;) {                               /* The application never returns */
+   }
+}
+
+/******************************************************************************/
+CBErrorCode LAUNCH_tryApp( void )
+{
+   CBErrorCode status = ERR_NONE;
+
+   /* The backup registers survive a reset.  TIME_Init() has already given
+    * access to them. */
+   if ( LAUNCH_HOLD_MAGIC == RTC_ReadBackupRegister( LAUNCH_HOLD_BKP_REG ) ) {
+      RTC_WriteBackupRegister( LAUNCH_HOLD_BKP_REG, 0 );
+      log_slow_printf("Staying in bootloader as requested by the application\n");
+      return( ERR_APP_IMG_LAUNCH_HELD );
+   }
+
+   const AppImgMark_t *pMark = (const AppImgMark_t *)APP_IMG_MARK_ADDR;
+   uint32_t size = *(__IO uint32_t *)APP_IMG_SIZE_ADDR;
+   uint32_t crc  = *(__IO uint32_t *)APP_IMG_CRC_ADDR;
+   AppImgMark_t newMark;
+   bool bCached = false;
+
+   status = APP_IMG_validate(
+         (const uint8_t *)APP_IMG_START_ADDR,
+         size,
+         crc,
+         pMark,
+         LAUNCH_crc,
+         &newMark,
+         &bCached
+   );
+   if ( ERR_NONE != status ) {
+      goto LAUNCH_tryApp_ERR_HANDLE;     /* Stop and jump to error handling */
+   }
+
+   if ( !bCached ) {
+      if ( APP_IMG_isMarkBlank( pMark ) ) {
+         /* Not being able to write the mark only costs a full check next boot */
+         CBErrorCode markStatus = LAUNCH_writeMark( &newMark );
+         if ( ERR_NONE != markStatus ) {
+            wrn_slow_printf("Unable to write the verified mark. Error: 0x%08x\n", markStatus);
+         }
+      } else {
+         wrn_slow_printf("Stale verified mark. Full check on every boot until a new image is loaded\n");
+      }
+   }
+
+   uint32_t bootUs = DWT->CYCCNT / ( SystemCoreClock / 1000000 );
+   RTC_WriteBackupRegister( LAUNCH_TIME_BKP_REG, bootUs );
+   log_slow_printf(
+         "Launching app: %lu bytes, crc 0x%08lx, %s check, %lu.%03lu ms after BSP_init\n",
+         size, crc, bCached ? "cached" : "full", bootUs / 1000, bootUs % 1000
+   );
+
+   LAUNCH_jump( APP_IMG_START_ADDR );
+
+LAUNCH_tryApp_ERR_HANDLE:         /* Handle any error that may have occurred. */
+   ERR_COND_OUTPUT(
+         status,
+         ACCESS_BARE_METAL,
+         "Not launching app. Error: 0x%08x\n",
+         status
+   );
+   return( status );
+}
+
+/**
+ * @}
+ * end addtogroup groupAppImg
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,74 @@
+/**
+ * @file   app_launch.h
+ * @brief  Declarations for handing the processor over to the application.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupAppImg
+ * @{
+ *
+ * BSP_init() calls LAUNCH_tryApp() right after the serial port and the RTC are
+ * up.  If the image in flash is good (see app_img.h) and nobody asked to stay
+ * in the bootloader, it jumps to the application and never returns.  The only
+ * other things running by then are the UART DMA and the DWT cycle counter so
+ * undoing those is all the teardown needed.
+ *
+ * To stay in the bootloader (to load a new image), the application writes
+ * LAUNCH_HOLD_MAGIC to the LAUNCH_HOLD_BKP_REG RTC backup register and resets.
+ * The bootloader clears it so the next reset goes back to the application.
+ *
+ * The time from BSP_init() to the jump is printed and left in the
+ * LAUNCH_TIME_BKP_REG RTC backup register in us for the application to report.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_LAUNCH_H_
+#define APP_LAUNCH_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include "CBErrors.h"                                  /* For CBErrorCode */
+#include "app_img.h"                       /* For application image layout */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< RTC backup register the application sets to stay in the bootloader */
+#define LAUNCH_HOLD_BKP_REG                                        RTC_BKP_DR0
+
+/**< Value of LAUNCH_HOLD_BKP_REG that keeps the bootloader running */
+#define LAUNCH_HOLD_MAGIC                                           0xB007B007
+
+/**< RTC backup register the boot to application time is left in (in us) */
+#define LAUNCH_TIME_BKP_REG                                        RTC_BKP_DR1
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Jump to the application if there is a good one.
+ *
+ * Validates the image, writing the verified mark the first time a new image
+ * passes, tears down the UART and jumps.
+ *
+ * @note 1: Only call this from BSP_init(), right after Serial_Init() and
+ * TIME_Init().  Nothing but the UART and the RTC may be running.
+ * @note 2: Only returns if the bootloader should keep running.
+ *
+ * @param   None
+ * @return: CBErrorCode reason the application wasn't launched:
+ *    @arg ERR_APP_IMG_LAUNCH_HELD: the application asked to stay here.
+ *    @arg any error from APP_IMG_validate().
+ */
+CBErrorCode LAUNCH_tryApp( void );
+
+/**
+ * @}
+ * end addtogroup groupAppImg
+ */
+
+#endif                                                        /* APP_LAUNCH_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -26,6 +26,10 @@
 #include "serial.h"
 #include "nor.h"                               /* M29WV128G NOR Flash support */
 #include "sdram.h"                          /* MT48LC2M3B2B5-7E SDRAM support */
+#include "qspy_stream.h"                       /* QSPY trace streaming support */
+#include "boot_prof.h"                             /* Boot time profiler support */
+#include "app_launch.h"                        /* Application launch support */
+#include "stack_mon.h"                          /* Task stack usage support */
 #include "projdefs.h"                          /* FreeRTOS base types support */
 #include "task.h"
 
@@ -45,11 +49,6 @@ __IO uint32_t TS_Pressed;
 static uint8_t  l_SysTick_Handler;
 QSTimeCtr QS_tickTime_;
 QSTimeCtr QS_tickPeriod_;
-
-
-#define QS_BUF_SIZE   (2*1024)
-#define QS_BAUD_RATE  115200
-
 #endif
 
 /* Private function prototypes -----------------------------------------------*/
@@ -71,24 +70,44 @@ void BSP_init( void )
    /* Enable the CRC Module */
    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC, ENABLE);
 
+   /* Start the DWT cycle counter.  QF uses it to time every event dispatched
+    * to an AO (see QF_rtcStats[]) and the boot profiler counts from here. */
+   CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+   DWT->CYCCNT = 0;
+   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
    /* 1. Initialize the Serial for printfs to the serial port */
+   BOOT_begin( BOOT_STEP_SERIAL );
    Serial_Init( SERIAL_UART1 );
+   BOOT_end( BOOT_STEP_SERIAL );
 
-   /* 2. Initialize the RTC for getting time stamps. */
+   /* 2. Initialize the RTC for getting time stamps.  It runs off the nominal
+    * LSI rate until the CPLR task calibrates it with TIME_calibrateLSI(). */
+   BOOT_begin( BOOT_STEP_RTC );
    TIME_Init();
+   BOOT_end( BOOT_STEP_RTC );
+
+   /* Hand over to the application right away if there is a good one and it
+    * didn't ask to stay in the bootloader.  Only returns if not. */
+   BOOT_begin( BOOT_STEP_APP_CHECK );
+   LAUNCH_tryApp();
+   BOOT_end( BOOT_STEP_APP_CHECK );
 
 
    RCC_ClocksTypeDef RCC_Clocks;
    RCC_GetClocksFreq(&RCC_Clocks);
    dbg_slow_printf("Clock speed: %d\n", RCC_Clocks.SYSCLK_Frequency);
 
-   /* 3. Initialize Ethernet */
-   ETH_BSP_Config();
+   /* 3. Ethernet is brought up by a task once the scheduler is running since
+    * the PHY reset and auto-negotiation take seconds.  See ETH_BSP_Config(). */
 
    /* 4. Initialize the I2C devices and associated busses */
+   BOOT_begin( BOOT_STEP_I2C );
    I2C_BusInit( I2CBus1 );
+   BOOT_end( BOOT_STEP_I2C );
 
    /* 5. Initialize the NOR flash */
+   BOOT_begin( BOOT_STEP_NOR );
    NOR_Init();
 
    /* NOR IDs structure */
@@ -105,6 +124,7 @@ void BSP_init( void )
    dbg_slow_printf("NOR ID: DevCode1 : 0x%04x\n", pNOR_ID.Device_Code1);
    dbg_slow_printf("NOR ID: DevCode2 : 0x%04x\n", pNOR_ID.Device_Code2);
    dbg_slow_printf("NOR ID: DevCode3 : 0x%04x\n", pNOR_ID.Device_Code3);
+   BOOT_end( BOOT_STEP_NOR );
 
    /* 6. Initialize the SDRAM  - this is already init in low_level startup code
    SDRAM_Init();
@@ -219,17 +239,7 @@ void QK_onIdle(void)
 
 #ifdef Q_SPY
 
-   if ((USART1->SR & USART_FLAG_TXE) != 0) {              /* is TXE empty? */
-      uint16_t b;
-
-      QF_INT_DISABLE();
-      b = QS_getByte();
-      QF_INT_ENABLE();
-
-      if (b != QS_EOD) {                              /* not End-Of-Data? */
-         USART1->DR = (b & 0xFF);             /* put into the DR register */
-      }
-   }
+   QSPY_drain();       /* Hand QS data to the LWIPMgr AO for UDP streaming */
 
 #elif defined NDEBUG
    __WFI();                                          /* wait for interrupt */
@@ -293,11 +303,9 @@ void Q_onAssert(char const * const file, int line)
  *          0: on failure
  */
 uint8_t QS_onStartup(void const *arg) {
-   static uint8_t qsBuf[QS_BUF_SIZE];            /* buffer for Quantum Spy */
-   QS_initBuf(qsBuf, sizeof(qsBuf));
-
-   /* USART3 and GPIOA/AFIO clocks are already enabled by this point */
-
+   /* QS buffer lives in SDRAM and is streamed out over UDP by LWIPMgr so the
+    * serial console is left alone. */
+   QSPY_init();
 
    QS_tickPeriod_ = (QSTimeCtr)(SystemCoreClock / BSP_TICKS_PER_SEC);
    QS_tickTime_ = QS_tickPeriod_;        /* to start the timestamp at zero */
@@ -394,7 +402,11 @@ QSTimeCtr QS_onGetTime(void) {            /* invoked with interrupts locked */
  * @brief  QS callback that flushes the serial buffer.
  *
  * This function is a callback implementation defined by QSPY that is used to
- * flush the serial buffer after it's filled up.
+ * flush the QS buffer after it's filled up.  The data can only go out once
+ * LWIPMgr gets to run and the idle hook is the only producer of the stream
+ * ring, so nothing is done here.  QS_onFlush() is called from whatever AO
+ * emits a dictionary, which could preempt the idle hook in the middle of
+ * QSPY_drain().
  *
  * @note 1: this function only exists on QSPY builds.
  *
@@ -402,16 +414,7 @@ QSTimeCtr QS_onGetTime(void) {            /* invoked with interrupts locked */
  * @return  None
  */
 void QS_onFlush(void) {
-   uint16_t b;
-   QF_INT_DISABLE();
-   while ((b = QS_getByte()) != QS_EOD) {      /* while not End-Of-Data... */
-      QF_INT_ENABLE();
-      while ((USART1->SR & USART_FLAG_TXE) == 0) { /* while TXE not empty */
-      }
-      USART1->DR = (b & 0xFF);                /* put into the DR register */
-      QF_INT_DISABLE();
-   }
-   QF_INT_ENABLE();
+   /* Left for the idle hook (see QSPY_drain()) */
 }
 #endif                                                             /* Q_SPY */
 /*--------------------------------------------------------------------------*/
@@ -473,6 +476,11 @@ void vApplicationTickHook(void)
  * is idle.  It is used by QSPY (if compiled in) to send data out to prevent
  * interfering with the system as much as possible.
  *
+ * It also lets the stack monitor look at one more task stack now and then.
+ * With tickless idle (release builds) the sleeping is left to
+ * vPortSuppressTicksAndSleep() in tickless.c, which FreeRTOS calls right after
+ * this hook.
+ *
  * This function can also be used to visualize idle activity.
  *
  * @param   None
@@ -480,21 +488,13 @@ void vApplicationTickHook(void)
  */
 void vApplicationIdleHook( void )
 {
-#ifdef Q_SPY
+   STK_MON_poll();
 
-   if ((USART1->SR & USART_FLAG_TXE) != 0) {              /* is TXE empty? */
-      uint16_t b;
-
-      QF_INT_DISABLE();
-      b = QS_getByte();
-      QF_INT_ENABLE();
+#ifdef Q_SPY
 
-      if (b != QS_EOD) {                              /* not End-Of-Data? */
-         USART1->DR = (b & 0xFF);             /* put into the DR register */
-      }
-   }
+   QSPY_drain();       /* Hand QS data to the LWIPMgr AO for UDP streaming */
 
-#elif defined NDEBUG
+#elif defined NDEBUG && configUSE_TICKLESS_IDLE == 0
    __WFI();                                          /* wait for interrupt */
 #endif
 }
@@ -23,6 +23,7 @@
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#include "CBErrors.h"                                  /* For CBErrorCode */
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -57,10 +58,18 @@
 
 /**
  * @brief  Configure ethernet, PHY, MAC, and EthDMA.
+ *
+ * Waits for the link and for auto-negotiation to finish, which takes seconds,
+ * so it's called from a low priority FreeRTOS task after the scheduler has
+ * started instead of from BSP_init().  Must be done before the LWIPMgr AO is
+ * started since resetting the MAC wipes out the DMA setup of the netif.
+ *
  * @param  None
- * @retval None
+ * @retval CBErrorCode:
+ *    @arg ERR_NONE: the MAC is configured for the negotiated link.
+ *    @arg ERR_ETH_INIT_FAILED: no link or auto-negotiation timed out.
  */
-void  ETH_BSP_Config( void );
+CBErrorCode ETH_BSP_Config( void );
 
 /**
  * @brief  Configure the PHY to generate an interrupt on change of link status.
@@ -374,7 +374,7 @@ uint32_t ETH_Init(ETH_InitTypeDef* ETH_InitStruct, uint16_t PHYAddress)
   
   /* Delay to assure PHY reset */
   _eth_delay_(PHY_RESET_DELAY);
-  dbg_slow_printf("Phy reset\n");
+  DBG_printf("Phy reset\n");
     
   if(ETH_InitStruct->ETH_AutoNegotiation != ETH_AutoNegotiation_Disable)
   {  
@@ -383,13 +383,13 @@ uint32_t ETH_Init(ETH_InitTypeDef* ETH_InitStruct, uint16_t PHYAddress)
     {
       timeout++;
     } while (!(ETH_ReadPHYRegister(PHYAddress, PHY_BSR) & PHY_Linked_Status) && (timeout < PHY_READ_TO));
-dbg_slow_printf("Linked status wait finished\n");
+DBG_printf("Linked status wait finished\n");
     /* Return ERROR in case of timeout */
     if(timeout == PHY_READ_TO)
     {
       return ETH_ERROR;
     }
-dbg_slow_printf("Linked status is set\n");
+DBG_printf("Linked status is set\n");
     /* Reset Timeout counter */
     timeout = 0; 
     /* Enable Auto-Negotiation */
@@ -410,7 +410,7 @@ dbg_slow_printf("Linked status is set\n");
     {
       return ETH_ERROR;
     }
-dbg_slow_printf("auto-negotiation is set\n");
+DBG_printf("auto-negotiation is set\n");
     /* Reset Timeout counter */
     timeout = 0;
     
@@ -422,13 +422,13 @@ dbg_slow_printf("auto-negotiation is set\n");
     {
       /* Set Ethernet duplex mode to Full-duplex following the auto-negotiation */
       ETH_InitStruct->ETH_Mode = ETH_Mode_FullDuplex;  
-dbg_slow_printf("Eth is set to Full Duplex\n");
+DBG_printf("Eth is set to Full Duplex\n");
     }
     else
     {
       /* Set Ethernet duplex mode to Half-duplex following the auto-negotiation */
       ETH_InitStruct->ETH_Mode = ETH_Mode_HalfDuplex;
-dbg_slow_printf("Eth is set to Half Duplex\n");
+DBG_printf("Eth is set to Half Duplex\n");
     }
 
     /* Configure the MAC with the speed fixed by the auto-negotiation process */
@@ -436,13 +436,13 @@ dbg_slow_printf("Eth is set to Half Duplex\n");
     {  
       /* Set Ethernet speed to 10M following the auto-negotiation */    
       ETH_InitStruct->ETH_Speed = ETH_Speed_10M;
-dbg_slow_printf("Eth speed is set to 10 Mb\n");
+DBG_printf("Eth speed is set to 10 Mb\n");
     }
     else
     {   
       /* Set Ethernet speed to 100M following the auto-negotiation */ 
       ETH_InitStruct->ETH_Speed = ETH_Speed_100M;
-dbg_slow_printf("Eth speed is set to 100 Mb\n");
+DBG_printf("Eth speed is set to 100 Mb\n");
     }    
   }
   else
@@ -1154,9 +1154,9 @@ uint32_t ETH_Prepare_Transmit_Descriptors(u16 FrameLength)
   if ((ETH->DMASR & ETH_DMASR_TBUS) != (u32)RESET)
   {
     /* Clear TBUS ETHERNET DMA flag */
-    ETH->DMASR = ETH_DMASR_TBUS;
+    ETH_DMASR_CLEAR(ETH_DMASR_TBUS);
     /* Resume DMA transmission*/
-    ETH->DMATPDR = 0;
+    ETH_TX_POLL_DEMAND();
   }
   
   /* Return SUCCESS */
@@ -1822,7 +1822,7 @@ void ETH_DMAClearFlag(uint32_t ETH_DMA_FLAG)
   assert_param(IS_ETH_DMA_FLAG(ETH_DMA_FLAG));
   
   /* Clear the selected ETHERNET DMA FLAG */
-  ETH->DMASR = (uint32_t) ETH_DMA_FLAG;
+  ETH_DMASR_CLEAR(ETH_DMA_FLAG);
 }
 
 /**
@@ -1934,7 +1934,7 @@ void ETH_DMAClearITPendingBit(uint32_t ETH_DMA_IT)
   assert_param(IS_ETH_DMA_IT(ETH_DMA_IT));
   
   /* Clear the selected ETHERNET DMA IT */
-  ETH->DMASR = (uint32_t) ETH_DMA_IT;
+  ETH_DMASR_CLEAR(ETH_DMA_IT);
 }
 
 /**
@@ -2140,7 +2140,7 @@ uint32_t ETH_GetCurrentRxBufferAddress(void)
   */
 void ETH_ResumeDMATransmission(void)
 {
-  ETH->DMATPDR = 0;
+  ETH_TX_POLL_DEMAND();
 }
 
 /**
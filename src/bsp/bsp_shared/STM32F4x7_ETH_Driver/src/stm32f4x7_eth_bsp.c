@@ -59,7 +59,7 @@ static void ETH_MACDMA_Config(void);
 /* Private functions ---------------------------------------------------------*/
 
 /******************************************************************************/
-void ETH_BSP_Config(void)
+CBErrorCode ETH_BSP_Config(void)
 {
    /* Configure the GPIO ports for ethernet pins */
    ETH_GPIO_Config();
@@ -67,13 +67,12 @@ void ETH_BSP_Config(void)
    /* Configure the Ethernet MAC/DMA */
    ETH_MACDMA_Config();
 
+   /* The scheduler is running by now so no slow printfs from here on */
    if (EthInitStatus == 0) {
-      err_slow_printf("Ethernet Init failed\n");
-      /* TODO: this can be handled better. Find out how to best tackle this from
-       * a system POV.  HR */
-      while(1);
+      ERR_printf("Ethernet Init failed\n");
+      return( ERR_ETH_INIT_FAILED );
    } else {
-      dbg_slow_printf("Ethernet Init succeeded\n");
+      DBG_printf("Ethernet Init succeeded\n");
    }
 
    /* Configure the PHY to generate an interrupt on change of link status
@@ -87,6 +86,7 @@ void ETH_BSP_Config(void)
    /* Configure the EXTI for Ethernet link status. */
 //   Eth_Link_EXTIConfig();
 
+   return( ERR_NONE );
 }
 
 /******************************************************************************/
@@ -152,8 +152,9 @@ static void ETH_MACDMA_Config( void )
    /* Configure Ethernet */
    EthInitStatus = ETH_Init(&ETH_InitStructure, DP83848_PHY_ADDRESS);
 
-   /* Enable the Ethernet Rx and Tx Interrupts */
-   ETH_DMAITConfig(ETH_DMA_IT_NIS | ETH_DMA_IT_R | ETH_DMA_IT_T, ENABLE);
+   /* Enable the Ethernet Rx Interrupt.  The Tx one is only turned on by
+    * eth_driver.c while frames are waiting for a Tx descriptor. */
+   ETH_DMAITConfig(ETH_DMA_IT_NIS | ETH_DMA_IT_R, ENABLE);
 }
 
 /******************************************************************************/
@@ -0,0 +1,122 @@
+/**
+ * @file   app_img.c
+ * @brief  Definitions for validating the application image in flash.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupAppImg
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_img.h"
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+
+/**< Smallest image that holds the stack pointer and the reset vector */
+#define APP_IMG_MIN_SIZE                                                     8
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Read a little endian word from the image.
+ * @param [in] *p: const uint8_t pointer to the word.
+ * @return: uint32_t value.
+ */
+static uint32_t APP_IMG_getWord( const uint8_t *p );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint32_t APP_IMG_getWord( const uint8_t *p )
+{
+   return( (uint32_t)p[0]         | ((uint32_t)p[1] << 8) |
+          ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24) );
+}
+
+/******************************************************************************/
+CBErrorCode APP_IMG_checkVectors( const uint8_t *pImg, uint32_t size )
+{
+   if ( APP_IMG_ERASED == size || size < APP_IMG_MIN_SIZE ||
+         size > APP_IMG_MAX_SIZE ) {
+      return( ERR_APP_IMG_NOT_FOUND );
+   }
+
+   uint32_t sp = APP_IMG_getWord( &pImg[0] );
+   if ( !( sp >  APP_IMG_SRAM_START && sp <= APP_IMG_SRAM_END ) &&
+        !( sp >  APP_IMG_CCM_START  && sp <= APP_IMG_CCM_END ) ) {
+      return( ERR_APP_IMG_BAD_VECTORS );
+   }
+
+   /* Reset handler has to be in the image and be a thumb address */
+   uint32_t reset = APP_IMG_getWord( &pImg[4] );
+   if ( 0 == ( reset & 1 ) ||
+         reset < APP_IMG_START_ADDR || reset >= APP_IMG_START_ADDR + size ) {
+      return( ERR_APP_IMG_BAD_VECTORS );
+   }
+
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+CBErrorCode APP_IMG_validate(
+      const uint8_t *pImg,
+      uint32_t size,
+      uint32_t crc,
+      const AppImgMark_t *pMark,
+      APP_IMG_CrcFn crcFn,
+      AppImgMark_t *pNewMark,
+      bool *pbCached
+)
+{
+   *pbCached = false;
+
+   CBErrorCode status = APP_IMG_checkVectors( pImg, size );
+   if ( ERR_NONE != status ) {
+      return( status );
+   }
+
+   uint32_t headLen = ( size < APP_IMG_HEAD_LEN ) ? size : APP_IMG_HEAD_LEN;
+   pNewMark->magic   = APP_IMG_MARK_MAGIC;
+   pNewMark->size    = size;
+   pNewMark->crc     = crc;
+   pNewMark->headCrc = crcFn( pImg, headLen );
+
+   if ( pMark->magic   == pNewMark->magic &&
+        pMark->size    == pNewMark->size &&
+        pMark->crc     == pNewMark->crc &&
+        pMark->headCrc == pNewMark->headCrc ) {
+      *pbCached = true;
+      return( ERR_NONE );
+   }
+
+   /* No mark or it was made for something else so check the whole thing */
+   if ( crc != crcFn( pImg, size ) ) {
+      return( ERR_APP_IMG_CRC_MISMATCH );
+   }
+
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+bool APP_IMG_isMarkBlank( const AppImgMark_t *pMark )
+{
+   return( APP_IMG_ERASED == pMark->magic &&
+           APP_IMG_ERASED == pMark->size &&
+           APP_IMG_ERASED == pMark->crc &&
+           APP_IMG_ERASED == pMark->headCrc );
+}
+
+/**
+ * @}
+ * end addtogroup groupAppImg
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,174 @@
+/**
+ * @file   app_img.h
+ * @brief  Declarations for validating the application image in flash.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupAppImg
+ * @{
+ *
+ * The application image lives at APP_IMG_START_ADDR and the tool that loads
+ * it stores its size and CRC32 in the last two words of flash.  Checking the
+ * CRC of the whole image on every boot is slow, so once an image has passed,
+ * a "verified" mark is written to the 4 words right below the size and crc:
+ *
+ *    | magic | size | crc | head crc | size | crc | <- end of flash
+ *    |<----- verified mark ------->|
+ *
+ * The mark repeats the size and crc it was made for and adds the CRC of the
+ * first APP_IMG_HEAD_LEN bytes of the image.  On the next boot, only the
+ * vector table and the head are checked against the mark.  Loading a new
+ * image erases the last sector, which clears the mark along with the size and
+ * crc.  The head crc catches images that were put in some other way (a
+ * debugger) over an old mark.
+ *
+ * Nothing in here touches hardware.  Flash is passed in as a pointer and the
+ * CRC as a function so all of it can be run on a host.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_IMG_H_
+#define APP_IMG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "CBErrors.h"                                  /* For CBErrorCode */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< First address of the application (USER_FLASH_FIRST_PAGE_ADDRESS) */
+#define APP_IMG_START_ADDR                                          0x08020000
+
+/**< Largest image FLASH_If_Erase() makes room for (sectors 5 to 10) */
+#define APP_IMG_MAX_SIZE                                                786432
+
+/**< Where the loader stores the image size (FLASH_APPL_SIZE_ADDRESS) */
+#define APP_IMG_SIZE_ADDR                                           0x080FFFF8
+
+/**< Where the loader stores the image CRC32 (FLASH_APPL_CRC_ADDRESS) */
+#define APP_IMG_CRC_ADDR                                            0x080FFFFC
+
+/**< Where the verified mark goes, right below the size */
+#define APP_IMG_MARK_ADDR       ( APP_IMG_SIZE_ADDR - sizeof(AppImgMark_t) )
+
+/**< First word of a verified mark */
+#define APP_IMG_MARK_MAGIC                                          0x4150504Bu
+
+/**< Number of bytes at the start of the image checked on every boot */
+#define APP_IMG_HEAD_LEN                                                  1024
+
+/**< Value of an erased flash word */
+#define APP_IMG_ERASED                                              0xFFFFFFFFu
+
+/**< RAM the initial stack pointer of the image may point into: the main SRAM
+ * and the CCM.  The stack pointer may be right at the end of either. */
+#define APP_IMG_SRAM_START                                          0x20000000
+#define APP_IMG_SRAM_END                                            0x20030000
+#define APP_IMG_CCM_START                                           0x10000000
+#define APP_IMG_CCM_END                                             0x10010000
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct AppImgMark_t
+ * The verified mark as laid out in flash.
+ */
+typedef struct AppImgMarks
+{
+   uint32_t magic;                               /**< APP_IMG_MARK_MAGIC */
+   uint32_t size;                 /**< Image size the mark was made for */
+   uint32_t crc;                   /**< Image crc the mark was made for */
+   uint32_t headCrc;      /**< CRC of the first APP_IMG_HEAD_LEN bytes */
+} AppImgMark_t;
+
+/**
+ * @brief Function that computes the CRC32 of a block of memory.
+ * @param [in] *data: const uint8_t pointer to the data.
+ * @param [in] len: uint32_t number of bytes.
+ * @return: uint32_t CRC32, same as zip/Boost compute it.
+ */
+typedef uint32_t (*APP_IMG_CrcFn)( const uint8_t *data, uint32_t len );
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Sanity check the vector table at the start of the image.
+ *
+ * The initial stack pointer has to point into RAM and the reset handler has to
+ * be a thumb address inside the image.
+ *
+ * @param [in] *pImg: const uint8_t pointer to the image (APP_IMG_START_ADDR on
+ * the target).
+ * @param [in] size: uint32_t size of the image as stored by the loader.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: vector table looks sane.
+ *    @arg ERR_APP_IMG_NOT_FOUND: no image or the size is out of range.
+ *    @arg ERR_APP_IMG_BAD_VECTORS: the vector table doesn't look like one.
+ */
+CBErrorCode APP_IMG_checkVectors( const uint8_t *pImg, uint32_t size );
+
+/**
+ * @brief   Validate the image, using the verified mark when it's good.
+ *
+ * Checks the vector table and the head crc.  If the mark matches, the image is
+ * taken as good.  Otherwise the crc of the whole image is checked against the
+ * stored one.
+ *
+ * @param [in] *pImg: const uint8_t pointer to the image.
+ * @param [in] size: uint32_t size of the image as stored by the loader.
+ * @param [in] crc: uint32_t crc of the image as stored by the loader.
+ * @param [in] *pMark: const AppImgMark_t pointer to the mark as it is in flash.
+ * @param [in] crcFn: APP_IMG_CrcFn used to compute the CRCs.
+ * @param [out] *pNewMark: AppImgMark_t pointer filled with the mark that goes
+ * with this image.  Only valid if ERR_NONE is returned.
+ * @param [out] *pbCached: bool pointer set to true if the mark was used and to
+ * false if the whole image had to be checked.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: the image is good.
+ *    @arg ERR_APP_IMG_NOT_FOUND: no image or the size is out of range.
+ *    @arg ERR_APP_IMG_BAD_VECTORS: the vector table doesn't look like one.
+ *    @arg ERR_APP_IMG_CRC_MISMATCH: the image doesn't match the stored crc.
+ */
+CBErrorCode APP_IMG_validate(
+      const uint8_t *pImg,
+      uint32_t size,
+      uint32_t crc,
+      const AppImgMark_t *pMark,
+      APP_IMG_CrcFn crcFn,
+      AppImgMark_t *pNewMark,
+      bool *pbCached
+);
+
+/**
+ * @brief   Check if the mark in flash is still erased and can be written.
+ *
+ * A mark can only be programmed once after the sector is erased.  If there is
+ * a stale one, the whole image gets checked on every boot until the next
+ * image is loaded.
+ *
+ * @param [in] *pMark: const AppImgMark_t pointer to the mark as it is in flash.
+ * @return: bool true if every word of the mark is erased.
+ */
+bool APP_IMG_isMarkBlank( const AppImgMark_t *pMark );
+
+/**
+ * @}
+ * end addtogroup groupAppImg
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                           /* APP_IMG_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
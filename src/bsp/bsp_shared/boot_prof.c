@@ -0,0 +1,244 @@
+/**
+ * @file   boot_prof.c
+ * @brief  Definitions for the boot time profiler.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupBootProf
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_prof.h"
+#include "con_fmt.h"                                    /* For FMT_snprintf() */
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \enum BootState_t
+ * Where a step is at.  Kept in a byte so marking a step is a single store.
+ */
+typedef enum BootStates
+{
+   BOOT_NOT_RUN = 0,                                 /**< Hasn't started yet */
+   BOOT_RUNNING,                                /**< Started but not ended */
+   BOOT_ENDED,                                           /**< Begin and end */
+} BootState_t;
+
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+static volatile uint32_t l_bootBegin[BOOT_STEP_MAX];
+static volatile uint32_t l_bootEnd[BOOT_STEP_MAX];
+static volatile uint8_t  l_bootState[BOOT_STEP_MAX];      /**< BootState_t */
+
+/**< Names of the steps as they show up in the timeline */
+static const char * const l_bootNames[BOOT_STEP_MAX] = {
+      [BOOT_STEP_SERIAL]    = "serial",
+      [BOOT_STEP_RTC]       = "rtc",
+      [BOOT_STEP_APP_CHECK] = "app.check",
+      [BOOT_STEP_I2C]       = "i2c",
+      [BOOT_STEP_NOR]       = "nor",
+      [BOOT_STEP_QF_INIT]   = "qf.init",
+      [BOOT_STEP_AO_START]  = "ao.start",
+      [BOOT_STEP_SCHED]     = "sched",
+      [BOOT_STEP_LSI_CAL]   = "lsi.cal",
+      [BOOT_STEP_DB_LOAD]   = "db.load",
+      [BOOT_STEP_ETH_PHY]   = "eth.phy",
+      [BOOT_STEP_NET_UP]    = "net.up",
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Convert a cycle count to us.
+ * @param [in] cycles: uint64_t cycle count.
+ * @param [in] cyclesPerSec: uint32_t rate of the cycle counter.
+ * @return: uint32_t time in us.
+ */
+static uint32_t BOOT_toUs( uint64_t cycles, uint32_t cyclesPerSec );
+
+/**
+ * @brief   Turn the stamps into cycles since BSP_init, past any wrap of the
+ * counter.
+ *
+ * The counter wraps every 2^32 cycles (23.8 s at 180 MHz).  A step is taken
+ * to start within half of that of the step before it that has started, and
+ * to last less than all of it.
+ *
+ * @param [out] *pBegin: uint64_t array of BOOT_STEP_MAX starts.
+ * @param [out] *pEnd: uint64_t array of BOOT_STEP_MAX ends.  Only set for the
+ * steps that ended.
+ * @return: None
+ */
+static void BOOT_unwrap( uint64_t *pBegin, uint64_t *pEnd );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint32_t BOOT_toUs( uint64_t cycles, uint32_t cyclesPerSec )
+{
+   return( (uint32_t)( cycles * 1000000u / cyclesPerSec ) );
+}
+
+/******************************************************************************/
+static void BOOT_unwrap( uint64_t *pBegin, uint64_t *pEnd )
+{
+   int64_t  prevBegin = 0;
+   uint32_t prevStamp = 0;
+
+   for ( uint8_t i = 0; i < BOOT_STEP_MAX; i++ ) {
+      if ( BOOT_NOT_RUN == l_bootState[i] ) {
+         continue;
+      }
+
+      int64_t begin = prevBegin + (int32_t)( l_bootBegin[i] - prevStamp );
+      if ( begin < 0 ) {
+         begin += (int64_t)1 << 32;       /* Can't start before BSP_init() */
+      }
+      pBegin[i] = (uint64_t)begin;
+      prevBegin = begin;
+      prevStamp = l_bootBegin[i];
+
+      if ( BOOT_ENDED == l_bootState[i] ) {
+         pEnd[i] = pBegin[i] + (uint32_t)( l_bootEnd[i] - l_bootBegin[i] );
+      }
+   }
+}
+
+/******************************************************************************/
+void BOOT_begin( BootStep_t step )
+{
+   if ( step < BOOT_STEP_MAX ) {
+      l_bootBegin[step] = BOOT_PROF_NOW();
+      l_bootState[step] = BOOT_RUNNING;
+   }
+}
+
+/******************************************************************************/
+void BOOT_end( BootStep_t step )
+{
+   if ( step < BOOT_STEP_MAX ) {
+      l_bootEnd[step]   = BOOT_PROF_NOW();
+      l_bootState[step] = BOOT_ENDED;
+   }
+}
+
+/******************************************************************************/
+void BOOT_set( BootStep_t step, uint32_t begin, uint32_t end )
+{
+   if ( step < BOOT_STEP_MAX ) {
+      l_bootBegin[step] = begin;
+      l_bootEnd[step]   = end;
+      l_bootState[step] = BOOT_ENDED;
+   }
+}
+
+/******************************************************************************/
+bool BOOT_isDone( void )
+{
+   for ( uint8_t i = 0; i < BOOT_STEP_MAX; i++ ) {
+      if ( BOOT_ENDED != l_bootState[i] ) {
+         return( false );
+      }
+   }
+   return( true );
+}
+
+/******************************************************************************/
+uint32_t BOOT_report( uint32_t cyclesPerSec, BOOT_LineFn out )
+{
+   char line[BOOT_MAX_LINE_LEN + 1];
+   char bar[BOOT_BAR_WIDTH + 1];
+   uint64_t begin[BOOT_STEP_MAX];
+   uint64_t end[BOOT_STEP_MAX];
+   uint64_t totalCycles = 0;
+
+   BOOT_unwrap( begin, end );
+
+   /* The step that finished last sets the scale of the bars */
+   for ( uint8_t i = 0; i < BOOT_STEP_MAX; i++ ) {
+      if ( BOOT_ENDED == l_bootState[i] && end[i] > totalCycles ) {
+         totalCycles = end[i];
+      }
+   }
+   uint32_t totalUs = BOOT_toUs( totalCycles, cyclesPerSec );
+
+   out( "Boot timeline, ms since BSP_init:" );
+   FMT_snprintf(
+         line, sizeof(line),
+         "%-10s %9s %9s |0%*u ms|",
+         "step", "start", "dur", BOOT_BAR_WIDTH - 4, totalUs / 1000
+   );
+   out( line );
+
+   for ( uint8_t i = 0; i < BOOT_STEP_MAX; i++ ) {
+      if ( BOOT_NOT_RUN == l_bootState[i] ) {
+         FMT_snprintf( line, sizeof(line), "%-10s   not run", l_bootNames[i] );
+         out( line );
+         continue;
+      }
+
+      uint32_t beginUs = BOOT_toUs( begin[i], cyclesPerSec );
+      if ( BOOT_RUNNING == l_bootState[i] ) {
+         FMT_snprintf(
+               line, sizeof(line),
+               "%-10s %5u.%03u   running",
+               l_bootNames[i], beginUs / 1000, beginUs % 1000
+         );
+         out( line );
+         continue;
+      }
+
+      uint32_t durUs = BOOT_toUs( end[i] - begin[i], cyclesPerSec );
+
+      /* Every step gets at least one mark so the short ones still show up */
+      uint32_t first = 0;
+      uint32_t last  = 0;
+      if ( 0 != totalCycles ) {
+         first = (uint32_t)( begin[i] * BOOT_BAR_WIDTH / totalCycles );
+         last  = (uint32_t)( end[i]   * BOOT_BAR_WIDTH / totalCycles );
+      }
+      if ( first >= BOOT_BAR_WIDTH ) {
+         first = BOOT_BAR_WIDTH - 1;
+      }
+      if ( last <= first ) {
+         last = first + 1;
+      }
+
+      for ( uint32_t col = 0; col < BOOT_BAR_WIDTH; col++ ) {
+         bar[col] = ( col >= first && col < last ) ? '#' : ' ';
+      }
+      bar[BOOT_BAR_WIDTH] = '\0';
+
+      FMT_snprintf(
+            line, sizeof(line),
+            "%-10s %5u.%03u %5u.%03u |%s|",
+            l_bootNames[i],
+            beginUs / 1000, beginUs % 1000,
+            durUs / 1000, durUs % 1000,
+            bar
+      );
+      out( line );
+   }
+
+   FMT_snprintf(
+         line, sizeof(line),
+         "Boot took %u.%03u ms",
+         totalUs / 1000, totalUs % 1000
+   );
+   out( line );
+
+   return( totalUs );
+}
+
+/**
+ * @}
+ * end addtogroup groupBootProf
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,155 @@
+/**
+ * @file   boot_prof.h
+ * @brief  Declarations for the boot time profiler.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupBootProf
+ * @{
+ *
+ * Every step of the startup marks when it begins and ends with a read of the
+ * DWT cycle counter, which BSP_init() starts from 0.  Steps that run after the
+ * scheduler has started may overlap.  Once every step has ended, the CPLR
+ * task prints the timeline, one line per step:
+ *
+ *    Boot timeline, ms since BSP_init:
+ *    step          start      dur |0                        2345 ms|
+ *    serial        0.000    0.153 |#                              |
+ *    ...
+ *    eth.phy      12.210 2333.101 | ############################# |
+ *
+ * The bar of each step spans the part of the whole boot it took up, so steps
+ * that ran at the same time are easy to spot.  Time spent in the startup code
+ * before BSP_init() (clocks and SDRAM) is not counted.
+ *
+ * The counter wraps every 23.8 s at 180 MHz.  The report follows it across
+ * the wrap as long as each step starts within half of that of the one before
+ * it and none of them takes longer than all of it.
+ *
+ * Marking a step is a single store so it is safe from any context.  The
+ * counter is read through BOOT_PROF_NOW().  A host build can define it (and
+ * pass any clock rate to BOOT_report()) to reproduce a timeline from recorded
+ * stamps.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef BOOT_PROF_H_
+#define BOOT_PROF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported defines ----------------------------------------------------------*/
+#ifndef BOOT_PROF_NOW
+#include "stm32f4xx.h"                                 /* For STM32F4 support */
+
+/**< Read the free running cycle counter */
+#define BOOT_PROF_NOW()                                           ( DWT->CYCCNT )
+#endif                                                       /* BOOT_PROF_NOW */
+
+/**< Longest line BOOT_report() passes to its output function, without NULL */
+#define BOOT_MAX_LINE_LEN                                                   72
+
+/**< Width of the bars in the timeline */
+#define BOOT_BAR_WIDTH                                                      32
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \enum BootStep_t
+ * Steps of the startup, roughly in the order they start.
+ */
+typedef enum BootSteps
+{
+   BOOT_STEP_SERIAL = 0,               /**< Serial_Init() of the console UART */
+   BOOT_STEP_RTC,                  /**< TIME_Init() with the nominal LSI rate */
+   BOOT_STEP_APP_CHECK,       /**< Validating the application image, if any */
+   BOOT_STEP_I2C,                                /**< I2C_BusInit() of bus 1 */
+   BOOT_STEP_NOR,                          /**< NOR_Init() and reading its ID */
+   BOOT_STEP_QF_INIT,            /**< AO ctors, QF_init(), pools and queues */
+   BOOT_STEP_AO_START,             /**< Starting the AOs and the CPLR task */
+   BOOT_STEP_SCHED,      /**< From QF_run() until the CPLR task first runs */
+   BOOT_STEP_LSI_CAL,          /**< Measuring the LSI and trimming the RTC */
+   BOOT_STEP_DB_LOAD,                 /**< Validating and reading the DB */
+   BOOT_STEP_ETH_PHY,     /**< MAC reset, PHY reset and auto-negotiation */
+   BOOT_STEP_NET_UP,                              /**< Starting the LWIPMgr AO */
+
+   BOOT_STEP_MAX                                     /**< ALWAYS LAST */
+} BootStep_t;
+
+/**
+ * @brief Function that prints one line of the timeline.
+ * @param [in] *line: const char pointer to the NULL terminated line without a
+ * newline.
+ * @return: None
+ */
+typedef void (*BOOT_LineFn)( const char *line );
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Mark the start of a step.
+ * @param [in] step: BootStep_t step that is starting.
+ * @return: None
+ */
+void BOOT_begin( BootStep_t step );
+
+/**
+ * @brief   Mark the end of a step.
+ * @param [in] step: BootStep_t step that just finished.
+ * @return: None
+ */
+void BOOT_end( BootStep_t step );
+
+/**
+ * @brief   Set the stamps of a step directly.
+ *
+ * Only meant for reproducing a recorded timeline on a host.
+ *
+ * @param [in] step: BootStep_t step.
+ * @param [in] begin: uint32_t cycle count when the step started.
+ * @param [in] end: uint32_t cycle count when the step ended.
+ * @return: None
+ */
+void BOOT_set( BootStep_t step, uint32_t begin, uint32_t end );
+
+/**
+ * @brief   Check if every step has ended.
+ * @param   None
+ * @return: bool true if the timeline is complete.
+ */
+bool BOOT_isDone( void );
+
+/**
+ * @brief   Print the timeline.
+ *
+ * Steps that haven't ended yet are shown as running.
+ *
+ * @param [in] cyclesPerSec: uint32_t rate of the cycle counter.
+ * @param [in] out: BOOT_LineFn function to print each line with.
+ * @return: uint32_t total boot time in us: the end of the step that finished
+ * last.
+ */
+uint32_t BOOT_report( uint32_t cyclesPerSec, BOOT_LineFn out );
+
+/**
+ * @}
+ * end addtogroup groupBootProf
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                        /* BOOT_PROF_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,292 @@
+/**
+ * @file   cpu_load.c
+ * @brief  Definitions for the per task CPU load accounting.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupCpuLoad
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cpu_load.h"
+#include <string.h>
+#ifdef CPU_LOAD_HOST_CLOCK
+#include <time.h>    /* The C library's, so give bsp_shared with -iquote */
+#else
+#include "stm32f4xx.h"                                 /* For STM32F4 support */
+#include "stm32f4xx_rcc.h"                           /* For STM32 clk support */
+#include "stm32f4xx_tim.h"                         /* For STM32 Timer support */
+#endif                                                 /* CPU_LOAD_HOST_CLOCK */
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct CpuLoadTask_t
+ * A task being accounted for.
+ */
+typedef struct CpuLoadTasks
+{
+   TaskHandle_t      task;             /**< NULL until attached or once gone */
+   const char       *name;                            /**< Name of the task */
+   uint32_t          prev;     /**< Run time total when the window started */
+   uint16_t volatile last;                 /**< Load over the last window */
+   uint16_t volatile avg;       /**< Average over the windows in hist[] */
+   uint16_t volatile peak;           /**< Highest single window since boot */
+   uint16_t          hist[CPU_LOAD_N_WINDOWS];  /**< Load of the last windows */
+} CpuLoadTask_t;
+
+/* Private defines -----------------------------------------------------------*/
+
+/**< Room for the status of every task.  Two more than the table for the idle
+ * task and a task that was deleted but not cleaned up yet. */
+#define CPU_LOAD_MAX_STATUS                             ( CPU_LOAD_MAX_TASKS + 2 )
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+static CpuLoadTask_t  l_cpuLoadTasks[CPU_LOAD_MAX_TASKS];
+static CpuLoadTask_t  l_cpuLoadIdle;
+static uint8_t        l_cpuLoadNTasks;
+static uint8_t        l_cpuLoadHead;         /**< Slot of hist[] to fill next */
+static uint8_t volatile l_cpuLoadNWindows;    /**< Slots of hist[] filled */
+static bool           l_cpuLoadStarted;     /**< The first window has begun */
+static TickType_t     l_cpuLoadWindowStart;
+static uint32_t       l_cpuLoadPrevTotal;   /**< Run time counter back then */
+static uint16_t volatile l_cpuLoadBusyPeak;   /**< Busiest window since boot */
+
+/**< Only used by CPU_LOAD_poll() but too big for the stack of its caller */
+static TaskStatus_t   l_cpuLoadStatus[CPU_LOAD_MAX_STATUS];
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Close the window of one task.
+ * @param [in|out] *pTask: CpuLoadTask_t pointer to the task.
+ * @param [in] nStatus: UBaseType_t number of entries in l_cpuLoadStatus.
+ * @param [in] elapsed: uint32_t run time counter ticks the window took, 0 to
+ * only start a new window.
+ * @param [in] nWindows: uint8_t number of windows kept once this one is.
+ * @return: None
+ */
+static void CPU_LOAD_closeWindow(
+      CpuLoadTask_t *pTask,
+      UBaseType_t nStatus,
+      uint32_t elapsed,
+      uint8_t nWindows
+);
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void CPU_LOAD_closeWindow(
+      CpuLoadTask_t *pTask,
+      UBaseType_t nStatus,
+      uint32_t elapsed,
+      uint8_t nWindows
+)
+{
+   uint32_t load = 0;
+
+   if ( NULL != pTask->task ) {
+      UBaseType_t i = 0;
+      while ( i < nStatus && l_cpuLoadStatus[i].xHandle != pTask->task ) {
+         i++;
+      }
+
+      if ( i == nStatus ) {
+         /* Deleted and cleaned up, the handle may get reused */
+         pTask->task = NULL;
+      } else {
+         uint32_t total = l_cpuLoadStatus[i].ulRunTimeCounter;
+         if ( 0 != elapsed ) {
+            load = (uint32_t)( (uint64_t)(uint32_t)( total - pTask->prev ) *
+                  CPU_LOAD_FULL / elapsed );
+            if ( load > CPU_LOAD_FULL ) {
+               load = CPU_LOAD_FULL;        /* Slice of the caller shifted in */
+            }
+         }
+         pTask->prev = total;
+      }
+   }
+
+   if ( 0 == elapsed ) {
+      return;
+   }
+
+   pTask->hist[l_cpuLoadHead] = (uint16_t)load;
+   pTask->last = (uint16_t)load;
+   if ( load > pTask->peak ) {
+      pTask->peak = (uint16_t)load;
+   }
+
+   uint32_t sum = 0;
+   for ( uint8_t w = 0; w < nWindows; w++ ) {
+      sum += pTask->hist[w];
+   }
+   pTask->avg = (uint16_t)( sum / nWindows );
+}
+
+/******************************************************************************/
+void CPU_LOAD_init( uint8_t nTasks )
+{
+   memset( l_cpuLoadTasks, 0, sizeof(l_cpuLoadTasks) );
+   memset( &l_cpuLoadIdle, 0, sizeof(l_cpuLoadIdle) );
+   l_cpuLoadIdle.name = "IDLE";
+   l_cpuLoadNTasks    = nTasks < CPU_LOAD_MAX_TASKS ? nTasks : CPU_LOAD_MAX_TASKS;
+   l_cpuLoadHead      = 0;
+   l_cpuLoadNWindows  = 0;
+   l_cpuLoadStarted   = false;
+   l_cpuLoadBusyPeak  = 0;
+}
+
+/******************************************************************************/
+void CPU_LOAD_attach( uint8_t idx, TaskHandle_t task, const char *name )
+{
+   if ( idx < l_cpuLoadNTasks ) {
+      /* A task's run time total starts at 0 when it's created */
+      l_cpuLoadTasks[idx].prev = 0;
+      l_cpuLoadTasks[idx].name = name;
+      l_cpuLoadTasks[idx].task = task;
+   }
+}
+
+/******************************************************************************/
+void CPU_LOAD_poll( void )
+{
+   TickType_t now = xTaskGetTickCount();
+   TickType_t ticks = (TickType_t)( now - l_cpuLoadWindowStart );
+
+   if ( l_cpuLoadStarted && ticks < CPU_LOAD_WINDOW_MS / portTICK_PERIOD_MS ) {
+      return;
+   }
+
+   uint32_t total = 0;
+   UBaseType_t nStatus =
+         uxTaskGetSystemState( l_cpuLoadStatus, CPU_LOAD_MAX_STATUS, &total );
+   if ( 0 == nStatus ) {
+      return;                         /* More tasks than CPU_LOAD_MAX_STATUS */
+   }
+
+   /* The first call only starts a window, and so does one that comes after
+    * the counter may have wrapped */
+   uint32_t elapsed = total - l_cpuLoadPrevTotal;
+   if ( !l_cpuLoadStarted || ticks > CPU_LOAD_MAX_WINDOW_MS / portTICK_PERIOD_MS ) {
+      elapsed = 0;
+   }
+   l_cpuLoadStarted     = true;
+   l_cpuLoadWindowStart = now;
+   l_cpuLoadPrevTotal   = total;
+
+   if ( NULL == l_cpuLoadIdle.task ) {
+      l_cpuLoadIdle.task = xTaskGetIdleTaskHandle();
+   }
+
+   uint8_t nWindows = l_cpuLoadNWindows < CPU_LOAD_N_WINDOWS ?
+         l_cpuLoadNWindows + 1 : CPU_LOAD_N_WINDOWS;
+
+   for ( uint8_t i = 0; i < l_cpuLoadNTasks; i++ ) {
+      CPU_LOAD_closeWindow( &l_cpuLoadTasks[i], nStatus, elapsed, nWindows );
+   }
+   CPU_LOAD_closeWindow( &l_cpuLoadIdle, nStatus, elapsed, nWindows );
+
+   if ( 0 != elapsed ) {
+      if ( CPU_LOAD_FULL - l_cpuLoadIdle.last > l_cpuLoadBusyPeak ) {
+         l_cpuLoadBusyPeak = CPU_LOAD_FULL - l_cpuLoadIdle.last;
+      }
+      l_cpuLoadHead = ( l_cpuLoadHead + 1 ) % CPU_LOAD_N_WINDOWS;
+      l_cpuLoadNWindows = nWindows;
+   }
+}
+
+/******************************************************************************/
+uint8_t CPU_LOAD_getNTasks( void )
+{
+   return( l_cpuLoadNTasks );
+}
+
+/******************************************************************************/
+bool CPU_LOAD_getInfo( uint8_t idx, CpuLoadInfo_t *pInfo )
+{
+   if ( idx >= l_cpuLoadNTasks ) {
+      return( false );
+   }
+
+   pInfo->name     = l_cpuLoadTasks[idx].name;
+   pInfo->last     = l_cpuLoadTasks[idx].last;
+   pInfo->avg      = l_cpuLoadTasks[idx].avg;
+   pInfo->peak     = l_cpuLoadTasks[idx].peak;
+   pInfo->bRunning = ( NULL != l_cpuLoadTasks[idx].task );
+   return( true );
+}
+
+/******************************************************************************/
+uint8_t CPU_LOAD_getBusy( CpuLoadInfo_t *pInfo )
+{
+   uint8_t nWindows = l_cpuLoadNWindows;
+
+   pInfo->name     = NULL;
+   pInfo->last     = 0 != nWindows ? CPU_LOAD_FULL - l_cpuLoadIdle.last : 0;
+   pInfo->avg      = 0 != nWindows ? CPU_LOAD_FULL - l_cpuLoadIdle.avg : 0;
+   pInfo->peak     = l_cpuLoadBusyPeak;
+   pInfo->bRunning = true;
+   return( nWindows );
+}
+
+/******************************************************************************/
+uint32_t CPU_LOAD_getLast( uint32_t idx )
+{
+   return( idx < l_cpuLoadNTasks ? l_cpuLoadTasks[idx].last : 0 );
+}
+
+/******************************************************************************/
+uint32_t CPU_LOAD_getBusyLast( uint32_t arg )
+{
+   (void) arg;
+   return( 0 != l_cpuLoadNWindows ? CPU_LOAD_FULL - l_cpuLoadIdle.last : 0 );
+}
+
+#ifndef CPU_LOAD_HOST_CLOCK
+/******************************************************************************/
+void CPU_LOAD_initTimer( void )
+{
+   RCC_ClocksTypeDef clocks;
+   TIM_TimeBaseInitTypeDef timInit;
+
+   /* APB1 timers run at twice PCLK1 whenever APB1 is divided down */
+   RCC_GetClocksFreq( &clocks );
+   uint32_t timClk = clocks.PCLK1_Frequency;
+   if ( clocks.HCLK_Frequency != clocks.PCLK1_Frequency ) {
+      timClk *= 2;
+   }
+
+   RCC_APB1PeriphClockCmd( RCC_APB1Periph_TIM2, ENABLE );
+   RCC_APB1PeriphClockLPModeCmd( RCC_APB1Periph_TIM2, ENABLE );
+
+   TIM_TimeBaseStructInit( &timInit );
+   timInit.TIM_Prescaler     = (uint16_t)( timClk / 1000000U - 1 );
+   timInit.TIM_Period        = 0xFFFFFFFF;
+   timInit.TIM_CounterMode   = TIM_CounterMode_Up;
+   timInit.TIM_ClockDivision = TIM_CKD_DIV1;
+   TIM_TimeBaseInit( TIM2, &timInit );
+   TIM_Cmd( TIM2, ENABLE );
+}
+#else
+/******************************************************************************/
+uint32_t CPU_LOAD_hostClock( void )
+{
+   struct timespec ts;
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return( (uint32_t)( (uint64_t)ts.tv_sec * 1000000U + ts.tv_nsec / 1000 ) );
+}
+#endif                                                 /* CPU_LOAD_HOST_CLOCK */
+
+/**
+ * @}
+ * end addtogroup groupCpuLoad
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,191 @@
+/**
+ * @file   cpu_load.h
+ * @brief  Declarations for the per task CPU load accounting.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupCpuLoad
+ * @{
+ *
+ * FreeRTOS adds the run time counter ticks (TIM2 microseconds, see
+ * FreeRTOSConfig.h) each task spends running to that task's total on every
+ * context switch.  TIM2 keeps counting while the core sleeps, so the idle
+ * task gets the time spent in WFI too.
+ * CPU_LOAD_poll() reads all the totals once every CPU_LOAD_WINDOW_MS and works
+ * out what share of that window each task got, in tenths of a percent.  The
+ * last CPU_LOAD_N_WINDOWS windows are kept, so the load is known both for the
+ * last window and averaged over all of them, along with the highest window
+ * since boot.  The share of the idle task is kept the same way whether it is
+ * attached or not; 1000 minus that is how busy the CPU is.
+ *
+ * Every AO runs in a task of its own so the load of a task is the load of its
+ * AO.  Interrupts are charged to whatever task they interrupted.
+ *
+ * Tasks are attached by their index in the application's task table, the
+ * same way as for the stack monitor.  CPU_LOAD_poll() is called by a single
+ * task that runs often and above most of the AOs (the CPLR task) so it keeps
+ * up even when the CPU is close to saturation.  The results are stored as
+ * single 16 bit values so the debug menu and telemetry can read them from any
+ * task.  A window that ends up longer than CPU_LOAD_MAX_WINDOW_MS, because the
+ * polling task was starved for that long, is thrown away rather than folded
+ * into the average.
+ *
+ * On a host, defining CPU_LOAD_HOST_CLOCK makes FreeRTOS count microseconds of
+ * the monotonic clock with CPU_LOAD_hostClock() instead.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CPU_LOAD_H_
+#define CPU_LOAD_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"                                   /* For FreeRTOS types */
+#include "task.h"                                       /* For TaskHandle_t */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< Most tasks the accounting keeps track of */
+#define CPU_LOAD_MAX_TASKS                                                  16
+
+/**< Length of one window */
+#define CPU_LOAD_WINDOW_MS                                                1000
+
+/**< Number of windows kept and averaged over */
+#define CPU_LOAD_N_WINDOWS                                                  10
+
+/**< Longest a window may get before it is thrown away.  Has to stay below
+ * the time it takes the run time counter to wrap (about 71 min). */
+#define CPU_LOAD_MAX_WINDOW_MS                                           10000
+
+/**< Full load of the CPU or of a task */
+#define CPU_LOAD_FULL                                                     1000
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct CpuLoadInfo_t
+ * Load of one task, in tenths of a percent.
+ */
+typedef struct CpuLoadInfos
+{
+   const char *name;                                  /**< Name of the task */
+   uint16_t    last;                       /**< Load over the last window */
+   uint16_t    avg;          /**< Average over the windows that are kept */
+   uint16_t    peak;                 /**< Highest single window since boot */
+   bool        bRunning;      /**< Attached and still in the task list */
+} CpuLoadInfo_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Start the accounting for the tasks of a task table.
+ *
+ * Call once, before any of the tasks are created.
+ *
+ * @param [in] nTasks: uint8_t number of entries in the task table.  Entries
+ * past CPU_LOAD_MAX_TASKS are not accounted for on their own.
+ * @return: None
+ */
+void CPU_LOAD_init( uint8_t nTasks );
+
+/**
+ * @brief   Attach a task that was just created to its entry.
+ * @param [in] idx: uint8_t index of the task in the task table.
+ * @param [in] task: TaskHandle_t of the task.
+ * @param [in] *name: const char name of the task.  Has to stay around.
+ * @return: None
+ */
+void CPU_LOAD_attach( uint8_t idx, TaskHandle_t task, const char *name );
+
+/**
+ * @brief   Close the current window if it's time to.
+ *
+ * Returns right away until CPU_LOAD_WINDOW_MS have gone by.  Must always be
+ * called from the same task.
+ *
+ * @param   None
+ * @return: None
+ */
+void CPU_LOAD_poll( void );
+
+/**
+ * @brief   Get the number of task table entries.
+ * @param   None
+ * @return: uint8_t number of entries.
+ */
+uint8_t CPU_LOAD_getNTasks( void );
+
+/**
+ * @brief   Get the load of a task.
+ * @param [in] idx: uint8_t index of the task in the table.
+ * @param [out] *pInfo: CpuLoadInfo_t pointer to fill in.
+ * @return: bool false if idx is out of range.
+ */
+bool CPU_LOAD_getInfo( uint8_t idx, CpuLoadInfo_t *pInfo );
+
+/**
+ * @brief   Get how busy the CPU was, which is everything but the idle task.
+ * @param [out] *pInfo: CpuLoadInfo_t pointer to fill in.  The name is NULL.
+ * @return: uint8_t number of windows kept so far, 0 if no window has closed
+ * yet and the loads mean nothing.
+ */
+uint8_t CPU_LOAD_getBusy( CpuLoadInfo_t *pInfo );
+
+/**
+ * @brief   Get the load of a task over the last window.  A TLM_Sampler.
+ * @param [in] idx: uint32_t index of the task in the table.
+ * @return: uint32_t tenths of a percent, 0 if idx is out of range.
+ */
+uint32_t CPU_LOAD_getLast( uint32_t idx );
+
+/**
+ * @brief   Get how busy the CPU was over the last window.  A TLM_Sampler.
+ * @param [in] arg: uint32_t unused.
+ * @return: uint32_t tenths of a percent.
+ */
+uint32_t CPU_LOAD_getBusyLast( uint32_t arg );
+
+#ifndef CPU_LOAD_HOST_CLOCK
+/**
+ * @brief   Start TIM2 counting up at 1MHz over its full 32 bits, as the run
+ * time counter.
+ *
+ * FreeRTOS calls this through portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() when
+ * the scheduler starts.  TIM2 is kept clocked in sleep mode so it counts
+ * through WFI.
+ *
+ * @param   None
+ * @return: None
+ */
+void CPU_LOAD_initTimer( void );
+#else
+/**
+ * @brief   Run time counter of a host build: the monotonic clock in us.
+ * @param   None
+ * @return: uint32_t microseconds, wrapping.
+ */
+uint32_t CPU_LOAD_hostClock( void );
+#endif                                                 /* CPU_LOAD_HOST_CLOCK */
+
+/**
+ * @}
+ * end addtogroup groupCpuLoad
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                         /* CPU_LOAD_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
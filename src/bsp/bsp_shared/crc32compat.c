@@ -24,19 +24,6 @@
 /* Private variables and Local objects ---------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 
-/******************************************************************************/
-/**
- * @brief This function bit reverses and is written in ARM assembly.
- *
- * @param  data:  a 32 bit word of data to be reversed
- * @return uint32_t: reversed 32 bit word of data.
- */
-static uint32_t revbit(uint32_t data)
-{
-   asm("rbit r0,r0");
-   return (data);
-};
-
 /* Private functions ---------------------------------------------------------*/
 
 /******************************************************************************/
@@ -58,8 +45,9 @@ uint32_t CRC32_Calc(char *buffer, int size)
 
       buffer += 4;
 
-      /* reverse the bit order of input data */
-      ui32=revbit(ui32);
+      /* reverse the bit order of input data.  __RBIT() is the CMSIS intrinsic so
+       * the compiler knows which registers it works on even when inlined. */
+      ui32=__RBIT(ui32);
 
       CRC->DR=ui32;
    }
@@ -67,7 +55,7 @@ uint32_t CRC32_Calc(char *buffer, int size)
    ui32=CRC->DR;
 
    /* reverse the bit order of output data */
-   ui32=revbit(ui32);
+   ui32=__RBIT(ui32);
 
    i = size & 3;
 
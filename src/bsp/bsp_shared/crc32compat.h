@@ -45,6 +45,9 @@
  * hardware choices and decided to use a right shift instead of left shift.
  * This requires that you first bit reverse the data, calculate the CRC, and
  * then reverse the data back.
+ * @note 2: Resets the CRC unit so it can't be interleaved with other users of
+ * it.  The CRC clock has to be on (BSP_init() turns it on).
+ * @note 3: Reads the buffer a word at a time so it has to be word aligned.
  *
  * @param  buffer:	Pointer to the buffer containing data.
  * @param  size:	Size of the buffer.
@@ -52,14 +55,6 @@
  */
 uint32_t CRC32_Calc( char *buffer, int size );
 
-/**
- * @brief This function bit reverses and is written in ARM assembly.
- *
- * @param  data:	a 32 bit word of data to be reversed
- * @return uint32_t: reversed 32 bit word of data.
- */
-//uint32_t revbit( uint32_t data );
-
 /**
  * @}
  * end addtogroup groupSharedBSP
@@ -0,0 +1,401 @@
+/**
+ * @file   evt_rec.c
+ * @brief  Definitions for the recorder of every event the AOs post and
+ * dispatch.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEvtRec
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#define QP_IMPL                           /* For the event pools, only read */
+#include "evt_rec.h"
+#include "qf_pkg.h"
+#include <string.h>
+
+/* The recorder runs on the target, and on a host (EVT_REC_HOST) that runs
+ * its AOs on one thread of the POSIX port to record them for a replay. */
+#ifdef QF_EVT_REC
+#define EVT_REC_RECORDER
+#endif
+
+#if defined(EVT_REC_RECORDER) && !defined(EVT_REC_HOST)
+#include "stm32f4xx.h"                                    /* For __get_IPSR() */
+#include "task.h"                                /* For the current thread */
+#endif                                                        /* EVT_REC_HOST */
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#define EVT_REC_FNV_BASIS                                          2166136261U
+#define EVT_REC_FNV_PRIME                                            16777619U
+
+/**< Returned by EVT_REC_reserve() when there's no room */
+#define EVT_REC_NO_ROOM                                            0xFFFFFFFFU
+
+/* Private macros ------------------------------------------------------------*/
+/**< The ring is big and doesn't need initializing, and SDRAM is already set up
+ * by SystemInit() before main() is called. */
+#ifdef EVT_REC_HOST
+#define EVT_REC_SDRAM
+#else
+#define EVT_REC_SDRAM                      __attribute__((section(".sdram")))
+#endif                                                        /* EVT_REC_HOST */
+
+/* Private variables and Local objects ---------------------------------------*/
+#ifdef EVT_REC_RECORDER
+
+/**< Not static so the debugger can find it to save it */
+EvtRecRing_t EVT_REC_ring EVT_REC_SDRAM;
+
+/* The slot count of a wrapping ring has to stay continuous when head wraps */
+typedef char EVT_REC_N_SLOTS_is_a_power_of_2[
+      ( 0 == ( EVT_REC_N_SLOTS & ( EVT_REC_N_SLOTS - 1 ) ) ) ? 1 : -1 ];
+
+static volatile bool l_evtRecOn;
+static bool          l_evtRecFull;    /**< Stopped since the ring filled up */
+static uint8_t       l_evtRecInitPrio;  /**< AO in its initial transition */
+#ifdef EVT_REC_HOST
+static uint8_t       l_evtRecStepPrio;          /**< AO in its RTC step */
+#endif                                                        /* EVT_REC_HOST */
+
+#endif                                                    /* EVT_REC_RECORDER */
+
+/* Private function prototypes -----------------------------------------------*/
+#ifdef EVT_REC_RECORDER
+
+/**
+ * @brief   Take slots for one record and its payload.
+ *
+ * The slots are marked EVT_REC_NONE until the caller writes the kind of the
+ * record last.
+ *
+ * @param [in] n: uint32_t slots to take.
+ * @return: uint32_t slot count of the first one, EVT_REC_NO_ROOM if not
+ * recording or the ring is full.
+ */
+static uint32_t EVT_REC_reserve( uint32_t n );
+
+/**
+ * @brief   Work out who is posting.
+ *
+ * Called from within the critical section of the post.
+ *
+ * @param   None
+ * @return: uint8_t priority of the AO, or EVT_REC_SENDER_ISR or
+ * EVT_REC_SENDER_TASK.
+ */
+static uint8_t EVT_REC_sender( void );
+
+#endif                                                    /* EVT_REC_RECORDER */
+
+/* Private functions ---------------------------------------------------------*/
+#ifdef EVT_REC_RECORDER
+
+/******************************************************************************/
+static uint32_t EVT_REC_reserve( uint32_t n )
+{
+   EvtRecHdr_t *hdr = &EVT_REC_ring.hdr;
+   uint32_t first = EVT_REC_NO_ROOM;
+   QF_CRIT_STAT_
+
+   QF_CRIT_ENTRY_();
+   if ( l_evtRecOn ) {
+      if ( EVT_REC_MODE_ONCE == hdr->mode && hdr->head + n > hdr->nSlots ) {
+         /* Keep what's there whole for a replay */
+         l_evtRecOn   = false;
+         l_evtRecFull = true;
+      } else {
+         first = hdr->head;
+         hdr->head += n;
+         for ( uint32_t i = 0; i < n; i++ ) {
+            EVT_REC_ring.slots[( first + i ) % EVT_REC_N_SLOTS].kind = EVT_REC_NONE;
+         }
+      }
+   }
+   if ( EVT_REC_NO_ROOM == first && l_evtRecFull ) {
+      hdr->nLost++;
+   }
+   QF_CRIT_EXIT_();
+
+   return( first );
+}
+
+/******************************************************************************/
+static uint8_t EVT_REC_sender( void )
+{
+#ifdef EVT_REC_HOST
+   /* One thread runs all the AOs, so the one in its initial transition or RTC
+    * step is the only one that can be posting */
+   if ( 0U != l_evtRecInitPrio ) {
+      return( l_evtRecInitPrio );
+   }
+   return( 0U != l_evtRecStepPrio ? l_evtRecStepPrio : EVT_REC_SENDER_TASK );
+#else
+   if ( 0U != __get_IPSR() ) {
+      return( EVT_REC_SENDER_ISR );
+   }
+
+   /* Before the scheduler runs, the current task is just the last one made */
+   if ( 0U != l_evtRecInitPrio ) {
+      return( l_evtRecInitPrio );
+   }
+   if ( taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState() ) {
+      return( EVT_REC_SENDER_TASK );
+   }
+
+   TaskHandle_t task = xTaskGetCurrentTaskHandle();
+   for ( uint8_t p = 1; p <= QF_MAX_ACTIVE; p++ ) {
+      if ( (QActive *)0 != QF_active_[p] && task == QF_active_[p]->thread ) {
+         return( p );
+      }
+   }
+   return( EVT_REC_SENDER_TASK );
+#endif                                                        /* EVT_REC_HOST */
+}
+
+/******************************************************************************/
+void QF_onEvtPosted(
+      QActive const * const me,
+      QEvt const * const e,
+      uint_fast8_t const how
+)
+{
+   static const uint8_t kinds[] = {
+      [QF_POSTED_FIFO_]    = EVT_REC_POST,
+      [QF_POSTED_LIFO_]    = EVT_REC_POST_LIFO,
+      [QF_POSTED_DROPPED_] = EVT_REC_DROP,
+   };
+
+   uint32_t n = EVT_REC_reserve( 1 );
+   if ( EVT_REC_NO_ROOM == n ) {
+      return;
+   }
+
+   EvtRec_t *r = &EVT_REC_ring.slots[n % EVT_REC_N_SLOTS].rec;
+   r->target = me->prio;
+   r->sender = EVT_REC_sender();
+   r->poolId = e->poolId_;
+   r->sig    = e->sig;
+   r->len    = 0;
+   r->time   = QF_RTC_CYCLES();
+   r->evt    = (uint32_t)(uintptr_t)e;
+   r->aux    = 0;
+   r->kind   = kinds[how];
+}
+
+/******************************************************************************/
+void QF_onEvtDispatch( QActive const * const me, QEvt const * const e )
+{
+   if ( (QEvt const *)0 == e ) {
+      /* Posts from the initial transition are from the AO itself */
+      l_evtRecInitPrio = me->prio;
+
+      uint32_t n = EVT_REC_reserve( 1 );
+      if ( EVT_REC_NO_ROOM != n ) {
+         EvtRec_t *r = &EVT_REC_ring.slots[n % EVT_REC_N_SLOTS].rec;
+         memset( r, 0, sizeof(*r) );
+         r->target = me->prio;
+         r->time   = QF_RTC_CYCLES();
+         r->kind   = EVT_REC_INIT;
+      }
+      return;
+   }
+
+#ifdef EVT_REC_HOST
+   l_evtRecStepPrio = me->prio;
+#endif                                                        /* EVT_REC_HOST */
+   if ( !l_evtRecOn ) {
+      return;
+   }
+
+   uint16_t len = EVT_REC_payloadLen( e );
+   uint32_t nData = ( len + EVT_REC_DATA_BYTES - 1 ) / EVT_REC_DATA_BYTES;
+   uint32_t n = EVT_REC_reserve( 1 + nData );
+   if ( EVT_REC_NO_ROOM == n ) {
+      return;
+   }
+
+   /* The payload goes in first so a record is never seen without it */
+   uint8_t const *payload = (uint8_t const *)e + sizeof(QEvt);
+   for ( uint32_t i = 0; i < nData; i++ ) {
+      EvtRecData_t *d = &EVT_REC_ring.slots[( n + 1 + i ) % EVT_REC_N_SLOTS].data;
+      uint32_t off = i * EVT_REC_DATA_BYTES;
+      uint32_t bytes = len - off < EVT_REC_DATA_BYTES ? len - off : EVT_REC_DATA_BYTES;
+      memcpy( d->data, &payload[off], bytes );
+      d->kind = EVT_REC_DATA;
+   }
+
+   EvtRec_t *r = &EVT_REC_ring.slots[n % EVT_REC_N_SLOTS].rec;
+   r->target = me->prio;
+   r->sender = 0;
+   r->poolId = e->poolId_;
+   r->sig    = e->sig;
+   r->len    = len;
+   r->time   = QF_RTC_CYCLES();
+   r->evt    = (uint32_t)(uintptr_t)e;
+   r->aux    = EVT_REC_digest( e, len );
+   r->kind   = EVT_REC_DISPATCH;
+}
+
+/******************************************************************************/
+void QF_onEvtDone(
+      QActive const * const me,
+      QEvt const * const e,
+      uint32_t const cycles
+)
+{
+   if ( (QEvt const *)0 == e ) {
+      l_evtRecInitPrio = 0;
+      return;
+   }
+#ifdef EVT_REC_HOST
+   l_evtRecStepPrio = 0;
+#endif                                                        /* EVT_REC_HOST */
+
+   uint32_t n = EVT_REC_reserve( 1 );
+   if ( EVT_REC_NO_ROOM == n ) {
+      return;
+   }
+
+   EvtRec_t *r = &EVT_REC_ring.slots[n % EVT_REC_N_SLOTS].rec;
+   r->target = me->prio;
+   r->sender = 0;
+   r->poolId = e->poolId_;
+   r->sig    = e->sig;
+   r->len    = 0;
+   r->time   = QF_RTC_CYCLES();
+   r->evt    = (uint32_t)(uintptr_t)e;
+   r->aux    = cycles;
+   r->kind   = EVT_REC_DONE;
+}
+
+#endif                                                    /* EVT_REC_RECORDER */
+
+/******************************************************************************/
+bool EVT_REC_start( EvtRecMode_t mode, uint32_t clockHz )
+{
+#ifdef EVT_REC_RECORDER
+   EvtRecHdr_t *hdr = &EVT_REC_ring.hdr;
+   QF_CRIT_STAT_
+
+   QF_CRIT_ENTRY_();
+   hdr->magic    = EVT_REC_MAGIC;
+   hdr->version  = EVT_REC_VERSION;
+   hdr->slotSize = sizeof(EvtRecSlot_t);
+   hdr->mode     = (uint8_t)mode;
+   hdr->nSlots   = EVT_REC_N_SLOTS;
+   hdr->head     = 0;
+   hdr->nLost    = 0;
+   hdr->clockHz  = clockHz;
+   l_evtRecFull  = false;
+   l_evtRecOn    = true;
+   QF_CRIT_EXIT_();
+   return( true );
+#else
+   (void) mode;
+   (void) clockHz;
+   return( false );
+#endif                                                    /* EVT_REC_RECORDER */
+}
+
+/******************************************************************************/
+void EVT_REC_stop( void )
+{
+#ifdef EVT_REC_RECORDER
+   l_evtRecOn = false;
+#endif                                                    /* EVT_REC_RECORDER */
+}
+
+/******************************************************************************/
+const EvtRecHdr_t* EVT_REC_getRing( void )
+{
+#ifdef EVT_REC_RECORDER
+   return( EVT_REC_MAGIC == EVT_REC_ring.hdr.magic ? &EVT_REC_ring.hdr : NULL );
+#else
+   return( NULL );
+#endif                                                    /* EVT_REC_RECORDER */
+}
+
+/******************************************************************************/
+bool EVT_REC_isRecording( void )
+{
+#ifdef EVT_REC_RECORDER
+   return( l_evtRecOn );
+#else
+   return( false );
+#endif                                                    /* EVT_REC_RECORDER */
+}
+
+/******************************************************************************/
+uint16_t EVT_REC_payloadLen( QEvt const *e )
+{
+   if ( 0U == e->poolId_ ) {
+      return( 0 );
+   }
+
+   uint8_t const *p = (uint8_t const *)e;
+   uint_fast16_t n = QF_EPOOL_EVENT_SIZE_( QF_pool_[e->poolId_ - 1U] );
+   while ( n > sizeof(QEvt) && 0U == p[n - 1] ) {
+      n--;
+   }
+   return( (uint16_t)( n - sizeof(QEvt) ) );
+}
+
+/******************************************************************************/
+uint32_t EVT_REC_digest( QEvt const *e, uint16_t len )
+{
+   uint32_t h = EVT_REC_FNV_BASIS;
+   uint8_t const hdr[3] = {
+         (uint8_t)e->sig, (uint8_t)( e->sig >> 8 ), e->poolId_
+   };
+
+   for ( uint8_t i = 0; i < sizeof(hdr); i++ ) {
+      h = ( h ^ hdr[i] ) * EVT_REC_FNV_PRIME;
+   }
+
+   uint8_t const *p = (uint8_t const *)e + sizeof(QEvt);
+   for ( uint16_t i = 0; i < len; i++ ) {
+      h = ( h ^ p[i] ) * EVT_REC_FNV_PRIME;
+   }
+   return( h );
+}
+
+/******************************************************************************/
+uint32_t EVT_REC_span( const EvtRecHdr_t *hdr, uint32_t *pFirst )
+{
+   uint32_t first = 0;
+   uint32_t n = hdr->head;
+
+   if ( n > hdr->nSlots ) {
+      first = n - hdr->nSlots;
+      n = hdr->nSlots;
+   }
+
+   /* The oldest slots of a wrapped ring may be the end of a payload */
+   while ( 0 != n && EVT_REC_DATA == EVT_REC_slot( hdr, first )->kind ) {
+      first++;
+      n--;
+   }
+
+   *pFirst = first;
+   return( n );
+}
+
+/******************************************************************************/
+const EvtRecSlot_t* EVT_REC_slot( const EvtRecHdr_t *hdr, uint32_t n )
+{
+   return( (const EvtRecSlot_t *)( hdr + 1 ) + n % hdr->nSlots );
+}
+
+/**
+ * @}
+ * end addtogroup groupEvtRec
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
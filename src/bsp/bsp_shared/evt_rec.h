@@ -0,0 +1,261 @@
+/**
+ * @file   evt_rec.h
+ * @brief  Declarations for the recorder of every event the AOs post and
+ * dispatch.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEvtRec
+ * @{
+ *
+ * Built with QF_EVT_REC (make EVT_REC=1), the QP port hands this module every
+ * post to an AO, every RTC step and every initial transition (see NOTE6 in
+ * qf_port.h).  Each one goes into a ring of fixed size slots in SDRAM:
+ *
+ * - EVT_REC_POST: signal, sender, target, pool and address of the event.
+ *   The sender is the priority of the AO whose thread (or initial transition)
+ *   posted it, EVT_REC_SENDER_ISR for an interrupt, including the tick, or
+ *   EVT_REC_SENDER_TASK for any other thread.
+ * - EVT_REC_DISPATCH: the start of an RTC step, with a digest of the event
+ *   and its payload in the EVT_REC_DATA slots that follow.
+ * - EVT_REC_DONE: the end of the step and the cycles it took.
+ * - EVT_REC_INIT: an initial transition.
+ *
+ * Every slot carries a DWT cycle count timestamp.  The payload is the part of
+ * the pool block past the QEvt, up to its last non-zero byte, which is all of
+ * it since the port zeroes pool events when they are allocated.  Static
+ * events (time events among them) have none.
+ *
+ * EVT_REC_MODE_ONCE records from boot until the ring is full and then stops,
+ * which is what evt_replay.h needs to feed the recording back into the same
+ * AOs on a host.  EVT_REC_MODE_WRAP keeps overwriting the oldest slots, for a
+ * look at the last few seconds before something got stuck.  The ring is a
+ * header followed by the slots, all in EVT_REC_ring, so it can be saved with
+ * the debugger, e.g. in gdb:
+ *
+ *    dump binary memory rec.bin &EVT_REC_ring ((char *)&EVT_REC_ring) + sizeof(EVT_REC_ring)
+ *
+ * The digest and payload helpers are built without QF_EVT_REC too, so the
+ * replayer can use them.
+ *
+ * A host program built with EVT_REC_HOST and the POSIX port can record too.
+ * It runs its AOs on one thread and brackets every RTC step and initial
+ * transition with QF_onEvtDispatch() and QF_onEvtDone() the way the FreeRTOS
+ * port does, and a post made outside of them counts as EVT_REC_SENDER_TASK.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef EVT_REC_H_
+#define EVT_REC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "qp_port.h"                                        /* for QP support */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< Slots in the ring, 1.25 MB of SDRAM */
+#ifndef EVT_REC_N_SLOTS
+#define EVT_REC_N_SLOTS                                                  65536
+#endif
+
+/**< Payload bytes in one EVT_REC_DATA slot */
+#define EVT_REC_DATA_BYTES                                                  19
+
+/**< Marks a ring that has been started, "EVRC" */
+#define EVT_REC_MAGIC                                               0x43525645
+
+/**< Version of the ring layout */
+#define EVT_REC_VERSION                                                      1
+
+/**< Sender of a post that came from an interrupt */
+#define EVT_REC_SENDER_ISR                                                0xFF
+
+/**< Sender of a post that came from a thread that isn't an AO */
+#define EVT_REC_SENDER_TASK                                               0xFE
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \enum EvtRecKind_t
+ * What a slot holds.
+ */
+typedef enum EvtRecKinds {
+   EVT_REC_NONE = 0,           /**< Not written yet, or being written */
+   EVT_REC_POST,               /**< Posted to the back of a queue */
+   EVT_REC_POST_LIFO,          /**< Posted to the front of a queue */
+   EVT_REC_DROP,               /**< Not posted since the queue was full */
+   EVT_REC_DISPATCH,           /**< RTC step started */
+   EVT_REC_DONE,               /**< RTC step finished */
+   EVT_REC_INIT,               /**< Initial transition */
+   EVT_REC_DATA                /**< Payload of the EVT_REC_DISPATCH before */
+} EvtRecKind_t;
+
+/**
+ * \enum EvtRecMode_t
+ * What to do once the ring is full.
+ */
+typedef enum EvtRecModes {
+   EVT_REC_MODE_ONCE = 0,      /**< Stop, keeping the start for a replay */
+   EVT_REC_MODE_WRAP           /**< Overwrite the oldest slots */
+} EvtRecMode_t;
+
+/**
+ * \struct EvtRec_t
+ * One record.  The fields that don't apply to a kind are 0.
+ */
+typedef struct EvtRecs
+{
+   uint8_t  kind;                                      /**< EvtRecKind_t */
+   uint8_t  target;          /**< Priority of the AO posted to or running */
+   uint8_t  sender;   /**< Priority of the AO that posted, or EVT_REC_SENDER_* */
+   uint8_t  poolId;                         /**< Pool of the event, 0 static */
+   uint16_t sig;                                   /**< Signal of the event */
+   uint16_t len;               /**< DISPATCH: payload bytes in the DATA slots */
+   uint32_t time;                            /**< DWT cycle count (wraps) */
+   uint32_t evt;       /**< Address of the event, ties posts to dispatches */
+   uint32_t aux;           /**< DISPATCH: digest, DONE: cycles of the step */
+} EvtRec_t;
+
+/**
+ * \struct EvtRecData_t
+ * Payload bytes of the last EVT_REC_DISPATCH.
+ */
+typedef struct EvtRecDatas
+{
+   uint8_t  kind;                                        /**< EVT_REC_DATA */
+   uint8_t  data[EVT_REC_DATA_BYTES];
+} EvtRecData_t;
+
+/**
+ * \union EvtRecSlot_t
+ * One slot of the ring.
+ */
+typedef union EvtRecSlots
+{
+   uint8_t      kind;                                  /**< EvtRecKind_t */
+   EvtRec_t     rec;
+   EvtRecData_t data;
+} EvtRecSlot_t;
+
+/**
+ * \struct EvtRecHdr_t
+ * Start of the ring, followed by nSlots slots.
+ */
+typedef struct EvtRecHdrs
+{
+   uint32_t magic;                                       /**< EVT_REC_MAGIC */
+   uint16_t version;                                   /**< EVT_REC_VERSION */
+   uint8_t  slotSize;                          /**< sizeof(EvtRecSlot_t) */
+   uint8_t  mode;                                      /**< EvtRecMode_t */
+   uint32_t nSlots;                              /**< Slots after the header */
+   uint32_t head;          /**< Slots ever taken, the next is head % nSlots */
+   uint32_t nLost;                    /**< Records that didn't make it in */
+   uint32_t clockHz;                        /**< Timestamp counts per second */
+} EvtRecHdr_t;
+
+/**
+ * \struct EvtRecRing_t
+ * The whole ring.
+ */
+typedef struct EvtRecRings
+{
+   EvtRecHdr_t  hdr;
+   EvtRecSlot_t slots[EVT_REC_N_SLOTS];
+} EvtRecRing_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Start recording, throwing away what was recorded so far.
+ *
+ * Call before the AOs are started to record their initial transitions, which
+ * a replay needs.
+ *
+ * @param [in] mode: EvtRecMode_t what to do once the ring is full.
+ * @param [in] clockHz: uint32_t DWT cycles per second, for the host.
+ * @return: bool false if the recorder isn't built in.
+ */
+bool EVT_REC_start( EvtRecMode_t mode, uint32_t clockHz );
+
+/**
+ * @brief   Stop recording.  What was recorded stays in the ring.
+ * @param   None
+ * @return: None
+ */
+void EVT_REC_stop( void );
+
+/**
+ * @brief   Get the ring.
+ * @param   None
+ * @return: const EvtRecHdr_t pointer to the header, followed by the slots,
+ * or NULL if the recorder isn't built in.
+ */
+const EvtRecHdr_t* EVT_REC_getRing( void );
+
+/**
+ * @brief   Check whether the recorder is taking records right now.
+ * @param   None
+ * @return: bool true if it is.
+ */
+bool EVT_REC_isRecording( void );
+
+/**
+ * @brief   Get the payload length of an event.
+ *
+ * The part of the pool block past the QEvt, up to its last non-zero byte.
+ *
+ * @param [in] *e: QEvt pointer to the event.
+ * @return: uint16_t bytes, 0 for a static event.
+ */
+uint16_t EVT_REC_payloadLen( QEvt const *e );
+
+/**
+ * @brief   Get the digest of an event: signal, pool and payload.
+ * @param [in] *e: QEvt pointer to the event.
+ * @param [in] len: uint16_t payload bytes, from EVT_REC_payloadLen().
+ * @return: uint32_t 32 bit FNV-1a digest.
+ */
+uint32_t EVT_REC_digest( QEvt const *e, uint16_t len );
+
+/**
+ * @brief   Find where the records of a ring start.
+ *
+ * In a wrapped ring the oldest slots may be the tail end of a payload, which
+ * are skipped.
+ *
+ * @param [in] *hdr: const EvtRecHdr_t pointer to the ring.
+ * @param [out] *pFirst: uint32_t slot count (mod nSlots) of the first record.
+ * @return: uint32_t number of slots from there on.
+ */
+uint32_t EVT_REC_span( const EvtRecHdr_t *hdr, uint32_t *pFirst );
+
+/**
+ * @brief   Get a slot of a ring.
+ * @param [in] *hdr: const EvtRecHdr_t pointer to the ring.
+ * @param [in] n: uint32_t slot count, taken mod nSlots.
+ * @return: const EvtRecSlot_t pointer to the slot.
+ */
+const EvtRecSlot_t* EVT_REC_slot( const EvtRecHdr_t *hdr, uint32_t n );
+
+/**
+ * @}
+ * end addtogroup groupEvtRec
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                          /* EVT_REC_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,481 @@
+/**
+ * @file   evt_replay.c
+ * @brief  Definitions for replaying an event recording into the AOs on a
+ * host.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEvtRec
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#define QP_IMPL                     /* For the event pools and reference counts */
+#include "evt_replay.h"
+#include "qf_pkg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>    /* The C library's, so give bsp_shared with -iquote */
+
+#ifndef EVT_REC_HOST
+#error "evt_replay.c only builds on a host, with EVT_REC_HOST and the POSIX port"
+#endif
+#ifdef Q_SPY
+#error "evt_replay.c doesn't support Q_SPY, whose post takes a sender"
+#endif
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct EvtReplayPost_t
+ * A post an AO made that its record hasn't come up for yet.
+ */
+typedef struct EvtReplayPosts
+{
+   QActive    *target;
+   QEvt const *e;
+   bool        bLifo;
+} EvtReplayPost_t;
+
+/**
+ * \struct EvtReplayAO_t
+ * An AO being replayed into.
+ */
+typedef struct EvtReplayAOs
+{
+   QActive           *me;                      /**< NULL if not added */
+   QEvt const        *ie;                  /**< For its initial transition */
+   QActiveVtbl const *orig;              /**< The vtable of the AO's class */
+   QActiveVtbl        vtbl;    /**< Copy of orig that holds back its posts */
+   EvtReplayPost_t    stash[EVT_REPLAY_STASH_LEN];   /**< Held back posts */
+   uint8_t            head;                   /**< Oldest post in stash[] */
+   uint8_t            n;                       /**< Posts in stash[] */
+   uint16_t           sig;                /**< Last event dispatched ... */
+   bool               bMatch;             /**< ... whether it matched ... */
+   uint64_t           hostNs;                /**< ... and what it took */
+} EvtReplayAO_t;
+
+/* Private defines -----------------------------------------------------------*/
+
+/**< Different signals of static events that can be made again */
+#define EVT_REPLAY_MAX_STATIC                                               64
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+static EvtReplayAO_t     l_evtReplayAOs[QF_MAX_ACTIVE + 1];
+static uint8_t           l_evtReplayCur;  /**< AO running, 0 while none is */
+static EvtReplayStats_t  l_evtReplayNoStats;   /**< Until a replay runs */
+static EvtReplayStats_t *l_evtReplayStats = &l_evtReplayNoStats;
+
+/**< Stand-ins for the static events, time events among them, that were
+ * posted by interrupts and other threads */
+static QEvt              l_evtReplayStatic[EVT_REPLAY_MAX_STATIC];
+static uint8_t           l_evtReplayNStatic;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Hold back a post an AO made, until its record comes up.
+ *
+ * In place of the post and postLIFO of the vtable of every AO added.
+ *
+ * @param [in] *me: QActive pointer to the AO posted to.
+ * @param [in] *e: QEvt pointer to the event.
+ * @param [in] bLifo: bool true for the front of the queue.
+ * @return: None
+ */
+static void EVT_REPLAY_stash( QActive * const me, QEvt const * const e, bool bLifo );
+
+/**
+ * @brief   FIFO post of an AO added.
+ * @param [in] *me: QActive pointer to the AO posted to.
+ * @param [in] *e: QEvt pointer to the event.
+ * @param [in] margin: uint_fast16_t ignored, the record says if it made it.
+ * @return: bool true.
+ */
+static bool EVT_REPLAY_post(
+      QActive * const me,
+      QEvt const * const e,
+      uint_fast16_t const margin
+);
+
+/**
+ * @brief   LIFO post of an AO added.
+ * @param [in] *me: QActive pointer to the AO posted to.
+ * @param [in] *e: QEvt pointer to the event.
+ * @return: None
+ */
+static void EVT_REPLAY_postLIFO( QActive * const me, QEvt const * const e );
+
+/**
+ * @brief   Put an event in the queue of an AO added.
+ * @param [in] *to: EvtReplayAO_t pointer to the AO.
+ * @param [in] *e: QEvt pointer to the event.
+ * @param [in] bLifo: bool true for the front of the queue.
+ * @return: bool false if the queue was full.
+ */
+static bool EVT_REPLAY_deliver( EvtReplayAO_t *to, QEvt const *e, bool bLifo );
+
+/**
+ * @brief   Make a post from an interrupt or a thread that isn't replayed.
+ * @param [in] *hdr: const EvtRecHdr_t pointer to the ring.
+ * @param [in] i: uint32_t slot of the record.
+ * @param [in] *r: const EvtRec_t pointer to the record.
+ * @return: None
+ */
+static void EVT_REPLAY_inject( const EvtRecHdr_t *hdr, uint32_t i, const EvtRec_t *r );
+
+/**
+ * @brief   Check the oldest post held back from an AO against its record and
+ * let it through.
+ * @param [in] *r: const EvtRec_t pointer to the record.
+ * @return: None
+ */
+static void EVT_REPLAY_check( const EvtRec_t *r );
+
+/**
+ * @brief   Dispatch the next event of an AO and check it against its record.
+ * @param [in] *r: const EvtRec_t pointer to the record.
+ * @return: None
+ */
+static void EVT_REPLAY_dispatch( const EvtRec_t *r );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void EVT_REPLAY_stash( QActive * const me, QEvt const * const e, bool bLifo )
+{
+   EvtReplayAO_t *from = &l_evtReplayAOs[l_evtReplayCur];
+
+   if ( 0 == l_evtReplayCur ) {
+      /* Not from an AO being replayed, nothing to check it against */
+      EVT_REPLAY_deliver( &l_evtReplayAOs[me->prio], e, bLifo );
+      return;
+   }
+
+   /* The reference is held until the post is let through or thrown away,
+    * since the AO may be done with the event by then */
+   if ( 0U != e->poolId_ ) {
+      QF_EVT_REF_CTR_INC_( e );
+   }
+   if ( EVT_REPLAY_STASH_LEN == from->n ) {
+      l_evtReplayStats->nUnexpected++;
+      QF_gc( e );
+      return;
+   }
+
+   EvtReplayPost_t *p = &from->stash[( from->head + from->n ) % EVT_REPLAY_STASH_LEN];
+   p->target = me;
+   p->e      = e;
+   p->bLifo  = bLifo;
+   from->n++;
+}
+
+/******************************************************************************/
+static bool EVT_REPLAY_post(
+      QActive * const me,
+      QEvt const * const e,
+      uint_fast16_t const margin
+)
+{
+   (void) margin;
+   EVT_REPLAY_stash( me, e, false );
+   return( true );
+}
+
+/******************************************************************************/
+static void EVT_REPLAY_postLIFO( QActive * const me, QEvt const * const e )
+{
+   EVT_REPLAY_stash( me, e, true );
+}
+
+/******************************************************************************/
+static bool EVT_REPLAY_deliver( EvtReplayAO_t *to, QEvt const *e, bool bLifo )
+{
+   if ( 0 == to->me->eQueue.nFree ) {
+      l_evtReplayStats->nPostMismatches++;
+      return( false );
+   }
+
+   if ( bLifo ) {
+      to->orig->postLIFO( to->me, e );
+   } else {
+      to->orig->post( to->me, e, 0 );
+   }
+   return( true );
+}
+
+/******************************************************************************/
+static void EVT_REPLAY_inject( const EvtRecHdr_t *hdr, uint32_t i, const EvtRec_t *r )
+{
+   QEvt const *e = NULL;
+
+   if ( 0 == r->poolId ) {
+      uint8_t s = 0;
+      while ( s < l_evtReplayNStatic && l_evtReplayStatic[s].sig != r->sig ) {
+         s++;
+      }
+      if ( s == l_evtReplayNStatic && s < EVT_REPLAY_MAX_STATIC ) {
+         l_evtReplayStatic[s].sig = r->sig;
+         l_evtReplayNStatic++;
+      }
+      if ( s < l_evtReplayNStatic ) {
+         e = &l_evtReplayStatic[s];
+      }
+   } else if ( r->poolId <= QF_maxPool_ ) {
+      uint_fast16_t size = QF_EPOOL_EVENT_SIZE_( QF_pool_[r->poolId - 1] );
+      QEvt *pe = QF_newX_( size, 1, r->sig );
+
+      /* The payload is in its dispatch, the first one of the same event by
+       * the same AO */
+      for ( uint32_t j = i + 1; NULL != pe && j < hdr->head; j++ ) {
+         const EvtRec_t *d = &EVT_REC_slot( hdr, j )->rec;
+         if ( EVT_REC_DISPATCH != d->kind || d->target != r->target || d->evt != r->evt ) {
+            continue;
+         }
+
+         uint8_t *payload = (uint8_t *)pe + sizeof(QEvt);
+         uint32_t len = d->len < size - sizeof(QEvt) ? d->len : size - sizeof(QEvt);
+         for ( uint32_t off = 0; off < len; off += EVT_REC_DATA_BYTES ) {
+            const EvtRecData_t *data = &EVT_REC_slot( hdr, j + 1 + off / EVT_REC_DATA_BYTES )->data;
+            memcpy( &payload[off], data->data,
+                  len - off < EVT_REC_DATA_BYTES ? len - off : EVT_REC_DATA_BYTES );
+         }
+         break;
+      }
+      e = pe;
+   }
+
+   if ( NULL == e ) {
+      l_evtReplayStats->nPostMismatches++;
+      return;
+   }
+
+   if ( !EVT_REPLAY_deliver( &l_evtReplayAOs[r->target], e, EVT_REC_POST_LIFO == r->kind ) ) {
+      QF_gc( e );
+      return;
+   }
+   l_evtReplayStats->nInjected++;
+}
+
+/******************************************************************************/
+static void EVT_REPLAY_check( const EvtRec_t *r )
+{
+   EvtReplayAO_t *from = &l_evtReplayAOs[r->sender];
+
+   if ( 0 == from->n ) {
+      l_evtReplayStats->nMissing++;
+      return;
+   }
+
+   EvtReplayPost_t p = from->stash[from->head];
+   from->head = ( from->head + 1 ) % EVT_REPLAY_STASH_LEN;
+   from->n--;
+
+   if ( p.target->prio == r->target && p.e->sig == r->sig &&
+         p.e->poolId_ == r->poolId && p.bLifo == ( EVT_REC_POST_LIFO == r->kind ) ) {
+      l_evtReplayStats->nPostsChecked++;
+   } else {
+      l_evtReplayStats->nPostMismatches++;
+   }
+
+   /* Let it through even if it doesn't match, to see where it leads */
+   if ( EVT_REC_DROP != r->kind ) {
+      EVT_REPLAY_deliver( &l_evtReplayAOs[p.target->prio], p.e, p.bLifo );
+   }
+   QF_gc( p.e );
+}
+
+/******************************************************************************/
+static void EVT_REPLAY_dispatch( const EvtRec_t *r )
+{
+   EvtReplayAO_t *ao = &l_evtReplayAOs[r->target];
+   struct timespec t0;
+   struct timespec t1;
+
+   ao->sig    = r->sig;
+   ao->bMatch = false;
+   ao->hostNs = 0;
+
+   if ( (QEvt const *)0 == ao->me->eQueue.frontEvt ) {
+      l_evtReplayStats->nDispatchMismatches++;
+      return;
+   }
+
+   QEvt const *e = QActive_get_( ao->me );
+   uint16_t len = EVT_REC_payloadLen( e );
+   ao->sig    = e->sig;
+   ao->bMatch = e->sig == r->sig && len == r->len && EVT_REC_digest( e, len ) == r->aux;
+   if ( !ao->bMatch ) {
+      l_evtReplayStats->nDispatchMismatches++;
+   }
+
+   l_evtReplayCur = r->target;
+   clock_gettime( CLOCK_MONOTONIC, &t0 );
+   QMSM_DISPATCH( &ao->me->super, e );
+   clock_gettime( CLOCK_MONOTONIC, &t1 );
+   l_evtReplayCur = 0;
+   QF_gc( e );
+
+   ao->hostNs = (uint64_t)( t1.tv_sec - t0.tv_sec ) * 1000000000U +
+         (uint64_t)t1.tv_nsec - (uint64_t)t0.tv_nsec;
+   l_evtReplayStats->nDispatched++;
+}
+
+/******************************************************************************/
+void EVT_REPLAY_init( void )
+{
+   memset( l_evtReplayAOs, 0, sizeof(l_evtReplayAOs) );
+   l_evtReplayCur     = 0;
+   l_evtReplayNStatic = 0;
+}
+
+/******************************************************************************/
+void EVT_REPLAY_addAO(
+      QActive *me,
+      uint8_t prio,
+      QEvt const *qSto[],
+      uint16_t qLen,
+      QEvt const *ie
+)
+{
+   EvtReplayAO_t *ao = &l_evtReplayAOs[prio];
+
+   /* What QActive_start_() of the POSIX port does, short of the thread and
+    * the initial transition */
+   QEQueue_init( &me->eQueue, qSto, qLen );
+   pthread_cond_init( &me->osObject, 0 );
+   me->prio = prio;
+   QF_add_( me );
+
+   ao->me   = me;
+   ao->ie   = ie;
+   ao->orig = (QActiveVtbl const *)me->super.vptr;
+   ao->vtbl = *ao->orig;
+   ao->vtbl.post     = &EVT_REPLAY_post;
+   ao->vtbl.postLIFO = &EVT_REPLAY_postLIFO;
+   me->super.vptr = &ao->vtbl.super;
+}
+
+/******************************************************************************/
+const EvtRecHdr_t* EVT_REPLAY_load( const char *path )
+{
+   FILE *f = fopen( path, "rb" );
+   if ( NULL == f ) {
+      return( NULL );
+   }
+
+   fseek( f, 0, SEEK_END );
+   long size = ftell( f );
+   rewind( f );
+
+   EvtRecHdr_t *hdr = NULL;
+   if ( size >= (long)sizeof(EvtRecHdr_t) ) {
+      hdr = malloc( (size_t)size );
+   }
+   if ( NULL != hdr && 1 != fread( hdr, (size_t)size, 1, f ) ) {
+      free( hdr );
+      hdr = NULL;
+   }
+   fclose( f );
+
+   if ( NULL != hdr && (
+         EVT_REC_MAGIC   != hdr->magic   ||
+         EVT_REC_VERSION != hdr->version ||
+         sizeof(EvtRecSlot_t) != hdr->slotSize ||
+         0 == hdr->nSlots ||
+         (uint64_t)size < sizeof(EvtRecHdr_t) + (uint64_t)hdr->nSlots * hdr->slotSize ) ) {
+      free( hdr );
+      hdr = NULL;
+   }
+   return( hdr );
+}
+
+/******************************************************************************/
+bool EVT_REPLAY_run(
+      const EvtRecHdr_t *hdr,
+      EvtReplayStepCb_t stepCb,
+      EvtReplayStats_t *pStats
+)
+{
+   memset( pStats, 0, sizeof(*pStats) );
+   if ( hdr->head > hdr->nSlots ) {
+      return( false );                   /* Wrapped, the start is gone */
+   }
+   l_evtReplayStats = pStats;
+
+   for ( uint32_t i = 0; i < hdr->head; i++ ) {
+      const EvtRec_t *r = &EVT_REC_slot( hdr, i )->rec;
+      if ( EVT_REC_NONE == r->kind || EVT_REC_DATA == r->kind ||
+            r->target > QF_MAX_ACTIVE || NULL == l_evtReplayAOs[r->target].me ) {
+         continue;
+      }
+
+      EvtReplayAO_t *ao = &l_evtReplayAOs[r->target];
+      switch ( r->kind ) {
+         case EVT_REC_INIT:
+            l_evtReplayCur = r->target;
+            QMSM_INIT( &ao->me->super, ao->ie );
+            l_evtReplayCur = 0;
+            break;
+
+         case EVT_REC_POST:
+         case EVT_REC_POST_LIFO:
+         case EVT_REC_DROP:
+            if ( r->sender <= QF_MAX_ACTIVE && NULL != l_evtReplayAOs[r->sender].me ) {
+               EVT_REPLAY_check( r );
+            } else if ( EVT_REC_DROP != r->kind ) {
+               EVT_REPLAY_inject( hdr, i, r );
+            }
+            break;
+
+         case EVT_REC_DISPATCH:
+            EVT_REPLAY_dispatch( r );
+            break;
+
+         case EVT_REC_DONE:
+            if ( NULL != stepCb ) {
+               EvtReplayStep_t step = {
+                     .rec          = r,
+                     .prio         = r->target,
+                     .sig          = ao->sig,
+                     .targetCycles = r->aux,
+                     .hostNs       = ao->hostNs,
+                     .bMatch       = ao->bMatch,
+               };
+               stepCb( &step );
+            }
+            break;
+
+         default:
+            break;
+      }
+   }
+
+   /* Posts the AOs made that never came up in the recording, unless the
+    * recording stopped before they could */
+   for ( uint8_t p = 1; p <= QF_MAX_ACTIVE; p++ ) {
+      EvtReplayAO_t *ao = &l_evtReplayAOs[p];
+      if ( 0 == hdr->nLost ) {
+         pStats->nUnexpected += ao->n;
+      }
+      while ( 0 != ao->n ) {
+         QF_gc( ao->stash[ao->head].e );
+         ao->head = ( ao->head + 1 ) % EVT_REPLAY_STASH_LEN;
+         ao->n--;
+      }
+   }
+   return( true );
+}
+
+/**
+ * @}
+ * end addtogroup groupEvtRec
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,169 @@
+/**
+ * @file   evt_replay.h
+ * @brief  Declarations for replaying an event recording into the AOs on a
+ * host.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEvtRec
+ * @{
+ *
+ * Not part of the firmware.  A host program builds the AOs it wants to replay
+ * against the POSIX port of QP with QF_EVT_REC (so pool events get zeroed the
+ * same way) and EVT_REC_HOST, along with evt_rec.c and this module, then:
+ *
+ * - sets up QF and the same event pools as the target does,
+ * - calls EVT_REPLAY_init() and EVT_REPLAY_addAO() for every AO instead of
+ *   QACTIVE_START(), which leaves out the thread so all of it runs in order
+ *   on the caller's thread,
+ * - loads a ring saved with the debugger (see evt_rec.h) with
+ *   EVT_REPLAY_load() and hands it to EVT_REPLAY_run().
+ *
+ * EVT_REPLAY_run() walks the records in the order they were taken:
+ *
+ * - EVT_REC_INIT runs the initial transition of the AO.
+ * - EVT_REC_POST from an interrupt or other thread is made again, with the
+ *   payload its EVT_REC_DISPATCH recorded, and posted to the AO.
+ * - EVT_REC_POST from an AO has to be a post the replayed AO made too.  Posts
+ *   made by the AOs during a replay are held back until the record of them
+ *   comes up, so they reach the queues in the same order as on the target,
+ *   and are checked against it.
+ * - EVT_REC_DISPATCH takes the next event off the queue of the AO, checks
+ *   its signal and digest against the record and dispatches it, timing it.
+ * - EVT_REC_DONE hands the cycles it took on the target and the time it took
+ *   on the host to the callback.
+ *
+ * The digests only match if the events are laid out the same on the host,
+ * so events carrying pointers want a 32 bit build (-m32).  Time events come
+ * back as plain static events of the same signal.  A ring that wrapped
+ * around can't be replayed since the AOs didn't start where it does.
+ *
+ * test/host/evt_replay_test.c records AOs on the host and replays them.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef EVT_REPLAY_H_
+#define EVT_REPLAY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "qp_port.h"                                        /* for QP support */
+#include "evt_rec.h"
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< Posts one AO can make in one RTC step before the records catch up */
+#ifndef EVT_REPLAY_STASH_LEN
+#define EVT_REPLAY_STASH_LEN                                                32
+#endif
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct EvtReplayStep_t
+ * One RTC step, as handed to the callback of EVT_REPLAY_run().
+ */
+typedef struct EvtReplayStepTag
+{
+   const EvtRec_t *rec;              /**< The EVT_REC_DONE record of the step */
+   uint8_t         prio;                           /**< Priority of the AO */
+   uint16_t        sig;                            /**< Signal dispatched */
+   uint32_t        targetCycles;            /**< Cycles it took on the target */
+   uint64_t        hostNs;            /**< Nanoseconds it took on the host */
+   bool            bMatch;    /**< Event matched the record when dispatched */
+} EvtReplayStep_t;
+
+/**
+ * \struct EvtReplayStats_t
+ * How a replay went.  Everything but the first three counts a difference
+ * from the recording.
+ */
+typedef struct EvtReplayStatsTag
+{
+   uint32_t nDispatched;                           /**< RTC steps replayed */
+   uint32_t nInjected;         /**< Posts from interrupts and other threads */
+   uint32_t nPostsChecked;        /**< Posts by AOs that matched the record */
+   uint32_t nPostMismatches;   /**< Posts by AOs that didn't match the record */
+   uint32_t nDispatchMismatches;    /**< Events that didn't match the record */
+   uint32_t nUnexpected;          /**< Posts by AOs that weren't recorded */
+   uint32_t nMissing;            /**< Recorded posts the AOs didn't make */
+} EvtReplayStats_t;
+
+/**
+ * @brief   Callback for every RTC step replayed.
+ * @param [in] *pStep: const EvtReplayStep_t pointer to the step.
+ * @return: None
+ */
+typedef void (*EvtReplayStepCb_t)( const EvtReplayStep_t *pStep );
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Forget any AOs added so far.
+ * @param   None
+ * @return: None
+ */
+void EVT_REPLAY_init( void );
+
+/**
+ * @brief   Add an AO to replay into, without its thread or initial transition.
+ *
+ * @param [in|out] *me: QActive pointer to the constructed AO.
+ * @param [in] prio: uint8_t priority it has on the target.
+ * @param [in] *qSto[]: QEvt pointer array for its queue.
+ * @param [in] qLen: uint16_t length of the queue, as on the target.
+ * @param [in] *ie: QEvt pointer to the initialization event, or NULL.
+ * @return: None
+ */
+void EVT_REPLAY_addAO(
+      QActive *me,
+      uint8_t prio,
+      QEvt const *qSto[],
+      uint16_t qLen,
+      QEvt const *ie
+);
+
+/**
+ * @brief   Load a ring saved from the target.
+ * @param [in] *path: const char pointer to the name of the file.
+ * @return: const EvtRecHdr_t pointer to the ring, NULL if it can't be read
+ * or isn't one.  Stays loaded until the program exits.
+ */
+const EvtRecHdr_t* EVT_REPLAY_load( const char *path );
+
+/**
+ * @brief   Replay a ring into the AOs added.
+ *
+ * @param [in] *hdr: const EvtRecHdr_t pointer to the ring.
+ * @param [in] stepCb: EvtReplayStepCb_t called for every RTC step, or NULL.
+ * @param [out] *pStats: EvtReplayStats_t pointer to how it went.
+ * @return: bool false if the ring can't be replayed, true if it was, whether
+ * or not it matched (see pStats).
+ */
+bool EVT_REPLAY_run(
+      const EvtRecHdr_t *hdr,
+      EvtReplayStepCb_t stepCb,
+      EvtReplayStats_t *pStats
+);
+
+/**
+ * @}
+ * end addtogroup groupEvtRec
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* EVT_REPLAY_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -21,9 +21,9 @@
  * This state machine handles all I/O on the I2C bus.  It can be instantiated
  * several times with a different bus for a parameter.  This AO doesn't handle
  * any actual I2C devices, just generic I2C bus operations such as sending the
- * start/end bit, waiting for events, initiating DMA reads/writes, etc.  I2C
- * devices should be handled in the I2CXDevMgr AOs.  This allows this AO to be
- * generic and reusable.
+ * start/end bit, waiting for events, initiating DMA or interrupt driven
+ * reads/writes, etc.  I2C devices should be handled in the I2CXDevMgr AOs.
+ * This allows this AO to be generic and reusable.
  *
  * @note 1: If editing this file, please make sure to update the I2CBusMgr.qm
  * model.  The generated code from that model should be very similar to the
@@ -42,7 +42,7 @@
 #include "I2CBusMgr.h"
 #include "project_includes.h"           /* Includes common to entire project. */
 #include "bsp.h"          /* For seconds to bsp tick conversion (SEC_TO_TICK) */
-#include "I2C1DevMgr.h"
+#include "I2CDevMgr.h"
 
 /* Compile-time called macros ------------------------------------------------*/
 Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
@@ -79,10 +79,6 @@ typedef struct {
          gets to 0. */
     uint32_t nI2CLoopTimeout;
 
-    /**< Specifies what the current I2C bus operation is happening.  Gets set upon
-         reception of I2C_READ_START_SIG and I2C_WRITE_START_SIG */
-    I2C_Operation_t i2cCurrOperation;
-
     /**< QPC timer Used to time I2C bus settling. */
     QTimeEvt i2cBusSettleTimerEvt;
 
@@ -99,6 +95,9 @@ typedef struct {
     /**< pointer to opaque pointer to the I2CxDevMgr AO that this instance of I2CBusMgr
      * AO will directly post events to */
     QActive * p_AO_I2CDevMgr;
+
+    /**< Transfer the I2C interrupts are running for this bus, if any */
+    I2C_Xfer_t xfer;
 } I2CBusMgr;
 
 /* protected: */
@@ -144,111 +143,6 @@ static QState I2CBusMgr_Idle(I2CBusMgr * const me, QEvt const * const e);
  */
 static QState I2CBusMgr_Busy(I2CBusMgr * const me, QEvt const * const e);
 
-/**
- * @brief This is a Wait state for polling for MASTER MODE (I2C EV5).
- *
- * This state is a Timeout/Wait state for the polling child state for MASTER MODE
- * on the I2C bus.  It takes care of the timeout and sending a result to anyone
- * who is listening for this event.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_EV5(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Poll state for polling for MASTER MODE (I2C EV5).
- *
- * This state posts an event to check for the I2C_EVENT_MASTER_MODE_SELECT (EV5)
- * which is triggerred by posting a START bit on the I2C bus. It also checks if
- * the system is out of retries for this action and exits if true.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_PollFor_I2C_EV5(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for polling for selecting transmitter mode (I2C
- * EV6).
- * This state is a Timeout/Wait state for the polling child state for MASTER
- * TRANSMITTER MODE on the I2C bus.  It takes care of the timeout and sending a
- * result to anyone who is listening for this event.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_EV6_TX(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Poll state for polling for MASTER MODE (I2C EV5).
- *
- * This state posts an event to check for the I2C_EVENT_MASTER_MODE_SELECT (EV5)
- * which is triggerred by posting a START bit on the I2C bus. It also checks if
- * the system is out of retries for this action and exits if true.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_PollFor_I2C_EV6_TX(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for polling for MASTER MODE (I2C EV5).
- *
- * This state is a Timeout/Wait state for the polling child state for MASTER MODE
- * on the I2C bus.  It takes care of the timeout and sending a result to anyone
- * who is listening for this event.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_EV8(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for polling for EV8 (MSB of the 2 byte address)
- *
- * This state posts an event to check for the
- * I2C_EVENT_MASTER_BYTE_TRANSMITTING (EV8) which is triggerred by
- * sending the MSByte of the memory address of the device in the previous state.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If EV8 occurred, the state sends the LSByte of internal memory address of the
- * device from where we want to read/write.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_EV8_MSB(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for polling for EV8 (LSB of the 2 byte address)
- *
- * This state posts an event to check for the
- * I2C_EVENT_MASTER_BYTE_TRANSMITTING (EV8) which is triggerred by
- * sending the MSByte of the memory address of the device in the previous state.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If EV8 occurred, the state sends the LSByte of internal memory address of the
- * device from where we want to read/write.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_EV8_LSB(I2CBusMgr * const me, QEvt const * const e);
 static QState I2CBusMgr_BusRecovery(I2CBusMgr * const me, QEvt const * const e);
 
 /**
@@ -307,7 +201,7 @@ static QState I2CBusMgr_WaitForBusToSettle(I2CBusMgr * const me, QEvt const * co
  * do this, a new communication has to be attempted.  This state initiates the
  * communication as if it is going to talk to a slave EEPROM.  An error is
  * expected and the I2C1_ER_IRQHandler ISR will clear it by calling the
- * I2C1_ErrorEventCallback function.
+ * I2C_ErrorEventCallback function.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
@@ -322,7 +216,7 @@ static QState I2CBusMgr_PollFor_I2C_EV5_REC(I2CBusMgr * const me, QEvt const * c
  * do this, a new communication has to be attempted.  This state continues after
  * previous state, because sometimes the error can happen a little later.
  * An error is expected and the I2C1_ER_IRQHandler ISR will clear it by
- * calling the I2C1_ErrorEventCallback function.
+ * calling the I2C_ErrorEventCallback function.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
@@ -332,133 +226,20 @@ static QState I2CBusMgr_PollFor_I2C_EV5_REC(I2CBusMgr * const me, QEvt const * c
 static QState I2CBusMgr_PollFor_I2C_EV6_REC(I2CBusMgr * const me, QEvt const * const e);
 
 /**
- * @brief This is a Wait state for reading the internal memory of some device
- * on an I2C bus.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_MemRead(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for DMA I2C read.
- *
- * This state issues a DMA read command which does all the work and posts a timer
- * to make sure it happens in a timely manner.  The callback from the ISR for the
- * associated DMA stream will post the event with the read data, which will also
- * take the state machine out of this state and back to Idle.
- *
- * @note: this state is READ operation specific.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitForDMAReadDone(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for polling for reading I2C bytes manually.
- *
- * This state posts an event to check for the I2C_FLAG_RXNE flag has been set
- * which indicates that I2C data is ready to be read out.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If data is ready to read, the state machine reads the byte of data and stores
- * it in the buffer.  It then checks whether there is 1 byte left to read and if
- * so, issues a STOP bit on the bus.  This is due to a bug in the STM32 I2C IP
- * which requires that the STOP bit be sent before the last byte is read out.
- *
- * @note: this state is READ operation specific.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_ReadI2CByte(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for polling for selecting transmitter mode (I2C
- * EV6).
- * This state is a Timeout/Wait state for the polling child state for MASTER
- * TRANSMITTER MODE on the I2C bus.  It takes care of the timeout and sending a
- * result to anyone who is listening for this event.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_EV6_RX(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Poll state for polling for MASTER MODE (I2C EV5).
- *
- * This state posts an event to check for the I2C_EVENT_MASTER_MODE_SELECT (EV5)
- * which is triggerred by posting a START bit on the I2C bus. It also checks if
- * the system is out of retries for this action and exits if true.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_PollFor_I2C_EV6_RX(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for writing the internal memory of some device
- * on an I2C bus.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitFor_I2C_MemWrite(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for DMA I2C write.
- *
- * This state issues a DMA write command which does all the work and posts a timer
- * to make sure it happens in a timely manner.  The callback from the ISR for the
- * associated DMA stream will post the event signaling completion, which will also
- * take the state machine out of this state and back to Idle.
- *
- * @note: this state is READ operation specific.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-static QState I2CBusMgr_WaitForDMAWriteDone(I2CBusMgr * const me, QEvt const * const e);
-
-/**
- * @brief This is a Wait state for polling for writing I2C bytes manually.
+ * @brief This is a Wait state for a transfer run by the I2C interrupts.
  *
- * This state posts an event to check for the I2C_EVENT_MASTER_BYTE_TRANSMITTED
- * I2C event which indicates that I2C data is ready to be written out.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If data is ready to write, the state machine writes the byte of data and
- * loops back into the state to wait for next I2C event until no more bytes are
- * left to be written.  It then issues a STOP bit on the I2C bus and returns to
- * Idle.
- *
- * @note: this state is WRITE operation specific.
- * @note: some devices on I2C bus, such as EEPROMs, require a post write delay
- * during which the device will not respond to any data. This should be accounted
- * for by the user of this AO since this AO is not device specific.
+ * The I2C event and error ISRs move the whole transfer and post
+ * I2C_BUS_XFER_DONE once it's finished or has failed, so this state only has
+ * to wait for that one event.  If the operation timer fires first, the exit
+ * action stops the transfer and releases the bus.  Either way, the result is
+ * sent back to the I2CxDevMgr AO on exit.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
  * @return status_: QState type that specifies where the state
  * machine is going next.
  */
-static QState I2CBusMgr_WriteI2CByte(I2CBusMgr * const me, QEvt const * const e);
+static QState I2CBusMgr_WaitForXferDone(I2CBusMgr * const me, QEvt const * const e);
 
 
 /* Private defines -----------------------------------------------------------*/
@@ -558,22 +339,9 @@ static QState I2CBusMgr_Active(I2CBusMgr * const me, QEvt const * const e) {
             );
             QTimeEvt_disarm(&me->i2cOpTimerEvt);
 
-            /* Get a pointer to the I2CxDevMgr AO to which this instance will directly
-             * post events to. */
-            if ( I2CBus1 == me->iBus ) {
-                me->p_AO_I2CDevMgr = AO_I2C1DevMgr;
-            //TODO: commented out since not implemented yet.  Uncomment if/when implemented
-            //}
-            //else if ( I2CBus2 == me->iBus ) {
-            //    me->p_AO_I2CDevMgr = AO_I2C2DevMgr;
-            //} else if ( I2CBus3 == me->iBus ) {
-            //    me->p_AO_I2CDevMgr = AO_I2C3DevMgr;
-            } else {
-                ERR_printf(
-                    "Unknown I2CBus%d specified for this instance of I2CBusMgr to post events to\n",
-                    me->iBus+1
-                );
-            }
+            /* Get a pointer to the I2CDevMgr AO instance for the same bus to which this
+             * instance will directly post events to. */
+            me->p_AO_I2CDevMgr = AO_I2CDevMgr[me->iBus];
 
             I2C_BusInit( me->iBus ); /* Initialize the I2C devices and associated busses */
             status_ = Q_HANDLED();
@@ -660,208 +428,70 @@ static QState I2CBusMgr_Idle(I2CBusMgr * const me, QEvt const * const e) {
             }
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_START_BIT} */
-        case I2C_BUS_START_BIT_SIG: {
-            I2C_GenerateSTART(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);  /* Send START condition */
-            status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV5);
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_7BIT_ADDR} */
-        case I2C_BUS_SEND_7BIT_ADDR_SIG: {
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_7BIT_ADDR::[I2C_TX?]} */
-            if (((I2CAddrEvt const *)e)->i2cDirection == I2C_Direction_Transmitter) {
-                DBG_printf(
-                    "Sending 7bitAddr 0x%02x with direction %d\n",
-                    ((I2CAddrEvt const *)e)->addr & 0x00FF,
-                    I2C_Direction_Receiver
-                );
-
-                /* Send slave Address for write */
-                I2C_Send7bitAddress(
-                    s_I2C_Bus[me->iBus].i2c_bus,            /* Get the STM32 designation of the I2C bus */
-                    ((I2CAddrEvt const *)e)->addr & 0x00FF, /* Get the address from the event */
-                    I2C_Direction_Transmitter               /* TX direction on the I2C bus */
-                );
-                status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_TX);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_7BIT_ADDR::[I2C_RX?]} */
-            else if (((I2CAddrEvt const *)e)->i2cDirection == I2C_Direction_Receiver) {
-                DBG_printf(
-                    "Sending 7bitAddr 0x%02x with direction %d\n",
-                    ((I2CAddrEvt const *)e)->addr & 0x00FF,
-                    I2C_Direction_Receiver
-                );
-
-                /* Send slave Address for write */
-                I2C_Send7bitAddress(
-                    s_I2C_Bus[me->iBus].i2c_bus,            /* Get the STM32 designation of the I2C bus */
-                    ((I2CAddrEvt const *)e)->addr & 0x00FF, /* Get the address from the event */
-                    I2C_Direction_Receiver                  /* RX direction on the I2C bus */
-                );
-                status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_RX);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_7BIT_ADDR::[else]} */
-            else {
-                me->errorCode = ERR_I2CBUS_INVALID_PARAMS_FOR_7BIT_ADDR;
-
-                ERR_printf(
-                    "Invalid params for sending 7bit I2CBus%d Addr, error: 0x%08x\n",
-                    me->iBus+1,
-                    me->errorCode
-                );
+        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_XFER} */
+        case I2C_BUS_XFER_SIG: {
+            /* Describe the whole transfer to the I2C ISRs */
+            me->xfer.devAddr     = ((I2CXferReqEvt const *)e)->devAddr;
+            me->xfer.memAddr     = ((I2CXferReqEvt const *)e)->memAddr;
+            me->xfer.memAddrSize = ((I2CXferReqEvt const *)e)->memAddrSize;
+            me->xfer.isRead      = ((I2CXferReqEvt const *)e)->isRead;
+            me->xfer.len         = ((I2CXferReqEvt const *)e)->bytes;
+            s_I2C_Bus[me->iBus].nBytesExpected = me->xfer.len;
 
-                /* Allocate a dynamic event to send back the result after attempting to recover
-                 * the I2C bus. */
-                I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-                i2cStatEvt->i2cBus = me->iBus;         // set the bus
-                i2cStatEvt->errorCode = me->errorCode; // set the error code that was last recorded.
-                QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
-                status_ = Q_HANDLED();
+            if ( me->xfer.isRead && NULL != ((I2CXferReqEvt const *)e)->pBuf ) {
+                /* Read straight into the requester's buffer in a single transfer */
+                me->xfer.buf = ((I2CXferReqEvt const *)e)->pBuf;
+                me->errorCode = ERR_NONE;
+            } else if ( me->xfer.isRead ) {
+                me->xfer.buf = s_I2C_Bus[me->iBus].pRxBuffer;
+                me->errorCode = ( me->xfer.len > MAX_I2C_READ_LEN ) ?
+                    ERR_I2CBUS_INVALID_XFER : ERR_NONE;
+            } else {
+                me->xfer.buf = s_I2C_Bus[me->iBus].pTxBuffer;
+                me->errorCode = ( me->xfer.len > MAX_I2C_WRITE_LEN ) ?
+                    ERR_I2CBUS_INVALID_XFER : ERR_NONE;
+                if ( ERR_NONE == me->errorCode ) {
+                    /* Copy the data right into the TX buffer for this I2C Bus. */
+                    MEMCPY(
+                        s_I2C_Bus[me->iBus].pTxBuffer,
+                        ((I2CXferReqEvt const *)e)->dataBuf,
+                        me->xfer.len
+                    );
+                }
             }
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_DEV_ADDR} */
-        case I2C_BUS_SEND_DEV_ADDR_SIG: {
-            /* Save the address */
-            me->addr = ((I2CAddrEvt const *)e)->addr;
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_DEV_ADDR::[2byteAddr?]} */
-            if (((I2CAddrEvt const *)e)->addrSize == 2) {
-                DBG_printf(
-                    "Sending internal MSB addr (0x%02x) to the I2C Device\n",
-                    (uint8_t)((me->addr & 0xFF00) >> 8)
-                );
 
-                /* Send the MSB of the address first to the I2C device */
-                I2C_SendData(
-                    s_I2C_Bus[me->iBus].i2c_bus,
-                    (uint8_t)((me->addr & 0xFF00) >> 8)
-                );
-                status_ = Q_TRAN(&I2CBusMgr_WaitFor_I2C_EV8_MSB);
+            if ( ERR_NONE == me->errorCode ) {
+                me->errorCode = I2C_StartXfer( me->iBus, &me->xfer );
             }
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_DEV_ADDR::[1byteAddr?]} */
-            else if (((I2CAddrEvt const *)e)->addrSize == 1) {
-                DBG_printf(
-                    "Sending internal 1 byte addr (0x%02x) to the I2C Device\n",
-                    (uint8_t)(me->addr & 0x00FF)
-                );
-
-                /* Send the LSB of the address to the I2C device */
-                I2C_SendData(
-                    s_I2C_Bus[me->iBus].i2c_bus,
-                    (uint8_t)(me->addr & 0x00FF)
-                );
-                status_ = Q_TRAN(&I2CBusMgr_WaitFor_I2C_EV8_LSB);
+            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_XFER::[Started?]} */
+            if (ERR_NONE == me->errorCode) {
+                status_ = Q_TRAN(&I2CBusMgr_WaitForXferDone);
             }
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_SEND_DEV_ADDR::[else]} */
+            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_XFER::[else]} */
             else {
-                me->errorCode = ERR_I2CBUS_INVALID_PARAMS_FOR_SEND_DATA;
-
                 ERR_printf(
-                    "Invalid params for sending data on I2CBus%d Addr, error: 0x%08x\n",
+                    "Unable to start transfer on I2CBus%d, error: 0x%08x\n",
                     me->iBus+1,
                     me->errorCode
                 );
 
-                /* Allocate a dynamic event to send back the result after attempting to recover
-                 * the I2C bus. */
-                I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-                i2cStatEvt->i2cBus = me->iBus;         // set the bus
-                i2cStatEvt->errorCode = me->errorCode; // set the error code that was last recorded.
-                QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
+                /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
+                if ( me->xfer.isRead ) {
+                    I2CBusDataEvt *i2cBusDataEvt = Q_NEW( I2CBusDataEvt, I2C_BUS_DONE_SIG );
+                    i2cBusDataEvt->i2cBus    = me->iBus;
+                    i2cBusDataEvt->errorCode = me->errorCode;
+                    i2cBusDataEvt->dataLen   = 0;
+                    QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cBusDataEvt, me);
+                } else {
+                    I2CStatusEvt *i2cStatusEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
+                    i2cStatusEvt->i2cBus    = me->iBus;
+                    i2cStatusEvt->errorCode = me->errorCode;
+                    QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatusEvt, me);
+                }
                 status_ = Q_HANDLED();
             }
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_READ_MEM} */
-        case I2C_BUS_READ_MEM_SIG: {
-            /* Store device and operation settings from the event */
-            s_I2C_Bus[me->iBus].nBytesExpected  = ((I2CReadMemReqEvt const *)e)->bytes;
-            s_I2C_Bus[me->iBus].nBytesCurrent = 0;
-            s_I2C_Bus[me->iBus].nRxIndex = 0;
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_READ_MEM::[DMAAccess?]} */
-            if (((I2CReadMemReqEvt const *)e)->memAccessType == I2C_MEM_DMA) {
-                DBG_printf("Starting DMA read on a device on I2CBus%d\n", me->iBus+1);
-
-
-                status_ = Q_TRAN(&I2CBusMgr_WaitForDMAReadDone);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_READ_MEM::[ByteAccess?]} */
-            else if (((I2CReadMemReqEvt const *)e)->memAccessType == I2C_MEM_BYTE) {
-                DBG_printf("Starting Byte-by-byte read on a device on I2CBus%d\n", me->iBus+1);
-                status_ = Q_TRAN(&I2CBusMgr_ReadI2CByte);
-            }
-            else {
-                status_ = Q_UNHANDLED();
-            }
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_WRITE_MEM} */
-        case I2C_BUS_WRITE_MEM_SIG: {
-            /* Store device and operation settings from the event */
-            s_I2C_Bus[me->iBus].nBytesExpected  = ((I2CWriteMemReqEvt const *)e)->bytes;
-            s_I2C_Bus[me->iBus].nBytesCurrent = 0;
-            s_I2C_Bus[me->iBus].nTxIndex = 0;
-            /* Copy the data right into the TX buffer for this I2C Bus. */
-            MEMCPY(
-                s_I2C_Bus[me->iBus].pTxBuffer,
-                ((I2CWriteMemReqEvt const *)e)->dataBuf,
-                s_I2C_Bus[me->iBus].nBytesExpected
-            );
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_WRITE_MEM::[DMAAccess?]} */
-            if (((I2CReadMemReqEvt const *)e)->memAccessType == I2C_MEM_DMA) {
-                DBG_printf("Starting DMA write on a device on I2CBus%d\n", me->iBus+1);
-
-
-                status_ = Q_TRAN(&I2CBusMgr_WaitForDMAWriteDone);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_WRITE_MEM::[ByteAccess?]} */
-            else if (((I2CReadMemReqEvt const *)e)->memAccessType == I2C_MEM_BYTE) {
-                DBG_printf("Starting Byte-by-byte read on a device on I2CBus%d\n", me->iBus+1);
-                status_ = Q_TRAN(&I2CBusMgr_WriteI2CByte);
-            }
-            else {
-                status_ = Q_UNHANDLED();
-            }
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_ACK_EN} */
-        case I2C_BUS_ACK_EN_SIG: {
-            I2C_AcknowledgeConfig(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
-            DBG_printf("Enabling Ack on I2CBus%d\n", me->iBus+1);
-
-            /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
-            I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus       = me->iBus;      // set the bus
-            i2cStatEvt->errorCode    = me->errorCode; // set the error code that was last recorded.
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_ACK_DIS} */
-        case I2C_BUS_ACK_DIS_SIG: {
-            I2C_AcknowledgeConfig(s_I2C_Bus[me->iBus].i2c_bus, DISABLE);
-            DBG_printf("Disabling Ack on I2CBus%d\n", me->iBus+1);
-
-            /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
-            I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus       = me->iBus;      // set the bus
-            i2cStatEvt->errorCode    = me->errorCode; // set the error code that was last recorded.
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Idle::I2C_BUS_STOP_BIT} */
-        case I2C_BUS_STOP_BIT_SIG: {
-            I2C_GenerateSTOP(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);  /* Send STOP condition */
-
-            /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
-            I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus       = me->iBus;      // set the bus
-            i2cStatEvt->errorCode    = me->errorCode; // set the error code that was last recorded.
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
-            status_ = Q_HANDLED();
-            break;
-        }
         default: {
             status_ = Q_SUPER(&I2CBusMgr_Active);
             break;
@@ -933,43 +563,37 @@ static QState I2CBusMgr_Busy(I2CBusMgr * const me, QEvt const * const e) {
     return status_;
 }
 
-/**
- * @brief This is a Wait state for polling for MASTER MODE (I2C EV5).
- *
- * This state is a Timeout/Wait state for the polling child state for MASTER MODE
- * on the I2C bus.  It takes care of the timeout and sending a result to anyone
- * who is listening for this event.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5} .....................*/
-static QState I2CBusMgr_WaitFor_I2C_EV5(I2CBusMgr * const me, QEvt const * const e) {
+/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery} .........................*/
+static QState I2CBusMgr_BusRecovery(I2CBusMgr * const me, QEvt const * const e) {
     QState status_;
     switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery} */
         case Q_ENTRY_SIG: {
-            /* Set error code that will be reported if things timeout or run out of retries */
-            me->errorCode = ERR_I2CBUS_EV5_TIMEOUT;
-
             /* Post an operation timer on entry */
             QTimeEvt_rearm(
                 &me->i2cOpTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_BASIC_OP )
+                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_BUS_RECOVERY )
             );
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery} */
         case Q_EXIT_SIG: {
             /* Timer disarmed in parent state */
 
-            /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
+            /* Allocate a dynamic event to send back the result after attempting to recover
+             * the I2C bus. */
             I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus       = me->iBus;      // set the bus
-            i2cStatEvt->errorCode    = me->errorCode; // set the error code that was last recorded.
+            i2cStatEvt->i2cBus = me->iBus;        // set the bus
+
+            /* Check if the bus is free */
+            if ( RESET == I2C_GetFlagStatus( s_I2C_Bus[me->iBus].i2c_bus, I2C_FLAG_BUSY ) ) {
+                me->errorCode = ERR_NONE;
+                DBG_printf("I2CBus%d free after recovery and ready to go.\n", me->iBus+1);
+            } else {
+                ERR_printf("Attempt to recover I2CBus%d failed with error: 0x%08x\n", me->iBus+1, me->errorCode);
+            }
+            i2cStatEvt->errorCode = me->errorCode; // set the error code that was last recorded.
             QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
             status_ = Q_HANDLED();
             break;
@@ -983,110 +607,54 @@ static QState I2CBusMgr_WaitFor_I2C_EV5(I2CBusMgr * const me, QEvt const * const
 }
 
 /**
- * @brief This is a Poll state for polling for MASTER MODE (I2C EV5).
+ * @brief This state initiates I2C bus recovery.
+ * The bus can become stuck if slave device is misbehaving (or not correctly
+ * implementing I2C protocol, or simply by being buggy). Most problems on the
+ * I2C bus are caused by a timing issue of the STOP bit being sent and the slave
+ * ends up locking the bus waiting for the STOP bit to arrive while the bus
+ * master is unable to send it.  The only way to really resolve the issue is to
+ * either reset the slave (not always possible) or to manually clock the bits in.
  *
- * This state posts an event to check for the I2C_EVENT_MASTER_MODE_SELECT (EV5)
- * which is triggerred by posting a START bit on the I2C bus. It also checks if
- * the system is out of retries for this action and exits if true.
+ * This state does exactly that.  Upon entry, it changes the GPIO from I2C
+ * configuration to regular GPIO and manually toggles the SCL line until the
+ * SDA line is released by the slave.
+ * On exit, this state reconfigures the GPIO back to I2C configuration.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
  * @return status_: QState type that specifies where the state
  * machine is going next.
  */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5::PollFor_I2C_EV5} ....*/
-static QState I2CBusMgr_PollFor_I2C_EV5(I2CBusMgr * const me, QEvt const * const e) {
+/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery} .....*/
+static QState I2CBusMgr_WaitForBusRecovery(I2CBusMgr * const me, QEvt const * const e) {
     QState status_;
     switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5::PollFor_I2C_EV5} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery} */
         case Q_ENTRY_SIG: {
-            /* Directly post an event to this AO to check for EV5 event. Post directly
-             * instead of publishing so we don't waste memory */
-            static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
-            QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5::PollFor_I2C_EV5::I2C_CHECK_EV} */
-        case I2C_CHECK_EV_SIG: {
-            /* Check if EV5 has happened.  If it has, go on to the next state.  Otherwise,
-             * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5::PollFor_I2C_EV5::I2C_CHECK_EV::[EV5?]} */
-            if (I2C_CheckEvent(s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_MODE_SELECT)) {
-                me->errorCode = ERR_NONE;
-                status_ = Q_TRAN(&I2CBusMgr_Idle);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5::PollFor_I2C_EV5::I2C_CHECK_EV::[else]} */
-            else {
-                me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5::PollFor_I2C_EV5::I2C_CHECK_EV::[else]::[Retriesleft?]} */
-                if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV5);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV5::PollFor_I2C_EV5::I2C_CHECK_EV::[else]::[else]} */
-                else {
-                    me->errorCode = ERR_I2CBUS_EV5_NOT_REC;
-                    ERR_printf(
-                        "Didn't see I2C_EVENT_MASTER_MODE_SELECT (EV5) on I2CBus%d, error: 0x%08x\n",
-                        me->iBus+1,
-                        me->errorCode
-                    );
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_EV5);
-            break;
-        }
-    }
-    return status_;
-}
+            /* Set the pins up for manual toggling */
+            I2C_BusInitForRecovery( me->iBus );
 
-/**
- * @brief This is a Wait state for polling for selecting transmitter mode (I2C
- * EV6).
- * This state is a Timeout/Wait state for the polling child state for MASTER
- * TRANSMITTER MODE on the I2C bus.  It takes care of the timeout and sending a
- * result to anyone who is listening for this event.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX} ..................*/
-static QState I2CBusMgr_WaitFor_I2C_EV6_TX(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX} */
-        case Q_ENTRY_SIG: {
-            /* Set error code that will be reported if things timeout or run out of retries */
-            me->errorCode = ERR_I2CBUS_EV6_TIMEOUT;
+            me->errorCode = ERR_I2CBUS_RCVRY_SDA_STUCK_LOW;
 
-            /* Post an operation timer on entry */
-            QTimeEvt_rearm(
-                &me->i2cOpTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_BASIC_OP )
-            );
+            /* Reset the maximum number of times to poll the I2C bus for an event */
+            me->nI2CLoopTimeout = MAX_I2C_TIMEOUT;
+
+            WRN_printf("Some I2C%d slave device is misbehaving.\n", (me->iBus) + 1);
+            WRN_printf("Attempting to recover bus by toggling the SCL line\n");
+            WRN_printf("This may cause data corruption if the last I2C op was a write\n");
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery} */
         case Q_EXIT_SIG: {
-            /* Timer disarmed in parent state */
-
-            /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
-            I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus       = me->iBus;      // set the bus
-            i2cStatEvt->errorCode    = me->errorCode; // set the error code that was last recorded.
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
+            /* Initialize the I2C devices and associated busses */
+            LOG_printf("ReInitializing I2C%d bus.\n", (me->iBus) + 1);
+            I2C_BusInit( me->iBus );
             status_ = Q_HANDLED();
             break;
         }
         default: {
-            status_ = Q_SUPER(&I2CBusMgr_Busy);
+            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
             break;
         }
     }
@@ -1094,61 +662,76 @@ static QState I2CBusMgr_WaitFor_I2C_EV6_TX(I2CBusMgr * const me, QEvt const * co
 }
 
 /**
- * @brief This is a Poll state for polling for MASTER MODE (I2C EV5).
+ * @brief This state manually toggles SCL line for I2C bus recovery.
+ * The bus can become stuck if slave device is misbehaving (or not correctly
+ * implementing I2C protocol, or simply by being buggy). Most problems on the
+ * I2C bus are caused by a timing issue of the STOP bit being sent and the slave
+ * ends up locking the bus waiting for the STOP bit to arrive while the bus
+ * master is unable to send it.  The only way to really resolve the issue is to
+ * either reset the slave (not always possible) or to manually clock the bits in.
  *
- * This state posts an event to check for the I2C_EVENT_MASTER_MODE_SELECT (EV5)
- * which is triggerred by posting a START bit on the I2C bus. It also checks if
- * the system is out of retries for this action and exits if true.
+ * This state manually toggles the SCL line until the SDA line is released
+ * by the slave.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
  * @return status_: QState type that specifies where the state
  * machine is going next.
  */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX::PollFor_I2C_EV6_TX} */
-static QState I2CBusMgr_PollFor_I2C_EV6_TX(I2CBusMgr * const me, QEvt const * const e) {
+/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL} */
+static QState I2CBusMgr_TogglingSCL(I2CBusMgr * const me, QEvt const * const e) {
     QState status_;
     switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX::PollFor_I2C_EV6_TX} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL} */
         case Q_ENTRY_SIG: {
-            /* Directly post an event to this AO to check for EV5 event. Post directly
-             * instead of publishing so we don't waste memory */
+            /* Toggle the SCL bit of the bus to the opposite value that it is now */
+            GPIO_ToggleBits( s_I2C_Bus[me->iBus].scl_port, s_I2C_Bus[me->iBus].scl_pin );
+
+            /* Directly post a static event to this AO so we don't waste memory */
             static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
             QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX::PollFor_I2C_EV6_TX::I2C_CHECK_EV} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV} */
         case I2C_CHECK_EV_SIG: {
-            /* Check if EV5 has happened.  If it has, go on to the next state.  Otherwise,
+            /* Check if bus is busy.  If free, go on to the next state.  Otherwise,
              * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX::PollFor_I2C_EV6_TX::I2C_CHECK_EV::[EV6(TX)?]} */
-            if (I2C_CheckEvent( s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED )) {
-                me->errorCode = ERR_NONE;
-                status_ = Q_TRAN(&I2CBusMgr_Idle);
+            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[BusFree?]} */
+            if (SET == GPIO_ReadInputDataBit( s_I2C_Bus[me->iBus].sda_port, s_I2C_Bus[me->iBus].sda_pin  )) {
+                WRN_printf(
+                    "I2CBus%d free after %d SCL toggles\n",
+                    me->iBus+1,
+                    MAX_I2C_TIMEOUT - me->nI2CLoopTimeout
+                );
+
+                /* Make sure to leave the SCL line high after exit */
+                GPIO_SetBits( s_I2C_Bus[me->iBus].scl_port, s_I2C_Bus[me->iBus].scl_pin );
+
+                /* Reset the maximum number of times to poll the I2C bus for an event */
+                me->nI2CLoopTimeout = MAX_I2C_TIMEOUT;
+                status_ = Q_TRAN(&I2CBusMgr_WaitForBusToSettle);
             }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX::PollFor_I2C_EV6_TX::I2C_CHECK_EV::[else]} */
+            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[else]} */
             else {
                 me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX::PollFor_I2C_EV6_TX::I2C_CHECK_EV::[else]::[Retriesleft?]} */
+                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[else]::[Retriesleft?]} */
                 if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_TX);
+                    status_ = Q_TRAN(&I2CBusMgr_TogglingSCL);
                 }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_TX::PollFor_I2C_EV6_TX::I2C_CHECK_EV::[else]::[else]} */
+                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[else]::[else]} */
                 else {
-                    me->errorCode = ERR_I2CBUS_EV6_NOT_REC;
-                    ERR_printf(
-                        "Didn't see I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED (EV6) on I2CBus%d, error: 0x%08x\n",
-                        me->iBus+1,
-                        me->errorCode
-                    );
+                    ERR_printf("Timeout waiting for I2CBus%d bus to be free\n", me->iBus+1);
+                    I2C_SoftwareResetCmd(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
+                    I2C_SoftwareResetCmd(s_I2C_Bus[me->iBus].i2c_bus, DISABLE);
+                    DBG_printf("I2C bus reset\n");
                     status_ = Q_TRAN(&I2CBusMgr_Idle);
                 }
             }
             break;
         }
         default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_EV6_TX);
+            status_ = Q_SUPER(&I2CBusMgr_WaitForBusRecovery);
             break;
         }
     }
@@ -1156,48 +739,58 @@ static QState I2CBusMgr_PollFor_I2C_EV6_TX(I2CBusMgr * const me, QEvt const * co
 }
 
 /**
- * @brief This is a Wait state for polling for MASTER MODE (I2C EV5).
- *
- * This state is a Timeout/Wait state for the polling child state for MASTER MODE
- * on the I2C bus.  It takes care of the timeout and sending a result to anyone
- * who is listening for this event.
+ * @brief This state waits for the bus to settle after being reconfigured to I2C.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
  * @return status_: QState type that specifies where the state
  * machine is going next.
  */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8} .....................*/
-static QState I2CBusMgr_WaitFor_I2C_EV8(I2CBusMgr * const me, QEvt const * const e) {
+/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle} .....*/
+static QState I2CBusMgr_WaitForBusToSettle(I2CBusMgr * const me, QEvt const * const e) {
     QState status_;
     switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle} */
         case Q_ENTRY_SIG: {
-            /* Set error code that will be reported if things timeout or run out of retries */
-            me->errorCode = ERR_I2CBUS_EV8_TIMEOUT;
+            /* Post a timer on entry */
+            QTimeEvt_rearm(
+                &me->i2cBusSettleTimerEvt,
+                SEC_TO_TICKS( LL_MAX_TIME_SEC_I2C_BUS_SETTLE )
+            );
 
-            /* Post an operation timer on entry */
+            /* Rearm the main I2C timer for a value that is enough for the current recovery
+             * effort and enough to retry the operation that caused the problem in the first
+             * place */
             QTimeEvt_rearm(
-                &me->i2cOpTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_BASIC_OP * 2 )
+                &me->i2cTimerEvt,
+                SEC_TO_TICKS( LL_MAX_TIME_SEC_I2C_BUS_SETTLE + LL_MAX_TOUT_SEC_I2C_BUS_RECOVERY )
             );
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle} */
         case Q_EXIT_SIG: {
-            /* Timer disarmed in parent state */
-
-            /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
-            I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus       = me->iBus;      // set the bus
-            i2cStatEvt->errorCode    = me->errorCode; // set the error code that was last recorded.
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
+            QTimeEvt_disarm( &me->i2cBusSettleTimerEvt );
             status_ = Q_HANDLED();
             break;
         }
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle::I2C_BUS_SETTLE_TIMER} */
+        case I2C_BUS_SETTLE_TIMER_SIG: {
+            WRN_printf(
+                "Finished waiting for I2CBus%d to settle after reset and intentional failure\n",
+                me->iBus+1
+            );
+
+            me->errorCode = ERR_I2CBUS_RCVRY_EV5_NOT_REC;
+
+            /* Send START condition */
+            WRN_printf("Generating I2C start after bus reset on I2CBus%d\n", me->iBus+1);
+            I2C_GenerateSTART(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
+            status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV5_REC);
+            break;
+        }
         default: {
-            status_ = Q_SUPER(&I2CBusMgr_Busy);
+            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
             break;
         }
     }
@@ -1205,77 +798,71 @@ static QState I2CBusMgr_WaitFor_I2C_EV8(I2CBusMgr * const me, QEvt const * const
 }
 
 /**
- * @brief This is a Wait state for polling for EV8 (MSB of the 2 byte address)
- *
- * This state posts an event to check for the
- * I2C_EVENT_MASTER_BYTE_TRANSMITTING (EV8) which is triggerred by
- * sending the MSByte of the memory address of the device in the previous state.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If EV8 occurred, the state sends the LSByte of internal memory address of the
- * device from where we want to read/write.
+ * @brief This state polls selects I2C master.
+ * After a recovering the bus, the it needs to error out properly.  In order to
+ * do this, a new communication has to be attempted.  This state initiates the
+ * communication as if it is going to talk to a slave EEPROM.  An error is
+ * expected and the I2C1_ER_IRQHandler ISR will clear it by calling the
+ * I2C_ErrorEventCallback function.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
  * @return status_: QState type that specifies where the state
  * machine is going next.
  */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_MSB} */
-static QState I2CBusMgr_WaitFor_I2C_EV8_MSB(I2CBusMgr * const me, QEvt const * const e) {
+/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC} ....*/
+static QState I2CBusMgr_PollFor_I2C_EV5_REC(I2CBusMgr * const me, QEvt const * const e) {
     QState status_;
     switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_MSB} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC} */
         case Q_ENTRY_SIG: {
-            /* Directly post an event to this AO to check for EV8 event. Post directly
-             * instead of publishing so we don't waste memory */
+            /* Directly post a static event to this AO so we don't waste memory */
             static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
             QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_MSB::I2C_CHECK_EV} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV} */
         case I2C_CHECK_EV_SIG: {
-            /* Check if EV6 has happened.  If it has, go on to the next state.  Otherwise,
+            /* Check if EV5 has happened.  If it has, go on to the next state.  Otherwise,
              * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_MSB::I2C_CHECK_EV::[EV8?]} */
-            if (I2C_CheckEvent( s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_BYTE_TRANSMITTING )) {
-                DBG_printf(
-                    "Sending internal LSB addr (0x%02x) to the I2C Device\n",
-                    (uint8_t)(me->addr & 0x00FF)
-                );
+            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[EV5?]} */
+            if (I2C_CheckEvent(s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_MODE_SELECT)) {
+                WRN_printf("Selecting slave device on I2CBus%d\n", me->iBus+1);
+
+                me->errorCode = ERR_I2CBUS_RCVRY_EV6_NOT_REC;
+
+                /* Set the direction to transmit the address */
+                I2C_SetDirection( me->iBus,  I2C_Direction_Transmitter);
 
-                /* Send the LSB of the address to the I2C device */
-                I2C_SendData(
-                    s_I2C_Bus[me->iBus].i2c_bus,
-                    (uint8_t)(me->addr & 0x00FF)
+                /* Send slave Address for write */
+                I2C_Send7bitAddress(
+                    s_I2C_Bus[me->iBus].i2c_bus,            // This is always the bus used in this ISR
+                    me->addr,                               // Look up the saved device address on this bus
+                    s_I2C_Bus[me->iBus].bTransDirection     // Direction of data on this bus
                 );
 
                 /* Reset the maximum number of times to poll the I2C bus for an event */
                 me->nI2CLoopTimeout = MAX_I2C_TIMEOUT;
-                status_ = Q_TRAN(&I2CBusMgr_WaitFor_I2C_EV8_LSB);
+                status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_REC);
             }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_MSB::I2C_CHECK_EV::[else]} */
+            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[else]} */
             else {
                 me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_MSB::I2C_CHECK_EV::[else]::[Retriesleft?]} */
+                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[else]::[Retriesleft?]} */
                 if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_WaitFor_I2C_EV8_MSB);
+                    status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV5_REC);
                 }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_MSB::I2C_CHECK_EV::[else]::[else]} */
+                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[else]::[else]} */
                 else {
-                    me->errorCode = ERR_I2CBUS_EV8_NOT_REC;
-                    ERR_printf(
-                        "Didn't see I2C_EVENT_MASTER_BYTE_TRANSMITTING (EV5) for MSB on I2CBus%d, error: 0x%08x\n",
-                        me->iBus+1,
-                        me->errorCode
-                    );
+                    WRN_printf("Expected timeout waiting for EV5 after I2CBus%d recovery\n", me->iBus+1);
                     status_ = Q_TRAN(&I2CBusMgr_Idle);
                 }
             }
             break;
         }
         default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_EV8);
+            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
             break;
         }
     }
@@ -1283,791 +870,139 @@ static QState I2CBusMgr_WaitFor_I2C_EV8_MSB(I2CBusMgr * const me, QEvt const * c
 }
 
 /**
- * @brief This is a Wait state for polling for EV8 (LSB of the 2 byte address)
- *
- * This state posts an event to check for the
- * I2C_EVENT_MASTER_BYTE_TRANSMITTING (EV8) which is triggerred by
- * sending the MSByte of the memory address of the device in the previous state.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If EV8 occurred, the state sends the LSByte of internal memory address of the
- * device from where we want to read/write.
+ * @brief This state selects I2C transmitter mode.
+ * After a recovering the bus, the it needs to error out properly.  In order to
+ * do this, a new communication has to be attempted.  This state continues after
+ * previous state, because sometimes the error can happen a little later.
+ * An error is expected and the I2C1_ER_IRQHandler ISR will clear it by
+ * calling the I2C_ErrorEventCallback function.
  *
  * @param  [in,out] me: Pointer to the state machine
  * @param  [in,out] e:  Pointer to the event being processed.
  * @return status_: QState type that specifies where the state
  * machine is going next.
  */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_LSB} */
-static QState I2CBusMgr_WaitFor_I2C_EV8_LSB(I2CBusMgr * const me, QEvt const * const e) {
+/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC} ....*/
+static QState I2CBusMgr_PollFor_I2C_EV6_REC(I2CBusMgr * const me, QEvt const * const e) {
     QState status_;
     switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_LSB} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC} */
         case Q_ENTRY_SIG: {
-            /* Directly post an event to this AO to check for EV8 event. Post directly
-             * instead of publishing so we don't waste memory */
+            /* Directly post a static event to this AO so we don't waste memory */
             static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
             QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_LSB::I2C_CHECK_EV} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV} */
         case I2C_CHECK_EV_SIG: {
             /* Check if EV6 has happened.  If it has, go on to the next state.  Otherwise,
              * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_LSB::I2C_CHECK_EV::[EV8?]} */
-            if (I2C_CheckEvent( s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_BYTE_TRANSMITTING )) {
-                me->errorCode = ERR_NONE;
+            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[EV6(RX)?]} */
+            if (I2C_CheckEvent( s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED )) {
+                WRN_printf("Got expected EV6 after I2CBus%d recovery\n", me->iBus+1);
                 status_ = Q_TRAN(&I2CBusMgr_Idle);
             }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_LSB::I2C_CHECK_EV::[else]} */
+            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[else]} */
             else {
                 me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_LSB::I2C_CHECK_EV::[else]::[Retriesleft?]} */
+                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[else]::[Retriesleft?]} */
                 if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_WaitFor_I2C_EV8_LSB);
+                    status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_REC);
                 }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV8::WaitFor_I2C_EV8_LSB::I2C_CHECK_EV::[else]::[else]} */
+                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[else]::[else]} */
                 else {
-                    me->errorCode = ERR_I2CBUS_EV8_NOT_REC;
-                    ERR_printf(
-                        "Didn't see I2C_EVENT_MASTER_BYTE_TRANSMITTING (EV5) for LSB on I2CBus%d, error: 0x%08x\n",
-                        me->iBus+1,
-                        me->errorCode
-                    );
+                    WRN_printf("Expected timeout waiting for EV6 after I2CBus%d recovery\n", me->iBus+1);
                     status_ = Q_TRAN(&I2CBusMgr_Idle);
                 }
             }
             break;
         }
         default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_EV8);
+            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
             break;
         }
     }
     return status_;
 }
-/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery} .........................*/
-static QState I2CBusMgr_BusRecovery(I2CBusMgr * const me, QEvt const * const e) {
+
+/**
+ * @brief This is a Wait state for a transfer run by the I2C interrupts.
+ *
+ * The I2C event and error ISRs move the whole transfer and post
+ * I2C_BUS_XFER_DONE once it's finished or has failed, so this state only has
+ * to wait for that one event.  If the operation timer fires first, the exit
+ * action stops the transfer and releases the bus.  Either way, the result is
+ * sent back to the I2CxDevMgr AO on exit.
+ *
+ * @param  [in,out] me: Pointer to the state machine
+ * @param  [in,out] e:  Pointer to the event being processed.
+ * @return status_: QState type that specifies where the state
+ * machine is going next.
+ */
+/*${AOs::I2CBusMgr::SM::Active::Busy::WaitForXferDone} .....................*/
+static QState I2CBusMgr_WaitForXferDone(I2CBusMgr * const me, QEvt const * const e) {
     QState status_;
     switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitForXferDone} */
         case Q_ENTRY_SIG: {
+            /* Assume a timeout.  The ISRs record the real result in the descriptor. */
+            me->errorCode = ERR_I2CBUS_XFER_TIMEOUT;
+
             /* Post an operation timer on entry */
             QTimeEvt_rearm(
                 &me->i2cOpTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_BUS_RECOVERY )
+                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_XFER )
             );
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery} */
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitForXferDone} */
         case Q_EXIT_SIG: {
             /* Timer disarmed in parent state */
 
-            /* Allocate a dynamic event to send back the result after attempting to recover
-             * the I2C bus. */
-            I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus = me->iBus;        // set the bus
-
-            /* Check if the bus is free */
-            if ( RESET == I2C_GetFlagStatus( s_I2C_Bus[me->iBus].i2c_bus, I2C_FLAG_BUSY ) ) {
-                me->errorCode = ERR_NONE;
-                DBG_printf("I2CBus%d free after recovery and ready to go.\n", me->iBus+1);
+            /* Only true if the transfer was still running, i.e. we timed out. */
+            if ( I2C_AbortXfer( me->iBus ) ) {
+                ERR_printf(
+                    "Transfer timed out on I2CBus%d after %d interrupts\n",
+                    me->iBus+1,
+                    me->xfer.nIrqs
+                );
+            }
+            me->errorCode = me->xfer.errorCode;
+
+            /* Allocate a dynamic event to send back the result of the transfer.  Data
+             * read into the requester's own buffer is already where it needs to be. */
+            if ( me->xfer.isRead ) {
+                I2CBusDataEvt *i2cBusDataEvt = Q_NEW( I2CBusDataEvt, I2C_BUS_DONE_SIG );
+                i2cBusDataEvt->i2cBus = me->iBus;
+                i2cBusDataEvt->errorCode = me->errorCode;
+                i2cBusDataEvt->dataLen = ( ERR_NONE == me->errorCode
+                    && me->xfer.buf == s_I2C_Bus[me->iBus].pRxBuffer ) ? me->xfer.len : 0;
+                MEMCPY(
+                    i2cBusDataEvt->dataBuf,
+                    s_I2C_Bus[me->iBus].pRxBuffer,
+                    i2cBusDataEvt->dataLen
+                );
+                QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cBusDataEvt, me);
             } else {
-                ERR_printf("Attempt to recover I2CBus%d failed with error: 0x%08x\n", me->iBus+1, me->errorCode);
+                I2CStatusEvt *i2cStatusEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
+                i2cStatusEvt->i2cBus = me->iBus;
+                i2cStatusEvt->errorCode = me->errorCode;
+                QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatusEvt, me);
             }
-            i2cStatEvt->errorCode = me->errorCode; // set the error code that was last recorded.
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
             status_ = Q_HANDLED();
             break;
         }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_Busy);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This state initiates I2C bus recovery.
- * The bus can become stuck if slave device is misbehaving (or not correctly
- * implementing I2C protocol, or simply by being buggy). Most problems on the
- * I2C bus are caused by a timing issue of the STOP bit being sent and the slave
- * ends up locking the bus waiting for the STOP bit to arrive while the bus
- * master is unable to send it.  The only way to really resolve the issue is to
- * either reset the slave (not always possible) or to manually clock the bits in.
- *
- * This state does exactly that.  Upon entry, it changes the GPIO from I2C
- * configuration to regular GPIO and manually toggles the SCL line until the
- * SDA line is released by the slave.
- * On exit, this state reconfigures the GPIO back to I2C configuration.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery} .....*/
-static QState I2CBusMgr_WaitForBusRecovery(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery} */
-        case Q_ENTRY_SIG: {
-            /* Set the pins up for manual toggling */
-            I2C_BusInitForRecovery( me->iBus );
-
-            me->errorCode = ERR_I2CBUS_RCVRY_SDA_STUCK_LOW;
-
-            /* Reset the maximum number of times to poll the I2C bus for an event */
-            me->nI2CLoopTimeout = MAX_I2C_TIMEOUT;
-
-            WRN_printf("Some I2C%d slave device is misbehaving.\n", (me->iBus) + 1);
-            WRN_printf("Attempting to recover bus by toggling the SCL line\n");
-            WRN_printf("This may cause data corruption if the last I2C op was a write\n");
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery} */
-        case Q_EXIT_SIG: {
-            /* Initialize the I2C devices and associated busses */
-            LOG_printf("ReInitializing I2C%d bus.\n", (me->iBus) + 1);
-            I2C_BusInit( me->iBus );
-            status_ = Q_HANDLED();
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This state manually toggles SCL line for I2C bus recovery.
- * The bus can become stuck if slave device is misbehaving (or not correctly
- * implementing I2C protocol, or simply by being buggy). Most problems on the
- * I2C bus are caused by a timing issue of the STOP bit being sent and the slave
- * ends up locking the bus waiting for the STOP bit to arrive while the bus
- * master is unable to send it.  The only way to really resolve the issue is to
- * either reset the slave (not always possible) or to manually clock the bits in.
- *
- * This state manually toggles the SCL line until the SDA line is released
- * by the slave.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL} */
-static QState I2CBusMgr_TogglingSCL(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL} */
-        case Q_ENTRY_SIG: {
-            /* Toggle the SCL bit of the bus to the opposite value that it is now */
-            GPIO_ToggleBits( s_I2C_Bus[me->iBus].scl_port, s_I2C_Bus[me->iBus].scl_pin );
-
-            /* Directly post a static event to this AO so we don't waste memory */
-            static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
-            QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV} */
-        case I2C_CHECK_EV_SIG: {
-            /* Check if bus is busy.  If free, go on to the next state.  Otherwise,
-             * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[BusFree?]} */
-            if (SET == GPIO_ReadInputDataBit( s_I2C_Bus[me->iBus].sda_port, s_I2C_Bus[me->iBus].sda_pin  )) {
-                WRN_printf(
-                    "I2CBus%d free after %d SCL toggles\n",
-                    me->iBus+1,
-                    MAX_I2C_TIMEOUT - me->nI2CLoopTimeout
-                );
-
-                /* Make sure to leave the SCL line high after exit */
-                GPIO_SetBits( s_I2C_Bus[me->iBus].scl_port, s_I2C_Bus[me->iBus].scl_pin );
-
-                /* Reset the maximum number of times to poll the I2C bus for an event */
-                me->nI2CLoopTimeout = MAX_I2C_TIMEOUT;
-                status_ = Q_TRAN(&I2CBusMgr_WaitForBusToSettle);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[else]} */
-            else {
-                me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[else]::[Retriesleft?]} */
-                if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_TogglingSCL);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusRecovery::TogglingSCL::I2C_CHECK_EV::[else]::[else]} */
-                else {
-                    ERR_printf("Timeout waiting for I2CBus%d bus to be free\n", me->iBus+1);
-                    I2C_SoftwareResetCmd(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
-                    I2C_SoftwareResetCmd(s_I2C_Bus[me->iBus].i2c_bus, DISABLE);
-                    DBG_printf("I2C bus reset\n");
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitForBusRecovery);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This state waits for the bus to settle after being reconfigured to I2C.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle} .....*/
-static QState I2CBusMgr_WaitForBusToSettle(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle} */
-        case Q_ENTRY_SIG: {
-            /* Post a timer on entry */
-            QTimeEvt_rearm(
-                &me->i2cBusSettleTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TIME_SEC_I2C_BUS_SETTLE )
-            );
-
-            /* Rearm the main I2C timer for a value that is enough for the current recovery
-             * effort and enough to retry the operation that caused the problem in the first
-             * place */
-            QTimeEvt_rearm(
-                &me->i2cTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TIME_SEC_I2C_BUS_SETTLE + LL_MAX_TOUT_SEC_I2C_BUS_RECOVERY )
-            );
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle} */
-        case Q_EXIT_SIG: {
-            QTimeEvt_disarm( &me->i2cBusSettleTimerEvt );
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::WaitForBusToSettle::I2C_BUS_SETTLE_TIMER} */
-        case I2C_BUS_SETTLE_TIMER_SIG: {
-            WRN_printf(
-                "Finished waiting for I2CBus%d to settle after reset and intentional failure\n",
-                me->iBus+1
-            );
-
-            me->errorCode = ERR_I2CBUS_RCVRY_EV5_NOT_REC;
-
-            /* Send START condition */
-            WRN_printf("Generating I2C start after bus reset on I2CBus%d\n", me->iBus+1);
-            I2C_GenerateSTART(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
-            status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV5_REC);
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This state polls selects I2C master.
- * After a recovering the bus, the it needs to error out properly.  In order to
- * do this, a new communication has to be attempted.  This state initiates the
- * communication as if it is going to talk to a slave EEPROM.  An error is
- * expected and the I2C1_ER_IRQHandler ISR will clear it by calling the
- * I2C1_ErrorEventCallback function.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC} ....*/
-static QState I2CBusMgr_PollFor_I2C_EV5_REC(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC} */
-        case Q_ENTRY_SIG: {
-            /* Directly post a static event to this AO so we don't waste memory */
-            static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
-            QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV} */
-        case I2C_CHECK_EV_SIG: {
-            /* Check if EV5 has happened.  If it has, go on to the next state.  Otherwise,
-             * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[EV5?]} */
-            if (I2C_CheckEvent(s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_MODE_SELECT)) {
-                WRN_printf("Selecting slave device on I2CBus%d\n", me->iBus+1);
-
-                me->errorCode = ERR_I2CBUS_RCVRY_EV6_NOT_REC;
-
-                /* Set the direction to transmit the address */
-                I2C_SetDirection( me->iBus,  I2C_Direction_Transmitter);
-
-                /* Send slave Address for write */
-                I2C_Send7bitAddress(
-                    s_I2C_Bus[me->iBus].i2c_bus,            // This is always the bus used in this ISR
-                    me->addr,                               // Look up the saved device address on this bus
-                    s_I2C_Bus[me->iBus].bTransDirection     // Direction of data on this bus
-                );
-
-                /* Reset the maximum number of times to poll the I2C bus for an event */
-                me->nI2CLoopTimeout = MAX_I2C_TIMEOUT;
-                status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_REC);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[else]} */
-            else {
-                me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[else]::[Retriesleft?]} */
-                if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV5_REC);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV5_REC::I2C_CHECK_EV::[else]::[else]} */
-                else {
-                    WRN_printf("Expected timeout waiting for EV5 after I2CBus%d recovery\n", me->iBus+1);
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This state selects I2C transmitter mode.
- * After a recovering the bus, the it needs to error out properly.  In order to
- * do this, a new communication has to be attempted.  This state continues after
- * previous state, because sometimes the error can happen a little later.
- * An error is expected and the I2C1_ER_IRQHandler ISR will clear it by
- * calling the I2C1_ErrorEventCallback function.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC} ....*/
-static QState I2CBusMgr_PollFor_I2C_EV6_REC(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC} */
-        case Q_ENTRY_SIG: {
-            /* Directly post a static event to this AO so we don't waste memory */
-            static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
-            QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV} */
-        case I2C_CHECK_EV_SIG: {
-            /* Check if EV6 has happened.  If it has, go on to the next state.  Otherwise,
-             * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[EV6(RX)?]} */
-            if (I2C_CheckEvent( s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED )) {
-                WRN_printf("Got expected EV6 after I2CBus%d recovery\n", me->iBus+1);
-                status_ = Q_TRAN(&I2CBusMgr_Idle);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[else]} */
-            else {
-                me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[else]::[Retriesleft?]} */
-                if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_REC);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::BusRecovery::PollFor_I2C_EV6_REC::I2C_CHECK_EV::[else]::[else]} */
-                else {
-                    WRN_printf("Expected timeout waiting for EV6 after I2CBus%d recovery\n", me->iBus+1);
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_BusRecovery);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This is a Wait state for reading the internal memory of some device
- * on an I2C bus.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead} .................*/
-static QState I2CBusMgr_WaitFor_I2C_MemRead(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead} */
-        case Q_ENTRY_SIG: {
-            /* Post an operation timer on entry */
-            QTimeEvt_rearm(
-                &me->i2cOpTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_MEM_READ )
-            );
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead} */
-        case Q_EXIT_SIG: {
-            /* Timer disarmed in parent state */
-
-            /* Allocate a dynamic event to send back the result after attempting to recover
-             * the I2C bus. */
-            I2CBusDataEvt *i2cBusDataEvt = Q_NEW( I2CBusDataEvt, I2C_BUS_DONE_SIG );
-            i2cBusDataEvt->i2cBus = me->iBus;
-            i2cBusDataEvt->errorCode = me->errorCode;
-            i2cBusDataEvt->dataLen = s_I2C_Bus[I2CBus1].nBytesExpected;
-            MEMCPY(
-                i2cBusDataEvt->dataBuf,
-                s_I2C_Bus[I2CBus1].pRxBuffer,
-                i2cBusDataEvt->dataLen
-            );
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cBusDataEvt, me);
-            status_ = Q_HANDLED();
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_Busy);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This is a Wait state for DMA I2C read.
- *
- * This state issues a DMA read command which does all the work and posts a timer
- * to make sure it happens in a timely manner.  The callback from the ISR for the
- * associated DMA stream will post the event with the read data, which will also
- * take the state machine out of this state and back to Idle.
- *
- * @note: this state is READ operation specific.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::WaitForDMAReadDone} */
-static QState I2CBusMgr_WaitForDMAReadDone(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::WaitForDMAReadDone} */
-        case Q_ENTRY_SIG: {
-            /* Reset the number of bytes already read to 0 */
-            s_I2C_Bus[me->iBus].nBytesCurrent = 0;
-
-            /* Start the DMA read operation */
-            I2C_StartDMARead(
-                me->iBus,
-                s_I2C_Bus[me->iBus].nBytesExpected
-            );
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::WaitForDMAReadDone::I2C_BUS_OP_TOUT} */
-        case I2C_BUS_OP_TOUT_SIG: {
-            ERR_printf("DMA READ Operation timeout on I2CBus%d.  Error: 0x%08x\n", me->iBus+1, me->errorCode);
-
-            /* These operations are bus specific */
-            if ( I2CBus1 == me->iBus ) {
-                ERR_printf("DMA1_St0 fifo is at %d\n", DMA_GetFIFOStatus(DMA1_Stream0) );
-                ERR_printf("DMA1_St0 TC flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_IT_TCIF0) );
-                ERR_printf("DMA1_St0 FE flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_FEIF0) );
-                ERR_printf("DMA1_St0 DM flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_DMEIF0) );
-                ERR_printf("DMA1_St0 TE flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_TEIF0) );
-                ERR_printf("DMA1_St0 HT flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_HTIF0) );
-
-
-                if (DMA_GetCmdStatus(DMA1_Stream0)== ENABLE) {
-                    ERR_printf("DMA1_Stream0 still enabled, turning off\n");
-                    DMA_Cmd( DMA1_Stream0, DISABLE );
-                }
-            }
-
-            /* Disable Acknowledgment */
-            I2C_AcknowledgeConfig(s_I2C_Bus[me->iBus].i2c_bus, DISABLE);
-
-            I2C_GenerateSTOP(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
-
-            /* Re-Enable Acknowledgment to be ready for another reception */
-            I2C_AcknowledgeConfig(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
-
-            DBG_printf("Generating I2C stop\n");
-            status_ = Q_TRAN(&I2CBusMgr_Idle);
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::WaitForDMAReadDone::I2C_BUS_DMA_DONE} */
-        case I2C_BUS_DMA_DONE_SIG: {
-            DBG_printf("Got I2C_BUS_DMA_DONE on I2CBus%d\n", me->iBus+1);
-            me->errorCode = ERR_NONE; // Everything went fine if this signal is received
-            status_ = Q_TRAN(&I2CBusMgr_Idle);
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_MemRead);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This is a Wait state for polling for reading I2C bytes manually.
- *
- * This state posts an event to check for the I2C_FLAG_RXNE flag has been set
- * which indicates that I2C data is ready to be read out.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If data is ready to read, the state machine reads the byte of data and stores
- * it in the buffer.  It then checks whether there is 1 byte left to read and if
- * so, issues a STOP bit on the bus.  This is due to a bug in the STM32 I2C IP
- * which requires that the STOP bit be sent before the last byte is read out.
- *
- * @note: this state is READ operation specific.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte} ....*/
-static QState I2CBusMgr_ReadI2CByte(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte} */
-        case Q_ENTRY_SIG: {
-            /* Directly post an event to this AO to check for EV8 event. Post directly
-             * instead of publishing so we don't waste memory */
-            static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
-            QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV} */
-        case I2C_CHECK_EV_SIG: {
-            /* Check if EV6 has happened.  If it has, go on to the next state.  Otherwise,
-             * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV::[ReadyToRead?]} */
-            if (RESET != I2C_GetFlagStatus( s_I2C_Bus[me->iBus].i2c_bus, I2C_FLAG_RXNE )) {
-                /* Reset the maximum number of times to poll the I2C bus for an event */
-                me->nI2CLoopTimeout = MAX_I2C_TIMEOUT;
-
-                s_I2C_Bus[me->iBus].pRxBuffer[s_I2C_Bus[me->iBus].nBytesCurrent++] =
-                    I2C_ReceiveData(s_I2C_Bus[me->iBus].i2c_bus);
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV::[ReadyToRead?]::[>1byteleft?]} */
-                if ((s_I2C_Bus[me->iBus].nBytesExpected - s_I2C_Bus[me->iBus].nBytesCurrent) > 1) {
-                    status_ = Q_TRAN(&I2CBusMgr_ReadI2CByte);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV::[ReadyToRead?]::[1byteleft?]} */
-                else if (1 == (s_I2C_Bus[me->iBus].nBytesExpected - s_I2C_Bus[me->iBus].nBytesCurrent)) {
-                    DBG_printf("Done Reading\n");
-                    I2C_AcknowledgeConfig( s_I2C_Bus[me->iBus].i2c_bus, DISABLE); /* Disable Acknowledgment */
-                    I2C_GenerateSTOP(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);        /* Generate Stop */
-                    status_ = Q_TRAN(&I2CBusMgr_ReadI2CByte);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV::[ReadyToRead?]::[else]} */
-                else {
-                    I2C_AcknowledgeConfig(s_I2C_Bus[me->iBus].i2c_bus, ENABLE); /* Re-enable Acknowledgment */
-                    DBG_printf("Done reading I2C data\n");
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV::[else]} */
-            else {
-                me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV::[else]::[Retriesleft?]} */
-                if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_ReadI2CByte);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemRead::ReadI2CByte::I2C_CHECK_EV::[else]::[else]} */
-                else {
-                    ERR_printf("Timeout waiting for I2C_FLAG_RXNE on I2CBus%d\n", me->iBus+1);
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_MemRead);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This is a Wait state for polling for selecting transmitter mode (I2C
- * EV6).
- * This state is a Timeout/Wait state for the polling child state for MASTER
- * TRANSMITTER MODE on the I2C bus.  It takes care of the timeout and sending a
- * result to anyone who is listening for this event.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX} ..................*/
-static QState I2CBusMgr_WaitFor_I2C_EV6_RX(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX} */
-        case Q_ENTRY_SIG: {
-            /* Set error code that will be reported if things timeout or run out of retries */
-            me->errorCode = ERR_I2CBUS_EV6_TIMEOUT;
-
-            /* Post an operation timer on entry */
-            QTimeEvt_rearm(
-                &me->i2cOpTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_BASIC_OP )
-            );
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX} */
-        case Q_EXIT_SIG: {
-            /* Timer disarmed in parent state */
-
-            /* Allocate a dynamic event to directly post to the proper I2CxDevMgr AO */
-            I2CStatusEvt* i2cStatEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatEvt->i2cBus       = me->iBus;      // set the bus
-            i2cStatEvt->errorCode    = me->errorCode; // set the error code that was last recorded.
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatEvt, me); // directly post the event to the correct AO
-            status_ = Q_HANDLED();
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_Busy);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This is a Poll state for polling for MASTER MODE (I2C EV5).
- *
- * This state posts an event to check for the I2C_EVENT_MASTER_MODE_SELECT (EV5)
- * which is triggerred by posting a START bit on the I2C bus. It also checks if
- * the system is out of retries for this action and exits if true.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX::PollFor_I2C_EV6_RX} */
-static QState I2CBusMgr_PollFor_I2C_EV6_RX(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX::PollFor_I2C_EV6_RX} */
-        case Q_ENTRY_SIG: {
-            /* Directly post an event to this AO to check for EV5 event. Post directly
-             * instead of publishing so we don't waste memory */
-            static QEvt const qEvt = { I2C_CHECK_EV_SIG, 0U, 0U };
-            QACTIVE_POST(AO_I2CBusMgr[me->iBus], &qEvt, me);
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX::PollFor_I2C_EV6_RX::I2C_CHECK_EV} */
-        case I2C_CHECK_EV_SIG: {
-            /* Check if EV5 has happened.  If it has, go on to the next state.  Otherwise,
-             * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX::PollFor_I2C_EV6_RX::I2C_CHECK_EV::[EV6(RX)?]} */
-            if (I2C_CheckEvent( s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED )) {
-                me->errorCode = ERR_NONE;
-                status_ = Q_TRAN(&I2CBusMgr_Idle);
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX::PollFor_I2C_EV6_RX::I2C_CHECK_EV::[else]} */
-            else {
-                me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX::PollFor_I2C_EV6_RX::I2C_CHECK_EV::[else]::[Retriesleft?]} */
-                if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_PollFor_I2C_EV6_RX);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_EV6_RX::PollFor_I2C_EV6_RX::I2C_CHECK_EV::[else]::[else]} */
-                else {
-                    me->errorCode = ERR_I2CBUS_EV6_NOT_REC;
-                    ERR_printf(
-                        "Didn't see I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED (EV6) on I2CBus%d, error: 0x%08x\n",
-                        me->iBus+1,
-                        me->errorCode
-                    );
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_EV6_RX);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This is a Wait state for writing the internal memory of some device
- * on an I2C bus.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite} ................*/
-static QState I2CBusMgr_WaitFor_I2C_MemWrite(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite} */
-        case Q_ENTRY_SIG: {
-            /* Post an operation timer on entry */
-            QTimeEvt_rearm(
-                &me->i2cOpTimerEvt,
-                SEC_TO_TICKS( LL_MAX_TOUT_SEC_I2C_MEM_WRITE )
-            );
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite} */
-        case Q_EXIT_SIG: {
-            /* Timer disarmed in parent state */
-
-            /* Allocate a dynamic event to send back the result after attempting to recover
-             * the I2C bus. */
-            I2CStatusEvt *i2cStatusEvt = Q_NEW( I2CStatusEvt, I2C_BUS_DONE_SIG );
-            i2cStatusEvt->i2cBus = me->iBus;
-            i2cStatusEvt->errorCode = me->errorCode;
-            QACTIVE_POST(me->p_AO_I2CDevMgr, (QEvt *)i2cStatusEvt, me);
-            status_ = Q_HANDLED();
+        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitForXferDone::I2C_BUS_XFER_DONE} */
+        case I2C_BUS_XFER_DONE_SIG: {
+            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitForXferDone::I2C_BUS_XFER_DONE::[Done?]} */
+            if (I2C_XFER_DONE == me->xfer.phase) {
+                status_ = Q_TRAN(&I2CBusMgr_Idle);
+            }
+            else {
+                status_ = Q_UNHANDLED();
+            }
             break;
         }
         default: {
@@ -2078,175 +1013,6 @@ static QState I2CBusMgr_WaitFor_I2C_MemWrite(I2CBusMgr * const me, QEvt const *
     return status_;
 }
 
-/**
- * @brief This is a Wait state for DMA I2C write.
- *
- * This state issues a DMA write command which does all the work and posts a timer
- * to make sure it happens in a timely manner.  The callback from the ISR for the
- * associated DMA stream will post the event signaling completion, which will also
- * take the state machine out of this state and back to Idle.
- *
- * @note: this state is READ operation specific.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WaitForDMAWriteDone} */
-static QState I2CBusMgr_WaitForDMAWriteDone(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WaitForDMAWriteDone} */
-        case Q_ENTRY_SIG: {
-            /* Reset the number of bytes already read to 0 */
-            s_I2C_Bus[me->iBus].nBytesCurrent = 0;
-
-            DBG_printf(
-                "Issuing a DMA write on I2CBus%d with %d bytes\n",
-                me->iBus+1,
-                s_I2C_Bus[me->iBus].nBytesExpected
-            );
-
-            /* Start the DMA read operation */
-            I2C_StartDMAWrite(
-                me->iBus,
-                s_I2C_Bus[me->iBus].nBytesExpected
-            );
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WaitForDMAWriteDone::I2C_BUS_OP_TOUT} */
-        case I2C_BUS_OP_TOUT_SIG: {
-            ERR_printf("DMA READ Operation timeout on I2CBus%d.  Error: 0x%08x\n", me->iBus+1, me->errorCode);
-
-            /* These operations are bus specific */
-            if ( I2CBus1 == me->iBus ) {
-                ERR_printf("DMA1_St0 fifo is at %d\n", DMA_GetFIFOStatus(DMA1_Stream0) );
-                ERR_printf("DMA1_St0 TC flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_IT_TCIF0) );
-                ERR_printf("DMA1_St0 FE flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_FEIF0) );
-                ERR_printf("DMA1_St0 DM flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_DMEIF0) );
-                ERR_printf("DMA1_St0 TE flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_TEIF0) );
-                ERR_printf("DMA1_St0 HT flag: %d\n", DMA_GetFlagStatus(DMA1_Stream0,DMA_FLAG_HTIF0) );
-
-
-                if (DMA_GetCmdStatus(DMA1_Stream0)== ENABLE) {
-                    ERR_printf("DMA1_Stream0 still enabled, turning off\n");
-                    DMA_Cmd( DMA1_Stream0, DISABLE );
-                }
-            }
-
-            /* Disable Acknowledgment */
-            I2C_AcknowledgeConfig(s_I2C_Bus[me->iBus].i2c_bus, DISABLE);
-
-            I2C_GenerateSTOP(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
-
-            /* Re-Enable Acknowledgment to be ready for another reception */
-            I2C_AcknowledgeConfig(s_I2C_Bus[me->iBus].i2c_bus, ENABLE);
-
-            DBG_printf("Generating I2C stop\n");
-            status_ = Q_TRAN(&I2CBusMgr_Idle);
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WaitForDMAWriteDone::I2C_BUS_DMA_DONE} */
-        case I2C_BUS_DMA_DONE_SIG: {
-            DBG_printf("Got I2C_BUS_DMA_DONE on I2CBus%d\n", me->iBus+1);
-            me->errorCode = ERR_NONE; // Everything went fine if this signal is received
-            status_ = Q_TRAN(&I2CBusMgr_Idle);
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_MemWrite);
-            break;
-        }
-    }
-    return status_;
-}
-
-/**
- * @brief This is a Wait state for polling for writing I2C bytes manually.
- *
- * This state posts an event to check for the I2C_EVENT_MASTER_BYTE_TRANSMITTED
- * I2C event which indicates that I2C data is ready to be written out.
- * It also checks if the system is out of retries for this action and exits
- * if true.
- * If data is ready to write, the state machine writes the byte of data and
- * loops back into the state to wait for next I2C event until no more bytes are
- * left to be written.  It then issues a STOP bit on the I2C bus and returns to
- * Idle.
- *
- * @note: this state is WRITE operation specific.
- * @note: some devices on I2C bus, such as EEPROMs, require a post write delay
- * during which the device will not respond to any data. This should be accounted
- * for by the user of this AO since this AO is not device specific.
- *
- * @param  [in,out] me: Pointer to the state machine
- * @param  [in,out] e:  Pointer to the event being processed.
- * @return status_: QState type that specifies where the state
- * machine is going next.
- */
-/*${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte} ..*/
-static QState I2CBusMgr_WriteI2CByte(I2CBusMgr * const me, QEvt const * const e) {
-    QState status_;
-    switch (e->sig) {
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte} */
-        case Q_ENTRY_SIG: {
-            /* Post an event to check for EV5 event */
-            QEvt *qEvt = Q_NEW(QEvt, I2C_CHECK_EV_SIG);
-            QF_PUBLISH((QEvt *)qEvt, AO_I2CMgr);
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte::I2C_CHECK_EV} */
-        case I2C_CHECK_EV_SIG: {
-            /* Check if EV6 has happened.  If it has, go on to the next state.  Otherwise,
-             * try again until number of retries is out */
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte::I2C_CHECK_EV::[ReadyToWrite?]} */
-            if (I2C_CheckEvent(s_I2C_Bus[me->iBus].i2c_bus, I2C_EVENT_MASTER_BYTE_TRANSMITTED)) {
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte::I2C_CHECK_EV::[ReadyToWrite?]::[Nomorebytes?]} */
-                if (0 == (s_I2C_Bus[me->iBus].nBytesExpected - s_I2C_Bus[me->iBus].nTxIndex)) {
-                    I2C_GenerateSTOP(I2C1, ENABLE);                        /* Generate Stop */
-                    DBG_printf("Done writing I2C data\n");
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte::I2C_CHECK_EV::[ReadyToWrite?]::[else]} */
-                else {
-                    DBG_printf("Writing 0x%02x byte %d to I2C Device\n",
-                        s_I2C_Bus[me->iBus].pTxBuffer[ s_I2C_Bus[me->iBus].nTxIndex ],
-                        s_I2C_Bus[me->iBus].nTxIndex
-                    );
-
-                    /* Send the single byte address to the device */
-                    I2C_SendData(
-                        s_I2C_Bus[me->iBus].i2c_bus,
-                        s_I2C_Bus[me->iBus].pTxBuffer[ s_I2C_Bus[me->iBus].nTxIndex++ ]
-                    );
-                    status_ = Q_TRAN(&I2CBusMgr_WriteI2CByte);
-                }
-            }
-            /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte::I2C_CHECK_EV::[else]} */
-            else {
-                me->nI2CLoopTimeout--;                 /* Decrement counter */
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte::I2C_CHECK_EV::[else]::[Retriesleft?]} */
-                if (me->nI2CLoopTimeout != 0) {
-                    status_ = Q_TRAN(&I2CBusMgr_WriteI2CByte);
-                }
-                /* ${AOs::I2CBusMgr::SM::Active::Busy::WaitFor_I2C_MemWrite::WriteI2CByte::I2C_CHECK_EV::[else]::[else]} */
-                else {
-                    ERR_printf("Timeout waiting for I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED (EV6)\n");
-                    status_ = Q_TRAN(&I2CBusMgr_Idle);
-                }
-            }
-            break;
-        }
-        default: {
-            status_ = Q_SUPER(&I2CBusMgr_WaitFor_I2C_MemWrite);
-            break;
-        }
-    }
-    return status_;
-}
-
 
 /**
  * @} end addtogroup groupI2C
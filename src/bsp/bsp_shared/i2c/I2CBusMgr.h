@@ -21,9 +21,9 @@
  * This state machine handles all I/O on the I2C bus.  It can be instantiated
  * several times with a different bus for a parameter.  This AO doesn't handle
  * any actual I2C devices, just generic I2C bus operations such as sending the
- * start/end bit, waiting for events, initiating DMA reads/writes, etc.  I2C
- * devices should be handled in the I2CXDevMgr AOs.  This allows this AO to be
- * generic and reusable.
+ * start/end bit, waiting for events, initiating DMA or interrupt driven
+ * reads/writes, etc.  I2C devices should be handled in the I2CXDevMgr AOs.
+ * This allows this AO to be generic and reusable.
  *
  * @note 1: If editing this file, please make sure to update the I2CBusMgr.qm
  * model.  The generated code from that model should be very similar to the
@@ -117,10 +117,10 @@ typedef struct {
 } I2CAddrEvt;
 
 /**
- * @brief Event struct type for reading internal memory of an I2C device such as an
- * EEPROM.
+ * @brief Event struct type for running a whole memory read or write on an I2C
+ * device from the I2C interrupts.
  */
-/*${Events::I2CReadMemReqEvt} ..............................................*/
+/*${Events::I2CXferReqEvt} .................................................*/
 typedef struct {
 /* protected: */
     QEvt super;
@@ -128,52 +128,28 @@ typedef struct {
     /**< Which I2C bus the event is for. */
     I2C_Bus_t i2cBus;
 
-    /**< Address on the I2C device to read from. */
-    uint16_t addr;
-
-    /**< Specifies whether the address is 1 byte (8 bit) or 2 bytes (10 or 16 bit) */
-    uint8_t addrSize;
+    /**< Device address in the 8 bit (shifted) form. */
+    uint8_t devAddr;
 
-    /**< Specifies how to access the internal memory of an I2C device:
-     *   @arg I2C_MEM_BYTE
-     *   @arg I2C_MEM_DMA
-     */
-    I2C_MemAccess_t memAccessType;
+    /**< Internal memory address on the I2C device. */
+    uint16_t memAddr;
 
-    /**< How many bytes to read */
-    uint16_t bytes;
-} I2CReadMemReqEvt;
+    /**< Bytes of memory address.  0, 1, or 2 */
+    uint8_t memAddrSize;
 
-/**
- * @brief Event struct type for reading internal memory of an I2C device such as an
- * EEPROM.
- */
-/*${Events::I2CWriteMemReqEvt} .............................................*/
-typedef struct {
-/* protected: */
-    QEvt super;
+    /**< Read from the device if true, write to it otherwise. */
+    bool isRead;
 
-    /**< Which I2C bus the event is for. */
-    I2C_Bus_t i2cBus;
-
-    /**< Address on the I2C device to read from. */
-    uint16_t addr;
-
-    /**< Specifies whether the address is 1 byte (8 bit) or 2 bytes (10 or 16 bit) */
-    uint8_t addrSize;
-
-    /**< Specifies how to access the internal memory of an I2C device:
-     *   @arg I2C_MEM_BYTE
-     *   @arg I2C_MEM_DMA
-     */
-    I2C_MemAccess_t memAccessType;
-
-    /**< How many bytes to read */
+    /**< How many bytes to read or write */
     uint16_t bytes;
 
-    /**< Buffer that holds the data. */
+    /**< Data to write.  Unused for reads. */
     uint8_t dataBuf[MAX_I2C_WRITE_LEN];
-} I2CWriteMemReqEvt;
+
+    /**< Where to read the data into or NULL to use the RX buffer of the bus.
+     * Lets a read be longer than MAX_I2C_READ_LEN.  Unused for writes. */
+    uint8_t * pBuf;
+} I2CXferReqEvt;
 
 
 /* Exported constants --------------------------------------------------------*/
@@ -1,6 +1,6 @@
 /*****************************************************************************
-* Model: I2C1DevMgr.qm
-* File:  ./I2C1DevMgr_gen.h
+* Model: I2CDevMgr.qm
+* File:  ./I2CDevMgr_gen.h
 *
 * This code has been generated by QM tool (see state-machine.com/qm).
 * DO NOT EDIT THIS FILE MANUALLY. All your changes will be lost.
@@ -14,11 +14,12 @@
 * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
 * for more details.
 *****************************************************************************/
-/*${.::I2C1DevMgr_gen.h} ...................................................*/
+/*${.::I2CDevMgr_gen.h} ....................................................*/
 /**
- * @file    I2C1DevMgr.h
- * @brief   Declarations for functions for the I2C1DevMgr AO.
- * This state machine handles any device that is attached to the I2C1 bus.
+ * @file    I2CDevMgr.h
+ * @brief   Declarations for functions for the I2CDevMgr AO.
+ * There is one instance of this state machine per I2C bus and each one handles
+ * the devices that the device registry (s_I2C_Dev[]) puts on its bus.
  * This AO doesn't handle the low level I2C commands and instead communicates
  * with I2CBusMgr AO to send the events that kick off the low level I2C cmds.
  * The rationale behind this is that different I2C devices require different
@@ -27,7 +28,7 @@
  * way, the I2C bus logic can stay common and any device differences are
  * handled in the device specific AOs.
  *
- * @note 1: If editing this file, please make sure to update the I2C1DevMgr.qm
+ * @note 1: If editing this file, please make sure to update the I2CDevMgr.qm
  * model.  The generated code from that model should be very similar to the
  * code in this file.
  *
@@ -41,8 +42,8 @@
  */
 
 /* Define to prevent recursive inclusion -------------------------------------*/
-#ifndef I2C1DEVMGR_H_
-#define I2C1DEVMGR_H_
+#ifndef I2CDEVMGR_H_
+#define I2CDEVMGR_H_
 
 /* Includes ------------------------------------------------------------------*/
 #include "qp_port.h"                                        /* for QP support */
@@ -72,6 +73,16 @@ typedef struct {
 
     /**< Which I2C device to read */
     I2C_Dev_t i2cDev;
+
+    /**< Opaque tag chosen by the requester and copied into the done event */
+    uint16_t tag;
+
+    /**< Caller's buffer to read straight into or NULL to get the data in
+     * I2C_DEV_READ_DONE.  Must stay valid until I2C_DEV_READ_DONE comes back. */
+    uint8_t * pBuf;
+
+    /**< AO that I2C_DEV_READ_DONE gets posted to.  Not used for ACCESS_FREERTOS. */
+    QActive * requester;
 } I2CReadReqEvt;
 
 /**
@@ -89,13 +100,23 @@ typedef struct {
     uint16_t bytes;
 
     /**< Buffer that holds the data. */
-    uint8_t dataBuf[MAX_I2C_READ_LEN];
+    uint8_t dataBuf[MAX_I2C_WRITE_LEN];
 
     /**< Specifies whether the request came from FreeRTOS thread or another AO */
     AccessType_t accessType;
 
     /**< Which I2C device to read */
     I2C_Dev_t i2cDev;
+
+    /**< Opaque tag chosen by the requester and copied into the done event */
+    uint16_t tag;
+
+    /**< Caller's data to write or NULL if it's in dataBuf.  Must stay valid
+     * until I2C_DEV_WRITE_DONE comes back. */
+    uint8_t const * pBuf;
+
+    /**< AO that I2C_DEV_WRITE_DONE gets posted to.  Not used for ACCESS_FREERTOS. */
+    QActive * requester;
 } I2CWriteReqEvt;
 
 /**
@@ -117,6 +138,12 @@ typedef struct {
 
     /**< Which I2C device was accessed */
     I2C_Dev_t i2cDev;
+
+    /**< Tag of the request this is the result of */
+    uint16_t tag;
+
+    /**< Caller's buffer the data was read into or NULL if it's in dataBuf */
+    uint8_t * pBuf;
 } I2CReadDoneEvt;
 
 /**
@@ -135,29 +162,52 @@ typedef struct {
 
     /**< Which I2C device was accessed */
     I2C_Dev_t i2cDev;
+
+    /**< Tag of the request this is the result of */
+    uint16_t tag;
 } I2CWriteDoneEvt;
 
+/**
+ * @brief Event struct type for a FreeRTOS thread to take back the buffer of a
+ * request it gave up waiting on.
+ */
+/*${Events::I2CCancelEvt} ..................................................*/
+typedef struct {
+/* protected: */
+    QEvt super;
+
+    /**< Which I2C device the request was for */
+    I2C_Dev_t i2cDev;
+
+    /**< Tag of the request */
+    uint16_t tag;
+
+    /**< Whether the request was a read or a write */
+    I2C_Operation_t i2cDevOp;
+} I2CCancelEvt;
+
 
 /* Exported constants --------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
 
 /**
- * @brief C "constructor" for I2C1DevMgr "class".
+ * @brief C "constructor" for I2CDevMgr "class".
  * Initializes all the timers and queues used by the AO, sets up a deferral
  * queue, and sets of the first state.
- * @param [in]: none.
+ * @param  [in] iBus: I2C_Bus_t type that specifies which I2C bus this instance
+ * of the AO manages the devices of.
  * @retval: none
  */
-/*${AOs::I2C1DevMgr_ctor} ..................................................*/
-void I2C1DevMgr_ctor(void);
+/*${AOs::I2CDevMgr_ctor} ...................................................*/
+void I2CDevMgr_ctor(I2C_Bus_t iBus);
 
 
 /**< "opaque" pointer to the Active Object */
-extern QActive * const AO_I2C1DevMgr;
+extern QActive * const AO_I2CDevMgr[MAX_I2C_BUS];
 
 
 /**
  * @} end addtogroup groupI2C
  */
-#endif                                                       /* I2C1DEVMGR_H_ */
+#endif                                                       /* I2CDEVMGR_H_ */
 /******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
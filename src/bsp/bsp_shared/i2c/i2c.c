@@ -95,8 +95,6 @@ I2C_BusSettings_t s_I2C_Bus[MAX_I2C_BUS] =
 
             /* TX I2C DMA settings */
             DMA1_Stream6,              /**< i2c_dma_tx_stream */
-            DMA1_Stream6_IRQn,         /**< i2c_dma_tx_irq_num */
-            DMA1_Stream6_PRIO,         /**< i2c_dma_tx_irq_prio */
             DMA_FLAG_TCIF6 |
             DMA_FLAG_FEIF6 |
             DMA_FLAG_DMEIF6 |
@@ -105,8 +103,6 @@ I2C_BusSettings_t s_I2C_Bus[MAX_I2C_BUS] =
 
             /* RX I2C DMA settings */
             DMA1_Stream0,              /**< i2c_dma_rx_stream */
-            DMA1_Stream0_IRQn,         /**< i2c_dma_rx_irq_num */
-            DMA1_Stream0_PRIO,         /**< i2c_dma_rx_irq_prio */
             DMA_FLAG_TCIF0 |
             DMA_FLAG_FEIF0 |
             DMA_FLAG_DMEIF0 |
@@ -126,6 +122,16 @@ I2C_BusSettings_t s_I2C_Bus[MAX_I2C_BUS] =
       }
 };
 
+/**
+ * @brief Traffic counters for the I2C Busses
+ */
+static I2C_Stats_t s_I2C_Stats[MAX_I2C_BUS];
+
+/**
+ * @brief Interrupt driven transfer running on each I2C Bus.  NULL if none.
+ */
+static I2C_Xfer_t * volatile s_I2C_Xfer[MAX_I2C_BUS];
+
 /* Private function prototypes -----------------------------------------------*/
 /**
  * @brief  I2C function to setup up both read and write operations.
@@ -200,6 +206,18 @@ static CBErrorCode I2C_TIMEOUT_UserCallbackRaw(
       int line
 );
 
+/**
+ * @brief  Wrap up an interrupt driven transfer from the I2C ISRs.
+ *
+ * Counts the transfer and posts I2C_BUS_XFER_DONE_SIG to the I2CBusMgr AO of
+ * the bus.  The result stays in the descriptor.
+ *
+ * @param [in] iBus: I2C_Bus_t type specifying the I2C bus of the transfer.
+ *    @arg I2CBus1
+ * @return: None
+ */
+static void I2C_finishXfer( I2C_Bus_t iBus );
+
 /* Private functions ---------------------------------------------------------*/
 
 /******************************************************************************/
@@ -262,6 +280,13 @@ void I2C_BusInit( I2C_Bus_t iBus )
    DMA_DeInit( s_I2C_Bus[iBus].i2c_dma_tx_stream );
 
    /* 4. Set up interrupts -------------------------------------------------- */
+   /* Set up Interrupt controller to handle I2C Event interrupts.  They stay
+    * disabled in the I2C peripheral until I2C_StartXfer() turns them on. */
+   NVIC_Config(
+         s_I2C_Bus[iBus].i2c_ev_irq_num,
+         s_I2C_Bus[iBus].i2c_ev_irq_prio
+   );
+
    /* Set up Interrupt controller to handle I2C Error interrupts */
    NVIC_Config(
          s_I2C_Bus[iBus].i2c_er_irq_num,
@@ -275,17 +300,6 @@ void I2C_BusInit( I2C_Bus_t iBus )
          ENABLE
    );
 
-   /* Initialize the IRQ and priorities for I2C DMA */
-   NVIC_Config(
-         s_I2C_Bus[iBus].i2c_dma_rx_irq_num,
-         s_I2C_Bus[iBus].i2c_dma_rx_irq_prio
-   );
-
-   NVIC_Config(
-         s_I2C_Bus[iBus].i2c_dma_tx_irq_num,
-         s_I2C_Bus[iBus].i2c_dma_tx_irq_prio
-   );
-
    /* I2C configuration */
    I2C_InitTypeDef  I2C_InitStructure;
    I2C_InitStructure.I2C_Mode                = I2C_Mode_I2C; /* Mode for the M24CXX EEPROM used by the STM324x9I-EVAL2 dev kit */
@@ -402,114 +416,47 @@ uint8_t I2C_getDirection( I2C_Bus_t iBus )
 }
 
 /******************************************************************************/
-void I2C_StartDMARead( I2C_Bus_t iBus, uint16_t wReadLen )
+CBErrorCode I2C_StartXfer( I2C_Bus_t iBus, I2C_Xfer_t *xfer )
 {
    /* Check inputs */
    assert_param( IS_I2C_BUS( iBus ) );
 
-   /* Set the structure buffer management for how many bytes to expect and how
-    * many are currently there (none). */
-   s_I2C_Bus[iBus].nBytesExpected = wReadLen;
-   s_I2C_Bus[iBus].nBytesCurrent  = 0;
-   s_I2C_Bus[iBus].nRxIndex       = 0;
-
-   /* Clear out the DMA settings */
-   DMA_Cmd( s_I2C_Bus[iBus].i2c_dma_rx_stream, DISABLE );
-   DMA_DeInit( s_I2C_Bus[iBus].i2c_dma_rx_stream );
-
-   /* Set up a new DMA structure for reading */
-   DMA_InitTypeDef    DMA_InitStructure;
-   DMA_InitStructure.DMA_Channel             = s_I2C_Bus[iBus].i2c_dma_channel;
-   DMA_InitStructure.DMA_PeripheralBaseAddr  = s_I2C_Bus[iBus].i2c_dma_dr_addr;
-   DMA_InitStructure.DMA_DIR                 = DMA_DIR_PeripheralToMemory;
-   DMA_InitStructure.DMA_PeripheralInc       = DMA_PeripheralInc_Disable;
-   DMA_InitStructure.DMA_MemoryInc           = DMA_MemoryInc_Enable;
-   DMA_InitStructure.DMA_PeripheralDataSize  = DMA_PeripheralDataSize_Byte;
-   DMA_InitStructure.DMA_MemoryDataSize      = DMA_MemoryDataSize_Byte;
-   DMA_InitStructure.DMA_Mode                = DMA_Mode_Normal;
-   DMA_InitStructure.DMA_Priority            = DMA_Priority_VeryHigh;
-   DMA_InitStructure.DMA_FIFOMode            = DMA_FIFOMode_Enable;
-   DMA_InitStructure.DMA_FIFOThreshold       = DMA_FIFOThreshold_Full;
-   DMA_InitStructure.DMA_MemoryBurst         = DMA_MemoryBurst_Single;
-   DMA_InitStructure.DMA_PeripheralBurst     = DMA_PeripheralBurst_Single;
-   DMA_InitStructure.DMA_Memory0BaseAddr     = (uint32_t)s_I2C_Bus[iBus].pRxBuffer;
-   DMA_InitStructure.DMA_BufferSize          = s_I2C_Bus[iBus].nBytesExpected;
-
-   DBG_printf("Attempting to read via DMA %d bytes\n", DMA_InitStructure.DMA_BufferSize);
-
-   /* Initialize the DMA with the filled in structure */
-   DMA_Init( s_I2C_Bus[iBus].i2c_dma_rx_stream, &DMA_InitStructure );
-
-   /* Enable the TransferComplete interrupt in the DMA */
-   DMA_ITConfig( s_I2C_Bus[iBus].i2c_dma_rx_stream, DMA_IT_TC, ENABLE );
-
-   /* Clear any pending flags on RX Stream */
-   DMA_ClearFlag(
-         s_I2C_Bus[iBus].i2c_dma_rx_stream,
-         s_I2C_Bus[iBus].i2c_dma_rx_flags
-   );
-
-   /* I2Cx DMA Enable */
-   I2C_DMACmd( s_I2C_Bus[iBus].i2c_bus, ENABLE );
-
-   /* Finally, activate DMA */
-   DMA_Cmd( s_I2C_Bus[iBus].i2c_dma_rx_stream, ENABLE );
-
+   s_I2C_Xfer[iBus] = xfer;
+   CBErrorCode status = I2CXfer_start( xfer, s_I2C_Bus[iBus].i2c_bus );
+   if ( ERR_NONE != status ) {
+      s_I2C_Xfer[iBus] = NULL;
+   }
+   return( status );
 }
 
 /******************************************************************************/
-void I2C_StartDMAWrite( I2C_Bus_t iBus, uint16_t wWriteLen )
+bool I2C_AbortXfer( I2C_Bus_t iBus )
 {
    /* Check inputs */
    assert_param( IS_I2C_BUS( iBus ) );
 
-   /* Set the structure buffer management for how many bytes to expect and how
-    * many are currently there (none). */
-   s_I2C_Bus[iBus].nBytesExpected = wWriteLen;
-   s_I2C_Bus[iBus].nBytesCurrent  = 0;
-   s_I2C_Bus[iBus].nTxIndex       = 0;
+   bool wasRunning = false;
 
-   /* Clear out the DMA settings */
-   DMA_Cmd( s_I2C_Bus[iBus].i2c_dma_tx_stream, DISABLE );
-   DMA_DeInit( s_I2C_Bus[iBus].i2c_dma_tx_stream );
+   /* Keep the ISRs of this bus from touching the descriptor meanwhile */
+   NVIC_DisableIRQ( s_I2C_Bus[iBus].i2c_ev_irq_num );
+   NVIC_DisableIRQ( s_I2C_Bus[iBus].i2c_er_irq_num );
 
-   /* Set up a new DMA structure for reading */
-   DMA_InitTypeDef    DMA_InitStructure;
-   DMA_InitStructure.DMA_Channel             = s_I2C_Bus[iBus].i2c_dma_channel;
-   DMA_InitStructure.DMA_PeripheralBaseAddr  = s_I2C_Bus[iBus].i2c_dma_dr_addr;
-   DMA_InitStructure.DMA_DIR                 = DMA_DIR_MemoryToPeripheral;
-   DMA_InitStructure.DMA_PeripheralInc       = DMA_PeripheralInc_Disable;
-   DMA_InitStructure.DMA_MemoryInc           = DMA_MemoryInc_Enable;
-   DMA_InitStructure.DMA_PeripheralDataSize  = DMA_PeripheralDataSize_Byte;
-   DMA_InitStructure.DMA_MemoryDataSize      = DMA_MemoryDataSize_Byte;
-   DMA_InitStructure.DMA_Mode                = DMA_Mode_Normal;
-   DMA_InitStructure.DMA_Priority            = DMA_Priority_VeryHigh;
-   DMA_InitStructure.DMA_FIFOMode            = DMA_FIFOMode_Enable;
-   DMA_InitStructure.DMA_FIFOThreshold       = DMA_FIFOThreshold_Full;
-   DMA_InitStructure.DMA_MemoryBurst         = DMA_MemoryBurst_Single;
-   DMA_InitStructure.DMA_PeripheralBurst     = DMA_PeripheralBurst_Single;
-   DMA_InitStructure.DMA_Memory0BaseAddr     = (uint32_t)s_I2C_Bus[iBus].pTxBuffer;
-   DMA_InitStructure.DMA_BufferSize          = s_I2C_Bus[iBus].nBytesExpected;
-
-   DBG_printf("Attempting to write via DMA %d bytes\n", DMA_InitStructure.DMA_BufferSize);
-
-   /* Initialize the DMA with the filled in structure */
-   DMA_Init( s_I2C_Bus[iBus].i2c_dma_tx_stream, &DMA_InitStructure );
-
-   /* Enable the TransferComplete interrupt in the DMA */
-   DMA_ITConfig( s_I2C_Bus[iBus].i2c_dma_tx_stream, DMA_IT_TC, ENABLE );
-
-   /* Clear any pending flags on RX Stream */
-   DMA_ClearFlag(
-         s_I2C_Bus[iBus].i2c_dma_tx_stream,
-         s_I2C_Bus[iBus].i2c_dma_tx_flags
-   );
+   if ( NULL != s_I2C_Xfer[iBus] ) {
+      wasRunning = I2CXfer_abort(
+            s_I2C_Xfer[iBus],
+            s_I2C_Bus[iBus].i2c_bus,
+            ERR_I2CBUS_XFER_TIMEOUT
+      );
+      s_I2C_Xfer[iBus] = NULL;
+   }
 
-   /* I2Cx DMA Enable */
-   I2C_DMACmd( s_I2C_Bus[iBus].i2c_bus, ENABLE );
+   NVIC_EnableIRQ( s_I2C_Bus[iBus].i2c_ev_irq_num );
+   NVIC_EnableIRQ( s_I2C_Bus[iBus].i2c_er_irq_num );
 
-   /* Finally, activate DMA */
-   DMA_Cmd( s_I2C_Bus[iBus].i2c_dma_tx_stream, ENABLE );
+   if ( wasRunning ) {
+      s_I2C_Stats[iBus].nTimeouts++;
+   }
+   return( wasRunning );
 }
 
 /******************************************************************************/
@@ -524,6 +471,15 @@ char* I2C_busToStr( I2C_Bus_t iBus )
    }
 }
 
+/******************************************************************************/
+const I2C_Stats_t* I2C_getStats( I2C_Bus_t iBus )
+{
+   /* Check inputs */
+   assert_param( IS_I2C_BUS( iBus ) );
+
+   return( &s_I2C_Stats[iBus] );
+}
+
 /******************************************************************************/
 /***                      Blocking functions for I2C                        ***/
 /* These functions block when called and should only be called before any AOs */
@@ -540,6 +496,8 @@ CBErrorCode I2C_readBufferBLK(
       uint16_t bytesToRead
 )
 {
+   const uint16_t bytesToReadTotal = bytesToRead;      /* For the statistics */
+
    /* Call the common setup for reads and writes for memory devices on I2C */
    CBErrorCode status = I2C_setupMemRW(
          iBus,
@@ -548,7 +506,7 @@ CBErrorCode I2C_readBufferBLK(
          i2cMemAddrSize
    );
    if ( ERR_NONE != status ) {
-      return I2C_TIMEOUT_UserCallback(iBus, status);
+      return( status );             /* Already reported by I2C_setupMemRW() */
    }
 
    /*!< Send STRAT condition a second time */
@@ -618,6 +576,9 @@ CBErrorCode I2C_readBufferBLK(
    /*!< Re-Enable Acknowledgement to be ready for another reception */
    I2C_AcknowledgeConfig(s_I2C_Bus[iBus].i2c_bus, ENABLE);
 
+   s_I2C_Stats[iBus].nReads++;
+   s_I2C_Stats[iBus].nBytesRead += bytesToReadTotal;
+
    status = ERR_NONE;  /* Just for consistency, set the status and return it. */
    return( status );
 }
@@ -680,7 +641,7 @@ CBErrorCode I2C_writeBufferBLK(
       );
 
       if ( ERR_NONE != status ) {
-         return I2C_TIMEOUT_UserCallback(iBus, status);
+         return( status );        /* Already reported by I2C_writePageBLK() */
       }
 
       /* Update the address and the pointer in the buffer for next iteration */
@@ -688,6 +649,9 @@ CBErrorCode I2C_writeBufferBLK(
       bufferIndex += writeSizeCurr;
    }
 
+   s_I2C_Stats[iBus].nWrites++;
+   s_I2C_Stats[iBus].nBytesWritten += bytesToWrite;
+
    return( status );
 }
 
@@ -709,7 +673,7 @@ static CBErrorCode I2C_writePageBLK(
          i2cMemAddrSize
    );
    if ( ERR_NONE != status ) {
-      return I2C_TIMEOUT_UserCallback(iBus, status);
+      return( status );             /* Already reported by I2C_setupMemRW() */
    }
 
    while( bytesToWrite ) {
@@ -823,131 +787,63 @@ static CBErrorCode I2C_setupMemRW(
 /******************************************************************************/
 
 /******************************************************************************/
-inline void I2C1_DMAReadCallback( void )
+inline void I2C_EventCallback( I2C_Bus_t iBus )
 {
-   /* Test on DMA Stream Transfer Complete interrupt */
-   if ( RESET != DMA_GetITStatus(DMA1_Stream0, DMA_IT_TCIF0) ) {
-      /* Start of STM32 I2C HW bug workaround:
-       * This is a workaround for the STM32 I2C hardware bug.  You have to send
-       * the STOP bit before receiving the last byte.  In the case of DMA xfers,
-       * this means doing it before you shut off the DMA stream.
-       * See the STM32 errata for more details. - HR */
-
-      I2C_AcknowledgeConfig( I2C1, DISABLE);        /* Disable Acknowledgment */
-
-      /* Disable DMA so it doesn't keep outputting the buffer. */
-      //      DMA_Cmd( DMA1_Stream0, DISABLE );
-      I2C_GenerateSTOP(I2C1, ENABLE);                        /* Generate Stop */
-
-      /* Wait for the byte to be received.
-       * Note: There's really no way around waiting for this flag to be reset
-       * outside of the ISR since you have to do this BEFORE you shut off DMA
-       * which has to be done in this ISR. Thankfully, this flag gets reset
-       * fairly quickly (125 times through the loop). - HR. */
-      uint16_t nI2CBusTimeout = MAX_I2C_TIMEOUT;
-      while(I2C_GetFlagStatus(I2C1, I2C_FLAG_RXNE) == RESET) {
-         if((nI2CBusTimeout--) == 0) {
-            ERR_printf("Timeout waiting for I2C Stop bit flag reset!\n");
-
-            /* Error condition.  Make sure to do proper cleanup*/
-            goto I2C1_DMAReadCallback_cleanup;
-         }
-      }
-
-      I2C_AcknowledgeConfig(I2C1, ENABLE);        /* Re-enable Acknowledgment */
-      /* End of STM32 I2C HW bug workaround */
-
-      /* Disable DMA so it doesn't keep outputting the buffer. */
-      DMA_Cmd( DMA1_Stream0, DISABLE );
-
-      /* Don't transport the data with the event.  The appropriate I2CBusMgr AO
-       * will handle copying out the data from the buffers.  Nobody else is
-       * allowed to touch this bus so there's no contention. */
-      static QEvt const qEvt = { I2C_BUS_DMA_DONE_SIG, 0U, 0U };
-      QACTIVE_POST(AO_I2CBusMgr[I2CBus1], &qEvt, AO_I2CBusMgr[I2CBus1]);
-
-      //      DBG_printf("%d loop iters\n", MAX_I2C_TIMEOUT - nI2CBusTimeout);
-
-      /* Tag for a common exit from this handler.  DON'T call return.  Instead, use
-       * goto I2C1_DMAReadCallback_cleanup;
-       * This allows for always correctly clearing the interrupt status bits. Else
-       * things will lock up. */
-      I2C1_DMAReadCallback_cleanup:
-
-      /* Clear DMA Stream Transfer Complete interrupt pending bit */
-      DMA_ClearITPendingBit( DMA1_Stream0, DMA_IT_TCIF0 );
+   I2C_TypeDef *i2c = s_I2C_Bus[iBus].i2c_bus;
+   I2C_Xfer_t *xfer = s_I2C_Xfer[iBus];
+
+   if ( NULL == xfer ) {
+      /* Nobody is waiting on this bus.  Don't let the event keep firing. */
+      i2c->CR2 &= (uint16_t)~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN);
+   } else if ( I2CXfer_onEvent( xfer, i2c ) ) {
+      I2C_finishXfer( iBus );
    }
 }
 
 /******************************************************************************/
-inline void I2C1_DMAWriteCallback( void )
+inline void I2C_ErrorEventCallback( I2C_Bus_t iBus )
 {
-   /* Test on DMA Stream Transfer Complete interrupt */
-   if ( RESET != DMA_GetITStatus(DMA1_Stream6, DMA_IT_TCIF6) ) {
-
-      /* Wait for the byte to be sent over the I2C bus.
-       * Note: There's really no way around waiting for this flag to be reset
-       * outside of the ISR since you have to do this BEFORE you shut off DMA
-       * which has to be done in this ISR. Thankfully, this flag gets reset
-       * fairly quickly (125 times through the loop at 100kHz and 57 at 400kHz).
-       * - HR. */
-      uint16_t nI2CBusTimeout = MAX_I2C_TIMEOUT;
-      while(I2C_GetFlagStatus(I2C1, I2C_FLAG_BTF) == RESET) {
-         if((nI2CBusTimeout--) == 0) {
-            ERR_printf("Timeout waiting for I2C Stop bit flag reset!\n");
-
-            /* Error condition.  Make sure to do proper cleanup*/
-            goto I2C1_DMAWriteCallback_cleanup;
-         }
-      }
+   I2C_TypeDef *i2c = s_I2C_Bus[iBus].i2c_bus;
 
-      I2C_GenerateSTOP(I2C1, ENABLE);                        /* Generate Stop */
-
-      DMA_Cmd( DMA1_Stream6, DISABLE );            /* Disable the DMA stream. */
-
-      /* Directly post event to the correct I2CBusMgr AO instance indicating
-       * that the DMA is finished. Let it decide what to do. */
-      static QEvt const qEvt = { I2C_BUS_DMA_DONE_SIG, 0U, 0U };
-      QACTIVE_POST(AO_I2CBusMgr[I2CBus1], &qEvt, AO_I2CBusMgr[I2CBus1]);
-
-      DBG_printf("%d loop iters\n", MAX_I2C_TIMEOUT - nI2CBusTimeout);
-
-      /* Tag for a common exit from this handler.  DON'T call return.  Instead, use
-       * goto I2C1_DMAWriteCallback_cleanup;
-       * This allows for always correctly clearing the interrupt status bits. Else
-       * things will lock up. */
-      I2C1_DMAWriteCallback_cleanup:
-      /* Clear DMA Stream Transfer Complete interrupt pending bit */
-      DMA_ClearITPendingBit( DMA1_Stream6, DMA_IT_TCIF6 );
+   /* A failed transfer releases the bus itself.  Just report it to the AO. */
+   I2C_Xfer_t *xfer = s_I2C_Xfer[iBus];
+   if ( NULL != xfer && I2CXfer_onError( xfer, i2c ) ) {
+      I2C_finishXfer( iBus );
+      return;
    }
-}
 
-/******************************************************************************/
-inline void I2C1_EventCallback( void )
-{
-   QF_CRIT_STAT_TYPE intStat;
-   BaseType_t lHigherPriorityTaskWoken = pdFALSE;
-
-   QF_ISR_ENTRY(intStat);                        /* inform QF about ISR entry */
-
-   QF_ISR_EXIT(intStat, lHigherPriorityTaskWoken);/* inform QF about ISR exit */
+   /* Read SR1 register to get I2C error */
+   __IO uint16_t regVal = I2C_ReadRegister(i2c, I2C_Register_SR1) & 0xFF00;
+   if (regVal != 0x0000) {
+      /* Clears error flags */
+      i2c->SR1 &= 0x00FF;
+      s_I2C_Stats[iBus].nErrors++;
 
-   /* the usual end of FreeRTOS ISR... */
-   portEND_SWITCHING_ISR(lHigherPriorityTaskWoken);
+      ERR_printf("I2C%d Error: 0x%04x.  Resetting error bits\n", iBus+1, regVal);
+      I2C_BusInit( iBus );
+   }
 }
 
 /******************************************************************************/
-inline void I2C1_ErrorEventCallback( void )
+static void I2C_finishXfer( I2C_Bus_t iBus )
 {
-   /* Read SR1 register to get I2C error */
-   __IO uint16_t regVal = I2C_ReadRegister(I2C1, I2C_Register_SR1) & 0xFF00;
-   if (regVal != 0x0000) {
-      /* Clears error flags */
-      I2C1->SR1 &= 0x00FF;
-
-      ERR_printf("I2C Error: 0x%04x.  Resetting error bits\n", regVal);
-      I2C_BusInit( I2CBus1 );
+   I2C_Xfer_t *xfer = s_I2C_Xfer[iBus];
+   s_I2C_Xfer[iBus] = NULL;
+
+   if ( ERR_NONE != xfer->errorCode ) {
+      s_I2C_Stats[iBus].nErrors++;
+   } else if ( xfer->isRead ) {
+      s_I2C_Stats[iBus].nReads++;
+      s_I2C_Stats[iBus].nBytesRead += xfer->len;
+   } else {
+      s_I2C_Stats[iBus].nWrites++;
+      s_I2C_Stats[iBus].nBytesWritten += xfer->len;
    }
+
+   /* Don't transport the result with the event.  The I2CBusMgr AO owns the
+    * descriptor and reads it from there. */
+   static QEvt const qEvt = { I2C_BUS_XFER_DONE_SIG, 0U, 0U };
+   QACTIVE_POST(AO_I2CBusMgr[iBus], &qEvt, AO_I2CBusMgr[iBus]);
 }
 
 /******************************************************************************/
@@ -959,6 +855,8 @@ static CBErrorCode I2C_TIMEOUT_UserCallbackRaw(
 )
 {
    if ( ERR_NONE != error ) {
+      s_I2C_Stats[iBus].nTimeouts++;
+
       /* Use the slow interface to print out the error and where it occured. */
       err_slow_printf("I2C%d bus error 0x%08x at %s():%d\n", iBus+1, error, func, line);
    }
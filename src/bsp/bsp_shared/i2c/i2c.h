@@ -23,8 +23,26 @@ extern "C" {
 #include "stm32f4xx.h"                                 /* For STM32F4 support */
 #include "bsp.h"
 #include "i2c_defs.h"
+#include "i2c_xfer.h"
 /* Exported defines ----------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct I2C_Stats_t
+ * Running totals of the traffic on an I2C bus.  Counters only ever go up (and
+ * wrap) and are updated from a single context each, so they can be read at any
+ * time without a critical section.
+ */
+typedef struct I2C_Stats
+{
+   uint32_t nReads;                   /**< Reads that completed successfully */
+   uint32_t nWrites;                 /**< Writes that completed successfully */
+   uint32_t nBytesRead;                /**< Bytes read by successful reads */
+   uint32_t nBytesWritten;         /**< Bytes written by successful writes */
+   uint32_t nErrors;         /**< Bus errors reported by the error interrupt */
+   uint32_t nTimeouts;/**< Operations abandoned while waiting on the hardware */
+} I2C_Stats_t;
+
 /* Exported macros -----------------------------------------------------------*/
 /**
  * @brief   Macro to determine if an I2C bus is defined in the system
@@ -33,7 +51,7 @@ extern "C" {
  *    1: Bus exists and is valid
  *    0: Bus doesn't exist or isn't defined
  */
-#define IS_I2C_BUS(BUS) ((BUS) == I2CBus1)
+#define IS_I2C_BUS(BUS) ( (uint32_t)(BUS) < MAX_I2C_BUS )
 
 /**
  * @brief   Macro as a wrapper for the I2C Timeout callback.
@@ -121,41 +139,33 @@ void I2C_SetDirection( I2C_Bus_t iBus,  uint8_t I2C_Direction);
 uint8_t I2C_getDirection( I2C_Bus_t iBus );
 
 /**
- * @brief   Start the DMA read operation on the specified I2C bus.
+ * @brief   Start an interrupt driven transfer on the specified I2C bus.
  *
- * This function kicks off the DMA read operation on the passed in I2C bus.
- * Once the operation has completed, the DMA ISR should call the handler
- * function, which in turn will post the event with the data to whoever is
- * subscribed to it.
+ * The I2C event and error ISRs run the whole transfer and post a single
+ * I2C_BUS_XFER_DONE_SIG to the I2CBusMgr AO of the bus when it is done or has
+ * failed.  The result is in the errorCode of the descriptor.
  *
  * @param [in]  iBus: I2C_Bus_t identifier for I2C bus
  *    @arg  I2CBus1
- * @param [in]  wReadLen: uint16_t for how many bytes to read from the I2C
- * device.
- * @return: None
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.  Must stay valid
+ * until I2C_BUS_XFER_DONE_SIG arrives or I2C_AbortXfer() is called.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the transfer was started.
+ *    @arg ERR_I2CBUS_INVALID_XFER: bad length or memory address size.
  */
-void I2C_StartDMARead( I2C_Bus_t iBus, uint16_t wReadLen );
+CBErrorCode I2C_StartXfer( I2C_Bus_t iBus, I2C_Xfer_t *xfer );
 
 /**
- * @brief   Start the DMA write operation on the specified I2C bus.
+ * @brief   Give up on the interrupt driven transfer on the specified I2C bus.
  *
- * This function kicks off the DMA write operation on the passed in I2C bus.
- * Once the operation has completed, the DMA ISR should call the handler
- * function, which in turn will post the event with the data to whoever is
- * subscribed to it.
+ * Releases the bus and records ERR_I2CBUS_XFER_TIMEOUT in the descriptor.  No
+ * I2C_BUS_XFER_DONE_SIG gets posted for an aborted transfer.
  *
  * @param [in]  iBus: I2C_Bus_t identifier for I2C bus
  *    @arg  I2CBus1
- * @param [in]  wReadLen: uint16_t for how many bytes to write from the I2C
- * device.
- *
- * @note: The data must already be copied into the s_I2C_Bus[iBus].pTxBuffer
- * buffer.  This should happen the moment that the event that kicks off the
- * write (usually I2C_WRITE_START_SIG) gets read from the I2CMgr AO queue.
- *
- * @return: None
+ * @return: bool true if a transfer was still running.
  */
-void I2C_StartDMAWrite( I2C_Bus_t iBus, uint16_t wWriteLen );
+bool I2C_AbortXfer( I2C_Bus_t iBus );
 
 
 /**
@@ -167,6 +177,15 @@ void I2C_StartDMAWrite( I2C_Bus_t iBus, uint16_t wWriteLen );
  */
 char* I2C_busToStr( I2C_Bus_t iBus );
 
+/**
+ * @brief   Get the traffic counters of an I2C bus.
+ *
+ * @param [in]  iBus: I2C_Bus_t identifier to choose bus
+ *    @arg I2CBus1: get the counters of I2CBus1
+ * @return: const I2C_Stats_t pointer to the counters of the bus.
+ */
+const I2C_Stats_t* I2C_getStats( I2C_Bus_t iBus );
+
 /**
  * @brief  Reads a block of data from a memory device on any I2C bus.
  *
@@ -238,71 +257,37 @@ CBErrorCode I2C_writeBufferBLK( /* TODO: does this belong in i2c_dev? */
 /******************************************************************************/
 
 /**
- * @brief   I2C DMA read callback function
- *
- * This function should only be called from the ISR that handles the DMA ISR
- * that handles the DMA stream that handles this functionality.
- *
- * @note: this function is defined as "inline" but not declared as such.  This
- * is so it can be called externally (by the file that contains the actual ISRs)
- * and they can still be inlined so as not incur any function call overhead.
- *
- * @note: There is a I2C1_DMAReadCallback_cleanup tag defined within this
- * handler.  Use it for a common exit from this handler.  DON'T call return.
- * Instead, use
- * goto I2C1_DMAReadCallback_cleanup;
- * This allows for always correctly clearing the interrupt status bits. Else
- * things will lock up.
- *
- * @param   None
- * @return: None
- */
-void I2C1_DMAReadCallback( void );
-
-/**
- * @brief   I2C DMA write callback function
- *
- * This function should only be called from the ISR that handles the DMA ISR
- * that handles the DMA stream that handles this functionality.
- *
- * @note: this function is defined as "inline" but not declared as such.  This
- * is so it can be called externally (by the file that contains the actual ISRs)
- * and they can still be inlined so as not incur any function call overhead.
- *
- * @param   None
- * @return: None
- */
-void I2C1_DMAWriteCallback( void );
-
-/**
- * @brief   I2C1 Error Event callback function
+ * @brief   I2C Error Event callback function
  *
- * This function should only be called from the ISR that handles the I2C1 ISR
- * that handles the I2C bus error interrupts.
+ * This function should only be called from the ISR that handles the bus error
+ * interrupts of the I2C peripheral of @a iBus (e.g. I2C1_ER_IRQHandler).
  *
  * @note: this function is defined as "inline" but not declared as such.  This
  * is so it can be called externally (by the file that contains the actual ISRs)
  * and they can still be inlined so as not incur any function call overhead.
  *
- * @param   None
+ * @param [in] iBus: I2C_Bus_t type specifying the I2C bus.
+ *    @arg I2CBus1
  * @return: None
  */
-void I2C1_ErrorEventCallback( void );
+void I2C_ErrorEventCallback( I2C_Bus_t iBus );
 
 /**
- * @brief   I2C1 Event callback function
+ * @brief   I2C Event callback function
  *
- * This function should only be called from the ISR that handles the I2C1 ISR
- * that handles the I2C1 bus regular event interrupts.
+ * This function should only be called from the ISR that handles the regular
+ * event interrupts of the I2C peripheral of @a iBus (e.g. I2C1_EV_IRQHandler).
+ * It advances the transfer started by I2C_StartXfer() on that bus.
  *
  * @note: this function is defined as "inline" but not declared as such.  This
  * is so it can be called externally (by the file that contains the actual ISRs)
  * and they can still be inlined so as not incur any function call overhead.
  *
- * @param   None
+ * @param [in] iBus: I2C_Bus_t type specifying the I2C bus.
+ *    @arg I2CBus1
  * @return: None
  */
-void I2C1_EventCallback( void );
+void I2C_EventCallback( I2C_Bus_t iBus );
 
 /**
  * @}
@@ -24,6 +24,7 @@ extern "C" {
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
 #include "stm32f4xx.h"                                 /* For STM32F4 support */
 #include "bsp_defs.h"
 #include "Shared.h"
@@ -49,15 +50,6 @@ typedef enum I2C_Operations {
    I2C_OP_REG_WRITE,                   /**< Writing to an I2C device register */
    /* Insert more I2C operations here... */
 } I2C_Operation_t;
-/**
- * I2C device internal memory access types
- */
-typedef enum I2C_MemAccess {
-   I2C_MEM_BYTE  = 0,                   /**< Access memory one byte at a time */
-   I2C_MEM_DMA,                                    /**< Access memory via DMA */
-   /* Insert more I2C access types here... */
-} I2C_MemAccess_t;
-
 /**
  * \enum I2C_Bus_t
  * I2C Busses available on the system.
@@ -110,14 +102,10 @@ typedef struct I2C_BusSettings
 
    /* TX I2C DMA settings */
    DMA_Stream_TypeDef *    i2c_dma_tx_stream;      /**< I2C DMA stream for TX */
-   IRQn_Type               i2c_dma_tx_irq_num;     /**< I2C DMA TX IRQ number */
-   ISR_Priority            i2c_dma_tx_irq_prio;  /**< I2C DMA TX IRQ priority */
    const uint32_t          i2c_dma_tx_flags;            /**< I2C DMA TX Flags */
 
    /* RX I2C DMA settings */
    DMA_Stream_TypeDef *    i2c_dma_rx_stream;      /**< I2C DMA stream for RX */
-   IRQn_Type               i2c_dma_rx_irq_num;     /**< I2C DMA RX IRQ number */
-   ISR_Priority            i2c_dma_rx_irq_prio;  /**< I2C DMA RX IRQ priority */
    const uint32_t          i2c_dma_rx_flags;            /**< I2C DMA TX Flags */
 
    /* Buffer management */
@@ -142,12 +130,14 @@ typedef enum I2C_Devices {
    SN_ROM,
    EUI_ROM,
    /* Insert more I2C device enumerations here... */
-   MAX_I2C_DEV     /**< Maximum number of available I2C devices on I2CBus1 */
+   MAX_I2C_DEV     /**< Maximum number of available I2C devices on all busses */
 } I2C_Dev_t;
 
 /**
  * @brief I2C_DeviceSettings_t
  * Settings for the various I2C devices that are attached to the I2C busses.
+ * The table of these (s_I2C_Dev[]) is the device registry.  Requests for a
+ * device are routed to the I2CDevMgr AO of the bus the registry puts it on.
  */
 typedef struct I2C_DeviceSettings
 {
@@ -163,6 +153,7 @@ typedef struct I2C_DeviceSettings
    const uint16_t          i2c_mem_min_addr;/**< The first address that can be accessed */
    const uint16_t          i2c_mem_max_addr;/**< The last address that can be accessed */
    const uint8_t           i2c_mem_page_size; /**< Size of a page of memory */
+   const bool              i2c_mem_read_only;   /**< Memory can't be written */
 
 } I2C_DevSettings_t;
 
@@ -174,12 +165,7 @@ typedef struct I2C_DeviceSettings
  *    1: Device exists and is valid
  *    0: Device doesn't exist or isn't defined
  */
-#define IS_I2C_DEVICE( DEV )                                                  \
-(                                                                             \
-   (DEV) == EEPROM ||                                                         \
-   (DEV) == SN_ROM ||                                                         \
-   (DEV) == EUI_ROM                                                           \
-)
+#define IS_I2C_DEVICE( DEV )                  ( (uint32_t)(DEV) < MAX_I2C_DEV )
 
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
@@ -22,7 +22,7 @@
 #include "Shared.h"
 #include "stm32f4xx_dma.h"                           /* For STM32 DMA support */
 #include "stm32f4xx_i2c.h"                           /* For STM32 DMA support */
-#include "I2C1DevMgr.h"                    /* For access to the I2C1DevMgr AO */
+#include "I2CDevMgr.h"                     /* For access to the I2CDevMgr AOs */
 #include "cplr.h"
 
 /* Compile-time called macros ------------------------------------------------*/
@@ -32,11 +32,23 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_I2C_DEV ); /* For debug system to ID this modul
 /* Private typedefs ----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
+
+/**< FreeRTOS ticks a thread waits for a reply from an I2CDevMgr AO */
+#define I2C_FRT_WAIT_TICKS \
+   ( (TickType_t)( HL_MAX_TOUT_SEC_I2C_FRT_WAIT * 1000 / portTICK_PERIOD_MS ) )
+
 /* Private variables and Local objects ---------------------------------------*/
 
+/**< Tag of the last request made by a FreeRTOS thread.  A reply with any other
+ * tag is a late reply to a request that already timed out.  Never 0 so the
+ * I2CDevMgr AOs can use 0 for "no cancelled request". */
+static uint16_t l_i2cFrtTag = 0;
+
 /**
  * @brief An internal structure that holds settings for I2C devices on all I2C
- * busses.
+ * busses.  This is the device registry: the bus a device is on here decides
+ * which I2CDevMgr AO instance handles it, so adding a device (on any bus) is
+ * only a matter of adding an entry.
  */
 I2C_DevSettings_t s_I2C_Dev[MAX_I2C_DEV] =
 {
@@ -53,6 +65,7 @@ I2C_DevSettings_t s_I2C_Dev[MAX_I2C_DEV] =
             0x00,                      /**< i2c_mem_min_addr */
             0xFF,                      /**< i2c_mem_max_addr */
             EEPROM_PAGE_SIZE,          /**< i2c_mem_page_size */
+            false,                     /**< i2c_mem_read_only */
       },
       {
             /* "External" device settings */
@@ -67,6 +80,7 @@ I2C_DevSettings_t s_I2C_Dev[MAX_I2C_DEV] =
             0x80,                      /**< i2c_mem_min_addr */
             0x8F,                      /**< i2c_mem_max_addr */
             EEPROM_PAGE_SIZE,          /**< i2c_mem_page_size */
+            true,                      /**< i2c_mem_read_only */
       },
       {
             /* "External" device settings */
@@ -81,12 +95,229 @@ I2C_DevSettings_t s_I2C_Dev[MAX_I2C_DEV] =
             0x98,                      /**< i2c_mem_min_addr */
             0x9F,                      /**< i2c_mem_max_addr */
             EEPROM_PAGE_SIZE / 2,      /**< i2c_mem_page_size */
+            true,                      /**< i2c_mem_read_only */
       },
 };
 
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Check a memory access against the device registry.
+ *
+ * @param [in]  iDev: I2C_Dev_t identifier of the device.
+ * @param [in]  offset: uint16_t offset from the current memory address.
+ * @param [in]  bytes: uint16_t number of bytes to access.
+ * @param [in]  isWrite: bool true if the memory is going to be written.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the access is allowed.
+ *    @arg ERR_I2C_DEV_INVALID_DEVICE: the device isn't in the registry.
+ *    @arg ERR_I2C_DEV_IS_READ_ONLY: a write to a read only device.
+ *    @arg ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY: the access runs past the end of
+ *    the device memory.
+ */
+static CBErrorCode I2C_checkDevAccess(
+      I2C_Dev_t iDev,
+      uint16_t offset,
+      uint16_t bytes,
+      bool isWrite
+);
+
+/**
+ * @brief   Output the error of a device memory access, if there was one.
+ *
+ * Only looks the device up in the registry if it's in there, on a bus that
+ * exists.  The device can come straight from a client request and the
+ * lookups assert on ones that aren't.
+ *
+ * @param [in]  status: CBErrorCode of the access.
+ * @param [in]  accType: AccessType_t of the caller, for how to output it.
+ * @param [in]  isWrite: bool true if the memory was being written.
+ * @param [in]  iDev: I2C_Dev_t identifier of the device.
+ * @param [in]  offset: uint16_t offset from the current memory address.
+ * @return: None
+ */
+static void I2C_devErrOutput(
+      CBErrorCode status,
+      AccessType_t accType,
+      bool isWrite,
+      I2C_Dev_t iDev,
+      uint16_t offset
+);
+
+/**
+ * @brief   Wait for the reply to a request a FreeRTOS thread made.
+ *
+ * The I2CDevMgr AOs put their reply at the front of CPLR_evtQueue so this only
+ * has to look at the front of the queue.  Late replies to requests that timed
+ * out are thrown away.  Requests for the thread that are queued up behind the
+ * reply are left alone.
+ *
+ * @param [in]  sig: QSignal of the reply.
+ *    @arg I2C_DEV_READ_DONE_SIG
+ *    @arg I2C_DEV_WRITE_DONE_SIG
+ * @param [in]  tag: uint16_t tag of the request.
+ * @return: QEvt pointer to the reply, which the caller has to garbage collect,
+ * or NULL if it didn't come back in time.
+ */
+static QEvt const *I2C_waitForReplyFRT( QSignal sig, uint16_t tag );
+
+/**
+ * @brief   Take back the buffer of a request a FreeRTOS thread gave up on.
+ *
+ * The I2CDevMgr AO may still be reading into or writing out of the caller's
+ * buffer, which is about to go out of scope.  This asks the AO to cancel the
+ * request and waits for the reply, which comes right away if the request is
+ * still queued, or once the bus is done with the buffer if it's running.
+ *
+ * @param [in]  iDev: I2C_Dev_t of the request.
+ * @param [in]  op: I2C_Operation_t of the request.
+ *    @arg I2C_OP_MEM_READ
+ *    @arg I2C_OP_MEM_WRITE
+ * @param [in]  tag: uint16_t tag of the request.
+ * @return: QEvt pointer to the reply, which the caller has to garbage collect.
+ * Asserts if that doesn't come back either since returning would leave the
+ * buffer in use.
+ */
+static QEvt const *I2C_cancelFRT(
+      I2C_Dev_t iDev,
+      I2C_Operation_t op,
+      uint16_t tag
+);
+
+/**
+ * @brief   Get the tag for the next request made by a FreeRTOS thread.
+ * @param   None
+ * @return: uint16_t tag.  Never 0.
+ */
+static uint16_t I2C_nextTagFRT( void );
+
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+static QEvt const *I2C_waitForReplyFRT( QSignal sig, uint16_t tag )
+{
+   TickType_t ticksLeft = I2C_FRT_WAIT_TICKS;
+
+   for (;;) {
+      QEvt const *e = CPLR_evtQueue.frontEvt;
+      if ( (QEvt *)0 != e &&
+            ( I2C_DEV_READ_DONE_SIG == e->sig ||
+              I2C_DEV_WRITE_DONE_SIG == e->sig ) ) {
+         e = QEQueue_get( &CPLR_evtQueue );
+
+         uint16_t replyTag = ( I2C_DEV_READ_DONE_SIG == e->sig ) ?
+               ((I2CReadDoneEvt const *)e)->tag :
+               ((I2CWriteDoneEvt const *)e)->tag;
+         if ( sig == e->sig && tag == replyTag ) {
+            return( e );
+         }
+
+         WRN_printf("Dropping late I2C reply %d with tag %d\n", e->sig, replyTag);
+         QF_gc( e );
+         continue;                    /* The next one may be the one we want */
+      }
+
+      if ( 0 == ticksLeft ) {
+         return( (QEvt const *)0 );
+      }
+      --ticksLeft;
+      vTaskDelay( 1 );  /* Let the AOs run.  Replies take several ticks anyway */
+   }
+}
+
+/******************************************************************************/
+static QEvt const *I2C_cancelFRT(
+      I2C_Dev_t iDev,
+      I2C_Operation_t op,
+      uint16_t tag
+)
+{
+   I2CCancelEvt *i2cCancelEvt = Q_NEW(I2CCancelEvt, I2C_DEV_CANCEL_SIG);
+   i2cCancelEvt->i2cDev       = iDev;
+   i2cCancelEvt->tag          = tag;
+   i2cCancelEvt->i2cDevOp     = op;
+
+   /* Ahead of any queued requests so one of them can't be the one to start
+    * using the buffer while this waits. */
+   QACTIVE_POST_LIFO(AO_I2CDevMgr[I2C_getBus( iDev )], (QEvt *)i2cCancelEvt);
+
+   QEvt const *e = I2C_waitForReplyFRT(
+         ( I2C_OP_MEM_READ == op ) ? I2C_DEV_READ_DONE_SIG : I2C_DEV_WRITE_DONE_SIG,
+         tag
+   );
+   Q_ASSERT( (QEvt const *)0 != e );
+   return( e );
+}
+
+/******************************************************************************/
+static uint16_t I2C_nextTagFRT( void )
+{
+   if ( 0 == ++l_i2cFrtTag ) {
+      ++l_i2cFrtTag;
+   }
+   return( l_i2cFrtTag );
+}
+
+/******************************************************************************/
+static CBErrorCode I2C_checkDevAccess(
+      I2C_Dev_t iDev,
+      uint16_t offset,
+      uint16_t bytes,
+      bool isWrite
+)
+{
+   if ( !IS_I2C_DEVICE( iDev ) || !IS_I2C_BUS( s_I2C_Dev[iDev].i2c_bus ) ) {
+      return( ERR_I2C_DEV_INVALID_DEVICE );
+   }
+
+   if ( isWrite && s_I2C_Dev[iDev].i2c_mem_read_only ) {
+      return( ERR_I2C_DEV_IS_READ_ONLY );
+   }
+
+   if ( I2C_getMemAddr( iDev ) + offset + bytes > I2C_getMaxMemAddr( iDev ) + 1 ) {
+      return( ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY );
+   }
+
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+static void I2C_devErrOutput(
+      CBErrorCode status,
+      AccessType_t accType,
+      bool isWrite,
+      I2C_Dev_t iDev,
+      uint16_t offset
+)
+{
+   if ( ERR_NONE == status ) {
+      return;
+   }
+
+   if ( !IS_I2C_DEVICE( iDev ) || !IS_I2C_BUS( s_I2C_Dev[iDev].i2c_bus ) ) {
+      ERR_COND_OUTPUT(
+            status,
+            accType,
+            "Error 0x%08x %s unknown I2C device %d\n",
+            status,
+            isWrite ? "writing" : "reading",
+            iDev
+      );
+      return;
+   }
+
+   ERR_COND_OUTPUT(
+         status,
+         accType,
+         "Error 0x%08x %s I2C device %s on %s at mem addr 0x%02x\n",
+         status,
+         isWrite ? "writing" : "reading",
+         I2C_devToStr(iDev),
+         I2C_busToStr( I2C_getBus(iDev) ),
+         I2C_getMemAddr( iDev ) + offset
+   );
+}
+
 /******************************************************************************/
 uint8_t I2C_getDevAddrSize( I2C_Dev_t iDev )
 {
@@ -193,7 +424,7 @@ CBErrorCode I2C_calcPageWriteSizes(
 )
 {
    /* Check if we are going to write over the end of the eeprom */
-   if (i2cMemAddr + bytesToWrite > I2C_getMaxMemAddr( EEPROM )) {
+   if (i2cMemAddr + bytesToWrite > I2C_getMaxMemAddr( EEPROM ) + 1) {
       return ( ERR_I2C1DEV_MEM_OUT_BOUNDS );
    }
 
@@ -240,60 +471,45 @@ CBErrorCode I2C_readDevMemFRT(
       goto I2C_readDevMemFRT_ERR_HANDLER;  /* Stop and jump to error handling */
    }
 
+   /* Short reads come back in the reply event.  That way a reply that shows
+    * up after this function gave up can't write into a buffer that's gone. */
+   bool isInEvt = ( nBytesToRead <= MAX_I2C_READ_LEN );
+   uint16_t tag = I2C_nextTagFRT();
+
    /* Issue a non-blocking call to read I2C */
    status = I2C_readDevMemEVT(
          iDev,                                        // I2C_Dev_t iDev,
          offset,                                      // uint16_t offset,
          nBytesToRead,                                // uint16_t bytesToRead,
          ACCESS_FREERTOS,                             // AccessType_t accType,
-         (QActive *)NULL                              // QActive* callingAO
+         (QActive *)NULL,                             // QActive* callingAO
+         isInEvt ? NULL : pBuffer,                    // uint8_t* pBuffer
+         tag                                          // uint16_t tag
    );
 
    if( ERR_NONE != status ) {
       goto I2C_readDevMemFRT_ERR_HANDLER;  /* Stop and jump to error handling */
    }
 
-   /* Suspend the task.  Once something has been put into the queue, the AO that
-    * put it there, will wake up this task. */
-   DBG_printf("Suspending Task\n");
-   vTaskSuspend( xHandle_CPLR );
-
-   DBG_printf("Task resumed\n");
-   /* The task has been awakened by the I2CXDevMgr AO because it has put an
-    * event into the raw queue */
-   QEvt const *evtI2CDone = QEQueue_get(&CPLR_evtQueue);
-   if (evtI2CDone != (QEvt *)0 ) {
-      LOG_printf("Found expected event in queue\n");
-      switch( evtI2CDone->sig ) {
-         case I2C1_DEV_READ_DONE_SIG:
-            DBG_printf("Got I2C1_DEV_READ_DONE_SIG\n");
-            *pBytesRead = ((I2CReadDoneEvt *) evtI2CDone)->bytes;
-            status = ((I2CReadDoneEvt *) evtI2CDone)->status;
-            MEMCPY(pBuffer,
-                  ((I2CReadDoneEvt *) evtI2CDone)->dataBuf,
-                  *pBytesRead
-            );
-
-            break;
-         default:
-            WRN_printf("Unknown signal %d\n", evtI2CDone->sig);
-            break;
-      }
-      QF_gc(evtI2CDone);         /* Don't forget to garbage collect the event */
-   } else {
-      WRN_printf("Expected event not found in queue\n");
+   QEvt const *evtI2CDone = I2C_waitForReplyFRT( I2C_DEV_READ_DONE_SIG, tag );
+   if ( (QEvt const *)0 == evtI2CDone && !isInEvt ) {
+      /* The AO may still read into pBuffer.  Get it back before returning. */
+      evtI2CDone = I2C_cancelFRT( iDev, I2C_OP_MEM_READ, tag );
+   }
+   if ( (QEvt const *)0 == evtI2CDone ) {
+      status = ERR_I2C_DEV_REPLY_TIMEOUT;
+      goto I2C_readDevMemFRT_ERR_HANDLER;  /* Stop and jump to error handling */
+   }
+
+   *pBytesRead = ((I2CReadDoneEvt const *) evtI2CDone)->bytes;
+   status = ((I2CReadDoneEvt const *) evtI2CDone)->status;
+   if ( isInEvt && ERR_NONE == status ) {
+      MEMCPY( pBuffer, ((I2CReadDoneEvt const *) evtI2CDone)->dataBuf, *pBytesRead );
    }
+   QF_gc(evtI2CDone);            /* Don't forget to garbage collect the event */
 
 I2C_readDevMemFRT_ERR_HANDLER:    /* Handle any error that may have occurred. */
-   ERR_COND_OUTPUT(
-         status,
-         ACCESS_FREERTOS,
-         "Error 0x%08x reading I2C device %s on %s at mem addr 0x%02x\n",
-         status,
-         I2C_devToStr(iDev),
-         I2C_busToStr( I2C_getBus(iDev) ),
-         I2C_getMemAddr( iDev ) + offset
-   );
+   I2C_devErrOutput( status, ACCESS_FREERTOS, false, iDev, offset );
    return( status );
 }
 
@@ -321,56 +537,40 @@ CBErrorCode I2C_writeDevMemFRT(
       goto I2C_writeDevMemFRT_ERR_HANDLER; /* Stop and jump to error handling */
    }
 
-   /* Issue a non-blocking call to read I2C */
+   uint16_t tag = I2C_nextTagFRT();
+
+   /* Issue a non-blocking call to write I2C */
    status = I2C_writeDevMemEVT(
          iDev,                                        // I2C_Dev_t iDev,
          offset,                                      // uint16_t offset,
          nBytesToWrite,                               // uint16_t bytesToRead,
          ACCESS_FREERTOS,                             // AccessType_t accType,
          (QActive *)NULL,                             // QActive* callingAO
-         pBuffer                                      // uint8_t* pBuffer
+         pBuffer,                                     // uint8_t* pBuffer
+         tag                                          // uint16_t tag
    );
 
    if( ERR_NONE != status ) {
       goto I2C_writeDevMemFRT_ERR_HANDLER; /* Stop and jump to error handling */
    }
 
-   /* Suspend the task.  Once something has been put into the queue, the AO that
-    * put it there, will wake up this task. */
-   DBG_printf("Suspending Task\n");
-   vTaskSuspend( xHandle_CPLR );
-   DBG_printf("Task resumed\n");
-
-   /* The task has been awakened by the I2CXDevMgr AO because it has put an
-    * event into the raw queue */
-   QEvt const *evtI2CDone = QEQueue_get(&CPLR_evtQueue);
-   if (evtI2CDone != (QEvt *)0 ) {
-      LOG_printf("Found expected event in queue\n");
-      switch( evtI2CDone->sig ) {
-         case I2C1_DEV_WRITE_DONE_SIG:
-            DBG_printf("Got I2C1_DEV_WRITE_DONE_SIG\n");
-            *pBytesWritten = ((I2CWriteDoneEvt *) evtI2CDone)->bytes;
-            status = ((I2CWriteDoneEvt *) evtI2CDone)->status;
-            break;
-         default:
-            WRN_printf("Unknown signal %d\n", evtI2CDone->sig);
-            break;
-      }
-      QF_gc(evtI2CDone);         /* Don't forget to garbage collect the event */
-   } else {
-      WRN_printf("Expected event not found in queue\n");
+   QEvt const *evtI2CDone = I2C_waitForReplyFRT( I2C_DEV_WRITE_DONE_SIG, tag );
+   if ( (QEvt const *)0 == evtI2CDone && nBytesToWrite > MAX_I2C_WRITE_LEN ) {
+      /* Too long to go in the request so the AO may still be writing out of
+       * pBuffer.  Get it back before returning. */
+      evtI2CDone = I2C_cancelFRT( iDev, I2C_OP_MEM_WRITE, tag );
+   }
+   if ( (QEvt const *)0 == evtI2CDone ) {
+      status = ERR_I2C_DEV_REPLY_TIMEOUT;
+      goto I2C_writeDevMemFRT_ERR_HANDLER; /* Stop and jump to error handling */
    }
 
+   *pBytesWritten = ((I2CWriteDoneEvt const *) evtI2CDone)->bytes;
+   status = ((I2CWriteDoneEvt const *) evtI2CDone)->status;
+   QF_gc(evtI2CDone);            /* Don't forget to garbage collect the event */
+
 I2C_writeDevMemFRT_ERR_HANDLER:   /* Handle any error that may have occurred. */
-   ERR_COND_OUTPUT(
-         status,
-         ACCESS_FREERTOS,
-         "Error 0x%08x writing I2C device %s on %s at mem addr 0x%02x\n",
-         status,
-         I2C_devToStr(iDev),
-         I2C_busToStr( I2C_getBus(iDev) ),
-         I2C_getMemAddr( iDev ) + offset
-   );
+   I2C_devErrOutput( status, ACCESS_FREERTOS, true, iDev, offset );
    return( status );
 }
 
@@ -380,61 +580,44 @@ CBErrorCode I2C_readDevMemEVT(
       uint16_t offset,
       uint16_t bytesToRead,
       AccessType_t accType,
-      QActive* callingAO
+      QActive* callingAO,
+      uint8_t *pBuffer,
+      uint16_t tag
 )
 {
    CBErrorCode status = ERR_NONE; /* Keep track of the errors that may occur.
                                      This gets returned at the end of the
                                      function */
-   QSignal sig = 0;               /* Signal which will be used in the event to
-                                     be posted. This may change based on which
-                                     AO will be posted to depending on which I2C
-                                     device was passed in */
-   QActive* aoToPostTo = 0;       /* AO to which to directly post the even. This
-                                     will change depending on which I2C device
-                                     was passed in */
 
-   /* Check inputs, requested read boundaries, and figure out which signals will
-    * be used to post the event to which AO. */
-   switch( iDev ) {
-      case EEPROM:                              /* Intentionally fall through */
-      case SN_ROM:                              /* Intentionally fall through */
-      case EUI_ROM:
-         /* These 3 devices are actually part of the same EEPROM chip (and thus
-          * on the same I2C bus) but have different bus addresses.  They can all
-          * be handled by this case. */
-         if ( offset + bytesToRead > I2C_getMaxMemAddr( iDev ) ) {
-            status = ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY;
-            goto I2C_readDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
-         }
-         sig = I2C1_DEV_RAW_MEM_READ_SIG;
-         aoToPostTo = AO_I2C1DevMgr;
-         break;
-      default:
-         status = ERR_I2C_DEV_INVALID_DEVICE;
-         goto I2C_readDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
-         break;
+   /* Only reads into the caller's own buffer can be longer than the done
+    * event can carry. */
+   if ( NULL == pBuffer && bytesToRead > MAX_I2C_READ_LEN ) {
+      status = ERR_MEM_BUFFER_LEN;
+      goto I2C_readDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
+   }
+
+   /* Check inputs and requested read boundaries against the device registry */
+   status = I2C_checkDevAccess( iDev, offset, bytesToRead, false );
+   if ( ERR_NONE != status ) {
+      goto I2C_readDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
    }
 
-   /* Create the event and directly post it to the right AO. */
-   I2CReadReqEvt *i2cReadReqEvt  = Q_NEW(I2CReadReqEvt, sig);
+   /* Create the event and directly post it to the I2CDevMgr AO of the bus the
+    * device is on.  Each bus has its own AO so requests for devices on
+    * different busses run in parallel. */
+   I2CReadReqEvt *i2cReadReqEvt  = Q_NEW(I2CReadReqEvt, I2C_DEV_RAW_MEM_READ_SIG);
    i2cReadReqEvt->i2cDev         = iDev;
    i2cReadReqEvt->addr           = I2C_getMemAddr( iDev ) + offset;
    i2cReadReqEvt->bytes          = bytesToRead;
    i2cReadReqEvt->accessType     = accType;
-   QACTIVE_POST(aoToPostTo, (QEvt *)(i2cReadReqEvt), callingAO);
+   i2cReadReqEvt->tag            = tag;
+   i2cReadReqEvt->pBuf           = pBuffer;
+   i2cReadReqEvt->requester      = callingAO;
+   QACTIVE_POST(AO_I2CDevMgr[I2C_getBus( iDev )], (QEvt *)(i2cReadReqEvt), callingAO);
 
 
 I2C_readDevMemEVT_ERR_HANDLER:    /* Handle any error that may have occurred. */
-   ERR_COND_OUTPUT(
-         status,
-         accType,
-         "Error 0x%08x reading I2C device %s on %s at mem addr 0x%02x\n",
-         status,
-         I2C_devToStr(iDev),
-         I2C_busToStr( I2C_getBus(iDev) ),
-         I2C_getMemAddr( iDev ) + offset
-   );
+   I2C_devErrOutput( status, accType, false, iDev, offset );
    return( status );
 }
 
@@ -445,70 +628,46 @@ CBErrorCode I2C_writeDevMemEVT(
       uint16_t bytesToWrite,
       AccessType_t accType,
       QActive* callingAO,
-      uint8_t *pBuffer
+      uint8_t *pBuffer,
+      uint16_t tag
 )
 {
    CBErrorCode status = ERR_NONE; /* Keep track of the errors that may occur.
                                      This gets returned at the end of the
                                      function */
-   QSignal sig = 0;               /* Signal which will be used in the event to
-                                     be posted. This may change based on which
-                                     AO will be posted to depending on which I2C
-                                     device was passed in */
-   QActive* aoToPostTo = 0;       /* AO to which to directly post the even. This
-                                     will change depending on which I2C device
-                                     was passed in */
 
-   /* Check inputs, requested read boundaries, and figure out which signals will
-    * be used to post the event to which AO. */
-   switch( iDev ) {
-      case EEPROM:
-         /* These 3 devices are actually part of the same EEPROM chip (and thus
-          * on the same I2C bus) but have different bus addresses.  They can all
-          * be handled by this case. */
-         if ( offset + bytesToWrite > I2C_getMaxMemAddr( iDev ) ) {
-            status = ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY;
-            goto I2C_writeDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
-         }
-         sig = I2C1_DEV_RAW_MEM_WRITE_SIG;
-         aoToPostTo = AO_I2C1DevMgr;
-         break;
-
-      case SN_ROM:                              /* Intentionally fall through */
-      case EUI_ROM:
-         status = ERR_I2C_DEV_IS_READ_ONLY;
-         goto I2C_writeDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
-         break;
-      default:
-         status = ERR_I2C_DEV_INVALID_DEVICE;
-         goto I2C_writeDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
-         break;
+   /* Check inputs and requested write boundaries against the device registry */
+   status = I2C_checkDevAccess( iDev, offset, bytesToWrite, true );
+   if ( ERR_NONE != status ) {
+      goto I2C_writeDevMemEVT_ERR_HANDLER;  /* Stop and jump to error handling */
    }
 
-   /* Create the event and directly post it to the right AO. */
-   I2CWriteReqEvt *i2cWriteReqEvt   = Q_NEW(I2CWriteReqEvt, sig);
+   /* Create the event and directly post it to the I2CDevMgr AO of the bus the
+    * device is on. */
+   I2CWriteReqEvt *i2cWriteReqEvt   = Q_NEW(I2CWriteReqEvt, I2C_DEV_RAW_MEM_WRITE_SIG);
    i2cWriteReqEvt->i2cDev           = iDev;
    i2cWriteReqEvt->addr             = I2C_getMemAddr( iDev ) + offset;
    i2cWriteReqEvt->bytes            = bytesToWrite;
    i2cWriteReqEvt->accessType       = accType;
-   MEMCPY(
-         i2cWriteReqEvt->dataBuf,
-         pBuffer,
-         i2cWriteReqEvt->bytes
-   );
-   QACTIVE_POST(aoToPostTo, (QEvt *)(i2cWriteReqEvt), callingAO);
+   i2cWriteReqEvt->tag              = tag;
+   i2cWriteReqEvt->requester        = callingAO;
+   if ( bytesToWrite > MAX_I2C_WRITE_LEN ) {
+      /* Too big for the event.  The I2CDevMgr AO writes it page by page
+       * straight out of the caller's buffer. */
+      i2cWriteReqEvt->pBuf          = pBuffer;
+   } else {
+      i2cWriteReqEvt->pBuf          = NULL;
+      MEMCPY(
+            i2cWriteReqEvt->dataBuf,
+            pBuffer,
+            i2cWriteReqEvt->bytes
+      );
+   }
+   QACTIVE_POST(AO_I2CDevMgr[I2C_getBus( iDev )], (QEvt *)(i2cWriteReqEvt), callingAO);
 
 
 I2C_writeDevMemEVT_ERR_HANDLER:   /* Handle any error that may have occurred. */
-   ERR_COND_OUTPUT(
-         status,
-         accType,
-         "Error 0x%08x writing I2C device %s on %s at mem addr 0x%02x\n",
-         status,
-         I2C_devToStr(iDev),
-         I2C_busToStr( I2C_getBus(iDev) ),
-         I2C_getMemAddr( iDev ) + offset
-   );
+   I2C_devErrOutput( status, accType, true, iDev, offset );
    return( status );
 }
 
@@ -538,22 +697,9 @@ CBErrorCode I2C_readDevMemBLK(
       goto I2C_readDevMemBLK_ERR_HANDLER;  /* Stop and jump to error handling */
    }
 
-   switch( iDev ) {
-      case EEPROM:                              /* Intentionally fall through */
-      case SN_ROM:                              /* Intentionally fall through */
-      case EUI_ROM:
-         /* These 3 devices are actually part of the same EEPROM chip (and thus
-          * on the same I2C bus) but have different bus addresses.  They can all
-          * be handled by this case. */
-         if ( offset + bytesToRead > I2C_getMaxMemAddr( iDev ) ) {
-            status = ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY;
-            goto I2C_readDevMemBLK_ERR_HANDLER;  /* Stop and jump to error handling */
-         }
-         break;
-      default:
-         status = ERR_I2C_DEV_INVALID_DEVICE;
-         goto I2C_readDevMemBLK_ERR_HANDLER;  /* Stop and jump to error handling */
-         break;
+   status = I2C_checkDevAccess( iDev, offset, bytesToRead, false );
+   if ( ERR_NONE != status ) {
+      goto I2C_readDevMemBLK_ERR_HANDLER;  /* Stop and jump to error handling */
    }
 
    status = I2C_readBufferBLK(
@@ -566,15 +712,7 @@ CBErrorCode I2C_readDevMemBLK(
    );
 
 I2C_readDevMemBLK_ERR_HANDLER:    /* Handle any error that may have occurred. */
-   ERR_COND_OUTPUT(
-         status,
-         accType,
-         "Error 0x%08x reading I2C device %s on %s at mem addr 0x%02x\n",
-         status,
-         I2C_devToStr(iDev),
-         I2C_busToStr( I2C_getBus(iDev) ),
-         I2C_getMemAddr( iDev ) + offset
-   );
+   I2C_devErrOutput( status, accType, false, iDev, offset );
    return( status );
 }
 
@@ -599,25 +737,9 @@ CBErrorCode I2C_writeDevMemBLK(
       goto I2C_writeDevMemBLK_ERR_HANDLER; /* Stop and jump to error handling */
    }
 
-   switch( iDev ) {
-      case EEPROM:
-         /* These 3 devices are actually part of the same EEPROM chip (and thus
-          * on the same I2C bus) but have different bus addresses.  They can all
-          * be handled by this case. */
-         if ( offset + bytesToWrite > I2C_getMaxMemAddr( iDev ) ) {
-            status = ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY;
-            goto I2C_writeDevMemBLK_ERR_HANDLER;  /* Stop and jump to error handling */
-         }
-         break;
-      case EUI_ROM:                             /* Intentionally fall through */
-      case SN_ROM:
-         status = ERR_I2C_DEV_IS_READ_ONLY;
-         goto I2C_writeDevMemBLK_ERR_HANDLER;  /* Stop and jump to error handling */
-         break;
-      default:
-         status = ERR_I2C_DEV_INVALID_DEVICE;
-         goto I2C_writeDevMemBLK_ERR_HANDLER;  /* Stop and jump to error handling */
-         break;
+   status = I2C_checkDevAccess( iDev, offset, bytesToWrite, true );
+   if ( ERR_NONE != status ) {
+      goto I2C_writeDevMemBLK_ERR_HANDLER; /* Stop and jump to error handling */
    }
 
    status = I2C_writeBufferBLK(
@@ -631,15 +753,7 @@ CBErrorCode I2C_writeDevMemBLK(
    );
 
 I2C_writeDevMemBLK_ERR_HANDLER:    /* Handle any error that may have occurred. */
-   ERR_COND_OUTPUT(
-         status,
-         accType,
-         "Error 0x%08x writing I2C device %s on %s at mem addr 0x%02x\n",
-         status,
-         I2C_devToStr(iDev),
-         I2C_busToStr( I2C_getBus(iDev) ),
-         I2C_getMemAddr( iDev ) + offset
-   );
+   I2C_devErrOutput( status, accType, true, iDev, offset );
    return( status );
 }
 
@@ -37,12 +37,7 @@ extern "C" {
  *    1: Device exists and is valid
  *    0: Device doesn't exist or isn't defined
  */
-#define IS_I2C_DEVICE( DEV )                                                  \
-(                                                                             \
-   (DEV) == EEPROM ||                                                         \
-   (DEV) == SN_ROM ||                                                         \
-   (DEV) == EUI_ROM                                                           \
-)
+#define IS_I2C_DEVICE( DEV )                  ( (uint32_t)(DEV) < MAX_I2C_DEV )
 
 /* Exported constants --------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
@@ -200,11 +195,15 @@ CBErrorCode I2C_calcPageWriteSizes(
  * @brief   A blocking function to read I2C data that should be called from
  * FreeRTOS threads.
  *
- * This function sends and event to the I2CxDevMgr AO to read data from an I2C
- * device and then suspends the calling task.  Once the AO is finished processing
- * the request, it will put an event with the data (or error) into the raw queue
- * and wake the task.  This function then resumes and retrieves the data out of
- * the queue, parses it, fills in the appropriate buffers and status and returns.
+ * This function sends and event to the I2CDevMgr AO of the device's bus to read
+ * data from an I2C device and then sleeps until the AO puts the reply (or
+ * error) at the front of the raw queue, or until HL_MAX_TOUT_SEC_I2C_FRT_WAIT
+ * runs out.  Reads of up to MAX_I2C_READ_LEN bytes come back in the reply and
+ * are copied to *pBuffer.  Longer reads go straight into *pBuffer so any amount
+ * that fits in it can be read with a single call and a single bus transfer.
+ * If such a read times out, the request is cancelled and this waits until the
+ * AO is done with *pBuffer before returning, so the buffer can live on the
+ * stack.
  *
  * @param [in] iDev: I2C_Dev_t type specifying the I2C Device.
  *    @arg EEPROM: 256 bytes of main EEPROM memory
@@ -221,6 +220,7 @@ CBErrorCode I2C_calcPageWriteSizes(
  * @param [in] bytesToRead: uint8_t variable specifying how many bytes to read
  * @return CBErrorCode: status of the read operation
  *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_I2C_DEV_REPLY_TIMEOUT: the I2CDevMgr AO didn't reply in time.
  */
 CBErrorCode I2C_readDevMemFRT(
       I2C_Dev_t iDev,
@@ -235,11 +235,12 @@ CBErrorCode I2C_readDevMemFRT(
  * @brief   A blocking function to write I2C data that should be called from
  * FreeRTOS threads.
  *
- * This function sends and event to the I2CxDevMgr AO to write data to an I2C
- * device and then suspends the calling task.  Once the AO is finished processing
- * the request, it will put an event with the data (or error) into the raw queue
- * and wake the task.  This function then resumes and retrieves the data out of
- * the queue, parses it, fills in the appropriate buffers and status and returns.
+ * This function sends and event to the I2CDevMgr AO of the device's bus to
+ * write data to an I2C device and then sleeps until the AO puts the reply (or
+ * error) at the front of the raw queue, or until HL_MAX_TOUT_SEC_I2C_FRT_WAIT
+ * runs out.  Writes longer than MAX_I2C_WRITE_LEN go straight out of *pBuffer.
+ * If one of those times out, the request is cancelled and this waits until the
+ * AO is done with *pBuffer before returning.
  *
  * @param [in] iDev: I2C_Dev_t type specifying the I2C Device.
  *    @arg EEPROM: 256 bytes of main EEPROM memory
@@ -254,6 +255,7 @@ CBErrorCode I2C_readDevMemFRT(
  * @param [in] bytesToWrite: uint8_t variable specifying how many bytes to write
  * @return CBErrorCode: status of the write operation
  *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_I2C_DEV_REPLY_TIMEOUT: the I2CDevMgr AO didn't reply in time.
  */
 CBErrorCode I2C_writeDevMemFRT(
       I2C_Dev_t iDev,
@@ -283,16 +285,29 @@ CBErrorCode I2C_writeDevMemFRT(
  *    @arg ACCESS_QPC:        non-blocking, event based access.
  *    @arg ACCESS_FREERTOS:   non-blocking, but waits on queue to know the status.
  * @param [in] *callingAO: QActive pointer to the AO that called this function.
- *                         If called by a FreeRTOS thread, this should be NULL.
+ *                         The done event is posted to it and nobody else.  If
+ *                         called by a FreeRTOS thread, this should be NULL.
+ * @param [out] *pBuffer: uint8_t pointer to where to read the data or NULL to
+ *                        get it in the dataBuf of the I2C_DEV_READ_DONE event.
+ *                        A buffer lets the whole device be read in a single
+ *                        transfer with no copies.  It must stay valid until
+ *                        I2C_DEV_READ_DONE comes back.
+ * @param [in] tag: uint16_t opaque tag that is copied into the
+ *                  I2C_DEV_READ_DONE event so the caller can match it to this
+ *                  request.  Only *callingAO sees it so any value can be
+ *                  used.  Use 0 if not needed.
  * @return CBErrorCode: status of the read operation
  *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_MEM_BUFFER_LEN: more than MAX_I2C_READ_LEN bytes with no pBuffer.
  */
 CBErrorCode I2C_readDevMemEVT(
       I2C_Dev_t iDev,
       uint16_t offset,
       uint16_t bytesToRead,
       AccessType_t accType,
-      QActive* callingAO
+      QActive* callingAO,
+      uint8_t *pBuffer,
+      uint16_t tag
 );
 
 /**
@@ -313,8 +328,17 @@ CBErrorCode I2C_readDevMemEVT(
  *    @arg ACCESS_QPC:        non-blocking, event based access.
  *    @arg ACCESS_FREERTOS:   non-blocking, but waits on queue to know the status.
  * @param [in] *callingAO: QActive pointer to the AO that called this function.
- *                         If called by a FreeRTOS thread, this should be NULL.
- * @param [in] *pBuffer: uint8_t pointer to the buffer to store read data.
+ *                         The done event is posted to it and nobody else.  If
+ *                         called by a FreeRTOS thread, this should be NULL.
+ * @param [in] *pBuffer: uint8_t pointer to the data to write.  Up to
+ *                       MAX_I2C_WRITE_LEN bytes are copied into the request.
+ *                       Anything longer is written page by page straight out
+ *                       of this buffer, which then has to stay valid until
+ *                       I2C_DEV_WRITE_DONE comes back.
+ * @param [in] tag: uint16_t opaque tag that is copied into the
+ *                  I2C_DEV_WRITE_DONE event so the caller can match it to this
+ *                  request.  Only *callingAO sees it so any value can be
+ *                  used.  Use 0 if not needed.
  * @return CBErrorCode: status of the read operation
  *    @arg ERR_NONE: if no errors occurred
  */
@@ -324,7 +348,8 @@ CBErrorCode I2C_writeDevMemEVT(
       uint16_t bytesToWrite,
       AccessType_t accType,
       QActive* callingAO,
-      uint8_t *pBuffer
+      uint8_t *pBuffer,
+      uint16_t tag
 );
 
 /******************************************************************************/
@@ -0,0 +1,365 @@
+/**
+ * @file   i2c_xfer.c
+ * @brief  Definitions for the interrupt driven I2C master transfer engine.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupI2C
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "i2c_xfer.h"
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+
+/**< SR1 flags the error ISR handles */
+#define I2C_XFER_SR1_ERRORS \
+   ( I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR )
+
+/* Private macros ------------------------------------------------------------*/
+
+/**< Set bits in a register of the I2C peripheral */
+#define I2C_XFER_SET( hw, reg, bits ) \
+   I2C_XFER_WR( (hw), reg, I2C_XFER_RD( (hw), reg ) | (bits) )
+
+/**< Clear bits in a register of the I2C peripheral */
+#define I2C_XFER_CLR( hw, reg, bits ) \
+   I2C_XFER_WR( (hw), reg, I2C_XFER_RD( (hw), reg ) & (uint16_t)~(bits) )
+
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Get how many bytes are still to be written to DR.
+ * @param [in] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @return: uint16_t memory address and data bytes left to send.
+ */
+static inline uint16_t I2CXfer_txLeft( const I2C_Xfer_t *xfer );
+
+/**
+ * @brief   Get the next byte of the memory address.  MSB goes first.
+ * @param [in] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @return: uint8_t byte to send.
+ */
+static inline uint8_t I2CXfer_memAddrByte( const I2C_Xfer_t *xfer );
+
+/**
+ * @brief   Handle an event while sending the memory address or data.
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @param [in] sr1: uint16_t SR1 read at the start of the ISR.
+ * @return: bool true if the transfer just finished.
+ */
+static bool I2CXfer_tx( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw, uint16_t sr1 );
+
+/**
+ * @brief   Set up the reception once the read address was acknowledged.
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @return: None
+ */
+static void I2CXfer_addrRx( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw );
+
+/**
+ * @brief   Handle an event while receiving data.
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @param [in] sr1: uint16_t SR1 read at the start of the ISR.
+ * @return: bool true if the transfer just finished.
+ */
+static bool I2CXfer_rx( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw, uint16_t sr1 );
+
+/**
+ * @brief   Turn off the event interrupts and record the result.
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @param [in] error: CBErrorCode result of the transfer.
+ * @return: None
+ */
+static void I2CXfer_finish(
+      I2C_Xfer_t *xfer,
+      I2C_XFER_HW_T *hw,
+      CBErrorCode error
+);
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static inline uint16_t I2CXfer_txLeft( const I2C_Xfer_t *xfer )
+{
+   uint16_t left = xfer->memAddrSize - xfer->nMemAddrSent;
+   if ( !xfer->isRead ) {
+      left += xfer->len - xfer->idx;
+   }
+   return( left );
+}
+
+/******************************************************************************/
+static inline uint8_t I2CXfer_memAddrByte( const I2C_Xfer_t *xfer )
+{
+   if ( 2 == xfer->memAddrSize && 0 == xfer->nMemAddrSent ) {
+      return( (uint8_t)(xfer->memAddr >> 8) );
+   }
+   return( (uint8_t)(xfer->memAddr & 0x00FF) );
+}
+
+/******************************************************************************/
+static bool I2CXfer_tx( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw, uint16_t sr1 )
+{
+   if ( (sr1 & I2C_SR1_TXE) && I2CXfer_txLeft( xfer ) > 0 ) {
+      if ( xfer->nMemAddrSent < xfer->memAddrSize ) {
+         I2C_XFER_WR( hw, DR, I2CXfer_memAddrByte( xfer ) );
+         xfer->nMemAddrSent++;
+      } else {
+         I2C_XFER_WR( hw, DR, xfer->buf[xfer->idx++] );
+      }
+
+      /* Once the last byte of a write is in DR, only BTF matters.  A read
+       * still needs the next TXE to time the repeated START. */
+      if ( 0 == I2CXfer_txLeft( xfer ) && !xfer->isRead ) {
+         I2C_XFER_CLR( hw, CR2, I2C_CR2_ITBUFEN );
+      }
+   } else if ( 0 == I2CXfer_txLeft( xfer ) ) {
+      if ( xfer->isRead ) {
+         /* The last address byte is in the shift register.  START now makes
+          * the repeated START right after it, before BTF can set and keep
+          * re-entering the ISR until SB. */
+         xfer->phase = I2C_XFER_RESTART;
+         I2C_XFER_CLR( hw, CR2, I2C_CR2_ITBUFEN );
+         I2C_XFER_SET( hw, CR1, I2C_CR1_START );
+      } else if ( sr1 & I2C_SR1_BTF ) {
+         I2C_XFER_SET( hw, CR1, I2C_CR1_STOP );
+         I2CXfer_finish( xfer, hw, ERR_NONE );
+         return( true );
+      }
+   }
+   return( false );
+}
+
+/******************************************************************************/
+static void I2CXfer_addrRx( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw )
+{
+   xfer->phase = I2C_XFER_RX;
+
+   if ( 1 == xfer->len ) {
+      /* NACK the only byte and STOP as soon as ADDR is cleared */
+      I2C_XFER_CLR( hw, CR1, I2C_CR1_ACK );
+      (void)I2C_XFER_RD( hw, SR2 );              /* SR1 then SR2 clears ADDR */
+      I2C_XFER_SET( hw, CR1, I2C_CR1_STOP );
+      I2C_XFER_SET( hw, CR2, I2C_CR2_ITBUFEN );
+   } else if ( 2 == xfer->len ) {
+      /* With POS set, the NACK goes on the second byte.  Both are read at BTF */
+      I2C_XFER_SET( hw, CR1, I2C_CR1_POS );
+      I2C_XFER_CLR( hw, CR1, I2C_CR1_ACK );
+      (void)I2C_XFER_RD( hw, SR2 );
+   } else {
+      (void)I2C_XFER_RD( hw, SR2 );
+
+      /* RXNE until 3 bytes are left, then BTF takes over */
+      if ( xfer->len > 3 ) {
+         I2C_XFER_SET( hw, CR2, I2C_CR2_ITBUFEN );
+      }
+   }
+}
+
+/******************************************************************************/
+static bool I2CXfer_rx( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw, uint16_t sr1 )
+{
+   uint16_t left = xfer->len - xfer->idx;
+
+   if ( 1 == left ) {
+      if ( sr1 & I2C_SR1_RXNE ) {
+         xfer->buf[xfer->idx++] = (uint8_t)I2C_XFER_RD( hw, DR );
+         I2CXfer_finish( xfer, hw, ERR_NONE );
+         return( true );
+      }
+   } else if ( 2 == left ) {
+      /* Only 2 byte reads get here.  Both bytes are in, STOP and read them. */
+      if ( sr1 & I2C_SR1_BTF ) {
+         I2C_XFER_SET( hw, CR1, I2C_CR1_STOP );
+         xfer->buf[xfer->idx++] = (uint8_t)I2C_XFER_RD( hw, DR );
+         xfer->buf[xfer->idx++] = (uint8_t)I2C_XFER_RD( hw, DR );
+         I2CXfer_finish( xfer, hw, ERR_NONE );
+         return( true );
+      }
+   } else if ( 3 == left ) {
+      /* N-2 is in DR and N-1 in the shift register with the clock stretched.
+       * NACK byte N, then STOP between reading N-2 and N-1. */
+      if ( sr1 & I2C_SR1_BTF ) {
+         I2C_XFER_CLR( hw, CR1, I2C_CR1_ACK );
+         xfer->buf[xfer->idx++] = (uint8_t)I2C_XFER_RD( hw, DR );
+         I2C_XFER_SET( hw, CR1, I2C_CR1_STOP );
+         xfer->buf[xfer->idx++] = (uint8_t)I2C_XFER_RD( hw, DR );
+         I2C_XFER_SET( hw, CR2, I2C_CR2_ITBUFEN );
+      }
+   } else if ( sr1 & I2C_SR1_RXNE ) {
+      xfer->buf[xfer->idx++] = (uint8_t)I2C_XFER_RD( hw, DR );
+      if ( 3 == xfer->len - xfer->idx ) {
+         I2C_XFER_CLR( hw, CR2, I2C_CR2_ITBUFEN );
+      }
+   }
+   return( false );
+}
+
+/******************************************************************************/
+static void I2CXfer_finish(
+      I2C_Xfer_t *xfer,
+      I2C_XFER_HW_T *hw,
+      CBErrorCode error
+)
+{
+   /* Leave the error interrupt on.  It is always enabled for the bus. */
+   I2C_XFER_CLR( hw, CR2, I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN );
+   I2C_XFER_CLR( hw, CR1, I2C_CR1_POS );
+   I2C_XFER_SET( hw, CR1, I2C_CR1_ACK );   /* Ready for the next reception */
+
+   /* A failed read can still have its repeated START pending.  Left set, it
+    * would take the bus again right after the STOP. */
+   I2C_XFER_CLR( hw, CR1, I2C_CR1_START );
+
+   xfer->errorCode = error;
+   xfer->phase     = I2C_XFER_DONE;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/******************************************************************************/
+CBErrorCode I2CXfer_start( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw )
+{
+   if ( xfer->memAddrSize > 2
+         || ( xfer->isRead && 0 == xfer->len )
+         || ( 0 == xfer->memAddrSize && 0 == xfer->len ) ) {
+      return( ERR_I2CBUS_INVALID_XFER );
+   }
+
+   xfer->idx          = 0;
+   xfer->nMemAddrSent = 0;
+   xfer->nIrqs        = 0;
+   xfer->errorCode    = ERR_NONE;
+   xfer->phase        = I2C_XFER_START;
+
+   I2C_XFER_CLR( hw, CR1, I2C_CR1_POS );
+   I2C_XFER_SET( hw, CR1, I2C_CR1_ACK );
+   I2C_XFER_SET( hw, CR2, I2C_CR2_ITEVTEN | I2C_CR2_ITERREN );
+   I2C_XFER_SET( hw, CR1, I2C_CR1_START );
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+bool I2CXfer_onEvent( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw )
+{
+   uint16_t sr1 = I2C_XFER_RD( hw, SR1 );
+   xfer->nIrqs++;
+
+   switch ( xfer->phase ) {
+      case I2C_XFER_START:
+         if ( sr1 & I2C_SR1_SB ) {            /* Writing DR after SR1 clears SB */
+            if ( xfer->isRead && 0 == xfer->memAddrSize ) {
+               I2C_XFER_WR( hw, DR, xfer->devAddr | 0x01 );
+               xfer->phase = I2C_XFER_ADDR_RX;
+            } else {
+               I2C_XFER_WR( hw, DR, xfer->devAddr & 0xFE );
+               xfer->phase = I2C_XFER_ADDR_TX;
+            }
+         }
+         break;
+
+      case I2C_XFER_ADDR_TX:
+         if ( sr1 & I2C_SR1_ADDR ) {
+            (void)I2C_XFER_RD( hw, SR2 );        /* SR1 then SR2 clears ADDR */
+            xfer->phase = I2C_XFER_TX;
+            I2C_XFER_SET( hw, CR2, I2C_CR2_ITBUFEN );
+
+            /* DR is empty right after ADDR so don't wait for a TXE interrupt */
+            return( I2CXfer_tx( xfer, hw, I2C_SR1_TXE ) );
+         }
+         break;
+
+      case I2C_XFER_TX:
+         return( I2CXfer_tx( xfer, hw, sr1 ) );
+
+      case I2C_XFER_RESTART:
+         if ( sr1 & I2C_SR1_SB ) {
+            I2C_XFER_WR( hw, DR, xfer->devAddr | 0x01 );
+            xfer->phase = I2C_XFER_ADDR_RX;
+         }
+         break;
+
+      case I2C_XFER_ADDR_RX:
+         if ( sr1 & I2C_SR1_ADDR ) {
+            I2CXfer_addrRx( xfer, hw );
+         }
+         break;
+
+      case I2C_XFER_RX:
+         return( I2CXfer_rx( xfer, hw, sr1 ) );
+
+      default:
+         /* Nothing is running.  Make sure a stray event doesn't keep firing. */
+         I2C_XFER_CLR( hw, CR2, I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN );
+         break;
+   }
+   return( false );
+}
+
+/******************************************************************************/
+bool I2CXfer_onError( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw )
+{
+   uint16_t sr1 = I2C_XFER_RD( hw, SR1 ) & I2C_XFER_SR1_ERRORS;
+
+   /* Error flags are cleared by writing 0 to them */
+   I2C_XFER_WR( hw, SR1, (uint16_t)~sr1 );
+
+   if ( 0 == sr1
+         || I2C_XFER_IDLE == xfer->phase
+         || I2C_XFER_DONE == xfer->phase ) {
+      return( false );
+   }
+   xfer->nIrqs++;
+
+   CBErrorCode error;
+   if ( sr1 & I2C_SR1_ARLO ) {
+      error = ERR_I2CBUS_ARB_LOST;  /* Not the bus master anymore so no STOP */
+   } else {
+      if ( sr1 & I2C_SR1_AF ) {
+         error = ERR_I2CBUS_NACK;
+      } else if ( sr1 & I2C_SR1_BERR ) {
+         error = ERR_I2CBUS_BUS_ERROR;
+      } else {
+         error = ERR_I2CBUS_OVERRUN;
+      }
+      I2C_XFER_SET( hw, CR1, I2C_CR1_STOP );
+   }
+
+   I2CXfer_finish( xfer, hw, error );
+   return( true );
+}
+
+/******************************************************************************/
+bool I2CXfer_abort(
+      I2C_Xfer_t *xfer,
+      I2C_XFER_HW_T *hw,
+      CBErrorCode error
+)
+{
+   if ( I2C_XFER_IDLE == xfer->phase || I2C_XFER_DONE == xfer->phase ) {
+      return( false );
+   }
+
+   I2C_XFER_SET( hw, CR1, I2C_CR1_STOP );
+   I2CXfer_finish( xfer, hw, error );
+   return( true );
+}
+
+/**
+ * @}
+ * end addtogroup groupI2C
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,166 @@
+/**
+ * @file   i2c_xfer.h
+ * @brief  Declarations for the interrupt driven I2C master transfer engine.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupI2C
+ * @{
+ *
+ * A whole memory read or write on an I2C device is described by a single
+ * I2C_Xfer_t descriptor:
+ *
+ *    START, dev addr (W), mem addr (0-2 bytes), data (write)
+ *    START, dev addr (W), mem addr (0-2 bytes), reSTART, dev addr (R), data
+ *
+ * The I2C event and error ISRs advance the descriptor one step per interrupt
+ * and only tell the caller when the transfer is done or has failed.  The
+ * I2CBusMgr AO therefore gets a single event per transfer instead of
+ * polling I2C_CheckEvent() with an event per bus phase.
+ *
+ * Reception follows the STM32F4 reference manual (RM0090) procedure for
+ * interrupt driven master receivers, including the special cases for 1 and 2
+ * byte reads and the BTF handling of the last 3 bytes.
+ *
+ * The peripheral registers are accessed only through the I2C_XFER_RD() and
+ * I2C_XFER_WR() macros.  A host build can define these (and I2C_XFER_HW_T)
+ * before including this file to run the engine against a simulated
+ * peripheral.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef I2C_XFER_H_
+#define I2C_XFER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "CBErrors.h"
+
+/* Exported defines ----------------------------------------------------------*/
+#ifndef I2C_XFER_HW_T
+#include "stm32f4xx.h"                                 /* For STM32F4 support */
+
+/**< Register block of the I2C peripheral the engine drives */
+#define I2C_XFER_HW_T                                              I2C_TypeDef
+
+/**< Read a register of the I2C peripheral */
+#define I2C_XFER_RD( hw, reg )                        ( (uint16_t)(hw)->reg )
+
+/**< Write a register of the I2C peripheral */
+#define I2C_XFER_WR( hw, reg, val )            ( (hw)->reg = (uint16_t)(val) )
+#endif                                                       /* I2C_XFER_HW_T */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \enum I2C_XferPhase_t
+ * Where a transfer is on the bus.
+ */
+typedef enum I2C_XferPhases
+{
+   I2C_XFER_IDLE = 0,                           /**< Not started or aborted */
+   I2C_XFER_START,                      /**< Waiting for SB after START (EV5) */
+   I2C_XFER_ADDR_TX,       /**< Waiting for ADDR of the write address (EV6) */
+   I2C_XFER_TX,                /**< Sending the memory address and data (EV8) */
+   I2C_XFER_RESTART,           /**< Waiting for SB after repeated START (EV5) */
+   I2C_XFER_ADDR_RX,        /**< Waiting for ADDR of the read address (EV6) */
+   I2C_XFER_RX,                                  /**< Receiving data (EV7) */
+   I2C_XFER_DONE,                  /**< Finished.  Check the error code */
+} I2C_XferPhase_t;
+
+/**
+ * \struct I2C_Xfer_t
+ * Descriptor of a single I2C master transfer.
+ */
+typedef struct I2C_Xfer
+{
+   /* Filled in by the caller */
+   uint8_t           devAddr;  /**< Device address in the 8 bit (shifted) form */
+   uint8_t           memAddrSize;   /**< Bytes of memory address.  0, 1, or 2 */
+   uint16_t          memAddr;        /**< Internal memory address, MSB first */
+   bool              isRead;        /**< Read from the device if true */
+   uint8_t          *buf;  /**< Data to write or where to store the read data */
+   uint16_t          len;                /**< Bytes of data to read or write */
+
+   /* Filled in by the engine */
+   I2C_XferPhase_t   phase;                  /**< Where the transfer is at */
+   uint16_t          idx;                       /**< Bytes of data moved */
+   uint8_t           nMemAddrSent;       /**< Bytes of memory address sent */
+   uint16_t          nIrqs;                 /**< ISR calls the transfer took */
+   CBErrorCode       errorCode;           /**< ERR_NONE if the transfer worked */
+} I2C_Xfer_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Start a transfer.
+ *
+ * Enables the event and error interrupts and generates the START condition.
+ * Everything after that happens in I2CXfer_onEvent() and I2CXfer_onError().
+ *
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.  Must stay valid
+ * until the transfer is done.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the transfer was started.
+ *    @arg ERR_I2CBUS_INVALID_XFER: bad length or memory address size.
+ */
+CBErrorCode I2CXfer_start( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw );
+
+/**
+ * @brief   Advance a transfer from the I2C event ISR.
+ *
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @return: bool true if the transfer just finished.
+ */
+bool I2CXfer_onEvent( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw );
+
+/**
+ * @brief   Fail a transfer from the I2C error ISR.
+ *
+ * Clears the error flags, releases the bus, and records the error.
+ *
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @return: bool true if the transfer just finished.
+ */
+bool I2CXfer_onError( I2C_Xfer_t *xfer, I2C_XFER_HW_T *hw );
+
+/**
+ * @brief   Give up on a transfer that is still running.
+ *
+ * Must not race the ISRs.  Call it with the I2C interrupts locked out.
+ *
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: I2C_XFER_HW_T pointer to the I2C peripheral.
+ * @param [in] error: CBErrorCode to record as the result.
+ * @return: bool true if the transfer was still running.
+ */
+bool I2CXfer_abort(
+      I2C_Xfer_t *xfer,
+      I2C_XFER_HW_T *hw,
+      CBErrorCode error
+);
+
+/**
+ * @}
+ * end addtogroup groupI2C
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                         /* I2C_XFER_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -47,6 +47,13 @@
 #include "bsp_defs.h"
 #include "DbgMgr.h"                                           /* For MenuEvt */
 #include "cplr.h"  /* for access to the raw queue used to talk to CPLR tastk */
+#include "qspy_stream.h"                        /* For QSPY trace streaming */
+#include "comm.h"                                        /* For CommFrameEvt */
+#include "serial_rx.h"               /* For the log port menu line assembler */
+#include "log_fanout.h"                   /* For the log port client fan-out */
+#include "con_fmt.h"                                 /* For FMT_snprintf() */
+#include "telemetry.h"                       /* For the UDP telemetry stream */
+#include <stdlib.h>                                         /* For strtoul() */
 
 /* Compile-time called macros ------------------------------------------------*/
 Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
@@ -71,7 +78,7 @@ struct echo_state {
     uint8_t state;                              /**< echo_states socket state */
     uint8_t retries;                         /**< Number of retries attempted */
     struct tcp_pcb *pcb;                              /**< Connection context */
-    struct pbuf *p;                              /**< pbuf (chain) to recycle */
+    uint8_t logId;       /**< Log fan-out client or LOG_FANOUT_NO_CLIENT */
 };
 
 
@@ -137,6 +144,14 @@ typedef struct {
     /**< Local timer for TCP send timeout. */
     QTimeEvt te_TcpSend;
     bool isEthDbgEnabled;
+
+    /**< Pointer to LWIP udp pcb struct used to stream QS trace data to QSPY. */
+    #ifdef Q_SPY
+    struct udp_pcb * qspy_upcb;
+    #endif;
+
+    /**< Pointer to LWIP udp pcb struct used to stream telemetry to a collector. */
+    struct udp_pcb * tlm_upcb;
 } LWIPMgr;
 
 /* Keeps track of what port is used by logging TCP connection */
@@ -145,10 +160,6 @@ extern uint16_t LWIPMgr_logPort;
 /* Keeps track of what port is used by system TCP connection */
 extern uint16_t LWIPMgr_sysPort;
 
-/* Pointer to the log socket state that will be passed in to the TCP callback
- * functions. */
-extern struct echo_state* LWIPMgr_es_log;
-
 /* Pointer to the log socket state that will be passed in to the TCP callback
  * functions. */
 extern struct echo_state* LWIPMgr_es_sys;
@@ -205,11 +216,28 @@ static QState LWIPMgr_Sending(LWIPMgr * const me, QEvt const * const e);
 
 /* Private defines -----------------------------------------------------------*/
 #define LWIP_SLOW_TICK_MS       TCP_TMR_INTERVAL
+#define LWIP_QSPY_MAX_DGRAMS    8      /* Max QSPY datagrams sent per flush */
+#define LWIP_LOG_RING_SIZE      8192    /* Shared log port ring.  Power of 2 */
 
 /* Private macros ------------------------------------------------------------*/
 /* Private variables and Local objects ---------------------------------------*/
 static LWIPMgr l_LWIPMgr;       /* the single instance of the active object */
 
+/* Incremental parsers for the data received on the TCP ports.  They keep their
+ * state between segments so a command can span several segments and a segment
+ * can carry several commands. */
+static SerialRxParser_t  l_logRxParser[LOG_FANOUT_MAX_CLIENTS]; /* Log port menu */
+static char              l_logRxLine[LOG_FANOUT_MAX_CLIENTS][MENU_MAX_CMD_LEN];
+static CommFrameParser_t l_sysFrameParser;   /* Binary frames on sys port */
+
+/* Every log port client reads the same ring of log records at its own pace.  A
+ * client that can't keep up loses its oldest records instead of holding up the
+ * AO or the other clients. */
+static LogFanout_t       l_logFanout;
+static uint64_t          l_logRing[LWIP_LOG_RING_SIZE / sizeof(uint64_t)];
+static uint8_t           l_logRxClient   = LOG_FANOUT_NO_CLIENT; /* Being parsed */
+static uint8_t           l_logMenuClient = LOG_FANOUT_ALL_CLIENTS;/* Gets menu */
+
 /* Global-scope objects ----------------------------------------------------*/
 QActive * const AO_LWIPMgr = (QActive *)&l_LWIPMgr;  /* "opaque" AO pointer */
 
@@ -263,21 +291,6 @@ static err_t LWIP_tcpRecv(
     err_t err);
 
 
-/**
- * @brief: A callback function that handles the actual sending of data
- * on a TCP socket.
- * This function is passed in as a callback to tcp_accept().
- *
- * @param [in|out] *tpcb: struct tcp_pcb pointer to the pcb that is handling the
- * context for this connection.
- * @param [in|out] *es: echo_state struct to keep track of the socket state.
- *
- * @return None
- */
-/*${AOs::LWIP_tcpSend} .....................................................*/
-static bool LWIP_tcpSend(struct tcp_pcb * tpcb, struct echo_state * es);
-
-
 /**
  * @brief: A callback function that handles the start of a RECV on a
  * TCP socket.
@@ -342,6 +355,87 @@ static void LWIP_tcpClose(struct tcp_pcb * tpcb, struct echo_state * es);
 static void LWIP_tcpError(void * arg, err_t err);
 
 
+/* TCP receive parser callbacks */
+/**
+  * @brief  Publish a complete menu command received on the log port.
+  *
+  * @param  line: pointer to the line, including the terminating '\n'.
+  * @param  len: length of the line, including the terminating '\n'.
+  * @retval None
+  */
+static void LWIP_logLineHandler(const char *line, uint16_t len);
+
+/**
+  * @brief  Handle a '!' command received on the log port.  These change the
+  *             settings of the connection they came in on and never reach the
+  *             menu.
+  *             !filter <level> [<module mask>]: only send records at or above
+  *                 level (0=DBG, 1=LOG, 2=WRN, 3=ERR) from the DBG_MODL_T
+  *                 modules in the hex mask.  No mask means all modules.
+  *             !stats: show what has been sent, filtered, and dropped.
+  *
+  * @param  line: pointer to the line, including the terminating '\n'.
+  * @param  len: length of the line, including the terminating '\n'.
+  * @retval None
+  */
+static void LWIP_logCommand(const char *line, uint16_t len);
+
+/* Log port fan-out */
+/**
+  * @brief  Copy as much of a log client's backlog into its TCP send buffer as
+  *             fits.  The rest stays in the ring until the data in flight is
+  *             acked.  Tells the client how many records it lost first if it
+  *             fell behind.
+  *
+  * @param  id: log fan-out client id.
+  * @retval None
+  */
+static void LWIP_logPump(uint8_t id);
+
+/**
+  * @brief  Run LWIP_logPump() for every connected log client.
+  *
+  * @param  None
+  * @retval None
+  */
+static void LWIP_logPumpAll(void);
+
+/**
+  * @brief  Tell the debug sink registry which log records the ethernet sink
+  *             takes: whatever the connected log clients filter in, as long
+  *             as debugging over ethernet is enabled.  Nothing otherwise, so
+  *             the records nobody reads aren't even formatted.
+  *
+  * @param  None
+  * @retval None
+  */
+static void LWIP_logSinkUpdate(void);
+
+/**
+  * @brief  Allocate the event for a frame received on the system port once its
+  *             header has been checked.  The frame parser copies the payload
+  *             straight into the event.
+  *
+  * @param  ctx: parser context (unused).
+  * @param  hdr: pointer to the header of the frame.
+  * @retval pointer to the payload buffer of the event or NULL if the event pool
+  *             is running low, in which case the frame is dropped.
+  */
+static uint8_t *LWIP_sysFrameGetBuffer(void *ctx, const CommFrameHdr_t *hdr);
+
+/**
+  * @brief  Publish a frame received on the system port to CommStackMgr, or
+  *             recycle its event if the frame was bad.
+  *
+  * @param  ctx: parser context (unused).
+  * @param  hdr: pointer to the header of the frame.
+  * @param  payload: buffer returned by LWIP_sysFrameGetBuffer().
+  * @param  isValid: true if the frame crc matched.
+  * @retval None
+  */
+static void LWIP_sysFrameHandler(void *ctx, const CommFrameHdr_t *hdr,
+                                 uint8_t *payload, bool isValid);
+
 /* UDP functions */
 /**
   * @brief  This function is the UDP handler callback. It is automatically
@@ -360,6 +454,76 @@ static void LWIP_tcpError(void * arg, err_t err);
 static void udp_rx_handler(void *arg, struct udp_pcb *upcb,
                            struct pbuf *p, struct ip_addr *addr, u16_t port);
 
+#ifdef Q_SPY
+/**
+  * @brief  This function is the UDP handler callback for the QSPY port.  Any
+  *             datagram that arrives on this port (re)directs the QS trace
+  *             stream to the sender. IT SHOULD NOT BE CALLED DIRECTLY.
+  *
+  * @param  arg: a pointer to arg.  (Not currently used)
+  * @param  upcb: a pointer to the udb structure containing UDP connect data.
+  * @param  p:  a pointer to the pbuf containing the received data.
+  * @param  addr: a pointer to struct containing the IP data.
+  * @param  part: a u16_t type containing the port number used to connect.
+  * @retval None
+  */
+static void qspy_udp_rx_handler(void *arg, struct udp_pcb *upcb,
+                                struct pbuf *p, struct ip_addr *addr, u16_t port);
+
+/**
+  * @brief  Send QS trace data waiting in the QSPY stream ring to the QSPY host.
+  *             At most LWIP_QSPY_MAX_DGRAMS datagrams are sent per call so
+  *             that tracing never starves the rest of the network traffic.
+  *
+  * @param  me: a pointer to the LWIPMgr AO.
+  * @retval None
+  */
+static void LWIP_qspyFlush(LWIPMgr * const me);
+#endif                                                             /* Q_SPY */
+
+/**
+  * @brief  This function is the UDP handler callback for the telemetry port.
+  *             Handles the subscribe, dictionary, and unsubscribe commands of
+  *             a telemetry collector. IT SHOULD NOT BE CALLED DIRECTLY.
+  *
+  * @param  arg: a pointer to the LWIPMgr AO.
+  * @param  upcb: a pointer to the udp structure containing UDP connect data.
+  * @param  p:  a pointer to the pbuf containing the received data.
+  * @param  addr: a pointer to struct containing the IP data.
+  * @param  port: a u16_t type containing the port number used to connect.
+  * @retval None
+  */
+static void tlm_udp_rx_handler(void *arg, struct udp_pcb *upcb,
+                               struct pbuf *p, struct ip_addr *addr, u16_t port);
+
+/**
+  * @brief  Register the lwIP and log port telemetry channels.
+  * @param  None
+  * @retval None
+  */
+static void LWIP_tlmRegister(void);
+
+/**
+  * @brief  Send the whole telemetry dictionary to a collector.  Takes as many
+  *             datagrams as it needs.
+  *
+  * @param  me: a pointer to the LWIPMgr AO.
+  * @param  addr: a pointer to the IP address of the collector.
+  * @param  port: a u16_t type containing the port of the collector.
+  * @retval None
+  */
+static void LWIP_tlmSendDict(LWIPMgr * const me,
+                             struct ip_addr *addr, u16_t port);
+
+/**
+  * @brief  Send a snapshot of every telemetry channel to the subscribed
+  *             collector.
+  *
+  * @param  me: a pointer to the LWIPMgr AO.
+  * @retval None
+  */
+static void LWIP_tlmSendSnapshot(LWIPMgr * const me);
+
 /* Private functions ---------------------------------------------------------*/
 
 
@@ -393,7 +557,6 @@ void LWIPMgr_ctor(void) {
 /*${AOs::LWIPMgr} ..........................................................*/
 uint16_t LWIPMgr_logPort;
 uint16_t LWIPMgr_sysPort;
-struct echo_state* LWIPMgr_es_log;
 struct echo_state* LWIPMgr_es_sys;
 /*${AOs::LWIPMgr::SM} ......................................................*/
 static QState LWIPMgr_initial(LWIPMgr * const me, QEvt const * const e) {
@@ -409,6 +572,8 @@ static QState LWIPMgr_initial(LWIPMgr * const me, QEvt const * const e) {
     QS_FUN_DICTIONARY(&LWIPMgr_initial);
     QS_FUN_DICTIONARY(&LWIPMgr_Active);
     QS_FUN_DICTIONARY(&udp_rx_handler);
+    QS_FUN_DICTIONARY(&qspy_udp_rx_handler);
+    QS_FUN_DICTIONARY(&tlm_udp_rx_handler);
     QS_FUN_DICTIONARY(&ETH_SendMsg_Handler);
 
     QS_FILTER_SM_OBJ(0);                  /* Turn off all tracing for this SM */
@@ -420,6 +585,19 @@ static QState LWIPMgr_initial(LWIPMgr * const me, QEvt const * const e) {
     LWIPMgr_sysPort = 1500;
     LWIPMgr_logPort = 1501;
 
+    for (uint8_t i = 0; i < LOG_FANOUT_MAX_CLIENTS; i++) {
+        SerialRx_init(
+            &l_logRxParser[i], NULL, 0,
+            l_logRxLine[i], sizeof(l_logRxLine[i]),
+            LWIP_logLineHandler
+        );
+    }
+    LogFanout_init(&l_logFanout, (uint8_t *)l_logRing, sizeof(l_logRing));
+    CommFrame_init(
+        &l_sysFrameParser, COMM_FRAME_MAX_PAYLOAD,
+        LWIP_sysFrameGetBuffer, LWIP_sysFrameHandler, NULL
+    );
+
     me->isEthDbgEnabled = true; // Enable debugging over ethernet by default.
 
     /* Configure the hardware MAC address for the Ethernet Controller */
@@ -456,6 +634,22 @@ static QState LWIPMgr_initial(LWIPMgr * const me, QEvt const * const e) {
     udp_bind(me->upcb, IP_ADDR_ANY, 777);             /* use port 777 for UDP */
     udp_recv(me->upcb, &udp_rx_handler, me);
 
+    #ifdef Q_SPY
+    /* Set up UDP related PCB for streaming QS trace data.  Nothing is sent until a
+     * QSPY host sends a datagram to this port to tell us where to send it. */
+    me->qspy_upcb = udp_new();
+    udp_bind(me->qspy_upcb, IP_ADDR_ANY, QSPY_UDP_PORT);
+    udp_recv(me->qspy_upcb, &qspy_udp_rx_handler, me);
+    QSPY_attach((QActive *)me, ETH_QSPY_FLUSH_SIG);
+    #endif
+
+    /* Set up UDP related PCB for streaming telemetry.  Nothing is sent until a
+     * collector subscribes by sending a command to this port. */
+    me->tlm_upcb = udp_new();
+    udp_bind(me->tlm_upcb, IP_ADDR_ANY, TLM_UDP_PORT);
+    udp_recv(me->tlm_upcb, &tlm_udp_rx_handler, me);
+    LWIP_tlmRegister();
+
     /* Set up TCP related PCB  for system connnection */
     me->tpcb_sys = tcp_new();
     if (me->tpcb_sys == NULL) {
@@ -481,7 +675,6 @@ static QState LWIPMgr_initial(LWIPMgr * const me, QEvt const * const e) {
 
     me->tpcb_log = tcp_listen(me->tpcb_log);
 
-    LWIPMgr_es_log = NULL;
     tcp_accept(me->tpcb_log, LWIP_tcpAccept);
 
     /* Signal subscriptions */
@@ -618,6 +811,14 @@ static QState LWIPMgr_Active(LWIPMgr * const me, QEvt const * const e) {
                 autoip_tmr();
             }
             #endif
+
+            #ifdef Q_SPY
+            LWIP_qspyFlush(me);   /* pick up trace data that didn't fill up a datagram */
+            #endif
+
+            if (TLM_tick(LWIP_SLOW_TICK_MS)) {
+                LWIP_tlmSendSnapshot(me);
+            }
             status_ = Q_HANDLED();
             break;
         }
@@ -630,6 +831,80 @@ static QState LWIPMgr_Active(LWIPMgr * const me, QEvt const * const e) {
         /* ${AOs::LWIPMgr::SM::Active::ETH_DBG_TOGGLE} */
         case ETH_DBG_TOGGLE_SIG: {
             me->isEthDbgEnabled = !(me->isEthDbgEnabled);
+            LWIP_logSinkUpdate();
+            status_ = Q_HANDLED();
+            break;
+        }
+        /* ${AOs::LWIPMgr::SM::Active::ETH_QSPY_FLUSH} */
+        case ETH_QSPY_FLUSH_SIG: {
+            #ifdef Q_SPY
+            LWIP_qspyFlush(me);
+            QSPY_flushDone();
+            #endif
+            status_ = Q_HANDLED();
+            break;
+        }
+        /* ${AOs::LWIPMgr::SM::Active::DBG_LOG} */
+        case DBG_LOG_SIG: {
+            /************************************************************/
+            /* WARNING: Do not use any fast logging functions here.  In
+             * fact, avoid using ANY logging here since it could cause an
+             * infinite loop. */
+            /************************************************************/
+            if (true == me->isEthDbgEnabled) {
+                /* Store it once for all the log clients, each filters on its own */
+                LogEvt const *logEvt = (LogEvt const *)e;
+                LogFanout_write(
+                    &l_logFanout,
+                    logEvt->super.dataBuf,
+                    logEvt->super.dataLen,
+                    logEvt->dbgLvl,
+                    logEvt->dbgModl,
+                    LOG_FANOUT_ALL_CLIENTS
+                );
+                LWIP_logPumpAll();
+            }
+            status_ = Q_HANDLED();
+            break;
+        }
+        /* ${AOs::LWIPMgr::SM::Active::DBG_MENU} */
+        case DBG_MENU_SIG: {
+            /************************************************************/
+            /* WARNING: Do not use any fast logging functions here.  In
+             * fact, avoid using ANY logging here since it could cause an
+             * infinite loop. */
+            /************************************************************/
+            /* Menu output only goes to the client that asked for it */
+            LogFanout_write(
+                &l_logFanout,
+                ((LrgDataEvt const *)e)->dataBuf,
+                ((LrgDataEvt const *)e)->dataLen,
+                CON,
+                0,
+                l_logMenuClient
+            );
+            LWIP_logPumpAll();
+            status_ = Q_HANDLED();
+            break;
+        }
+        /* ${AOs::LWIPMgr::SM::Active::ETH_LOG_TCP_SEND} */
+        case ETH_LOG_TCP_SEND_SIG: {
+            /************************************************************/
+            /* WARNING: Do not use any fast logging functions here.  In
+             * fact, avoid using ANY logging here since it could cause an
+             * infinite loop. */
+            /************************************************************/
+            if (true == me->isEthDbgEnabled) {
+                LogFanout_write(
+                    &l_logFanout,
+                    ((LrgDataEvt const *)e)->dataBuf,
+                    ((LrgDataEvt const *)e)->dataLen,
+                    CON,
+                    0,
+                    LOG_FANOUT_ALL_CLIENTS
+                );
+                LWIP_logPumpAll();
+            }
             status_ = Q_HANDLED();
             break;
         }
@@ -671,171 +946,48 @@ static QState LWIPMgr_Idle(LWIPMgr * const me, QEvt const * const e) {
             status_ = Q_HANDLED();
             break;
         }
-        /* ${AOs::LWIPMgr::SM::Active::Idle} */
-        case Q_EXIT_SIG: {
-            /* Failed to send data, probably because out of pbufs.  Defer the event
-             * (if possible) and it will try again after getting back from "Sending"
-             * state. */
-            if (QEQueue_getNFree(&me->deferredEvtQueue) > 0) {
-                /* defer the request - this event will be handled
-                 * when the state machine goes back to Idle state */
-                QActive_defer((QActive *)me, &me->deferredEvtQueue, e);
-            } else {
-                /* notify the request sender that the request was ignored.. */
-                err_slow_printf("Unable to defer an ETH event");
-            }
-            status_ = Q_HANDLED();
-            break;
-        }
-        /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_MENU} */
-        case DBG_MENU_SIG: {
-            /************************************************************/
-            /* WARNING: Do not use any fast logging functions here.  In
-             * fact, avoid using ANY logging here since it could cause an
-             * infinite loop. */
-            /************************************************************/
-            /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_MENU::[ConnExists?]} */
-            if (NULL != LWIPMgr_es_log) {
-                struct pbuf *p = pbuf_new(
-                    (u8_t *)((LrgDataEvt const *)e)->dataBuf,
-                    ((LrgDataEvt const *)e)->dataLen
-                );
-                /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_MENU::[ConnExists?]::[MemAvail?]} */
-                if (p != (struct pbuf *)0) {
-                    LWIPMgr_es_log->p = p;                         // Attach pbuf to the socket state
-                    //dbg_slow_printf("c tcpSend, me->tpcb: %x, LWIPMgr_es_log->pcb: %x\n", (uint32_t) me->tpcb_log, (uint32_t) LWIPMgr_es_log->pcb);
-                    tcp_sent(LWIPMgr_es_log->pcb, LWIP_tcpSent);   // Set callback
-                    bool dataSent = LWIP_tcpSend(
-                        LWIPMgr_es_log->pcb,
-                        LWIPMgr_es_log
-                    );                                             // Queue data for sending
-                    pbuf_free(p);                                  // don't leak the pbuf!
-                    /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_MENU::[ConnExists?]::[MemAvail?]::[Datanotsent?]} */
-                    if (false == dataSent) {
-                        pbuf_free(p);                                  // don't leak the pbuf!
-                        status_ = Q_TRAN(&LWIPMgr_Sending);
-                    }
-                    /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_MENU::[ConnExists?]::[MemAvail?]::[else]} */
-                    else {
-                        status_ = Q_HANDLED();
-                    }
-                }
-                /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_MENU::[ConnExists?]::[else]} */
-                else {
-                    WRN_printf("MEM unavailable, trying again in a bit...\n");
-                    status_ = Q_TRAN(&LWIPMgr_Sending);
-                }
-            }
-            /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_MENU::[else]} */
-            else {
-                DBG_printf("Conn NULL\n");
-                status_ = Q_HANDLED();
-            }
-            break;
-        }
-        /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND} */
-        case DBG_LOG_SIG: /* intentionally fall through */
-        case ETH_LOG_TCP_SEND_SIG: {
-            /************************************************************/
-            /* WARNING: Do not use any fast logging functions here.  In
-             * fact, avoid using ANY logging here since it could cause an
-             * infinite loop. */
-            /************************************************************/
-            /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[EthDbgEnabled?]} */
-            if (true == me->isEthDbgEnabled) {
-                /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[EthDbgEnabled?]::[ConnExists?]} */
-                if (NULL != LWIPMgr_es_log) {
-                    struct pbuf *p = pbuf_new(
-                        (u8_t *)((LrgDataEvt const *)e)->dataBuf,
-                        ((LrgDataEvt const *)e)->dataLen
-                    );
-                    /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[EthDbgEnabled?]::[ConnExists?]::[MemAvail?]} */
-                    if (p != (struct pbuf *)0) {
-                        LWIPMgr_es_log->p = p;                         // Attach pbuf to the socket state
-                        //dbg_slow_printf("c tcpSend, me->tpcb: %x, LWIPMgr_es_log->pcb: %x\n", (uint32_t) me->tpcb_log, (uint32_t) LWIPMgr_es_log->pcb);
-                        tcp_sent(LWIPMgr_es_log->pcb, LWIP_tcpSent);   // Set callback
-                        bool dataSent = LWIP_tcpSend(
-                            LWIPMgr_es_log->pcb,
-                            LWIPMgr_es_log
-                        );                                             // Queue data for sending
-                        pbuf_free(p);                                  // don't leak the pbuf!
-                        /* ${..LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[EthDbgEnabled?]::[ConnExists?]::[MemAvail?]::[Datanotsent?]} */
-                        if (false == dataSent) {
-                            pbuf_free(p);                                  // don't leak the pbuf!
-                            status_ = Q_TRAN(&LWIPMgr_Sending);
-                        }
-                        /* ${..LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[EthDbgEnabled?]::[ConnExists?]::[MemAvail?]::[else]} */
-                        else {
-                            status_ = Q_HANDLED();
-                        }
-                    }
-                    /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[EthDbgEnabled?]::[ConnExists?]::[else]} */
-                    else {
-                        WRN_printf("MEM unavailable, trying again in a bit...\n");
-                        status_ = Q_TRAN(&LWIPMgr_Sending);
-                    }
-                }
-                /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[EthDbgEnabled?]::[else]} */
-                else {
-                    status_ = Q_HANDLED();
-                }
-            }
-            /* ${AOs::LWIPMgr::SM::Active::Idle::DBG_LOG, ETH_LOG_TCP_SEND::[else]} */
-            else {
-                status_ = Q_HANDLED();
-            }
-            break;
-        }
         /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND} */
         case ETH_SYS_TCP_SEND_SIG: {
-
-
-            /* Event posted that will include (inside it) a msg to send */
-            if (me->upcb->remote_port != (uint16_t)0) {
-                struct pbuf *p = pbuf_new(
-                    (u8_t *)((EthEvt const *)e)->msg,
-                    ((EthEvt const *)e)->msg_len
-                );
-                if (p != (struct pbuf *)0) {
-                    udp_send(me->upcb, p);
-                    pbuf_free(p);                   /* don't leak the pbuf! */
-                }
-            }
             /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND::[ConnExists?]} */
             if (NULL != LWIPMgr_es_sys) {
-                struct pbuf *p = pbuf_new(
-                    (u8_t *)((LrgDataEvt const *)e)->dataBuf,
-                    ((LrgDataEvt const *)e)->dataLen
-                );
-                /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND::[ConnExists?]::[MemAvail?]} */
-                if (p != (struct pbuf *)0) {
-                    LWIPMgr_es_sys->p = p;                         // Attach pbuf to the socket state
-                    //dbg_slow_printf("c tcpSend, me->tpcb: %x, LWIPMgr_es_log->pcb: %x\n", (uint32_t) me->tpcb_log, (uint32_t) LWIPMgr_es_log->pcb);
-                    tcp_sent(LWIPMgr_es_sys->pcb, LWIP_tcpSent);   // Set callback
-                    bool dataSent = LWIP_tcpSend(
+                /* Copy the data straight from the event into the TCP send
+                 * buffer.  If it doesn't fit, hold on to the event until some
+                 * of the data already in flight is acked. */
+                LrgDataEvt const *dataEvt = (LrgDataEvt const *)e;
+                err_t err = ERR_MEM;
+                if (tcp_sndbuf(LWIPMgr_es_sys->pcb) >= dataEvt->dataLen) {
+                    err = tcp_write(
                         LWIPMgr_es_sys->pcb,
-                        LWIPMgr_es_sys
-                    );                                             // Queue data for sending
-                    pbuf_free(p);                                  // don't leak the pbuf!
-                    /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND::[ConnExists?]::[MemAvail?]::[Datanotsent?]} */
-                    if (false == dataSent) {
-                        pbuf_free(p);                                  // don't leak the pbuf!
-                        status_ = Q_TRAN(&LWIPMgr_Sending);
-                    }
-                    /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND::[ConnExists?]::[MemAvail?]::[else]} */
-                    else {
-                        status_ = Q_HANDLED();
-                    }
+                        dataEvt->dataBuf,
+                        dataEvt->dataLen,
+                        TCP_WRITE_FLAG_COPY
+                    );
+                }
+                /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND::[ConnExists?]::[Queued?]} */
+                if (ERR_OK == err) {
+                    /* Push it out now instead of waiting for the TCP timer so
+                     * each response goes out as soon as it's ready. */
+                    tcp_output(LWIPMgr_es_sys->pcb);
+
+                    /* If earlier sends had to wait, keep them coming in order */
+                    QActive_recall((QActive *)me, &me->deferredEvtQueue);
+                    status_ = Q_HANDLED();
                 }
                 /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND::[ConnExists?]::[else]} */
                 else {
-                    WRN_printf("MEM unavailable, trying again in a bit...\n");
+                    if (QEQueue_getNFree(&me->deferredEvtQueue) > 0) {
+                        QActive_defer((QActive *)me, &me->deferredEvtQueue, e);
+                    } else {
+                        ERR_printf("Unable to defer a sys TCP send, dropping %d bytes\n", dataEvt->dataLen);
+                    }
+                    tcp_sent(LWIPMgr_es_sys->pcb, LWIP_tcpSent);   // Get TCP_DONE on ack
                     status_ = Q_TRAN(&LWIPMgr_Sending);
                 }
             }
             /* ${AOs::LWIPMgr::SM::Active::Idle::ETH_SYS_TCP_SEND::[else]} */
             else {
-                ERR_printf("Attempting to send data over system ethernet port but no connection exists.  Something is probably very wrong!\n");
+                /* The client went away while requests were still pending */
+                WRN_printf("No connection on system ethernet port, dropping response\n");
                 status_ = Q_HANDLED();
             }
             break;
@@ -888,10 +1040,8 @@ static QState LWIPMgr_Sending(LWIPMgr * const me, QEvt const * const e) {
             status_ = Q_TRAN(&LWIPMgr_Idle);
             break;
         }
-        /* ${AOs::LWIPMgr::SM::Active::Sending::DBG_LOG, DBG_MENU, ETH_LOG_TCP_SEND} */
-        case DBG_LOG_SIG: /* intentionally fall through */
-        case DBG_MENU_SIG: /* intentionally fall through */
-        case ETH_LOG_TCP_SEND_SIG: {
+        /* ${AOs::LWIPMgr::SM::Active::Sending::ETH_SYS_TCP_SEND} */
+        case ETH_SYS_TCP_SEND_SIG: {
             if (QEQueue_getNFree(&me->deferredEvtQueue) > 0) {
                /* defer the request - this event will be handled
                 * when the state machine goes back to Idle state */
@@ -947,21 +1097,14 @@ static err_t LWIP_tcpAccept(
     LWIP_UNUSED_ARG(arg);
     LWIP_UNUSED_ARG(err);
 
-    if ( LWIPMgr_logPort == newpcb->local_port ) {
-        if ( NULL != LWIPMgr_es_log ) {
-            /* A connection on the logging port exists already. */
-            ret_err = ERR_USE;
-            WRN_printf("A connection on the logging port %d exists already.\n", newpcb->local_port );
-            return ret_err;
-       }
-    } else if ( LWIPMgr_sysPort == newpcb->local_port ) {
+    if ( LWIPMgr_sysPort == newpcb->local_port ) {
         if ( NULL != LWIPMgr_es_sys ) {
             /* A connection on the system port exists already. */
             ret_err = ERR_USE;
-            WRN_printf("A connection on the logging port %d exists already.\n", newpcb->local_port );
+            WRN_printf("A connection on the system port %d exists already.\n", newpcb->local_port );
             return ret_err;
        }
-    } else {
+    } else if ( LWIPMgr_logPort != newpcb->local_port ) {
         ERR_printf("Unknown port number %d\n", newpcb->local_port );
         ret_err = ERR_VAL;
         return ret_err;
@@ -975,7 +1118,33 @@ static err_t LWIP_tcpAccept(
         es->state = ES_ACCEPTED;
         es->pcb = newpcb;
         es->retries = 0;
-        es->p = NULL;
+        es->logId = LOG_FANOUT_NO_CLIENT;
+
+        if ( LWIPMgr_logPort == newpcb->local_port ) {
+            /* Every log client gets its own cursor into the shared log ring */
+            es->logId = LogFanout_open(&l_logFanout, es);
+            LWIP_logSinkUpdate();
+            if ( LOG_FANOUT_NO_CLIENT == es->logId ) {
+                mem_free(es);
+                ret_err = ERR_USE;
+                WRN_printf(
+                    "All %d connections on the logging port %d are in use.\n",
+                    LOG_FANOUT_MAX_CLIENTS, newpcb->local_port
+                );
+                return ret_err;
+            }
+            l_logRxParser[es->logId].lineLen      = 0;  /* Drop leftovers of old connection */
+            l_logRxParser[es->logId].isDiscarding = false;
+            tcp_sent(newpcb, LWIP_tcpSent);     /* Keep the log coming as data is acked */
+            LOG_printf(
+                "New connection %d accepted on log/debug port %d\n",
+                es->logId, newpcb->local_port
+            );
+        } else {
+            LWIPMgr_es_sys = es; /* Tell the opaque pointer about this new structure. */
+            CommFrame_reset(&l_sysFrameParser); /* Drop leftovers of old connection */
+            LOG_printf("New connection accepted on system port %d\n", newpcb->local_port);
+        }
         ret_err = ERR_OK;
 
         /* pass newly allocated es to our callbacks */
@@ -983,18 +1152,6 @@ static err_t LWIP_tcpAccept(
         tcp_recv(newpcb, LWIP_tcpRecv);
         tcp_err(newpcb, LWIP_tcpError);
         tcp_poll(newpcb, LWIP_tcpPoll, 0);
-
-        if ( LWIPMgr_logPort == newpcb->local_port ) {
-            LWIPMgr_es_log = es; /* Tell the opaque pointer about this new structure. */
-            LOG_printf("New connection accepted on log/debug port %d\n", newpcb->local_port);
-        } else if ( LWIPMgr_sysPort == newpcb->local_port ) {
-            LWIPMgr_es_sys = es; /* Tell the opaque pointer about this new structure. */
-            LOG_printf("New connection accepted on system port %d\n", newpcb->local_port);
-        } else {
-            ERR_printf("Unknown port number %d\n", newpcb->local_port );
-            ret_err = ERR_VAL;
-            return ret_err;
-        }
     } else {
         ret_err = ERR_MEM;
         ERR_printf("Error allocating LWIP mem for echo state\n");
@@ -1031,67 +1188,37 @@ static err_t LWIP_tcpRecv(
     LWIP_ASSERT("arg != NULL",arg != NULL);
     es = (struct echo_state *)arg;
     if (p == NULL) {
-        /* remote host closed connection */
+        /* remote host closed connection.  Anything already handed to lwIP still
+         * goes out ahead of the FIN. */
         es->state = ES_CLOSING;
-        if(es->p == NULL) {
-            LOG_printf("Closing connection\n");
-            /* we're done sending, close it */
-            LWIP_tcpClose(tpcb, es);
-        } else {
-            /* we're not done yet */
-            tcp_sent(tpcb, LWIP_tcpSent);
-            LWIP_tcpSend(tpcb, es);
-        }
+        LOG_printf("Closing connection\n");
+        LWIP_tcpClose(tpcb, es);
         ret_err = ERR_OK;
 
     } else if(err != ERR_OK) {
         /* cleanup, for unkown reason */
         if (p != NULL) {
-            es->p = NULL;
             pbuf_free(p);
         }
         ret_err = err;
         ERR_printf("Unknown error\n");
-    } else if(es->state == ES_ACCEPTED) {
-        /* first data chunk in p->payload */
+    } else if(es->state == ES_ACCEPTED || es->state == ES_RECEIVED) {
         es->state = ES_RECEIVED;
-        /* store reference to incoming pbuf (chain) */
-        es->p = p;
-
-        if ( LWIPMgr_logPort == tpcb->local_port ) {
-            /* This eth port can only receive menu commands */
-            MenuEvt *menuEvt = Q_NEW( MenuEvt, DBG_MENU_REQ_SIG );
-
-            /* 2. Fill the msg payload with payload (the actual received msg)*/
-            MEMCPY(
-                  menuEvt->buffer,
-                  p->payload,
-                  (p->tot_len)-1
-            );
-            menuEvt->bufferLen = (p->tot_len)-1;
-            menuEvt->msgSrc = ETH_PORT_LOG;
-
-            /* 3. Publish the newly created event to current AO */
-            QF_PUBLISH( (QEvent *)menuEvt, AO_LWIPMgr );
-
-        } else if ( LWIPMgr_sysPort == tpcb->local_port ) {
-            LOG_printf(
-                "Received data on SYS port %d.\n",
-                tpcb->local_port
-            );
-            EthEvt *ethEvt = Q_NEW(EthEvt, CPLR_ETH_SYS_TEST_SIG);
-
-            /* Fill the msg payload with payload (the actual received msg)*/
-            ethEvt->msg_len = (p->tot_len)-1;
-            MEMCPY(
-                  ethEvt->msg,
-                  p->payload,
-                  ethEvt->msg_len
-            );
-            ethEvt->msg_src = ETH_PORT_SYS;
 
-            /* Post directly to the "raw" queue for FreeRTOS task to read */
-            QEQueue_postFIFO(&CPLR_evtQueue, (QEvt *)ethEvt);
+        /* Run every pbuf of the chain through the parser for this port.  The
+         * parsers keep their state between calls so the segment boundaries
+         * don't matter: a command may span several segments and a segment
+         * may hold several commands. Nothing holds on to the pbuf afterwards. */
+        struct pbuf *q;
+        if ( LOG_FANOUT_NO_CLIENT != es->logId ) {
+            l_logRxClient = es->logId;       /* Replies go back to this client */
+            for ( q = p; q != NULL; q = q->next ) {
+                SerialRx_feed(&l_logRxParser[es->logId], (const uint8_t *)q->payload, q->len);
+            }
+        } else if ( es == LWIPMgr_es_sys ) {
+            for ( q = p; q != NULL; q = q->next ) {
+                CommFrame_feed(&l_sysFrameParser, (const uint8_t *)q->payload, q->len);
+            }
         } else {
             LOG_printf(
                 "Received data on unknown port %d.  Discarding.\n",
@@ -1101,139 +1228,22 @@ static err_t LWIP_tcpRecv(
 
         /* Free the pbuf */
         tcp_recved(tpcb, p->tot_len);
-        es->p = NULL;
         pbuf_free(p);
         ret_err = ERR_OK;
-    } else if (es->state == ES_RECEIVED) {
-        /* read some more data */
-        if(es->p == NULL) {
-            es->p = p;
-
-            if ( LWIPMgr_logPort == tpcb->local_port ) {
-                /* This eth port can only receive menu commands */
-                MenuEvt *menuEvt = Q_NEW( MenuEvt, DBG_MENU_REQ_SIG );
-
-                /* 2. Fill the msg payload with payload (the actual received msg)*/
-                MEMCPY(
-                      menuEvt->buffer,
-                      p->payload,
-                      (p->tot_len)-1
-                );
-                menuEvt->bufferLen = (p->tot_len)-1;
-                menuEvt->msgSrc = ETH_PORT_LOG;
-
-                /* 3. Publish the newly created event to current AO */
-                QF_PUBLISH( (QEvent *)menuEvt, AO_LWIPMgr );
-
-            } else if ( LWIPMgr_sysPort == tpcb->local_port ) {
-                DBG_printf(
-                    "Received data on SYS port %d.\n",
-                    tpcb->local_port
-                );
-                EthEvt *ethEvt = Q_NEW(EthEvt, CPLR_ETH_SYS_TEST_SIG);
-
-                /* Fill the msg payload with payload (the actual received msg)*/
-                ethEvt->msg_len = (p->tot_len)-1;
-                MEMCPY(
-                      ethEvt->msg,
-                      p->payload,
-                      ethEvt->msg_len
-                );
-                ethEvt->msg_src = ETH_PORT_SYS;
-
-                /* Post directly to the "raw" queue for FreeRTOS task to read */
-                QEQueue_postFIFO(&CPLR_evtQueue, (QEvt *)ethEvt);
-            } else {
-                LOG_printf(
-                    "Received data on unknown port %d.  Discarding.\n",
-                    tpcb->local_port
-                );
-            }
-
-            /* Free the pbuf */
-            tcp_recved(tpcb, p->tot_len);
-            es->p = NULL;
-            pbuf_free(p);
-            ret_err = ERR_OK;
-        } else {
-            struct pbuf *ptr;
-             /* chain pbufs to the end of what we recv'ed previously  */
-            ptr = es->p;
-            pbuf_chain(ptr,p);
-        }
-        ret_err = ERR_OK;
     } else if(es->state == ES_CLOSING) {
         /* odd case, remote side closing twice, trash data */
         tcp_recved(tpcb, p->tot_len);
-        es->p = NULL;
         pbuf_free(p);
         ret_err = ERR_OK;
     } else {
         /* unkown es->state, trash data  */
         tcp_recved(tpcb, p->tot_len);
-        es->p = NULL;
         pbuf_free(p);
         ret_err = ERR_OK;
     }
     return ret_err;
 }
 
-/**
- * @brief: A callback function that handles the actual sending of data
- * on a TCP socket.
- * This function is passed in as a callback to tcp_accept().
- *
- * @param [in|out] *tpcb: struct tcp_pcb pointer to the pcb that is handling the
- * context for this connection.
- * @param [in|out] *es: echo_state struct to keep track of the socket state.
- *
- * @return None
- */
-/*${AOs::LWIP_tcpSend} .....................................................*/
-static bool LWIP_tcpSend(struct tcp_pcb * tpcb, struct echo_state * es) {
-    struct pbuf *ptr;
-    err_t wr_err = ERR_OK;
-    bool status = false;
-
-    while ((wr_err == ERR_OK) && (es->p != NULL) && (es->p->len <= tcp_sndbuf(tpcb))) {
-        ptr = es->p;
-        /* enqueue data for transmission */
-        wr_err = tcp_write(tpcb, ptr->payload, ptr->len, 1);
-        if (wr_err == ERR_OK) {
-            status = true;
-            uint16_t plen;
-            uint8_t freed;
-            plen = ptr->len;
-
-            /* continue with next pbuf in chain (if any) */
-            es->p = ptr->next;
-            if(es->p != NULL) {
-                /* new reference! */
-                pbuf_ref(es->p);
-            }
-            /* chop first pbuf from chain */
-            do {
-                /* try hard to free pbuf */
-                freed = pbuf_free(ptr);
-            } while(freed == 0);
-
-            /* we can read more data now */
-            tcp_recved(tpcb, plen);
-        } else if(wr_err == ERR_MEM) {
-            /* we are low on memory, try later / harder, defer to poll */
-            es->p = ptr;
-            WRN_printf("Running low on mem in LWIP, polling later\n");
-            status = false;
-        } else {
-            /* other problem ?? */
-            WRN_printf("Some unknown problem occurred\n");
-            status = false;
-        }
-    }
-
-    return( status );
-}
-
 /**
  * @brief: A callback function that handles the start of a RECV on a
  * TCP socket.
@@ -1255,18 +1265,14 @@ static err_t LWIP_tcpSent(
     uint16_t len)
 {
     struct echo_state *es;
+    LWIP_UNUSED_ARG(tpcb);
     LWIP_UNUSED_ARG(len);
     es = (struct echo_state *)arg;
     es->retries = 0;
-    if(es->p != NULL) {
-        /* still got pbufs to send */
-        tcp_sent(tpcb, LWIP_tcpSent);
-        LWIP_tcpSend(tpcb, es);
+    if ( LOG_FANOUT_NO_CLIENT != es->logId ) {
+        /* Room freed up in the send buffer so send more of this client's log */
+        LWIP_logPump(es->logId);
     } else {
-        /* no more pbufs to send */
-        if(es->state == ES_CLOSING) {
-            LWIP_tcpClose(tpcb, es);
-        }
         QEvt *qEvt = Q_NEW( QEvt, TCP_DONE_SIG);
         QF_PUBLISH(qEvt, AO_LWIPMgr);
     }
@@ -1291,15 +1297,11 @@ static err_t LWIP_tcpPoll(void * arg, struct tcp_pcb * tpcb) {
     struct echo_state *es;
     es = (struct echo_state *)arg;
     if (es != NULL) {
-        if (es->p != NULL) {
-            /* there is a remaining pbuf (chain)  */
-            tcp_sent(tpcb, LWIP_tcpSent);
-            LWIP_tcpSend(tpcb, es);
-        } else {
-            /* no remaining pbuf (chain)  */
-            if(es->state == ES_CLOSING) {
-                LWIP_tcpClose(tpcb, es);
-            }
+        if (es->state == ES_CLOSING) {
+            LWIP_tcpClose(tpcb, es);
+        } else if ( LOG_FANOUT_NO_CLIENT != es->logId ) {
+            /* Pick up any log that didn't fit in the send buffer last time */
+            LWIP_logPump(es->logId);
         }
         ret_err = ERR_OK;
     } else {
@@ -1329,10 +1331,17 @@ static void LWIP_tcpClose(struct tcp_pcb * tpcb, struct echo_state * es) {
     tcp_poll(tpcb, NULL, 0);
 
     if (es != NULL) {
-        if ( LWIPMgr_logPort == tpcb->local_port ) {
-            LWIPMgr_es_log = NULL;
-            LOG_printf("Log/Dbg TCP Connection on port %d closed\n", tpcb->local_port);
-        } else if ( LWIPMgr_sysPort == tpcb->local_port ) {
+        if ( LOG_FANOUT_NO_CLIENT != es->logId ) {
+            LogFanout_close(&l_logFanout, es->logId);
+            LWIP_logSinkUpdate();
+            if ( l_logMenuClient == es->logId ) {
+                l_logMenuClient = LOG_FANOUT_ALL_CLIENTS;
+            }
+            LOG_printf(
+                "Log/Dbg TCP Connection %d on port %d closed\n",
+                es->logId, tpcb->local_port
+            );
+        } else if ( es == LWIPMgr_es_sys ) {
             LWIPMgr_es_sys = NULL;
             LOG_printf("System TCP Connection on port %d closed\n", tpcb->local_port);
         } else {
@@ -1361,24 +1370,215 @@ static void LWIP_tcpError(void * arg, err_t err) {
     struct echo_state *es;
     LWIP_UNUSED_ARG(err);
     es = (struct echo_state *)arg;
+
+    /* lwIP has already freed the pcb by the time this is called so only the
+     * socket state can be used to figure out which connection this was. */
     if (es != NULL) {
-        if ( LWIPMgr_logPort == es->pcb->local_port ) {
-            LWIPMgr_es_log = NULL;
-            LOG_printf("Log/Dbg TCP Connection on port %d closed\n", es->pcb->local_port);
-        } else if ( LWIPMgr_sysPort == es->pcb->local_port ) {
+        if ( LOG_FANOUT_NO_CLIENT != es->logId ) {
+            LogFanout_close(&l_logFanout, es->logId);
+            LWIP_logSinkUpdate();
+            if ( l_logMenuClient == es->logId ) {
+                l_logMenuClient = LOG_FANOUT_ALL_CLIENTS;
+            }
+            LOG_printf("Log/Dbg TCP Connection %d closed\n", es->logId);
+        } else if ( es == LWIPMgr_es_sys ) {
             LWIPMgr_es_sys = NULL;
-            LOG_printf("System TCP Connection on port %d closed\n", es->pcb->local_port);
+            LOG_printf("System TCP Connection closed\n");
         } else {
-            WRN_printf(
-                "Attempting to close an unknown socket on port %d\n",
-                es->pcb->local_port
-            );
+            WRN_printf("Attempting to close an unknown socket\n");
         }
         mem_free(es);
     }
     ERR_printf("Handling error, freeing memory\n");
 }
 
+/* TCP receive parser callbacks .............................................*/
+static void LWIP_logLineHandler(const char *line, uint16_t len) {
+
+    if ( '!' == line[0] ) {
+        LWIP_logCommand(line, len);
+        return;
+    }
+
+    /* Send the menu output back to whoever asked for it */
+    l_logMenuClient = l_logRxClient;
+
+    /* This eth port can only receive menu commands */
+    MenuEvt *menuEvt = Q_NEW( MenuEvt, DBG_MENU_REQ_SIG );
+
+    /* Fill the msg payload with payload (the actual received msg)*/
+    MEMCPY( menuEvt->buffer, line, len );
+    menuEvt->bufferLen = len;
+    menuEvt->msgSrc = ETH_PORT_LOG;
+
+    /* Publish the newly created event to current AO */
+    QF_PUBLISH( (QEvent *)menuEvt, AO_LWIPMgr );
+}
+
+static void LWIP_logCommand(const char *line, uint16_t len) {
+    uint8_t id = l_logRxClient;
+    LogFanoutClient_t const *client = &l_logFanout.clients[id];
+    char cmd[MENU_MAX_CMD_LEN + 1];
+    char reply[128];
+    int replyLen;
+
+    /* Make it a string so strtoul() can be used on it */
+    len = MIN( len, sizeof(cmd) - 1 );
+    MEMCPY( cmd, line, len );
+    cmd[len] = '\0';
+
+    if ( 0 == strncmp( cmd, "!filter", 7 ) ) {
+        char *pos = &cmd[7];
+        char *end;
+        unsigned long lvl = strtoul( pos, &end, 10 );
+        if ( end == pos || lvl > ERR ) {
+            replyLen = FMT_snprintf(
+                reply, sizeof(reply),
+                "Usage: !filter <0=DBG 1=LOG 2=WRN 3=ERR> [<module mask>]\n"
+            );
+        } else {
+            pos = end;
+            unsigned long modlMask = strtoul( pos, &end, 16 );
+            if ( end == pos ) {
+                modlMask = LOG_FANOUT_ALL_MODULES;
+            }
+            LogFanout_setFilter( &l_logFanout, id, (DBG_LEVEL_T)lvl, modlMask );
+            LWIP_logSinkUpdate();
+            replyLen = FMT_snprintf(
+                reply, sizeof(reply),
+                "Log filter: level %lu, modules 0x%08lx\n", lvl, modlMask
+            );
+        }
+    } else if ( 0 == strncmp( cmd, "!stats", 6 ) ) {
+        replyLen = FMT_snprintf(
+            reply, sizeof(reply),
+            "Client %d: sent %lu, filtered %lu, dropped %lu. "
+            "Ring: %lu written, %lu evicted, %d clients\n",
+            id,
+            (unsigned long)client->nSent,
+            (unsigned long)client->nFiltered,
+            (unsigned long)client->nDropped,
+            (unsigned long)l_logFanout.nWritten,
+            (unsigned long)l_logFanout.nEvicted,
+            l_logFanout.nOpen
+        );
+    } else {
+        replyLen = FMT_snprintf(
+            reply, sizeof(reply),
+            "Log port commands: !filter <level> [<module mask>], !stats\n"
+        );
+    }
+
+    LogFanout_write(
+        &l_logFanout, (const uint8_t *)reply, (uint16_t)replyLen, CON, 0, id
+    );
+    LWIP_logPump(id);
+}
+
+/* Log port fan-out ..........................................................*/
+static void LWIP_logPump(uint8_t id) {
+    /************************************************************/
+    /* WARNING: Do not use ANY logging here.  Every log message
+     * ends up back in here and it would loop forever. */
+    /************************************************************/
+    struct echo_state *es = (struct echo_state *)LogFanout_getCtx(&l_logFanout, id);
+    if ( NULL == es || ES_CLOSING == es->state ) {
+        return;
+    }
+
+    LogFanoutClient_t *client = &l_logFanout.clients[id];
+    const uint8_t *data;
+    uint16_t len;
+    bool isQueued = false;
+
+    /* Tell the client it missed something before sending anything newer */
+    if ( client->nDropped != client->nDropsReported ) {
+        char notice[48];
+        len = (uint16_t)FMT_snprintf(
+            notice, sizeof(notice), "*** %lu log records dropped ***\n",
+            (unsigned long)(client->nDropped - client->nDropsReported)
+        );
+        if ( tcp_sndbuf(es->pcb) < len ||
+             ERR_OK != tcp_write(es->pcb, notice, len, TCP_WRITE_FLAG_COPY) ) {
+            return;                      /* Try again once some data is acked */
+        }
+        client->nDropsReported = client->nDropped;
+        isQueued = true;
+    }
+
+    /* Records are copied into the TCP send buffer so they can be released
+     * from the ring right away */
+    while ( NULL != (data = LogFanout_peek(&l_logFanout, id, &len)) ) {
+        if ( tcp_sndbuf(es->pcb) < len ||
+             ERR_OK != tcp_write(es->pcb, data, len, TCP_WRITE_FLAG_COPY) ) {
+            break;
+        }
+        LogFanout_next(&l_logFanout, id);
+        isQueued = true;
+    }
+
+    /* Push it out now instead of waiting for the TCP timer */
+    if ( isQueued ) {
+        tcp_output(es->pcb);
+    }
+}
+
+static void LWIP_logPumpAll(void) {
+    for ( uint8_t id = 0; id < LOG_FANOUT_MAX_CLIENTS; id++ ) {
+        LWIP_logPump(id);
+    }
+}
+
+static void LWIP_logSinkUpdate(void) {
+    DbgSinkFilter_t filter = { { 0 } };
+    bool isAny = false;
+
+    if ( l_LWIPMgr.isEthDbgEnabled ) {
+        for ( uint8_t id = 0; id < LOG_FANOUT_MAX_CLIENTS; id++ ) {
+            LogFanoutClient_t const *client = &l_logFanout.clients[id];
+            if ( client->isOpen ) {
+                DBG_SINK_filterAdd( &filter, client->minLvl, client->modlMask );
+                isAny = true;
+            }
+        }
+    }
+    DBG_SINK_set( DBG_SINK_ETH, isAny ? &filter : NULL );
+}
+
+static uint8_t *LWIP_sysFrameGetBuffer(void *ctx, const CommFrameHdr_t *hdr) {
+    (void)ctx;        /* suppress the compiler warning about unused parameter */
+
+    /* Leave a few events in the pool for the logging and the responses */
+    CommFrameEvt *frameEvt;
+    Q_NEW_X( frameEvt, CommFrameEvt, 4, MSG_FRAME_RECEIVED_SIG );
+    if ( NULL == frameEvt ) {
+        return( NULL );
+    }
+
+    frameEvt->src     = ETH_PORT_SYS;
+    frameEvt->type    = hdr->type;
+    frameEvt->seq     = hdr->seq;
+    frameEvt->dataLen = hdr->len;
+    return( frameEvt->dataBuf );
+}
+
+static void LWIP_sysFrameHandler(void *ctx, const CommFrameHdr_t *hdr,
+                                 uint8_t *payload, bool isValid) {
+    (void)ctx;        /* suppress the compiler warning about unused parameter */
+    (void)hdr;
+
+    /* Get back to the event that owns the payload buffer */
+    CommFrameEvt *frameEvt = (CommFrameEvt *)(
+        payload - offsetof(CommFrameEvt, dataBuf)
+    );
+
+    if ( isValid ) {
+        QF_PUBLISH( (QEvt *)frameEvt, AO_LWIPMgr );
+    } else {
+        QF_gc( (QEvt *)frameEvt );         /* Never published so recycle it */
+    }
+}
+
 /* Ethernet message sender ...................................................*/
 void ETH_SendMsg_Handler(MsgEvt const *e) {
 
@@ -1415,6 +1615,145 @@ static void udp_rx_handler(void *arg, struct udp_pcb *upcb,
     pbuf_free(p);
 }
 
+#ifdef Q_SPY
+/* QSPY UDP handler ..........................................................*/
+static void qspy_udp_rx_handler(void *arg, struct udp_pcb *upcb,
+                                struct pbuf *p, struct ip_addr *addr, u16_t port) {
+    (void)arg;        /* suppress the compiler warning about unused parameter */
+
+    /* 1. Stream the trace to whoever asked for it */
+    udp_connect(upcb, addr, port);
+
+    /* 2. Free up the pbuf */
+    pbuf_free(p);
+}
+
+/* QSPY trace sender .........................................................*/
+static void LWIP_qspyFlush(LWIPMgr * const me) {
+
+    /* Leave the data buffered until a QSPY host shows up since QSPY needs the
+     * dictionaries sent at startup to make sense of the rest of the trace. */
+    if (me->qspy_upcb->remote_port == (uint16_t)0) {
+        return;
+    }
+
+    for (uint8_t i = 0; (i < LWIP_QSPY_MAX_DGRAMS) && (QSPY_level() > 0); ++i) {
+        uint16_t len = (uint16_t)MIN( QSPY_level(), QSPY_DGRAM_SIZE );
+        struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+        if (p == (struct pbuf *)0) {
+            break;              /* out of lwIP memory, data stays in the ring */
+        }
+
+        /* PBUF_RAM pbufs have a single contiguous payload so copy straight in */
+        QSPY_read((uint8_t *)p->payload, len);
+        QSPY_countTx(len, (ERR_OK == udp_send(me->qspy_upcb, p)));
+        pbuf_free(p);                               /* don't leak the pbuf! */
+    }
+}
+#endif                                                             /* Q_SPY */
+
+/* Telemetry UDP handler .....................................................*/
+static void tlm_udp_rx_handler(void *arg, struct udp_pcb *upcb,
+                               struct pbuf *p, struct ip_addr *addr, u16_t port) {
+    LWIPMgr *me = (LWIPMgr *)arg;
+
+    switch (TLM_handleCmd((const uint8_t *)p->payload, p->len)) {
+        case TLM_CMD_SUBSCRIBE:
+            udp_connect(upcb, addr, port);  /* snapshots go to the subscriber */
+            LWIP_tlmSendDict(me, addr, port);
+            break;
+        case TLM_CMD_DICT:
+            LWIP_tlmSendDict(me, addr, port);
+            break;
+        case TLM_CMD_UNSUBSCRIBE:
+            udp_disconnect(upcb);
+            break;
+        default:
+            break;                            /* not a command, just ignore it */
+    }
+
+    pbuf_free(p);
+}
+
+/* Telemetry channels ........................................................*/
+static void LWIP_tlmRegister(void) {
+    #if LWIP_STATS
+    /* The lwIP counters are only 16 bits wide.  The dictionary says so and the
+     * collector takes care of the wrap. */
+    TLM_ADD_VAR("lwip.link.xmit",  TLM_COUNTER, lwip_stats.link.xmit);
+    TLM_ADD_VAR("lwip.link.recv",  TLM_COUNTER, lwip_stats.link.recv);
+    TLM_ADD_VAR("lwip.link.drop",  TLM_COUNTER, lwip_stats.link.drop);
+    TLM_ADD_VAR("lwip.link.err",   TLM_COUNTER, lwip_stats.link.err);
+    TLM_ADD_VAR("lwip.udp.drop",   TLM_COUNTER, lwip_stats.udp.drop);
+    TLM_ADD_VAR("lwip.tcp.xmit",   TLM_COUNTER, lwip_stats.tcp.xmit);
+    TLM_ADD_VAR("lwip.tcp.recv",   TLM_COUNTER, lwip_stats.tcp.recv);
+    TLM_ADD_VAR("lwip.tcp.drop",   TLM_COUNTER, lwip_stats.tcp.drop);
+    TLM_ADD_VAR("lwip.mem.used",   TLM_GAUGE,   lwip_stats.mem.used);
+    TLM_ADD_VAR("lwip.mem.max",    TLM_GAUGE,   lwip_stats.mem.max);
+    TLM_ADD_VAR("lwip.mem.err",    TLM_COUNTER, lwip_stats.mem.err);
+    TLM_ADD_VAR("lwip.pbuf.used",  TLM_GAUGE,   lwip_stats.memp[MEMP_PBUF_POOL].used);
+    TLM_ADD_VAR("lwip.tcpseg.used", TLM_GAUGE,  lwip_stats.memp[MEMP_TCP_SEG].used);
+    #endif
+
+    TLM_ADD_VAR("eth.rx.irqs",     TLM_COUNTER, eth_driver_getStats()->rxIrqs);
+    TLM_ADD_VAR("eth.rx.polls",    TLM_COUNTER, eth_driver_getStats()->rxPolls);
+    TLM_ADD_VAR("eth.rx.frames",   TLM_COUNTER, eth_driver_getStats()->rxFrames);
+    TLM_ADD_VAR("eth.rx.resched",  TLM_COUNTER, eth_driver_getStats()->rxResched);
+    TLM_ADD_VAR("eth.tx.irqs",     TLM_COUNTER, eth_driver_getStats()->txIrqs);
+    TLM_ADD_VAR("eth.tx.queued",   TLM_COUNTER, eth_driver_getStats()->txQueued);
+
+    TLM_ADD_VAR("log.written",     TLM_COUNTER, l_logFanout.nWritten);
+    TLM_ADD_VAR("log.evicted",     TLM_COUNTER, l_logFanout.nEvicted);
+    TLM_ADD_VAR("tlm.sendErr",     TLM_COUNTER, TLM_getStats()->nSendErrors);
+}
+
+/* Telemetry senders .........................................................*/
+static void LWIP_tlmSendDict(LWIPMgr * const me,
+                             struct ip_addr *addr, u16_t port) {
+    uint8_t first = 0;
+
+    while (first < TLM_getNChannels()) {
+        struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, TLM_DGRAM_MAX_LEN, PBUF_RAM);
+        if (p == (struct pbuf *)0) {
+            TLM_countSendError();
+            break;        /* out of lwIP memory, the collector can ask again */
+        }
+
+        uint8_t next;
+        uint16_t len = TLM_buildDict(
+            (uint8_t *)p->payload, TLM_DGRAM_MAX_LEN, sys_now(), first, &next
+        );
+        if (len == 0) {
+            pbuf_free(p);
+            break;
+        }
+
+        pbuf_realloc(p, len);              /* only send what was filled in */
+        if (ERR_OK != udp_sendto(me->tlm_upcb, p, addr, port)) {
+            TLM_countSendError();
+        }
+        pbuf_free(p);                               /* don't leak the pbuf! */
+        first = next;
+    }
+}
+
+/*............................................................................*/
+static void LWIP_tlmSendSnapshot(LWIPMgr * const me) {
+    uint16_t len = TLM_getSnapshotLen();
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+    if (p == (struct pbuf *)0) {
+        TLM_countSendError();
+        return;              /* out of lwIP memory, skip this one snapshot */
+    }
+
+    /* PBUF_RAM pbufs have a single contiguous payload so build straight in */
+    TLM_buildSnapshot((uint8_t *)p->payload, len, sys_now());
+    if (ERR_OK != udp_send(me->tlm_upcb, p)) {
+        TLM_countSendError();
+    }
+    pbuf_free(p);                                   /* don't leak the pbuf! */
+}
+
 /**
  * @}
  * end addtogroup groupLWIP_QPC_Eth
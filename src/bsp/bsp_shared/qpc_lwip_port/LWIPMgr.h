@@ -63,6 +63,9 @@ enum LWIPMgrSignals {
     TCP_DONE_SIG,
     TCP_TIMEOUT_SIG,
     MAX_PUB_SIG,                                  /* the last published signal */
+
+    /* Signals below are only ever posted directly to LWIPMgr */
+    ETH_QSPY_FLUSH_SIG = MAX_PUB_SIG,
 };
 
 
@@ -0,0 +1,329 @@
+/**
+ * @file   log_fanout.c
+ * @brief  Definitions for the shared log buffer that feeds several log
+ * clients at once.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupLWIP_QPC_Eth
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "log_fanout.h"
+#include <string.h>
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct LogFanoutRec_t
+ * Header in front of every record in the ring.  Always 8 byte aligned.
+ */
+typedef struct LogFanoutRec
+{
+   uint16_t len;                          /**< Length of the text that follows */
+   uint8_t  lvl;                /**< DBG_LEVEL_T or LOG_FANOUT_LVL_PAD */
+   uint8_t  dst;       /**< Client id of a CON record or LOG_FANOUT_ALL_CLIENTS */
+   uint32_t modl;                  /**< DBG_MODL_T module or 0 if unknown */
+} LogFanoutRec_t;
+
+/* Private defines -----------------------------------------------------------*/
+
+/**< Level of the record that fills the end of the ring before a wrap */
+#define LOG_FANOUT_LVL_PAD                                                0xFF
+
+/* Private macros ------------------------------------------------------------*/
+
+/**< Space a record with len bytes of text takes up in the ring */
+#define LOG_FANOUT_REC_SIZE( len )  \
+   ( LOG_FANOUT_HDR_LEN + ( ((uint32_t)(len) + 7UL) & ~7UL ) )
+
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Get the header of the record at a position in the ring.
+ * @param [in] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] pos: uint32_t position of the record.
+ * @return: LogFanoutRec_t pointer to the header.
+ */
+static inline LogFanoutRec_t* LogFanout_rec( LogFanout_t *fan, uint32_t pos );
+
+/**
+ * @brief   Check if a client should get a record.
+ * @param [in] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] id: uint8_t id of the client.
+ * @param [in] *rec: LogFanoutRec_t pointer to the header of the record.
+ * @return: bool true if the client wants the record.
+ */
+static bool LogFanout_wants(
+      LogFanout_t *fan,
+      uint8_t id,
+      const LogFanoutRec_t *rec
+);
+
+/**
+ * @brief   Throw away the oldest record in the ring.
+ *
+ * Clients that hadn't read it yet are moved past it and, if they would have
+ * been sent the record, it is counted as dropped for them.
+ *
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @return: None
+ */
+static void LogFanout_evict( LogFanout_t *fan );
+
+/**
+ * @brief   Reserve space at the head of the ring and fill in the header.
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] recSize: uint32_t space to reserve.  Must fit in the ring.
+ * @param [in] len: uint16_t length of the text.
+ * @param [in] lvl: uint8_t level of the record.
+ * @param [in] dst: uint8_t destination of the record.
+ * @param [in] modl: uint32_t module of the record.
+ * @return: LogFanoutRec_t pointer to the header of the new record.
+ */
+static LogFanoutRec_t* LogFanout_reserve(
+      LogFanout_t *fan,
+      uint32_t recSize,
+      uint16_t len,
+      uint8_t lvl,
+      uint8_t dst,
+      uint32_t modl
+);
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static inline LogFanoutRec_t* LogFanout_rec( LogFanout_t *fan, uint32_t pos )
+{
+   return( (LogFanoutRec_t *)&fan->ring[pos & (fan->size - 1)] );
+}
+
+/******************************************************************************/
+static bool LogFanout_wants(
+      LogFanout_t *fan,
+      uint8_t id,
+      const LogFanoutRec_t *rec
+)
+{
+   if ( LOG_FANOUT_LVL_PAD == rec->lvl ) {
+      return( false );
+   }
+
+   /* Direct console output goes where it was sent no matter the filter */
+   if ( CON == rec->lvl ) {
+      return( LOG_FANOUT_ALL_CLIENTS == rec->dst || id == rec->dst );
+   }
+
+   const LogFanoutClient_t *client = &fan->clients[id];
+   return(
+         rec->lvl >= client->minLvl
+         && ( 0 == rec->modl || 0 != (rec->modl & client->modlMask) )
+   );
+}
+
+/******************************************************************************/
+static void LogFanout_evict( LogFanout_t *fan )
+{
+   const LogFanoutRec_t *rec = LogFanout_rec( fan, fan->tail );
+   uint32_t recSize = LOG_FANOUT_REC_SIZE( rec->len );
+
+   for ( uint8_t id = 0; id < LOG_FANOUT_MAX_CLIENTS; id++ ) {
+      LogFanoutClient_t *client = &fan->clients[id];
+      if ( client->isOpen && client->cursor == fan->tail ) {
+         if ( LogFanout_wants( fan, id, rec ) ) {
+            client->nDropped++;
+         }
+         client->cursor += recSize;
+      }
+   }
+
+   if ( LOG_FANOUT_LVL_PAD != rec->lvl ) {
+      fan->nEvicted++;
+   }
+   fan->tail += recSize;
+}
+
+/******************************************************************************/
+static LogFanoutRec_t* LogFanout_reserve(
+      LogFanout_t *fan,
+      uint32_t recSize,
+      uint16_t len,
+      uint8_t lvl,
+      uint8_t dst,
+      uint32_t modl
+)
+{
+   while ( fan->head - fan->tail + recSize > fan->size ) {
+      LogFanout_evict( fan );
+   }
+
+   LogFanoutRec_t *rec = LogFanout_rec( fan, fan->head );
+   rec->len  = len;
+   rec->lvl  = lvl;
+   rec->dst  = dst;
+   rec->modl = modl;
+   fan->head += recSize;
+   return( rec );
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/******************************************************************************/
+void LogFanout_init( LogFanout_t *fan, uint8_t *ring, uint32_t size )
+{
+   memset( fan, 0, sizeof(*fan) );
+   fan->ring = ring;
+   fan->size = size;
+}
+
+/******************************************************************************/
+uint8_t LogFanout_open( LogFanout_t *fan, void *ctx )
+{
+   for ( uint8_t id = 0; id < LOG_FANOUT_MAX_CLIENTS; id++ ) {
+      LogFanoutClient_t *client = &fan->clients[id];
+      if ( !client->isOpen ) {
+         memset( client, 0, sizeof(*client) );
+         client->isOpen   = true;
+         client->cursor   = fan->head;
+         client->minLvl   = DBG;
+         client->modlMask = LOG_FANOUT_ALL_MODULES;
+         client->ctx      = ctx;
+         fan->nOpen++;
+         return( id );
+      }
+   }
+   return( LOG_FANOUT_NO_CLIENT );
+}
+
+/******************************************************************************/
+void LogFanout_close( LogFanout_t *fan, uint8_t id )
+{
+   if ( id < LOG_FANOUT_MAX_CLIENTS && fan->clients[id].isOpen ) {
+      fan->clients[id].isOpen = false;
+      fan->clients[id].ctx    = NULL;
+      fan->nOpen--;
+   }
+}
+
+/******************************************************************************/
+void* LogFanout_getCtx( LogFanout_t *fan, uint8_t id )
+{
+   if ( id < LOG_FANOUT_MAX_CLIENTS && fan->clients[id].isOpen ) {
+      return( fan->clients[id].ctx );
+   }
+   return( NULL );
+}
+
+/******************************************************************************/
+void LogFanout_setFilter(
+      LogFanout_t *fan,
+      uint8_t id,
+      DBG_LEVEL_T minLvl,
+      uint32_t modlMask
+)
+{
+   if ( id < LOG_FANOUT_MAX_CLIENTS ) {
+      fan->clients[id].minLvl   = minLvl;
+      fan->clients[id].modlMask = modlMask;
+   }
+}
+
+/******************************************************************************/
+bool LogFanout_write(
+      LogFanout_t *fan,
+      const uint8_t *data,
+      uint16_t len,
+      DBG_LEVEL_T lvl,
+      uint32_t modl,
+      uint8_t dst
+)
+{
+   if ( 0 == fan->nOpen ) {
+      return( false );
+   }
+
+   uint32_t recSize = LOG_FANOUT_REC_SIZE( len );
+   if ( recSize > fan->size ) {
+      fan->nTooBig++;
+      return( false );
+   }
+
+   /* Records never wrap.  Fill the end of the ring with a pad record first if
+    * this one doesn't fit before the end.  The pad itself may get evicted to
+    * make room for the record, which is fine. */
+   uint32_t toEnd = fan->size - (fan->head & (fan->size - 1));
+   if ( recSize > toEnd ) {
+      LogFanout_reserve(
+            fan,
+            toEnd,
+            (uint16_t)(toEnd - LOG_FANOUT_HDR_LEN),
+            LOG_FANOUT_LVL_PAD,
+            LOG_FANOUT_ALL_CLIENTS,
+            0
+      );
+   }
+
+   LogFanoutRec_t *rec = LogFanout_reserve(
+         fan,
+         recSize,
+         len,
+         (uint8_t)lvl,
+         dst,
+         modl
+   );
+   memcpy( (uint8_t *)rec + LOG_FANOUT_HDR_LEN, data, len );
+   fan->nWritten++;
+   return( true );
+}
+
+/******************************************************************************/
+const uint8_t* LogFanout_peek( LogFanout_t *fan, uint8_t id, uint16_t *pLen )
+{
+   if ( id >= LOG_FANOUT_MAX_CLIENTS || !fan->clients[id].isOpen ) {
+      return( NULL );
+   }
+
+   LogFanoutClient_t *client = &fan->clients[id];
+   while ( client->cursor != fan->head ) {
+      LogFanoutRec_t *rec = LogFanout_rec( fan, client->cursor );
+      if ( LogFanout_wants( fan, id, rec ) ) {
+         *pLen = rec->len;
+         return( (const uint8_t *)rec + LOG_FANOUT_HDR_LEN );
+      }
+
+      if ( LOG_FANOUT_LVL_PAD != rec->lvl ) {
+         client->nFiltered++;
+      }
+      client->cursor += LOG_FANOUT_REC_SIZE( rec->len );
+   }
+   return( NULL );
+}
+
+/******************************************************************************/
+void LogFanout_next( LogFanout_t *fan, uint8_t id )
+{
+   if ( id >= LOG_FANOUT_MAX_CLIENTS ) {
+      return;
+   }
+
+   LogFanoutClient_t *client = &fan->clients[id];
+   if ( client->isOpen && client->cursor != fan->head ) {
+      client->cursor += LOG_FANOUT_REC_SIZE(
+            LogFanout_rec( fan, client->cursor )->len
+      );
+      client->nSent++;
+   }
+}
+
+/**
+ * @}
+ * end addtogroup groupLWIP_QPC_Eth
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,233 @@
+/**
+ * @file   log_fanout.h
+ * @brief  Declarations for the shared log buffer that feeds several log
+ * clients at once.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupLWIP_QPC_Eth
+ * @{
+ *
+ * Every log record is written once into a single ring and every client has
+ * its own cursor into that ring.  Sending to a client only moves its cursor,
+ * so any number of clients can read the same records without copying them
+ * and without waiting on each other.
+ *
+ * Records are stored whole and never wrap around the end of the ring:
+ *
+ *    | len (2) | level (1) | dst (1) | module (4) | data (len) | pad to 8 |
+ *
+ * If a record doesn't fit before the end of the ring, the rest of the ring is
+ * filled with a pad record and the record starts at the beginning.
+ *
+ * When the ring is full, the oldest record is thrown away to make room.  Any
+ * client whose cursor still points at that record is moved past it and the
+ * record is counted as dropped for that client.  A slow client therefore only
+ * ever loses its own backlog and never holds up the writer or other clients.
+ *
+ * Each client has a level and module filter.  Records below the level or
+ * from a module that isn't in the mask are skipped for that client.  Records
+ * with the CON level are direct output (menu replies) and are never filtered.
+ * They go either to a single client or to all of them.
+ *
+ * This module has no hardware or RTOS dependencies so it can be compiled on a
+ * host and benchmarked.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef LOG_FANOUT_H_
+#define LOG_FANOUT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "dbg_cntrl.h"                     /* For DBG_LEVEL_T and DBG_MODL_T */
+
+/* Exported defines ----------------------------------------------------------*/
+#define LOG_FANOUT_MAX_CLIENTS                                               4
+
+/**< Client id returned by LogFanout_open() when all clients are in use */
+#define LOG_FANOUT_NO_CLIENT                                              0xFF
+
+/**< Destination of a CON record that goes to every client */
+#define LOG_FANOUT_ALL_CLIENTS                                            0xFE
+
+/**< Module mask of a client that wants records from every module */
+#define LOG_FANOUT_ALL_MODULES                                     0xFFFFFFFFUL
+
+/**< Size of the header in front of every record in the ring */
+#define LOG_FANOUT_HDR_LEN                                                   8
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct LogFanoutClient_t
+ * State of a single reader of the log ring.
+ */
+typedef struct LogFanoutClient
+{
+   bool          isOpen;                    /**< Client slot is in use */
+   uint32_t      cursor;     /**< Ring position of the next record to read */
+   DBG_LEVEL_T   minLvl;       /**< Records below this level are skipped */
+   uint32_t      modlMask;   /**< DBG_MODL_T modules this client wants */
+   void         *ctx;              /**< Owner context passed to open */
+
+   uint32_t      nSent;     /**< Records handed over with LogFanout_next() */
+   uint32_t      nFiltered;       /**< Records skipped by the filter */
+   uint32_t      nDropped;   /**< Records lost because client fell behind */
+   uint32_t      nDropsReported;/**< nDropped the owner already told about */
+} LogFanoutClient_t;
+
+/**
+ * \struct LogFanout_t
+ * Shared log ring and all of its clients.
+ */
+typedef struct LogFanout
+{
+   uint8_t            *ring;                      /**< Record storage */
+   uint32_t            size;/**< Size of the ring.  A power of 2, at least 64 */
+   uint32_t            head;            /**< Where the next record goes */
+   uint32_t            tail;     /**< Oldest record still in the ring */
+   uint8_t             nOpen;                 /**< Number of open clients */
+
+   LogFanoutClient_t   clients[LOG_FANOUT_MAX_CLIENTS];   /**< Readers */
+
+   uint32_t            nWritten;          /**< Records written to the ring */
+   uint32_t            nEvicted;  /**< Records thrown away to make room */
+   uint32_t            nTooBig;   /**< Records that could never fit */
+} LogFanout_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Initialize a log fan-out with no clients.
+ *
+ * @param [out] *fan: LogFanout_t pointer to the fan-out to initialize.
+ * @param [in] *ring: pointer to the record storage.  Must be 8 byte aligned.
+ * @param [in] size: uint32_t size of the storage.  Must be a power of 2 and at
+ * least 64 bytes.
+ * @return: None
+ */
+void LogFanout_init( LogFanout_t *fan, uint8_t *ring, uint32_t size );
+
+/**
+ * @brief   Add a client.
+ *
+ * The client starts at the current end of the ring so it only gets records
+ * written after it was opened.  Its filter lets everything through.
+ *
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] *ctx: void pointer the owner can get back with
+ * LogFanout_getCtx().
+ * @return: uint8_t id of the new client or LOG_FANOUT_NO_CLIENT if all the
+ * client slots are in use.
+ */
+uint8_t LogFanout_open( LogFanout_t *fan, void *ctx );
+
+/**
+ * @brief   Remove a client.  Whatever it hadn't read yet is forgotten.
+ *
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] id: uint8_t id of the client.
+ * @return: None
+ */
+void LogFanout_close( LogFanout_t *fan, uint8_t id );
+
+/**
+ * @brief   Get the owner context of a client.
+ *
+ * @param [in] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] id: uint8_t id of the client.
+ * @return: void pointer passed to LogFanout_open() or NULL if the client isn't
+ * open.
+ */
+void* LogFanout_getCtx( LogFanout_t *fan, uint8_t id );
+
+/**
+ * @brief   Set which records a client gets.
+ *
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] id: uint8_t id of the client.
+ * @param [in] minLvl: DBG_LEVEL_T lowest level to send.  DBG sends everything.
+ * @param [in] modlMask: uint32_t mask of DBG_MODL_T modules to send.
+ * @return: None
+ */
+void LogFanout_setFilter(
+      LogFanout_t *fan,
+      uint8_t id,
+      DBG_LEVEL_T minLvl,
+      uint32_t modlMask
+);
+
+/**
+ * @brief   Append a record to the ring.
+ *
+ * Makes room by throwing away the oldest records if needed.  Does nothing if
+ * no clients are open.
+ *
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] *data: pointer to the text of the record.
+ * @param [in] len: uint16_t length of the text.
+ * @param [in] lvl: DBG_LEVEL_T level of the record.  CON records are never
+ * filtered.
+ * @param [in] modl: uint32_t DBG_MODL_T module that wrote the record or 0 if
+ * unknown.  Records with no module pass every module filter.
+ * @param [in] dst: uint8_t id of the only client that gets a CON record or
+ * LOG_FANOUT_ALL_CLIENTS.  Ignored for other levels.
+ * @return: bool true if the record was written.
+ */
+bool LogFanout_write(
+      LogFanout_t *fan,
+      const uint8_t *data,
+      uint16_t len,
+      DBG_LEVEL_T lvl,
+      uint32_t modl,
+      uint8_t dst
+);
+
+/**
+ * @brief   Get the next record a client should be sent.
+ *
+ * Records the client's filter doesn't want are skipped.  The record stays in
+ * place until LogFanout_next() is called, so if it can't be sent right now the
+ * same record is returned again next time.  The returned pointer is only good
+ * until the next LogFanout_write().
+ *
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] id: uint8_t id of the client.
+ * @param [out] *pLen: uint16_t pointer to where to store the length of the
+ * record.
+ * @return: const uint8_t* pointer to the text of the record or NULL if the
+ * client is caught up.
+ */
+const uint8_t* LogFanout_peek( LogFanout_t *fan, uint8_t id, uint16_t *pLen );
+
+/**
+ * @brief   Move a client past the record returned by LogFanout_peek().
+ *
+ * @param [in,out] *fan: LogFanout_t pointer to the fan-out.
+ * @param [in] id: uint8_t id of the client.
+ * @return: None
+ */
+void LogFanout_next( LogFanout_t *fan, uint8_t id );
+
+/**
+ * @}
+ * end addtogroup groupLWIP_QPC_Eth
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* LOG_FANOUT_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -163,7 +163,10 @@ The STM32F207 allows computing and verifying the IP, UDP, TCP and ICMP checksums
    lwIP is compiled. 4 byte alignment -> define MEM_ALIGNMENT to 4, 2
    byte alignment -> define MEM_ALIGNMENT to 2. */
 #define MEM_ALIGNMENT                   4           // default is 1
-#define MEM_SIZE                        (3 * 1024)  // default is 1600
+/* Every TCP connection can have up to TCP_SND_BUF of copied data waiting for
+   acks in the heap: one system connection and up to LOG_FANOUT_MAX_CLIENTS log
+   connections. */
+#define MEM_SIZE                        (16 * 1024) // default is 1600
 //#define MEMP_SEPARATE_POOLS             0
 //#define MEMP_OVERFLOW_CHECK             0
 //#define MEMP_SANITY_CHECK               0
@@ -188,9 +191,9 @@ The STM32F207 allows computing and verifying the IP, UDP, TCP and ICMP checksums
 /* MEMP_NUM_TCP_PCB: the number of simulatenously active TCP
    connections. Technically, we don't need any since this
    application is all UDP */
-#define MEMP_NUM_TCP_PCB                5          // default 5
+#define MEMP_NUM_TCP_PCB                6          // default 5
 //#define MEMP_NUM_TCP_PCB_LISTEN         8
-//#define MEMP_NUM_TCP_SEG                16
+#define MEMP_NUM_TCP_SEG                32         // default 16
 //#define MEMP_NUM_REASSDATA              5
 //#define MEMP_NUM_ARP_QUEUE              30
 //#define MEMP_NUM_IGMP_GROUP             8
@@ -457,13 +460,15 @@ The STM32F207 allows computing and verifying the IP, UDP, TCP and ICMP checksums
 // ---------- Statistics options ----------
 //
 //****************************************************************************
-#define LWIP_STATS						      0
-//#define LWIP_STATS_DISPLAY              0
-#define LINK_STATS                        0
-//#define ETHARP_STATS                    (LWIP_ARP)
-//#define IP_STATS                        1
-//#define IPFRAG_STATS                    (IP_REASSEMBLY || IP_FRAG)
-//#define ICMP_STATS                      1
+/* Kept on for the UDP telemetry stream (see telemetry.h).  Only the counters
+ * that are streamed are enabled. */
+#define LWIP_STATS                        1
+#define LWIP_STATS_DISPLAY                0
+#define LINK_STATS                        1
+#define ETHARP_STATS                      0
+#define IP_STATS                          0
+#define IPFRAG_STATS                      0
+#define ICMP_STATS                        0
 //#define IGMP_STATS                      (LWIP_IGMP)
 //#define UDP_STATS                       (LWIP_UDP)
 //#define TCP_STATS                       (LWIP_TCP)
@@ -15,6 +15,7 @@
  */
 
 /* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
 #include "netif/eth_driver.h"
 #include "stm32f4x7_eth.h"
 #include "stm32f4x7_eth_bsp.h"
@@ -67,9 +68,30 @@ static uint8_t       PbufQueue_put(PbufQueue *me, struct pbuf *p);
 /**< LWIP Pbuf queue get */
 static struct pbuf*  PbufQueue_get(PbufQueue *me);
 
+/**< Is the next TX descriptor ours to fill */
+static bool          eth_driver_txFree(void);
+
+/**< Is there anything in the RX ring */
+static bool          eth_driver_rxPending(void);
+
+/**< Send as much of the TX queue as there are free TX descriptors for */
+static void          eth_driver_txDrain(void);
+
+/**< Turn DMA interrupts on or off from the AO */
+static void          eth_driver_itConfig(uint32_t it, FunctionalState state);
+
 static struct netif 	l_netif;               /**< the single network interface */
 static QActive* 		l_active; /**< active object associated with this driver */
 static PbufQueue 		l_txq;              /**< queue of pbufs for transmission */
+static EthDriverStats_t l_stats;                 /**< see eth_driver_getStats() */
+
+/**< The TX interrupt is on or its LWIP_TX_READY_SIG hasn't been handled yet */
+static bool             l_bTxIrqArmed;
+
+/**< Events posted to the AO.  eth_driver_read() posts LWIP_RX_READY_SIG to
+ * itself too when it runs out of budget. */
+static QEvent const     l_evtRxReady = { LWIP_RX_READY_SIG, 0 };
+static QEvent const     l_evtTxReady = { LWIP_TX_READY_SIG, 0 };
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -157,62 +179,119 @@ struct netif *eth_driver_init(
 }
 /*..........................................................................*/
 void eth_driver_read(void) {
-
-/* This is a fix for the slowdown issue due to a buildup of packets in the
- * DMA buffer.  Normally, only one packet is read at a time and the rest sit
- * there eliminating useful buffers, eventually leading to a slowdown. Yeah,
- * GOTOs are bad.  Get over it. */
-GET_NEXT_FRAGMENT:;
-    struct pbuf *p = low_level_receive();
-    if (p != NULL) {                  /* new packet received into the pbuf? */
-        if (ethernet_input(p, &l_netif) != ERR_OK) {   /* pbuf not handled? */
-            LWIP_DEBUGF(NETIF_DEBUG, ("eth_driver_input: input error\n"));
-            pbuf_free(p);                                  /* free the pbuf */
-            p = NULL;
-        } else {
-        	goto GET_NEXT_FRAGMENT;  // See note at the beginning of function.
-        }
-
-        /* try to output a packet if TX fifo is empty and pbuf is available */
-        if( ETH_GetDMAFlagStatus(ETH_DMA_FLAG_TBU) == RESET) {
-            p = PbufQueue_get(&l_txq);
-            if (p != NULL) {
-                low_level_transmit(&l_netif, p);
-                pbuf_free(p);    /* free the pbuf, lwIP knows nothing of it */
-                p = NULL;
+    uint16_t nFrames = 0;
+    bool bMore;
+
+    l_stats.rxPolls++;
+
+    /* The RX interrupt stays off until the ring is empty, so a burst costs an
+     * interrupt and an event per ETH_RX_BUDGET frames rather than per frame.
+     * The budget keeps the burst from holding up the other events of the AO. */
+    do {
+        struct pbuf *p = low_level_receive();
+        if (p != NULL) {              /* new packet received into the pbuf? */
+            l_stats.rxFrames++;
+            if (ethernet_input(p, &l_netif) != ERR_OK) { /* pbuf not handled? */
+                LWIP_DEBUGF(NETIF_DEBUG, ("eth_driver_input: input error\n"));
+                pbuf_free(p);                              /* free the pbuf */
             }
         }
+        nFrames++;
+        bMore = eth_driver_rxPending();
+    } while ( bMore && nFrames < ETH_RX_BUDGET );
+
+    /* Whatever lwIP sent back may have found the TX descriptors busy */
+    eth_driver_txDrain();
+
+    if ( !bMore ) {
+        /* Clear the RX status before the last look at the ring.  A frame that
+         * comes in after that raises the interrupt as soon as it's enabled. */
+        ETH_DMAClearITPendingBit(ETH_DMA_IT_R);
+        bMore = eth_driver_rxPending();
     }
 
-    /* re-enable the RX interrupt */
-    ETH_DMAITConfig(ETH_DMA_IT_NIS | ETH_DMA_IT_R, ENABLE);
+    if ( bMore ) {
+        /* Go to the back of the queue, behind the events that came in while
+         * this ran, and carry on with the ring from there. */
+        l_stats.rxResched++;
+        QACTIVE_POST(l_active, &l_evtRxReady, l_active);
+    } else {
+        /* re-enable the RX interrupt */
+        eth_driver_itConfig(ETH_DMA_IT_NIS | ETH_DMA_IT_R, ENABLE);
+    }
 }
 
 /******************************************************************************/
 void eth_driver_write(void)
 {
-	if ( ETH_GetDMAFlagStatus(ETH_DMA_FLAG_TBU) == RESET) { /* TX fifo available*/
+    l_bTxIrqArmed = false;          /* This is the event the interrupt posted */
+    eth_driver_txDrain();
+}
+
+/******************************************************************************/
+const EthDriverStats_t* eth_driver_getStats(void)
+{
+    return(&l_stats);
+}
+
+/******************************************************************************/
+static bool eth_driver_txFree(void)
+{
+    return( 0 == (DMATxDescToSet->Status & ETH_DMATxDesc_OWN) );
+}
+
+/******************************************************************************/
+static bool eth_driver_rxPending(void)
+{
+    return( 0 == (DMARxDescToGet->Status & ETH_DMARxDesc_OWN) );
+}
+
+/******************************************************************************/
+static void eth_driver_txDrain(void)
+{
+    while ( !PbufQueue_isEmpty(&l_txq) && eth_driver_txFree() ) {
         struct pbuf *p = PbufQueue_get(&l_txq);
-        if (p != NULL) {                        /* pbuf found in the queue? */
-            low_level_transmit(&l_netif, p);
-            pbuf_free(p);        /* free the pbuf, lwIP knows nothing of it */
-        }
+        low_level_transmit(&l_netif, p);
+        pbuf_free(p);            /* free the pbuf, lwIP knows nothing of it */
+    }
+
+    /* Frames still waiting: have the DMA tell when it gives a descriptor back.
+     * The interrupt turns itself off, so there's never more than one
+     * LWIP_TX_READY_SIG on its way. */
+    if ( !PbufQueue_isEmpty(&l_txq) && !l_bTxIrqArmed ) {
+        l_bTxIrqArmed = true;
+        eth_driver_itConfig(ETH_DMA_IT_NIS | ETH_DMA_IT_T, ENABLE);
     }
 }
 
+/******************************************************************************/
+static void eth_driver_itConfig(uint32_t it, FunctionalState state)
+{
+    QF_CRIT_STAT_TYPE intStat;
+
+    /* ETH_EventCallback() turns interrupts off in the same register, so it
+     * can't be let in halfway through the read-modify-write */
+    QF_CRIT_ENTRY(intStat);
+    ETH_DMAITConfig(it, state);
+    QF_CRIT_EXIT(intStat);
+}
+
 /******************************************************************************/
 err_t ethernetif_output(struct netif *netif, struct pbuf *p)
 {
     if (PbufQueue_isEmpty(&l_txq) &&            /* nothing in the TX queue? */
-        ETH_GetDMAFlagStatus(ETH_DMA_FLAG_TBU) == RESET) {     /* TX empty? */
+        eth_driver_txFree()) {                   /* TX descriptor available? */
     	low_level_transmit(netif, p);               /* send the pbuf right away */
         /* the pbuf will be freed by the lwIP code */
     }
     else {                 /* otherwise post the pbuf to the transmit queue */
         if (PbufQueue_put(&l_txq, p)) { /*could the TX queue take the pbuf? */
             pbuf_ref(p);     /* reference the pbuf to spare it from freeing */
+            l_stats.txQueued++;
+            eth_driver_txDrain();        /* wait for the TX interrupt if busy */
         } else {                                    /* no room in the queue */
         	/* the pbuf will be freed by the lwIP code */
+            LINK_STATS_INC(link.drop);
             return(ERR_MEM);
         }
     }
@@ -231,7 +310,10 @@ err_t ethernetif_init(struct netif *netif)
      * is available...)
      */
     netif->output = etharp_output;
-    netif->linkoutput = (void *)low_level_transmit;
+
+    /* Through the TX queue, so a frame that finds every TX descriptor busy
+     * waits for the DMA instead of being copied over one it's still sending */
+    netif->linkoutput = ethernetif_output;
 
     /* Initialize the Ethernet PHY, MAC, and DMA hardware as well as any
      * necessary buffers */
@@ -380,7 +462,7 @@ struct pbuf *low_level_receive(void)
 	/* When Rx Buffer unavailable flag is set: clear it and resume reception */
 	if ((ETH->DMASR & ETH_DMASR_RBUS) != (u32)RESET) {
 		/* Clear RBUS ETHERNET DMA flag */
-		ETH->DMASR = ETH_DMASR_RBUS;
+		ETH_DMASR_CLEAR(ETH_DMASR_RBUS);
 
 		/* Resume DMA reception */
 		ETH->DMARPDR = 0;
@@ -512,9 +594,23 @@ void low_level_init(struct netif *netif)
 	/* Initialize Rx Descriptors list: Chain Mode  */
 	ETH_DMARxDescChainInit(DMARxDscrTab, &Rx_Buff[0][0], ETH_RXBUFNB);
 
-	/* Enable Ethernet Rx interrrupt */
+	/* Enable Ethernet Rx interrrupt on every ETH_RX_IRQ_FRAMES-th descriptor.
+	 * A frame in any of the others sets RS when the receive watchdog runs out
+	 * instead, ETH_RX_IRQ_USEC after it came in. */
 	for(i=0; i<ETH_RXBUFNB; i++) {
-		ETH_DMARxDescReceiveITConfig(&DMARxDscrTab[i], ENABLE);
+		ETH_DMARxDescReceiveITConfig(
+		      &DMARxDscrTab[i],
+		      (0 == (i + 1) % ETH_RX_IRQ_FRAMES) ? ENABLE : DISABLE
+		);
+	}
+	uint32_t rxWatchdog =
+	      (ETH_RX_IRQ_USEC * (SystemCoreClock / 1000000UL) + 255UL) / 256UL;
+	ETH_SetReceiveWatchdogTimer((uint8_t)((rxWatchdog > 255UL) ? 255UL : rxWatchdog));
+
+	/* Tx descriptors all set TS when done.  The TX interrupt is only turned on
+	 * while frames wait in l_txq, see eth_driver_txDrain(). */
+	for(i=0; i<ETH_TXBUFNB; i++) {
+		ETH_DMATxDescTransmitITConfig(&DMATxDscrTab[i], ENABLE);
 	}
 
 #ifdef CHECKSUM_BY_HARDWARE
@@ -538,25 +634,30 @@ void low_level_init(struct netif *netif)
 /******************************************************************************/
 inline void ETH_EventCallback( void )
 {
-   if ( ETH_GetDMAFlagStatus(ETH_DMA_FLAG_R) == SET) {
+   /* The status bits get set whether or not their interrupt is on.  Only post
+    * for the ones that are on: for the others LWIPMgr already has an event
+    * on its way or is busy with the RX ring. */
+   if ( ETH_GetDMAFlagStatus(ETH_DMA_FLAG_R) == SET &&
+         0 != ( ETH->DMAIER & ETH_DMA_IT_R ) ) {
       ETH_DMAClearITPendingBit(ETH_DMA_IT_NIS | ETH_DMA_IT_R);/* clear the interrupt sources */
-      static QEvent const evt_eth_rx = { LWIP_RX_READY_SIG, 0 };
-      QACTIVE_POST(l_active, &evt_eth_rx, &l_Ethernet_IRQHandler);
-
       ETH_DMAITConfig(ETH_DMA_IT_R, DISABLE);       /* disable further RX */
+      l_stats.rxIrqs++;
+      QACTIVE_POST(l_active, &l_evtRxReady, &l_Ethernet_IRQHandler);
    }
 
-    if ( ETH_GetDMAFlagStatus(ETH_DMA_FLAG_T) == SET) {
+   if ( ETH_GetDMAFlagStatus(ETH_DMA_FLAG_T) == SET &&
+         0 != ( ETH->DMAIER & ETH_DMA_IT_T ) ) {
       ETH_DMAClearITPendingBit(ETH_DMA_IT_NIS | ETH_DMA_IT_T);/* clear the interrupt sources */
-        static QEvent const evt_eth_tx = { LWIP_TX_READY_SIG, 0 };
-        QACTIVE_POST(l_active, &evt_eth_tx, &l_Ethernet_IRQHandler);
-    }
+      ETH_DMAITConfig(ETH_DMA_IT_T, DISABLE);  /* eth_driver_txDrain() rearms */
+      l_stats.txIrqs++;
+      QACTIVE_POST(l_active, &l_evtTxReady, &l_Ethernet_IRQHandler);
+   }
 
     /* When Rx Buffer unavailable flag is set: clear it and resume reception. Taken from:
      * http://lists.gnu.org/archive/html/lwip-users/2012-09/msg00053.html */
     if ((ETH->DMASR & ETH_DMASR_RBUS) != (u32)RESET) {
       /* Clear RBUS ETHERNET DMA flag */
-      ETH->DMASR = ETH_DMASR_RBUS;
+      ETH_DMASR_CLEAR(ETH_DMASR_RBUS);
 
       /* Resume DMA reception. The register doesn't care what you write to it. */
       ETH->DMARPDR = 0;
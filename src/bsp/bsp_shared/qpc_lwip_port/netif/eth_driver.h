@@ -55,6 +55,38 @@ void lwIPHostGetTime(u32_t *time_s, u32_t *time_ns);
 #define TX_PBUF_QUEUE_LEN 8
 #endif
 
+#ifndef ETH_RX_BUDGET
+/**
+ * @brief   Most frames eth_driver_read() hands to lwIP in one dispatch.  If
+ * there are more in the RX ring it posts LWIP_RX_READY_SIG to the AO again, so
+ * whatever got queued in the meantime runs before the rest of the burst.
+ */
+#define ETH_RX_BUDGET 8
+#endif
+
+#ifndef ETH_RX_IRQ_FRAMES
+/**
+ * @brief   RX interrupt moderation: only every ETH_RX_IRQ_FRAMES-th RX
+ * descriptor interrupts when a frame lands in it.  A frame fits in one
+ * descriptor, so this counts frames.  1 interrupts on every frame.
+ */
+#define ETH_RX_IRQ_FRAMES 4
+#endif
+
+#ifndef ETH_RX_IRQ_USEC
+/**
+ * @brief   RX interrupt moderation: how long the frames held back by
+ * ETH_RX_IRQ_FRAMES wait for the interrupt after the last one came in.  This
+ * is the DMA receive status watchdog, which counts in steps of 256 HCLK cycles
+ * (1.4us at 180MHz) up to 255 steps.
+ */
+#define ETH_RX_IRQ_USEC 50
+#endif
+
+#if (ETH_RX_IRQ_FRAMES > 1) && (ETH_RX_IRQ_USEC == 0)
+   #error "ETH_RX_IRQ_FRAMES > 1 needs ETH_RX_IRQ_USEC to flush the frames it holds back"
+#endif
+
 
 /* Exported macros -----------------------------------------------------------*/
 /**
@@ -76,6 +108,18 @@ typedef struct PbufQueueTag {
     uint8_t overflow;                           /**< flag for queue overflow  */
 } PbufQueue;
 
+/**
+ * @struct Counters of how the driver gets to its work
+ */
+typedef struct EthDriverStatsTag {
+    uint32_t rxIrqs;               /**< RX interrupts that started a poll */
+    uint32_t rxPolls;              /**< Calls to eth_driver_read() */
+    uint32_t rxFrames;             /**< Frames handed to lwIP */
+    uint32_t rxResched;      /**< Polls that left frames for the next one */
+    uint32_t txIrqs;        /**< TX interrupts for frames waiting to go out */
+    uint32_t txQueued;     /**< Frames that waited for a free TX descriptor */
+} EthDriverStats_t;
+
 /**
  * @enum Ethernet signals used by QPC
  */
@@ -110,8 +154,10 @@ struct netif *eth_driver_init(
 /**
  * @brief Read data from the ethernet buffer
  *
- * Initialize the DMA connnected to the ethernet MAC to read data from the MAC
- * into its private buffer.
+ * Called for LWIP_RX_READY_SIG.  Hands up to ETH_RX_BUDGET frames from the RX
+ * ring to lwIP and sends what it can of the TX queue.  If frames are left it
+ * posts LWIP_RX_READY_SIG to the AO again, otherwise it turns the RX interrupt
+ * back on.  Only one LWIP_RX_READY_SIG is ever in the queue of the AO.
  *
  * @param   None
  * @return  None
@@ -121,14 +167,22 @@ void eth_driver_read( void );
 /**
  * @brief Write data to the ethernet buffer
  *
- * Initialize the DMA connnected to the ethernet MAC to write data to the MAC
- * from its private buffer.
+ * Called for LWIP_TX_READY_SIG, which the TX interrupt only posts while frames
+ * are waiting in the TX queue for a descriptor.  Sends as many of them as
+ * there are free descriptors.
  *
  * @param   None
  * @return  None
  */
 void eth_driver_write( void );
 
+/**
+ * @brief   Get the driver counters.
+ * @param   None
+ * @return: const EthDriverStats_t pointer to the counters.
+ */
+const EthDriverStats_t* eth_driver_getStats( void );
+
 /**
  * @brief   Initialize the ethernet hardware.
  *
@@ -0,0 +1,235 @@
+/**
+ * @file   eth_pcap.c
+ * @brief  Definitions for reading and writing pcap files of Ethernet frames.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEthSim
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "netif/eth_pcap.h"
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+
+/**< Magic numbers of the file header as read in the file's byte order */
+#define PCAP_MAGIC_US                                              0xA1B2C3D4u
+#define PCAP_MAGIC_NS                                              0xA1B23C4Du
+
+/**< Sizes of the file and the record headers */
+#define PCAP_FILE_HDR_LEN                                                   24
+#define PCAP_REC_HDR_LEN                                                    16
+
+/**< Version written to new files */
+#define PCAP_VERSION_MAJOR                                                   2
+#define PCAP_VERSION_MINOR                                                   4
+
+/**< Snap length written to new files */
+#define PCAP_SNAPLEN                                                     65535
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Get a 32 bit little endian field.
+ * @param [in] *p: const uint8_t pointer to the field.
+ * @return: uint32_t value.
+ */
+static uint32_t PCAP_getLE32( const uint8_t *p );
+
+/**
+ * @brief   Put a 32 bit little endian field.
+ * @param [out] *p: uint8_t pointer to the field.
+ * @param [in] val: uint32_t value.
+ * @return: None
+ */
+static void PCAP_putLE32( uint8_t *p, uint32_t val );
+
+/**
+ * @brief   Get a 32 bit field of a header in the byte order of the file.
+ * @param [in] *me: const EthPcap_t pointer to the capture.
+ * @param [in] *p: const uint8_t pointer to the field.
+ * @return: uint32_t value.
+ */
+static uint32_t PCAP_get32( const EthPcap_t *me, const uint8_t *p );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint32_t PCAP_getLE32( const uint8_t *p )
+{
+   return( (uint32_t)p[0]         | ((uint32_t)p[1] << 8) |
+          ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24) );
+}
+
+/******************************************************************************/
+static void PCAP_putLE32( uint8_t *p, uint32_t val )
+{
+   p[0] = (uint8_t)( val );
+   p[1] = (uint8_t)( val >> 8 );
+   p[2] = (uint8_t)( val >> 16 );
+   p[3] = (uint8_t)( val >> 24 );
+}
+
+/******************************************************************************/
+static uint32_t PCAP_get32( const EthPcap_t *me, const uint8_t *p )
+{
+   uint32_t val = PCAP_getLE32( p );
+   if ( me->bSwapped ) {
+      val = ( val >> 24 ) | ( ( val >> 8 ) & 0xFF00 ) |
+            ( ( val << 8 ) & 0xFF0000 ) | ( val << 24 );
+   }
+   return( val );
+}
+
+/******************************************************************************/
+CBErrorCode PCAP_openRead( EthPcap_t *me, const char *path )
+{
+   uint8_t hdr[PCAP_FILE_HDR_LEN];
+
+   me->bSwapped = false;
+   me->bNanoSec = false;
+   me->pFile = fopen( path, "rb" );
+   if ( NULL == me->pFile ) {
+      return( ERR_ETH_SIM_PCAP_OPEN_FAILED );
+   }
+
+   if ( sizeof(hdr) != fread( hdr, 1, sizeof(hdr), me->pFile ) ) {
+      PCAP_close( me );
+      return( ERR_ETH_SIM_PCAP_BAD_FORMAT );
+   }
+
+   /* The magic number tells the byte order and the timestamp resolution */
+   uint32_t magic = PCAP_getLE32( &hdr[0] );
+   if ( PCAP_MAGIC_US == magic || PCAP_MAGIC_NS == magic ) {
+      me->bNanoSec = ( PCAP_MAGIC_NS == magic );
+   } else {
+      me->bSwapped = true;
+      magic = PCAP_get32( me, &hdr[0] );
+      if ( PCAP_MAGIC_US != magic && PCAP_MAGIC_NS != magic ) {
+         PCAP_close( me );
+         return( ERR_ETH_SIM_PCAP_BAD_FORMAT );
+      }
+      me->bNanoSec = ( PCAP_MAGIC_NS == magic );
+   }
+
+   /* Link type is in the low 16 bits, the upper ones may hold FCS info */
+   if ( PCAP_LINKTYPE_ETHERNET != ( PCAP_get32( me, &hdr[20] ) & 0xFFFF ) ) {
+      PCAP_close( me );
+      return( ERR_ETH_SIM_PCAP_BAD_FORMAT );
+   }
+
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+CBErrorCode PCAP_openWrite( EthPcap_t *me, const char *path )
+{
+   uint8_t hdr[PCAP_FILE_HDR_LEN] = { 0 };
+
+   me->bSwapped = false;
+   me->bNanoSec = false;
+   me->pFile = fopen( path, "wb" );
+   if ( NULL == me->pFile ) {
+      return( ERR_ETH_SIM_PCAP_OPEN_FAILED );
+   }
+
+   /* Zone and sigfigs (8 to 15) stay 0 */
+   PCAP_putLE32( &hdr[0], PCAP_MAGIC_US );
+   PCAP_putLE32( &hdr[4], PCAP_VERSION_MAJOR | ( PCAP_VERSION_MINOR << 16 ) );
+   PCAP_putLE32( &hdr[16], PCAP_SNAPLEN );
+   PCAP_putLE32( &hdr[20], PCAP_LINKTYPE_ETHERNET );
+
+   if ( sizeof(hdr) != fwrite( hdr, 1, sizeof(hdr), me->pFile ) ) {
+      PCAP_close( me );
+      return( ERR_ETH_SIM_PCAP_IO );
+   }
+
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+CBErrorCode PCAP_read(
+      EthPcap_t *me,
+      uint8_t *buf,
+      uint16_t bufSize,
+      uint16_t *pLen,
+      uint64_t *pTsUs
+)
+{
+   uint8_t hdr[PCAP_REC_HDR_LEN];
+
+   size_t got = fread( hdr, 1, sizeof(hdr), me->pFile );
+   if ( 0 == got ) {
+      return( ERR_ETH_SIM_PCAP_END );
+   } else if ( sizeof(hdr) != got ) {
+      return( ERR_ETH_SIM_PCAP_IO );
+   }
+
+   uint32_t sec     = PCAP_get32( me, &hdr[0] );
+   uint32_t frac    = PCAP_get32( me, &hdr[4] );
+   uint32_t capLen  = PCAP_get32( me, &hdr[8] );
+
+   *pTsUs = (uint64_t)sec * 1000000u + ( me->bNanoSec ? frac / 1000 : frac );
+
+   if ( capLen > bufSize ) {
+      if ( 0 != fseek( me->pFile, (long)capLen, SEEK_CUR ) ) {
+         return( ERR_ETH_SIM_PCAP_IO );
+      }
+      *pLen = 0;
+      return( ERR_ETH_SIM_FRAME_TOO_BIG );
+   }
+
+   if ( capLen != fread( buf, 1, capLen, me->pFile ) ) {
+      return( ERR_ETH_SIM_PCAP_IO );
+   }
+
+   /* Frames cut short by the snap length are replayed as captured */
+   *pLen = (uint16_t)capLen;
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+CBErrorCode PCAP_write(
+      EthPcap_t *me,
+      const uint8_t *frame,
+      uint16_t len,
+      uint64_t tsUs
+)
+{
+   uint8_t hdr[PCAP_REC_HDR_LEN];
+
+   PCAP_putLE32( &hdr[0], (uint32_t)( tsUs / 1000000u ) );
+   PCAP_putLE32( &hdr[4], (uint32_t)( tsUs % 1000000u ) );
+   PCAP_putLE32( &hdr[8], len );
+   PCAP_putLE32( &hdr[12], len );
+
+   if ( sizeof(hdr) != fwrite( hdr, 1, sizeof(hdr), me->pFile ) ||
+         len != fwrite( frame, 1, len, me->pFile ) ) {
+      return( ERR_ETH_SIM_PCAP_IO );
+   }
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+void PCAP_close( EthPcap_t *me )
+{
+   if ( NULL != me->pFile ) {
+      fclose( me->pFile );
+      me->pFile = NULL;
+   }
+}
+
+/**
+ * @}
+ * end addtogroup groupEthSim
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
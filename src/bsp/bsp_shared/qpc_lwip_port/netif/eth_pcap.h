@@ -0,0 +1,126 @@
+/**
+ * @file   eth_pcap.h
+ * @brief  Declarations for reading and writing pcap files of Ethernet frames.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEthSim
+ * @{
+ *
+ * Host side only.  Frames read from a capture are fed to ETH_SIM_rxFrame() and
+ * the ones the simulated MAC sends can be written out the same way so they
+ * can be looked at with wireshark.  Reads classic pcap files of either byte
+ * order with us or ns timestamps.  Writes little endian, us, LINKTYPE_ETHERNET.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ETH_PCAP_H_
+#define ETH_PCAP_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "CBErrors.h"                                  /* For CBErrorCode */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< Link type of Ethernet captures */
+#define PCAP_LINKTYPE_ETHERNET                                               1
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct EthPcap_t
+ * An open capture file.
+ */
+typedef struct EthPcaps
+{
+   FILE    *pFile;                               /**< NULL when not open */
+   bool     bSwapped;   /**< File was written with the other byte order */
+   bool     bNanoSec;               /**< Timestamps are in ns, not in us */
+} EthPcap_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Open a capture and check its header.
+ * @param [out] *me: EthPcap_t pointer to the capture.
+ * @param [in] *path: const char pointer to the name of the file.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: ready for PCAP_read().
+ *    @arg ERR_ETH_SIM_PCAP_OPEN_FAILED: can't open the file.
+ *    @arg ERR_ETH_SIM_PCAP_BAD_FORMAT: not a pcap of Ethernet frames.
+ */
+CBErrorCode PCAP_openRead( EthPcap_t *me, const char *path );
+
+/**
+ * @brief   Create a capture and write its header.
+ * @param [out] *me: EthPcap_t pointer to the capture.
+ * @param [in] *path: const char pointer to the name of the file.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: ready for PCAP_write().
+ *    @arg ERR_ETH_SIM_PCAP_OPEN_FAILED: can't create the file.
+ *    @arg ERR_ETH_SIM_PCAP_IO: can't write the header.
+ */
+CBErrorCode PCAP_openWrite( EthPcap_t *me, const char *path );
+
+/**
+ * @brief   Read the next frame.
+ *
+ * @param [in] *me: EthPcap_t pointer to the capture.
+ * @param [out] *buf: uint8_t pointer to where the frame goes.
+ * @param [in] bufSize: uint16_t size of buf.
+ * @param [out] *pLen: uint16_t pointer to the length of the frame.
+ * @param [out] *pTsUs: uint64_t pointer to the timestamp of the frame in us.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: frame read.
+ *    @arg ERR_ETH_SIM_PCAP_END: no more frames.
+ *    @arg ERR_ETH_SIM_FRAME_TOO_BIG: frame doesn't fit in buf.  It's skipped
+ *    so the next read gets the next frame.
+ *    @arg ERR_ETH_SIM_PCAP_IO: file cut short.
+ */
+CBErrorCode PCAP_read(
+      EthPcap_t *me,
+      uint8_t *buf,
+      uint16_t bufSize,
+      uint16_t *pLen,
+      uint64_t *pTsUs
+);
+
+/**
+ * @brief   Write a frame.
+ * @param [in] *me: EthPcap_t pointer to the capture.
+ * @param [in] *frame: const uint8_t pointer to the frame, without the FCS.
+ * @param [in] len: uint16_t length of the frame.
+ * @param [in] tsUs: uint64_t timestamp of the frame in us.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: frame written.
+ *    @arg ERR_ETH_SIM_PCAP_IO: otherwise.
+ */
+CBErrorCode PCAP_write(
+      EthPcap_t *me,
+      const uint8_t *frame,
+      uint16_t len,
+      uint64_t tsUs
+);
+
+/**
+ * @brief   Close the capture.  Safe to call on one that isn't open.
+ * @param [in] *me: EthPcap_t pointer to the capture.
+ * @return: None
+ */
+void PCAP_close( EthPcap_t *me );
+
+/**
+ * @}
+ * end addtogroup groupEthSim
+ */
+
+#endif                                                         /* ETH_PCAP_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,496 @@
+/**
+ * @file   eth_sim.c
+ * @brief  Definitions for the simulated STM32F4x7 Ethernet MAC/DMA.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEthSim
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "netif/eth_sim.h"
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+
+/**< DMASR bits that go into the normal and the abnormal interrupt summary */
+#define ETH_SIM_NORMAL_BITS \
+   ( ETH_DMASR_TS | ETH_DMASR_TBUS | ETH_DMASR_RS | ETH_DMASR_ERS )
+#define ETH_SIM_ABNORMAL_BITS \
+   ( ETH_DMASR_TPSS | ETH_DMASR_TJTS | ETH_DMASR_ROS | ETH_DMASR_TUS | \
+     ETH_DMASR_RBUS | ETH_DMASR_RPSS | ETH_DMASR_RWTS | ETH_DMASR_ETS | \
+     ETH_DMASR_FBES )
+
+/**< Bytes of FCS the DMA leaves at the end of a received frame */
+#define ETH_SIM_FCS_LEN                                                      4
+
+/**< Frame offsets used for the checksum offload */
+#define ETH_SIM_ETHERTYPE_OFFSET                                            12
+#define ETH_SIM_IP_OFFSET                                                   14
+#define ETH_SIM_ETHERTYPE_IPV4                                          0x0800
+#define ETH_SIM_IP_PROTO_ICMP                                                1
+#define ETH_SIM_IP_PROTO_TCP                                                 6
+#define ETH_SIM_IP_PROTO_UDP                                                17
+
+/* Private macros ------------------------------------------------------------*/
+
+/**< Descriptors and buffers as the DMA sees them: 32 bit bus addresses */
+#define ETH_SIM_DESC( addr_ )   ((ETH_DMADESCTypeDef *)(uintptr_t)(addr_))
+#define ETH_SIM_BUF( addr_ )                 ((uint8_t *)(uintptr_t)(addr_))
+
+/**< Big endian 16 bit field of a frame */
+#define ETH_SIM_GET16( p_ )  ((uint16_t)(((p_)[0] << 8) | (p_)[1]))
+
+/* Private variables and Local objects ---------------------------------------*/
+ETH_TypeDef ETH_SIM_regs;        /**< Register block ETH points at (conf.h) */
+
+static ETH_SIM_IrqFn l_irqFn;
+static ETH_SIM_TxFn  l_txFn;
+static void         *l_txArg;
+static EthSimStats_t l_stats;
+
+static bool l_bRxRunning;    /**< RX DMA started and current desc loaded */
+static bool l_bTxRunning;    /**< TX DMA started and current desc loaded */
+static bool l_bTxSuspended;   /**< TX DMA waiting for a poll demand */
+static bool l_bInIrq;            /**< Interrupt running, don't nest it */
+static bool l_bInTx;      /**< TX DMA running, a poll demand from txFn waits */
+static bool l_bTxHold;              /**< Frames stay in the TX ring for now */
+static bool l_bRxWdt;                     /**< Receive watchdog is running */
+static uint32_t l_rxWdtNs;          /**< Time left on the receive watchdog */
+
+/**< Frame being pulled off the TX ring.  Kept between runs in case the
+ * driver hands over the first segments of a frame before the rest. */
+static uint8_t  l_txFrame[ETH_SIM_MAX_FRAME_LEN];
+static uint16_t l_txLen;
+static uint32_t l_txCic;                 /**< Checksum insertion of the frame */
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Set DMASR bits and the summary bits they are enabled for.
+ * @param [in] bits: uint32_t DMASR status bits.
+ * @return: None
+ */
+static void ETH_SIM_setStatus( uint32_t bits );
+
+/**
+ * @brief   Pick up the start and stop of the DMA by the driver.
+ *
+ * Like the DMA, starting loads the current descriptor from the list address.
+ *
+ * @param   None
+ * @return: None
+ */
+static void ETH_SIM_checkStart( void );
+
+/**
+ * @brief   Run the interrupt for as long as it's asserted.
+ * @param   None
+ * @return: None
+ */
+static void ETH_SIM_irq( void );
+
+/**
+ * @brief   Take the frames the driver gave to the DMA off the TX ring.
+ * @param   None
+ * @return: None
+ */
+static void ETH_SIM_txDma( void );
+
+/**
+ * @brief   Insert IP and TCP/UDP/ICMP checksums like the offload engine.
+ * @param [in|out] *frame: uint8_t pointer to the frame.
+ * @param [in] len: uint16_t length of the frame.
+ * @param [in] cic: uint32_t checksum insertion control of the first descriptor.
+ * @return: None
+ */
+static void ETH_SIM_insertCsum( uint8_t *frame, uint16_t len, uint32_t cic );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void ETH_SIM_setStatus( uint32_t bits )
+{
+   ETH->DMASR |= bits;
+   if ( 0 != ( bits & ETH->DMAIER & ETH_SIM_NORMAL_BITS ) ) {
+      ETH->DMASR |= ETH_DMASR_NIS;
+   }
+   if ( 0 != ( bits & ETH->DMAIER & ETH_SIM_ABNORMAL_BITS ) ) {
+      ETH->DMASR |= ETH_DMASR_AIS;
+   }
+}
+
+/******************************************************************************/
+static void ETH_SIM_checkStart( void )
+{
+   if ( 0 != ( ETH->DMAOMR & ETH_DMAOMR_SR ) ) {
+      if ( !l_bRxRunning ) {
+         ETH->DMACHRDR = ETH->DMARDLAR;
+         l_bRxRunning  = true;
+      }
+   } else {
+      l_bRxRunning = false;
+   }
+
+   if ( 0 != ( ETH->DMAOMR & ETH_DMAOMR_ST ) ) {
+      if ( !l_bTxRunning ) {
+         ETH->DMACHTDR  = ETH->DMATDLAR;
+         l_bTxRunning   = true;
+         l_bTxSuspended = false;
+         l_txLen        = 0;
+      }
+   } else {
+      l_bTxRunning = false;
+   }
+
+   /* Self clearing bits are done as soon as anyone looks */
+   ETH->DMABMR &= ~ETH_DMABMR_SR;
+   ETH->DMAOMR &= ~ETH_DMAOMR_FTF;
+}
+
+/******************************************************************************/
+static void ETH_SIM_irq( void )
+{
+   if ( l_bInIrq || NULL == l_irqFn ) {
+      return;
+   }
+
+   l_bInIrq = true;
+   for ( uint8_t runs = 0;
+         0 != ( ETH->DMASR & ETH->DMAIER & ( ETH_DMASR_NIS | ETH_DMASR_AIS ) );
+         runs++ ) {
+      if ( runs >= ETH_SIM_MAX_IRQ_RUNS ) {
+         /* On the target this would be an interrupt storm */
+         l_stats.irqStuck++;
+         break;
+      }
+      l_stats.irqs++;
+      l_irqFn();
+   }
+   l_bInIrq = false;
+}
+
+/******************************************************************************/
+static void ETH_SIM_txDma( void )
+{
+   ETH_SIM_checkStart();
+   if ( !l_bTxRunning || l_bTxSuspended || l_bInTx || l_bTxHold ) {
+      return;
+   }
+
+   l_bInTx = true;
+   for (;;) {
+      ETH_DMADESCTypeDef *pDesc = ETH_SIM_DESC( ETH->DMACHTDR );
+      uint32_t status = pDesc->Status;
+
+      if ( 0 == ( status & ETH_DMATxDesc_OWN ) ) {
+         l_bTxSuspended = true;
+         ETH_SIM_setStatus( ETH_DMASR_TBUS );
+         break;
+      }
+
+      if ( 0 != ( status & ETH_DMATxDesc_FS ) ) {
+         l_txLen = 0;
+         l_txCic = status & ETH_DMATxDesc_CIC;
+      }
+
+      /* Anything past the longest frame would be a giant on the wire */
+      uint16_t segLen = (uint16_t)( pDesc->ControlBufferSize & ETH_DMATxDesc_TBS1 );
+      if ( segLen > sizeof(l_txFrame) - l_txLen ) {
+         segLen = (uint16_t)( sizeof(l_txFrame) - l_txLen );
+      }
+      memcpy( &l_txFrame[l_txLen], ETH_SIM_BUF( pDesc->Buffer1Addr ), segLen );
+      l_txLen += segLen;
+
+      pDesc->Status = status & ~ETH_DMATxDesc_OWN;
+      ETH->DMACHTDR = pDesc->Buffer2NextDescAddr;
+
+      if ( 0 != ( status & ETH_DMATxDesc_LS ) ) {
+         ETH_SIM_insertCsum( l_txFrame, l_txLen, l_txCic );
+         l_stats.txFrames++;
+         l_stats.txBytes += l_txLen;
+         if ( NULL != l_txFn ) {
+            l_txFn( l_txFrame, l_txLen, l_txArg );
+         }
+         l_txLen = 0;
+
+         if ( 0 != ( status & ETH_DMATxDesc_IC ) ) {
+            ETH_SIM_setStatus( ETH_DMASR_TS );
+         }
+      }
+   }
+   l_bInTx = false;
+
+   ETH_SIM_irq();
+}
+
+/******************************************************************************/
+static void ETH_SIM_insertCsum( uint8_t *frame, uint16_t len, uint32_t cic )
+{
+   if ( ETH_DMATxDesc_CIC_ByPass == cic ||
+         len < ETH_SIM_IP_OFFSET + 20 ||
+         ETH_SIM_ETHERTYPE_IPV4 !=
+         ETH_SIM_GET16( &frame[ETH_SIM_ETHERTYPE_OFFSET] ) ) {
+      return;
+   }
+
+   uint8_t *ip = &frame[ETH_SIM_IP_OFFSET];
+   uint16_t hdrLen = (uint16_t)( ( ip[0] & 0x0F ) * 4 );
+   uint16_t totLen = ETH_SIM_GET16( &ip[2] );
+   if ( hdrLen < 20 || totLen < hdrLen || ETH_SIM_IP_OFFSET + totLen > len ) {
+      return;                             /* Engine leaves bad frames alone */
+   }
+
+   ip[10] = 0;
+   ip[11] = 0;
+   uint16_t csum = ETH_SIM_inetCsum( ip, hdrLen, 0 );
+   ip[10] = (uint8_t)( csum >> 8 );
+   ip[11] = (uint8_t)( csum );
+
+   if ( ETH_DMATxDesc_CIC_IPV4Header == cic ) {
+      return;
+   }
+
+   /* Fragments only get the header checksum */
+   if ( 0 != ( ETH_SIM_GET16( &ip[6] ) & 0x3FFF ) ) {
+      return;
+   }
+
+   uint8_t *seg = &ip[hdrLen];
+   uint16_t segLen = (uint16_t)( totLen - hdrLen );
+   uint8_t *pCsum;
+   bool bPseudo = true;
+
+   switch ( ip[9] ) {
+      case ETH_SIM_IP_PROTO_TCP:
+         if ( segLen < 20 ) {
+            return;
+         }
+         pCsum = &seg[16];
+         break;
+      case ETH_SIM_IP_PROTO_UDP:
+         if ( segLen < 8 ) {
+            return;
+         }
+         pCsum = &seg[6];
+         break;
+      case ETH_SIM_IP_PROTO_ICMP:
+         if ( segLen < 4 ) {
+            return;
+         }
+         pCsum = &seg[2];
+         bPseudo = false;
+         break;
+      default:
+         return;
+   }
+
+   /* In segment mode the driver already put the pseudo header sum in there */
+   uint32_t sum = 0;
+   if ( ETH_DMATxDesc_CIC_TCPUDPICMP_Full == cic ) {
+      pCsum[0] = 0;
+      pCsum[1] = 0;
+      if ( bPseudo ) {
+         sum = (uint32_t)ETH_SIM_GET16( &ip[12] ) + ETH_SIM_GET16( &ip[14] ) +
+               ETH_SIM_GET16( &ip[16] ) + ETH_SIM_GET16( &ip[18] ) +
+               ip[9] + segLen;
+      }
+   }
+
+   csum = ETH_SIM_inetCsum( seg, segLen, sum );
+   if ( ETH_SIM_IP_PROTO_UDP == ip[9] && 0 == csum ) {
+      csum = 0xFFFF;                        /* 0 means no checksum for UDP */
+   }
+   pCsum[0] = (uint8_t)( csum >> 8 );
+   pCsum[1] = (uint8_t)( csum );
+}
+
+/******************************************************************************/
+void ETH_SIM_init( ETH_SIM_IrqFn irqFn, ETH_SIM_TxFn txFn, void *txArg )
+{
+   memset( &ETH_SIM_regs, 0, sizeof(ETH_SIM_regs) );
+   memset( &l_stats, 0, sizeof(l_stats) );
+
+   l_irqFn        = irqFn;
+   l_txFn         = txFn;
+   l_txArg        = txArg;
+   l_bRxRunning   = false;
+   l_bTxRunning   = false;
+   l_bTxSuspended = false;
+   l_bInIrq       = false;
+   l_bInTx        = false;
+   l_bTxHold      = false;
+   l_bRxWdt       = false;
+   l_txLen        = 0;
+}
+
+/******************************************************************************/
+CBErrorCode ETH_SIM_rxFrame( const uint8_t *frame, uint16_t len )
+{
+   if ( len > ETH_SIM_MAX_FRAME_LEN ) {
+      return( ERR_ETH_SIM_FRAME_TOO_BIG );
+   }
+
+   ETH_SIM_checkStart();
+   if ( !l_bRxRunning ) {
+      l_stats.rxStopped++;
+      return( ERR_ETH_SIM_RX_STOPPED );
+   }
+
+   /* The MAC FIFO holds the whole frame, so make sure there are enough
+    * descriptors before touching any of them.  If not, the frame is lost. */
+   uint32_t wireLen = (uint32_t)len + ETH_SIM_FCS_LEN;
+   uint32_t left = wireLen;
+   ETH_DMADESCTypeDef *pDesc = ETH_SIM_DESC( ETH->DMACHRDR );
+   for ( uint32_t i = 0; left > 0; i++ ) {
+      uint32_t bufSize = pDesc->ControlBufferSize & ETH_DMARxDesc_RBS1;
+      if ( 0 == ( pDesc->Status & ETH_DMARxDesc_OWN ) || 0 == bufSize ||
+            i >= ETH_RXBUFNB ) {
+         l_stats.rxNoDesc++;
+         ETH_SIM_setStatus( ETH_DMASR_RBUS );
+         ETH_SIM_irq();
+         return( ERR_ETH_SIM_NO_RX_DESC );
+      }
+      left -= ( left > bufSize ) ? bufSize : left;
+      pDesc = ETH_SIM_DESC( pDesc->Buffer2NextDescAddr );
+   }
+
+   /* Copy it in.  The FCS bytes are left as zeros. */
+   uint32_t done = 0;
+   bool bIrq = false;
+   pDesc = ETH_SIM_DESC( ETH->DMACHRDR );
+   while ( done < wireLen ) {
+      uint32_t bufSize = pDesc->ControlBufferSize & ETH_DMARxDesc_RBS1;
+      uint32_t segLen = ( wireLen - done > bufSize ) ? bufSize : wireLen - done;
+      uint8_t *pBuf = ETH_SIM_BUF( pDesc->Buffer1Addr );
+
+      uint32_t dataLen = ( done < len ) ? len - done : 0;
+      if ( dataLen > segLen ) {
+         dataLen = segLen;
+      }
+      memcpy( pBuf, &frame[done], dataLen );
+      memset( &pBuf[dataLen], 0, segLen - dataLen );
+
+      uint32_t status = 0;
+      if ( 0 == done ) {
+         status |= ETH_DMARxDesc_FS;
+      }
+      done += segLen;
+      if ( done == wireLen ) {
+         status |= ETH_DMARxDesc_LS |
+               ( ( wireLen << ETH_DMARxDesc_FrameLengthShift ) & ETH_DMARxDesc_FL );
+         if ( len > ETH_SIM_ETHERTYPE_OFFSET + 1 &&
+               ETH_SIM_GET16( &frame[ETH_SIM_ETHERTYPE_OFFSET] ) >= 0x600 ) {
+            status |= ETH_DMARxDesc_FT;            /* Ethernet II, not 802.3 */
+         }
+         bIrq = ( 0 == ( pDesc->ControlBufferSize & ETH_DMARxDesc_DIC ) );
+      }
+      pDesc->Status = status;                     /* Gives it back: OWN is 0 */
+
+      ETH->DMACHRDR = pDesc->Buffer2NextDescAddr;
+      pDesc = ETH_SIM_DESC( ETH->DMACHRDR );
+   }
+
+   l_stats.rxFrames++;
+   l_stats.rxBytes += len;
+
+   if ( bIrq ) {
+      l_bRxWdt = false;               /* RS set by a descriptor stops it */
+      ETH_SIM_setStatus( ETH_DMASR_RS );
+      ETH_SIM_irq();
+   } else if ( 0 != ETH->DMARSWTR ) {
+      l_bRxWdt  = true;
+      l_rxWdtNs = (uint32_t)( (uint64_t)ETH->DMARSWTR * 256U * 1000000000ULL /
+            ETH_SIM_HCLK_HZ );
+   }
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+void ETH_SIM_poll( void )
+{
+   ETH_SIM_txDma();
+
+   /* An interrupt enabled while its status was already set fires right away */
+   if ( 0 != ( ETH->DMASR & ETH->DMAIER & ETH_SIM_NORMAL_BITS ) ) {
+      ETH->DMASR |= ETH_DMASR_NIS;
+   }
+   if ( 0 != ( ETH->DMASR & ETH->DMAIER & ETH_SIM_ABNORMAL_BITS ) ) {
+      ETH->DMASR |= ETH_DMASR_AIS;
+   }
+   ETH_SIM_irq();
+}
+
+/******************************************************************************/
+void ETH_SIM_elapse( uint32_t ns )
+{
+   if ( !l_bRxWdt ) {
+      return;
+   }
+   if ( ns < l_rxWdtNs ) {
+      l_rxWdtNs -= ns;
+      return;
+   }
+
+   l_bRxWdt = false;
+   l_stats.rxWatchdog++;
+   ETH_SIM_setStatus( ETH_DMASR_RS );
+   ETH_SIM_irq();
+}
+
+/******************************************************************************/
+void ETH_SIM_txHold( bool bHold )
+{
+   l_bTxHold = bHold;
+   if ( !bHold ) {
+      ETH_SIM_txDma();
+   }
+}
+
+/******************************************************************************/
+const EthSimStats_t* ETH_SIM_getStats( void )
+{
+   return( &l_stats );
+}
+
+/******************************************************************************/
+uint16_t ETH_SIM_inetCsum( const uint8_t *data, uint16_t len, uint32_t sum )
+{
+   uint16_t i = 0;
+   for ( ; i + 1 < len; i += 2 ) {
+      sum += ETH_SIM_GET16( &data[i] );
+   }
+   if ( i < len ) {
+      sum += (uint32_t)data[i] << 8;
+   }
+   while ( 0 != ( sum >> 16 ) ) {
+      sum = ( sum & 0xFFFF ) + ( sum >> 16 );
+   }
+   return( (uint16_t)~sum );
+}
+
+/******************************************************************************/
+void ETH_SIM_clearStatus( uint32_t bits )
+{
+   ETH->DMASR &= ~bits;
+}
+
+/******************************************************************************/
+void ETH_SIM_txPollDemand( void )
+{
+   l_bTxSuspended = false;
+   ETH_SIM_txDma();
+}
+
+/**
+ * @}
+ * end addtogroup groupEthSim
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,184 @@
+/**
+ * @file   eth_sim.h
+ * @brief  Declarations for the simulated STM32F4x7 Ethernet MAC/DMA.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEthSim
+ * @{
+ *
+ * Lets eth_driver.c, the ST driver and everything above them (lwIP, LWIPMgr)
+ * run on a host without a network.  Building with ETH_SIM defined points ETH
+ * at a register block in RAM (see stm32f4x7_eth_conf.h) and this module plays
+ * the part of the DMA:
+ *
+ * - ETH_SIM_rxFrame() puts a frame into the RX descriptor ring the way the DMA
+ *   does (FS/LS/FL, OWN given back, RS or RBUS in DMASR) and raises the
+ *   interrupt, which calls ETH_EventCallback() like ETH_IRQHandler() does.
+ * - A frame in a descriptor with DIC set only raises the interrupt once the
+ *   receive watchdog (DMARSWTR) runs out.  Time only passes for it in
+ *   ETH_SIM_elapse().
+ * - Frames the driver hands to the TX ring are taken off right away on the
+ *   poll demand, unless held with ETH_SIM_txHold(), get their checksums
+ *   inserted as the checksum offload engine would, and are passed to an
+ *   ETH_SIM_TxFn.  That can write them to a pcap
+ *   file (eth_pcap.h) or feed them to the synthetic TCP client
+ *   (eth_sim_tcp.h), which answers through ETH_SIM_rxFrame().
+ *
+ * The interrupt is level triggered like the real one: the callback runs for as
+ * long as an enabled status bit is left set.  What the sim can't see are plain
+ * register writes, like the driver starting the DMA or enabling an interrupt
+ * whose status is already pending.  Call ETH_SIM_poll() after low_level_init()
+ * and after every event dispatched to LWIPMgr.
+ *
+ * Descriptors hold 32 bit addresses.  On a 64 bit host, link with -no-pie so
+ * the descriptor tables and buffers in stm32f4x7_eth.c end up below 4GB.
+ *
+ * This is not part of the firmware build.  A host build compiles this file,
+ * eth_driver.c, stm32f4x7_eth.c and the lwIP core with -DETH_SIM and provides
+ * its own RCC stubs and QP port.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ETH_SIM_H_
+#define ETH_SIM_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32f4x7_eth.h"              /* For ETH registers and descriptors */
+#include "CBErrors.h"                                  /* For CBErrorCode */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< Longest frame, without the FCS, the sim takes or sends (with a VLAN tag) */
+#define ETH_SIM_MAX_FRAME_LEN                                             1522
+
+/**< Times the interrupt runs back to back before it's counted as stuck */
+#define ETH_SIM_MAX_IRQ_RUNS                                                16
+
+/**< HCLK of the target.  The receive watchdog counts 256 of these per step. */
+#define ETH_SIM_HCLK_HZ                                           180000000UL
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief Function called for the interrupt, normally ETH_EventCallback().
+ */
+typedef void (*ETH_SIM_IrqFn)( void );
+
+/**
+ * @brief Function called with every frame the MAC sends.
+ * @param [in] *frame: const uint8_t pointer to the frame, without the FCS.
+ * @param [in] len: uint16_t length of the frame.
+ * @param [in] *arg: void pointer given to ETH_SIM_init().
+ * @return: None
+ */
+typedef void (*ETH_SIM_TxFn)( const uint8_t *frame, uint16_t len, void *arg );
+
+/**
+ * \struct EthSimStats_t
+ * What the simulated MAC has seen since ETH_SIM_init().
+ */
+typedef struct EthSimStatsTag
+{
+   uint32_t rxFrames;                   /**< Frames put in the RX ring */
+   uint32_t rxBytes;              /**< Bytes of those frames, without FCS */
+   uint32_t rxNoDesc;           /**< Frames dropped for lack of descriptors */
+   uint32_t rxStopped;          /**< Frames dropped with RX DMA stopped */
+   uint32_t txFrames;                      /**< Frames taken off TX ring */
+   uint32_t txBytes;              /**< Bytes of those frames, without FCS */
+   uint32_t irqs;                         /**< Runs of the interrupt */
+   uint32_t irqStuck;  /**< Times an interrupt kept firing without clearing */
+   uint32_t rxWatchdog;     /**< Times the receive watchdog ran out and set RS */
+} EthSimStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Reset the simulated MAC.
+ *
+ * Clears the registers and the stats.  Call before low_level_init() so the
+ * driver sets up the rings in the clean register block.
+ *
+ * @param [in] irqFn: ETH_SIM_IrqFn to call for the interrupt.
+ * @param [in] txFn: ETH_SIM_TxFn to pass sent frames to.
+ * @param [in] *txArg: void pointer passed to txFn.
+ * @return: None
+ */
+void ETH_SIM_init( ETH_SIM_IrqFn irqFn, ETH_SIM_TxFn txFn, void *txArg );
+
+/**
+ * @brief   Receive a frame as if it came in on the wire.
+ *
+ * @param [in] *frame: const uint8_t pointer to the frame, without the FCS.
+ * @param [in] len: uint16_t length of the frame.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: frame is in the RX ring.
+ *    @arg ERR_ETH_SIM_RX_STOPPED: the driver hasn't started RX DMA.
+ *    @arg ERR_ETH_SIM_NO_RX_DESC: ring full, frame dropped and RBUS set.
+ *    @arg ERR_ETH_SIM_FRAME_TOO_BIG: longer than ETH_SIM_MAX_FRAME_LEN.
+ */
+CBErrorCode ETH_SIM_rxFrame( const uint8_t *frame, uint16_t len );
+
+/**
+ * @brief   Let the MAC catch up with what the driver did to it.
+ *
+ * Sends anything left in the TX ring and raises the interrupt if the driver
+ * enabled one that is pending.
+ *
+ * @param   None
+ * @return: None
+ */
+void ETH_SIM_poll( void );
+
+/**
+ * @brief   Let time go by for the MAC.
+ *
+ * Runs the receive watchdog.  Every frame put in a descriptor with DIC set
+ * starts it over, and when it runs out it sets RS and raises the interrupt.
+ *
+ * @param [in] ns: uint32_t nanoseconds that went by.
+ * @return: None
+ */
+void ETH_SIM_elapse( uint32_t ns );
+
+/**
+ * @brief   Hold the frames in the TX ring, as if the wire were busy.
+ *
+ * The descriptors the driver hands over stay owned by the DMA until released,
+ * then the frames go out as usual.
+ *
+ * @param [in] bHold: bool true to hold the frames, false to send them.
+ * @return: None
+ */
+void ETH_SIM_txHold( bool bHold );
+
+/**
+ * @brief   Get the stats.
+ * @param   None
+ * @return: const EthSimStats_t pointer to the stats.
+ */
+const EthSimStats_t* ETH_SIM_getStats( void );
+
+/**
+ * @brief   Internet checksum (RFC 1071) of a block, for building frames.
+ * @param [in] *data: const uint8_t pointer to the data.
+ * @param [in] len: uint16_t number of bytes.
+ * @param [in] sum: uint32_t running sum to start from (pseudo header).
+ * @return: uint16_t checksum in host order, ready to be stored big endian.
+ */
+uint16_t ETH_SIM_inetCsum( const uint8_t *data, uint16_t len, uint32_t sum );
+
+/**
+ * @}
+ * end addtogroup groupEthSim
+ */
+
+#endif                                                          /* ETH_SIM_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
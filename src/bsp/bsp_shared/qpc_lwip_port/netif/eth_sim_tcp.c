@@ -0,0 +1,470 @@
+/**
+ * @file   eth_sim_tcp.c
+ * @brief  Definitions for a synthetic TCP client on the simulated wire.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEthSim
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "netif/eth_sim_tcp.h"
+#include "netif/eth_sim.h"
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+
+/**< Header lengths.  The client never sends IP options. */
+#define SIM_TCP_ETH_HDR_LEN                                                 14
+#define SIM_TCP_IP_HDR_LEN                                                  20
+#define SIM_TCP_TCP_HDR_LEN                                                 20
+#define SIM_TCP_ARP_LEN                                                     28
+
+/**< Ethertypes and IP protocol */
+#define SIM_TCP_ETHERTYPE_IPV4                                          0x0800
+#define SIM_TCP_ETHERTYPE_ARP                                           0x0806
+#define SIM_TCP_IP_PROTO_TCP                                                 6
+
+/**< ARP opcodes */
+#define SIM_TCP_ARP_REQUEST                                                  1
+#define SIM_TCP_ARP_REPLY                                                    2
+
+/**< TCP flags */
+#define SIM_TCP_FIN                                                       0x01
+#define SIM_TCP_SYN                                                       0x02
+#define SIM_TCP_RST                                                       0x04
+#define SIM_TCP_PSH                                                       0x08
+#define SIM_TCP_ACK                                                       0x10
+
+/**< First sequence number.  Fixed so runs are repeatable. */
+#define SIM_TCP_ISS                                                 0x00010000
+
+/* Private macros ------------------------------------------------------------*/
+
+/**< Big endian fields of a frame */
+#define SIM_TCP_GET16( p_ )  ((uint16_t)(((p_)[0] << 8) | (p_)[1]))
+#define SIM_TCP_GET32( p_ ) \
+   (((uint32_t)(p_)[0] << 24) | ((uint32_t)(p_)[1] << 16) | \
+    ((uint32_t)(p_)[2] << 8)  |  (uint32_t)(p_)[3])
+
+/**< Sequence number compare that survives the wrap */
+#define SIM_TCP_SEQ_LT( a_, b_ )              ((int32_t)((a_) - (b_)) < 0)
+#define SIM_TCP_SEQ_LEQ( a_, b_ )            ((int32_t)((a_) - (b_)) <= 0)
+
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Put a 16 bit big endian field.
+ * @param [out] *p: uint8_t pointer to the field.
+ * @param [in] val: uint16_t value.
+ * @return: None
+ */
+static void SIM_TCP_put16( uint8_t *p, uint16_t val );
+
+/**
+ * @brief   Put a 32 bit big endian field.
+ * @param [out] *p: uint8_t pointer to the field.
+ * @param [in] val: uint32_t value.
+ * @return: None
+ */
+static void SIM_TCP_put32( uint8_t *p, uint32_t val );
+
+/**
+ * @brief   Build a segment and put it on the wire.
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @param [in] seq: uint32_t sequence number of the segment.
+ * @param [in] flags: uint8_t TCP flags.
+ * @param [in] *data: const uint8_t pointer to the payload.
+ * @param [in] len: uint16_t length of the payload.
+ * @return: CBErrorCode from ETH_SIM_rxFrame().
+ */
+static CBErrorCode SIM_TCP_output(
+      SimTcp_t *me,
+      uint32_t seq,
+      uint8_t flags,
+      const uint8_t *data,
+      uint16_t len
+);
+
+/**
+ * @brief   Send as much of the data and the FIN as the window allows.
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @return: None
+ */
+static void SIM_TCP_push( SimTcp_t *me );
+
+/**
+ * @brief   Answer an ARP request for the client.
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @param [in] *arp: const uint8_t pointer to the ARP packet.
+ * @param [in] len: uint16_t length of the ARP packet.
+ * @return: None
+ */
+static void SIM_TCP_onArp( SimTcp_t *me, const uint8_t *arp, uint16_t len );
+
+/**
+ * @brief   Handle a segment from the board.
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @param [in] *tcp: const uint8_t pointer to the TCP header.
+ * @param [in] len: uint16_t length of the segment.
+ * @return: None
+ */
+static void SIM_TCP_onSegment( SimTcp_t *me, const uint8_t *tcp, uint16_t len );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void SIM_TCP_put16( uint8_t *p, uint16_t val )
+{
+   p[0] = (uint8_t)( val >> 8 );
+   p[1] = (uint8_t)( val );
+}
+
+/******************************************************************************/
+static void SIM_TCP_put32( uint8_t *p, uint32_t val )
+{
+   p[0] = (uint8_t)( val >> 24 );
+   p[1] = (uint8_t)( val >> 16 );
+   p[2] = (uint8_t)( val >> 8 );
+   p[3] = (uint8_t)( val );
+}
+
+/******************************************************************************/
+static CBErrorCode SIM_TCP_output(
+      SimTcp_t *me,
+      uint32_t seq,
+      uint8_t flags,
+      const uint8_t *data,
+      uint16_t len
+)
+{
+   uint8_t frame[ETH_SIM_MAX_FRAME_LEN];
+
+   /* Only the SYN carries an option: the MSS */
+   uint16_t tcpHdrLen = SIM_TCP_TCP_HDR_LEN + ( ( flags & SIM_TCP_SYN ) ? 4 : 0 );
+   uint16_t ipLen = SIM_TCP_IP_HDR_LEN + tcpHdrLen + len;
+   uint8_t *ip  = &frame[SIM_TCP_ETH_HDR_LEN];
+   uint8_t *tcp = &ip[SIM_TCP_IP_HDR_LEN];
+
+   memcpy( &frame[0], me->peerMac, 6 );
+   memcpy( &frame[6], me->mac, 6 );
+   SIM_TCP_put16( &frame[12], SIM_TCP_ETHERTYPE_IPV4 );
+
+   memset( ip, 0, SIM_TCP_IP_HDR_LEN );
+   ip[0] = 0x45;                                   /* IPv4, no options */
+   SIM_TCP_put16( &ip[2], ipLen );
+   SIM_TCP_put16( &ip[4], me->ipId++ );
+   SIM_TCP_put16( &ip[6], 0x4000 );                     /* Don't fragment */
+   ip[8] = 64;                                                     /* TTL */
+   ip[9] = SIM_TCP_IP_PROTO_TCP;
+   memcpy( &ip[12], me->ip, 4 );
+   memcpy( &ip[16], me->peerIp, 4 );
+   SIM_TCP_put16( &ip[10], ETH_SIM_inetCsum( ip, SIM_TCP_IP_HDR_LEN, 0 ) );
+
+   memset( tcp, 0, tcpHdrLen );
+   SIM_TCP_put16( &tcp[0], me->port );
+   SIM_TCP_put16( &tcp[2], me->peerPort );
+   SIM_TCP_put32( &tcp[4], seq );
+   SIM_TCP_put32( &tcp[8], ( flags & SIM_TCP_ACK ) ? me->rcvNxt : 0 );
+   tcp[12] = (uint8_t)( ( tcpHdrLen / 4 ) << 4 );
+   tcp[13] = flags;
+   SIM_TCP_put16( &tcp[14], SIM_TCP_WND );
+   if ( flags & SIM_TCP_SYN ) {
+      tcp[20] = 2;                                              /* MSS kind */
+      tcp[21] = 4;
+      SIM_TCP_put16( &tcp[22], SIM_TCP_MSS );
+   }
+   memcpy( &tcp[tcpHdrLen], data, len );
+
+   uint32_t sum = (uint32_t)SIM_TCP_GET16( &ip[12] ) + SIM_TCP_GET16( &ip[14] ) +
+         SIM_TCP_GET16( &ip[16] ) + SIM_TCP_GET16( &ip[18] ) +
+         SIM_TCP_IP_PROTO_TCP + tcpHdrLen + len;
+   SIM_TCP_put16( &tcp[16], ETH_SIM_inetCsum( tcp, tcpHdrLen + len, sum ) );
+
+   me->segsOut++;
+   me->txBytes += len;
+   CBErrorCode status = ETH_SIM_rxFrame( frame, SIM_TCP_ETH_HDR_LEN + ipLen );
+   if ( ERR_NONE != status ) {
+      me->segsDropped++;
+   }
+   return( status );
+}
+
+/******************************************************************************/
+static void SIM_TCP_push( SimTcp_t *me )
+{
+   if ( SIM_TCP_ESTABLISHED != me->state ) {
+      return;
+   }
+
+   uint32_t txEnd = me->txSeq + me->txLen;
+   while ( SIM_TCP_SEQ_LT( me->sndNxt, txEnd ) ) {
+      uint32_t inFlight = me->sndNxt - me->sndUna;
+      if ( inFlight >= me->sndWnd ) {
+         return;                       /* The ACK that opens it pushes more */
+      }
+
+      uint32_t segLen = txEnd - me->sndNxt;
+      if ( segLen > SIM_TCP_MSS ) {
+         segLen = SIM_TCP_MSS;
+      }
+      if ( segLen > me->sndWnd - inFlight ) {
+         segLen = me->sndWnd - inFlight;
+      }
+
+      /* A dropped segment still counts as sent, SIM_TCP_retransmit() goes
+       * back for it */
+      uint32_t seq = me->sndNxt;
+      me->sndNxt += segLen;
+      SIM_TCP_output(
+            me, seq, SIM_TCP_ACK | SIM_TCP_PSH,
+            &me->pTx[seq - me->txSeq], (uint16_t)segLen
+      );
+   }
+
+   if ( me->bFinWanted ) {
+      SIM_TCP_output( me, me->sndNxt, SIM_TCP_ACK | SIM_TCP_FIN, NULL, 0 );
+      me->sndNxt++;
+      me->state = SIM_TCP_FIN_WAIT;
+   }
+}
+
+/******************************************************************************/
+static void SIM_TCP_onArp( SimTcp_t *me, const uint8_t *arp, uint16_t len )
+{
+   if ( len < SIM_TCP_ARP_LEN ||
+         SIM_TCP_ARP_REQUEST != SIM_TCP_GET16( &arp[6] ) ||
+         0 != memcmp( &arp[24], me->ip, 4 ) ) {
+      return;
+   }
+
+   uint8_t frame[SIM_TCP_ETH_HDR_LEN + SIM_TCP_ARP_LEN];
+   uint8_t *reply = &frame[SIM_TCP_ETH_HDR_LEN];
+
+   memcpy( &frame[0], &arp[8], 6 );                 /* Back to the sender */
+   memcpy( &frame[6], me->mac, 6 );
+   SIM_TCP_put16( &frame[12], SIM_TCP_ETHERTYPE_ARP );
+
+   memcpy( reply, arp, 6 );                  /* Same hardware and protocol */
+   SIM_TCP_put16( &reply[6], SIM_TCP_ARP_REPLY );
+   memcpy( &reply[8], me->mac, 6 );
+   memcpy( &reply[14], me->ip, 4 );
+   memcpy( &reply[18], &arp[8], 10 );          /* Sender MAC and IP as target */
+
+   ETH_SIM_rxFrame( frame, sizeof(frame) );
+}
+
+/******************************************************************************/
+static void SIM_TCP_onSegment( SimTcp_t *me, const uint8_t *tcp, uint16_t len )
+{
+   uint16_t hdrLen = (uint16_t)( ( tcp[12] >> 4 ) * 4 );
+   if ( hdrLen < SIM_TCP_TCP_HDR_LEN || hdrLen > len ) {
+      return;
+   }
+
+   uint32_t seq   = SIM_TCP_GET32( &tcp[4] );
+   uint32_t ack   = SIM_TCP_GET32( &tcp[8] );
+   uint8_t  flags = tcp[13];
+   uint16_t dataLen = len - hdrLen;
+   bool bAckNeeded = false;
+
+   me->segsIn++;
+
+   if ( flags & SIM_TCP_RST ) {
+      me->state = SIM_TCP_CLOSED;
+      return;
+   }
+
+   if ( SIM_TCP_SYN_SENT == me->state ) {
+      if ( ( flags & ( SIM_TCP_SYN | SIM_TCP_ACK ) ) != ( SIM_TCP_SYN | SIM_TCP_ACK ) ||
+            ack != me->sndNxt ) {
+         return;
+      }
+      me->rcvNxt = seq + 1;
+      me->sndUna = ack;
+      me->sndWnd = SIM_TCP_GET16( &tcp[14] );
+      me->state  = SIM_TCP_ESTABLISHED;
+      SIM_TCP_output( me, me->sndNxt, SIM_TCP_ACK, NULL, 0 );
+      SIM_TCP_push( me );
+      return;
+   }
+
+   if ( SIM_TCP_CLOSED == me->state ) {
+      return;
+   }
+
+   if ( ( flags & SIM_TCP_ACK ) &&
+         SIM_TCP_SEQ_LEQ( me->sndUna, ack ) && SIM_TCP_SEQ_LEQ( ack, me->sndNxt ) ) {
+      me->sndUna = ack;
+      me->sndWnd = SIM_TCP_GET16( &tcp[14] );
+   }
+
+   /* Only in order data is taken.  Anything else gets the ACK the board needs
+    * to go back and resend. */
+   if ( 0 != dataLen ) {
+      if ( seq == me->rcvNxt ) {
+         me->rcvNxt += dataLen;
+         me->rxBytes += dataLen;
+         if ( NULL != me->dataFn ) {
+            me->dataFn( &tcp[hdrLen], dataLen, me->dataArg );
+         }
+      }
+      bAckNeeded = true;
+   }
+
+   if ( ( flags & SIM_TCP_FIN ) && seq + dataLen == me->rcvNxt ) {
+      me->rcvNxt++;
+      me->bPeerFin = true;
+      bAckNeeded = true;
+   }
+
+   if ( bAckNeeded ) {
+      SIM_TCP_output( me, me->sndNxt, SIM_TCP_ACK, NULL, 0 );
+   }
+
+   if ( SIM_TCP_FIN_WAIT == me->state ) {
+      if ( me->sndUna == me->sndNxt && me->bPeerFin ) {
+         me->state = SIM_TCP_CLOSED;
+      }
+   } else {
+      SIM_TCP_push( me );
+   }
+}
+
+/******************************************************************************/
+void SIM_TCP_ctor(
+      SimTcp_t *me,
+      const uint8_t mac[6],
+      const uint8_t ip[4],
+      uint16_t port,
+      const uint8_t peerMac[6],
+      const uint8_t peerIp[4],
+      uint16_t peerPort,
+      SIM_TCP_DataFn dataFn,
+      void *dataArg
+)
+{
+   memset( me, 0, sizeof(*me) );
+   memcpy( me->mac, mac, sizeof(me->mac) );
+   memcpy( me->ip, ip, sizeof(me->ip) );
+   memcpy( me->peerMac, peerMac, sizeof(me->peerMac) );
+   memcpy( me->peerIp, peerIp, sizeof(me->peerIp) );
+   me->port     = port;
+   me->peerPort = peerPort;
+   me->dataFn   = dataFn;
+   me->dataArg  = dataArg;
+   me->state    = SIM_TCP_CLOSED;
+}
+
+/******************************************************************************/
+CBErrorCode SIM_TCP_connect( SimTcp_t *me )
+{
+   me->sndUna     = SIM_TCP_ISS;
+   me->sndNxt     = SIM_TCP_ISS + 1;
+   me->txSeq      = me->sndNxt;
+   me->txLen      = 0;
+   me->bFinWanted = false;
+   me->bPeerFin   = false;
+   me->state      = SIM_TCP_SYN_SENT;
+   return( SIM_TCP_output( me, SIM_TCP_ISS, SIM_TCP_SYN, NULL, 0 ) );
+}
+
+/******************************************************************************/
+CBErrorCode SIM_TCP_write( SimTcp_t *me, const uint8_t *data, uint32_t len )
+{
+   if ( SIM_TCP_ESTABLISHED != me->state || me->bFinWanted ||
+         !SIM_TCP_isIdle( me ) ) {
+      return( ERR_ETH_SIM_TCP_NOT_READY );
+   }
+
+   me->pTx   = data;
+   me->txLen = len;
+   me->txSeq = me->sndNxt;
+   SIM_TCP_push( me );
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+void SIM_TCP_close( SimTcp_t *me )
+{
+   if ( SIM_TCP_ESTABLISHED == me->state ) {
+      me->bFinWanted = true;
+      SIM_TCP_push( me );
+   }
+}
+
+/******************************************************************************/
+void SIM_TCP_onFrame( SimTcp_t *me, const uint8_t *frame, uint16_t len )
+{
+   if ( len < SIM_TCP_ETH_HDR_LEN ) {
+      return;
+   }
+
+   uint16_t type = SIM_TCP_GET16( &frame[12] );
+   if ( SIM_TCP_ETHERTYPE_ARP == type ) {
+      SIM_TCP_onArp( me, &frame[SIM_TCP_ETH_HDR_LEN], len - SIM_TCP_ETH_HDR_LEN );
+      return;
+   }
+
+   const uint8_t *ip = &frame[SIM_TCP_ETH_HDR_LEN];
+   if ( SIM_TCP_ETHERTYPE_IPV4 != type ||
+         len < SIM_TCP_ETH_HDR_LEN + SIM_TCP_IP_HDR_LEN ||
+         SIM_TCP_IP_PROTO_TCP != ip[9] ||
+         0 != memcmp( &ip[12], me->peerIp, 4 ) ||
+         0 != memcmp( &ip[16], me->ip, 4 ) ) {
+      return;
+   }
+
+   uint16_t ipHdrLen = (uint16_t)( ( ip[0] & 0x0F ) * 4 );
+   uint16_t ipLen = SIM_TCP_GET16( &ip[2] );
+   if ( ipHdrLen < SIM_TCP_IP_HDR_LEN || ipLen < ipHdrLen + SIM_TCP_TCP_HDR_LEN ||
+         SIM_TCP_ETH_HDR_LEN + ipLen > len ) {
+      return;
+   }
+
+   const uint8_t *tcp = &ip[ipHdrLen];
+   if ( me->peerPort != SIM_TCP_GET16( &tcp[0] ) ||
+         me->port != SIM_TCP_GET16( &tcp[2] ) ) {
+      return;
+   }
+
+   SIM_TCP_onSegment( me, tcp, ipLen - ipHdrLen );
+}
+
+/******************************************************************************/
+void SIM_TCP_retransmit( SimTcp_t *me )
+{
+   if ( SIM_TCP_SYN_SENT == me->state ) {
+      SIM_TCP_output( me, SIM_TCP_ISS, SIM_TCP_SYN, NULL, 0 );
+      return;
+   }
+
+   if ( SIM_TCP_FIN_WAIT == me->state && me->sndUna != me->sndNxt ) {
+      /* Go back to sending data, the FIN goes out again after it */
+      me->state = SIM_TCP_ESTABLISHED;
+   }
+   if ( SIM_TCP_ESTABLISHED == me->state ) {
+      me->sndNxt = me->sndUna;
+      SIM_TCP_push( me );
+   }
+}
+
+/******************************************************************************/
+bool SIM_TCP_isIdle( const SimTcp_t *me )
+{
+   return( me->sndUna == me->sndNxt );
+}
+
+/**
+ * @}
+ * end addtogroup groupEthSim
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,197 @@
+/**
+ * @file   eth_sim_tcp.h
+ * @brief  Declarations for a synthetic TCP client on the simulated wire.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupEthSim
+ * @{
+ *
+ * Host side only.  Plays a PC talking to the board over TCP so a benchmark
+ * doesn't need a capture of every exchange: it connects, sends what it's given
+ * (menu commands, system port requests) and counts and hands back what the
+ * board sends (menu replies, streamed logs).
+ *
+ * Frames go to the board through ETH_SIM_rxFrame().  Every frame the board
+ * sends has to be passed to SIM_TCP_onFrame(), normally from the ETH_SIM_TxFn.
+ * It answers ARP requests for its own address and ACKs everything in order
+ * right away.  The wire itself never loses anything, but the board can drop
+ * frames when its RX ring is full.  Call SIM_TCP_retransmit() when the board
+ * has gone quiet with data still unacked.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ETH_SIM_TCP_H_
+#define ETH_SIM_TCP_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "CBErrors.h"                                  /* For CBErrorCode */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< Largest segment the client sends and the MSS it asks for */
+#define SIM_TCP_MSS                                                       1460
+
+/**< Receive window the client advertises.  It takes data as it comes. */
+#define SIM_TCP_WND                                                      16384
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief Function called with data the board sent, in order.
+ * @param [in] *data: const uint8_t pointer to the data.
+ * @param [in] len: uint16_t number of bytes.
+ * @param [in] *arg: void pointer given to SIM_TCP_ctor().
+ * @return: None
+ */
+typedef void (*SIM_TCP_DataFn)( const uint8_t *data, uint16_t len, void *arg );
+
+/**
+ * \enum SimTcpState_t
+ * Connection states the client goes through.
+ */
+typedef enum SimTcpStates
+{
+   SIM_TCP_CLOSED = 0,              /**< Not connected or reset by the board */
+   SIM_TCP_SYN_SENT,                           /**< Waiting for the SYN ACK */
+   SIM_TCP_ESTABLISHED,                           /**< Sending and receiving */
+   SIM_TCP_FIN_WAIT,        /**< FIN sent, waiting for it to be acked and for
+                                 the FIN of the board */
+} SimTcpState_t;
+
+/**
+ * \struct SimTcp_t
+ * One connection to the board.
+ */
+typedef struct SimTcps
+{
+   uint8_t  mac[6];                                  /**< MAC of the client */
+   uint8_t  ip[4];                                    /**< IP of the client */
+   uint16_t port;                                   /**< Port of the client */
+   uint8_t  peerMac[6];                               /**< MAC of the board */
+   uint8_t  peerIp[4];                                 /**< IP of the board */
+   uint16_t peerPort;                    /**< Port the board is listening on */
+
+   SimTcpState_t state;                         /**< Where the connection is */
+   uint32_t sndUna;                       /**< Oldest sequence not yet acked */
+   uint32_t sndNxt;                              /**< Next sequence to send */
+   uint32_t rcvNxt;                     /**< Next sequence expected to come */
+   uint32_t sndWnd;                      /**< Window advertised by the board */
+   bool     bFinWanted;             /**< Close once everything has been sent */
+   bool     bPeerFin;                      /**< Board has closed its side */
+
+   const uint8_t *pTx;                       /**< Data being sent, not copied */
+   uint32_t txLen;                                  /**< Length of pTx data */
+   uint32_t txSeq;                                 /**< Sequence of pTx[0] */
+
+   SIM_TCP_DataFn dataFn;            /**< Gets the data the board sends */
+   void    *dataArg;                                /**< Passed to dataFn */
+   uint16_t ipId;                          /**< ID of the next IP datagram */
+
+   uint32_t rxBytes;                         /**< Data bytes from the board */
+   uint32_t txBytes;              /**< Data bytes sent, retransmits included */
+   uint32_t segsIn;                         /**< Segments from the board */
+   uint32_t segsOut;                            /**< Segments to the board */
+   uint32_t segsDropped;  /**< Segments the board's MAC didn't have room for */
+} SimTcp_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Set up a client.  Nothing is sent until SIM_TCP_connect().
+ *
+ * @param [out] *me: SimTcp_t pointer to the client.
+ * @param [in] mac: const uint8_t array with the MAC of the client.
+ * @param [in] ip: const uint8_t array with the IP of the client.
+ * @param [in] port: uint16_t port of the client.
+ * @param [in] peerMac: const uint8_t array with the MAC of the board.
+ * @param [in] peerIp: const uint8_t array with the IP of the board.
+ * @param [in] peerPort: uint16_t port on the board to connect to.
+ * @param [in] dataFn: SIM_TCP_DataFn to call with the data from the board, or
+ * NULL if it's only counted.
+ * @param [in] *dataArg: void pointer passed to dataFn.
+ * @return: None
+ */
+void SIM_TCP_ctor(
+      SimTcp_t *me,
+      const uint8_t mac[6],
+      const uint8_t ip[4],
+      uint16_t port,
+      const uint8_t peerMac[6],
+      const uint8_t peerIp[4],
+      uint16_t peerPort,
+      SIM_TCP_DataFn dataFn,
+      void *dataArg
+);
+
+/**
+ * @brief   Send the SYN.
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @return: CBErrorCode from ETH_SIM_rxFrame().
+ */
+CBErrorCode SIM_TCP_connect( SimTcp_t *me );
+
+/**
+ * @brief   Send data to the board.
+ *
+ * The data isn't copied and has to stay around until SIM_TCP_isIdle().  It's
+ * sent as fast as the window of the board allows.
+ *
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @param [in] *data: const uint8_t pointer to the data.
+ * @param [in] len: uint32_t number of bytes.
+ * @return: CBErrorCode:
+ *    @arg ERR_NONE: data will be sent.
+ *    @arg ERR_ETH_SIM_TCP_NOT_READY: not connected or the last data isn't
+ *    acked yet.
+ */
+CBErrorCode SIM_TCP_write( SimTcp_t *me, const uint8_t *data, uint32_t len );
+
+/**
+ * @brief   Close the connection once everything has been sent.
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @return: None
+ */
+void SIM_TCP_close( SimTcp_t *me );
+
+/**
+ * @brief   Handle a frame sent by the board.
+ *
+ * Frames that aren't ARP requests for the client or segments of this
+ * connection are ignored, so all the clients can be given every frame.
+ *
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @param [in] *frame: const uint8_t pointer to the frame, without the FCS.
+ * @param [in] len: uint16_t length of the frame.
+ * @return: None
+ */
+void SIM_TCP_onFrame( SimTcp_t *me, const uint8_t *frame, uint16_t len );
+
+/**
+ * @brief   Send everything not acked again, starting at the oldest.
+ * @param [in] *me: SimTcp_t pointer to the client.
+ * @return: None
+ */
+void SIM_TCP_retransmit( SimTcp_t *me );
+
+/**
+ * @brief   Check if all the data written has been acked.
+ * @param [in] *me: const SimTcp_t pointer to the client.
+ * @return: bool true if there is nothing left in flight.
+ */
+bool SIM_TCP_isIdle( const SimTcp_t *me );
+
+/**
+ * @}
+ * end addtogroup groupEthSim
+ */
+
+#endif                                                      /* ETH_SIM_TCP_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
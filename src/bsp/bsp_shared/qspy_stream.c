@@ -0,0 +1,189 @@
+/**
+ * @file   qspy_stream.c
+ * @brief  This file contains the definitions for the QSPY trace streaming
+ * buffer that decouples QS record generation from the network transport.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupQSPY
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "qspy_stream.h"
+#include "Shared.h"                                   /* For MIN() macro */
+#include "stm32f4xx.h"                                 /* For STM32F4 support */
+#include <string.h>
+
+#ifdef Q_SPY
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#define QSPY_TRACE_BUF_SIZE    (32*1024)      /**< Size of the QS trace buffer */
+#define QSPY_RING_BUF_SIZE     (8*1024)  /**< Size of the stream ring. Pow of 2 */
+#define QSPY_DRAIN_CHUNK       128 /**< Max bytes copied per critical section */
+
+/* Private macros ------------------------------------------------------------*/
+/**< Both buffers are large and don't need initializing so they live in SDRAM,
+ * which is already set up by SystemInit() before main() is called. */
+#define QSPY_SDRAM             __attribute__((section(".sdram")))
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint8_t l_qsTraceBuf[QSPY_TRACE_BUF_SIZE] QSPY_SDRAM;
+static uint8_t l_qspyRing[QSPY_RING_BUF_SIZE] QSPY_SDRAM;
+
+/**< Free running ring indices.  Head is only written by the producer (idle
+ * hook) and tail is only written by the consumer AO so no locking is needed. */
+static volatile uint32_t l_qspyHead;
+static volatile uint32_t l_qspyTail;
+
+static QActive          *l_qspyConsumer;   /**< AO that sends the ring out */
+static QEvt              l_qspyFlushEvt;  /**< Static event to wake consumer */
+static volatile bool     l_qspyFlushPending;  /**< Consumer already notified */
+static bool              l_qspyRingFull;  /**< Edge detect for ring stalls */
+static bool              l_qspyQSFull;    /**< Edge detect for QS overruns */
+static QSPY_Stats        l_qspyStats;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+void QSPY_init( void )
+{
+   QS_initBuf(l_qsTraceBuf, sizeof(l_qsTraceBuf));
+
+   l_qspyHead         = 0;
+   l_qspyTail         = 0;
+   l_qspyConsumer     = (QActive *)0;
+   l_qspyFlushPending = false;
+   l_qspyRingFull     = false;
+   l_qspyQSFull       = false;
+   memset(&l_qspyStats, 0, sizeof(l_qspyStats));
+}
+
+/******************************************************************************/
+void QSPY_attach( QActive *ao, QSignal sig )
+{
+   l_qspyFlushEvt.sig     = sig;
+   l_qspyFlushEvt.poolId_ = 0U;                  /* static, immutable event */
+   l_qspyFlushEvt.refCtr_ = 0U;
+   l_qspyFlushPending     = false;
+   l_qspyConsumer         = ao;
+}
+
+/******************************************************************************/
+void QSPY_drain( void )
+{
+   /* A full QS buffer means the next record will overwrite the oldest.  Only
+    * count each time it fills up, not each time the idle hook notices it. */
+   QF_INT_DISABLE();
+   bool isQSFull = ( QS_priv_.used >= QS_priv_.end );
+   QF_INT_ENABLE();
+   if ( isQSFull && !l_qspyQSFull ) {
+      l_qspyStats.qsOverruns++;
+   }
+   l_qspyQSFull = isQSFull;
+
+   for (;;) {
+      uint32_t head  = l_qspyHead;
+      uint32_t space = QSPY_RING_BUF_SIZE - (head - l_qspyTail);
+      uint32_t offs  = head & (QSPY_RING_BUF_SIZE - 1);
+
+      if ( 0 == space ) {
+         if ( !l_qspyRingFull ) {
+            l_qspyStats.ringFullStalls++;
+         }
+         l_qspyRingFull = true;
+         break;
+      }
+      l_qspyRingFull = false;
+
+      /* Copy only up to the physical end of the ring in one go */
+      uint16_t nBytes = (uint16_t)MIN( space, QSPY_RING_BUF_SIZE - offs );
+      nBytes = (uint16_t)MIN( nBytes, QSPY_DRAIN_CHUNK );
+
+      QF_INT_DISABLE();
+      uint8_t const *block = QS_getBlock(&nBytes);
+      if ( (uint8_t const *)0 != block ) {
+         memcpy(&l_qspyRing[offs], block, nBytes);
+      }
+      QF_INT_ENABLE();
+
+      if ( (uint8_t const *)0 == block ) {
+         break;                                        /* No more QS data */
+      }
+
+      __DMB();                /* Data must be in the ring before head moves */
+      l_qspyHead = head + nBytes;
+      l_qspyStats.bytesQueued += nBytes;
+   }
+
+   /* Wake up the consumer only once there is a full datagram worth of data.
+    * Any leftovers are picked up by the consumer on its own periodic tick. */
+   if ( ((QActive *)0 != l_qspyConsumer) && !l_qspyFlushPending &&
+        (QSPY_level() >= QSPY_DGRAM_SIZE) ) {
+      l_qspyFlushPending = true;
+      if ( !QACTIVE_POST_X(l_qspyConsumer, &l_qspyFlushEvt, 1U, (void *)0) ) {
+         l_qspyFlushPending = false;          /* Queue full, try again later */
+      }
+   }
+}
+
+/******************************************************************************/
+uint32_t QSPY_level( void )
+{
+   return( l_qspyHead - l_qspyTail );
+}
+
+/******************************************************************************/
+uint16_t QSPY_read( uint8_t *dst, uint16_t len )
+{
+   uint32_t tail  = l_qspyTail;
+   uint32_t avail = l_qspyHead - tail;
+   uint16_t nRead = (uint16_t)MIN( avail, len );
+   uint32_t offs  = tail & (QSPY_RING_BUF_SIZE - 1);
+   uint32_t first = MIN( nRead, QSPY_RING_BUF_SIZE - offs );
+
+   memcpy(dst, &l_qspyRing[offs], first);
+   memcpy(&dst[first], l_qspyRing, nRead - first);           /* wrapped part */
+
+   __DMB();             /* Data must be out of the ring before tail moves */
+   l_qspyTail = tail + nRead;
+   return( nRead );
+}
+
+/******************************************************************************/
+void QSPY_flushDone( void )
+{
+   l_qspyFlushPending = false;
+}
+
+/******************************************************************************/
+void QSPY_countTx( uint16_t nBytes, bool isSent )
+{
+   if ( isSent ) {
+      l_qspyStats.dgramsSent++;
+      l_qspyStats.bytesSent += nBytes;
+   } else {
+      l_qspyStats.dgramsDropped++;
+   }
+}
+
+/******************************************************************************/
+QSPY_Stats const *QSPY_getStats( void )
+{
+   return( &l_qspyStats );
+}
+
+#endif                                                             /* Q_SPY */
+
+/**
+ * @}
+ * end addtogroup groupQSPY
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,138 @@
+/**
+ * @file   qspy_stream.h
+ * @brief  This file contains the declarations for the QSPY trace streaming
+ * buffer that decouples QS record generation from the network transport.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupQSPY
+ * @{
+ *
+ * QS trace records are formatted by QP into the QS trace buffer.  The FreeRTOS
+ * idle hook moves them (in short critical sections) into a single-producer,
+ * single-consumer stream ring.  The only consumer of that ring is the LWIPMgr
+ * AO, which sends the contents out as UDP datagrams to a QSPY host.  Neither
+ * side ever blocks on the other: when the stream ring is full, the idle hook
+ * simply stops draining and the QS buffer absorbs the backlog until it wraps.
+ *
+ * All of this only exists in Q_SPY builds.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef QSPY_STREAM_H_
+#define QSPY_STREAM_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include "qp_port.h"                                        /* for QP support */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef Q_SPY
+
+/* Exported defines ----------------------------------------------------------*/
+#define QSPY_UDP_PORT           6601       /**< Default QSPY port on the host */
+#define QSPY_DGRAM_SIZE         512 /**< Max bytes of trace per UDP datagram */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/**
+ * \struct QSPY_Stats
+ * Counters used to account for trace data lost due to backpressure.
+ */
+typedef struct {
+   uint32_t bytesQueued;        /**< Bytes moved from QS buffer to the ring */
+   uint32_t bytesSent;       /**< Bytes handed to lwIP in sent datagrams */
+   uint32_t dgramsSent;                  /**< Number of datagrams sent out */
+   uint32_t dgramsDropped; /**< Datagrams lost due to lack of lwIP memory */
+   uint32_t qsOverruns;  /**< Times QS buffer was found full (records lost) */
+   uint32_t ringFullStalls; /**< Times the drain stopped due to a full ring */
+} QSPY_Stats;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/**
+ * @brief  Initialize the QS trace buffer and the QSPY stream ring.
+ *
+ * @note: should only be called from QS_onStartup().
+ *
+ * @param  None
+ * @return None
+ */
+void QSPY_init( void );
+
+/**
+ * @brief  Attach an AO that consumes the stream ring.
+ *
+ * After this call, QSPY_drain() will post an event with the given signal to
+ * the AO whenever at least a full datagram of trace data is waiting.
+ *
+ * @param [in] *ao: QActive pointer to the consumer AO.
+ * @param [in] sig: QSignal to post to the consumer AO.
+ * @return None
+ */
+void QSPY_attach( QActive *ao, QSignal sig );
+
+/**
+ * @brief  Move QS trace data into the stream ring (producer side).
+ *
+ * @note: should only be called from the idle hook.  The ring has a single
+ * producer, so calling it from anywhere else (QS_onFlush() included) would
+ * let two drains write the same part of the ring.
+ *
+ * @param  None
+ * @return None
+ */
+void QSPY_drain( void );
+
+/**
+ * @brief  Number of bytes currently waiting in the stream ring.
+ * @param  None
+ * @return uint32_t: number of bytes available to QSPY_read().
+ */
+uint32_t QSPY_level( void );
+
+/**
+ * @brief  Copy data out of the stream ring (consumer side).
+ *
+ * @note: should only be called from the consumer AO.
+ *
+ * @param [out] *dst: uint8_t pointer to the buffer to copy into.
+ * @param [in] len: uint16_t max number of bytes to copy.
+ * @return uint16_t: number of bytes actually copied.
+ */
+uint16_t QSPY_read( uint8_t *dst, uint16_t len );
+
+/**
+ * @brief  Tell the producer that the consumer finished servicing a flush event.
+ * @param  None
+ * @return None
+ */
+void QSPY_flushDone( void );
+
+/**
+ * @brief  Account for a datagram the consumer tried to send.
+ * @param [in] nBytes: uint16_t number of bytes in the datagram.
+ * @param [in] isSent: bool indicating whether lwIP accepted the datagram.
+ * @return None
+ */
+void QSPY_countTx( uint16_t nBytes, bool isSent );
+
+/**
+ * @brief  Get a pointer to the QSPY stream counters.
+ * @param  None
+ * @return QSPY_Stats const*: pointer to the counters.
+ */
+QSPY_Stats const *QSPY_getStats( void );
+
+#endif                                                             /* Q_SPY */
+
+/**
+ * @}
+ * end addtogroup groupQSPY
+ */
+
+#endif                                                      /* QSPY_STREAM_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
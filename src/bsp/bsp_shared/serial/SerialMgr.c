@@ -167,8 +167,10 @@ static QState SerialMgr_initial(SerialMgr * const me, QEvt const * const e) {
     QS_FUN_DICTIONARY(&SerialMgr_Busy);
 
     me->isSerialDbgEnabled = true; // enable debug over serial by default.
+    DBG_SINK_enable(DBG_SINK_SERIAL, me->isSerialDbgEnabled);
 
     QActive_subscribe((QActive *)me, UART_DMA_START_SIG);
+    QActive_subscribe((QActive *)me, UART_DMA_B64_START_SIG);
     QActive_subscribe((QActive *)me, DBG_LOG_SIG);
     QActive_subscribe((QActive *)me, DBG_MENU_SIG);
     QActive_subscribe((QActive *)me, UART_DMA_DONE_SIG);
@@ -207,6 +209,7 @@ static QState SerialMgr_Active(SerialMgr * const me, QEvt const * const e) {
         /* ${AOs::SerialMgr::SM::Active::UART_DMA_DBG_TOGGLE} */
         case UART_DMA_DBG_TOGGLE_SIG: {
             me->isSerialDbgEnabled = !(me->isSerialDbgEnabled);
+            DBG_SINK_enable(DBG_SINK_SERIAL, me->isSerialDbgEnabled);
             status_ = Q_HANDLED();
             break;
         }
@@ -254,6 +257,18 @@ static QState SerialMgr_Idle(SerialMgr * const me, QEvt const * const e) {
             status_ = Q_TRAN(&SerialMgr_Busy);
             break;
         }
+        /* ${AOs::SerialMgr::SM::Active::Idle::UART_DMA_B64_START} */
+        case UART_DMA_B64_START_SIG: {
+            /* Base64 encode the data from the event straight into the UART's private
+             * buffer */
+            Serial_DMAConfigBase64(
+                SERIAL_UART1,
+                ((LrgDataEvt const *) e)->dataBuf,
+                ((LrgDataEvt const *) e)->dataLen
+            );
+            status_ = Q_TRAN(&SerialMgr_Busy);
+            break;
+        }
         /* ${AOs::SerialMgr::SM::Active::Idle::DBG_MENU} */
         case DBG_MENU_SIG: {
             /* Set up the DMA buffer here.  This copies the data from the event to the UART's
@@ -337,8 +352,9 @@ static QState SerialMgr_Busy(SerialMgr * const me, QEvt const * const e) {
             status_ = Q_TRAN(&SerialMgr_Idle);
             break;
         }
-        /* ${AOs::SerialMgr::SM::Active::Busy::UART_DMA_START, DBG_LOG, DBG_MENU} */
+        /* ${AOs::SerialMgr::SM::Active::Busy::UART_DMA_START, UART_DMA_B64_START, DBG_LOG, DBG_MENU} */
         case UART_DMA_START_SIG: /* intentionally fall through */
+        case UART_DMA_B64_START_SIG: /* intentionally fall through */
         case DBG_LOG_SIG: /* intentionally fall through */
         case DBG_MENU_SIG: {
             if (QEQueue_getNFree(&me->deferredEvtQueue) > 0) {
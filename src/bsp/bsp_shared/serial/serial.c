@@ -13,6 +13,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "serial.h"
+#include "serial_rx.h"
 #include "stm32f4xx.h"                                 /* For STM32F4 support */
 #include "stm32f4xx_rcc.h"                         /* For STM32F4 clk support */
 #include "stm32f4xx_dma.h"                         /* For STM32F4 DMA support */
@@ -21,8 +22,11 @@
 
 #include "assert.h"
 #include "project_includes.h"
-#include "base64_wrapper.h"
+#include "base64_stream.h"
+#include "comm.h"                                       /* For CommFrameEvt */
 #include <stdio.h>
+#include <stddef.h>
+#include <string.h>
 #include "qp_port.h"                                        /* for QP support */
 #include "CBSignals.h"
 #include "CBErrors.h"
@@ -36,6 +40,19 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_SERIAL ); /* For debug system to ID this module
 
 /* Private typedefs ----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
+#define UART1_RX_DMA_BUF_LEN        256  /**< Circular RX DMA buffer for UART1 */
+
+/**< TX DMA buffer holds a whole LrgDataEvt, base64 encoded, plus the '\n' */
+#define UART1_TX_BUF_LEN            (B64S_ENCODED_LEN(MAX_MSG_LEN) + 1)
+
+/**< RX line buffer holds a whole base64 encoded frame plus the '\n' */
+#define UART1_RX_LINE_LEN           (B64S_ENCODED_LEN(MAX_MSG_LEN) + 1)
+
+/**< Every base64 encoded frame starts with these characters.  They are the
+ * encoding of COMM_FRAME_SYNC0 and the top of COMM_FRAME_SYNC1, and no menu
+ * command starts with them. */
+#define SERIAL_B64_FRAME_PREFIX     "pV"
+#define SERIAL_B64_FRAME_PREFIX_LEN 2
 /**
  * @brief Maximum Timeout values for flags and events waiting loops.
  * These timeouts are not based on accurate values, they just guarantee that
@@ -52,8 +69,26 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_SERIAL ); /* For debug system to ID this module
 /**
  * @brief Buffers for Serial interfaces
  */
-static char          Uart1TxBuffer[MAX_MSG_LEN];
-static char          Uart1RxBuffer[MENU_MAX_CMD_LEN];
+static char          Uart1TxBuffer[UART1_TX_BUF_LEN];
+static char          Uart1RxBuffer[UART1_RX_LINE_LEN];
+static uint8_t       Uart1RxDMABuffer[UART1_RX_DMA_BUF_LEN];
+
+/**
+ * @brief Line assemblers that consume the circular RX DMA buffers
+ */
+static SerialRxParser_t a_UARTRxParsers[SERIAL_MAX];
+
+/**
+ * @brief Binary command frames that come over UART1 as base64 lines
+ */
+static CommFrameParser_t l_uart1FrameParser;
+static B64S_DecState     l_uart1FrameB64;
+
+/**
+ * @brief TX counters for Serial interfaces
+ */
+static Serial_Stats_t a_UARTStats[SERIAL_MAX];
+
 /**
  * @brief An internal array of structures that holds almost all the settings for
  * the all serial ports used in the system.
@@ -65,7 +100,7 @@ static USART_Settings_t a_UARTSettings[SERIAL_MAX] =
 
             /* USART settings */
             USART1,                    /**< usart */
-            115200,                    /**< usart_baud */
+            460800,                    /**< usart_baud */
             RCC_APB2Periph_USART1,     /**< usart_clk */
             USART1_IRQn,               /**< usart_irq_num */
             USART1_PRIO,               /**< usart_irq_prio */
@@ -85,8 +120,10 @@ static USART_Settings_t a_UARTSettings[SERIAL_MAX] =
             /* Buffer management */
             &Uart1TxBuffer[0],         /**< *bufferTX */
             0,                         /**< indexTX */
-            &Uart1RxBuffer[0],         /**< *bufferTX */
-            0,                         /**< indexRX */
+            &Uart1RxBuffer[0],         /**< *bufferRX */
+            UART1_RX_LINE_LEN,         /**< bufferRXLen */
+            &Uart1RxDMABuffer[0],      /**< *bufferRXDMA */
+            UART1_RX_DMA_BUF_LEN,      /**< bufferRXDMALen */
       }
 };
 
@@ -100,11 +137,281 @@ static USART_DMA_Settings_t a_UARTDMASettings[SERIAL_MAX] =
             DMA_Channel_4,             /**< dma_channel */
             DMA2_Stream7,              /**< dma_stream */
             RCC_AHB1Periph_DMA2,       /**< dma_clk */
+
+            DMA2_Stream5_IRQn,         /**< rx_dma_irq_num */
+            USART1_PRIO,               /**< rx_dma_irq_prio - same as USART so
+                                            the two RX ISRs can't preempt each
+                                            other */
+            DMA_Channel_4,             /**< rx_dma_channel */
+            DMA2_Stream5,              /**< rx_dma_stream */
       }
 };
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Set up and start the circular RX DMA for specified serial port.
+ *
+ * @param [in] serial_port: Which serial port to set up the RX DMA for
+ *    @arg SYSTEM_SERIAL
+ * @return: None
+ */
+static void Serial_DMARxConfig(
+      SerialPort_T serial_port
+);
+
+/**
+ * @brief   Process all data received by the RX DMA of a serial port so far.
+ *
+ * @note: Should only be called from the RX ISRs of the serial port.
+ *
+ * @param [in] serial_port: Which serial port to process
+ *    @arg SYSTEM_SERIAL
+ * @return: None
+ */
+static void Serial_RxProcess(
+      SerialPort_T serial_port
+);
+
+/**
+ * @brief   Hand a complete line received over UART1 to whoever takes it.
+ *
+ * Lines that start with SERIAL_B64_FRAME_PREFIX are base64 encoded command
+ * frames and are decoded straight into the frame parser of the port.  All
+ * other lines are published as menu commands.
+ *
+ * @param [in] *line: pointer to the line, including the terminating '\n'.
+ * @param [in] len: length of the line, including the terminating '\n'.
+ * @return: None
+ */
+static void Serial_UART1LineHandler(
+      const char *line,
+      uint16_t len
+);
+
+/**
+ * @brief   Get an event to hold the payload of a frame received over UART1.
+ * @param [in] *ctx: unused.
+ * @param [in] *hdr: CommFrameHdr_t pointer to the header of the frame.
+ * @return: pointer to the payload buffer of a new CommFrameEvt, or NULL if
+ * the pool is running low.
+ */
+static uint8_t* Serial_UART1FrameGetBuffer(
+      void *ctx,
+      const CommFrameHdr_t *hdr
+);
+
+/**
+ * @brief   Publish or recycle the event of a frame received over UART1.
+ * @param [in] *ctx: unused.
+ * @param [in] *hdr: CommFrameHdr_t pointer to the header of the frame.
+ * @param [in] *payload: payload buffer of the event.
+ * @param [in] isValid: true if the frame passed its CRC check.
+ * @return: None
+ */
+static void Serial_UART1FrameHandler(
+      void *ctx,
+      const CommFrameHdr_t *hdr,
+      uint8_t *payload,
+      bool isValid
+);
+
+/**
+ * @brief   Set up the TX DMA to send what's in the TX buffer of a port.
+ *
+ * @param [in] serial_port: Which serial port to set up the TX DMA for
+ *    @arg SYSTEM_SERIAL
+ * @return: None
+ */
+static void Serial_DMATxConfig(
+      SerialPort_T serial_port
+);
+
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+static void Serial_DMARxConfig(
+      SerialPort_T serial_port
+)
+{
+   /* Enable the DMA clock */
+   RCC_AHB1PeriphClockCmd( a_UARTDMASettings[serial_port].dma_clk, ENABLE );
+
+   DMA_DeInit( a_UARTDMASettings[serial_port].rx_dma_stream );
+
+   DMA_InitTypeDef  DMA_InitStructure;
+   DMA_InitStructure.DMA_Channel             = a_UARTDMASettings[serial_port].rx_dma_channel;
+   DMA_InitStructure.DMA_DIR                 = DMA_DIR_PeripheralToMemory; // Receive
+   DMA_InitStructure.DMA_Memory0BaseAddr     = (uint32_t)a_UARTSettings[serial_port].bufferRXDMA;
+   DMA_InitStructure.DMA_BufferSize          = (uint16_t)a_UARTSettings[serial_port].bufferRXDMALen;
+   DMA_InitStructure.DMA_PeripheralBaseAddr  = (uint32_t)&(a_UARTSettings[serial_port].usart)->DR;
+   DMA_InitStructure.DMA_PeripheralInc       = DMA_PeripheralInc_Disable;
+   DMA_InitStructure.DMA_MemoryInc           = DMA_MemoryInc_Enable;
+   DMA_InitStructure.DMA_PeripheralDataSize  = DMA_PeripheralDataSize_Byte;
+   DMA_InitStructure.DMA_MemoryDataSize      = DMA_MemoryDataSize_Byte;
+   DMA_InitStructure.DMA_Mode                = DMA_Mode_Circular;
+   DMA_InitStructure.DMA_Priority            = DMA_Priority_High;
+   /* No FIFO so the DMA counter always reflects what is actually in memory */
+   DMA_InitStructure.DMA_FIFOMode            = DMA_FIFOMode_Disable;
+   DMA_InitStructure.DMA_FIFOThreshold       = DMA_FIFOThreshold_Full;
+   DMA_InitStructure.DMA_MemoryBurst         = DMA_MemoryBurst_Single;
+   DMA_InitStructure.DMA_PeripheralBurst     = DMA_PeripheralBurst_Single;
+
+   DMA_Init( a_UARTDMASettings[serial_port].rx_dma_stream, &DMA_InitStructure );
+
+   /* Set up Interrupt controller to handle USART RX DMA */
+   NVIC_Config(
+         a_UARTDMASettings[serial_port].rx_dma_irq_num,
+         a_UARTDMASettings[serial_port].rx_dma_irq_prio
+   );
+
+   /* Half and full transfer interrupts guarantee the ring is serviced at
+    * least twice per lap even if the line never goes idle */
+   DMA_ITConfig(
+         a_UARTDMASettings[serial_port].rx_dma_stream,
+         DMA_IT_HT | DMA_IT_TC,
+         ENABLE
+   );
+
+   /* Enable the USART Rx DMA request */
+   USART_DMACmd( a_UARTSettings[serial_port].usart, USART_DMAReq_Rx, ENABLE );
+
+   /* Start the circular RX DMA.  It runs forever from this point on. */
+   DMA_Cmd( a_UARTDMASettings[serial_port].rx_dma_stream, ENABLE );
+}
+
+/******************************************************************************/
+static void Serial_RxProcess(
+      SerialPort_T serial_port
+)
+{
+   /* The DMA counts down the number of bytes left until it wraps around */
+   uint16_t writePos = a_UARTSettings[serial_port].bufferRXDMALen -
+         DMA_GetCurrDataCounter( a_UARTDMASettings[serial_port].rx_dma_stream );
+
+   SerialRx_process( &a_UARTRxParsers[serial_port], writePos );
+}
+
+/******************************************************************************/
+static void Serial_UART1LineHandler(
+      const char *line,
+      uint16_t len
+)
+{
+   if ( len > SERIAL_B64_FRAME_PREFIX_LEN &&
+         0 == memcmp( line, SERIAL_B64_FRAME_PREFIX, SERIAL_B64_FRAME_PREFIX_LEN ) ) {
+      B64S_decodeInit( &l_uart1FrameB64 );
+      CommFrame_feedBase64( &l_uart1FrameParser, &l_uart1FrameB64, line, len );
+
+      /* A frame never spans lines so drop whatever is left of one */
+      CommFrame_reset( &l_uart1FrameParser );
+      return;
+   }
+
+   if ( len > MENU_MAX_CMD_LEN ) {
+      a_UARTStats[SERIAL_UART1].nRxLongLines++;
+      return;
+   }
+
+   MenuEvt *menuEvt = Q_NEW( MenuEvt, DBG_MENU_REQ_SIG );
+
+   /* Fill the msg payload with payload (the actual received msg)*/
+   MEMCPY( menuEvt->buffer, line, len );
+   menuEvt->bufferLen = len;
+   menuEvt->msgSrc = SERIAL_CON;
+
+   /* Publish the newly created event to current AO */
+   QF_PUBLISH( (QEvent *)menuEvt, AO_SerialMgr );
+}
+
+/******************************************************************************/
+static uint8_t* Serial_UART1FrameGetBuffer(
+      void *ctx,
+      const CommFrameHdr_t *hdr
+)
+{
+   (void)ctx;        /* suppress the compiler warning about unused parameter */
+
+   /* Leave a few events in the pool for the logging and the responses */
+   CommFrameEvt *frameEvt;
+   Q_NEW_X( frameEvt, CommFrameEvt, 4, MSG_FRAME_RECEIVED_SIG );
+   if ( NULL == frameEvt ) {
+      return( NULL );
+   }
+
+   frameEvt->src     = SERIAL_CON;
+   frameEvt->type    = hdr->type;
+   frameEvt->seq     = hdr->seq;
+   frameEvt->dataLen = hdr->len;
+   return( frameEvt->dataBuf );
+}
+
+/******************************************************************************/
+static void Serial_UART1FrameHandler(
+      void *ctx,
+      const CommFrameHdr_t *hdr,
+      uint8_t *payload,
+      bool isValid
+)
+{
+   (void)ctx;        /* suppress the compiler warning about unused parameter */
+   (void)hdr;
+
+   /* Get back to the event that owns the payload buffer */
+   CommFrameEvt *frameEvt = (CommFrameEvt *)(
+         payload - offsetof(CommFrameEvt, dataBuf)
+   );
+
+   if ( isValid ) {
+      QF_PUBLISH( (QEvt *)frameEvt, AO_SerialMgr );
+   } else {
+      QF_gc( (QEvt *)frameEvt );            /* Never published so recycle it */
+   }
+}
+
+/******************************************************************************/
+static void Serial_DMATxConfig(
+      SerialPort_T serial_port
+)
+{
+   /* Enable the DMA clock */
+   RCC_AHB1PeriphClockCmd( a_UARTDMASettings[serial_port].dma_clk, ENABLE );
+
+   /* Set up Interrupt controller to handle USART DMA */
+   NVIC_Config(
+         a_UARTDMASettings[serial_port].dma_irq_num,
+         a_UARTDMASettings[serial_port].dma_irq_prio
+   );
+
+   a_UARTStats[serial_port].nTxBytes += a_UARTSettings[serial_port].indexTX;
+
+   DMA_DeInit( a_UARTDMASettings[serial_port].dma_stream );
+
+   DMA_InitTypeDef  DMA_InitStructure;
+   DMA_InitStructure.DMA_Channel             = a_UARTDMASettings[serial_port].dma_channel;
+   DMA_InitStructure.DMA_DIR                 = DMA_DIR_MemoryToPeripheral; // Transmit
+   DMA_InitStructure.DMA_Memory0BaseAddr     = (uint32_t)a_UARTSettings[serial_port].bufferTX;
+   DMA_InitStructure.DMA_BufferSize          = (uint16_t)a_UARTSettings[serial_port].indexTX;
+   DMA_InitStructure.DMA_PeripheralBaseAddr  = (uint32_t)&(a_UARTSettings[serial_port].usart)->DR;
+   DMA_InitStructure.DMA_PeripheralInc       = DMA_PeripheralInc_Disable;
+   DMA_InitStructure.DMA_MemoryInc           = DMA_MemoryInc_Enable;
+   DMA_InitStructure.DMA_PeripheralDataSize  = DMA_PeripheralDataSize_Byte;
+   DMA_InitStructure.DMA_MemoryDataSize      = DMA_MemoryDataSize_Byte;
+   DMA_InitStructure.DMA_Mode                = DMA_Mode_Normal;
+   DMA_InitStructure.DMA_Priority            = DMA_Priority_High;
+   DMA_InitStructure.DMA_FIFOMode            = DMA_FIFOMode_Enable;
+   DMA_InitStructure.DMA_FIFOThreshold       = DMA_FIFOThreshold_Full;
+   DMA_InitStructure.DMA_MemoryBurst         = DMA_MemoryBurst_Single;
+   DMA_InitStructure.DMA_PeripheralBurst     = DMA_PeripheralBurst_Single;
+
+   DMA_Init( a_UARTDMASettings[serial_port].dma_stream, &DMA_InitStructure );
+
+   /* Enable the USART Tx DMA request */
+   USART_DMACmd( a_UARTSettings[serial_port].usart, USART_DMAReq_Tx, ENABLE );
+
+   /* Enable DMA Stream Transfer Complete interrupt */
+   DMA_ITConfig( a_UARTDMASettings[serial_port].dma_stream, DMA_IT_TC, ENABLE );
+}
+
 /******************************************************************************/
 void Serial_Init(
       SerialPort_T serial_port
@@ -155,7 +462,7 @@ void Serial_Init(
 
    /* 3 - Set all the USART ------------------------------------------------ */
    /* All system serial devices are configured as follows:
-       - BaudRate = 115200 baud
+       - BaudRate = 460800 baud (set in a_UARTSettings)
        - Word Length = 8 Bits
        - One Stop Bit
        - No parity
@@ -183,10 +490,30 @@ void Serial_Init(
          a_UARTSettings[serial_port].usart_irq_prio
    );
 
-   /* Enable USART interrupts */
+   /* 4 - Set up circular RX DMA ------------------------------------------- */
+   /* Only UART1 exists for now so it's the only one with a line handler */
+   SerialRx_init(
+         &a_UARTRxParsers[serial_port],
+         a_UARTSettings[serial_port].bufferRXDMA,
+         a_UARTSettings[serial_port].bufferRXDMALen,
+         a_UARTSettings[serial_port].bufferRX,
+         a_UARTSettings[serial_port].bufferRXLen,
+         Serial_UART1LineHandler
+   );
+   CommFrame_init(
+         &l_uart1FrameParser,
+         COMM_FRAME_MAX_PAYLOAD,
+         Serial_UART1FrameGetBuffer,
+         Serial_UART1FrameHandler,
+         NULL
+   );
+   Serial_DMARxConfig( serial_port );
+
+   /* Enable USART interrupts.  Data is moved by the DMA so the only interrupt
+    * needed from the USART is the one that says the line went idle. */
    USART_ITConfig(
          a_UARTSettings[serial_port].usart,                   /* Which USART */
-         USART_IT_RXNE,                         /* Which interrupt to choose */
+         USART_IT_IDLE,                         /* Which interrupt to choose */
          ENABLE                                         /* ENABLE or DISABLE */
    );
 
@@ -204,45 +531,42 @@ void Serial_DMAConfig(
 {
    assert(wBufferLen <= MAX_MSG_LEN);
 
-   /* Enable the DMA clock */
-   RCC_AHB1PeriphClockCmd( a_UARTDMASettings[serial_port].dma_clk, ENABLE );
-
-   /* Set up Interrupt controller to handle USART DMA */
-   NVIC_Config(
-         a_UARTDMASettings[serial_port].dma_irq_num,
-         a_UARTDMASettings[serial_port].dma_irq_prio
-   );
-
    /* Copy over the buffer and index. TODO: maybe do this in the StartXfer()? */
    a_UARTSettings[serial_port].indexTX = wBufferLen;
    MEMCPY( a_UARTSettings[serial_port].bufferTX, pBuffer, wBufferLen );
 
-   DMA_DeInit( a_UARTDMASettings[serial_port].dma_stream );
-
-   DMA_InitTypeDef  DMA_InitStructure;
-   DMA_InitStructure.DMA_Channel             = a_UARTDMASettings[serial_port].dma_channel;
-   DMA_InitStructure.DMA_DIR                 = DMA_DIR_MemoryToPeripheral; // Transmit
-   DMA_InitStructure.DMA_Memory0BaseAddr     = (uint32_t)a_UARTSettings[serial_port].bufferTX;
-   DMA_InitStructure.DMA_BufferSize          = (uint16_t)a_UARTSettings[serial_port].indexTX;
-   DMA_InitStructure.DMA_PeripheralBaseAddr  = (uint32_t)&(a_UARTSettings[serial_port].usart)->DR;
-   DMA_InitStructure.DMA_PeripheralInc       = DMA_PeripheralInc_Disable;
-   DMA_InitStructure.DMA_MemoryInc           = DMA_MemoryInc_Enable;
-   DMA_InitStructure.DMA_PeripheralDataSize  = DMA_PeripheralDataSize_Byte;
-   DMA_InitStructure.DMA_MemoryDataSize      = DMA_MemoryDataSize_Byte;
-   DMA_InitStructure.DMA_Mode                = DMA_Mode_Normal;
-   DMA_InitStructure.DMA_Priority            = DMA_Priority_High;
-   DMA_InitStructure.DMA_FIFOMode            = DMA_FIFOMode_Enable;
-   DMA_InitStructure.DMA_FIFOThreshold       = DMA_FIFOThreshold_Full;
-   DMA_InitStructure.DMA_MemoryBurst         = DMA_MemoryBurst_Single;
-   DMA_InitStructure.DMA_PeripheralBurst     = DMA_PeripheralBurst_Single;
-
-   DMA_Init( a_UARTDMASettings[serial_port].dma_stream, &DMA_InitStructure );
+   Serial_DMATxConfig( serial_port );
+}
 
-   /* Enable the USART Tx DMA request */
-   USART_DMACmd( a_UARTSettings[serial_port].usart, USART_DMAReq_Tx, ENABLE );
+/******************************************************************************/
+void Serial_DMAConfigBase64(
+      SerialPort_T serial_port,
+      const uint8_t *pData,
+      uint16_t wDataLen
+)
+{
+   assert(wDataLen <= MAX_MSG_LEN);
+
+   /* Encode straight into the TX DMA buffer.  It holds the encoding of the
+    * largest message so all of it goes in one call. */
+   char *pOut = a_UARTSettings[serial_port].bufferTX;
+   B64S_EncState state;
+   int consumed = 0;
+
+   B64S_encodeInit( &state );
+   int encoded_sz = B64S_encodeChunk(
+         &state,
+         pData,
+         wDataLen,
+         pOut,
+         UART1_TX_BUF_LEN,
+         &consumed
+   );
+   encoded_sz += B64S_encodeFinal( &state, &pOut[encoded_sz] );
+   pOut[encoded_sz++] = '\n';
 
-   /* Enable DMA Stream Transfer Complete interrupt */
-   DMA_ITConfig( a_UARTDMASettings[serial_port].dma_stream, DMA_IT_TC, ENABLE );
+   a_UARTSettings[serial_port].indexTX = (uint16_t)encoded_sz;
+   Serial_DMATxConfig( serial_port );
 }
 
 /******************************************************************************/
@@ -254,26 +578,6 @@ void Serial_DMAStartXfer(
    DMA_Cmd(a_UARTDMASettings[serial_port].dma_stream, ENABLE);
 }
 
-/******************************************************************************/
-uint32_t Serial_send_base64_enc_msg(
-      SerialPort_T serial_port,
-      char *message,
-      uint16_t len
-)
-{
-   char encoded_serial_buf[MAX_MSG_LEN];
-   int encoded_sz = base64_encode( message, len, encoded_serial_buf, MAX_MSG_LEN );
-
-   if(encoded_sz < 1)
-   {
-      err_slow_printf("Encoding failed\n");
-      return ERR_SERIAL_MSG_BASE64_ENC_FAILED;
-   }
-
-   /* Return the result of the raw message send function */
-   return( Serial_send_raw_msg( serial_port, encoded_serial_buf, encoded_sz ) );
-}
-
 /******************************************************************************/
 uint32_t Serial_send_raw_msg(
       SerialPort_T serial_port,
@@ -296,15 +600,33 @@ uint32_t Serial_send_raw_msg(
       while( RESET == USART_GetFlagStatus( a_UARTSettings[ serial_port ].usart, USART_FLAG_TXE ) ) {
          if( (timeout--) <= 0 ) {
             err_slow_printf("!!! - Hardware not responding while trying to send a serial msg\n");
+            a_UARTStats[serial_port].nTxTimeouts++;
             return ERR_SERIAL_HW_TIMEOUT;
          }
       }
       USART_SendData( a_UARTSettings[ serial_port ].usart, message[i] );
+      a_UARTStats[serial_port].nTxBytes++;
    }
 
    return ERR_NONE;
 }
 
+/******************************************************************************/
+const Serial_Stats_t* Serial_getStats(
+      SerialPort_T serial_port
+)
+{
+   return( &a_UARTStats[serial_port] );
+}
+
+/******************************************************************************/
+const SerialRxParser_t* Serial_getRxParser(
+      SerialPort_T serial_port
+)
+{
+   return( &a_UARTRxParsers[serial_port] );
+}
+
 /******************************************************************************/
 /***                      Callback functions for Serial/UART                ***/
 /******************************************************************************/
@@ -326,65 +648,31 @@ inline void Serial_DMASendCallback( void )
    }
 }
 
+/******************************************************************************/
+inline void Serial_DMARecvCallback( void )
+{
+   /* Test on DMA Stream Half Transfer interrupt */
+   if ( RESET != DMA_GetITStatus(DMA2_Stream5, DMA_IT_HTIF5) ) {
+      DMA_ClearITPendingBit(DMA2_Stream5, DMA_IT_HTIF5);
+      Serial_RxProcess( SERIAL_UART1 );
+   }
+
+   /* Test on DMA Stream Transfer Complete interrupt */
+   if ( RESET != DMA_GetITStatus(DMA2_Stream5, DMA_IT_TCIF5) ) {
+      DMA_ClearITPendingBit(DMA2_Stream5, DMA_IT_TCIF5);
+      Serial_RxProcess( SERIAL_UART1 );
+   }
+}
+
 /******************************************************************************/
 inline void Serial_UART1Callback(void)
 {
-   while (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET) {
-      uint8_t data = (uint8_t)USART_ReceiveData(USART1);
-
-      if ( '\n' == data && a_UARTSettings[SERIAL_UART1].indexRX > 0 ) {
-
-         /* 1. Construct a new msg event indicating that a msg has been received */
-//         MsgEvt *msgEvt = Q_NEW( MsgEvt, MSG_RECEIVED_SIG );
-//
-//         /* 2. Fill the msg payload with payload (the actual received msg)*/
-//         MEMCPY(
-//               msgEvt->msg,
-//               a_UARTSettings[SERIAL_UART1].bufferRX,
-//               a_UARTSettings[SERIAL_UART1].indexRX
-//         );
-//         msgEvt->msg_len = a_UARTSettings[SERIAL_UART1].indexRX;
-//         msgEvt->msg_src = SERIAL_UART1;
-//
-//         /* 3. Publish the newly created event to current AO */
-//         QF_PUBLISH( (QEvent *)msgEvt, AO_SerialMgr );
-
-         /* If a newline is received and the buffer is not empty, post event
-          * with the buffer data */
-         a_UARTSettings[SERIAL_UART1].bufferRX[ a_UARTSettings[SERIAL_UART1].indexRX++ ] = data;
-
-         /* Serial can only receive menu commands */
-         MenuEvt *menuEvt = Q_NEW( MenuEvt, DBG_MENU_REQ_SIG );
-
-         /* 2. Fill the msg payload with payload (the actual received msg)*/
-         MEMCPY(
-               menuEvt->buffer,
-               a_UARTSettings[SERIAL_UART1].bufferRX,
-               a_UARTSettings[SERIAL_UART1].indexRX
-         );
-         menuEvt->bufferLen = a_UARTSettings[SERIAL_UART1].indexRX;
-         menuEvt->msgSrc = SERIAL_CON;
-
-         /* 3. Publish the newly created event to current AO */
-         QF_PUBLISH( (QEvent *)menuEvt, AO_SerialMgr );
-
-         a_UARTSettings[SERIAL_UART1].indexRX = 0;       /* Reset the RX buffer */
-
-      } else if ( '\r' == data ) {
-         /* If a linefeed is received, toss it out. */
-         data = 0;
-      } else {
-         if ( a_UARTSettings[SERIAL_UART1].indexRX >= MENU_MAX_CMD_LEN ) {
-            WRN_printf(
-                  "Attempting to RX a serial msg over %d bytes which will overrun the buffer. Ignoring\n",
-                  MENU_MAX_CMD_LEN
-            );
-            a_UARTSettings[SERIAL_UART1].indexRX = 0;       /* Reset the RX buffer */
-         } else {
-            /* If any other data is recieved, add it to the buffer */
-            a_UARTSettings[SERIAL_UART1].bufferRX[ a_UARTSettings[SERIAL_UART1].indexRX++ ] = data;
-         }
-      }
+   if ( RESET != USART_GetITStatus(USART1, USART_IT_IDLE) ) {
+      /* IDLE flag is cleared by reading SR followed by DR.  The DR read
+       * doesn't steal any data since the DMA already took it. */
+      (void)USART_ReceiveData(USART1);
+
+      Serial_RxProcess( SERIAL_UART1 );
    }
 }
 /**
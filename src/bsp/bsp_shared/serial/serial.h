@@ -18,6 +18,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx.h"
 #include "bsp_defs.h"
+#include "serial_rx.h"                             /* For SerialRxParser_t */
 /* Exported defines ----------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
@@ -61,8 +62,10 @@ typedef struct USART_Settings
     /* Buffer management */
     char                *bufferTX;             /**< Serial port in data buffer. */
     uint16_t            indexTX;   /**< Serial port in data buffer used length. */
-    char                *bufferRX;             /**< Serial port in data buffer. */
-    uint16_t            indexRX;   /**< Serial port in data buffer used length. */
+    char                *bufferRX;      /**< Serial port RX line assembly buffer */
+    const uint16_t      bufferRXLen;   /**< Serial port RX line buffer length. */
+    uint8_t             *bufferRXDMA;  /**< Serial port circular DMA RX buffer. */
+    const uint16_t      bufferRXDMALen; /**< Serial port DMA RX buffer length. */
 } USART_Settings_t;
 
 /**
@@ -74,14 +77,31 @@ typedef struct USART_DMA_Settings
 {
     SerialPort_T        port;              /**< System serial port specifier. */
 
-    IRQn_Type           dma_irq_num;          /**< STM32 serial DMA IRQ number*/
-    ISR_Priority        dma_irq_prio;      /**< STM32 serial DMA IRQ priority */
-    uint32_t            dma_channel;            /**< STM32 serial DMA channel */
-    DMA_Stream_TypeDef* dma_stream;              /**< STM32 serial DMA stream */
+    IRQn_Type           dma_irq_num;       /**< STM32 serial TX DMA IRQ number*/
+    ISR_Priority        dma_irq_prio;   /**< STM32 serial TX DMA IRQ priority */
+    uint32_t            dma_channel;         /**< STM32 serial TX DMA channel */
+    DMA_Stream_TypeDef* dma_stream;           /**< STM32 serial TX DMA stream */
     const uint32_t      dma_clk;       /**< STM32 DMA clock for use with uart */
 
+    IRQn_Type           rx_dma_irq_num;    /**< STM32 serial RX DMA IRQ number*/
+    ISR_Priority        rx_dma_irq_prio; /**< STM32 serial RX DMA IRQ priority */
+    uint32_t            rx_dma_channel;      /**< STM32 serial RX DMA channel */
+    DMA_Stream_TypeDef* rx_dma_stream;        /**< STM32 serial RX DMA stream */
+
 } USART_DMA_Settings_t;
 
+/**
+ * \struct Serial_Stats_t
+ * Running totals of the data sent out of a serial port.  The received data is
+ * counted by the line assembler of the port (see Serial_getRxParser()).
+ */
+typedef struct Serial_Stats
+{
+   uint32_t nTxBytes;             /**< Bytes handed to the UART or its DMA */
+   uint32_t nTxTimeouts;/**< Sends abandoned because the UART stopped responding */
+   uint32_t nRxLongLines;  /**< Lines too long for a menu command and dropped */
+} Serial_Stats_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
 
@@ -134,26 +154,24 @@ void Serial_DMAStartXfer(
 );
 
 /**
- * @brief   Send a base64 encoded message over serial.
+ * @brief   Set up a DMA transfer of a base64 encoded message over serial.
  *
- * Sends a message out through the specified serial port after base64 encoding
- * it, one character at a time. The last character sent is the '\n' character.
- * That is how the receiver knows the message is complete.
+ * Same as Serial_DMAConfig() except that the message is base64 encoded
+ * straight into the TX DMA buffer of the port as it's copied, followed by a
+ * '\n' so the receiver knows the message is complete.  Nothing is staged in
+ * between and nothing waits on the UART.  The transfer is kicked off with
+ * Serial_DMAStartXfer() as usual.
  *
- * @param [in]  serial_port: a USART_Port type that specifies how to look up settings
- * in the serial port settings structure
- * @param [in]  *message: pointer to the buffer with message to send
- * @param [in]  len: length of the message to send
- * @retval  uint32_t: error code from error.h
- *    @arg  ERR_NONE:   No errors
- *    @arg  ERR_SERIAL_HW_TIMEOUT:     Serial hardware stopped responding
- *    @arg  ERR_SERIAL_MSG_TOO_LONG:   Message being sent is longer than MAX_MSG_LEN
- *    @arg  ERR_SERIAL_MSG_BASE64_ENC_FAILED: Failed to base64 encode the message, likely due to length
+ * @param [in] serial_port: Which serial port to send over
+ *    @arg SYSTEM_SERIAL
+ * @param [in] *pData: pointer to the message to encode and send
+ * @param [in] wDataLen: length of the message, no more than MAX_MSG_LEN
+ * @return: None
  */
-uint32_t Serial_send_base64_enc_msg(
+void Serial_DMAConfigBase64(
       SerialPort_T serial_port,
-      char *message,
-      uint16_t len
+      const uint8_t *pData,
+      uint16_t wDataLen
 );
 
 /**
@@ -176,6 +194,30 @@ uint32_t Serial_send_raw_msg(
       uint16_t len
 );
 
+/**
+ * @brief   Get the TX counters of a serial port.
+ *
+ * @param [in]  serial_port: Which serial port to get the counters of
+ *    @arg SYSTEM_SERIAL
+ * @return: const Serial_Stats_t pointer to the counters of the port.
+ */
+const Serial_Stats_t* Serial_getStats(
+      SerialPort_T serial_port
+);
+
+/**
+ * @brief   Get the RX line assembler of a serial port.
+ *
+ * Only meant for reading its nBytes, nLines, and nOverflows counters.
+ *
+ * @param [in]  serial_port: Which serial port to get the line assembler of
+ *    @arg SYSTEM_SERIAL
+ * @return: const SerialRxParser_t pointer to the line assembler of the port.
+ */
+const SerialRxParser_t* Serial_getRxParser(
+      SerialPort_T serial_port
+);
+
 /**
  * @brief   Serial DMA send callback function
  *
@@ -191,13 +233,31 @@ uint32_t Serial_send_raw_msg(
  */
 void Serial_DMASendCallback( void );
 
+/**
+ * @brief   Serial DMA receive callback function
+ *
+ * Handles the half and full transfer interrupts of the circular RX DMA and
+ * processes all data received so far.
+ *
+ * @note: This function should only be called from the ISR that handles the
+ * RX DMA stream of this UART.
+ *
+ * @note: this function is defined as "inline" but not declared as such.  This
+ * is so it can be called externally (by the file that contains the actual ISRs)
+ * and they can still be inlined so as not incur any function call overhead.
+ *
+ * @param   None
+ * @return: None
+ */
+void Serial_DMARecvCallback( void );
+
 /**
  * @brief   Serial RX callback function
  *
- * Receives a message from through the serial port, one character at a
- * time. The last character received is either the '\n' or '\r'
- * character. The message gets stored in a buffer until the end-of-line
- * character is received.
+ * Data is received by a circular DMA so the UART only interrupts when the RX
+ * line goes idle after a burst of data.  All the bytes received since the
+ * last interrupt are then processed in one go and every complete line (ending
+ * in '\n') is published as a separate menu command.
  *
  * @note: This function should only be called from the ISR that handles this UART.
  *
@@ -0,0 +1,139 @@
+/**
+ * @file   serial_rx.c
+ * @brief  Definitions for the serial receive line assembler.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupSerial
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "serial_rx.h"
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+uint16_t SerialRx_feed(
+      SerialRxParser_t *parser,
+      const uint8_t *data,
+      uint16_t len
+)
+{
+   uint16_t nLines = 0;
+
+   parser->nBytes += len;
+
+   for ( uint16_t i = 0; i < len; i++ ) {
+      char c = (char)data[i];
+
+      if ( '\r' == c ) {
+         continue;                         /* Toss out any carriage returns */
+      }
+
+      if ( '\n' == c ) {
+         if ( parser->isDiscarding ) {
+            parser->isDiscarding = false;     /* End of the overflowed line */
+         } else if ( parser->lineLen > 0 ) {
+            parser->line[ parser->lineLen++ ] = c;
+            parser->handler( parser->line, parser->lineLen );
+            parser->nLines++;
+            nLines++;
+         }
+         parser->lineLen = 0;
+         continue;
+      }
+
+      if ( parser->isDiscarding ) {
+         continue;
+      }
+
+      /* Always leave room for the '\n' at the end of the line */
+      if ( parser->lineLen >= parser->lineMax - 1 ) {
+         parser->isDiscarding = true;
+         parser->lineLen      = 0;
+         parser->nOverflows++;
+      } else {
+         parser->line[ parser->lineLen++ ] = c;
+      }
+   }
+
+   return( nLines );
+}
+
+/******************************************************************************/
+void SerialRx_init(
+      SerialRxParser_t *parser,
+      const uint8_t *ring,
+      uint16_t ringSize,
+      char *line,
+      uint16_t lineMax,
+      SerialRxLineHandler handler
+)
+{
+   parser->ring         = ring;
+   parser->ringSize     = ringSize;
+   parser->ringPos      = 0;
+   parser->line         = line;
+   parser->lineMax      = lineMax;
+   parser->lineLen      = 0;
+   parser->isDiscarding = false;
+   parser->handler      = handler;
+   parser->nBytes       = 0;
+   parser->nLines       = 0;
+   parser->nOverflows   = 0;
+}
+
+/******************************************************************************/
+uint16_t SerialRx_process(
+      SerialRxParser_t *parser,
+      uint16_t writePos
+)
+{
+   uint16_t nLines = 0;
+
+   /* A write position at the very end of the ring is the same as the start */
+   if ( writePos >= parser->ringSize ) {
+      writePos = 0;
+   }
+
+   if ( writePos == parser->ringPos ) {
+      return( 0 );                                          /* Nothing new */
+   }
+
+   if ( writePos > parser->ringPos ) {
+      /* New data is contiguous */
+      nLines += SerialRx_feed(
+            parser,
+            &parser->ring[ parser->ringPos ],
+            writePos - parser->ringPos
+      );
+   } else {
+      /* New data wraps around the end of the ring */
+      nLines += SerialRx_feed(
+            parser,
+            &parser->ring[ parser->ringPos ],
+            parser->ringSize - parser->ringPos
+      );
+      nLines += SerialRx_feed( parser, &parser->ring[0], writePos );
+   }
+
+   parser->ringPos = writePos;
+   return( nLines );
+}
+
+/**
+ * @}
+ * end addtogroup groupSerial
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,132 @@
+/**
+ * @file   serial_rx.h
+ * @brief  Declarations for the serial receive line assembler.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupSerial
+ * @{
+ *
+ * The serial ports receive into a circular DMA buffer.  Whenever the UART
+ * goes idle or the DMA reaches the half or the end of that buffer, the new
+ * bytes between the last consumed position and the current DMA write position
+ * are run through this line assembler, which hands complete lines to a
+ * handler in one batch.
+ *
+ * The line assembler can also be fed directly from a linear buffer, which is
+ * how the menu commands arriving on the TCP log port are split into lines.
+ *
+ * This module has no hardware dependencies so it can be compiled on a host
+ * and fed byte streams through a simulated DMA ring.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SERIAL_RX_H_
+#define SERIAL_RX_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported defines ----------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief Callback invoked for every complete line.
+ * @param [in] *line: pointer to the line, including the terminating '\n'.
+ * @param [in] len: length of the line, including the terminating '\n'.
+ */
+typedef void (*SerialRxLineHandler)( const char *line, uint16_t len );
+
+/**
+ * \struct SerialRxParser_t
+ * State of a circular DMA ring consumer and line assembler.
+ */
+typedef struct SerialRxParser
+{
+   const uint8_t       *ring;                   /**< Circular DMA RX buffer */
+   uint16_t             ringSize;            /**< Size of the DMA RX buffer */
+   uint16_t             ringPos;  /**< Next position in the ring to consume */
+
+   char                *line;                   /**< Line assembly buffer */
+   uint16_t             lineMax;  /**< Size of line buffer incl. the '\n' */
+   uint16_t             lineLen;       /**< Current length of the line */
+   bool                 isDiscarding;/**< Line too long, drop until '\n' */
+
+   SerialRxLineHandler  handler;      /**< Called for each complete line */
+
+   uint32_t             nBytes;               /**< Total bytes consumed */
+   uint32_t             nLines;          /**< Total lines handed over */
+   uint32_t             nOverflows;  /**< Lines dropped for being too long */
+} SerialRxParser_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Initialize a line assembler for a circular DMA buffer.
+ *
+ * @param [out] *parser: SerialRxParser_t pointer to the parser to initialize.
+ * @param [in] *ring: pointer to the circular DMA buffer.  May be NULL if the
+ * parser is only ever fed through SerialRx_feed().
+ * @param [in] ringSize: size of the circular DMA buffer.
+ * @param [in] *line: pointer to the buffer where lines are assembled.
+ * @param [in] lineMax: size of the line buffer including the '\n'.
+ * @param [in] handler: SerialRxLineHandler called for each complete line.
+ * @return: None
+ */
+void SerialRx_init(
+      SerialRxParser_t *parser,
+      const uint8_t *ring,
+      uint16_t ringSize,
+      char *line,
+      uint16_t lineMax,
+      SerialRxLineHandler handler
+);
+
+/**
+ * @brief   Consume all new data in the circular DMA buffer.
+ *
+ * Processes all bytes from the last consumed position up to (but not
+ * including) the DMA write position, handling a wrap around the end of the
+ * ring.  '\r' characters are dropped and lines longer than the line buffer
+ * are thrown away in their entirety.
+ *
+ * @note: The caller is responsible for calling this often enough (at least
+ * on every half and full transfer) that the DMA never laps the consumer.
+ *
+ * @param [in,out] *parser: SerialRxParser_t pointer to the parser.
+ * @param [in] writePos: current DMA write position in the ring.
+ * @return: uint16_t number of complete lines handed to the handler.
+ */
+uint16_t SerialRx_process(
+      SerialRxParser_t *parser,
+      uint16_t writePos
+);
+
+/**
+ * @brief   Run a contiguous chunk of data through the line assembler.
+ *
+ * Same line handling as SerialRx_process() but for data that isn't in the
+ * ring, such as the payload of a pbuf.
+ *
+ * @param [in,out] *parser: SerialRxParser_t pointer to the parser.
+ * @param [in] *data: pointer to the chunk.
+ * @param [in] len: length of the chunk.
+ * @return: uint16_t number of complete lines handed to the handler.
+ */
+uint16_t SerialRx_feed(
+      SerialRxParser_t *parser,
+      const uint8_t *data,
+      uint16_t len
+);
+
+/**
+ * @}
+ * end addtogroup groupSerial
+ */
+#endif                                                        /* SERIAL_RX_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
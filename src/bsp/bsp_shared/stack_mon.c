@@ -0,0 +1,172 @@
+/**
+ * @file   stack_mon.c
+ * @brief  Definitions for the task stack high-water monitor.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupStackMon
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stack_mon.h"
+#include <string.h>
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct StackMonTask_t
+ * A task being monitored.
+ */
+typedef struct StackMonTasks
+{
+   TaskHandle_t volatile task;       /**< NULL until attached or once retired */
+   uint16_t     volatile used;               /**< Deepest use seen in bytes */
+} StackMonTask_t;
+
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+static const StackCfg_t *l_stkMonCfg;
+static StackMonTask_t    l_stkMonTasks[STK_MON_MAX_TASKS];
+static uint8_t           l_stkMonNTasks;
+static uint8_t           l_stkMonNext;    /**< Next to sample in this sweep */
+static TickType_t        l_stkMonSweepStart;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Look at the stack of a task and keep the deepest use.
+ * @param [in] idx: uint8_t index of the task.
+ * @param [in] task: TaskHandle_t of the task, NULL for the calling one.
+ * @return: None
+ */
+static void STK_MON_sample( uint8_t idx, TaskHandle_t task );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void STK_MON_sample( uint8_t idx, TaskHandle_t task )
+{
+   /* Returns words that still hold the fill byte, from the far end up */
+   uint32_t unused = uxTaskGetStackHighWaterMark( task ) * sizeof(StackType_t);
+   uint32_t size = l_stkMonCfg[idx].size;
+   uint16_t used = (uint16_t)( unused < size ? size - unused : 0 );
+
+   if ( used > l_stkMonTasks[idx].used ) {
+      l_stkMonTasks[idx].used = used;
+   }
+}
+
+/******************************************************************************/
+void STK_MON_init( const StackCfg_t *cfg, uint8_t nTasks )
+{
+   memset( l_stkMonTasks, 0, sizeof(l_stkMonTasks) );
+   l_stkMonCfg        = cfg;
+   l_stkMonNTasks     = nTasks < STK_MON_MAX_TASKS ? nTasks : STK_MON_MAX_TASKS;
+   l_stkMonNext       = 0;
+   l_stkMonSweepStart = 0;
+}
+
+/******************************************************************************/
+void STK_MON_attach( uint8_t idx, TaskHandle_t task )
+{
+   if ( idx < l_stkMonNTasks ) {
+      l_stkMonTasks[idx].task = task;
+   }
+}
+
+/******************************************************************************/
+void STK_MON_retire( uint8_t idx )
+{
+   if ( idx >= l_stkMonNTasks ) {
+      return;
+   }
+
+   /* What a deleted task leaves behind is freed by the idle task itself, in
+    * its loop and not in the hook, so a sample STK_MON_poll() was in the
+    * middle of when the task got deleted is still safe to finish. */
+   l_stkMonTasks[idx].task = NULL;
+   STK_MON_sample( idx, NULL );
+}
+
+/******************************************************************************/
+void STK_MON_poll( void )
+{
+   if ( l_stkMonNext >= l_stkMonNTasks ) {
+      TickType_t now = xTaskGetTickCount();
+      if ( (TickType_t)( now - l_stkMonSweepStart ) <
+            STK_MON_PERIOD_MS / portTICK_PERIOD_MS ) {
+         return;
+      }
+      l_stkMonSweepStart = now;
+      l_stkMonNext = 0;
+   }
+
+   uint8_t idx = l_stkMonNext++;
+   TaskHandle_t task = l_stkMonTasks[idx].task;
+   if ( NULL != task ) {
+      STK_MON_sample( idx, task );
+   }
+}
+
+/******************************************************************************/
+void STK_MON_sampleAll( void )
+{
+   /* The idle task can't free a deleted task while this runs above it */
+   for ( uint8_t i = 0; i < l_stkMonNTasks; i++ ) {
+      TaskHandle_t task = l_stkMonTasks[i].task;
+      if ( NULL != task ) {
+         STK_MON_sample( i, task );
+      }
+   }
+}
+
+/******************************************************************************/
+uint8_t STK_MON_getNTasks( void )
+{
+   return( l_stkMonNTasks );
+}
+
+/******************************************************************************/
+bool STK_MON_getInfo( uint8_t idx, StackInfo_t *pInfo )
+{
+   if ( idx >= l_stkMonNTasks ) {
+      return( false );
+   }
+
+   pInfo->name     = l_stkMonCfg[idx].name;
+   pInfo->size     = l_stkMonCfg[idx].size;
+   pInfo->used     = l_stkMonTasks[idx].used;
+   pInfo->bRunning = ( NULL != l_stkMonTasks[idx].task );
+
+   pInfo->recommended = 0;
+   if ( 0 != pInfo->used ) {
+      uint32_t rec = pInfo->used +
+            ( (uint32_t)pInfo->used * STK_MON_MARGIN_PCT + 99 ) / 100;
+      rec = ( rec + STK_MON_ROUND_BYTES - 1 ) / STK_MON_ROUND_BYTES *
+            STK_MON_ROUND_BYTES;
+      if ( rec < STK_MON_MIN_BYTES ) {
+         rec = STK_MON_MIN_BYTES;
+      }
+      pInfo->recommended = (uint16_t)( rec > 0xFFFF ? 0xFFFF : rec );
+   }
+   return( true );
+}
+
+/******************************************************************************/
+uint32_t STK_MON_getUsed( uint32_t idx )
+{
+   return( idx < l_stkMonNTasks ? l_stkMonTasks[idx].used : 0 );
+}
+
+/**
+ * @}
+ * end addtogroup groupStackMon
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,169 @@
+/**
+ * @file   stack_mon.h
+ * @brief  Declarations for the task stack high-water monitor.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupStackMon
+ * @{
+ *
+ * Every task is given the stack size listed for it in a StackCfg_t table and
+ * is attached here by its index in that table once it has been created.
+ * FreeRTOS fills each new stack with tskSTACK_FILL_BYTE (configCHECK_FOR_STACK_
+ * OVERFLOW is 2), so how deep a stack has ever been used is found by looking
+ * for the first byte that was overwritten.
+ *
+ * STK_MON_poll() runs from the idle hook and looks at one task per call, going
+ * through all of them every STK_MON_PERIOD_MS.  The deepest use seen so far is
+ * kept for each task and reported through the debug menu and telemetry along
+ * with a recommended size: the deepest use plus STK_MON_MARGIN_PCT, rounded up.
+ * A recommendation is only as good as the paths the task has taken since
+ * boot, so let the board run its full workload before shrinking a stack.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef STACK_MON_H_
+#define STACK_MON_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"                                   /* For FreeRTOS types */
+#include "task.h"                                       /* For TaskHandle_t */
+
+/* Exported defines ----------------------------------------------------------*/
+
+/**< Most tasks the monitor keeps track of */
+#define STK_MON_MAX_TASKS                                                   16
+
+/**< Time it takes to look at every task once */
+#define STK_MON_PERIOD_MS                                                 1000
+
+/**< Headroom added to the deepest use for the recommended size */
+#define STK_MON_MARGIN_PCT                                                  25
+
+/**< Recommended sizes are rounded up to this many bytes */
+#define STK_MON_ROUND_BYTES                                                 64
+
+/**< Smallest size ever recommended */
+#define STK_MON_MIN_BYTES     ( configMINIMAL_STACK_SIZE * sizeof(StackType_t) )
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct StackCfg_t
+ * Name and stack size of one task, an entry of the stack configuration table.
+ */
+typedef struct StackCfgs
+{
+   const char *name;       /**< Name of the task, up to configMAX_TASK_NAME_LEN */
+   uint16_t    size;                         /**< Stack size in bytes */
+} StackCfg_t;
+
+/**
+ * \struct StackInfo_t
+ * What the monitor knows about the stack of one task.
+ */
+typedef struct StackInfos
+{
+   const char *name;                                  /**< Name of the task */
+   uint16_t    size;                          /**< Configured size in bytes */
+   uint16_t    used;         /**< Deepest use seen in bytes, 0 if never run */
+   uint16_t    recommended;     /**< Recommended size in bytes, 0 if unknown */
+   bool        bRunning;     /**< Attached and not retired, being watched */
+} StackInfo_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Start monitoring the tasks of a stack configuration table.
+ *
+ * Call once, before any of the tasks are created.  Nothing is sampled until
+ * a task is attached.
+ *
+ * @param [in] *cfg: const StackCfg_t table of the tasks.  Has to stay around.
+ * @param [in] nTasks: uint8_t number of entries in cfg.  Entries past
+ * STK_MON_MAX_TASKS are not monitored.
+ * @return: None
+ */
+void STK_MON_init( const StackCfg_t *cfg, uint8_t nTasks );
+
+/**
+ * @brief   Attach a task that was just created to its configuration entry.
+ * @param [in] idx: uint8_t index of the task in the configuration table.
+ * @param [in] task: TaskHandle_t of the task.
+ * @return: None
+ */
+void STK_MON_attach( uint8_t idx, TaskHandle_t task );
+
+/**
+ * @brief   Take a last sample of the calling task and stop watching it.
+ *
+ * A task that deletes itself calls this right before vTaskDelete( NULL ) so
+ * its deepest use is kept.
+ *
+ * @param [in] idx: uint8_t index of the calling task in the table.
+ * @return: None
+ */
+void STK_MON_retire( uint8_t idx );
+
+/**
+ * @brief   Sample the next task when it's time to.  Called by the idle hook.
+ *
+ * Never blocks.  Takes as long as it takes to look through the unused part
+ * of one stack.
+ *
+ * @param   None
+ * @return: None
+ */
+void STK_MON_poll( void );
+
+/**
+ * @brief   Sample every attached task right away.
+ * @param   None
+ * @return: None
+ */
+void STK_MON_sampleAll( void );
+
+/**
+ * @brief   Get the number of tasks being monitored.
+ * @param   None
+ * @return: uint8_t number of tasks.
+ */
+uint8_t STK_MON_getNTasks( void );
+
+/**
+ * @brief   Get what's known about the stack of a task.
+ * @param [in] idx: uint8_t index of the task in the table.
+ * @param [out] *pInfo: StackInfo_t pointer to fill in.
+ * @return: bool false if idx is out of range.
+ */
+bool STK_MON_getInfo( uint8_t idx, StackInfo_t *pInfo );
+
+/**
+ * @brief   Get the deepest use of a stack.  A TLM_Sampler for telemetry.
+ * @param [in] idx: uint32_t index of the task in the table.
+ * @return: uint32_t bytes, 0 if the task hasn't run or idx is out of range.
+ */
+uint32_t STK_MON_getUsed( uint32_t idx );
+
+/**
+ * @}
+ * end addtogroup groupStackMon
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                        /* STACK_MON_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -61,6 +61,26 @@
 #endif
 
 
+/* Writes to the write-1-to-clear DMA status register and to the transmit poll
+   demand register go through these macros.  A host build defines ETH_SIM to
+   run the driver against the simulated MAC in eth_sim.c instead, which has to
+   see these writes as they happen. */
+#ifdef ETH_SIM
+  extern ETH_TypeDef ETH_SIM_regs;
+  void ETH_SIM_clearStatus(uint32_t bits);
+  void ETH_SIM_txPollDemand(void);
+  #undef  ETH
+  #undef  ETH_MAC_BASE
+  #define ETH                        (&ETH_SIM_regs)
+  #define ETH_MAC_BASE               ((uint32_t)(uintptr_t)&ETH_SIM_regs)
+  #define ETH_DMASR_CLEAR(bits_)     ETH_SIM_clearStatus((uint32_t)(bits_))
+  #define ETH_TX_POLL_DEMAND()       ETH_SIM_txPollDemand()
+#else
+  #define ETH_DMASR_CLEAR(bits_)     (ETH->DMASR = (uint32_t)(bits_))
+  #define ETH_TX_POLL_DEMAND()       (ETH->DMATPDR = 0)
+#endif
+
+
 /* PHY configuration section **************************************************/
 /* PHY Reset delay */ 
 #define PHY_RESET_DELAY    ((uint32_t)0x000FFFFF)
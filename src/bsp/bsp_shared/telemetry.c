@@ -0,0 +1,391 @@
+/**
+ * @file   telemetry.c
+ * @brief  Definitions for the binary telemetry registry and datagram builder.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupTelemetry
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "telemetry.h"
+#include <string.h>
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct TLM_Channel_t
+ * A single registered counter or gauge.
+ */
+typedef struct TLM_Channel
+{
+   const char            *name;                     /**< Name of the channel */
+   uint8_t                kind;                              /**< TLM_Kind_t */
+   uint8_t                width;          /**< 1, 2, or 4 bytes.  4 for a fn */
+   const volatile void   *pVar;          /**< Variable to read or NULL if fn */
+   TLM_Sampler            sampler;              /**< Sampler if pVar is NULL */
+   uint32_t               arg;                   /**< Passed to the sampler */
+} TLM_Channel_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define TLM_MAGIC0                                                         'T'
+#define TLM_MAGIC1                                                         'L'
+
+/**< Bytes in front of the name in a dictionary entry */
+#define TLM_DICT_ENTRY_HDR_LEN                                               3
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+static TLM_Channel_t l_tlmChannels[TLM_MAX_CHANNELS];
+static uint8_t       l_tlmNChannels;
+static uint16_t      l_tlmDictId;   /**< FNV-1a of the table folded to 16 bits */
+static uint16_t      l_tlmSeq;
+static uint32_t      l_tlmPeriodMs;     /**< 0 when nobody is subscribed */
+static uint32_t      l_tlmElapsedMs;
+static TLM_Stats_t   l_tlmStats;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Add a channel to the table and fold it into the dictionary id.
+ * @param [in] *ch: const TLM_Channel_t pointer to the channel to add.
+ * @return: uint8_t id of the channel or TLM_NO_CHANNEL if the table is full.
+ */
+static uint8_t TLM_add( const TLM_Channel_t *ch );
+
+/**
+ * @brief   Get the length of a channel name as it goes in the dictionary.
+ * @param [in] *name: const char* name of the channel.
+ * @return: uint8_t length of the name cut at TLM_MAX_NAME_LEN.
+ */
+static uint8_t TLM_nameLen( const char *name );
+
+/**
+ * @brief   Read the current value of a channel.
+ * @param [in] *ch: const TLM_Channel_t pointer to the channel.
+ * @return: uint32_t value of the channel.
+ */
+static inline uint32_t TLM_sample( const TLM_Channel_t *ch );
+
+/**
+ * @brief   Write the common datagram header.
+ * @param [out] *buf: pointer to where to write the header.
+ * @param [in] type: uint8_t TLM_DGRAM_SNAPSHOT or TLM_DGRAM_DICT.
+ * @param [in] timeMs: uint32_t ms since boot.
+ * @param [in] first: uint8_t first channel in the datagram.
+ * @param [in] count: uint8_t number of channels in the datagram.
+ * @return: None
+ */
+static void TLM_putHdr(
+      uint8_t *buf,
+      uint8_t type,
+      uint32_t timeMs,
+      uint8_t first,
+      uint8_t count
+);
+
+/**
+ * @brief   Write a little endian uint16_t.
+ * @param [out] *buf: pointer to where to write the value.
+ * @param [in] val: uint16_t value to write.
+ * @return: None
+ */
+static inline void TLM_putU16( uint8_t *buf, uint16_t val );
+
+/**
+ * @brief   Write a little endian uint32_t.
+ * @param [out] *buf: pointer to where to write the value.
+ * @param [in] val: uint32_t value to write.
+ * @return: None
+ */
+static inline void TLM_putU32( uint8_t *buf, uint32_t val );
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint8_t TLM_add( const TLM_Channel_t *ch )
+{
+   if ( l_tlmNChannels >= TLM_MAX_CHANNELS ) {
+      l_tlmStats.nFull++;
+      return( TLM_NO_CHANNEL );
+   }
+
+   /* The dictionary id only has to change whenever the table does, so a
+    * cheap hash of what the collector sees in the dictionary is plenty. */
+   uint32_t hash = 2166136261UL ^ l_tlmDictId;
+   hash = (hash ^ ch->kind) * 16777619UL;
+   hash = (hash ^ ch->width) * 16777619UL;
+   for ( uint8_t i = 0; i < TLM_nameLen( ch->name ); i++ ) {
+      hash = (hash ^ (uint8_t)ch->name[i]) * 16777619UL;
+   }
+   l_tlmDictId = (uint16_t)((hash >> 16) ^ hash);
+
+   l_tlmChannels[l_tlmNChannels] = *ch;
+   return( l_tlmNChannels++ );
+}
+
+/******************************************************************************/
+static uint8_t TLM_nameLen( const char *name )
+{
+   uint8_t len = 0;
+   while ( len < TLM_MAX_NAME_LEN && '\0' != name[len] ) {
+      len++;
+   }
+   return( len );
+}
+
+/******************************************************************************/
+static inline uint32_t TLM_sample( const TLM_Channel_t *ch )
+{
+   if ( NULL == ch->pVar ) {
+      return( ch->sampler( ch->arg ) );
+   }
+
+   /* A single aligned load is atomic on a Cortex-M so there is no need to
+    * lock out whoever updates the variable. */
+   switch ( ch->width ) {
+      case 1:  return( *(const volatile uint8_t *)ch->pVar );
+      case 2:  return( *(const volatile uint16_t *)ch->pVar );
+      default: return( *(const volatile uint32_t *)ch->pVar );
+   }
+}
+
+/******************************************************************************/
+static void TLM_putHdr(
+      uint8_t *buf,
+      uint8_t type,
+      uint32_t timeMs,
+      uint8_t first,
+      uint8_t count
+)
+{
+   buf[0]  = TLM_MAGIC0;
+   buf[1]  = TLM_MAGIC1;
+   buf[2]  = TLM_VERSION;
+   buf[3]  = type;
+   TLM_putU16( &buf[4], l_tlmSeq );
+   TLM_putU16( &buf[6], l_tlmDictId );
+   TLM_putU32( &buf[8], timeMs );
+   buf[12] = first;
+   buf[13] = count;
+   buf[14] = l_tlmNChannels;
+   buf[15] = 0;
+}
+
+/******************************************************************************/
+static inline void TLM_putU16( uint8_t *buf, uint16_t val )
+{
+   buf[0] = (uint8_t)val;
+   buf[1] = (uint8_t)(val >> 8);
+}
+
+/******************************************************************************/
+static inline void TLM_putU32( uint8_t *buf, uint32_t val )
+{
+   buf[0] = (uint8_t)val;
+   buf[1] = (uint8_t)(val >> 8);
+   buf[2] = (uint8_t)(val >> 16);
+   buf[3] = (uint8_t)(val >> 24);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/******************************************************************************/
+void TLM_init( void )
+{
+   memset( l_tlmChannels, 0, sizeof(l_tlmChannels) );
+   memset( &l_tlmStats, 0, sizeof(l_tlmStats) );
+   l_tlmNChannels = 0;
+   l_tlmDictId    = 0;
+   l_tlmSeq       = 0;
+   l_tlmPeriodMs  = 0;
+   l_tlmElapsedMs = 0;
+}
+
+/******************************************************************************/
+uint8_t TLM_addVar(
+      const char *name,
+      TLM_Kind_t kind,
+      const volatile void *pVar,
+      uint8_t width
+)
+{
+   if ( NULL == pVar || !( 1 == width || 2 == width || 4 == width ) ) {
+      return( TLM_NO_CHANNEL );
+   }
+
+   TLM_Channel_t ch = { name, (uint8_t)kind, width, pVar, NULL, 0 };
+   return( TLM_add( &ch ) );
+}
+
+/******************************************************************************/
+uint8_t TLM_addFn(
+      const char *name,
+      TLM_Kind_t kind,
+      TLM_Sampler sampler,
+      uint32_t arg
+)
+{
+   if ( NULL == sampler ) {
+      return( TLM_NO_CHANNEL );
+   }
+
+   TLM_Channel_t ch = { name, (uint8_t)kind, 4, NULL, sampler, arg };
+   return( TLM_add( &ch ) );
+}
+
+/******************************************************************************/
+uint8_t TLM_getNChannels( void )
+{
+   return( l_tlmNChannels );
+}
+
+/******************************************************************************/
+uint16_t TLM_getSnapshotLen( void )
+{
+   return( (uint16_t)(TLM_HDR_LEN + 4 * l_tlmNChannels) );
+}
+
+/******************************************************************************/
+uint16_t TLM_buildSnapshot( uint8_t *buf, uint16_t bufSize, uint32_t timeMs )
+{
+   uint16_t len = TLM_getSnapshotLen();
+   if ( bufSize < len ) {
+      return( 0 );
+   }
+
+   TLM_putHdr( buf, TLM_DGRAM_SNAPSHOT, timeMs, 0, l_tlmNChannels );
+
+   uint8_t *pVal = &buf[TLM_HDR_LEN];
+   for ( uint8_t i = 0; i < l_tlmNChannels; i++ ) {
+      TLM_putU32( pVal, TLM_sample( &l_tlmChannels[i] ) );
+      pVal += 4;
+   }
+
+   l_tlmSeq++;
+   l_tlmStats.nSnapshots++;
+   return( len );
+}
+
+/******************************************************************************/
+uint16_t TLM_buildDict(
+      uint8_t *buf,
+      uint16_t bufSize,
+      uint32_t timeMs,
+      uint8_t first,
+      uint8_t *pNext
+)
+{
+   *pNext = l_tlmNChannels;
+   if ( first >= l_tlmNChannels || bufSize < TLM_HDR_LEN ) {
+      return( 0 );
+   }
+
+   uint16_t len = TLM_HDR_LEN;
+   uint8_t  id  = first;
+   for ( ; id < l_tlmNChannels; id++ ) {
+      const TLM_Channel_t *ch = &l_tlmChannels[id];
+      uint8_t nameLen = TLM_nameLen( ch->name );
+      if ( len + TLM_DICT_ENTRY_HDR_LEN + nameLen > bufSize ) {
+         break;
+      }
+
+      buf[len++] = ch->kind;
+      buf[len++] = ch->width;
+      buf[len++] = nameLen;
+      memcpy( &buf[len], ch->name, nameLen );
+      len += nameLen;
+   }
+
+   if ( id == first ) {
+      return( 0 );                        /* Buffer can't hold a single entry */
+   }
+
+   TLM_putHdr( buf, TLM_DGRAM_DICT, timeMs, first, (uint8_t)(id - first) );
+   *pNext = id;
+   l_tlmStats.nDictDgrams++;
+   return( len );
+}
+
+/******************************************************************************/
+TLM_Cmd_t TLM_handleCmd( const uint8_t *data, uint16_t len )
+{
+   if ( 0 == len ) {
+      return( TLM_CMD_NONE );
+   }
+
+   switch ( data[0] ) {
+      case 'S': {
+         uint32_t periodMs = TLM_DEFAULT_PERIOD_MS;
+         if ( len >= 3 ) {
+            periodMs = (uint32_t)data[1] | ((uint32_t)data[2] << 8);
+         }
+         if ( periodMs < TLM_MIN_PERIOD_MS ) {
+            periodMs = TLM_MIN_PERIOD_MS;
+         }
+
+         /* First snapshot goes out on the next tick */
+         l_tlmPeriodMs  = periodMs;
+         l_tlmElapsedMs = periodMs;
+         return( TLM_CMD_SUBSCRIBE );
+      }
+      case 'D':
+         return( TLM_CMD_DICT );
+      case 'U':
+         l_tlmPeriodMs = 0;
+         return( TLM_CMD_UNSUBSCRIBE );
+      default:
+         return( TLM_CMD_NONE );
+   }
+}
+
+/******************************************************************************/
+bool TLM_tick( uint32_t elapsedMs )
+{
+   if ( 0 == l_tlmPeriodMs ) {
+      return( false );
+   }
+
+   /* Carry the remainder over so the average rate is exact even when the
+    * period isn't a multiple of the tick. */
+   l_tlmElapsedMs += elapsedMs;
+   if ( l_tlmElapsedMs < l_tlmPeriodMs ) {
+      return( false );
+   }
+
+   l_tlmElapsedMs -= l_tlmPeriodMs;
+   if ( l_tlmElapsedMs >= l_tlmPeriodMs ) {
+      l_tlmElapsedMs = 0;                       /* Fell behind, don't burst */
+   }
+   return( true );
+}
+
+/******************************************************************************/
+bool TLM_isSubscribed( void )
+{
+   return( 0 != l_tlmPeriodMs );
+}
+
+/******************************************************************************/
+void TLM_countSendError( void )
+{
+   l_tlmStats.nSendErrors++;
+}
+
+/******************************************************************************/
+const TLM_Stats_t* TLM_getStats( void )
+{
+   return( &l_tlmStats );
+}
+
+/**
+ * @}
+ * end addtogroup groupTelemetry
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,286 @@
+/**
+ * @file   telemetry.h
+ * @brief  Declarations for the binary telemetry registry and datagram builder.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupTelemetry
+ * @{
+ *
+ * Modules register their counters and gauges as channels once at startup.
+ * From then on, a collector that subscribes gets a snapshot of every channel
+ * at a fixed rate as a single small UDP datagram.  The LWIPMgr AO owns the
+ * socket and the timing; this module only keeps the channel table, builds the
+ * datagrams, and tracks the subscription.
+ *
+ * A channel is either a variable, which is read with a single 1, 2, or 4 byte
+ * load, or a sampler function.  There is no critical section around a
+ * snapshot.  Every value is consistent on its own but the values are not
+ * taken at exactly the same instant, which doesn't matter for statistics
+ * sampled once a second.  A sampler must be short and must never block.
+ *
+ * Counters are sent as running totals and are never reset by the device.  The
+ * collector computes the rate from the difference between two snapshots,
+ * modulo the width of the counter given in the dictionary.  A lost datagram
+ * therefore only costs resolution, never data.
+ *
+ * Every datagram starts with the same header (all fields little endian):
+ *
+ *    | 'T' | 'L' | ver (1) | type (1) | seq (2) | dictId (2) | time (4) |
+ *    | first (1) | count (1) | total (1) | rsvd (1) |
+ *
+ *    - type: TLM_DGRAM_SNAPSHOT or TLM_DGRAM_DICT.
+ *    - seq: incremented for every snapshot so the collector can spot losses.
+ *    - dictId: hash of the channel table.  If it changes, the collector has to
+ *      ask for the dictionary again.
+ *    - time: ms since boot when the datagram was built.
+ *    - first, count: channels described by this datagram.
+ *    - total: number of channels registered.
+ *
+ * A snapshot is followed by @a count uint32_t values, one per channel.  A
+ * dictionary is followed by @a count entries of
+ *
+ *    | kind (1) | width (1) | nameLen (1) | name (nameLen) |
+ *
+ * and is split over as many datagrams as it needs.
+ *
+ * The collector controls the stream by sending one of these commands:
+ *
+ *    - 'S' [period (2)]: send snapshots to me every @a period ms (default
+ *      TLM_DEFAULT_PERIOD_MS).  Also sends the dictionary.
+ *    - 'D': send the dictionary again.
+ *    - 'U': stop sending.
+ *
+ * This module has no hardware or RTOS dependencies so it can be compiled on a
+ * host and benchmarked.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported defines ----------------------------------------------------------*/
+#define TLM_UDP_PORT                                                      6602
+#define TLM_MAX_CHANNELS                                                    96
+#define TLM_MAX_NAME_LEN                                                    24
+#define TLM_DEFAULT_PERIOD_MS                                             1000
+#define TLM_MIN_PERIOD_MS                                                  250
+
+#define TLM_HDR_LEN                                                         16
+#define TLM_VERSION                                                          1
+#define TLM_DGRAM_SNAPSHOT                                                   0
+#define TLM_DGRAM_DICT                                                       1
+
+/**< Largest datagram ever built.  Holds a snapshot of every channel. */
+#define TLM_DGRAM_MAX_LEN               (TLM_HDR_LEN + 4 * TLM_MAX_CHANNELS)
+
+/**< Channel id returned when the channel table is full */
+#define TLM_NO_CHANNEL                                                    0xFF
+
+/* Exported macros -----------------------------------------------------------*/
+
+/**
+ * @brief   Register a variable as a channel.  Its width is taken from its type.
+ * @param [in] name: const char* name of the channel.  Must stay valid forever.
+ * @param [in] kind: TLM_Kind_t of the channel.
+ * @param [in] var: the variable.  Must be 1, 2, or 4 bytes wide.
+ * @return: uint8_t id of the channel or TLM_NO_CHANNEL.
+ */
+#define TLM_ADD_VAR( name, kind, var ) \
+   TLM_addVar( (name), (kind), (const volatile void *)&(var), sizeof(var) )
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \enum TLM_Kind_t
+ * How the collector should interpret the value of a channel.
+ */
+typedef enum TLM_Kinds
+{
+   TLM_COUNTER = 0,     /**< Running total.  Only the rate is interesting */
+   TLM_GAUGE,                  /**< Current level, e.g. free blocks in a pool */
+} TLM_Kind_t;
+
+/**
+ * \enum TLM_Cmd_t
+ * What the LWIPMgr AO has to do after a command from the collector.
+ */
+typedef enum TLM_Cmds
+{
+   TLM_CMD_NONE = 0,              /**< Unknown command, ignore the datagram */
+   TLM_CMD_SUBSCRIBE,    /**< Send snapshots to the sender and the dictionary */
+   TLM_CMD_DICT,                    /**< Send the dictionary to the sender */
+   TLM_CMD_UNSUBSCRIBE,                            /**< Stop sending snapshots */
+} TLM_Cmd_t;
+
+/**
+ * @brief Function that reads the value of a channel.
+ * @param [in] arg: uint32_t argument given when the channel was registered.
+ * @return: uint32_t value of the channel.
+ */
+typedef uint32_t (*TLM_Sampler)( uint32_t arg );
+
+/**
+ * \struct TLM_Stats_t
+ * Counters of the telemetry stream itself.
+ */
+typedef struct TLM_Stats
+{
+   uint32_t nSnapshots;                       /**< Snapshots built so far */
+   uint32_t nDictDgrams;             /**< Dictionary datagrams built so far */
+   uint32_t nSendErrors;     /**< Datagrams lost for lack of lwIP memory */
+   uint32_t nFull;         /**< Channels that didn't fit in the table */
+} TLM_Stats_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Forget all channels and any subscription.
+ * @param   None
+ * @return: None
+ */
+void TLM_init( void );
+
+/**
+ * @brief   Register a variable as a channel.
+ *
+ * Normally called through TLM_ADD_VAR().  Channels should only be registered
+ * before QF_run() or from the LWIPMgr AO since the table isn't locked.
+ *
+ * @param [in] *name: const char* name of the channel.  Must stay valid forever.
+ * Names longer than TLM_MAX_NAME_LEN are cut short in the dictionary.
+ * @param [in] kind: TLM_Kind_t of the channel.
+ * @param [in] *pVar: pointer to the variable.  Must be aligned to its width.
+ * @param [in] width: uint8_t width of the variable.  1, 2, or 4.
+ * @return: uint8_t id of the channel or TLM_NO_CHANNEL if the table is full
+ * or the width is not supported.
+ */
+uint8_t TLM_addVar(
+      const char *name,
+      TLM_Kind_t kind,
+      const volatile void *pVar,
+      uint8_t width
+);
+
+/**
+ * @brief   Register a sampler function as a channel.
+ *
+ * @param [in] *name: const char* name of the channel.  Must stay valid forever.
+ * @param [in] kind: TLM_Kind_t of the channel.
+ * @param [in] sampler: TLM_Sampler that reads the value.
+ * @param [in] arg: uint32_t passed to the sampler.
+ * @return: uint8_t id of the channel or TLM_NO_CHANNEL if the table is full.
+ */
+uint8_t TLM_addFn(
+      const char *name,
+      TLM_Kind_t kind,
+      TLM_Sampler sampler,
+      uint32_t arg
+);
+
+/**
+ * @brief   Get the number of registered channels.
+ * @param   None
+ * @return: uint8_t number of channels.
+ */
+uint8_t TLM_getNChannels( void );
+
+/**
+ * @brief   Get the length of a snapshot datagram.
+ * @param   None
+ * @return: uint16_t length of the datagram TLM_buildSnapshot() builds.
+ */
+uint16_t TLM_getSnapshotLen( void );
+
+/**
+ * @brief   Build a snapshot datagram of every channel.
+ *
+ * @param [out] *buf: pointer to where to build the datagram.
+ * @param [in] bufSize: uint16_t size of @a buf.
+ * @param [in] timeMs: uint32_t ms since boot.
+ * @return: uint16_t length of the datagram or 0 if it doesn't fit.
+ */
+uint16_t TLM_buildSnapshot( uint8_t *buf, uint16_t bufSize, uint32_t timeMs );
+
+/**
+ * @brief   Build a dictionary datagram.
+ *
+ * Describes as many channels starting at @a first as fit in @a bufSize.
+ *
+ * @param [out] *buf: pointer to where to build the datagram.
+ * @param [in] bufSize: uint16_t size of @a buf.
+ * @param [in] timeMs: uint32_t ms since boot.
+ * @param [in] first: uint8_t first channel to describe.
+ * @param [out] *pNext: uint8_t pointer to where to store the first channel
+ * that didn't fit.  Equal to TLM_getNChannels() when the dictionary is done.
+ * @return: uint16_t length of the datagram or 0 if there is nothing to send.
+ */
+uint16_t TLM_buildDict(
+      uint8_t *buf,
+      uint16_t bufSize,
+      uint32_t timeMs,
+      uint8_t first,
+      uint8_t *pNext
+);
+
+/**
+ * @brief   Handle a command datagram from a collector.
+ *
+ * @param [in] *data: pointer to the datagram.
+ * @param [in] len: uint16_t length of the datagram.
+ * @return: TLM_Cmd_t what the caller has to do with the socket.
+ */
+TLM_Cmd_t TLM_handleCmd( const uint8_t *data, uint16_t len );
+
+/**
+ * @brief   Advance the snapshot timer.
+ *
+ * @param [in] elapsedMs: uint32_t ms since the last call.
+ * @return: bool true if a snapshot is due now.
+ */
+bool TLM_tick( uint32_t elapsedMs );
+
+/**
+ * @brief   Check if a collector is subscribed.
+ * @param   None
+ * @return: bool true if snapshots are being sent.
+ */
+bool TLM_isSubscribed( void );
+
+/**
+ * @brief   Count a datagram that couldn't be sent.
+ * @param   None
+ * @return: None
+ */
+void TLM_countSendError( void );
+
+/**
+ * @brief   Get the counters of the telemetry stream itself.
+ * @param   None
+ * @return: const TLM_Stats_t pointer to the counters.
+ */
+const TLM_Stats_t* TLM_getStats( void );
+
+/**
+ * @}
+ * end addtogroup groupTelemetry
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                        /* TELEMETRY_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
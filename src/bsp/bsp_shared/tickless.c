@@ -0,0 +1,159 @@
+/**
+ * @file   tickless.c
+ * @brief  Definitions for the tickless idle that keeps QF time events on time.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupTickless
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tickless.h"
+#include "qp_port.h"                              /* For the QF time events */
+#ifndef TICKLESS_SIM
+#include "stm32f4xx.h"                             /* For SysTick and __WFI() */
+#endif                                                        /* TICKLESS_SIM */
+
+#if configUSE_TICKLESS_IDLE == 1
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#ifndef TICKLESS_SIM
+
+/**< SysTick counts in one tick */
+#define TICKLESS_COUNTS_PER_TICK     ( configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ )
+
+/**< Most ticks the 24 bit SysTick can count down */
+#define TICKLESS_MAX_TICKS      ( SysTick_LOAD_RELOAD_Msk / TICKLESS_COUNTS_PER_TICK )
+
+/**< SysTick counts missed while it's stopped to be reloaded.  Same estimate of
+ * 45 CPU cycles as port.c */
+#define TICKLESS_STOPPED_COUNTS  ( 45UL / ( configCPU_CLOCK_HZ / configSYSTICK_CLOCK_HZ ) )
+
+#endif                                                        /* TICKLESS_SIM */
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+static TicklessStats_t l_ticklessStats;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+TickType_t TICKLESS_sleepTicks( TickType_t xExpectedIdleTime, TickType_t maxTicks )
+{
+   TickType_t nTicks = xExpectedIdleTime;
+
+   /* The tick that posts the next time event has to be a real one */
+   QTimeEvtCtr qfTicks = QF_ticksToExpiryX( 0U );
+   if ( 0 != qfTicks && qfTicks < nTicks ) {
+      nTicks = qfTicks;
+   }
+
+   if ( nTicks > maxTicks ) {
+      nTicks = maxTicks;
+   }
+   return( nTicks );
+}
+
+/******************************************************************************/
+void TICKLESS_step( TickType_t nTicks )
+{
+   if ( 0 == nTicks ) {
+      return;
+   }
+
+   vTaskStepTick( nTicks );
+   QF_tickStepX( 0U, (QTimeEvtCtr)nTicks );
+   l_ticklessStats.nTicksSkipped += nTicks;
+}
+
+/******************************************************************************/
+const TicklessStats_t* TICKLESS_getStats( void )
+{
+   return( &l_ticklessStats );
+}
+
+#ifndef TICKLESS_SIM
+/******************************************************************************/
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+   /* Unlike taskENTER_CRITICAL() this masks every interrupt, but WFI still
+    * wakes up on one that's pending */
+   __disable_irq();
+
+   TickType_t nTicks = TICKLESS_sleepTicks( xExpectedIdleTime, TICKLESS_MAX_TICKS );
+   if ( nTicks < 2 ) {
+      __enable_irq();
+      return;
+   }
+
+   /* An interrupt may have readied a task since the idle task checked */
+   if ( eAbortSleep == eTaskConfirmSleepModeStatus() ) {
+      l_ticklessStats.nAborts++;
+      __enable_irq();
+      return;
+   }
+
+   /* Run out at the end of the last tick, counting from what is left of the
+    * current one.  Stopping the SysTick also clears its COUNTFLAG. */
+   SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+   uint32_t reload = SysTick->VAL + TICKLESS_COUNTS_PER_TICK * ( nTicks - 1 );
+   if ( reload > TICKLESS_STOPPED_COUNTS ) {
+      reload -= TICKLESS_STOPPED_COUNTS;
+   }
+   SysTick->LOAD = reload;
+   SysTick->VAL  = 0;
+   SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+   l_ticklessStats.nSleeps++;
+   __DSB();
+   __WFI();
+   __ISB();
+
+   uint32_t ctrl = SysTick->CTRL;
+   SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+   uint32_t nSlept;
+   uint32_t load;
+   if ( 0 != ( ctrl & SysTick_CTRL_COUNTFLAG_Msk ) ) {
+      /* Ran out.  Its interrupt is pending and counts the last tick once
+       * interrupts are enabled.  Finish the tick it reloaded for. */
+      nSlept = nTicks - 1;
+      load = ( TICKLESS_COUNTS_PER_TICK - 1 ) - ( reload - SysTick->VAL );
+      if ( load < TICKLESS_STOPPED_COUNTS || load > TICKLESS_COUNTS_PER_TICK ) {
+         load = TICKLESS_COUNTS_PER_TICK - 1;
+      }
+   } else {
+      /* Some other interrupt.  Count the whole ticks and finish the one it
+       * came in. */
+      l_ticklessStats.nEarlyWakes++;
+      uint32_t counted = nTicks * TICKLESS_COUNTS_PER_TICK - SysTick->VAL;
+      nSlept = counted / TICKLESS_COUNTS_PER_TICK;
+      load = ( nSlept + 1 ) * TICKLESS_COUNTS_PER_TICK - counted;
+   }
+
+   /* The new LOAD takes effect at the next reload, after the current tick */
+   SysTick->LOAD = load;
+   SysTick->VAL  = 0;
+   SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+   SysTick->LOAD = TICKLESS_COUNTS_PER_TICK - 1;
+
+   TICKLESS_step( nSlept );
+   __enable_irq();
+}
+#endif                                                        /* TICKLESS_SIM */
+
+#endif                                         /* configUSE_TICKLESS_IDLE == 1 */
+
+/**
+ * @}
+ * end addtogroup groupTickless
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
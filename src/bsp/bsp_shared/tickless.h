@@ -0,0 +1,119 @@
+/**
+ * @file   tickless.h
+ * @brief  Declarations for the tickless idle that keeps QF time events on time.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupTickless
+ * @{
+ *
+ * With configUSE_TICKLESS_IDLE set, the idle task calls
+ * vPortSuppressTicksAndSleep() whenever no task has to wake up for at least
+ * two ticks.  FreeRTOS only knows about its own delays though, while every
+ * QTimeEvt counts down in QF_TICK_X() from the tick hook.  This module
+ * replaces the weak vPortSuppressTicksAndSleep() of the port with one that:
+ *
+ * - sleeps no longer than the FreeRTOS delay, the next QF time event
+ *   (QF_ticksToExpiryX()) and what the 24 bit SysTick can count,
+ * - reprograms the SysTick to run out at the end of that tick, waits for an
+ *   interrupt, and works out how many whole ticks went by,
+ * - steps both the FreeRTOS tick count (vTaskStepTick()) and every QF time
+ *   event counter (QF_tickStepX()) by that many ticks before interrupts are
+ *   enabled again.
+ *
+ * The tick that ends the sleep is then handled by the SysTick interrupt as
+ * usual, so a time event is posted on the same tick it would have been
+ * without the sleep.  All of it runs with interrupts disabled (WFI still
+ * wakes up on one that is pending), so no ISR can arm a time event between
+ * the look at the counters and the step.
+ *
+ * Tickless idle is only on in release builds.  Debug builds never sleep, the
+ * same as in the idle hook, so the debugger stays attached, and the QS
+ * timestamps of spy builds rely on the SysTick reload never changing.  The
+ * SysTick runs from HCLK/8 in release builds so a sleep can last up to about
+ * 745 ms.
+ *
+ * TICKLESS_sleepTicks() and TICKLESS_step() don't touch the hardware.  A host
+ * test defines TICKLESS_SIM, leaves out the SysTick half, and calls them from
+ * a simulated tick source around its own QF_TICK_X() calls.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TICKLESS_H_
+#define TICKLESS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "FreeRTOS.h"                                   /* For FreeRTOS types */
+#include "task.h"                                       /* For TickType_t */
+
+/* Exported defines ----------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct TicklessStats_t
+ * What the tickless idle has done since boot.
+ */
+typedef struct TicklessStatsTag
+{
+   uint32_t nSleeps;                     /**< Times the tick was stopped */
+   uint32_t nTicksSkipped;        /**< Ticks that went by without their IRQ */
+   uint32_t nEarlyWakes;        /**< Sleeps ended by some other interrupt */
+   uint32_t nAborts;       /**< Sleeps given up since a task became ready */
+} TicklessStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Work out how many ticks the idle task can sleep for.
+ *
+ * Call with interrupts disabled.
+ *
+ * @param [in] xExpectedIdleTime: TickType_t ticks until a task has to run,
+ * from FreeRTOS.
+ * @param [in] maxTicks: TickType_t most ticks the tick timer can sleep for.
+ * @return: TickType_t ticks to sleep for, including the one that ends the
+ * sleep.  Less than 2 isn't worth stopping the tick for.
+ */
+TickType_t TICKLESS_sleepTicks( TickType_t xExpectedIdleTime, TickType_t maxTicks );
+
+/**
+ * @brief   Account for whole ticks that went by while the tick was stopped.
+ *
+ * Call with interrupts disabled, in the same critical section as
+ * TICKLESS_sleepTicks(), before the interrupt of the tick that ends the
+ * sleep is let through.
+ *
+ * @param [in] nTicks: TickType_t ticks to step by.  Must be less than what
+ * TICKLESS_sleepTicks() returned.
+ * @return: None
+ */
+void TICKLESS_step( TickType_t nTicks );
+
+/**
+ * @brief   Get the stats.
+ * @param   None
+ * @return: const TicklessStats_t pointer to the stats.
+ */
+const TicklessStats_t* TICKLESS_getStats( void );
+
+/**
+ * @}
+ * end addtogroup groupTickless
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                         /* TICKLESS_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
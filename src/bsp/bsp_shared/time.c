@@ -48,7 +48,7 @@ __IO uint32_t   uwPeriodValue = 0;   /**< Calculated period value of LSI output,
  *
  * @note 1: This function sets up TIM5 but after returning, TIM5 can be used for
  * other purposes.
- * @note 2: This function should only be called by the TIME_Init() function.
+ * @note 2: This function should only be called by TIME_calibrateLSI().
  *
  * @param  None
  * @retval LSI Frequency
@@ -111,18 +111,6 @@ void TIME_Init( void )
    /* Enable Wakeup Counter */
    RTC_WakeUpCmd( ENABLE );
 
-   /* Get the LSI frequency:  TIM5 is used to measure the LSI frequency */
-   uwLsiFreq = TIME_getLSIFrequency();
-
-   /* Calendar Configuration */
-   RTC_InitStructure.RTC_AsynchPrediv = 0x7F;
-   RTC_InitStructure.RTC_SynchPrediv =  (uwLsiFreq/128) - 1;
-   RTC_InitStructure.RTC_HourFormat = RTC_HourFormat_24;
-   /* Check on RTC init */
-   if ( ERROR == RTC_Init( &RTC_InitStructure ) ) {
-      err_slow_printf("!!RTC Prescaler Config failed!!\n");
-   }
-
    /* Initialize the clock to zero */
    RTC_TimeTypeDef RTC_TimeStructure;
    RTC_TimeStructure.RTC_H12     = RTC_H12_AM;
@@ -139,6 +127,25 @@ void TIME_Init( void )
 //   TIME_subSecondTimer_Init();
 }
 
+/******************************************************************************/
+uint32_t TIME_calibrateLSI( void )
+{
+   /* Get the LSI frequency:  TIM5 is used to measure the LSI frequency */
+   uwLsiFreq = TIME_getLSIFrequency();
+
+   /* Calendar Configuration.  Only the prescalers change so the RTC keeps the
+    * time it has counted so far. */
+   RTC_InitStructure.RTC_AsynchPrediv = 0x7F;
+   RTC_InitStructure.RTC_SynchPrediv =  (uwLsiFreq/128) - 1;
+   RTC_InitStructure.RTC_HourFormat = RTC_HourFormat_24;
+   /* Check on RTC init */
+   if ( ERROR == RTC_Init( &RTC_InitStructure ) ) {
+      ERR_printf("!!RTC Prescaler Config failed!!\n");
+   }
+
+   return( uwLsiFreq );
+}
+
 /******************************************************************************/
 static uint32_t TIME_getLSIFrequency( void )
 {
@@ -48,17 +48,32 @@ typedef struct
  * @brief  Initializes the RTC and a subsecond timer.
  *
  * This function:
- *   -# initializes the RTC.
- *   -# calibrates the RTC using TIM5 to account for clock drift.
+ *   -# initializes the RTC assuming the LSI runs at its nominal 32KHz.
  *   -# initializes a subsecond timer using TIM7.
  *
  * @note 1: This function should be called only once and only in the beginning.
+ * @note 2: Call TIME_calibrateLSI() afterwards to account for clock drift.
  *
  * @param  None
  * @return None
  */
 void TIME_Init( void );
 
+/**
+ * @brief  Calibrates the RTC prescaler against the measured LSI frequency.
+ *
+ * Uses TIM5 to measure the LSI oscillator, which is quite drifty, and trims
+ * the RTC so it keeps time.  The time of day is kept.  This is kept out of
+ * TIME_Init() so it doesn't hold up the boot and is meant to be called from
+ * a FreeRTOS thread once the scheduler is running.
+ *
+ * @note: TIM5 is free to use for something else once this returns.
+ *
+ * @param  None
+ * @return uint32_t measured LSI frequency in Hz.
+ */
+uint32_t TIME_calibrateLSI( void );
+
 /**
  * @brief   Return a structure containing the current time.
  * @param  None
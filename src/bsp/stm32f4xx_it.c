@@ -134,44 +134,30 @@ void DebugMon_Handler(void)
 /******************************************************************************/
 
 /******************************************************************************/
-void DMA1_Stream0_IRQHandler( void )
-{
-   QF_CRIT_STAT_TYPE intStat;
-   BaseType_t lHigherPriorityTaskWoken = pdFALSE;
-
-   QF_ISR_ENTRY(intStat);                        /* inform QF about ISR entry */
-
-   I2C1_DMAReadCallback(); /* Issue the callback function which does the actual work. */
-
-   QF_ISR_EXIT(intStat, lHigherPriorityTaskWoken);/* inform QF about ISR exit */
-
-   portEND_SWITCHING_ISR(lHigherPriorityTaskWoken);/* the end of FreeRTOS ISR */
-}
-
-/******************************************************************************/
-void DMA1_Stream6_IRQHandler( void )
+void DMA2_Stream7_IRQHandler( void )
 {
    QF_CRIT_STAT_TYPE intStat;
    BaseType_t lHigherPriorityTaskWoken = pdFALSE;
 
    QF_ISR_ENTRY(intStat);                        /* inform QF about ISR entry */
 
-   I2C1_DMAWriteCallback(); /* Issue the callback function which does the actual work. */
+   Serial_DMASendCallback(); /* Issue the callback function which does the actual work. */
 
    QF_ISR_EXIT(intStat, lHigherPriorityTaskWoken);/* inform QF about ISR exit */
 
+   /* the usual end of FreeRTOS ISR... */
    portEND_SWITCHING_ISR(lHigherPriorityTaskWoken);/* the end of FreeRTOS ISR */
 }
 
 /******************************************************************************/
-void DMA2_Stream7_IRQHandler( void )
+void DMA2_Stream5_IRQHandler( void )
 {
    QF_CRIT_STAT_TYPE intStat;
    BaseType_t lHigherPriorityTaskWoken = pdFALSE;
 
    QF_ISR_ENTRY(intStat);                        /* inform QF about ISR entry */
 
-   Serial_DMASendCallback(); /* Issue the callback function which does the actual work. */
+   Serial_DMARecvCallback(); /* Issue the callback function which does the actual work. */
 
    QF_ISR_EXIT(intStat, lHigherPriorityTaskWoken);/* inform QF about ISR exit */
 
@@ -202,7 +188,7 @@ void I2C1_ER_IRQHandler( void )
 
    QF_ISR_ENTRY(intStat);                        /* inform QF about ISR entry */
 
-   I2C1_ErrorEventCallback();/* Issue the callback function which does the actual work. */
+   I2C_ErrorEventCallback( I2CBus1 ); /* Issue the callback function which does the actual work. */
 
    QF_ISR_EXIT(intStat, lHigherPriorityTaskWoken);/* inform QF about ISR exit */
 
@@ -217,7 +203,7 @@ void I2C1_EV_IRQHandler( void )
 
    QF_ISR_ENTRY(intStat);                        /* inform QF about ISR entry */
 
-   I2C1_EventCallback();     /* Issue the callback function which does the actual work. */
+   I2C_EventCallback( I2CBus1 );      /* Issue the callback function which does the actual work. */
 
    QF_ISR_EXIT(intStat, lHigherPriorityTaskWoken);/* inform QF about ISR exit */
 
@@ -111,20 +111,6 @@ void PendSV_Handler( void ) __attribute__((__interrupt__));
 /******************************************************************************/
 
 
-/**
- * @brief   This ISR function handles DMA1 Stream0 interrupt requests.
- * @param  None
- * @retval None
- */
-void DMA1_Stream0_IRQHandler( void ) __attribute__((__interrupt__));
-
-/**
- * @brief   This ISR function handles DMA1 Stream6 interrupt requests.
- * @param  None
- * @retval None
- */
-void DMA1_Stream6_IRQHandler( void ) __attribute__((__interrupt__));
-
 /**
  * @brief   This ISR function handles DMA2_Stream7 global interrupt requests.
  *
@@ -134,6 +120,16 @@ void DMA1_Stream6_IRQHandler( void ) __attribute__((__interrupt__));
  */
 void DMA2_Stream7_IRQHandler( void ) __attribute__((__interrupt__));
 
+/**
+ * @brief   This ISR function handles DMA2_Stream5 global interrupt requests.
+ *
+ * This ISR function processes data received by the circular RX DMA used by
+ * UART1 every time the DMA gets half way or all the way through its buffer.
+ * @param     None
+ * @retval    None
+ */
+void DMA2_Stream5_IRQHandler( void ) __attribute__((__interrupt__));
+
 /**
  * @brief   This ISR function handles Ethernet global interrupt request.
  *
@@ -201,8 +197,9 @@ void TIM5_IRQHandler( void ) __attribute__((__interrupt__));
 /**
  * @brief   ISR that handles incoming data on UART1 (debug serial) port.
  *
- * This ISR should use the callback function which should be defined wherever
- * serial communications is handled.
+ * The data itself is moved by a circular DMA so this ISR only fires when the
+ * RX line goes idle.  This ISR should use the callback function which should
+ * be defined wherever serial communications is handled.
  *
  * @param   None
  * @retval  None
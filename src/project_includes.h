@@ -143,6 +143,11 @@
        * @ingroup groupSharedBSP
        */
 
+      /**
+       * @defgroup groupTelemetry Binary UDP telemetry of counters and gauges.
+       * @ingroup groupSharedBSP
+       */
+
       /**
        * @defgroup groupSTM32runtime STM32 init, runtime, and optimizations.
        * @ingroup groupSharedBSP
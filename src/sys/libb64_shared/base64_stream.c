@@ -0,0 +1,219 @@
+/**
+ * @file    base64_stream.c
+ * @brief   Streaming, table driven base64 encoder and decoder.
+ *
+ * @date    10/18/2026
+ * @author  Harry Rostovtsev
+ * @email   rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ */
+
+#include "base64_stream.h"
+
+/* Special values in the decode table.  All negative so a single sign check on
+ * a whole block is enough to fall back to the slow path. */
+#define B64S_INV   -1                                /* Not a base64 character */
+#define B64S_PAD   -2                                         /* '=' padding */
+#define B64S_SKP   -3                        /* Whitespace/framing, ignored */
+
+static const char b64s_encLUT[64] =
+{
+    'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O','P',
+    'Q','R','S','T','U','V','W','X','Y','Z','a','b','c','d','e','f',
+    'g','h','i','j','k','l','m','n','o','p','q','r','s','t','u','v',
+    'w','x','y','z','0','1','2','3','4','5','6','7','8','9','+','/'
+};
+
+#define I B64S_INV
+static const int8_t b64s_decLUT[256] =
+{
+    I, I, I, I, I, I, I, I, I, B64S_SKP, B64S_SKP, I, I, B64S_SKP, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    B64S_SKP, I, I, I, I, I, I, I, I, I, I,62, I, I, I,63,
+   52,53,54,55,56,57,58,59,60,61, I, I, I, B64S_PAD, I, I,
+    I, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,
+   15,16,17,18,19,20,21,22,23,24,25, I, I, I, I, I,
+    I,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,
+   41,42,43,44,45,46,47,48,49,50,51, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I
+};
+#undef I
+
+/* 3 bytes -> 4 characters */
+static inline void b64s_encodeBlock(const uint8_t *in, char *out)
+{
+    uint32_t block = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+    out[0] = b64s_encLUT[(block >> 18) & 0x3F];
+    out[1] = b64s_encLUT[(block >> 12) & 0x3F];
+    out[2] = b64s_encLUT[(block >>  6) & 0x3F];
+    out[3] = b64s_encLUT[ block        & 0x3F];
+}
+
+/* 24 accumulated bits -> 3 bytes */
+static inline void b64s_decodeBlock(uint32_t block, uint8_t *out)
+{
+    out[0] = (uint8_t)(block >> 16);
+    out[1] = (uint8_t)(block >> 8);
+    out[2] = (uint8_t)(block);
+}
+
+void B64S_encodeInit(B64S_EncState *state)
+{
+    state->nCarry = 0;
+}
+
+int B64S_encodeChunk(B64S_EncState *state, const uint8_t *in, int in_len,
+                     char *out, int out_max_len, int *consumed)
+{
+    int nIn  = 0;
+    int nOut = 0;
+
+    /* Finish off a block started by a previous call first */
+    if (state->nCarry > 0) {
+        if (state->nCarry + in_len < 3) {
+            while (nIn < in_len) {
+                state->carry[state->nCarry++] = in[nIn++];
+            }
+            *consumed = nIn;
+            return 0;
+        }
+        if (out_max_len < 4) {
+            *consumed = 0;
+            return 0;
+        }
+
+        uint8_t block[3];
+        uint8_t i;
+        for (i = 0; i < state->nCarry; ++i) {
+            block[i] = state->carry[i];
+        }
+        for (; i < 3; ++i) {
+            block[i] = in[nIn++];
+        }
+        b64s_encodeBlock(block, out);
+        nOut = 4;
+        state->nCarry = 0;
+    }
+
+    /* Whole blocks for as long as both input and output allow */
+    while ((in_len - nIn >= 3) && (out_max_len - nOut >= 4)) {
+        b64s_encodeBlock(&in[nIn], &out[nOut]);
+        nIn  += 3;
+        nOut += 4;
+    }
+
+    /* Hold on to a short tail only if the output wasn't what stopped us */
+    if (in_len - nIn < 3) {
+        while (nIn < in_len) {
+            state->carry[state->nCarry++] = in[nIn++];
+        }
+    }
+
+    *consumed = nIn;
+    return nOut;
+}
+
+int B64S_encodeFinal(B64S_EncState *state, char *out)
+{
+    if (0 == state->nCarry) {
+        return 0;
+    }
+
+    uint8_t block[3] = { state->carry[0], 0, 0 };
+    if (2 == state->nCarry) {
+        block[1] = state->carry[1];
+    }
+    b64s_encodeBlock(block, out);
+
+    out[3] = '=';
+    if (1 == state->nCarry) {
+        out[2] = '=';
+    }
+    state->nCarry = 0;
+    return 4;
+}
+
+void B64S_decodeInit(B64S_DecState *state)
+{
+    state->accum    = 0;
+    state->nChars   = 0;
+    state->isPadded = false;
+}
+
+int B64S_decodeChunk(B64S_DecState *state, const char *in, int in_len,
+                     uint8_t *out, int out_max_len)
+{
+    const uint8_t *pIn = (const uint8_t *)in;
+    int nIn  = 0;
+    int nOut = 0;
+
+    while (nIn < in_len) {
+
+        /* Fast path: a whole block of 4 plain base64 characters */
+        if ((0 == state->nChars) && (in_len - nIn >= 4) && !state->isPadded) {
+            int8_t a = b64s_decLUT[pIn[nIn]];
+            int8_t b = b64s_decLUT[pIn[nIn + 1]];
+            int8_t c = b64s_decLUT[pIn[nIn + 2]];
+            int8_t d = b64s_decLUT[pIn[nIn + 3]];
+            if ((a | b | c | d) >= 0) {
+                if (out_max_len - nOut < 3) {
+                    return -1;
+                }
+                b64s_decodeBlock(
+                    ((uint32_t)a << 18) | ((uint32_t)b << 12) |
+                    ((uint32_t)c << 6)  |  (uint32_t)d,
+                    &out[nOut]
+                );
+                nIn  += 4;
+                nOut += 3;
+                continue;
+            }
+        }
+
+        /* Slow path: one character at a time */
+        int8_t v = b64s_decLUT[pIn[nIn++]];
+        if (B64S_SKP == v) {
+            continue;
+        } else if (B64S_PAD == v) {
+            /* Padding completes a 2 or 3 character block */
+            int nBytes = (3 == state->nChars) ? 2 : (2 == state->nChars) ? 1 : 0;
+            if (out_max_len - nOut < nBytes) {
+                return -1;
+            }
+            uint32_t block = state->accum << (6 * (4 - state->nChars));
+            if (nBytes > 0) {
+                out[nOut++] = (uint8_t)(block >> 16);
+            }
+            if (nBytes > 1) {
+                out[nOut++] = (uint8_t)(block >> 8);
+            }
+            state->accum    = 0;
+            state->nChars   = 0;
+            state->isPadded = true;
+            continue;
+        } else if ((B64S_INV == v) || state->isPadded) {
+            return -1;               /* Garbage or data following the padding */
+        }
+
+        state->accum = (state->accum << 6) | (uint32_t)v;
+        if (4 == ++state->nChars) {
+            if (out_max_len - nOut < 3) {
+                return -1;
+            }
+            b64s_decodeBlock(state->accum, &out[nOut]);
+            nOut += 3;
+            state->accum  = 0;
+            state->nChars = 0;
+        }
+    }
+
+    return nOut;
+}
+/******** Copyright (C) 2013 Harry Rostovtsev. All rights reserved *****END OF FILE****/
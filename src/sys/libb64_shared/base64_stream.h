@@ -0,0 +1,120 @@
+/**
+ * @file    base64_stream.h
+ * @brief   Streaming, table driven base64 encoder and decoder.
+ *
+ * Unlike the libb64 encoder which walks a per-character state machine, this
+ * codec works on whole 3 byte/4 character blocks using lookup tables and only
+ * carries the (at most 2 byte or 3 character) remainder between calls.  This
+ * allows arbitrarily long messages to be encoded or decoded in small chunks,
+ * straight into whatever transmit buffer is available, without first having
+ * to stage the whole message in a MAX_MSG_LEN buffer.
+ *
+ * Encoded output never contains newlines.  Decoding skips '\r', '\n', and
+ * any padding so framed data can be fed in exactly as it was received.
+ *
+ * @date    10/18/2026
+ * @author  Harry Rostovtsev
+ * @email   rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ */
+#ifndef BASE64_STREAM_H_
+#define BASE64_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of characters it takes to base64 encode n bytes (with padding)
+ */
+#define B64S_ENCODED_LEN( n )       ((((n) + 2) / 3) * 4)
+
+/**
+ * @brief Max number of bytes that n base64 characters can decode to.
+ */
+#define B64S_DECODED_MAX( n )       ((((n) + 3) / 4) * 3)
+
+/**
+ * \struct B64S_EncState
+ * Encoder state carried between calls to B64S_encodeChunk().
+ */
+typedef struct
+{
+    uint8_t carry[2];          /**< Input bytes that didn't make a full block */
+    uint8_t nCarry;                         /**< Number of bytes in carry[] */
+} B64S_EncState;
+
+/**
+ * \struct B64S_DecState
+ * Decoder state carried between calls to B64S_decodeChunk().
+ */
+typedef struct
+{
+    uint32_t accum;          /**< Accumulated 6 bit values of a partial block */
+    uint8_t  nChars;               /**< Number of characters in accum so far */
+    bool     isPadded;      /**< Padding seen, no more data should follow */
+} B64S_DecState;
+
+/**
+ * Initialize the encoder state.  Must be called before each new message.
+ *
+ * @param[out]    state: Pointer to encoder state.
+ */
+void B64S_encodeInit(B64S_EncState *state);
+
+/**
+ * Encodes as much of the input as fits into the output buffer.  Only whole
+ * 4 character blocks are ever written.  Up to 2 trailing input bytes that
+ * don't make a full block are kept in the state until more data arrives or
+ * B64S_encodeFinal() is called.
+ *
+ * @param[in|out] state: Pointer to encoder state.
+ * @param[in]     in: Pointer to data to encode.
+ * @param[in]     in_len: Length of the data to encode (in bytes).
+ * @param[out]    out: Pointer to buffer to put encoded data.
+ * @param[in]     out_max_len: Size of the output buffer.
+ * @param[out]    consumed: Number of input bytes consumed (including the ones
+ *                now held in the state).  The caller should call again with
+ *                the rest of the input once the output has been sent.
+ *
+ * @return Number of characters written to out.
+ */
+int B64S_encodeChunk(B64S_EncState *state, const uint8_t *in, int in_len,
+                     char *out, int out_max_len, int *consumed);
+
+/**
+ * Flushes any bytes held in the encoder state as a final padded block.
+ *
+ * @param[in|out] state: Pointer to encoder state.
+ * @param[out]    out: Pointer to buffer with room for at least 4 characters.
+ *
+ * @return Number of characters written to out (0 or 4).
+ */
+int B64S_encodeFinal(B64S_EncState *state, char *out);
+
+/**
+ * Initialize the decoder state.  Must be called before each new message.
+ *
+ * @param[out]    state: Pointer to decoder state.
+ */
+void B64S_decodeInit(B64S_DecState *state);
+
+/**
+ * Decodes a chunk of base64 data.  Any partial block at the end of the chunk
+ * is kept in the state and completed by the next call.
+ *
+ * @param[in|out] state: Pointer to decoder state.
+ * @param[in]     in: Pointer to the encoded characters.
+ * @param[in]     in_len: Number of encoded characters.
+ * @param[out]    out: Pointer to buffer to put decoded data.
+ * @param[in]     out_max_len: Size of the output buffer.  Must be at least
+ *                B64S_DECODED_MAX(in_len + 3) to guarantee success.
+ *
+ * @return Number of bytes written to out.
+ *      @arg >= 0: Number of decoded bytes.
+ *      @arg < 0: Invalid character or output buffer too small.
+ */
+int B64S_decodeChunk(B64S_DecState *state, const char *in, int in_len,
+                     uint8_t *out, int out_max_len);
+
+#endif                                                    /* BASE64_STREAM_H_ */
+/******** Copyright (C) 2013 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -18,35 +18,32 @@
 // $Log$
 
 #include "base64_wrapper.h"
+#include "base64_stream.h"
 
 
 int base64_encode(char *in, int in_len, char *out, int out_max_len)
 {
-    base64_encodestate state;
-    int outBuf_len = (in_len / 3) * 4;
+    B64S_EncState state;
+    int consumed;
 
-    if (outBuf_len > out_max_len) {
+    /* Room for the padded output and the terminating newline */
+    if (B64S_ENCODED_LEN(in_len) + 1 > out_max_len) {
         return -1;
     }
 
-    base64_init_encodestate(&state);
-    int r1 = base64_encode_block(in, in_len, out, &state);
-    int r2 = base64_encode_blockend(out+r1, &state);
-    base64_init_encodestate(&state);
-
-    int n_encoded = r1 + r2;
+    B64S_encodeInit(&state);
+    int n_encoded = B64S_encodeChunk(&state, (const uint8_t *)in, in_len,
+                                     out, out_max_len, &consumed);
+    n_encoded += B64S_encodeFinal(&state, out + n_encoded);
+    out[n_encoded++] = '\n';
 
     return n_encoded;
-
 }
 
 int base64_decode(char *in, int in_len, char *out, int out_max_len)
 {
-    base64_decodestate dstate;
-    base64_init_decodestate(&dstate);
-
-    int n_decoded = base64_decode_block(in, in_len, out, &dstate);
-    base64_init_decodestate(&dstate);
+    B64S_DecState dstate;
+    B64S_decodeInit(&dstate);
 
-    return n_decoded;
+    return B64S_decodeChunk(&dstate, in, in_len, (uint8_t *)out, out_max_len);
 }
@@ -21,15 +21,21 @@
 
 #include "cencode.h"
 #include "cdecode.h"
+#include "base64_stream.h"
 
 /**
- * Encodes a char array into base64
+ * Encodes a char array into base64.  The result is terminated with a '\n'.
+ *
+ * @note: For messages that are long or that can be sent out in pieces, use
+ * the streaming B64S_encodeChunk() directly instead of staging the whole
+ * encoded message in a buffer.
  *
  * @param[in]     in: Pointer to char array containing data to encode
  * @param[in]     in_len:  Length of the data to encode (in bytes)
  * @param[in|out] in: Pointer to char array to put encoded data.
  * @param[in]     in_len:  Max length of the encoded data.  This is necessary
- * since encoded data ends up longer than the original.
+ * since encoded data ends up longer than the original.  Must be at least
+ * B64S_ENCODED_LEN(in_len) + 1.
  *
  * @return n_encoded:
  *      @arg > 0: Number of bytes in the resulting encoded string.
@@ -59,7 +65,7 @@
 int base64_encode(char *in, int in_len, char *out, int out_max_len);
 
 /**
- * Encodes a char array into base64
+ * Decodes a base64 char array.  Newlines in the input are ignored.
  *
  * @param[in]     in: Pointer to char array containing encoded data
  * @param[in]     in_len:  Length of the encoded data (in bytes)
@@ -92,10 +92,21 @@
 #define configUSE_TICK_HOOK             1
 #define configCPU_CLOCK_HZ              ( ( unsigned long ) 180000000 )
 #define configTICK_RATE_HZ              ( ( TickType_t ) 1000 )
+/* Tickless idle, see tickless.h in the BSP.  Not in debug builds, which never
+sleep so the debugger stays attached, nor in spy builds, whose QS timestamps
+count on a fixed SysTick reload.  The SysTick runs from HCLK/8 so the 24 bit
+counter can sleep for up to 745 ticks. */
+#if defined(NDEBUG) && !defined(Q_SPY)
+   #define configUSE_TICKLESS_IDLE      1
+   #define configSYSTICK_CLOCK_HZ       ( configCPU_CLOCK_HZ / 8UL )
+#else
+   #define configUSE_TICKLESS_IDLE      0
+#endif
+
 #define configMINIMAL_STACK_SIZE        ( ( unsigned short ) 256 )
 #define configTOTAL_HEAP_SIZE           ( ( size_t ) ( 24576 * 2 ) )
 #define configMAX_TASK_NAME_LEN         ( 16 )
-#define configUSE_TRACE_FACILITY        0
+#define configUSE_TRACE_FACILITY        1   /* For uxTaskGetSystemState() */
 #define configUSE_16_BIT_TICKS          0
 #define configIDLE_SHOULD_YIELD         1
 #define configUSE_MUTEXES               0
@@ -105,7 +116,24 @@
 #define configUSE_MALLOC_FAILED_HOOK    0
 #define configUSE_APPLICATION_TASK_TAG  0
 #define configUSE_COUNTING_SEMAPHORES   0
-#define configGENERATE_RUN_TIME_STATS   0
+#define configGENERATE_RUN_TIME_STATS   1   /* For the CPU load, cpu_load.h */
+
+/* Run time stats count microseconds of TIM2, a free running 32 bit timer
+that CPU_LOAD_initTimer() starts at 1MHz.  The DWT cycle counter can't be used
+because it stops while the core sleeps in WFI, so idle time (and with tickless
+idle, most of it) would go missing.  TIM2 wraps every 2^32 us (about 71 min),
+far longer than the windows of cpu_load.c.  The counter is read straight from
+TIM2->CNT.  A host build defines CPU_LOAD_HOST_CLOCK to count microseconds of
+the monotonic clock instead. */
+#ifdef CPU_LOAD_HOST_CLOCK
+   extern uint32_t CPU_LOAD_hostClock( void );
+   #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+   #define portGET_RUN_TIME_COUNTER_VALUE()  CPU_LOAD_hostClock()
+#else
+   extern void CPU_LOAD_initTimer( void );
+   #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()  CPU_LOAD_initTimer()
+   #define portGET_RUN_TIME_COUNTER_VALUE()  ( *( uint32_t const volatile * ) 0x40000024U )
+#endif
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
@@ -149,6 +177,10 @@ See http://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html. */
 #define INCLUDE_vTaskSuspend             1
 #define INCLUDE_vTaskDelayUntil          0
 #define INCLUDE_vTaskDelay               1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1   /* For the stack monitor */
+#define INCLUDE_xTaskGetIdleTaskHandle   1
+#define INCLUDE_xTaskGetCurrentTaskHandle 1 /* For the event recorder */
+#define INCLUDE_xTaskGetSchedulerState   1
 
 /* Definitions that map the FreeRTOS port interrupt handlers to their CMSIS
 standard names. */
@@ -45,6 +45,7 @@ Q_DEFINE_THIS_MODULE("qf_port")
 
 /* global varibles used by this FreeRTOS port */
 FreeRTOSExtras FreeRTOS_extras;
+QF_RtcStats QF_rtcStats[QF_MAX_ACTIVE + 1];
 
 /*..........................................................................*/
 void QF_init(void) {
@@ -65,9 +66,26 @@ void QF_stop(void) {
 static void task_function(void *pvParameters) { /* FreeRTOS signature */
     QActive *act = (QActive *)pvParameters;
 
+    QF_RtcStats *stats = &QF_rtcStats[act->prio];
+
     while (act->thread != (TaskHandle_t)0) {
         QEvt const *e = QActive_get_(act);
+        uint32_t start;
+        uint32_t cycles;
+#ifdef QF_EVT_REC
+        QF_onEvtDispatch(act, e); /* see NOTE6 in qf_port.h */
+#endif
+        start = QF_RTC_CYCLES();
         QMSM_DISPATCH(&act->super, e);
+        cycles = QF_RTC_CYCLES() - start; /* includes any preemption */
+        ++stats->nSteps;
+        stats->cycles += cycles;
+        if (cycles > stats->maxCycles) {
+            stats->maxCycles = cycles;
+        }
+#ifdef QF_EVT_REC
+        QF_onEvtDone(act, e, cycles);
+#endif
         QF_gc(e); /* check if the event is garbage, and collect it if so */
     }
 
@@ -92,7 +110,13 @@ void QActive_start_(QActive * const me, uint_fast8_t prio,
 
     me->prio = prio;  /* save the QF priority */
     QF_add_(me);      /* make QF aware of this active object */
+#ifdef QF_EVT_REC
+    QF_onEvtDispatch(me, (QEvt const *)0); /* see NOTE6 in qf_port.h */
+#endif
     QMSM_INIT(&me->super, ie); /* execute initial transition */
+#ifdef QF_EVT_REC
+    QF_onEvtDone(me, (QEvt const *)0, (uint32_t)0);
+#endif
 
     /* create the FreeRTOS.org task for the AO */
     err = xTaskCreate(&task_function,   /* the task function */
@@ -105,6 +129,56 @@ void QActive_start_(QActive * const me, uint_fast8_t prio,
     me->osObject = me->thread; /* OS-Object for FreeRTOS is the task handle */
 }
 /*..........................................................................*/
+uint_fast16_t QF_getPoolFree(uint_fast8_t const poolId) {
+    Q_REQUIRE(((uint_fast8_t)1 <= poolId) && (poolId <= QF_maxPool_));
+    return (uint_fast16_t)QF_pool_[poolId - (uint_fast8_t)1].nFree;
+}
+/*..........................................................................*/
+QTimeEvtCtr QF_ticksToExpiryX(uint_fast8_t const tickRate) {
+    QTimeEvtCtr minCtr = (QTimeEvtCtr)0;
+    QTimeEvt *t;
+    uint_fast8_t list;
+
+    Q_REQUIRE(tickRate < (uint_fast8_t)QF_MAX_TICK_RATE);
+
+    /* the main list and the list of time events armed since the last tick */
+    for (list = (uint_fast8_t)0; list < (uint_fast8_t)2; ++list) {
+        t = (list == (uint_fast8_t)0)
+            ? QF_timeEvtHead_[tickRate].next
+            : (QTimeEvt *)QF_timeEvtHead_[tickRate].act;
+        for (; t != (QTimeEvt *)0; t = t->next) {
+            /* a zero counter means disarmed, waiting to be unlinked */
+            if ((t->ctr != (QTimeEvtCtr)0)
+                && ((minCtr == (QTimeEvtCtr)0) || (t->ctr < minCtr)))
+            {
+                minCtr = t->ctr;
+            }
+        }
+    }
+    return minCtr;
+}
+/*..........................................................................*/
+void QF_tickStepX(uint_fast8_t const tickRate, QTimeEvtCtr const nTicks) {
+    QTimeEvt *t;
+    uint_fast8_t list;
+
+    Q_REQUIRE(tickRate < (uint_fast8_t)QF_MAX_TICK_RATE);
+
+    QF_timeEvtHead_[tickRate].ctr += nTicks; /* QS tick counter */
+    for (list = (uint_fast8_t)0; list < (uint_fast8_t)2; ++list) {
+        t = (list == (uint_fast8_t)0)
+            ? QF_timeEvtHead_[tickRate].next
+            : (QTimeEvt *)QF_timeEvtHead_[tickRate].act;
+        for (; t != (QTimeEvt *)0; t = t->next) {
+            if (t->ctr != (QTimeEvtCtr)0) {
+                /* nothing may expire during the step, see NOTE5 */
+                Q_ASSERT(t->ctr > nTicks);
+                t->ctr -= nTicks;
+            }
+        }
+    }
+}
+/*..........................................................................*/
 void QActive_stop(QActive * const me) {
     me->thread = (TaskHandle_t)0; /* stop the thread loop */
 }
@@ -58,6 +58,39 @@
 #include "qmpool.h"    /* this QP port uses the native QF memory pool */
 #include "qf.h"        /* QF platform-independent public interface */
 
+/* run-to-completion (RTC) step statistics of an active object, see NOTE4 */
+typedef struct {
+    uint32_t nSteps;    /* number of events dispatched so far */
+    uint32_t cycles;    /* CPU cycles spent in all the RTC steps (wraps) */
+    uint32_t maxCycles; /* longest single RTC step */
+} QF_RtcStats;
+
+/* RTC step statistics indexed by the QF priority of the active object */
+extern QF_RtcStats QF_rtcStats[QF_MAX_ACTIVE + 1];
+
+/* number of free blocks in an event pool right now, see NOTE4 */
+uint_fast16_t QF_getPoolFree(uint_fast8_t const poolId);
+
+/* clock ticks until the next time event at the rate expires, see NOTE5 */
+QTimeEvtCtr QF_ticksToExpiryX(uint_fast8_t const tickRate);
+
+/* account for clock ticks that went by without QF_TICK_X(), see NOTE5 */
+void QF_tickStepX(uint_fast8_t const tickRate, QTimeEvtCtr const nTicks);
+
+#ifdef QF_EVT_REC
+/* event recorder callbacks (provided in the BSP), see NOTE6 */
+void QF_onEvtPosted(QActive const * const me, QEvt const * const e,
+                    uint_fast8_t const how);
+void QF_onEvtDispatch(QActive const * const me, QEvt const * const e);
+void QF_onEvtDone(QActive const * const me, QEvt const * const e,
+                  uint32_t const cycles);
+#endif /* QF_EVT_REC */
+
+/* free-running CPU cycle counter used to time RTC steps, see NOTE4 */
+#ifndef QF_RTC_CYCLES
+    #define QF_RTC_CYCLES() (*(uint32_t const volatile *)0xE0001004U)
+#endif
+
 /* FreeRTOS "extras" for handling ISRs for FreeRTOS/ARM-Cortex-M */
 typedef struct {
     BaseType_t volatile isrNest;
@@ -130,9 +163,24 @@ extern FreeRTOSExtras FreeRTOS_extras;
     #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
         (QMPool_init(&(p_), (poolSto_), (poolSize_), (evtSize_)))
     #define QF_EPOOL_EVENT_SIZE_(p_)  ((uint_fast16_t)(p_).blockSize)
-    #define QF_EPOOL_GET_(p_, e_, m_) ((e_) = (QEvt *)QMPool_get(&(p_), (m_)))
     #define QF_EPOOL_PUT_(p_, e_)     (QMPool_put(&(p_), (e_)))
 
+#ifdef QF_EVT_REC
+    #include <string.h>  /* for memset() */
+
+    /* record every post, and hand out zeroed pool events, see NOTE6 */
+    #define QACTIVE_EQUEUE_POSTED_(me_, e_, how_) \
+        QF_onEvtPosted((me_), (e_), (how_))
+    #define QF_EPOOL_GET_(p_, e_, m_) do { \
+        (e_) = (QEvt *)QMPool_get(&(p_), (m_)); \
+        if ((e_) != (QEvt *)0) { \
+            memset((e_), 0, (size_t)(p_).blockSize); \
+        } \
+    } while (0)
+#else
+    #define QF_EPOOL_GET_(p_, e_, m_) ((e_) = (QEvt *)QMPool_get(&(p_), (m_)))
+#endif /* QF_EVT_REC */
+
 #endif /* ifdef QP_IMPL */
 
 /*****************************************************************************
@@ -155,6 +203,41 @@ extern FreeRTOSExtras FreeRTOS_extras;
 * port uses a dummy "FreeRTOSConfig.h" from the "config" sub-directory, so that
 * applications can still use their own (and potentially different) FreeRTOS
 * configuration at compile time.
+*
+* NOTE4:
+* Every RTC step of every active object is timed with QF_RTC_CYCLES(), which
+* by default reads the DWT cycle counter (DWT->CYCCNT) of the Cortex-M. The
+* BSP must enable the counter before QF_run(). Each entry of QF_rtcStats[] is
+* written only by the thread of its own active object and each field is a
+* single 32-bit word, so any other thread can read the fields at any time
+* without a critical section. The same goes for QF_getPoolFree(), which reads
+* a single counter (compare QF_getPoolMin()).
+*
+* NOTE5:
+* QF_ticksToExpiryX() and QF_tickStepX() let a tickless idle (see tickless.h
+* in the BSP) stop the tick for as long as no time event needs it.
+* QF_ticksToExpiryX() returns the smallest counter of all the armed time
+* events, which is the number of QF_TICK_X() calls after which the first one
+* gets posted, or 0 if none is armed. After a sleep, QF_tickStepX() takes the
+* ticks that were skipped off every counter at once. It must be fewer than
+* what QF_ticksToExpiryX() returned, so nothing expires during the step and
+* the tick that ends the sleep posts the time event on time. Call both with
+* interrupts disabled, and together in the same critical section, so no time
+* event can be armed in between.
+*
+* NOTE6:
+* Building with QF_EVT_REC defined (make EVT_REC=1) hands every post, every
+* RTC step and every initial transition to an event recorder in the BSP (see
+* evt_rec.h). QF_onEvtPosted() is called inside the critical section of the
+* post, before the recipient is resumed, so posts are recorded in the order
+* they go into the queues. QF_onEvtDispatch() and QF_onEvtDone() bracket
+* every RTC step in the thread of the active object, outside of any critical
+* section, and are called with a NULL event around the initial transition in
+* QActive_start_(). Pool events are also zeroed when they are allocated, so
+* the bytes past what the sender filled in (e.g. the unused part of a
+* message buffer) are the same on every run and the recorder can take a
+* digest of the whole block. The QP library has to be rebuilt when the
+* option changes.
 */
 
 #endif /* qf_port_h */
@@ -58,6 +58,16 @@ static int_t l_running;
 void QF_init(void) {
     /* lock memory so we're never swapped out to disk */
     /*mlockall(MCL_CURRENT | MCL_FUTURE);  uncomment when supported */
+
+#ifdef QF_EVT_REC
+    {   /* the recorder nests critical sections, see NOTE02 in qf_port.h */
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init(&QF_pThreadMutex_, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
+#endif /* QF_EVT_REC */
 }
 /*..........................................................................*/
 int_t QF_run(void) {
@@ -112,13 +122,14 @@ static void *thread_routine(void *arg) { /* the expected POSIX signature */
 void QActive_start_(QActive * const me, uint_fast8_t prio,
                     QEvt const *qSto[], uint_fast16_t qLen,
                     void *stkSto, uint_fast16_t stkSize,
-                    QEvt const *ie)
+                    QEvt const *ie, const char* taskName)
 {
     pthread_t thread;
     pthread_attr_t attr;
     struct sched_param param;
 
     Q_REQUIRE(stkSto == (void *)0); /* p-threads allocate stack internally */
+    (void)taskName; /* p-threads are not named */
 
     QEQueue_init(&me->eQueue, qSto, qLen);
     pthread_cond_init(&me->osObject, 0);
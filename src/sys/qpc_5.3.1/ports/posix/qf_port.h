@@ -68,6 +68,20 @@ void QF_onClockTick(void); /* clock tick callback (provided in the app) */
 
 extern pthread_mutex_t QF_pThreadMutex_; /* mutex for QF critical section */
 
+#ifdef QF_EVT_REC
+/* event recorder callbacks (evt_rec.c in the BSP), see NOTE02 */
+void QF_onEvtPosted(QActive const * const me, QEvt const * const e,
+                    uint_fast8_t const how);
+void QF_onEvtDispatch(QActive const * const me, QEvt const * const e);
+void QF_onEvtDone(QActive const * const me, QEvt const * const e,
+                  uint32_t const cycles);
+
+/* no cycle counter on the host, a program can define its own */
+#ifndef QF_RTC_CYCLES
+    #define QF_RTC_CYCLES() ((uint32_t)0)
+#endif
+#endif /* QF_EVT_REC */
+
 /****************************************************************************/
 /* interface used only inside QF implementation, but not in applications */
 #ifdef QP_IMPL
@@ -87,7 +101,21 @@ extern pthread_mutex_t QF_pThreadMutex_; /* mutex for QF critical section */
     #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
         QMPool_init(&(p_), poolSto_, poolSize_, evtSize_)
     #define QF_EPOOL_EVENT_SIZE_(p_)  ((p_).blockSize)
+#ifdef QF_EVT_REC
+    #include <string.h>  /* for memset() */
+
+    /* record every post, and hand out zeroed pool events, see NOTE02 */
+    #define QACTIVE_EQUEUE_POSTED_(me_, e_, how_) \
+        QF_onEvtPosted((me_), (e_), (how_))
+    #define QF_EPOOL_GET_(p_, e_, m_) do { \
+        (e_) = (QEvt *)QMPool_get(&(p_), (m_)); \
+        if ((e_) != (QEvt *)0) { \
+            memset((e_), 0, (size_t)(p_).blockSize); \
+        } \
+    } while (0)
+#else
     #define QF_EPOOL_GET_(p_, e_, m_) ((e_) = (QEvt *)QMPool_get(&(p_), (m_)))
+#endif /* QF_EVT_REC */
     #define QF_EPOOL_PUT_(p_, e_)     (QMPool_put(&(p_), e_))
 
 #endif /* QP_IMPL */
@@ -120,6 +148,17 @@ extern pthread_mutex_t QF_pThreadMutex_; /* mutex for QF critical section */
 * also subject to priority inversions. However, the p-thread mutex
 * implementation, such as Linux p-threads, should support the priority-
 * inheritance protocol.
+*
+* NOTE02:
+* Building with QF_EVT_REC defined records posts the same way as the FreeRTOS
+* port does (see NOTE6 there), so a host program can record its active
+* objects and replay them with evt_replay.h in the BSP. Pool events are
+* zeroed when allocated so the digests of events made during a replay match
+* the recording. The port doesn't call QF_onEvtDispatch() and QF_onEvtDone()
+* from its threads, whose order isn't repeatable anyway; the program runs
+* the active objects on one thread and brackets every RTC step itself. The
+* recorder enters the critical section from inside the critical section of
+* the post, so QF_init() makes QF_pThreadMutex_ recursive.
 */
 
 #endif /* qf_port_h */
@@ -138,6 +138,7 @@ bool QActive_post_(QActive * const me, QEvt const * const e,
         if (me->eQueue.nMin > nFree) {
             me->eQueue.nMin = nFree;    /* update minimum so far */
         }
+        QACTIVE_EQUEUE_POSTED_(me, e, QF_POSTED_FIFO_); /* LOCAL CHANGE, see qf_pkg.h */
 
         /* empty queue? */
         if (me->eQueue.frontEvt == (QEvt const *)0) {
@@ -171,6 +172,7 @@ bool QActive_post_(QActive * const me, QEvt const * const e,
             QS_EQC_(margin);      /* margin requested */
         QS_END_NOCRIT_()
 
+        QACTIVE_EQUEUE_POSTED_(me, e, QF_POSTED_DROPPED_); /* LOCAL CHANGE, see qf_pkg.h */
         QF_gc(e); /* recycle the event to avoid a leak */
         status = false; /* event not posted */
     }
@@ -100,6 +100,7 @@ void QActive_postLIFO_(QActive * const me, QEvt const * const e) {
     if (me->eQueue.nMin > nFree) {
         me->eQueue.nMin = nFree; /* update minimum so far */
     }
+    QACTIVE_EQUEUE_POSTED_(me, e, QF_POSTED_LIFO_); /* LOCAL CHANGE, see qf_pkg.h */
 
     frontEvt = me->eQueue.frontEvt; /* read volatile into the temporary */
     me->eQueue.frontEvt = e; /* deliver the event directly to the front */
@@ -87,6 +87,32 @@
     #define QF_CRIT_EXIT_()     QF_CRIT_EXIT(critStat_)
 #endif
 
+/****************************************************************************/
+/* LOCAL CHANGE (not in QP/C 5.3.1): the QACTIVE_EQUEUE_POSTED_ port hook.
+* This block and its three call sites in qa_fifo.c and qa_lifo.c, each
+* marked "LOCAL CHANGE", are the only edits to the QP sources. They do
+* nothing unless the port defines the hook (QF_EVT_REC). Carry them over
+* when upgrading QP.
+*/
+/*! how an event went into an event queue, see #QACTIVE_EQUEUE_POSTED_ */
+#define QF_POSTED_FIFO_     ((uint_fast8_t)0) /*!< posted to the back */
+#define QF_POSTED_LIFO_     ((uint_fast8_t)1) /*!< posted to the front */
+#define QF_POSTED_DROPPED_  ((uint_fast8_t)2) /*!< no room, about to be gc'd */
+
+#ifndef QACTIVE_EQUEUE_POSTED_
+    /*! Port hook called for every event posted to an active object. */
+    /**
+    * \description
+    * Called inside the critical section of the post, after the queue
+    * counters are updated but before the event queue is signaled, so what
+    * the port records comes before anything the recipient does with the
+    * event. \a how_ is one of #QF_POSTED_FIFO_, #QF_POSTED_LIFO_ and
+    * #QF_POSTED_DROPPED_. Ports that don't need it leave it undefined.
+    */
+    #define QACTIVE_EQUEUE_POSTED_(me_, e_, how_) ((void)0)
+#endif
+/* END OF LOCAL CHANGE */
+
 /* package-scope objects ****************************************************/
 
 /*! heads of linked lists of time events, one for every clock tick rate */
@@ -0,0 +1,362 @@
+/**
+ * @file    con_fmt.c
+ * @brief   Small, reentrant, integer only string formatter.
+ *
+ * This file contains the definitions for a replacement of newlib's
+ * snprintf()/vsnprintf() for the logging and menu output paths.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupConOut
+ * @{
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "con_fmt.h"
+#include <string.h>
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/**
+ * \struct FmtOut_t
+ * Output buffer being written by a single formatter call.  Lives on the
+ * caller's stack, which is what makes the formatter reentrant.
+ */
+typedef struct FmtOut {
+   char    *buf;                                      /**< Output buffer */
+   size_t   size;                /**< Size of the buffer including NULL */
+   size_t   pos;                /**< Number of characters written so far */
+} FmtOut_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define FMT_FLAG_LEFT       0x01                       /**< '-' flag seen */
+#define FMT_FLAG_ZERO       0x02                       /**< '0' flag seen */
+
+/* Largest uint32_t in octal is 11 digits, decimal is 10, and hex is 8 */
+#define FMT_MAX_DIGITS      11
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables and Local objects ---------------------------------------*/
+static const char fmt_hexLower[16] = "0123456789abcdef";
+static const char fmt_hexUpper[16] = "0123456789ABCDEF";
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Append a block of characters to the output, truncating if needed.
+ * @param [in,out] *out: FmtOut_t pointer to the output.
+ * @param [in] *src: const char pointer to the characters to append.
+ * @param [in] len: size_t number of characters to append.
+ * @return: None
+ */
+static void FMT_put( FmtOut_t *out, const char *src, size_t len );
+
+/**
+ * @brief   Append the same character several times.
+ * @param [in,out] *out: FmtOut_t pointer to the output.
+ * @param [in] c: char to append.
+ * @param [in] n: int number of times to append it.  Nothing if <= 0.
+ * @return: None
+ */
+static void FMT_pad( FmtOut_t *out, char c, int n );
+
+/**
+ * @brief   Format an unsigned 32 bit number with an optional prefix.
+ * @param [in,out] *out: FmtOut_t pointer to the output.
+ * @param [in] val: uint32_t magnitude of the number.
+ * @param [in] base: uint8_t 8, 10, or 16.
+ * @param [in] *digits: const char pointer to the digit table to use.
+ * @param [in] *prefix: const char pointer to the sign or "0x" prefix.
+ * @param [in] flags: uint8_t FMT_FLAG_XXX flags.
+ * @param [in] width: int minimum field width.
+ * @param [in] prec: int minimum number of digits or -1 if not specified.
+ * @return: None
+ */
+static void FMT_number(
+      FmtOut_t *out,
+      uint32_t val,
+      uint8_t base,
+      const char *digits,
+      const char *prefix,
+      uint8_t flags,
+      int width,
+      int prec
+);
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void FMT_put( FmtOut_t *out, const char *src, size_t len )
+{
+   /* Always leave room for the NULL */
+   size_t room = out->size - 1 - out->pos;
+   if ( len > room ) {
+      len = room;
+   }
+   memcpy( &out->buf[out->pos], src, len );
+   out->pos += len;
+}
+
+/******************************************************************************/
+static void FMT_pad( FmtOut_t *out, char c, int n )
+{
+   while ( n-- > 0 && out->pos + 1 < out->size ) {
+      out->buf[out->pos++] = c;
+   }
+}
+
+/******************************************************************************/
+static void FMT_number(
+      FmtOut_t *out,
+      uint32_t val,
+      uint8_t base,
+      const char *digits,
+      const char *prefix,
+      uint8_t flags,
+      int width,
+      int prec
+)
+{
+   char tmp[FMT_MAX_DIGITS];
+   int  nDigits = 0;
+
+   /* Build the digits backwards from the end of the temp buffer.  A precision
+    * of zero means a zero value prints no digits at all. */
+   if ( 16 == base ) {
+      while ( val ) {
+         tmp[FMT_MAX_DIGITS - 1 - nDigits++] = digits[val & 0xF];
+         val >>= 4;
+      }
+   } else if ( 8 == base ) {
+      while ( val ) {
+         tmp[FMT_MAX_DIGITS - 1 - nDigits++] = digits[val & 0x7];
+         val >>= 3;
+      }
+   } else {
+      while ( val ) {
+         tmp[FMT_MAX_DIGITS - 1 - nDigits++] = digits[val % 10];
+         val /= 10;
+      }
+   }
+
+   if ( prec < 0 ) {
+      prec = 1;
+   } else {
+      flags &= ~FMT_FLAG_ZERO;         /* Precision overrides the '0' flag */
+   }
+
+   int nPrefix = (int)strlen( prefix );
+   int nZeros  = (prec > nDigits) ? prec - nDigits : 0;
+   int nPad    = width - nPrefix - nZeros - nDigits;
+   if ( nPad < 0 ) {
+      nPad = 0;
+   }
+
+   if ( flags & FMT_FLAG_LEFT ) {
+      FMT_put( out, prefix, nPrefix );
+      FMT_pad( out, '0', nZeros );
+      FMT_put( out, &tmp[FMT_MAX_DIGITS - nDigits], nDigits );
+      FMT_pad( out, ' ', nPad );
+   } else if ( flags & FMT_FLAG_ZERO ) {
+      FMT_put( out, prefix, nPrefix );
+      FMT_pad( out, '0', nZeros + nPad );
+      FMT_put( out, &tmp[FMT_MAX_DIGITS - nDigits], nDigits );
+   } else {
+      FMT_pad( out, ' ', nPad );
+      FMT_put( out, prefix, nPrefix );
+      FMT_pad( out, '0', nZeros );
+      FMT_put( out, &tmp[FMT_MAX_DIGITS - nDigits], nDigits );
+   }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/******************************************************************************/
+int FMT_vsnprintf( char *buf, size_t size, const char *fmt, va_list args )
+{
+   if ( 0 == size ) {
+      return( 0 );
+   }
+
+   FmtOut_t out = { buf, size, 0 };
+
+   while ( *fmt ) {
+
+      /* Copy everything up to the next conversion in one go */
+      const char *lit = fmt;
+      while ( *fmt && '%' != *fmt ) {
+         fmt++;
+      }
+      FMT_put( &out, lit, fmt - lit );
+      if ( '\0' == *fmt ) {
+         break;
+      }
+
+      const char *spec = fmt++;                        /* Points to the '%' */
+
+      /* Flags */
+      uint8_t flags = 0;
+      for ( ;; fmt++ ) {
+         if ( '-' == *fmt ) {
+            flags |= FMT_FLAG_LEFT;
+         } else if ( '0' == *fmt ) {
+            flags |= FMT_FLAG_ZERO;
+         } else {
+            break;
+         }
+      }
+
+      /* Width */
+      int width = 0;
+      if ( '*' == *fmt ) {
+         width = va_arg( args, int );
+         if ( width < 0 ) {
+            flags |= FMT_FLAG_LEFT;
+            width  = -width;
+         }
+         fmt++;
+      } else {
+         while ( *fmt >= '0' && *fmt <= '9' ) {
+            width = width * 10 + (*fmt++ - '0');
+         }
+      }
+
+      /* Precision */
+      int prec = -1;
+      if ( '.' == *fmt ) {
+         fmt++;
+         prec = 0;
+         if ( '*' == *fmt ) {
+            prec = va_arg( args, int );
+            fmt++;
+         } else {
+            while ( *fmt >= '0' && *fmt <= '9' ) {
+               prec = prec * 10 + (*fmt++ - '0');
+            }
+         }
+      }
+
+      /* Length modifiers.  All integer types we support are 32 bits on this
+       * target and smaller types are promoted to int when passed through the
+       * va args, so these only need to be skipped. */
+      while ( 'h' == *fmt || 'l' == *fmt || 'z' == *fmt ) {
+         fmt++;
+      }
+
+      if ( flags & FMT_FLAG_LEFT ) {
+         flags &= ~FMT_FLAG_ZERO;               /* '-' overrides the '0' flag */
+      }
+
+      switch ( *fmt ) {
+         case 'd':
+         case 'i': {
+            int32_t  sval = va_arg( args, int32_t );
+            uint32_t uval = (sval < 0) ? (uint32_t)0 - (uint32_t)sval : (uint32_t)sval;
+            FMT_number(
+                  &out, uval, 10, fmt_hexLower, (sval < 0) ? "-" : "",
+                  flags, width, prec
+            );
+            break;
+         }
+         case 'u':
+            FMT_number(
+                  &out, va_arg( args, uint32_t ), 10, fmt_hexLower, "",
+                  flags, width, prec
+            );
+            break;
+         case 'x':
+            FMT_number(
+                  &out, va_arg( args, uint32_t ), 16, fmt_hexLower, "",
+                  flags, width, prec
+            );
+            break;
+         case 'X':
+            FMT_number(
+                  &out, va_arg( args, uint32_t ), 16, fmt_hexUpper, "",
+                  flags, width, prec
+            );
+            break;
+         case 'o':
+            FMT_number(
+                  &out, va_arg( args, uint32_t ), 8, fmt_hexLower, "",
+                  flags, width, prec
+            );
+            break;
+         case 'p':
+            FMT_number(
+                  &out, (uint32_t)(uintptr_t)va_arg( args, void * ), 16,
+                  fmt_hexLower, "0x", flags, width, prec
+            );
+            break;
+         case 'c': {
+            char c = (char)va_arg( args, int );
+            if ( !(flags & FMT_FLAG_LEFT) ) {
+               FMT_pad( &out, ' ', width - 1 );
+            }
+            FMT_put( &out, &c, 1 );
+            if ( flags & FMT_FLAG_LEFT ) {
+               FMT_pad( &out, ' ', width - 1 );
+            }
+            break;
+         }
+         case 's': {
+            const char *s = va_arg( args, const char * );
+            if ( NULL == s ) {
+               s = "(null)";
+            }
+            int len = 0;
+            while ( s[len] && (prec < 0 || len < prec) ) {
+               len++;
+            }
+            if ( !(flags & FMT_FLAG_LEFT) ) {
+               FMT_pad( &out, ' ', width - len );
+            }
+            FMT_put( &out, s, len );
+            if ( flags & FMT_FLAG_LEFT ) {
+               FMT_pad( &out, ' ', width - len );
+            }
+            break;
+         }
+         case '%':
+            FMT_put( &out, "%", 1 );
+            break;
+         case '\0':
+            /* Format string ends in the middle of a conversion */
+            FMT_put( &out, spec, fmt - spec );
+            fmt--;
+            break;
+         default:
+            /* Unsupported conversion.  Copy it out as is. */
+            FMT_put( &out, spec, fmt - spec + 1 );
+            break;
+      }
+      fmt++;
+   }
+
+   buf[out.pos] = '\0';
+   return( (int)out.pos );
+}
+
+/******************************************************************************/
+int FMT_snprintf( char *buf, size_t size, const char *fmt, ... )
+{
+   va_list args;
+   va_start( args, fmt );
+   int len = FMT_vsnprintf( buf, size, fmt, args );
+   va_end( args );
+   return( len );
+}
+
+/******************************************************************************/
+void FMT_byteToHex( char *dst, uint8_t byte )
+{
+   dst[0] = fmt_hexLower[byte >> 4];
+   dst[1] = fmt_hexLower[byte & 0xF];
+}
+
+/**
+ * @} end group groupConOut
+ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
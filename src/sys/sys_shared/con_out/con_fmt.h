@@ -0,0 +1,88 @@
+/**
+ * @file    con_fmt.h
+ * @brief   Small, reentrant, integer only string formatter.
+ *
+ * This file contains the declarations for a replacement of newlib's
+ * snprintf()/vsnprintf() for the logging and menu output paths.  The newlib
+ * formatter is large, slow, and needs a lot of stack, which every AO that logs
+ * has to pay for.  This one only handles the conversions that are actually
+ * used by the debug and menu output:
+ *
+ *    - Conversions: %d %i %u %x %X %o %s %c %p %%
+ *    - Flags: '-' (left justify) and '0' (zero pad)
+ *    - Field width and precision, either as digits or '*'
+ *    - Length modifiers 'h', 'hh', 'l', and 'z' are accepted.  Everything is
+ *      formatted as 32 bits.
+ *
+ * There is no floating point support.  Unknown conversions are copied to the
+ * output as is so they are easy to spot.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupConOut
+ * @{
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CON_FMT_H_
+#define CON_FMT_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+
+/* Exported defines ----------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Format a string into a buffer from a va_list.
+ *
+ * Behaves like vsnprintf() for the supported subset, with one deliberate
+ * difference: the return value is the number of characters actually written,
+ * not the number that would have been written if the buffer were big enough.
+ * That makes it always safe to add the return value to a running buffer index.
+ *
+ * @param [out] *buf: char pointer to the output buffer.  Always NULL
+ * terminated unless @a size is 0.
+ * @param [in] size: size_t size of the output buffer, including the NULL.
+ * @param [in] *fmt: const char pointer to the format string.
+ * @param [in] args: va_list of the arguments.
+ * @return: int number of characters written, not including the NULL.
+ */
+int FMT_vsnprintf( char *buf, size_t size, const char *fmt, va_list args );
+
+/**
+ * @brief   Format a string into a buffer.
+ *
+ * See FMT_vsnprintf() for details.
+ *
+ * @param [out] *buf: char pointer to the output buffer.
+ * @param [in] size: size_t size of the output buffer, including the NULL.
+ * @param [in] *fmt: const char pointer to the format string.
+ * @param [in] ... : the variable list of arguments.
+ * @return: int number of characters written, not including the NULL.
+ */
+int FMT_snprintf( char *buf, size_t size, const char *fmt, ... );
+
+/**
+ * @brief   Write a byte as two lower case hex digits.
+ *
+ * @param [out] *dst: char pointer to where to write the two digits.  Not NULL
+ * terminated.
+ * @param [in] byte: uint8_t byte to convert.
+ * @return: None
+ */
+void FMT_byteToHex( char *dst, uint8_t byte );
+
+/**
+ * @} end group groupConOut
+ */
+
+#endif                                                           /* CON_FMT_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
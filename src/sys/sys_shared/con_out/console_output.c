@@ -15,6 +15,7 @@
  */
 /* Includes ------------------------------------------------------------------*/
 #include "console_output.h"
+#include "con_fmt.h"                                /* for FMT_xxx formatting */
 #include "qp_port.h"                                        /* for QP support */
 #include "CBSignals.h"
 #include "CBErrors.h"
@@ -32,8 +33,28 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_SERIAL ); /* For debug system to ID this module
 /* Private macros ------------------------------------------------------------*/
 /* Private variables and Local objects ---------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Post a finished menu output event to the AO that handles its
+ * destination.
+ * @param [in] *lrgDataEvt: LrgDataEvt pointer to the event to post.
+ * @param [in] dst: MsgSrc destination of the event.
+ * @return: None
+ */
+static void MENU_postEvt( LrgDataEvt *lrgDataEvt, MsgSrc dst );
+
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+static void MENU_postEvt( LrgDataEvt *lrgDataEvt, MsgSrc dst )
+{
+   if ( SERIAL_CON == dst ) {
+      QACTIVE_POST(AO_SerialMgr, (QEvt *)lrgDataEvt, AO_DbgMgr); // directly post the event to the correct AO
+   } else {
+      QACTIVE_POST(AO_LWIPMgr, (QEvt *)lrgDataEvt, AO_DbgMgr); // directly post the event to the correct AO
+   }
+}
+
 /******************************************************************************/
 void MENU_printf(
       volatile MsgSrc dst,
@@ -52,7 +73,7 @@ void MENU_printf(
    va_start(args, fmt);
 
    /* 3. Print the actual user supplied data to the buffer and set the length */
-   lrgDataEvt->dataLen += vsnprintf(
+   lrgDataEvt->dataLen += FMT_vsnprintf(
          (char *)&lrgDataEvt->dataBuf[lrgDataEvt->dataLen],
          MAX_MSG_LEN - lrgDataEvt->dataLen, // Account for the part of the buffer that was already written.
          fmt,
@@ -62,16 +83,73 @@ void MENU_printf(
 
    /* 4. Directly post the event to the appropriate AO based on it's intended
     * destination.  */
-   if ( SERIAL_CON == dst ) {
-      QACTIVE_POST(AO_SerialMgr, (QEvt *)lrgDataEvt, AO_DbgMgr); // directly post the event to the correct AO
-   } else {
-      QACTIVE_POST(AO_LWIPMgr, (QEvt *)lrgDataEvt, AO_DbgMgr); // directly post the event to the correct AO
+   MENU_postEvt( lrgDataEvt, dst );
+}
+
+/******************************************************************************/
+void MENU_renderInit( MenuRender_t *render, MsgSrc dst )
+{
+   render->evt   = NULL;
+   render->dst   = dst;
+   render->nEvts = 0;
+}
+
+/******************************************************************************/
+void MENU_renderPrintf( MenuRender_t *render, const char *fmt, ... )
+{
+   va_list args;
+
+   for ( ;; ) {
+      /* Start a new event if there isn't one being filled */
+      if ( NULL == render->evt ) {
+         render->evt = Q_NEW(LrgDataEvt, DBG_MENU_SIG);
+         render->evt->dataLen = 0;
+         render->evt->src = render->dst;
+         render->evt->dst = render->dst;
+      }
+
+      LrgDataEvt *lrgDataEvt = render->evt;
+      uint16_t room = MAX_MSG_LEN - lrgDataEvt->dataLen;
+
+      va_start(args, fmt);
+      int len = FMT_vsnprintf(
+            (char *)&lrgDataEvt->dataBuf[lrgDataEvt->dataLen],
+            room,
+            fmt,
+            args
+      );
+      va_end(args);
+
+      /* Output that exactly fills the rest of the buffer may have been cut
+       * short.  Unless this event was empty to begin with, send what was there
+       * before and try again with a fresh event. */
+      if ( len >= room - 1 && 0 != lrgDataEvt->dataLen ) {
+         MENU_postEvt( lrgDataEvt, render->dst );
+         render->nEvts++;
+         render->evt = NULL;
+         continue;
+      }
+
+      lrgDataEvt->dataLen += len;
+      return;
    }
 }
 
+/******************************************************************************/
+uint16_t MENU_renderFlush( MenuRender_t *render )
+{
+   if ( NULL != render->evt ) {
+      MENU_postEvt( render->evt, render->dst );
+      render->nEvts++;
+      render->evt = NULL;
+   }
+   return( render->nEvts );
+}
+
 /******************************************************************************/
 void CON_output(
       DBG_LEVEL_T dbgLvl,
+      DBG_MODL_T dbgModl,
       volatile MsgSrc src,
       volatile MsgSrc dst,
       const char *pFuncName,
@@ -80,14 +158,24 @@ void CON_output(
       ...
 )
 {
+   /* 0. The macros already checked, but not every caller goes through them.
+    * Nothing to do if no output would take it. */
+   if ( dbgLvl <= ERR && !DBG_SINK_WANTS( dbgLvl, dbgModl ) ) {
+      return;
+   }
+
    /* 1. Get the time first so the printout of the event is as close as possible
     * to when it actually occurred */
    time_T time = TIME_getTime();
 
    /* 2. Construct a new msg event pointer and allocate storage in the QP event
     * pool.  Allocate with margin so we can fall back on regular slow printfs if
-    * there's a problem */
-   LrgDataEvt *lrgDataEvt = Q_NEW(LrgDataEvt, DBG_LOG_SIG);
+    * there's a problem.  The level and module ride along with the text so
+    * subscribers can filter without parsing it. */
+   LogEvt *logEvt = Q_NEW(LogEvt, DBG_LOG_SIG);
+   logEvt->dbgLvl = dbgLvl;
+   logEvt->dbgModl = dbgModl;
+   LrgDataEvt *lrgDataEvt = &logEvt->super;
    lrgDataEvt->dataLen = 0;
    lrgDataEvt->src = src;
    lrgDataEvt->dst = dst;
@@ -96,7 +184,7 @@ void CON_output(
     * prepend (if anything). */
    switch (dbgLvl) {
       case DBG:
-         lrgDataEvt->dataLen += snprintf(
+         lrgDataEvt->dataLen += FMT_snprintf(
                (char *)&lrgDataEvt->dataBuf[lrgDataEvt->dataLen],
                MAX_MSG_LEN,
                "DBG-%02d:%02d:%02d:%03d-%s():%d:",
@@ -109,7 +197,7 @@ void CON_output(
          );
          break;
       case LOG:
-         lrgDataEvt->dataLen += snprintf(
+         lrgDataEvt->dataLen += FMT_snprintf(
                (char *)&lrgDataEvt->dataBuf[lrgDataEvt->dataLen],
                MAX_MSG_LEN,
                "LOG-%02d:%02d:%02d:%03d-%s():%d:",
@@ -122,7 +210,7 @@ void CON_output(
          );
          break;
       case WRN:
-         lrgDataEvt->dataLen += snprintf(
+         lrgDataEvt->dataLen += FMT_snprintf(
                (char *)&lrgDataEvt->dataBuf[lrgDataEvt->dataLen],
                MAX_MSG_LEN,
                "WRN-%02d:%02d:%02d:%03d-%s():%d:",
@@ -135,7 +223,7 @@ void CON_output(
          );
          break;
       case ERR:
-         lrgDataEvt->dataLen += snprintf(
+         lrgDataEvt->dataLen += FMT_snprintf(
                (char *)&lrgDataEvt->dataBuf[lrgDataEvt->dataLen],
                MAX_MSG_LEN,
                "ERR-%02d:%02d:%02d:%03d-%s():%d:",
@@ -157,7 +245,7 @@ void CON_output(
    va_start(args, fmt);
 
    /* 5. Print the actual user supplied data to the buffer and set the length */
-   lrgDataEvt->dataLen += vsnprintf(
+   lrgDataEvt->dataLen += FMT_vsnprintf(
          (char *)&lrgDataEvt->dataBuf[lrgDataEvt->dataLen],
          MAX_MSG_LEN - lrgDataEvt->dataLen, // Account for the part of the buffer that was already written.
          fmt,
@@ -184,13 +272,13 @@ void CON_slow_output(
 
    /* Temporary local buffer and index to compose the msg */
    char tmpBuffer[MAX_MSG_LEN];
-   uint8_t tmpBufferIndex = 0;
+   uint16_t tmpBufferIndex = 0;
 
    /* 2. Based on the debug level specified by the calling macro, decide what to
     * prepend (if anything). */
    switch (dbgLvl) {
       case DBG:
-         tmpBufferIndex += snprintf(
+         tmpBufferIndex += FMT_snprintf(
                tmpBuffer,
                MAX_MSG_LEN,
                "DBG-SLOW!-%02d:%02d:%02d:%03d-%s():%d:",
@@ -203,7 +291,7 @@ void CON_slow_output(
          );
          break;
       case LOG:
-         tmpBufferIndex += snprintf(
+         tmpBufferIndex += FMT_snprintf(
                tmpBuffer,
                MAX_MSG_LEN,
                "LOG-SLOW!-%02d:%02d:%02d:%03d-%s():%d:",
@@ -216,7 +304,7 @@ void CON_slow_output(
          );
          break;
       case WRN:
-         tmpBufferIndex += snprintf(
+         tmpBufferIndex += FMT_snprintf(
                tmpBuffer,
                MAX_MSG_LEN,
                "WRN-SLOW!-%02d:%02d:%02d:%03d-%s():%d:",
@@ -229,7 +317,7 @@ void CON_slow_output(
          );
          break;
       case ERR:
-         tmpBufferIndex += snprintf(
+         tmpBufferIndex += FMT_snprintf(
                tmpBuffer,
                MAX_MSG_LEN,
                "ERR-SLOW!-%02d:%02d:%02d:%03d-%s():%d:",
@@ -242,7 +330,7 @@ void CON_slow_output(
          );
          break;
       case ISR:
-         tmpBufferIndex += snprintf(
+         tmpBufferIndex += FMT_snprintf(
                tmpBuffer,
                MAX_MSG_LEN,
                "D-ISR!-%02d:%02d:%02d:%03d-:%d:",
@@ -263,7 +351,7 @@ void CON_slow_output(
    va_list args;
    va_start(args, fmt);
 
-   tmpBufferIndex += vsnprintf(
+   tmpBufferIndex += FMT_vsnprintf(
          &tmpBuffer[tmpBufferIndex],
          MAX_MSG_LEN - tmpBufferIndex, // Account for the part of the buffer that was already written.
          fmt,
@@ -316,40 +404,34 @@ CBErrorCode CON_hexToStr(
    /* Index used to keep track of how far into the buffer we've printed */
    *strDataLen = 0;
 
+   /* Each number takes up 2 digits, the separator, and optionally the 0x */
+   const uint16_t entryLen = ( true == bPrintX ) ? 5 : 3;
+
    for ( uint16_t i = 0; i < hexDataLen; i++ ) {
 
       /* Let user zero num of columns but if they do, just give them back one
        * long row of data without any linebreaks. */
-      if ( 0 != outputNColumns && i % outputNColumns == 0 && i != 0 ) {
-         *strDataLen += snprintf(
-               &strDataBuffer[*strDataLen],
-               strDataBufferSize - *strDataLen,
-               "\n"
-         );
+      bool bNewLine = ( 0 != outputNColumns && i % outputNColumns == 0 && i != 0 );
+
+      /* Always leave room for the NULL termination */
+      if ( *strDataLen + bNewLine + entryLen >= strDataBufferSize ) {
+         strDataBuffer[*strDataLen] = '\0';
+         return( ERR_MEM_BUFFER_LEN );
+      }
+
+      if ( bNewLine ) {
+         strDataBuffer[(*strDataLen)++] = '\n';
       }
       /* Print the actual number after checking if we need to print 0x in front*/
       if ( true == bPrintX ) {
-         *strDataLen += snprintf(
-               &strDataBuffer[*strDataLen],
-               strDataBufferSize - *strDataLen,
-               "0x%02x%c",
-               hexData[i],
-               sep
-         );
-      } else {
-         *strDataLen += snprintf(
-               &strDataBuffer[*strDataLen],
-               strDataBufferSize - *strDataLen,
-               "%02x%c",
-               hexData[i],
-               sep
-         );
-      }
-
-      if ( *strDataLen >= strDataBufferSize ) {
-         return( ERR_MEM_BUFFER_LEN );
+         strDataBuffer[(*strDataLen)++] = '0';
+         strDataBuffer[(*strDataLen)++] = 'x';
       }
+      FMT_byteToHex( &strDataBuffer[*strDataLen], hexData[i] );
+      *strDataLen += 2;
+      strDataBuffer[(*strDataLen)++] = sep;
    }
+   strDataBuffer[*strDataLen] = '\0';
    return( status );
 
 }
@@ -26,6 +26,30 @@
 #include "dbg_cntrl.h"                                   /* For debug control */
 
 /* Exported defines ----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \struct MenuRender_t
+ * Context for rendering multi-line menu output.  Output is packed into as few
+ * LrgDataEvt events as possible instead of one event per MENU_printf() call.
+ */
+typedef struct MenuRender {
+   LrgDataEvt *evt;           /**< Event currently being filled or NULL */
+   MsgSrc      dst;               /**< Where the output is being sent to */
+   uint16_t    nEvts;        /**< Number of events posted by this render */
+} MenuRender_t;
+
+/**
+ * \struct LogEvt
+ * DBG_LOG_SIG event published by CON_output().  Subscribers that don't care
+ * about the level or module can treat it as a plain LrgDataEvt.
+ */
+typedef struct LogEvtTag {
+   LrgDataEvt  super;                        /**< Text of the log message */
+   DBG_LEVEL_T dbgLvl;                 /**< Level the message was logged at */
+   DBG_MODL_T  dbgModl;       /**< Module that logged the message or 0 */
+} LogEvt;
+
 /* Exported variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -50,7 +74,9 @@
  * @endcode
  *
  * @note 1: This function is always enabled.
- * @note 2: Use just as a regular printf with all the same flags.
+ * @note 2: Use just as a regular printf.  Formatting is done by
+ * FMT_vsnprintf() so only the integer, string, and char conversions listed in
+ * con_fmt.h are supported.
  * @note 3: Don't use this for regular debugging since it will be difficult to
  * track down where this is being called since it prepends no location or
  * temporal data to help you.
@@ -75,6 +101,51 @@ void MENU_printf(
       ...
 );
 
+/**
+ * @brief Start rendering multi-line menu output.
+ *
+ * MENU_renderPrintf() calls made with the context are appended to a single
+ * LrgDataEvt.  An event is only posted when the next output won't fit in it or
+ * when MENU_renderFlush() is called, so a whole menu printout takes a handful
+ * of maximally filled events instead of one event per line.
+ *
+ * Usage Example:
+ *
+ * @code
+ * MenuRender_t render;
+ * MENU_renderInit( &render, dst );
+ * for ( i = 0; i < n; i++ ) {
+ *    MENU_renderPrintf( &render, "Line %d\n", i );
+ * }
+ * MENU_renderFlush( &render );
+ * @endcode
+ *
+ * @param [out] *render: MenuRender_t pointer to the context to initialize.
+ * @param [in] dst: MsgSrc var that determines where the output will go
+ *    @arg SERIAL_CON: output to serial port.
+ *    @arg ETH_LOG_PORT: output to the ethernet port.
+ * @return None
+ */
+void MENU_renderInit( MenuRender_t *render, MsgSrc dst );
+
+/**
+ * @brief Append printf style output to a menu render.
+ *
+ * @param [in,out] *render: MenuRender_t pointer to the render context.
+ * @param [in] *fmt: const char pointer to the format string.
+ * @param [in] ... : the variable list of arguments.
+ * @return None
+ */
+void MENU_renderPrintf( MenuRender_t *render, const char *fmt, ... );
+
+/**
+ * @brief Post any output of a menu render that hasn't been sent yet.
+ *
+ * @param [in,out] *render: MenuRender_t pointer to the render context.
+ * @return uint16_t: total number of events posted by this render.
+ */
+uint16_t MENU_renderFlush( MenuRender_t *render );
+
 /**
  * @brief Function that gets called by the XXX_printf() macros to output a
  * dbg/log/wrn/err to DMA serial console.
@@ -125,6 +196,9 @@ void MENU_printf(
  *   Enabled in all builds. Just the "User message here" will be printed.  This
  *   is meant to output serial menu items.
  *
+ * @param [in] dbgModl: DBG_MODL_T module that called the macro.  Stored in the
+ * published LogEvt so subscribers can filter by module.
+ *
  * @param [in] src: MsgSrc var specifying the source of the data.
  *    @arg NA_SRC_DST: no src/dst
  *    @arg SERIAL_CON: data is to or from the serial console
@@ -151,6 +225,7 @@ void MENU_printf(
  */
 void CON_output(
       DBG_LEVEL_T dbgLvl,
+      DBG_MODL_T dbgModl,
       volatile MsgSrc src,
       volatile MsgSrc dst,
       const char *pFuncName,
@@ -218,7 +293,8 @@ void CON_slow_output(
  * @brief   Convert a uint8_t hex array to a string array.
  *
  * @note: passed in buffer for string output should be at least 5x the size of
- * the original data.
+ * the original data plus one for the NULL termination.  If it's not, as many
+ * whole numbers as fit are written and ERR_MEM_BUFFER_LEN is returned.
  *
  * @param [in] hexData: const char* pointer to the buffer that contains the hex
  * data to convert.
@@ -41,9 +41,71 @@ Q_DEFINE_THIS_FILE                  /* For QSPY to know the name of this file */
  */
 uint32_t  glbDbgConfig = 0;
 
+/**< What every sink takes.  The debug UART takes everything from boot, like
+ * SerialMgr, and the TCP log port nothing until a client connects. */
+static DbgSinkFilter_t l_dbgSinks[DBG_SINK_MAX] = {
+   [DBG_SINK_SERIAL] = { .modl = {
+         DBG_SINK_ALL_MODULES, DBG_SINK_ALL_MODULES,
+         DBG_SINK_ALL_MODULES, DBG_SINK_ALL_MODULES
+   } },
+};
+
+/**< All of l_dbgSinks ORed together, for DBG_SINK_WANTS() */
+DbgSinkFilter_t volatile glbDbgSinks = { .modl = {
+      DBG_SINK_ALL_MODULES, DBG_SINK_ALL_MODULES,
+      DBG_SINK_ALL_MODULES, DBG_SINK_ALL_MODULES
+} };
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+void DBG_SINK_set( DBG_SINK_T sink, const DbgSinkFilter_t *filter )
+{
+   QF_CRIT_STAT_TYPE intStat;
+
+   if ( sink >= DBG_SINK_MAX ) {
+      return;
+   }
+
+   /* SerialMgr and LWIPMgr run at different priorities, so the update of one
+    * sink and the sum of all of them have to happen together */
+   QF_CRIT_ENTRY(intStat);
+   for ( uint8_t lvl = 0; lvl < DBG_SINK_N_LVLS; lvl++ ) {
+      l_dbgSinks[sink].modl[lvl] = ( NULL != filter ) ? filter->modl[lvl] : 0;
+
+      uint32_t modl = 0;
+      for ( uint8_t i = 0; i < DBG_SINK_MAX; i++ ) {
+         modl |= l_dbgSinks[i].modl[lvl];
+      }
+      glbDbgSinks.modl[lvl] = modl;
+   }
+   QF_CRIT_EXIT(intStat);
+}
+
+/******************************************************************************/
+void DBG_SINK_enable( DBG_SINK_T sink, bool bEnable )
+{
+   DbgSinkFilter_t filter = { .modl = { 0 } };
+
+   if ( bEnable ) {
+      DBG_SINK_filterAdd( &filter, DBG, DBG_SINK_ALL_MODULES );
+   }
+   DBG_SINK_set( sink, &filter );
+}
+
+/******************************************************************************/
+void DBG_SINK_filterAdd(
+      DbgSinkFilter_t *filter,
+      DBG_LEVEL_T minLvl,
+      uint32_t modlMask
+)
+{
+   for ( uint8_t lvl = minLvl; lvl < DBG_SINK_N_LVLS; lvl++ ) {
+      filter->modl[lvl] |= modlMask;
+   }
+}
+
 /**
  * @} end addtogroup groupDbgCntrl
  */
@@ -120,6 +120,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -182,11 +183,74 @@ typedef enum DBG_MODULES {
    DBG_MODL_DB       = 0x00000800, /**< Database module debugging. */
 } DBG_MODL_T;
 
+/**< Module mask of a sink that takes output from every module */
+#define DBG_SINK_ALL_MODULES                                       0xFFFFFFFFUL
+
+/**< Levels a sink can filter on, DBG through ERR */
+#define DBG_SINK_N_LVLS                                              (ERR + 1)
+
+/*! \enum DBG_SINK_T
+ * The outputs that consume the DBG_LOG_SIG events published by CON_output().
+ */
+typedef enum DBG_SINKS {
+   DBG_SINK_SERIAL = 0,      /**< SerialMgr, the debug UART */
+   DBG_SINK_ETH,             /**< LWIPMgr, the clients of the TCP log port */
+   DBG_SINK_MAX
+} DBG_SINK_T;
+
+/**
+ * \struct DbgSinkFilter_t
+ * What a sink takes: the modules it takes output from, at each level.
+ */
+typedef struct DbgSinkFilters
+{
+   uint32_t modl[DBG_SINK_N_LVLS];          /**< DBG_MODL_T mask per level */
+} DbgSinkFilter_t;
+
 /* Exported variables --------------------------------------------------------*/
 extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
 
+/**< What all the active sinks together take.  Only set by DBG_SINK_set() */
+extern DbgSinkFilter_t volatile glbDbgSinks;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Set what one output takes.
+ *
+ * The owner of the output calls this whenever it's turned on or off or its
+ * filter changes, so CON_output() and the XXX_printf() macros can skip
+ * formatting and allocating output that no sink would take.
+ *
+ * @param [in] sink: DBG_SINK_T the output.
+ * @param [in] *filter: const DbgSinkFilter_t pointer to what it takes, NULL
+ * if it's off.
+ * @return: None
+ */
+void DBG_SINK_set( DBG_SINK_T sink, const DbgSinkFilter_t *filter );
+
+/**
+ * @brief   Turn an output on for everything, or off.
+ * @param [in] sink: DBG_SINK_T the output.
+ * @param [in] bEnable: bool true for everything, false for nothing.
+ * @return: None
+ */
+void DBG_SINK_enable( DBG_SINK_T sink, bool bEnable );
+
+/**
+ * @brief   Add a level and module filter to a sink filter being built.
+ * @param [in|out] *filter: DbgSinkFilter_t pointer to the filter.
+ * @param [in] minLvl: DBG_LEVEL_T lowest level to take.
+ * @param [in] modlMask: uint32_t DBG_MODL_T modules to take it from.
+ * @return: None
+ */
+void DBG_SINK_filterAdd(
+      DbgSinkFilter_t *filter,
+      DBG_LEVEL_T minLvl,
+      uint32_t modlMask
+);
+
 /* Exported macros -----------------------------------------------------------*/
 
 /**
@@ -243,6 +307,15 @@ extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
 #define DBG_DISABLE_DEBUG_FOR_ALL_MODULES( ) \
       glbDbgConfig = 0x00000000;
 
+/**
+ * @brief   Check whether any active output would take a message.
+ *
+ * @param [in] @c lvl_: DBG_LEVEL_T level of the message, DBG through ERR.
+ * @param [in] @c modl_: DBG_MODL_T module of the message.
+ */
+#define DBG_SINK_WANTS( lvl_, modl_ ) \
+      ( 0 != ( glbDbgSinks.modl[(lvl_)] & (uint32_t)(modl_) ) )
+
 /**
  * @brief   Conditional error output
  *
@@ -284,6 +357,11 @@ extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
 
 /** @addtogroup groupDbgFast
  * @{
+ *
+ * None of these format or allocate anything unless one of the outputs that
+ * is on right now would take the message (see DBG_SINK_set()).  With the
+ * debug UART turned off and no client on the TCP log port, a call costs a
+ * load and a compare and its arguments aren't even evaluated.
  */
 
 /**
@@ -320,9 +398,10 @@ extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
 #define DBG_printf(fmt, ...) \
       do { \
          if (DEBUG) { \
-            if ( glbDbgConfig & DBG_this_module_ ) { \
-               CON_output(DBG, NA_SRC_DST, NA_SRC_DST, __func__, __LINE__, fmt, \
-                  ##__VA_ARGS__); \
+            if ( ( glbDbgConfig & DBG_this_module_ ) && \
+                  DBG_SINK_WANTS( DBG, DBG_this_module_ ) ) { \
+               CON_output(DBG, DBG_this_module_, NA_SRC_DST, NA_SRC_DST, \
+                  __func__, __LINE__, fmt, ##__VA_ARGS__); \
             } \
          } \
       } while (0)
@@ -367,8 +446,11 @@ extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
  */
 #ifndef SLOW_PRINTF
 #define LOG_printf(fmt, ...) \
-      do { CON_output(LOG, NA_SRC_DST, NA_SRC_DST, __func__, __LINE__, fmt, \
-            ##__VA_ARGS__); \
+      do { \
+         if ( DBG_SINK_WANTS( LOG, DBG_this_module_ ) ) { \
+            CON_output(LOG, DBG_this_module_, NA_SRC_DST, NA_SRC_DST, \
+               __func__, __LINE__, fmt, ##__VA_ARGS__); \
+         } \
       } while (0)
 #else
 #define LOG_printf(fmt, ...) \
@@ -405,8 +487,11 @@ extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
  */
 #ifndef SLOW_PRINTF
 #define WRN_printf(fmt, ...) \
-      do { CON_output(WRN, NA_SRC_DST, NA_SRC_DST, __func__, __LINE__, fmt, \
-            ##__VA_ARGS__); \
+      do { \
+         if ( DBG_SINK_WANTS( WRN, DBG_this_module_ ) ) { \
+            CON_output(WRN, DBG_this_module_, NA_SRC_DST, NA_SRC_DST, \
+               __func__, __LINE__, fmt, ##__VA_ARGS__); \
+         } \
       } while (0)
 #else
 #define WRN_printf(fmt, ...) \
@@ -443,8 +528,11 @@ extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
  */
 #ifndef SLOW_PRINTF
 #define ERR_printf(fmt, ...) \
-      do { CON_output(ERR, NA_SRC_DST, NA_SRC_DST, __func__, __LINE__, fmt, \
-            ##__VA_ARGS__); \
+      do { \
+         if ( DBG_SINK_WANTS( ERR, DBG_this_module_ ) ) { \
+            CON_output(ERR, DBG_this_module_, NA_SRC_DST, NA_SRC_DST, \
+               __func__, __LINE__, fmt, ##__VA_ARGS__); \
+         } \
       } while (0)
 #else
 #define ERR_printf(fmt, ...) \
@@ -487,8 +575,8 @@ extern uint32_t  glbDbgConfig; /**< Allow global access to debug info */
 #if 0
 #define MENU_printf(dst, fmt, ...) \
       do {  DBG_printf("dst:%d\n", dst); \
-            CON_output(CON, dst, dst, __func__, __LINE__, fmt, \
-            ##__VA_ARGS__); \
+            CON_output(CON, DBG_this_module_, dst, dst, __func__, __LINE__, \
+            fmt, ##__VA_ARGS__); \
       } while (0)
 #endif
 #else
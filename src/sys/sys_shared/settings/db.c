@@ -18,7 +18,9 @@
 #include <stddef.h>
 #include "i2c_defs.h"                                /* for I2C functionality */
 #include "i2c_dev.h"                               /* for I2C device mappings */
+#include "I2CDevMgr.h"                    /* for MAX_I2C_READ_LEN/WRITE_LEN */
 #include "db.h"
+#include "db_journal.h"                /* for the journaled settings store */
 #include "ipAndMac.h"                                  /* for default IP addr */
 
 /* Compile-time called macros ------------------------------------------------*/
@@ -30,14 +32,15 @@ DBG_DEFINE_THIS_MODULE( DBG_MODL_DB );  /* For debug system to ID this module */
  * DB elements that can be retrieved.
  */
 typedef enum {
-   DB_EEPROM = 0,           /**< Setting is located in the main EEPROM memory */
+   DB_EEPROM = 0,     /**< Setting is a record in the journal in the main EEPROM */
    DB_SN_ROM,         /**< Setting is located in the RO SNR section of EEPROM */
    DB_UI_ROM,        /**< Setting is located in the RO UI64 section of EEPROM */
 
    /* .. insert more I2C devices before GPIO so they are all together .. */
 
    DB_GPIO,                          /**< Setting is specified via a GPIO pin */
-   DB_FLASH                  /**< Setting is located in the main FLASH memory */
+   DB_FLASH,                 /**< Setting is located in the main FLASH memory */
+   DB_JOURNAL_HDR        /**< Setting comes from the header of the journal */
 } DB_ElemLoc_t;
 
 /**
@@ -48,11 +51,14 @@ typedef struct {
    DB_ElemLoc_t  loc;  /**< Specifies how the db element is stored */
    size_t       size;  /**< Specifies the size of the db element */
    uint16_t    offset; /**< Specifies the offset from beginning of EEPROM memory
-                            where the element is stored */
+                            where the element is stored.  For elements in the
+                            journal, where the fixed layout of older FW kept
+                            it, which is only used to migrate. */
 } SettingsDB_Desc_t;
 
 /**
- * DB element structure mapping that resides in the main memory of the EEPROM
+ * DB element structure mapping that older FW kept at the start of the main
+ * memory of the EEPROM.  Only read to move the settings into the journal.
  */
 typedef struct {
    uint32_t dbMagicWord; /**< Magic word that specifies whether a DB exists.  If
@@ -69,10 +75,42 @@ typedef struct {
  * there, the DB needs to be initialized to a default and updated after. */
 #define DB_MAGIC_WORD_DEF   0xdefec8db
 
-/**< Current version of the DB.  This needs to be bumped once the FW is out in
- * the field and any changes are made to the DB. This is to allow for a smooth
- * upgrade of the DB. */
-#define DB_VERSION_DEF      0x0001
+/**< Current version of the DB.  This is the schema of the journal's key table
+ * and needs to be bumped whenever an element is added to the EEPROM, removed
+ * from it, or changes size.  The journal is then rewritten with the new table
+ * on the next boot: new elements get their defaults and the rest are kept. */
+#define DB_VERSION_DEF      0x0002
+
+/**< Version of the fixed SettingsDB_t layout used before the journal */
+#define DB_LEGACY_VERSION   0x0001
+
+/**< The journal takes up the whole main EEPROM, split into 4 banks of 4 pages.
+ * Formatting an empty EEPROM starts in bank 1 so that the old layout at the
+ * start of bank 0 is still intact if the power goes out while migrating. */
+#define DB_JOURNAL_N_BANKS       4
+#define DB_JOURNAL_BANK_SIZE     ( EEPROM_PAGE_SIZE * 4 )
+#define DB_JOURNAL_FIRST_BANK    1
+
+/**< How long a FreeRTOS thread waits for another caller to finish with the
+ * journal before giving up with ERR_DB_BUSY */
+#define DB_FRT_WAIT_TICKS \
+   ( (TickType_t)( HL_MAX_TOUT_SEC_I2C_FRT_WAIT * 1000 / portTICK_PERIOD_MS ) )
+
+/**< Free space in the active bank below which DB_maintain() compacts.  Leaves
+ * room for one more of the largest record so an AO, which can't compact, can
+ * still write while the maintenance hasn't run yet. */
+#define DB_JOURNAL_COMPACT_FREE  ( DBJ_REC_OVERHEAD + DBJ_MAX_VAL_LEN )
+
+/**< Longest single I2C transaction for a batch of elements.  Anything this
+ * short travels in the I2CDevMgr events so FreeRTOS and QPC accesses don't
+ * have to keep a buffer alive until the reply comes back. */
+#define DB_RUN_MAX_LEN      MAX_I2C_READ_LEN
+
+/**< Largest gap between two elements that is read along with them instead of
+ * starting another I2C read.  Setting up a read costs about as much as this
+ * many data bytes and it lets the values of neighbouring journal records be
+ * read together. */
+#define DB_READ_MAX_GAP     DBJ_REC_OVERHEAD
 
 /* Private macros ------------------------------------------------------------*/
 
@@ -82,15 +120,29 @@ typedef struct {
 /**< Macro to get the offset of the element stored in the EEPROM memory */
 #define DB_LOC_OF_ELEM(s,m)      offsetof(s, m)
 
+/**< Macro to print a warning the right way for how the DB is being accessed */
+#define DB_WRN_OUTPUT(accessType, fmt, ...) {                                  \
+      if ( ACCESS_BARE_METAL == (accessType) ) {                              \
+         wrn_slow_printf(fmt, ##__VA_ARGS__);                                 \
+      } else {                                                                \
+         WRN_printf(fmt, ##__VA_ARGS__);                                      \
+      }                                                                       \
+   }
+
 /* Private variables and Local objects ---------------------------------------*/
 
-/**< Array to specify where all the DB elements reside */
+/**< Array to specify where all the DB elements reside.  A host test built
+ * with DB_HOST_LAYOUT can move them around with DB_hostPlaceElem(). */
+#ifdef DB_HOST_LAYOUT
+static SettingsDB_Desc_t settingsDB[DB_MAX_ELEM] = {
+#else
 static const SettingsDB_Desc_t settingsDB[DB_MAX_ELEM] = {
-      { DB_MAGIC_WORD,  DB_EEPROM,  DB_SIZE_OF_ELEM(SettingsDB_t, dbMagicWord), DB_LOC_OF_ELEM(SettingsDB_t, dbMagicWord)},
-      { DB_VERSION,     DB_EEPROM,  DB_SIZE_OF_ELEM(SettingsDB_t, dbVersion)  , DB_LOC_OF_ELEM(SettingsDB_t, dbVersion)  },
-      { DB_MAC_ADDR,    DB_UI_ROM,  6                                         , 2                                        },
-      { DB_IP_ADDR,     DB_EEPROM,  DB_SIZE_OF_ELEM(SettingsDB_t, ipAddr)     , DB_LOC_OF_ELEM(SettingsDB_t, ipAddr)     },
-      { DB_SN,          DB_SN_ROM,  16                                        , 0                                        },
+#endif                                                      /* DB_HOST_LAYOUT */
+      { DB_MAGIC_WORD,  DB_JOURNAL_HDR, DB_SIZE_OF_ELEM(SettingsDB_t, dbMagicWord), DB_LOC_OF_ELEM(SettingsDB_t, dbMagicWord)},
+      { DB_VERSION,     DB_JOURNAL_HDR, DB_SIZE_OF_ELEM(SettingsDB_t, dbVersion)  , DB_LOC_OF_ELEM(SettingsDB_t, dbVersion)  },
+      { DB_MAC_ADDR,    DB_UI_ROM,      6                                         , 2                                        },
+      { DB_IP_ADDR,     DB_EEPROM,      DB_SIZE_OF_ELEM(SettingsDB_t, ipAddr)     , DB_LOC_OF_ELEM(SettingsDB_t, ipAddr)     },
+      { DB_SN,          DB_SN_ROM,      16                                        , 0                                        },
 };
 
 /**
@@ -110,9 +162,594 @@ static const SettingsDB_t DB_defaultEeepromSettings = {
       .ipAddr = {STATIC_IPADDR0, STATIC_IPADDR1, STATIC_IPADDR2, STATIC_IPADDR3}
 };
 
+/**< Key table of the journal.  The key of an element is its DB_Elem_t and
+ * only the DB_EEPROM elements are stored. */
+static const DBJ_Key_t DB_journalKeys[DB_MAX_ELEM] = {
+      [DB_IP_ADDR] = {
+            DB_SIZE_OF_ELEM(SettingsDB_t, ipAddr),
+            DB_defaultEeepromSettings.ipAddr
+      },
+};
+
+static DBJ_Store_t DB_journal;                /**< The mounted settings store */
+
+/**< Set while a call is using the journal.  See DB_lock() */
+static volatile bool DB_isBusy = false;
+
+/**
+ * How the journal gets to the EEPROM during the call that holds the lock.
+ */
+static struct {
+   AccessType_t  accessType;            /**< How the caller accesses the DB */
+   QActive      *callingAO;                    /**< Caller for ACCESS_QPC */
+   uint16_t      tag;              /**< Tag of the writes for ACCESS_QPC */
+   uint8_t       nWrites;       /**< I2C writes done (or posted) so far */
+   uint8_t       nRepliesLeft;  /**< ACCESS_QPC writes not back yet */
+   bool          isWriteOk;        /**< All of those that came back worked */
+} DB_io;
+
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Read the main EEPROM for the journal.
+ *
+ * Uses the access type of the caller holding the lock.  See DBJ_ReadFn.
+ */
+static CBErrorCode DB_journalRead( uint16_t addr, uint8_t *pBuf, uint16_t len );
+
+/**
+ * @brief   Write the main EEPROM for the journal.
+ *
+ * Uses the access type of the caller holding the lock.  For ACCESS_QPC the
+ * data is split into requests that fit in the event so the journal can reuse
+ * its buffer right away.  See DBJ_WriteFn.
+ */
+static CBErrorCode DB_journalWrite(
+      uint16_t addr,
+      const uint8_t *pBuf,
+      uint16_t len
+);
+
+/**
+ * @brief   Take the journal for the duration of one DB call.  An ACCESS_QPC
+ * write keeps it until the last of its I2C writes is back.
+ *
+ * A FreeRTOS thread waits for up to DB_FRT_WAIT_TICKS for the current user to
+ * finish.  An AO can't wait so it gets ERR_DB_BUSY right away.
+ *
+ * @param  [in] accessType: AccessType_t of the caller.
+ * @param  [in] *callingAO: QActive pointer to the calling AO for ACCESS_QPC.
+ * @param  [in] tag: uint16_t tag of the writes for ACCESS_QPC.
+ * @return CBErrorCode: ERR_NONE if the journal was taken, ERR_DB_BUSY if not.
+ */
+static CBErrorCode DB_lock(
+      AccessType_t accessType,
+      QActive *callingAO,
+      uint16_t tag
+);
+
+/**
+ * @brief   Give the journal back after DB_lock().
+ * @param   None
+ * @return  None
+ */
+static void DB_unlock( void );
+
+/**
+ * @brief   Mount the journal, moving the settings over from the fixed layout
+ * of older FW if there is no journal yet.  Must hold the lock.
+ *
+ * @param   None
+ * @return CBErrorCode: ERR_NONE if the journal is mounted, ERR_DB_NOT_INIT if
+ * there was nothing to mount or migrate.
+ */
+static CBErrorCode DB_mount( void );
+
+/**
+ * @brief   Copy an element that comes from the header of the journal.
+ * @param  [in] elem: DB_Elem_t element.  Must be in DB_JOURNAL_HDR.
+ * @param  [out] *pBuf: uint8_t pointer to where to store the element.
+ * @return  None
+ */
+static void DB_getHdrElem( DB_Elem_t elem, uint8_t *pBuf );
+
+/**
+ * @brief   Append a batch of DB elements to the journal.
+ *
+ * All the records go out in a single I2C write (or as few requests as fit in
+ * the events for ACCESS_QPC).  If the active bank is full, it is compacted
+ * first unless the caller is an AO, which gets ERR_DB_NO_SPACE until
+ * DB_maintain() has run.  For ACCESS_QPC the journal only takes the new
+ * records once DB_onWriteDoneEVT() has seen every write come back, and holds
+ * the lock until then.
+ *
+ * @param  [in] *elems: DB_ElemBuf_t array of the elements.  Already checked.
+ * @param  [in] nElems: uint8_t number of elements in *elems.
+ * @param  [in] accessType: AccessType_t of the access.
+ * @param  [in] *callingAO: QActive pointer to the calling AO for ACCESS_QPC.
+ * @param  [in] tag: uint16_t tag of the requests for ACCESS_QPC.
+ * @param  [out] *pnRuns: uint8_t pointer to where to store the number of I2C
+ * writes that were done (or posted).
+ * @return CBErrorCode: status of the append.
+ */
+static CBErrorCode DB_writeBatch(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      AccessType_t accessType,
+      QActive *callingAO,
+      uint16_t tag,
+      uint8_t *pnRuns
+);
+
+/**
+ * @brief   Read or write a batch of DB elements with as few I2C transactions
+ * as possible.
+ *
+ * Every element is checked before anything is sent to the bus.  Writes are
+ * appended to the journal.  For reads, the elements are sorted by location
+ * and offset (the offset of a journal element is where its latest record is).
+ * Neighbours on the same I2C device are merged into runs of at most
+ * DB_RUN_MAX_LEN bytes and each run is a single I2C read.
+ *
+ * @param  [in] *elems: DB_ElemBuf_t array of the elements.
+ * @param  [in] nElems: uint8_t number of elements in *elems.
+ * @param  [in] isWrite: bool true to write the elements, false to read them.
+ * @param  [in] accessType: AccessType_t of the access.  ACCESS_QPC is only
+ * allowed for writes.
+ * @param  [in] *callingAO: QActive pointer to the calling AO for ACCESS_QPC.
+ * @param  [in] tag: uint16_t tag of the requests for ACCESS_QPC.
+ * @param  [out] *pnRuns: uint8_t pointer to where to store the number of I2C
+ * transactions that were done (or posted).
+ * @return CBErrorCode: status of the batch.
+ */
+static CBErrorCode DB_xferBatch(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      bool isWrite,
+      AccessType_t accessType,
+      QActive *callingAO,
+      uint16_t tag,
+      uint8_t *pnRuns
+);
+
+/**< Where the journal lives and what goes in it */
+static const DBJ_Cfg_t DB_journalCfg = {
+      DB_journalRead,                           // DBJ_ReadFn read
+      DB_journalWrite,                          // DBJ_WriteFn write
+      0,                                        // uint16_t base
+      DB_JOURNAL_BANK_SIZE,                     // uint16_t bankSize
+      DB_JOURNAL_N_BANKS,                       // uint8_t nBanks
+      DB_JOURNAL_FIRST_BANK,                    // uint8_t firstBank
+      DB_JOURNAL_COMPACT_FREE,                  // uint16_t compactFree
+      DB_VERSION_DEF,                           // uint16_t schema
+      DB_journalKeys,                           // const DBJ_Key_t *keys
+      DB_MAX_ELEM                               // uint8_t nKeys
+};
+
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+static CBErrorCode DB_journalRead( uint16_t addr, uint8_t *pBuf, uint16_t len )
+{
+   I2C_Dev_t iDev = DB_I2C_devices[DB_EEPROM];
+   uint16_t bytesDone = 0;
+
+   switch( DB_io.accessType ) {
+      case ACCESS_BARE_METAL:
+         return( I2C_readDevMemBLK( iDev, addr, len, ACCESS_BARE_METAL, pBuf, len ) );
+
+      case ACCESS_FREERTOS:
+         return( I2C_readDevMemFRT( iDev, addr, pBuf, len, &bytesDone, len ) );
+
+      default:
+         return( ERR_DB_WRONG_ACCESS_TYPE );   /* An AO can't wait for the data */
+   }
+}
+
+/******************************************************************************/
+static CBErrorCode DB_journalWrite(
+      uint16_t addr,
+      const uint8_t *pBuf,
+      uint16_t len
+)
+{
+   I2C_Dev_t iDev = DB_I2C_devices[DB_EEPROM];
+   CBErrorCode status = ERR_NONE;
+   uint16_t bytesDone = 0;
+
+   switch( DB_io.accessType ) {
+      case ACCESS_BARE_METAL:
+         status = I2C_writeDevMemBLK( iDev, addr, len, ACCESS_BARE_METAL, (uint8_t *)pBuf, len );
+         DB_io.nWrites++;
+         break;
+
+      case ACCESS_FREERTOS:
+         status = I2C_writeDevMemFRT( iDev, addr, (uint8_t *)pBuf, len, &bytesDone, len );
+         DB_io.nWrites++;
+         break;
+
+      case ACCESS_QPC:
+         /* The requests go out in order on the same I2CDevMgr so the header
+          * of a new bank still lands after its records. */
+         while ( bytesDone < len && ERR_NONE == status ) {
+            uint16_t chunk = len - bytesDone;
+            if ( chunk > MAX_I2C_WRITE_LEN ) {
+               chunk = MAX_I2C_WRITE_LEN;
+            }
+
+            status = I2C_writeDevMemEVT(
+                  iDev,                                  // I2C_Dev_t iDev
+                  addr + bytesDone,                      // uint16_t offset
+                  chunk,                                 // uint16_t bytesToWrite
+                  ACCESS_QPC,                            // AccessType_t accType
+                  DB_io.callingAO,                       // QActive* callingAO
+                  (uint8_t *)&pBuf[bytesDone],           // uint8_t *pBuffer
+                  DB_io.tag                              // uint16_t tag
+            );
+            bytesDone += chunk;
+            DB_io.nWrites++;
+         }
+         break;
+
+      default:
+         status = ERR_DB_WRONG_ACCESS_TYPE;
+         break;
+   }
+
+   return( status );
+}
+
+/******************************************************************************/
+static CBErrorCode DB_lock(
+      AccessType_t accessType,
+      QActive *callingAO,
+      uint16_t tag
+)
+{
+   QF_CRIT_STAT_TYPE intStat;
+   TickType_t ticksLeft = DB_FRT_WAIT_TICKS;
+   bool isTaken = false;
+
+   for (;;) {
+      QF_CRIT_ENTRY(intStat);
+      if ( !DB_isBusy ) {
+         DB_isBusy = true;
+         isTaken = true;
+      }
+      QF_CRIT_EXIT(intStat);
+
+      if ( isTaken ) {
+         break;
+      }
+
+      if ( ACCESS_FREERTOS != accessType || 0 == ticksLeft ) {
+         return( ERR_DB_BUSY );
+      }
+      vTaskDelay(1);
+      ticksLeft--;
+   }
+
+   DB_io.accessType = accessType;
+   DB_io.callingAO  = callingAO;
+   DB_io.tag        = tag;
+   DB_io.nWrites    = 0;
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+static void DB_unlock( void )
+{
+   DB_isBusy = false;
+}
+
+/******************************************************************************/
+static CBErrorCode DB_mount( void )
+{
+   uint32_t nMigrations = DB_journal.stats.nMigrations;
+
+   CBErrorCode status = DBJ_mount( &DB_journal, &DB_journalCfg );
+   if ( ERR_NONE == status && nMigrations != DB_journal.stats.nMigrations ) {
+      DB_WRN_OUTPUT(
+            DB_io.accessType,
+            "Rewrote the settings DB with version 0x%04x\n",
+            DB_VERSION_DEF
+      );
+   }
+
+   if ( ERR_DB_NOT_INIT != status ) {
+      return( status );
+   }
+
+   /* No journal yet.  Move the settings over if the EEPROM still has the fixed
+    * layout of older FW.  The journal starts in DB_JOURNAL_FIRST_BANK so the
+    * old layout isn't touched until the journal is complete. */
+   SettingsDB_t legacy;
+   status = DB_journalRead( 0, (uint8_t *)&legacy, sizeof(legacy) );
+   if ( ERR_NONE != status ) {
+      return( status );
+   }
+
+   if ( DB_MAGIC_WORD_DEF != legacy.dbMagicWord ||
+         DB_LEGACY_VERSION != legacy.dbVersion ) {
+      return( ERR_DB_NOT_INIT );
+   }
+
+   DBJ_Val_t vals[DB_MAX_ELEM];
+   uint8_t nVals = 0;
+   for ( uint8_t i = 0; i < DB_MAX_ELEM; i++ ) {
+      if ( DB_EEPROM == settingsDB[i].loc ) {
+         vals[nVals].key  = i;
+         vals[nVals].pVal = (const uint8_t *)&legacy + settingsDB[i].offset;
+         vals[nVals].len  = settingsDB[i].size;
+         nVals++;
+      }
+   }
+
+   status = DBJ_format( &DB_journal, &DB_journalCfg, vals, nVals );
+   if ( ERR_NONE == status ) {
+      DB_journal.stats.nMigrations++;
+      DB_WRN_OUTPUT(
+            DB_io.accessType,
+            "Moved the settings DB version 0x%04x into the journal\n",
+            legacy.dbVersion
+      );
+   }
+   return( status );
+}
+
+/******************************************************************************/
+static void DB_getHdrElem( DB_Elem_t elem, uint8_t *pBuf )
+{
+   uint32_t magicWord = DB_MAGIC_WORD_DEF;
+
+   if ( DB_MAGIC_WORD == elem ) {
+      MEMCPY( pBuf, (uint8_t *)&magicWord, settingsDB[elem].size );
+   } else {
+      MEMCPY( pBuf, (uint8_t *)&DB_journal.schema, settingsDB[elem].size );
+   }
+}
+
+/******************************************************************************/
+static CBErrorCode DB_writeBatch(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      AccessType_t accessType,
+      QActive *callingAO,
+      uint16_t tag,
+      uint8_t *pnRuns
+)
+{
+   DBJ_Val_t vals[DB_MAX_BATCH_ELEMS];
+
+   for ( uint8_t i = 0; i < nElems; i++ ) {
+      vals[i].key  = (uint8_t)elems[i].elem;
+      vals[i].pVal = elems[i].pBuffer;
+      vals[i].len  = settingsDB[elems[i].elem].size;
+   }
+
+   CBErrorCode status = DB_lock( accessType, callingAO, tag );
+   if ( ERR_NONE != status ) {
+      return( status );
+   }
+
+   /* An AO can't read so it can't mount either.  DBJ_append() tells it. */
+   if ( !DB_journal.isMounted && ACCESS_QPC != accessType ) {
+      status = DB_mount();
+   }
+
+   if ( ERR_NONE == status && ACCESS_QPC == accessType ) {
+      status = DBJ_appendAsync( &DB_journal, vals, nElems );
+   } else if ( ERR_NONE == status ) {
+      status = DBJ_append( &DB_journal, vals, nElems );
+   }
+
+   if ( ERR_DB_NO_SPACE == status && ACCESS_QPC != accessType ) {
+      status = DBJ_compact( &DB_journal );
+      if ( ERR_NONE == status ) {
+         status = DBJ_append( &DB_journal, vals, nElems );
+      }
+   }
+
+   *pnRuns = DB_io.nWrites;
+
+   /* Posted writes still have to come back, even if a later one failed to
+    * post.  DB_onWriteDoneEVT() gives the lock back after the last one. */
+   if ( ACCESS_QPC == accessType && DB_io.nWrites > 0 ) {
+      DB_io.nRepliesLeft = DB_io.nWrites;
+      DB_io.isWriteOk    = true;
+      return( status );
+   }
+   DB_unlock();
+   return( status );
+}
+
+/******************************************************************************/
+static CBErrorCode DB_xferBatch(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      bool isWrite,
+      AccessType_t accessType,
+      QActive *callingAO,
+      uint16_t tag,
+      uint8_t *pnRuns
+)
+{
+   uint8_t order[DB_MAX_BATCH_ELEMS];  /* Indices of elems sorted by location */
+   uint16_t offsets[DB_MAX_BATCH_ELEMS];  /* Where each element is on its dev */
+   uint8_t runBuf[DB_RUN_MAX_LEN];
+   bool needsJournal = false;
+   CBErrorCode status = ERR_NONE;
+
+   *pnRuns = 0;
+
+   /* 1. Sanity checks of every element before anything goes out on the bus */
+   if ( NULL == elems ) {
+      return( ERR_MEM_NULL_VALUE );
+   }
+
+   if ( 0 == nElems || nElems > DB_MAX_BATCH_ELEMS ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+
+   for ( uint8_t i = 0; i < nElems; i++ ) {
+      DB_Elem_t elem = elems[i].elem;
+      if ( (uint32_t)elem >= DB_MAX_ELEM ) {
+         return( ERR_DB_ELEM_NOT_FOUND );
+      }
+
+      if ( NULL == elems[i].pBuffer ) {
+         return( ERR_MEM_NULL_VALUE );
+      }
+
+      if ( elems[i].bufSize < settingsDB[elem].size ) {
+         return( ERR_MEM_BUFFER_LEN );
+      }
+
+      /* Only the journal in the main EEPROM is writable */
+      if ( isWrite && DB_EEPROM != settingsDB[elem].loc ) {
+         return( ERR_DB_ELEM_IS_READ_ONLY );
+      }
+
+      /* GPIO and FLASH aren't supported */
+      if ( DB_GPIO == settingsDB[elem].loc || DB_FLASH == settingsDB[elem].loc ) {
+         return( ERR_UNIMPLEMENTED );
+      }
+
+      if ( DB_EEPROM == settingsDB[elem].loc ||
+            DB_JOURNAL_HDR == settingsDB[elem].loc ) {
+         needsJournal = true;
+      }
+      offsets[i] = settingsDB[elem].offset;
+   }
+
+   if ( isWrite ) {
+      return( DB_writeBatch( elems, nElems, accessType, callingAO, tag, pnRuns ) );
+   }
+
+   /* An AO has nobody to scatter the reply */
+   if ( ACCESS_BARE_METAL != accessType && ACCESS_FREERTOS != accessType ) {
+      return( ERR_DB_WRONG_ACCESS_TYPE );
+   }
+
+   /* 2. Look up where the journal elements are.  Once the lock is given back
+    * the records may get compacted into another bank but the old bank keeps
+    * its data until the journal has gone all the way around. */
+   if ( needsJournal ) {
+      status = DB_lock( accessType, callingAO, tag );
+      if ( ERR_NONE != status ) {
+         return( status );
+      }
+
+      if ( !DB_journal.isMounted ) {
+         status = DB_mount();
+      }
+
+      for ( uint8_t i = 0; i < nElems && ERR_NONE == status; i++ ) {
+         DB_Elem_t elem = elems[i].elem;
+         if ( DB_EEPROM == settingsDB[elem].loc ) {
+            status = DBJ_locate( &DB_journal, (uint8_t)elem, &offsets[i] );
+         } else if ( DB_JOURNAL_HDR == settingsDB[elem].loc ) {
+            DB_getHdrElem( elem, elems[i].pBuffer );
+         }
+      }
+
+      DB_unlock();
+      if ( ERR_NONE != status ) {
+         return( status );
+      }
+   }
+
+   /* 3. Insertion sort of the elements on I2C devices by location and offset.
+    * There are only a handful. */
+   uint8_t nDev = 0;
+   for ( uint8_t i = 0; i < nElems; i++ ) {
+      DB_ElemLoc_t loc = settingsDB[elems[i].elem].loc;
+      if ( DB_JOURNAL_HDR == loc ) {
+         continue;                                     /* Already copied above */
+      }
+
+      uint8_t j = nDev;
+      while ( j > 0 ) {
+         DB_ElemLoc_t prevLoc = settingsDB[elems[order[j - 1]].elem].loc;
+         if ( prevLoc < loc ||
+               ( prevLoc == loc && offsets[order[j - 1]] <= offsets[i] ) ) {
+            break;
+         }
+         order[j] = order[j - 1];
+         j--;
+      }
+      order[j] = i;
+      nDev++;
+   }
+
+   /* 4. Merge neighbours into runs and do one I2C read per run */
+   uint8_t first = 0;
+   while ( first < nDev ) {
+      SettingsDB_Desc_t const *desc = &settingsDB[elems[order[first]].elem];
+      DB_ElemLoc_t loc   = desc->loc;
+      uint16_t     start = offsets[order[first]];
+      uint16_t     end   = start + desc->size;
+
+      uint8_t last = first + 1;
+      while ( last < nDev ) {
+         desc = &settingsDB[elems[order[last]].elem];
+         uint16_t offset = offsets[order[last]];
+         if ( desc->loc != loc || offset > end + DB_READ_MAX_GAP ) {
+            break;
+         }
+
+         uint16_t newEnd = offset + desc->size;
+         if ( newEnd < end ) {
+            newEnd = end;
+         }
+
+         if ( newEnd - start > DB_RUN_MAX_LEN ) {
+            break;
+         }
+         end = newEnd;
+         last++;
+      }
+
+      if ( ACCESS_BARE_METAL == accessType ) {
+         status = I2C_readDevMemBLK(
+               DB_I2C_devices[loc],             // I2C_Dev_t iDev
+               start,                           // uint16_t offset
+               end - start,                     // uint16_t bytesToRead
+               accessType,                      // AccessType_t accType
+               runBuf,                          // uint8_t* pBuffer
+               sizeof(runBuf)                   // uint8_t bufSize
+         );
+      } else {
+         uint16_t bytesRead = 0;
+         status = I2C_readDevMemFRT(
+               DB_I2C_devices[loc],             // I2C_Dev_t iDev
+               start,                           // uint16_t offset
+               runBuf,                          // uint8_t *pBuffer
+               sizeof(runBuf),                  // uint16_t nBufferSize
+               &bytesRead,                      // uint16_t *pBytesRead
+               end - start                      // uint16_t nBytesToRead
+         );
+      }
+      if ( ERR_NONE != status ) {
+         return( status );
+      }
+      (*pnRuns)++;
+
+      for ( uint8_t k = first; k < last; k++ ) {
+         desc = &settingsDB[elems[order[k]].elem];
+         MEMCPY(
+               elems[order[k]].pBuffer,
+               &runBuf[offsets[order[k]] - start],
+               desc->size
+         );
+      }
+
+      first = last;
+   }
+
+   return( status );
+}
+
 /******************************************************************************/
 char* DB_elemToStr( DB_Elem_t elem )
 {
@@ -131,47 +768,29 @@ CBErrorCode DB_isValid( AccessType_t accessType )
 {
    CBErrorCode status = ERR_NONE;            /* keep track of success/failure */
 
-   uint32_t db_magicWord = 0;
-   status = DB_getElemBLK(
-         DB_MAGIC_WORD,
-         (uint8_t *)&db_magicWord,
-         sizeof(db_magicWord),
-         ACCESS_BARE_METAL
-   );
-
-   if ( ERR_NONE != status ) {
+   /* Mounting has to read the EEPROM which an AO can't wait for */
+   if ( ACCESS_QPC == accessType ) {
+      status = ERR_DB_WRONG_ACCESS_TYPE;
       goto DB_isValid_ERR_HANDLE;          /* Stop and jump to error handling */
-   } else {
-      if ( db_magicWord != DB_MAGIC_WORD_DEF ) {
-         wrn_slow_printf(
-               "Magic word in DB (0x%08x) doesn't match expected (0x%08x)\n",
-               db_magicWord,
-               DB_MAGIC_WORD_DEF
-         );
-         return( ERR_DB_NOT_INIT);
-      }
    }
 
-   uint16_t db_version = 0;
-   status = DB_getElemBLK(
-         DB_VERSION,
-         (uint8_t *)&db_version,
-         sizeof(db_version),
-         ACCESS_BARE_METAL
-   );
-
+   status = DB_lock( accessType, (QActive *)NULL, 0 );
    if ( ERR_NONE != status ) {
       goto DB_isValid_ERR_HANDLE;          /* Stop and jump to error handling */
-   } else {
-      if ( db_version != DB_VERSION_DEF ) {
+   }
 
-         wrn_slow_printf(
-               "DB version in EEPROM (0x%04x) doesn't match expected (0x%04x)\n",
-               db_version,
-               DB_VERSION_DEF
-         );
-         return( ERR_DB_VER_MISMATCH);
-      }
+   if ( !DB_journal.isMounted ) {
+      status = DB_mount();
+   }
+   DB_unlock();
+
+   if ( ERR_DB_NOT_INIT == status ) {
+      DB_WRN_OUTPUT(
+            accessType,
+            "No settings journal or DB version 0x%04x found in EEPROM\n",
+            DB_LEGACY_VERSION
+      );
+      return( status );
    }
 
 DB_isValid_ERR_HANDLE:      /* Handle any error that may have occurred. */
@@ -189,58 +808,22 @@ CBErrorCode DB_initToDefault( AccessType_t accessType )
 {
    CBErrorCode status = ERR_NONE;            /* keep track of success/failure */
 
-   switch( accessType ) {
-      case ACCESS_BARE_METAL:
-         status = DB_setElemBLK(
-               DB_MAGIC_WORD,
-               (uint8_t *)&DB_defaultEeepromSettings.dbMagicWord,
-               sizeof(DB_defaultEeepromSettings.dbMagicWord),
-               accessType
-         );
-         if ( ERR_NONE != status ) {
-            goto DB_initToDefault_ERR_HANDLE;
-         }
-
-         status = DB_setElemBLK(
-               DB_VERSION,
-               (uint8_t *)&DB_defaultEeepromSettings.dbVersion,
-               sizeof(DB_defaultEeepromSettings.dbVersion),
-               accessType
-         );
-         if ( ERR_NONE != status ) {
-            goto DB_initToDefault_ERR_HANDLE;
-         }
-
-         status = DB_setElemBLK(
-               DB_IP_ADDR,
-               (uint8_t *)&DB_defaultEeepromSettings.ipAddr,
-               sizeof(DB_defaultEeepromSettings.ipAddr),
-               accessType
-         );
-         if ( ERR_NONE != status ) {
-            goto DB_initToDefault_ERR_HANDLE;
-         }
-
-         break;                              /* end of case ACCESS_BARE_METAL */
-
-      case ACCESS_QPC:
-         status = ERR_UNIMPLEMENTED;
-         goto DB_initToDefault_ERR_HANDLE; /* Stop and jump to error handling */
-         break;                                     /* end of case ACCESS_QPC */
-
-      case  ACCESS_FREERTOS:
-         status = ERR_UNIMPLEMENTED;
-         goto DB_initToDefault_ERR_HANDLE; /* Stop and jump to error handling */
-         break;                                /* end of case ACCESS_FREERTOS */
+   /* An AO would have nowhere to get the results of the writes from */
+   if ( ACCESS_QPC == accessType ) {
+      status = ERR_DB_WRONG_ACCESS_TYPE;
+      goto DB_initToDefault_ERR_HANDLE;    /* Stop and jump to error handling */
+   }
 
-      default:
-         status = ERR_UNIMPLEMENTED;
-         goto DB_initToDefault_ERR_HANDLE; /* Stop and jump to error handling */
-         break;                                        /* end of default case */
+   /* Starts a new bank with every element at its default */
+   status = DB_lock( accessType, (QActive *)NULL, 0 );
+   if ( ERR_NONE != status ) {
+      goto DB_initToDefault_ERR_HANDLE;    /* Stop and jump to error handling */
+   }
 
-   }                                               /* End of switch statement */
+   status = DBJ_format( &DB_journal, &DB_journalCfg, NULL, 0 );
+   DB_unlock();
 
-DB_initToDefault_ERR_HANDLE:      /* Handle any error that may have occurred. */
+DB_initToDefault_ERR_HANDLE:  /* Handle any error that may have occurred. */
    ERR_COND_OUTPUT(
          status,
          accessType,
@@ -258,60 +841,26 @@ CBErrorCode DB_getElemBLK(
       AccessType_t accessType
 )
 {
-   CBErrorCode status = ERR_NONE;            /* keep track of success/failure */
+   DB_ElemBuf_t elemBuf = { elem, pBuffer, bufSize };
+   uint8_t nRuns = 0;
 
-   /* 1. Sanity checks of buffer sizes and memory allocations. */
-   if ( bufSize < settingsDB[elem].size ) {
-      status = ERR_MEM_BUFFER_LEN;
-      goto DB_getElemBLK_ERR_HANDLE;       /* Stop and jump to error handling */
-   }
-
-   if ( NULL == pBuffer ) {
-      status = ERR_MEM_NULL_VALUE;
-      goto DB_getElemBLK_ERR_HANDLE;       /* Stop and jump to error handling */
-   }
-
-   /* 2. Find where the element lives */
-   DB_ElemLoc_t loc = settingsDB[elem].loc;
-
-   /* 3. Call the location dependent functions to retrieve the data from DB */
-   switch( loc ) {
-      case DB_EEPROM:                           /* Intentionally fall through */
-      case DB_SN_ROM:                           /* Intentionally fall through */
-      case DB_UI_ROM:
-         status = I2C_readDevMemBLK(
-               DB_I2C_devices[loc],          // I2C_Dev_t iDev,
-               settingsDB[elem].offset,      // uint16_t offset,
-               settingsDB[elem].size,        // uint16_t bytesToRead,
-               accessType,                   // AccessType_t accType,
-               pBuffer,                      // uint8_t* pBuffer,
-               bufSize                       // uint8_t  bufSize
-         );
-         break;
-      case DB_GPIO:
-         status = ERR_UNIMPLEMENTED;
-         goto DB_getElemBLK_ERR_HANDLE;    /* Stop and jump to error handling */
-         break;
-      case DB_FLASH:
-         status = ERR_UNIMPLEMENTED;
-         goto DB_getElemBLK_ERR_HANDLE;    /* Stop and jump to error handling */
-         break;
-         /* Add more locations here. Anything that fails will go to the default
-          * case and get logged as an error. */
-      default:
-         status = ERR_DB_ELEM_NOT_FOUND;
-         goto DB_getElemBLK_ERR_HANDLE;    /* Stop and jump to error handling */
-         break;
-   }
+   CBErrorCode status = DB_xferBatch(
+         &elemBuf,
+         1,
+         false,
+         accessType,
+         (QActive *)NULL,
+         0,
+         &nRuns
+   );
 
-DB_getElemBLK_ERR_HANDLE:         /* Handle any error that may have occurred. */
    ERR_COND_OUTPUT(
          status,
          accessType,
          "Error 0x%08x getting element %s (%d) from DB\n",
+         status,
          DB_elemToStr( elem ),
-         elem,
-         status
+         elem
    );
    return( status );
 }
@@ -324,61 +873,273 @@ CBErrorCode DB_setElemBLK(
       AccessType_t accessType
 )
 {
-   CBErrorCode status = ERR_NONE; /* keep track of success/failure of operations. */
+   DB_ElemBuf_t elemBuf = { elem, pBuffer, bufSize };
+   uint8_t nRuns = 0;
 
-   /* 1. Sanity checks of buffer sizes and memory allocations. */
-   if ( bufSize > settingsDB[elem].size ) {
-      status = ERR_MEM_BUFFER_LEN;
-      goto DB_getElemBLK_ERR_HANDLE;       /* Stop and jump to error handling */
+   CBErrorCode status = ( ACCESS_QPC == accessType ) ? ERR_DB_WRONG_ACCESS_TYPE :
+         DB_xferBatch(
+               &elemBuf,
+               1,
+               true,
+               accessType,
+               (QActive *)NULL,
+               0,
+               &nRuns
+         );
+
+   ERR_COND_OUTPUT(
+         status,
+         accessType,
+         "Error 0x%08x setting element %s (%d) to DB\n",
+         status,
+         DB_elemToStr( elem ),
+         elem
+   );
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode DB_getElemsBLK(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      AccessType_t accessType
+)
+{
+   uint8_t nRuns = 0;
+
+   CBErrorCode status = DB_xferBatch(
+         elems,
+         nElems,
+         false,
+         accessType,
+         (QActive *)NULL,
+         0,
+         &nRuns
+   );
+
+   ERR_COND_OUTPUT(
+         status,
+         accessType,
+         "Error 0x%08x getting %d elements from DB\n",
+         status,
+         nElems
+   );
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode DB_setElemsBLK(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      AccessType_t accessType
+)
+{
+   uint8_t nRuns = 0;
+
+   CBErrorCode status = ( ACCESS_QPC == accessType ) ? ERR_DB_WRONG_ACCESS_TYPE :
+         DB_xferBatch(
+               elems,
+               nElems,
+               true,
+               accessType,
+               (QActive *)NULL,
+               0,
+               &nRuns
+         );
+
+   ERR_COND_OUTPUT(
+         status,
+         accessType,
+         "Error 0x%08x setting %d elements to DB\n",
+         status,
+         nElems
+   );
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode DB_getElemEVT(
+      DB_Elem_t elem,
+      QActive *callingAO,
+      uint16_t tag
+)
+{
+   CBErrorCode status = ERR_NONE;            /* keep track of success/failure */
+
+   if ( (uint32_t)elem >= DB_MAX_ELEM ) {
+      status = ERR_DB_ELEM_NOT_FOUND;
+      goto DB_getElemEVT_ERR_HANDLE;       /* Stop and jump to error handling */
    }
 
-   if ( NULL == pBuffer ) {
-      status = ERR_MEM_NULL_VALUE;
-      goto DB_getElemBLK_ERR_HANDLE;       /* Stop and jump to error handling */
+   if ( DB_GPIO == settingsDB[elem].loc || DB_FLASH == settingsDB[elem].loc ) {
+      status = ERR_UNIMPLEMENTED;
+      goto DB_getElemEVT_ERR_HANDLE;       /* Stop and jump to error handling */
    }
 
-   /* 2. Find where the element lives */
-   DB_ElemLoc_t loc = settingsDB[elem].loc;
+   if ( DB_JOURNAL_HDR == settingsDB[elem].loc ) {
+      if ( !DB_journal.isMounted ) {
+         status = ERR_DB_NOT_INIT;
+         goto DB_getElemEVT_ERR_HANDLE;    /* Stop and jump to error handling */
+      }
 
-   /* 3. Call the location dependent functions to write the data to DB */
-   switch( loc ) {
-      case DB_EEPROM:
-         status = I2C_writeDevMemBLK(
-               DB_I2C_devices[loc],                // I2C_Dev_t iDev,
-               settingsDB[elem].offset,            // uint16_t offset,
-               settingsDB[elem].size,              // uint16_t bytesToWrite,
-               accessType,                         // AccessType_t accType,
-               pBuffer,                            // uint8_t* pBuffer,
-               bufSize                             // uint8_t  bufSize
-         );
-         break;
-      case DB_SN_ROM:                           /* Fall through intentionally */
-      case DB_UI_ROM:                           /* Fall through intentionally */
-      case DB_GPIO:                             /* Fall through intentionally */
-      case DB_FLASH:                            /* Fall through intentionally */
-         status = ERR_DB_ELEM_IS_READ_ONLY;
-         goto DB_getElemBLK_ERR_HANDLE;
-         break;
-         /* Add more locations here. Anything that fails will go to the default
-          * case and get logged as an error. */
-      default:
-         status = ERR_DB_ELEM_NOT_FOUND;
-         goto DB_getElemBLK_ERR_HANDLE;
-         break;
+      /* Already in RAM.  Reply the same way the I2CDevMgr AO would. */
+      I2CReadDoneEvt *i2cReadDoneEvt = Q_NEW(I2CReadDoneEvt, I2C_DEV_READ_DONE_SIG);
+      i2cReadDoneEvt->status = ERR_NONE;
+      i2cReadDoneEvt->bytes  = settingsDB[elem].size;
+      i2cReadDoneEvt->i2cDev = DB_I2C_devices[DB_EEPROM];
+      i2cReadDoneEvt->tag    = tag;
+      i2cReadDoneEvt->pBuf   = NULL;
+      DB_getHdrElem( elem, i2cReadDoneEvt->dataBuf );
+      if ( (QActive *)0 != callingAO ) {
+         QACTIVE_POST(callingAO, (QEvt *)i2cReadDoneEvt, callingAO);
+      } else {
+         QF_gc((QEvt *)i2cReadDoneEvt);            /* Nobody to give it to */
+      }
+      goto DB_getElemEVT_ERR_HANDLE;         /* Nothing left to do.  Not an error */
    }
 
-DB_getElemBLK_ERR_HANDLE:         /* Handle any error that may have occurred. */
+   uint16_t offset = settingsDB[elem].offset;
+   if ( DB_EEPROM == settingsDB[elem].loc ) {
+      status = DB_lock( ACCESS_QPC, callingAO, tag );
+      if ( ERR_NONE != status ) {
+         goto DB_getElemEVT_ERR_HANDLE;    /* Stop and jump to error handling */
+      }
+
+      status = DBJ_locate( &DB_journal, (uint8_t)elem, &offset );
+      DB_unlock();
+      if ( ERR_NONE != status ) {
+         goto DB_getElemEVT_ERR_HANDLE;    /* Stop and jump to error handling */
+      }
+   }
+
+   /* Every element fits in the reply event so there is no buffer to keep */
+   status = I2C_readDevMemEVT(
+         DB_I2C_devices[settingsDB[elem].loc], // I2C_Dev_t iDev,
+         offset,                               // uint16_t offset,
+         settingsDB[elem].size,                // uint16_t bytesToRead,
+         ACCESS_QPC,                           // AccessType_t accType,
+         callingAO,                            // QActive* callingAO
+         NULL,                                 // uint8_t *pBuffer
+         tag                                   // uint16_t tag
+   );
+
+DB_getElemEVT_ERR_HANDLE:         /* Handle any error that may have occurred. */
    ERR_COND_OUTPUT(
          status,
-         accessType,
-         "Error 0x%08x setting element %s (%d) to DB\n",
+         ACCESS_QPC,
+         "Error 0x%08x requesting element %s (%d) from DB\n",
+         status,
          DB_elemToStr( elem ),
-         elem,
+         elem
+   );
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode DB_setElemsEVT(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      QActive *callingAO,
+      uint16_t tag,
+      uint8_t *pnReplies
+)
+{
+   CBErrorCode status = DB_xferBatch(
+         elems,
+         nElems,
+         true,
+         ACCESS_QPC,
+         callingAO,
+         tag,
+         pnReplies
+   );
+
+   ERR_COND_OUTPUT(
+         status,
+         ACCESS_QPC,
+         "Error 0x%08x requesting %d elements to be set in DB\n",
+         status,
+         nElems
+   );
+   return( status );
+}
+
+/******************************************************************************/
+void DB_onWriteDoneEVT( CBErrorCode status )
+{
+   /* Only the AO holding the lock gets the replies.  Ignore anything else. */
+   if ( !DB_isBusy || ACCESS_QPC != DB_io.accessType ||
+         0 == DB_io.nRepliesLeft ) {
+      return;
+   }
+
+   if ( ERR_NONE != status ) {
+      DB_io.isWriteOk = false;
+   }
+
+   if ( 0 == --DB_io.nRepliesLeft ) {
+      DBJ_commit( &DB_journal, DB_io.isWriteOk );
+      DB_unlock();
+   }
+}
+
+/******************************************************************************/
+CBErrorCode DB_maintain( AccessType_t accessType )
+{
+   CBErrorCode status = ERR_NONE;            /* keep track of success/failure */
+
+   /* Compacting reads the active bank which an AO can't wait for */
+   if ( ACCESS_QPC == accessType ) {
+      status = ERR_DB_WRONG_ACCESS_TYPE;
+      goto DB_maintain_ERR_HANDLE;         /* Stop and jump to error handling */
+   }
+
+   /* Cheap check first so the lock is only taken when there is work to do */
+   if ( !DBJ_needsCompact( &DB_journal ) ) {
+      return( ERR_NONE );
+   }
+
+   status = DB_lock( accessType, (QActive *)NULL, 0 );
+   if ( ERR_NONE != status ) {
+      goto DB_maintain_ERR_HANDLE;         /* Stop and jump to error handling */
+   }
+
+   if ( DBJ_needsCompact( &DB_journal ) ) {
+      status = DBJ_compact( &DB_journal );
+   }
+   DB_unlock();
+
+DB_maintain_ERR_HANDLE:     /* Handle any error that may have occurred. */
+   ERR_COND_OUTPUT(
+         status,
+         accessType,
+         "Error 0x%08x compacting the settings DB\n",
          status
    );
    return( status );
 }
 
+/******************************************************************************/
+const DBJ_Stats_t *DB_getStats( void )
+{
+   return( &DB_journal.stats );
+}
+
+#ifdef DB_HOST_LAYOUT
+/******************************************************************************/
+void DB_hostPlaceElem(
+      DB_Elem_t elem,
+      DB_Elem_t sameDevAs,
+      uint16_t offset,
+      size_t size
+)
+{
+   settingsDB[elem].loc    = settingsDB[sameDevAs].loc;
+   settingsDB[elem].offset = offset;
+   settingsDB[elem].size   = size;
+}
+#endif                                                      /* DB_HOST_LAYOUT */
+
 /**
  * @}
  * end addtogroup groupSettings
@@ -7,7 +7,19 @@
  * implementation abstracts away the ability to locate and size the different
  * elements in the different sections of the EEPROM as well as other locations.
  * (See Note). It also provides interfaces to allow DB access using blocking
- * (bare metal) and non-blocking (QP event based).
+ * (bare metal), blocking with a timeout (FreeRTOS threads), and non-blocking
+ * (QP event based).
+ *
+ * Several elements can be read or written with one call.  Elements that sit
+ * next to each other on the same I2C device are then read or written with a
+ * single I2C transaction instead of one per element.
+ *
+ * The writable settings in the main EEPROM are kept in a journal (see
+ * db_journal.h) instead of at fixed offsets.  Every write appends a record so
+ * the wear is spread over the whole EEPROM, and a write that is cut short by
+ * a power loss leaves the previous value in place.  DB_maintain() moves the
+ * latest values into a fresh bank when the active one runs low.  The fixed
+ * layout of older FW is moved into the journal the first time it's mounted.
  *
  * The database consists of a structure that maps all the different types to a
  * memory location in memory and allows non-linear access to read/update the
@@ -36,7 +48,14 @@
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#include "qp_port.h"                                        /* for QP support */
+#include "db_journal.h"                                   /* for DBJ_Stats_t */
+
 /* Exported defines ----------------------------------------------------------*/
+
+/**< Most elements that can be read or written with a single call */
+#define DB_MAX_BATCH_ELEMS                                                    8
+
 /* Exported macros -----------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
 /**
@@ -53,12 +72,22 @@ typedef enum DB_Elements {
    DB_SN,                  /**< Serial number stored in the special SN section
                                 of RO EEPROM */
 
-   /* Add more elements here.  If adding elements after code is released, bump
-    * the DB_VERSION up. */
+   /* Add more elements here.  If an element is added to the main EEPROM after
+    * code is released, bump DB_VERSION_DEF up so the journal is rewritten with
+    * it on the next boot. */
 
    DB_MAX_ELEM   /**< Max number of elements that can be stored.  ALWAYS LAST */
 } DB_Elem_t;
 
+/**
+ * One element of a batched DB access and the caller's buffer for it.
+ */
+typedef struct DB_ElemBufs {
+   DB_Elem_t    elem;                /**< Which element to read or write */
+   uint8_t  *pBuffer;   /**< Where to read the element to or write it from */
+   size_t    bufSize;                          /**< Size of the pBuffer */
+} DB_ElemBuf_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
 /**
@@ -78,17 +107,26 @@ char* DB_elemToStr( DB_Elem_t elem );
 /**
  * @brief   Check if Settings DB in EEPROM is valid.
  *
- * This function checks for a magic number at the beginning of the EEPROM and
- * the version to see if they match what's expected.
+ * This function mounts the settings journal in EEPROM if it isn't mounted
+ * yet.  A journal written with an older DB_VERSION is rewritten with the
+ * current elements, and an EEPROM that still has the fixed layout of older FW
+ * is moved into a new journal.
+ *
+ * Mounting reads the header of every bank of the journal and then the whole
+ * active bank, one I2C read each.  Once mounted, this doesn't touch the bus.
  *
  * @param  [in] accessType: AccessType_t that specifies how the function is being
  * accessed.
  *    @arg ACCESS_BARE_METAL: blocking access that is slow.  Don't use once the
  *                            RTOS is running.
- *    @arg ACCESS_QPC:        non-blocking, event based access.
- *    @arg ACCESS_FREERTOS:   non-blocking, but waits on queue to know the status.
+ *    @arg ACCESS_FREERTOS:   blocks the calling thread until the I2CDevMgr AO
+ *                            replies or HL_MAX_TOUT_SEC_I2C_FRT_WAIT runs out.
  * @return CBErrorCode: status of the read operation
  *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_DB_NOT_INIT: there is no DB.  Call DB_initToDefault().
+ *    @arg ERR_DB_WRONG_ACCESS_TYPE: called with ACCESS_QPC.  AOs should read
+ *    DB_MAGIC_WORD and DB_VERSION with DB_getElemEVT() instead.
+ *    @arg ERR_DB_BUSY: another caller held on to the DB for too long.
  *    other errors if found.
  */
 CBErrorCode DB_isValid( AccessType_t accessType );
@@ -97,16 +135,29 @@ CBErrorCode DB_isValid( AccessType_t accessType );
  * @brief   Initialize the settings DB in EEPROM to a stored default.
  *
  * This function initializes the settings DB in EEPROM to a stored default.
- * This should only happen if it is found to be invalid by DB_isValid().
+ * This should only happen if it is found to be invalid by DB_isValid().  The
+ * default is written into the next bank of the journal with two I2C writes,
+ * all the records with one and the header after them with the other, so it
+ * only takes over once the header is written.
+ *
+ * @note: AOs can't reset the DB.  The journal only takes the new bank once
+ * both writes are back, and there is no AO or tag to send them to and no
+ * DB_onWriteDoneEVT() for a format.  An AO that finds the DB invalid with
+ * DB_getElemEVT() has to leave it to a FreeRTOS thread, the way CPLR does it
+ * at startup, or put the elements it needs back with DB_setElemsEVT().
  *
  * @param  [in] accessType: AccessType_t that specifies how the function is being
  * accessed.
  *    @arg ACCESS_BARE_METAL: blocking access that is slow.  Don't use once the
  *                            RTOS is running.
- *    @arg ACCESS_QPC:        non-blocking, event based access.
- *    @arg ACCESS_FREERTOS:   non-blocking, but waits on queue to know the status.
+ *    @arg ACCESS_QPC:        not supported.  See the note above.  Returns
+ *                            ERR_DB_WRONG_ACCESS_TYPE.
+ *    @arg ACCESS_FREERTOS:   blocks the calling thread until the I2CDevMgr AO
+ *                            replies or HL_MAX_TOUT_SEC_I2C_FRT_WAIT runs out.
  * @return CBErrorCode: status of the read operation
  *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_DB_BUSY: the DB is in use by another caller.
+ *    @arg ERR_DB_WRONG_ACCESS_TYPE: called with ACCESS_QPC.
  *    other errors if found.
  */
 CBErrorCode DB_initToDefault( AccessType_t accessType  );
@@ -130,10 +181,12 @@ CBErrorCode DB_initToDefault( AccessType_t accessType  );
  * accessed.
  *    @arg ACCESS_BARE_METAL: blocking access that is slow.  Don't use once the
  *                            RTOS is running.
- *    @arg ACCESS_QPC:        non-blocking, event based access.
- *    @arg ACCESS_FREERTOS:   non-blocking, but waits on queue to know the status.
+ *    @arg ACCESS_FREERTOS:   blocks the calling thread until the I2CDevMgr AO
+ *                            replies or HL_MAX_TOUT_SEC_I2C_FRT_WAIT runs out.
  * @return CBErrorCode: status of the read operation
  *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_DB_WRONG_ACCESS_TYPE: called with ACCESS_QPC.  AOs should use
+ *    DB_getElemEVT() instead.
  *    other errors if found.
  */
 CBErrorCode DB_getElemBLK(
@@ -158,15 +211,18 @@ CBErrorCode DB_getElemBLK(
  *
  * @param  [in] *pBuffer: uint8_t pointer to a buffer where to element to be set
  *                         is.
- * @param  [in] bufSize: size of the pBuffer.
+ * @param  [in] bufSize: size of the pBuffer.  Must be at least the size of the
+ *                       element.
  * @param  [in] accessType: AccessType_t that specifies how the function is being
  * accessed.
  *    @arg ACCESS_BARE_METAL: blocking access that is slow.  Don't use once the
  *                            RTOS is running.
- *    @arg ACCESS_QPC:        non-blocking, event based access.
- *    @arg ACCESS_FREERTOS:   non-blocking, but waits on queue to know the status.
- * @return CBErrorCode: status of the read operation
+ *    @arg ACCESS_FREERTOS:   blocks the calling thread until the I2CDevMgr AO
+ *                            replies or HL_MAX_TOUT_SEC_I2C_FRT_WAIT runs out.
+ * @return CBErrorCode: status of the write operation
  *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_DB_WRONG_ACCESS_TYPE: called with ACCESS_QPC.  AOs should use
+ *    DB_setElemEVT() instead.
  *    other errors if found.
  */
 CBErrorCode DB_setElemBLK(
@@ -176,6 +232,189 @@ CBErrorCode DB_setElemBLK(
       AccessType_t accessType
 );
 
+/**
+ * @brief   Get several elements from the settings DB.
+ *
+ * Elements that are next to each other on the same I2C device (or close enough
+ * that reading the gap is cheaper than another transaction) are read with a
+ * single I2C transaction.  The order of the elements doesn't matter.
+ *
+ * @param  [in,out] *elems: DB_ElemBuf_t array of the elements to get and the
+ *                          buffers where to store them.
+ * @param  [in] nElems: uint8_t number of elements in *elems.  At most
+ *                      DB_MAX_BATCH_ELEMS.
+ * @param  [in] accessType: AccessType_t that specifies how the function is being
+ * accessed.
+ *    @arg ACCESS_BARE_METAL: blocking access that is slow.  Don't use once the
+ *                            RTOS is running.
+ *    @arg ACCESS_FREERTOS:   blocks the calling thread until the I2CDevMgr AO
+ *                            replies or HL_MAX_TOUT_SEC_I2C_FRT_WAIT runs out.
+ * @return CBErrorCode: status of the read operation
+ *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_DB_WRONG_ACCESS_TYPE: called with ACCESS_QPC.
+ *    other errors if found.  Nothing is read if any of the elements is bad.
+ */
+CBErrorCode DB_getElemsBLK(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      AccessType_t accessType
+);
+
+/**
+ * @brief   Set several elements in the settings DB.
+ *
+ * All the elements are appended to the journal with a single I2C transaction.
+ * If the active bank is full, it is compacted first.
+ *
+ * @param  [in] *elems: DB_ElemBuf_t array of the elements to set and the
+ *                      buffers that hold their new values.
+ * @param  [in] nElems: uint8_t number of elements in *elems.  At most
+ *                      DB_MAX_BATCH_ELEMS.
+ * @param  [in] accessType: AccessType_t that specifies how the function is being
+ * accessed.
+ *    @arg ACCESS_BARE_METAL: blocking access that is slow.  Don't use once the
+ *                            RTOS is running.
+ *    @arg ACCESS_FREERTOS:   blocks the calling thread until the I2CDevMgr AO
+ *                            replies or HL_MAX_TOUT_SEC_I2C_FRT_WAIT runs out.
+ * @return CBErrorCode: status of the write operation
+ *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_DB_WRONG_ACCESS_TYPE: called with ACCESS_QPC.  AOs should use
+ *    DB_setElemsEVT() instead.
+ *    other errors if found.  Nothing is written if any of the elements is bad.
+ */
+CBErrorCode DB_setElemsBLK(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      AccessType_t accessType
+);
+
+/**
+ * @brief   Request an element from the settings DB from an AO.
+ *
+ * This function is non-blocking and instantly returns.  The element comes
+ * back in the dataBuf of an I2C_DEV_READ_DONE event which is posted to
+ * *callingAO with the given tag.
+ *
+ * @param  [in] elem: DB_Elem_t that specifies what element to retrieve.
+ *    @arg DB_MAGIC_WORD: only used to validate that the DB even exists.
+ *    @arg DB_VERSION: version of the DB.  To be used for future upgrades.
+ *    @arg DB_MAC_ADDR: MAC address stored in the RO part of DB.
+ *    @arg DB_IP_ADDR: IP address stored in the RW part of DB.
+ *    @arg DB_SN: Serial number stored in the RO part of DB.
+ * @param  [in] *callingAO: QActive pointer to the AO that called this function.
+ * @param  [in] tag: uint16_t tag copied into the I2C_DEV_READ_DONE event.
+ * @return CBErrorCode: status of posting the request
+ *    @arg ERR_NONE: if no errors occurred
+ *    other errors if found.
+ */
+CBErrorCode DB_getElemEVT(
+      DB_Elem_t elem,
+      QActive *callingAO,
+      uint16_t tag
+);
+
+/**
+ * @brief   Request several elements to be set in the settings DB from an AO.
+ *
+ * This function is non-blocking and instantly returns.  All the elements are
+ * appended to the journal with as few I2C transactions as fit in the request
+ * events.  Each transaction comes back as an I2C_DEV_WRITE_DONE event which
+ * is posted to *callingAO with the given tag.  The buffers can be reused as soon as this
+ * function returns.
+ *
+ * The status of every one of those events has to be passed to
+ * DB_onWriteDoneEVT().  The new values only count once the last one is in
+ * and until then the DB stays busy.
+ *
+ * @param  [in] *elems: DB_ElemBuf_t array of the elements to set and the
+ *                      buffers that hold their new values.
+ * @param  [in] nElems: uint8_t number of elements in *elems.  At most
+ *                      DB_MAX_BATCH_ELEMS.
+ * @param  [in] *callingAO: QActive pointer to the AO that called this function.
+ * @param  [in] tag: uint16_t tag copied into the I2C_DEV_WRITE_DONE events.
+ * @param  [out] *pnReplies: uint8_t pointer to where to store how many
+ *                           I2C_DEV_WRITE_DONE events to expect.  Set even
+ *                           if an error is returned since the requests
+ *                           posted before the error still come back.
+ * @return CBErrorCode: status of posting the requests
+ *    @arg ERR_NONE: if no errors occurred
+ *    @arg ERR_DB_NO_SPACE: the active bank is full.  An AO can't compact it
+ *    so try again after DB_maintain() has run.
+ *    @arg ERR_DB_BUSY: the DB is in use by a FreeRTOS thread or the last
+ *    DB_setElemsEVT() isn't done yet.  Try again.
+ *    other errors if found.  Nothing is written if any of the elements is bad.
+ */
+CBErrorCode DB_setElemsEVT(
+      DB_ElemBuf_t const *elems,
+      uint8_t nElems,
+      QActive *callingAO,
+      uint16_t tag,
+      uint8_t *pnReplies
+);
+
+/**
+ * @brief   Tell the settings DB that one of the writes of DB_setElemsEVT()
+ * came back.
+ *
+ * Call it from the AO for every I2C_DEV_WRITE_DONE event with the tag given
+ * to DB_setElemsEVT().  Once the last one is in, the new values go into the
+ * index of the journal if every write worked, or are dropped if any failed,
+ * and the DB is free again.
+ *
+ * @param  [in] status: CBErrorCode status of the I2C_DEV_WRITE_DONE event.
+ * @return  None
+ */
+void DB_onWriteDoneEVT( CBErrorCode status );
+
+/**
+ * @brief   Compact the settings journal if it's running low on space.
+ *
+ * Copies the latest value of every element into the next bank of the journal.
+ * Meant to be called regularly from a FreeRTOS thread so that AOs, which
+ * can't compact, always find room to write.  Does nothing if there is enough
+ * space left.
+ *
+ * @param  [in] accessType: AccessType_t that specifies how the function is being
+ * accessed.
+ *    @arg ACCESS_BARE_METAL: blocking access that is slow.  Don't use once the
+ *                            RTOS is running.
+ *    @arg ACCESS_FREERTOS:   blocks the calling thread until the I2CDevMgr AO
+ *                            replies or HL_MAX_TOUT_SEC_I2C_FRT_WAIT runs out.
+ * @return CBErrorCode: status of the compaction
+ *    @arg ERR_NONE: if no errors occurred or there was nothing to do
+ *    @arg ERR_DB_WRONG_ACCESS_TYPE: called with ACCESS_QPC.
+ *    @arg ERR_DB_BUSY: the DB is in use by another caller.  Try again later.
+ *    other errors if found.
+ */
+CBErrorCode DB_maintain( AccessType_t accessType );
+
+/**
+ * @brief   Get the counters of the settings journal.
+ * @param   None
+ * @return  const DBJ_Stats_t pointer to the counters.
+ */
+const DBJ_Stats_t *DB_getStats( void );
+
+#ifdef DB_HOST_LAYOUT
+/**
+ * @brief   Move a DB element onto the same device as another one.  Only for
+ * host tests, to try the merging of reads with a layout the board doesn't
+ * have yet.
+ *
+ * @param  [in] elem: DB_Elem_t element to move.
+ * @param  [in] sameDevAs: DB_Elem_t element whose device to move it to.
+ * @param  [in] offset: uint16_t new offset of the element on that device.
+ * @param  [in] size: size_t new size of the element.
+ * @return  None
+ */
+void DB_hostPlaceElem(
+      DB_Elem_t elem,
+      DB_Elem_t sameDevAs,
+      uint16_t offset,
+      size_t size
+);
+#endif                                                      /* DB_HOST_LAYOUT */
+
 #ifdef __cplusplus
 }
 #endif
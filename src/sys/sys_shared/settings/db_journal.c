@@ -0,0 +1,542 @@
+/**
+ * @file   db_journal.c
+ * @brief  Definitions for the journaled key/length/value settings store.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupSettings
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "db_journal.h"
+#include "comm_frame.h"                          /* For CommFrame_crc16() */
+#include <string.h>
+
+/* Compile-time called macros ------------------------------------------------*/
+/* Private typedefs ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#define DBJ_MAGIC0                                                         'S'
+#define DBJ_MAGIC1                                                         'J'
+#define DBJ_CRC_INIT                                                    0xFFFF
+
+/**< Bytes in front of the value in a record */
+#define DBJ_REC_HDR_LEN                                                      3
+
+/**< rseq a bank never gets to so the one after its last record can't wrap */
+#define DBJ_RSEQ_LIMIT                                                    0xFF
+
+/* Private macros ------------------------------------------------------------*/
+
+/**< Address of the start of a bank */
+#define DBJ_BANK_ADDR( cfg, bank ) \
+   ( (uint16_t)( (cfg)->base + (uint16_t)(bank) * (cfg)->bankSize ) )
+
+/* Private variables and Local objects ---------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief   Check that a configuration can be used.
+ * @param [in] *cfg: const DBJ_Cfg_t pointer to the configuration.
+ * @return: bool true if it is good.
+ */
+static bool DBJ_isCfgValid( const DBJ_Cfg_t *cfg );
+
+/**
+ * @brief   Compute the crc of a record.
+ * @param [in] seq: uint32_t seq of the bank the record is in.
+ * @param [in] *rec: const uint8_t pointer to the start of the record.
+ * @return: uint16_t crc.
+ */
+static uint16_t DBJ_recCrc( uint32_t seq, const uint8_t *rec );
+
+/**
+ * @brief   Build a record.
+ * @param [out] *rec: uint8_t pointer to where to build it.
+ * @param [in] seq: uint32_t seq of the bank it goes into.
+ * @param [in] key: uint8_t key.
+ * @param [in] rseq: uint8_t rseq of the record.
+ * @param [in] *pVal: const uint8_t pointer to the value.
+ * @param [in] len: uint8_t length of the value.
+ * @return: uint16_t length of the record.
+ */
+static uint16_t DBJ_putRec(
+      uint8_t *rec,
+      uint32_t seq,
+      uint8_t key,
+      uint8_t rseq,
+      const uint8_t *pVal,
+      uint8_t len
+);
+
+/**
+ * @brief   Walk the records of the bank in me->old and build the index.
+ * @param [in,out] *me: DBJ_Store_t pointer to the store.
+ * @return: None
+ */
+static void DBJ_scan( DBJ_Store_t *me );
+
+/**
+ * @brief   Write every key into the next bank and make it the active one.
+ *
+ * @param [in,out] *me: DBJ_Store_t pointer to the store.
+ * @param [in] *cfg: const DBJ_Cfg_t pointer to the configuration.
+ * @param [in] *vals: const DBJ_Val_t array of values to use.  May be NULL.
+ * @param [in] nVals: uint8_t number of values.
+ * @param [in] keepCurrent: bool true to take the values that aren't given
+ * from the active bank, which must be in me->old.  false to use the defaults.
+ * @return: CBErrorCode ERR_NONE if the new bank is active.
+ */
+static CBErrorCode DBJ_rewrite(
+      DBJ_Store_t *me,
+      const DBJ_Cfg_t *cfg,
+      const DBJ_Val_t *vals,
+      uint8_t nVals,
+      bool keepCurrent
+);
+
+/**
+ * @brief   Check values against the key table.
+ * @param [in] *cfg: const DBJ_Cfg_t pointer to the configuration.
+ * @param [in] *vals: const DBJ_Val_t array of values.
+ * @param [in] nVals: uint8_t number of values.
+ * @return: uint16_t bytes the records of the values take or 0 if a value
+ * doesn't match the table.
+ */
+static uint16_t DBJ_checkVals(
+      const DBJ_Cfg_t *cfg,
+      const DBJ_Val_t *vals,
+      uint8_t nVals
+);
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static bool DBJ_isCfgValid( const DBJ_Cfg_t *cfg )
+{
+   if ( NULL == cfg || NULL == cfg->read || NULL == cfg->write ||
+         NULL == cfg->keys || cfg->nKeys > DBJ_MAX_KEYS ||
+         cfg->nBanks < 2 || cfg->nBanks > DBJ_MAX_BANKS ||
+         cfg->firstBank >= cfg->nBanks ||
+         cfg->bankSize <= DBJ_HDR_LEN || cfg->bankSize > DBJ_MAX_BANK_SIZE ) {
+      return( false );
+   }
+
+   for ( uint8_t key = 0; key < cfg->nKeys; key++ ) {
+      if ( cfg->keys[key].len > DBJ_MAX_VAL_LEN ||
+            ( 0 != cfg->keys[key].len && NULL == cfg->keys[key].pDefault ) ) {
+         return( false );
+      }
+   }
+   return( true );
+}
+
+/******************************************************************************/
+static uint16_t DBJ_recCrc( uint32_t seq, const uint8_t *rec )
+{
+   uint8_t seqBytes[4] = {
+         (uint8_t)seq, (uint8_t)(seq >> 8), (uint8_t)(seq >> 16), (uint8_t)(seq >> 24)
+   };
+   uint16_t crc = CommFrame_crc16( DBJ_CRC_INIT, seqBytes, sizeof(seqBytes) );
+   return( CommFrame_crc16( crc, rec, DBJ_REC_HDR_LEN + rec[1] ) );
+}
+
+/******************************************************************************/
+static uint16_t DBJ_putRec(
+      uint8_t *rec,
+      uint32_t seq,
+      uint8_t key,
+      uint8_t rseq,
+      const uint8_t *pVal,
+      uint8_t len
+)
+{
+   rec[0] = key;
+   rec[1] = len;
+   rec[2] = rseq;
+   memcpy( &rec[DBJ_REC_HDR_LEN], pVal, len );
+
+   uint16_t crc = DBJ_recCrc( seq, rec );
+   rec[DBJ_REC_HDR_LEN + len]     = (uint8_t)crc;
+   rec[DBJ_REC_HDR_LEN + len + 1] = (uint8_t)(crc >> 8);
+   return( DBJ_REC_OVERHEAD + len );
+}
+
+/******************************************************************************/
+static void DBJ_scan( DBJ_Store_t *me )
+{
+   const DBJ_Cfg_t *cfg = me->cfg;
+   uint16_t off = DBJ_HDR_LEN;
+   int16_t lastRseq = -1;
+
+   for ( uint8_t key = 0; key < DBJ_MAX_KEYS; key++ ) {
+      me->index[key] = DBJ_NO_REC;
+   }
+
+   /* The log ends at the first record that doesn't check out */
+   while ( off + DBJ_REC_OVERHEAD <= cfg->bankSize ) {
+      const uint8_t *rec = &me->old[off];
+      uint8_t len = rec[1];
+      if ( len > DBJ_MAX_VAL_LEN || off + DBJ_REC_OVERHEAD + len > cfg->bankSize ) {
+         break;
+      }
+
+      /* A failed append burns its rseqs, so anything it left behind further
+       * on is older than the record that replaced it. */
+      if ( (int16_t)rec[2] <= lastRseq ) {
+         break;
+      }
+
+      uint16_t crc = rec[DBJ_REC_HDR_LEN + len] |
+            ( rec[DBJ_REC_HDR_LEN + len + 1] << 8 );
+      if ( crc != DBJ_recCrc( me->seq, rec ) ) {
+         break;
+      }
+
+      /* Records of keys that are gone or changed size are skipped */
+      if ( rec[0] < cfg->nKeys && 0 != len && cfg->keys[rec[0]].len == len ) {
+         me->index[rec[0]] = off;
+      }
+      lastRseq = rec[2];
+      off += DBJ_REC_OVERHEAD + len;
+   }
+
+   me->tail = off;
+   me->rseq = (uint8_t)( lastRseq + 1 );
+}
+
+/******************************************************************************/
+static CBErrorCode DBJ_rewrite(
+      DBJ_Store_t *me,
+      const DBJ_Cfg_t *cfg,
+      const DBJ_Val_t *vals,
+      uint8_t nVals,
+      bool keepCurrent
+)
+{
+   uint8_t  bank = me->isMounted ? ( me->bank + 1 ) % cfg->nBanks : cfg->firstBank;
+   uint32_t seq  = me->isMounted ? me->seq + 1 : 1;
+   uint16_t index[DBJ_MAX_KEYS];
+   uint16_t off  = DBJ_HDR_LEN;
+   uint8_t  rseq = 0;
+
+   for ( uint8_t key = 0; key < DBJ_MAX_KEYS; key++ ) {
+      index[key] = DBJ_NO_REC;
+   }
+
+   for ( uint8_t key = 0; key < cfg->nKeys; key++ ) {
+      uint8_t len = cfg->keys[key].len;
+      if ( 0 == len ) {
+         continue;
+      }
+
+      const uint8_t *pVal = cfg->keys[key].pDefault;
+      if ( keepCurrent && DBJ_NO_REC != me->index[key] ) {
+         pVal = &me->old[me->index[key] + DBJ_REC_HDR_LEN];
+      }
+      for ( uint8_t i = 0; i < nVals; i++ ) {
+         if ( vals[i].key == key ) {
+            pVal = vals[i].pVal;
+         }
+      }
+
+      if ( off + DBJ_REC_OVERHEAD + len > cfg->bankSize ) {
+         return( ERR_DB_NO_SPACE );        /* The key table doesn't fit a bank */
+      }
+      index[key] = off;
+      off += DBJ_putRec( &me->img[off], seq, key, rseq++, pVal, len );
+   }
+
+   me->img[0] = DBJ_MAGIC0;
+   me->img[1] = DBJ_MAGIC1;
+   me->img[2] = (uint8_t)cfg->schema;
+   me->img[3] = (uint8_t)(cfg->schema >> 8);
+   me->img[4] = (uint8_t)seq;
+   me->img[5] = (uint8_t)(seq >> 8);
+   me->img[6] = (uint8_t)(seq >> 16);
+   me->img[7] = (uint8_t)(seq >> 24);
+   uint16_t crc = CommFrame_crc16( DBJ_CRC_INIT, me->img, DBJ_HDR_LEN - 2 );
+   me->img[8] = (uint8_t)crc;
+   me->img[9] = (uint8_t)(crc >> 8);
+
+   /* Records first and the header last.  Until the header is written, the old
+    * bank is still the active one. */
+   CBErrorCode status = ERR_NONE;
+   if ( off > DBJ_HDR_LEN ) {
+      status = cfg->write(
+            DBJ_BANK_ADDR( cfg, bank ) + DBJ_HDR_LEN,
+            &me->img[DBJ_HDR_LEN],
+            off - DBJ_HDR_LEN
+      );
+      if ( ERR_NONE != status ) {
+         return( status );
+      }
+   }
+
+   status = cfg->write( DBJ_BANK_ADDR( cfg, bank ), me->img, DBJ_HDR_LEN );
+   if ( ERR_NONE != status ) {
+      return( status );
+   }
+
+   me->cfg       = cfg;
+   me->isMounted = true;
+   me->bank      = bank;
+   me->schema    = cfg->schema;
+   me->seq       = seq;
+   me->tail      = off;
+   me->rseq      = rseq;
+   memcpy( me->index, index, sizeof(me->index) );
+   me->stats.nCompactions++;
+   me->stats.nBytesWritten += off;
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+static uint16_t DBJ_checkVals(
+      const DBJ_Cfg_t *cfg,
+      const DBJ_Val_t *vals,
+      uint8_t nVals
+)
+{
+   uint16_t total = 0;
+   for ( uint8_t i = 0; i < nVals; i++ ) {
+      if ( vals[i].key >= cfg->nKeys || 0 == vals[i].len ||
+            cfg->keys[vals[i].key].len != vals[i].len || NULL == vals[i].pVal ) {
+         return( 0 );
+      }
+      total += DBJ_REC_OVERHEAD + vals[i].len;
+   }
+   return( total );
+}
+
+/******************************************************************************/
+CBErrorCode DBJ_mount( DBJ_Store_t *me, const DBJ_Cfg_t *cfg )
+{
+   memset( me, 0, sizeof(*me) );
+   me->cfg = cfg;
+
+   if ( !DBJ_isCfgValid( cfg ) ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+
+   /* 1. The valid header with the highest seq marks the active bank */
+   bool isFound = false;
+   for ( uint8_t bank = 0; bank < cfg->nBanks; bank++ ) {
+      uint8_t hdr[DBJ_HDR_LEN];
+      CBErrorCode status = cfg->read( DBJ_BANK_ADDR( cfg, bank ), hdr, sizeof(hdr) );
+      if ( ERR_NONE != status ) {
+         return( status );
+      }
+
+      uint16_t crc = hdr[8] | ( hdr[9] << 8 );
+      if ( DBJ_MAGIC0 != hdr[0] || DBJ_MAGIC1 != hdr[1] ||
+            crc != CommFrame_crc16( DBJ_CRC_INIT, hdr, DBJ_HDR_LEN - 2 ) ) {
+         continue;
+      }
+
+      uint32_t seq = hdr[4] | ( hdr[5] << 8 ) | ( hdr[6] << 16 ) |
+            ( (uint32_t)hdr[7] << 24 );
+      if ( !isFound || (int32_t)( seq - me->seq ) > 0 ) {
+         isFound    = true;
+         me->bank   = bank;
+         me->seq    = seq;
+         me->schema = hdr[2] | ( hdr[3] << 8 );
+      }
+   }
+
+   if ( !isFound ) {
+      return( ERR_DB_NOT_INIT );
+   }
+
+   /* 2. Read the whole active bank at once and index it */
+   CBErrorCode status = cfg->read(
+         DBJ_BANK_ADDR( cfg, me->bank ),
+         me->old,
+         cfg->bankSize
+   );
+   if ( ERR_NONE != status ) {
+      return( status );
+   }
+   me->isMounted = true;
+   DBJ_scan( me );
+
+   /* 3. Bring a bank from another schema (or one missing a key) up to date */
+   bool isMissing = false;
+   for ( uint8_t key = 0; key < cfg->nKeys; key++ ) {
+      if ( 0 != cfg->keys[key].len && DBJ_NO_REC == me->index[key] ) {
+         isMissing = true;
+      }
+   }
+
+   if ( me->schema != cfg->schema || isMissing ) {
+      me->stats.nMigrations++;
+      status = DBJ_rewrite( me, cfg, NULL, 0, true );
+   }
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode DBJ_format(
+      DBJ_Store_t *me,
+      const DBJ_Cfg_t *cfg,
+      const DBJ_Val_t *vals,
+      uint8_t nVals
+)
+{
+   if ( !DBJ_isCfgValid( cfg ) ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+
+   if ( nVals > 0 && ( NULL == vals || 0 == DBJ_checkVals( cfg, vals, nVals ) ) ) {
+      return( ERR_DB_ELEM_NOT_FOUND );
+   }
+
+   if ( me->isPending ) {
+      return( ERR_DB_BUSY );
+   }
+
+   if ( me->isMounted && me->cfg != cfg ) {
+      me->isMounted = false;                /* Different store.  Start over */
+   }
+   return( DBJ_rewrite( me, cfg, vals, nVals, false ) );
+}
+
+/******************************************************************************/
+CBErrorCode DBJ_append( DBJ_Store_t *me, const DBJ_Val_t *vals, uint8_t nVals )
+{
+   CBErrorCode status = DBJ_appendAsync( me, vals, nVals );
+   if ( ERR_NONE == status ) {
+      DBJ_commit( me, true );
+   }
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode DBJ_appendAsync(
+      DBJ_Store_t *me,
+      const DBJ_Val_t *vals,
+      uint8_t nVals
+)
+{
+   if ( !me->isMounted ) {
+      return( ERR_DB_NOT_INIT );
+   }
+
+   if ( me->isPending ) {
+      return( ERR_DB_BUSY );
+   }
+
+   const DBJ_Cfg_t *cfg = me->cfg;
+   uint16_t total = ( NULL == vals ) ? 0 : DBJ_checkVals( cfg, vals, nVals );
+   if ( 0 == total ) {
+      return( ERR_DB_ELEM_NOT_FOUND );
+   }
+
+   if ( me->tail + total > cfg->bankSize || me->rseq + nVals > DBJ_RSEQ_LIMIT ) {
+      return( ERR_DB_NO_SPACE );
+   }
+
+   uint16_t off = 0;
+   uint8_t rseq = me->rseq;
+   for ( uint8_t i = 0; i < nVals; i++ ) {
+      off += DBJ_putRec( &me->img[off], me->seq, vals[i].key, rseq++,
+            vals[i].pVal, vals[i].len );
+      me->pendKeys[i] = vals[i].key;
+   }
+
+   CBErrorCode status = cfg->write(
+         DBJ_BANK_ADDR( cfg, me->bank ) + me->tail,
+         me->img,
+         off
+   );
+
+   /* The rseqs are used up even if the write fails.  The next records go
+    * in the same spot and anything left over after them must not count. */
+   me->rseq = rseq;
+   if ( ERR_NONE != status ) {
+      return( status );
+   }
+
+   me->isPending = true;
+   me->nPend     = nVals;
+   me->pendTail  = me->tail + off;
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+void DBJ_commit( DBJ_Store_t *me, bool isWritten )
+{
+   if ( !me->isPending ) {
+      return;
+   }
+   me->isPending = false;
+
+   if ( !isWritten ) {
+      return;
+   }
+
+   uint16_t off = me->tail;
+   for ( uint8_t i = 0; i < me->nPend; i++ ) {
+      uint8_t key = me->pendKeys[i];
+      me->index[key] = off;
+      off += DBJ_REC_OVERHEAD + me->cfg->keys[key].len;
+   }
+   me->stats.nAppends      += me->nPend;
+   me->stats.nBytesWritten += me->pendTail - me->tail;
+   me->tail = me->pendTail;
+}
+
+/******************************************************************************/
+CBErrorCode DBJ_compact( DBJ_Store_t *me )
+{
+   if ( !me->isMounted ) {
+      return( ERR_DB_NOT_INIT );
+   }
+
+   if ( me->isPending ) {
+      return( ERR_DB_BUSY );
+   }
+
+   CBErrorCode status = me->cfg->read(
+         DBJ_BANK_ADDR( me->cfg, me->bank ),
+         me->old,
+         me->cfg->bankSize
+   );
+   if ( ERR_NONE != status ) {
+      return( status );
+   }
+   return( DBJ_rewrite( me, me->cfg, NULL, 0, true ) );
+}
+
+/******************************************************************************/
+bool DBJ_needsCompact( const DBJ_Store_t *me )
+{
+   return( me->isMounted && !me->isPending &&
+         ( me->cfg->bankSize - me->tail < me->cfg->compactFree ||
+           me->rseq + DBJ_MAX_KEYS > DBJ_RSEQ_LIMIT ) );
+}
+
+/******************************************************************************/
+CBErrorCode DBJ_locate( const DBJ_Store_t *me, uint8_t key, uint16_t *pAddr )
+{
+   if ( !me->isMounted ) {
+      return( ERR_DB_NOT_INIT );
+   }
+
+   if ( key >= me->cfg->nKeys || DBJ_NO_REC == me->index[key] ) {
+      return( ERR_DB_ELEM_NOT_FOUND );
+   }
+
+   *pAddr = DBJ_BANK_ADDR( me->cfg, me->bank ) + me->index[key] + DBJ_REC_HDR_LEN;
+   return( ERR_NONE );
+}
+
+/**
+ * @}
+ * end addtogroup groupSettings
+ */
+
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,312 @@
+/**
+ * @file   db_journal.h
+ * @brief  Declarations for the journaled key/length/value settings store.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupSettings
+ * @{
+ *
+ * The store splits a memory into equal banks.  Only one bank is active at a
+ * time.  It starts with a header and is followed by records which are only
+ * ever appended:
+ *
+ *    header: | 'S' | 'J' | schema (2) | seq (4) | crc (2) |
+ *    record: | key (1) | len (1) | rseq (1) | value (len) | crc (2) |
+ *
+ *    - schema: version of the key table the bank was written with.
+ *    - seq: incremented every time a new bank is started.  The valid header
+ *      with the highest seq marks the active bank.  Compared the way serial
+ *      numbers are so it can wrap.
+ *    - rseq: incremented for every record in a bank.  It never wraps: a bank
+ *      that runs out of rseqs counts as full.
+ *    - crc: CRC-16/CCITT-FALSE.  A record's crc also covers the seq of its bank
+ *      so leftovers from an earlier use of the bank never look valid.
+ *
+ * Changing a value appends a new record.  The last record of a key wins.  When
+ * the bank runs low on space, the latest value of every key is copied into
+ * the next bank and that bank's header is written last.  The banks are used
+ * round robin so the wear is spread over the whole memory instead of hitting
+ * the same few bytes on every change.  Since nothing is ever erased, a torn
+ * write just ends the log early: the scan stops at the first record that
+ * doesn't check out and a torn bank change leaves the old bank active.
+ *
+ * Mounting reads the active bank once and builds an in-RAM index of where the
+ * latest value of each key is.  Lookups after that never scan the memory.
+ * When the write function only queues the data up, DBJ_appendAsync() leaves
+ * the index alone until DBJ_commit() says the data is really in the memory.
+ * If the bank was written with a different schema or a key is missing, the
+ * bank is rewritten right away with the current key table.  New keys get their
+ * default and keys that are gone are dropped.
+ *
+ * The memory is only accessed through the read and write functions given in
+ * the configuration.  This module has no hardware or RTOS dependencies and
+ * does no locking so it can be compiled on a host and tested against a
+ * simulated memory.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DB_JOURNAL_H_
+#define DB_JOURNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "CBErrors.h"
+
+/* Exported defines ----------------------------------------------------------*/
+#define DBJ_HDR_LEN                                                         10
+#define DBJ_REC_OVERHEAD                                                     5
+#define DBJ_MAX_KEYS                                                        16
+#define DBJ_MAX_VAL_LEN                                                     16
+#define DBJ_MAX_BANK_SIZE                                                  128
+#define DBJ_MAX_BANKS                                                        8
+
+/**< Index entry of a key that has no record in the active bank */
+#define DBJ_NO_REC                                                      0xFFFF
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief Function that reads the memory the store lives in.
+ * @param [in] addr: uint16_t address to read from.
+ * @param [out] *pBuf: uint8_t pointer to where to store the data.
+ * @param [in] len: uint16_t number of bytes to read.
+ * @return: CBErrorCode ERR_NONE if the data was read.
+ */
+typedef CBErrorCode (*DBJ_ReadFn)( uint16_t addr, uint8_t *pBuf, uint16_t len );
+
+/**
+ * @brief Function that writes the memory the store lives in.
+ * @param [in] addr: uint16_t address to write to.
+ * @param [in] *pBuf: const uint8_t pointer to the data.
+ * @param [in] len: uint16_t number of bytes to write.
+ * @return: CBErrorCode ERR_NONE if the data was written (or queued up to be).
+ */
+typedef CBErrorCode (*DBJ_WriteFn)( uint16_t addr, const uint8_t *pBuf, uint16_t len );
+
+/**
+ * \struct DBJ_Key_t
+ * Entry of the key table.  The key is the index of the entry.
+ */
+typedef struct DBJ_Keys
+{
+   uint8_t           len;        /**< Length of the value.  0 if not stored */
+   const uint8_t    *pDefault;        /**< Default value.  len bytes long */
+} DBJ_Key_t;
+
+/**
+ * \struct DBJ_Cfg_t
+ * Where the store lives and what goes in it.
+ */
+typedef struct DBJ_Cfgs
+{
+   DBJ_ReadFn        read;                       /**< Reads the memory */
+   DBJ_WriteFn       write;                     /**< Writes the memory */
+   uint16_t          base;                /**< Address of the first bank */
+   uint16_t          bankSize;  /**< Bytes per bank.  DBJ_MAX_BANK_SIZE max */
+   uint8_t           nBanks;                 /**< 2 to DBJ_MAX_BANKS banks */
+   uint8_t           firstBank;       /**< Bank to use when formatting an
+                                           empty memory */
+   uint16_t          compactFree;  /**< Compact when less free than this */
+   uint16_t          schema;           /**< Version of the key table below */
+   const DBJ_Key_t  *keys;                         /**< The key table */
+   uint8_t           nKeys;             /**< DBJ_MAX_KEYS entries at most */
+} DBJ_Cfg_t;
+
+/**
+ * \struct DBJ_Val_t
+ * A value to store under a key.
+ */
+typedef struct DBJ_Vals
+{
+   uint8_t           key;                         /**< Key to store it under */
+   const uint8_t    *pVal;                                   /**< The value */
+   uint8_t           len;   /**< Length of the value.  Must match the table */
+} DBJ_Val_t;
+
+/**
+ * \struct DBJ_Stats_t
+ * Counters of the store since it was mounted.
+ */
+typedef struct DBJ_Stats
+{
+   uint32_t nAppends;                           /**< Records appended */
+   uint32_t nCompactions;          /**< Banks started (incl. migrations) */
+   uint32_t nMigrations;      /**< Rewrites because of a schema change */
+   uint32_t nBytesWritten;               /**< Bytes sent to the memory */
+} DBJ_Stats_t;
+
+/**
+ * \struct DBJ_Store_t
+ * State of a mounted store.  Only touch it through the DBJ_ functions.
+ */
+typedef struct DBJ_Stores
+{
+   const DBJ_Cfg_t  *cfg;                            /**< Configuration */
+   bool              isMounted;        /**< true if a valid bank was found */
+   uint8_t           bank;                              /**< Active bank */
+   uint16_t          schema;          /**< Schema the bank was written with */
+   uint32_t          seq;                       /**< seq of the active bank */
+   uint16_t          tail;      /**< Offset in the bank of the first free byte */
+   uint8_t           rseq;                   /**< rseq of the next record */
+   uint16_t          index[DBJ_MAX_KEYS]; /**< Offset of each key's record */
+   bool              isPending;   /**< An append is waiting for DBJ_commit() */
+   uint16_t          pendTail;        /**< tail once the append is committed */
+   uint8_t           nPend;              /**< Records of the pending append */
+   uint8_t           pendKeys[DBJ_MAX_KEYS];    /**< Their keys, in order */
+   uint8_t           img[DBJ_MAX_BANK_SIZE];     /**< Bank being written */
+   uint8_t           old[DBJ_MAX_BANK_SIZE];        /**< Bank being read */
+   DBJ_Stats_t       stats;                                 /**< Counters */
+} DBJ_Store_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Find the active bank and build the index.
+ *
+ * If the active bank was written with another schema, or is missing a key,
+ * it is rewritten into the next bank right away.
+ *
+ * @param [out] *me: DBJ_Store_t pointer to the store.
+ * @param [in] *cfg: const DBJ_Cfg_t pointer to the configuration.  Must stay
+ * valid as long as the store is used.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the store is mounted.
+ *    @arg ERR_DB_NOT_INIT: there is no valid bank.  DBJ_format() has to be
+ *    called before the store can be used.
+ *    @arg ERR_MEM_BUFFER_LEN: bad configuration.
+ *    other errors from the read and write functions.
+ */
+CBErrorCode DBJ_mount( DBJ_Store_t *me, const DBJ_Cfg_t *cfg );
+
+/**
+ * @brief   Start a new bank that holds the given values.
+ *
+ * Keys that aren't given get their default.  Used to set up an empty memory
+ * and to move values over from somewhere else.  Writes the bank after the
+ * active one, or cfg->firstBank if nothing is mounted.
+ *
+ * @param [in,out] *me: DBJ_Store_t pointer to the store.
+ * @param [in] *cfg: const DBJ_Cfg_t pointer to the configuration.
+ * @param [in] *vals: const DBJ_Val_t array of values.  May be NULL.
+ * @param [in] nVals: uint8_t number of values.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the store is mounted and holds the values.
+ *    @arg ERR_DB_ELEM_NOT_FOUND: a key or length doesn't match the table.
+ *    @arg ERR_DB_BUSY: an append is still waiting for DBJ_commit().
+ *    other errors from the write function.  The store is left as it was.
+ */
+CBErrorCode DBJ_format(
+      DBJ_Store_t *me,
+      const DBJ_Cfg_t *cfg,
+      const DBJ_Val_t *vals,
+      uint8_t nVals
+);
+
+/**
+ * @brief   Append new values.
+ *
+ * All the records go out with a single call to the write function.  Same as
+ * DBJ_appendAsync() followed right away by DBJ_commit().
+ *
+ * @param [in,out] *me: DBJ_Store_t pointer to the store.
+ * @param [in] *vals: const DBJ_Val_t array of values.
+ * @param [in] nVals: uint8_t number of values.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the values were written.
+ *    @arg ERR_DB_NOT_INIT: the store isn't mounted.
+ *    @arg ERR_DB_ELEM_NOT_FOUND: a key or length doesn't match the table.
+ *    @arg ERR_DB_NO_SPACE: the records don't fit.  Call DBJ_compact() first.
+ *    @arg ERR_DB_BUSY: an append is still waiting for DBJ_commit().
+ *    other errors from the write function.  The index is left as it was.
+ */
+CBErrorCode DBJ_append( DBJ_Store_t *me, const DBJ_Val_t *vals, uint8_t nVals );
+
+/**
+ * @brief   Append new values with a write function that only queues the data.
+ *
+ * The records are handed to the write function but the index and the tail
+ * stay where they are, so lookups keep finding the old values, until
+ * DBJ_commit() is called.  Until then, appends and compactions get
+ * ERR_DB_BUSY.
+ *
+ * @param [in,out] *me: DBJ_Store_t pointer to the store.
+ * @param [in] *vals: const DBJ_Val_t array of values.
+ * @param [in] nVals: uint8_t number of values.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the records were queued.  DBJ_commit() has to follow.
+ *    other errors same as DBJ_append().  Nothing is pending.
+ */
+CBErrorCode DBJ_appendAsync(
+      DBJ_Store_t *me,
+      const DBJ_Val_t *vals,
+      uint8_t nVals
+);
+
+/**
+ * @brief   Finish the append started by DBJ_appendAsync().
+ *
+ * @param [in,out] *me: DBJ_Store_t pointer to the store.
+ * @param [in] isWritten: bool true if all the records made it into the
+ * memory.  false throws the append away.  The next one goes in the same spot
+ * and whatever part of this one did get written never counts.
+ * @return: None
+ */
+void DBJ_commit( DBJ_Store_t *me, bool isWritten );
+
+/**
+ * @brief   Copy the latest value of every key into the next bank.
+ *
+ * @param [in,out] *me: DBJ_Store_t pointer to the store.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the next bank is now the active one.
+ *    @arg ERR_DB_NOT_INIT: the store isn't mounted.
+ *    @arg ERR_DB_BUSY: an append is still waiting for DBJ_commit().
+ *    other errors from the read and write functions.  The store is left as
+ *    it was.
+ */
+CBErrorCode DBJ_compact( DBJ_Store_t *me );
+
+/**
+ * @brief   Check if the active bank is running low on space or rseqs.
+ * @param [in] *me: const DBJ_Store_t pointer to the store.
+ * @return: bool true if DBJ_compact() should be called.  Always false while
+ * an append is pending.
+ */
+bool DBJ_needsCompact( const DBJ_Store_t *me );
+
+/**
+ * @brief   Find where the latest value of a key is.
+ *
+ * @param [in] *me: const DBJ_Store_t pointer to the store.
+ * @param [in] key: uint8_t key.
+ * @param [out] *pAddr: uint16_t pointer to where to store the address of the
+ * value in the memory.
+ * @return: CBErrorCode
+ *    @arg ERR_NONE: the value is at *pAddr.
+ *    @arg ERR_DB_NOT_INIT: the store isn't mounted.
+ *    @arg ERR_DB_ELEM_NOT_FOUND: the key isn't in the table.
+ */
+CBErrorCode DBJ_locate( const DBJ_Store_t *me, uint8_t key, uint16_t *pAddr );
+
+/**
+ * @}
+ * end addtogroup groupSettings
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* DB_JOURNAL_H_ */
+/******** Copyright (C) 2014 Harry Rostovtsev. All rights reserved *****END OF FILE****/
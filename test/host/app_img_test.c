@@ -0,0 +1,325 @@
+/**
+ * @file   app_img_test.c
+ * @brief  Host test of the validation of the application image.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Runs app_img.c on an image in RAM with a software CRC32 that counts the
+ * bytes it goes over, so the test can tell a check of the head from a check
+ * of the whole image:
+ *
+ * - A 600000 byte image with a blank mark gets the full check and the mark to
+ *   write.  With that mark, the next boot only checks the head.
+ * - A stale mark (made for another size, crc or head) gets the full check and
+ *   isn't blank, so it can't be written over.
+ * - A size of 0, erased or past the end of flash, and a bad vector table, are
+ *   turned away without any crc.  A bad crc is caught by the full check.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "app_img.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define IMG_SIZE                600000
+#define SMALL_SIZE              512                 /**< Below the head */
+#define RESET_OFFSET            0x1C1               /**< Thumb Reset_Handler */
+#define FAR_OFFSET              500000              /**< Past the head */
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0xA991A6u;
+static uint32_t l_crcTable[256];
+static uint32_t l_nCrcCalls;
+static uint32_t l_nCrcBytes;
+
+static uint8_t *l_img;                      /**< APP_IMG_MAX_SIZE of flash */
+
+static const AppImgMark_t l_blank = {
+      APP_IMG_ERASED, APP_IMG_ERASED, APP_IMG_ERASED, APP_IMG_ERASED
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void crcInit( void )
+{
+   for ( uint32_t i = 0; i < 256; i++ ) {
+      uint32_t c = i;
+      for ( int k = 0; k < 8; k++ ) {
+         c = ( c & 1 ) ? 0xEDB88320u ^ ( c >> 1 ) : c >> 1;
+      }
+      l_crcTable[i] = c;
+   }
+}
+
+/**
+ * @brief   CRC32 the way zip computes it, counting what it's asked to do.
+ * @param [in] *data: const uint8_t pointer to the data.
+ * @param [in] len: uint32_t number of bytes.
+ * @return: uint32_t CRC32.
+ */
+static uint32_t crc32( const uint8_t *data, uint32_t len )
+{
+   uint32_t c = 0xFFFFFFFFu;
+
+   l_nCrcCalls++;
+   l_nCrcBytes += len;
+   for ( uint32_t i = 0; i < len; i++ ) {
+      c = l_crcTable[( c ^ data[i] ) & 0xFF] ^ ( c >> 8 );
+   }
+   return( c ^ 0xFFFFFFFFu );
+}
+
+/******************************************************************************/
+static void putWord( uint8_t *p, uint32_t v )
+{
+   p[0] = (uint8_t)v;
+   p[1] = (uint8_t)( v >> 8 );
+   p[2] = (uint8_t)( v >> 16 );
+   p[3] = (uint8_t)( v >> 24 );
+}
+
+/**
+ * @brief   Fill the flash with an image of some size and a sane vector table.
+ * @param [in] size: uint32_t size of the image.
+ * @return: uint32_t its crc, as the loader stores it.
+ */
+static uint32_t makeImage( uint32_t size )
+{
+   memset( l_img, 0xFF, APP_IMG_MAX_SIZE );
+   for ( uint32_t i = 8; i < size; i++ ) {
+      l_img[i] = (uint8_t)HT_rand( &l_seed );
+   }
+   putWord( &l_img[0], APP_IMG_SRAM_END );
+   putWord( &l_img[4], APP_IMG_START_ADDR + RESET_OFFSET );
+
+   uint32_t crc = crc32( l_img, size );
+   l_nCrcCalls = 0;
+   l_nCrcBytes = 0;
+   return( crc );
+}
+
+/**
+ * @brief   Validate the image and count the crc work it took.
+ * @param [in] size: uint32_t stored size.
+ * @param [in] crc: uint32_t stored crc.
+ * @param [in] *pMark: const AppImgMark_t pointer to the mark in flash.
+ * @param [out] *pNewMark: AppImgMark_t pointer to the mark to write.
+ * @param [out] *pbCached: bool pointer set if the mark was used.
+ * @return: CBErrorCode what APP_IMG_validate() returned.
+ */
+static CBErrorCode validate( uint32_t size, uint32_t crc,
+      const AppImgMark_t *pMark, AppImgMark_t *pNewMark, bool *pbCached )
+{
+   l_nCrcCalls = 0;
+   l_nCrcBytes = 0;
+   *pbCached = true;
+   return( APP_IMG_validate( l_img, size, crc, pMark, crc32, pNewMark,
+         pbCached ) );
+}
+
+/**
+ * @brief   First boot of an image, then the boots after it.
+ * @param   None
+ * @return: None
+ */
+static void test_mark( void )
+{
+   AppImgMark_t mark, again;
+   bool isCached;
+   uint32_t crc = makeImage( IMG_SIZE );
+
+   HT_CHECK( APP_IMG_isMarkBlank( &l_blank ) );
+
+   /* Blank mark: the whole image, and the mark to write */
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &l_blank, &mark,
+         &isCached ) );
+   HT_CHECK( !isCached );
+   HT_CHECK_MSG( 2 == l_nCrcCalls && APP_IMG_HEAD_LEN + IMG_SIZE ==
+         l_nCrcBytes, "%u calls, %u bytes", l_nCrcCalls, l_nCrcBytes );
+   HT_CHECK( APP_IMG_MARK_MAGIC == mark.magic && IMG_SIZE == mark.size &&
+         crc == mark.crc );
+   HT_CHECK( crc32( l_img, APP_IMG_HEAD_LEN ) == mark.headCrc );
+   HT_CHECK( !APP_IMG_isMarkBlank( &mark ) );
+
+   /* With the mark only the head */
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &mark, &again,
+         &isCached ) );
+   HT_CHECK( isCached );
+   HT_CHECK( 1 == l_nCrcCalls && APP_IMG_HEAD_LEN == l_nCrcBytes );
+   HT_CHECK( 0 == memcmp( &mark, &again, sizeof(mark) ) );
+
+   /* The mark vouches for what's past the head.  Only loading an image, which
+    * erases the mark, gets all of it checked again. */
+   l_img[FAR_OFFSET] ^= 0x01;
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &mark, &again,
+         &isCached ) );
+   HT_CHECK( isCached );
+   HT_CHECK( ERR_APP_IMG_CRC_MISMATCH == validate( IMG_SIZE, crc, &l_blank,
+         &again, &isCached ) );
+   HT_CHECK( !isCached && APP_IMG_HEAD_LEN + IMG_SIZE == l_nCrcBytes );
+   l_img[FAR_OFFSET] ^= 0x01;
+
+   /* An image shorter than the head only hashes itself */
+   uint32_t smallCrc = makeImage( SMALL_SIZE );
+   HT_CHECK( ERR_NONE == validate( SMALL_SIZE, smallCrc, &l_blank, &mark,
+         &isCached ) );
+   HT_CHECK( 2 * SMALL_SIZE == l_nCrcBytes );
+   HT_CHECK( ERR_NONE == validate( SMALL_SIZE, smallCrc, &mark, &again,
+         &isCached ) );
+   HT_CHECK( isCached && SMALL_SIZE == l_nCrcBytes );
+
+   /* As big as it gets */
+   crc = makeImage( APP_IMG_MAX_SIZE );
+   HT_CHECK( ERR_NONE == validate( APP_IMG_MAX_SIZE, crc, &l_blank, &mark,
+         &isCached ) );
+   HT_CHECK( !isCached );
+}
+
+/**
+ * @brief   Marks that were made for something else.
+ * @param   None
+ * @return: None
+ */
+static void test_stale( void )
+{
+   AppImgMark_t mark, newMark;
+   bool isCached;
+   uint32_t crc = makeImage( IMG_SIZE );
+
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &l_blank, &mark,
+         &isCached ) );
+
+   /* Each field of the mark on its own */
+   for ( int field = 0; field < 4; field++ ) {
+      AppImgMark_t stale = mark;
+      ( (uint32_t *)&stale )[field] ^= 0x00010000u;
+      HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &stale, &newMark,
+            &isCached ) );
+      HT_CHECK_MSG( !isCached && APP_IMG_HEAD_LEN + IMG_SIZE == l_nCrcBytes,
+            "field %d", field );
+      HT_CHECK( 0 == memcmp( &mark, &newMark, sizeof(mark) ) );
+      HT_CHECK( !APP_IMG_isMarkBlank( &stale ) );
+   }
+
+   /* Half programmed: still can't be written, so every boot checks it all */
+   AppImgMark_t half = l_blank;
+   half.magic = APP_IMG_MARK_MAGIC;
+   HT_CHECK( !APP_IMG_isMarkBlank( &half ) );
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &half, &newMark,
+         &isCached ) );
+   HT_CHECK( !isCached );
+
+   /* Put in over the old mark by a debugger: same size and crc stored but
+    * another head, so the mark doesn't count and the crc doesn't match */
+   l_img[100] ^= 0x80;
+   HT_CHECK( ERR_APP_IMG_CRC_MISMATCH == validate( IMG_SIZE, crc, &mark,
+         &newMark, &isCached ) );
+   HT_CHECK( !isCached && APP_IMG_HEAD_LEN + IMG_SIZE == l_nCrcBytes );
+
+   /* And with the crc of what's there now, it's good */
+   uint32_t newCrc = crc32( l_img, IMG_SIZE );
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, newCrc, &mark, &newMark,
+         &isCached ) );
+   HT_CHECK( !isCached && newCrc == newMark.crc &&
+         newMark.headCrc != mark.headCrc );
+}
+
+/**
+ * @brief   What gets turned away before any crc, and a bad crc.
+ * @param   None
+ * @return: None
+ */
+static void test_bad( void )
+{
+   AppImgMark_t mark;
+   bool isCached;
+   uint32_t crc = makeImage( IMG_SIZE );
+
+   static const uint32_t badSizes[] = {
+         0, 7, APP_IMG_ERASED, APP_IMG_MAX_SIZE + 1, 0x00100000
+   };
+   for ( uint32_t i = 0; i < sizeof(badSizes) / sizeof(badSizes[0]); i++ ) {
+      HT_CHECK_MSG( ERR_APP_IMG_NOT_FOUND == validate( badSizes[i], crc,
+            &l_blank, &mark, &isCached ), "size %u", badSizes[i] );
+      HT_CHECK( !isCached && 0 == l_nCrcCalls );
+   }
+
+   /* A stack pointer outside of RAM, and reset handlers that aren't thumb or
+    * aren't in the image */
+   static const struct {
+      uint32_t offset;
+      uint32_t value;
+   } badVectors[] = {
+         { 0, APP_IMG_SRAM_START },
+         { 0, APP_IMG_SRAM_END + 4 },
+         { 0, APP_IMG_CCM_END + 4 },
+         { 0, APP_IMG_ERASED },
+         { 4, APP_IMG_START_ADDR + RESET_OFFSET - 1 },
+         { 4, APP_IMG_START_ADDR - 1 },
+         { 4, APP_IMG_START_ADDR + IMG_SIZE + 1 },
+         { 4, APP_IMG_ERASED },
+   };
+   for ( uint32_t i = 0; i < sizeof(badVectors) / sizeof(badVectors[0]);
+         i++ ) {
+      uint8_t saved[4];
+      memcpy( saved, &l_img[badVectors[i].offset], sizeof(saved) );
+      putWord( &l_img[badVectors[i].offset], badVectors[i].value );
+      HT_CHECK_MSG( ERR_APP_IMG_BAD_VECTORS == validate( IMG_SIZE, crc,
+            &l_blank, &mark, &isCached ), "vector %u", i );
+      HT_CHECK( 0 == l_nCrcCalls );
+      memcpy( &l_img[badVectors[i].offset], saved, sizeof(saved) );
+   }
+
+   /* The CCM works for the stack too */
+   putWord( &l_img[0], APP_IMG_CCM_END );
+   crc = crc32( l_img, IMG_SIZE );
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &l_blank, &mark,
+         &isCached ) );
+
+   /* Stored crc off by a bit, and the last byte of the image off */
+   HT_CHECK( ERR_APP_IMG_CRC_MISMATCH == validate( IMG_SIZE, crc ^ 1,
+         &l_blank, &mark, &isCached ) );
+   HT_CHECK( !isCached );
+   l_img[IMG_SIZE - 1] ^= 0x40;
+   HT_CHECK( ERR_APP_IMG_CRC_MISMATCH == validate( IMG_SIZE, crc, &l_blank,
+         &mark, &isCached ) );
+
+   /* Bytes past the stored size aren't part of it */
+   l_img[IMG_SIZE - 1] ^= 0x40;
+   l_img[IMG_SIZE] ^= 0x40;
+   HT_CHECK( ERR_NONE == validate( IMG_SIZE, crc, &l_blank, &mark,
+         &isCached ) );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   crcInit();
+   l_img = malloc( APP_IMG_MAX_SIZE );
+
+   /* The check value of CRC32 */
+   HT_CHECK( 0xCBF43926u == crc32( (const uint8_t *)"123456789", 9 ) );
+
+   test_mark();
+   test_stale();
+   test_bad();
+
+   free( l_img );
+   return( HT_DONE( "app_img_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
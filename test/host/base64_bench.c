@@ -0,0 +1,131 @@
+/**
+ * @file   base64_bench.c
+ * @brief  Host benchmark of the streaming base64 codec against libb64.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Encodes and decodes the same buffer with both codecs and prints MB/s of
+ * input for each.  The streaming codec is driven the way the firmware drives
+ * it: whole messages of MAX_MSG_LEN (300) bytes, each straight into a buffer
+ * that holds its encoding.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "base64_stream.h"
+#include "cencode.h"
+#include "cdecode.h"
+#include <string.h>
+#include <stdlib.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_BYTES             (1024 * 1024)           /**< Input per pass */
+#define BENCH_MSG_LEN           300                        /**< MAX_MSG_LEN */
+#define BENCH_PASSES            20
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static double mbps( uint64_t ns )
+{
+   return( (double)BENCH_BYTES * BENCH_PASSES / ((double)ns / 1e9) / 1e6 );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   uint8_t *in   = malloc( BENCH_BYTES );
+   char    *text = malloc( B64S_ENCODED_LEN(BENCH_BYTES) + BENCH_BYTES / 64 );
+   uint8_t *out  = malloc( BENCH_BYTES + 3 );
+   uint32_t seed = 0xB64B64u;
+   uint64_t t0;
+   volatile int sink = 0;
+
+   for ( int i = 0; i < BENCH_BYTES; i++ ) {
+      in[i] = (uint8_t)HT_rand( &seed );
+   }
+
+   /* Encode, one message at a time */
+   t0 = HT_nowNs();
+   for ( int p = 0; p < BENCH_PASSES; p++ ) {
+      char *o = text;
+      for ( int i = 0; i < BENCH_BYTES; i += BENCH_MSG_LEN ) {
+         int n = ( BENCH_BYTES - i < BENCH_MSG_LEN ) ? BENCH_BYTES - i : BENCH_MSG_LEN;
+         base64_encodestate st;
+         base64_init_encodestate( &st );
+         int k = base64_encode_block( (const char *)&in[i], n, o, &st );
+         k += base64_encode_blockend( &o[k], &st );
+         o += k;
+      }
+      sink += (int)(o - text);
+   }
+   uint64_t libEnc = HT_nowNs() - t0;
+
+   t0 = HT_nowNs();
+   for ( int p = 0; p < BENCH_PASSES; p++ ) {
+      char *o = text;
+      for ( int i = 0; i < BENCH_BYTES; i += BENCH_MSG_LEN ) {
+         int n = ( BENCH_BYTES - i < BENCH_MSG_LEN ) ? BENCH_BYTES - i : BENCH_MSG_LEN;
+         B64S_EncState st;
+         int consumed;
+         B64S_encodeInit( &st );
+         int k = B64S_encodeChunk( &st, &in[i], n, o, B64S_ENCODED_LEN(n), &consumed );
+         k += B64S_encodeFinal( &st, &o[k] );
+         o[k++] = '\n';
+         o += k;
+      }
+      sink += (int)(o - text);
+   }
+   uint64_t strEnc = HT_nowNs() - t0;
+
+   /* Decode the whole buffer as one stream */
+   B64S_EncState est;
+   int consumed;
+   B64S_encodeInit( &est );
+   int nText = B64S_encodeChunk( &est, in, BENCH_BYTES, text,
+         B64S_ENCODED_LEN(BENCH_BYTES), &consumed );
+   nText += B64S_encodeFinal( &est, &text[nText] );
+
+   t0 = HT_nowNs();
+   for ( int p = 0; p < BENCH_PASSES; p++ ) {
+      base64_decodestate st;
+      base64_init_decodestate( &st );
+      sink += base64_decode_block( text, nText, (char *)out, &st );
+   }
+   uint64_t libDec = HT_nowNs() - t0;
+   HT_CHECK( 0 == memcmp( out, in, BENCH_BYTES ) );
+
+   memset( out, 0, BENCH_BYTES );
+   t0 = HT_nowNs();
+   for ( int p = 0; p < BENCH_PASSES; p++ ) {
+      B64S_DecState st;
+      B64S_decodeInit( &st );
+      sink += B64S_decodeChunk( &st, text, nText, out, BENCH_BYTES + 3 );
+   }
+   uint64_t strDec = HT_nowNs() - t0;
+   HT_CHECK( 0 == memcmp( out, in, BENCH_BYTES ) );
+
+   printf( "base64 encode   libb64 %7.1f MB/s   stream %7.1f MB/s   x%.2f\n",
+         mbps( libEnc ), mbps( strEnc ), (double)libEnc / strEnc );
+   printf( "base64 decode   libb64 %7.1f MB/s   stream %7.1f MB/s   x%.2f\n",
+         mbps( libDec ), mbps( strDec ), (double)libDec / strDec );
+
+   free( in );
+   free( text );
+   free( out );
+   (void)sink;
+   return( HT_DONE( "base64_bench" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
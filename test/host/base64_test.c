@@ -0,0 +1,284 @@
+/**
+ * @file   base64_test.c
+ * @brief  Host test of the streaming base64 codec and of command frames
+ * carried over it.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The libb64 encoder in the tree is the reference: the streaming encoder has
+ * to produce the same text for every length and every way of splitting the
+ * input, and the decoder has to give back the input for every way of
+ * splitting the text.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "base64_stream.h"
+#include "base64_wrapper.h"
+#include "cencode.h"
+#include "comm_frame.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_LEN                 300        /**< Longest input that's checked */
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0x2014B64u;
+
+static struct {
+   uint8_t  buf[MAX_LEN];
+   uint16_t len;
+   uint8_t  type;
+   uint16_t seq;
+   int      nGood;
+   int      nBad;
+} l_frame;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static int libb64_encode( const uint8_t *in, int len, char *out )
+{
+   base64_encodestate state;
+   base64_init_encodestate( &state );
+   int n = base64_encode_block( (const char *)in, len, out, &state );
+   n += base64_encode_blockend( &out[n], &state );
+   return( n - 1 );                             /* Without libb64's newline */
+}
+
+/******************************************************************************/
+static int stream_encode( const uint8_t *in, int len, char *out, int maxChunk )
+{
+   B64S_EncState state;
+   int nOut = 0;
+
+   B64S_encodeInit( &state );
+   while ( len > 0 ) {
+      int chunk = 1 + (int)(HT_rand( &l_seed ) % (uint32_t)maxChunk);
+      int room  = 4 + 4 * (int)(HT_rand( &l_seed ) % 8);   /* Small outputs */
+      int consumed = 0;
+      if ( chunk > len ) {
+         chunk = len;
+      }
+      nOut += B64S_encodeChunk( &state, in, chunk, &out[nOut], room, &consumed );
+      in  += consumed;
+      len -= consumed;
+   }
+   nOut += B64S_encodeFinal( &state, &out[nOut] );
+   return( nOut );
+}
+
+/******************************************************************************/
+static int stream_decode( const char *in, int len, uint8_t *out, int maxChunk )
+{
+   B64S_DecState state;
+   int nOut = 0;
+
+   B64S_decodeInit( &state );
+   while ( len > 0 ) {
+      int chunk = 1 + (int)(HT_rand( &l_seed ) % (uint32_t)maxChunk);
+      if ( chunk > len ) {
+         chunk = len;
+      }
+      int n = B64S_decodeChunk( &state, in, chunk, &out[nOut],
+            B64S_DECODED_MAX(chunk + 3) );
+      if ( n < 0 ) {
+         return( n );
+      }
+      nOut += n;
+      in   += chunk;
+      len  -= chunk;
+   }
+   return( nOut );
+}
+
+/******************************************************************************/
+static uint8_t* frame_getBuffer( void *ctx, const CommFrameHdr_t *hdr )
+{
+   (void)ctx;
+   l_frame.type = hdr->type;
+   l_frame.seq  = hdr->seq;
+   l_frame.len  = hdr->len;
+   return( l_frame.buf );
+}
+
+/******************************************************************************/
+static void frame_handler( void *ctx, const CommFrameHdr_t *hdr,
+      uint8_t *payload, bool isValid )
+{
+   (void)ctx; (void)hdr; (void)payload;
+   if ( isValid ) {
+      l_frame.nGood++;
+   } else {
+      l_frame.nBad++;
+   }
+}
+
+/******************************************************************************/
+static void test_encodeMatchesLibb64( void )
+{
+   uint8_t in[MAX_LEN];
+   char    ref[B64S_ENCODED_LEN(MAX_LEN) + 2];
+   char    out[B64S_ENCODED_LEN(MAX_LEN) + 4];
+
+   for ( int len = 0; len <= MAX_LEN; len++ ) {
+      for ( int i = 0; i < len; i++ ) {
+         in[i] = (uint8_t)HT_rand( &l_seed );
+      }
+      int nRef = libb64_encode( in, len, ref );
+      HT_CHECK( B64S_ENCODED_LEN(len) == nRef );
+
+      for ( int maxChunk = 1; maxChunk <= 64; maxChunk *= 4 ) {
+         int n = stream_encode( in, len, out, maxChunk );
+         HT_CHECK_MSG( n == nRef && 0 == memcmp( out, ref, n ),
+               "len %d maxChunk %d", len, maxChunk );
+      }
+   }
+}
+
+/******************************************************************************/
+static void test_decodeRoundTrip( void )
+{
+   uint8_t in[MAX_LEN];
+   uint8_t out[MAX_LEN + 3];
+   char    text[2 * B64S_ENCODED_LEN(MAX_LEN)];
+
+   for ( int len = 0; len <= MAX_LEN; len++ ) {
+      for ( int i = 0; i < len; i++ ) {
+         in[i] = (uint8_t)HT_rand( &l_seed );
+      }
+      int nText = libb64_encode( in, len, text );
+
+      for ( int maxChunk = 1; maxChunk <= 64; maxChunk *= 4 ) {
+         int n = stream_decode( text, nText, out, maxChunk );
+         HT_CHECK_MSG( n == len && 0 == memcmp( out, in, len ),
+               "len %d maxChunk %d", len, maxChunk );
+      }
+
+      /* Line endings anywhere in the text are skipped */
+      char crlf[2 * B64S_ENCODED_LEN(MAX_LEN) + 4];
+      int  nCrlf = 0;
+      for ( int i = 0; i < nText; i++ ) {
+         crlf[nCrlf++] = text[i];
+         if ( 0 == HT_rand( &l_seed ) % 7 ) {
+            crlf[nCrlf++] = '\r';
+            crlf[nCrlf++] = '\n';
+         }
+      }
+      int n = stream_decode( crlf, nCrlf, out, 16 );
+      HT_CHECK_MSG( n == len && 0 == memcmp( out, in, len ), "crlf len %d", len );
+   }
+}
+
+/******************************************************************************/
+static void test_decodeRejects( void )
+{
+   B64S_DecState state;
+   uint8_t out[16];
+
+   B64S_decodeInit( &state );
+   HT_CHECK( B64S_decodeChunk( &state, "QU*D", 4, out, sizeof(out) ) < 0 );
+
+   B64S_decodeInit( &state );
+   HT_CHECK( B64S_decodeChunk( &state, "QQ==QUJD", 8, out, sizeof(out) ) < 0 );
+
+   B64S_decodeInit( &state );
+   HT_CHECK( B64S_decodeChunk( &state, "QUJDREVG", 8, out, 5 ) < 0 );
+}
+
+/******************************************************************************/
+static void test_wrapperBounds( void )
+{
+   char in[MAX_LEN];
+   char out[B64S_ENCODED_LEN(MAX_LEN) + 1];
+
+   memset( in, 'x', sizeof(in) );
+   for ( int len = 0; len <= MAX_LEN; len += 7 ) {
+      int need = B64S_ENCODED_LEN(len) + 1;
+      HT_CHECK( need == base64_encode( in, len, out, need ) );
+      HT_CHECK( '\n' == out[need - 1] );
+      HT_CHECK( -1 == base64_encode( in, len, out, need - 1 ) );
+   }
+}
+
+/******************************************************************************/
+static void test_framesOverBase64( void )
+{
+   CommFrameParser_t parser;
+   B64S_DecState     b64;
+   uint8_t payload[200];
+   uint8_t frames[3 * (sizeof(payload) + COMM_FRAME_OVERHEAD)];
+   char    text[B64S_ENCODED_LEN(sizeof(frames)) + 2];
+
+   CommFrame_init( &parser, sizeof(l_frame.buf), frame_getBuffer,
+         frame_handler, NULL );
+
+   for ( int len = 0; len <= (int)sizeof(payload); len += 13 ) {
+      for ( int i = 0; i < len; i++ ) {
+         payload[i] = (uint8_t)HT_rand( &l_seed );
+      }
+
+      /* Three frames on one line, base64 encoded as a whole */
+      uint16_t nFrames = 0;
+      for ( int f = 0; f < 3; f++ ) {
+         nFrames += CommFrame_encode( &frames[nFrames],
+               sizeof(frames) - nFrames, 0x01, (uint16_t)(len + f), payload,
+               (uint16_t)len );
+      }
+      int nText = libb64_encode( frames, nFrames, text );
+      text[nText++] = '\n';
+
+      memset( &l_frame, 0, sizeof(l_frame) );
+      B64S_decodeInit( &b64 );
+      uint16_t nGood = 0;
+      for ( int pos = 0; pos < nText; ) {
+         int chunk = 1 + (int)(HT_rand( &l_seed ) % 100);
+         if ( chunk > nText - pos ) {
+            chunk = nText - pos;
+         }
+         nGood += CommFrame_feedBase64( &parser, &b64, &text[pos],
+               (uint16_t)chunk );
+         pos += chunk;
+      }
+      HT_CHECK_MSG( 3 == nGood && 3 == l_frame.nGood && 0 == l_frame.nBad,
+            "len %d good %d", len, nGood );
+      HT_CHECK( len == l_frame.len && len + 2 == l_frame.seq );
+      HT_CHECK( 0 == memcmp( l_frame.buf, payload, len ) );
+   }
+
+   /* Garbage in the middle of a frame drops the frame and resets the decoder */
+   uint16_t n = CommFrame_encode( frames, sizeof(frames), 0x01, 7, payload, 40 );
+   int nText = libb64_encode( frames, n, text );
+   memset( &l_frame, 0, sizeof(l_frame) );
+   B64S_decodeInit( &b64 );
+   HT_CHECK( 0 == CommFrame_feedBase64( &parser, &b64, text, 20 ) );
+   HT_CHECK( 0 == CommFrame_feedBase64( &parser, &b64, "*", 1 ) );
+   HT_CHECK( 1 == l_frame.nBad );
+
+   B64S_decodeInit( &b64 );
+   HT_CHECK( 1 == CommFrame_feedBase64( &parser, &b64, text, (uint16_t)nText ) );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_encodeMatchesLibb64();
+   test_decodeRoundTrip();
+   test_decodeRejects();
+   test_wrapperBounds();
+   test_framesOverBase64();
+   return( HT_DONE( "base64_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
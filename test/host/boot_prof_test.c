@@ -0,0 +1,200 @@
+/**
+ * @file   boot_prof_test.c
+ * @brief  Host test of the boot time profiler on a fake cycle counter.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * boot_prof.c reads the counter through BOOT_PROF_NOW(), which
+ * stub/boot_prof/boot_prof_now.h points at BOOT_hostNow.  The test marks
+ * steps the way the firmware does while it moves the counter along, then
+ * compares every line BOOT_report() prints with the timeline it should be:
+ *
+ * - Steps that overlap, one of them starting before a step ahead of it in
+ *   BootStep_t, a step that's still running and steps that never began.
+ * - A boot held up for long enough that the counter wraps at 180 MHz, with
+ *   a step that ends after the wrap and one that starts after it.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "boot_prof.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_LINES               (BOOT_STEP_MAX + 4)
+#define CORE_HZ                 180000000u          /**< SystemCoreClock */
+#define CYCLES_PER_MS           (CORE_HZ / 1000u)
+#define N_LINES( a_ )           ( (int)( sizeof(a_) / sizeof((a_)[0]) ) )
+
+/* Private variables and Local objects ---------------------------------------*/
+volatile uint32_t BOOT_hostNow;
+
+static char l_lines[MAX_LINES][BOOT_MAX_LINE_LEN + 2];
+static int  l_nLines;
+
+/**< Overlapping steps, at 1 cycle per us */
+static const char * const l_overlap[] = {
+      "Boot timeline, ms since BSP_init:",
+      "step           start       dur |0                          32 ms|",
+      "serial         0.000     1.000 |#                               |",
+      "rtc            1.000     2.000 | ##                             |",
+      "app.check    not run",
+      "i2c            3.000     1.000 |   #                            |",
+      "nor            4.000   running",
+      "qf.init      not run",
+      "ao.start     not run",
+      "sched        not run",
+      "lsi.cal        8.000    24.000 |        ########################|",
+      "db.load       16.000     8.000 |                ########        |",
+      "eth.phy       10.000    22.000 |          ######################|",
+      "net.up       not run",
+      "Boot took 32.000 ms",
+};
+
+/**< A boot that runs past the wrap of the counter */
+static const char * const l_wrap[] = {
+      "Boot timeline, ms since BSP_init:",
+      "step           start       dur |0                       30500 ms|",
+      "serial         0.000     0.500 |#                               |",
+      "rtc            1.000     1.000 |#                               |",
+      "app.check      2.000     1.000 |#                               |",
+      "i2c            3.000     1.000 |#                               |",
+      "nor            4.000     1.000 |#                               |",
+      "qf.init        5.000     1.000 |#                               |",
+      "ao.start       6.000     1.000 |#                               |",
+      "sched          7.000     1.000 |#                               |",
+      "lsi.cal     9000.000  1000.000 |         #                      |",
+      "db.load    17000.000  1000.000 |                 #              |",
+      "eth.phy    22000.000  8000.000 |                       ######## |",
+      "net.up     30000.000   500.000 |                               #|",
+      "Boot took 30500.000 ms",
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void addLine( const char *line )
+{
+   HT_CHECK_MSG( strlen( line ) <= BOOT_MAX_LINE_LEN, "too long: %s", line );
+   if ( l_nLines < MAX_LINES ) {
+      strncpy( l_lines[l_nLines], line, sizeof(l_lines[0]) - 1 );
+   }
+   l_nLines++;
+}
+
+/**
+ * @brief   Print the timeline and compare it line by line.
+ * @param [in] cyclesPerSec: uint32_t rate of the counter.
+ * @param [in] *expected: const char pointer array of the lines.
+ * @param [in] nExpected: int number of lines.
+ * @return: uint32_t what BOOT_report() returned.
+ */
+static uint32_t report( uint32_t cyclesPerSec, const char * const *expected,
+      int nExpected )
+{
+   l_nLines = 0;
+   uint32_t totalUs = BOOT_report( cyclesPerSec, addLine );
+
+   HT_CHECK_MSG( nExpected == l_nLines, "%d lines", l_nLines );
+   for ( int i = 0; i < nExpected && i < l_nLines; i++ ) {
+      HT_CHECK_MSG( 0 == strcmp( expected[i], l_lines[i] ),
+            "line %d\n  got  \"%s\"\n  want \"%s\"", i, l_lines[i],
+            expected[i] );
+   }
+   return( totalUs );
+}
+
+/******************************************************************************/
+static void at( uint32_t cycles )
+{
+   BOOT_hostNow = cycles;
+}
+
+/**
+ * @brief   Mark steps as the counter moves, with overlaps and gaps.
+ * @param   None
+ * @return: None
+ */
+static void test_overlap( void )
+{
+   at( 0 );     BOOT_begin( BOOT_STEP_SERIAL );
+   at( 1000 );  BOOT_end( BOOT_STEP_SERIAL );  BOOT_begin( BOOT_STEP_RTC );
+   at( 3000 );  BOOT_end( BOOT_STEP_RTC );     BOOT_begin( BOOT_STEP_I2C );
+   at( 4000 );  BOOT_end( BOOT_STEP_I2C );     BOOT_begin( BOOT_STEP_NOR );
+
+   /* The threads: eth.phy starts before db.load but comes after it */
+   at( 8000 );  BOOT_begin( BOOT_STEP_LSI_CAL );
+   at( 10000 ); BOOT_begin( BOOT_STEP_ETH_PHY );
+   at( 16000 ); BOOT_begin( BOOT_STEP_DB_LOAD );
+   at( 24000 ); BOOT_end( BOOT_STEP_DB_LOAD );
+   at( 32000 ); BOOT_end( BOOT_STEP_LSI_CAL ); BOOT_end( BOOT_STEP_ETH_PHY );
+
+   /* Past the end of the steps does nothing */
+   at( 99000 ); BOOT_begin( BOOT_STEP_MAX );   BOOT_end( BOOT_STEP_MAX );
+   BOOT_set( BOOT_STEP_MAX, 0, 99000 );
+
+   HT_CHECK( !BOOT_isDone() );
+   HT_CHECK( 32000 == report( 1000000, l_overlap, N_LINES( l_overlap ) ) );
+}
+
+/**
+ * @brief   A recorded timeline that runs past the wrap of the counter.
+ * @param   None
+ * @return: None
+ */
+static void test_wrap( void )
+{
+   /* Set in ms and truncated to the 32 bits the counter has */
+   static const struct {
+      uint32_t beginMs;
+      uint32_t endMs;
+   } steps[BOOT_STEP_MAX] = {
+      [BOOT_STEP_SERIAL]    = { 0,     0 },
+      [BOOT_STEP_RTC]       = { 1,     2 },
+      [BOOT_STEP_APP_CHECK] = { 2,     3 },
+      [BOOT_STEP_I2C]       = { 3,     4 },
+      [BOOT_STEP_NOR]       = { 4,     5 },
+      [BOOT_STEP_QF_INIT]   = { 5,     6 },
+      [BOOT_STEP_AO_START]  = { 6,     7 },
+      [BOOT_STEP_SCHED]     = { 7,     8 },
+      [BOOT_STEP_LSI_CAL]   = { 9000,  10000 },
+      [BOOT_STEP_DB_LOAD]   = { 17000, 18000 },
+      [BOOT_STEP_ETH_PHY]   = { 22000, 30000 },   /* Ends past 23860.9 ms */
+      [BOOT_STEP_NET_UP]    = { 30000, 30500 },   /* Starts past it */
+   };
+
+   for ( int i = 0; i < BOOT_STEP_MAX; i++ ) {
+      uint64_t begin = (uint64_t)steps[i].beginMs * CYCLES_PER_MS;
+      uint64_t end   = (uint64_t)steps[i].endMs * CYCLES_PER_MS;
+      if ( BOOT_STEP_SERIAL == i ) {
+         end = CYCLES_PER_MS / 2;
+      }
+      BOOT_set( (BootStep_t)i, (uint32_t)begin, (uint32_t)end );
+   }
+   HT_CHECK( (uint32_t)( 30000ull * CYCLES_PER_MS ) <
+         (uint32_t)( 22000ull * CYCLES_PER_MS ) );          /* It did wrap */
+
+   HT_CHECK( BOOT_isDone() );
+   HT_CHECK( 30500000u == report( CORE_HZ, l_wrap, N_LINES( l_wrap ) ) );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_overlap();
+   test_wrap();
+   return( HT_DONE( "boot_prof_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,262 @@
+/**
+ * @file   comm_frame_bench.c
+ * @brief  Host benchmark of the command frame parser.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Runs the same frames through each way the firmware feeds the parser:
+ * CommFrame_feed() in pieces, CommFrame_feedRing() on a circular DMA ring
+ * half a ring at a time, and CommFrame_feedBase64() one line at a time the
+ * way the serial port hands them over.  The clean stream is nothing but
+ * frames.  The noisy one has noise full of sync markers in front of every
+ * frame, on a line of its own for base64, and a bad crc in one frame of
+ * every 8.  MB/s is of the binary stream, before any base64 encoding.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "comm_frame.h"
+#include "base64_stream.h"
+#include <string.h>
+#include <stdlib.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_PAYLOAD             291          /**< COMM_FRAME_MAX_PAYLOAD */
+#define MAX_UNIT                (32 + MAX_PAYLOAD + COMM_FRAME_OVERHEAD)
+#define BENCH_BYTES             (1024 * 1024)           /**< Stream length */
+#define BENCH_PASSES            20
+#define FEED_CHUNK              64     /**< Bytes per CommFrame_feed() call */
+#define RING_SIZE               256   /**< UART1_RX_DMA_BUF_LEN in serial.c */
+#define BAD_CRC_EVERY           8
+#define N_BUFS                  8     /**< More than the rescan depth + 1 */
+
+/* Private typedefs ----------------------------------------------------------*/
+/**< One stream, as binary and as base64 lines */
+typedef struct {
+   uint8_t *bin;
+   int      binLen;
+   char    *text;
+   int      textLen;
+   int      nFrames;
+   int      nBadCrc;
+} Stream_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0xF4A3E5u;
+static int      l_nGood;                /**< Valid frames seen by handler */
+
+/**< Every rescan of a bad frame holds on to its buffer while the frames in
+ * it get buffers of their own */
+static struct {
+   uint8_t  bufs[N_BUFS][MAX_PAYLOAD];
+   bool     inUse[N_BUFS];
+} l_pool;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint8_t* getBuffer( void *ctx, const CommFrameHdr_t *hdr )
+{
+   (void)ctx; (void)hdr;
+   for ( int i = 0; i < N_BUFS; i++ ) {
+      if ( !l_pool.inUse[i] ) {
+         l_pool.inUse[i] = true;
+         return( l_pool.bufs[i] );
+      }
+   }
+   return( NULL );
+}
+
+/******************************************************************************/
+static void handler( void *ctx, const CommFrameHdr_t *hdr, uint8_t *payload,
+      bool isValid )
+{
+   (void)ctx; (void)hdr;
+   l_pool.inUse[(payload - &l_pool.bufs[0][0]) / MAX_PAYLOAD] = false;
+   l_nGood += isValid;
+}
+
+/******************************************************************************/
+static void addLine( Stream_t *s, const uint8_t *data, int len )
+{
+   B64S_EncState enc;
+   int consumed;
+
+   B64S_encodeInit( &enc );
+   s->textLen += B64S_encodeChunk( &enc, data, len, &s->text[s->textLen],
+         B64S_ENCODED_LEN(len), &consumed );
+   s->textLen += B64S_encodeFinal( &enc, &s->text[s->textLen] );
+   s->text[s->textLen++] = '\n';
+}
+
+/**
+ * @brief   Build a stream of frames, with or without noise and bad crcs.
+ * @param [out] *s: Stream_t pointer to the stream to fill in.
+ * @param [in] isNoisy: bool true for noise and bad crcs.
+ * @return: None
+ */
+static void makeStream( Stream_t *s, bool isNoisy )
+{
+   uint8_t payload[MAX_PAYLOAD];
+   uint8_t unit[MAX_UNIT];
+
+   s->bin     = malloc( BENCH_BYTES );
+   s->text    = malloc( B64S_ENCODED_LEN(BENCH_BYTES) * 2 );
+   s->binLen  = 0;
+   s->textLen = 0;
+   s->nFrames = 0;
+   s->nBadCrc = 0;
+
+   while ( s->binLen + MAX_UNIT <= BENCH_BYTES ) {
+      int n = 0;
+      if ( isNoisy ) {
+         int nNoise = (int)(HT_rand( &l_seed ) % 24);
+         for ( int k = 0; k < nNoise; k++ ) {
+            uint32_t r = HT_rand( &l_seed );
+            if ( 0 == r % 4 && k + 1 < nNoise ) {
+               unit[n++] = COMM_FRAME_SYNC0;
+               unit[n++] = COMM_FRAME_SYNC1;
+               k++;
+            } else {
+               unit[n++] = (uint8_t)(r >> 8);
+            }
+         }
+      }
+
+      uint16_t len = (uint16_t)(HT_rand( &l_seed ) % (MAX_PAYLOAD + 1));
+      for ( int k = 0; k < len; k++ ) {
+         payload[k] = (uint8_t)HT_rand( &l_seed );
+      }
+      uint16_t nFrame = CommFrame_encode( &unit[n], MAX_PAYLOAD +
+            COMM_FRAME_OVERHEAD, 0x42, (uint16_t)s->nFrames, payload, len );
+      s->nFrames++;
+      if ( isNoisy && 0 == s->nFrames % BAD_CRC_EVERY ) {
+         unit[n + nFrame - 1] ^= 0x5A;
+         s->nBadCrc++;
+      }
+
+      memcpy( &s->bin[s->binLen], unit, (size_t)(n + nFrame) );
+      s->binLen += n + nFrame;
+
+      /* A line ends whatever frame is in it, so the noise gets a line of
+       * its own like it would on the serial port */
+      if ( n > 0 ) {
+         addLine( s, unit, n );
+      }
+      addLine( s, &unit[n], nFrame );
+   }
+}
+
+/******************************************************************************/
+static void runFeed( CommFrameParser_t *p, const Stream_t *s )
+{
+   for ( int pos = 0; pos < s->binLen; pos += FEED_CHUNK ) {
+      int n = ( s->binLen - pos < FEED_CHUNK ) ? s->binLen - pos : FEED_CHUNK;
+      CommFrame_feed( p, &s->bin[pos], (uint16_t)n );
+   }
+}
+
+/******************************************************************************/
+static void runRing( CommFrameParser_t *p, const Stream_t *s )
+{
+   static uint8_t ring[RING_SIZE];
+   uint16_t rd = 0;
+
+   /* The DMA fills half the ring and the parser eats it */
+   for ( int pos = 0; pos < s->binLen; ) {
+      uint16_t wr = rd;
+      for ( int k = 0; k < RING_SIZE / 2 && pos < s->binLen; k++ ) {
+         ring[wr] = s->bin[pos++];
+         wr = (uint16_t)((wr + 1) % RING_SIZE);
+      }
+      CommFrame_feedRing( p, ring, RING_SIZE, rd, wr );
+      rd = wr;
+   }
+}
+
+/******************************************************************************/
+static void runBase64( CommFrameParser_t *p, const Stream_t *s )
+{
+   B64S_DecState b64;
+
+   /* Same as Serial_UART1LineHandler() */
+   for ( int pos = 0; pos < s->textLen; ) {
+      const char *line = &s->text[pos];
+      const char *end  = memchr( line, '\n', (size_t)(s->textLen - pos) );
+      uint16_t len = (uint16_t)(end - line + 1);
+      B64S_decodeInit( &b64 );
+      CommFrame_feedBase64( p, &b64, line, len );
+      CommFrame_reset( p );
+      pos += len;
+   }
+}
+
+/**
+ * @brief   Time one way of feeding the parser and check what it found.
+ * @param [in] *name: const char pointer to the label to print.
+ * @param [in] *s: const Stream_t pointer to the stream.
+ * @param [in] run: the function that feeds the parser.
+ * @return: None
+ */
+static void bench( const char *name, const Stream_t *s,
+      void (*run)( CommFrameParser_t *, const Stream_t * ) )
+{
+   CommFrameParser_t p;
+   uint64_t t0 = HT_nowNs();
+
+   for ( int pass = 0; pass < BENCH_PASSES; pass++ ) {
+      l_nGood = 0;
+      CommFrame_init( &p, MAX_PAYLOAD, getBuffer, handler, NULL );
+      run( &p, s );
+      CommFrame_reset( &p );
+   }
+   uint64_t ns = HT_nowNs() - t0;
+
+   int nGood = s->nFrames - s->nBadCrc;
+   HT_CHECK_MSG( nGood == l_nGood, "%s: %d of %d frames", name, l_nGood,
+         nGood );
+   HT_CHECK( (uint32_t)s->nBadCrc <= p.nCrcErrors && 0 == p.nNoBuffer );
+   HT_CHECK( 0 != s->nBadCrc || ( 0 == p.nCrcErrors && 0 == p.nSkipped ) );
+
+   double sec = (double)ns / 1e9;
+   printf( "comm_frame %-14s %7.1f MB/s %8.0f frames/s  crc %6u len %6u"
+         " skip %7u\n", name,
+         (double)s->binLen * BENCH_PASSES / sec / 1e6,
+         (double)s->nFrames * BENCH_PASSES / sec,
+         p.nCrcErrors, p.nLenErrors, p.nSkipped );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   Stream_t clean, noisy;
+
+   makeStream( &clean, false );
+   makeStream( &noisy, true );
+
+   bench( "feed clean", &clean, runFeed );
+   bench( "feed noisy", &noisy, runFeed );
+   bench( "ring clean", &clean, runRing );
+   bench( "ring noisy", &noisy, runRing );
+   bench( "base64 clean", &clean, runBase64 );
+   bench( "base64 noisy", &noisy, runBase64 );
+
+   free( clean.bin );
+   free( clean.text );
+   free( noisy.bin );
+   free( noisy.text );
+   return( HT_DONE( "comm_frame_bench" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
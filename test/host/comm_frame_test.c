@@ -0,0 +1,400 @@
+/**
+ * @file   comm_frame_test.c
+ * @brief  Host test of the command frame parser.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Frames are mixed with noise that contains sync markers, fed to the parser
+ * in random pieces, and every real frame has to come out exactly once.  The
+ * payload buffers come from a small pool, like the event pools on the
+ * target, and every buffer handed out has to be given back.  The fuzz test
+ * mangles frames with bit errors, lost and extra bytes, stray sync markers
+ * and truncation, and feeds them through every entry point.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "comm_frame.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_PAYLOAD             291          /**< COMM_FRAME_MAX_PAYLOAD */
+#define N_BUFS                  8            /**< Buffers in the pool */
+#define STREAM_LEN              (64 * 1024)
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0xC0FFEE32u;
+
+static struct {
+   uint8_t  bufs[N_BUFS][MAX_PAYLOAD];
+   bool     inUse[N_BUFS];
+   int      nOut;                         /**< Buffers handed out right now */
+   bool     starve;                         /**< Pretend the pool is empty */
+} l_pool;
+
+static struct {
+   uint8_t  seen[0x10000];        /**< Times each real frame seq was seen */
+   int      nFrames;
+   int      nBogus;         /**< Good crc but not one of the real frames */
+} l_rx;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint8_t* getBuffer( void *ctx, const CommFrameHdr_t *hdr )
+{
+   (void)ctx; (void)hdr;
+   if ( l_pool.starve ) {
+      return( NULL );
+   }
+   for ( int i = 0; i < N_BUFS; i++ ) {
+      if ( !l_pool.inUse[i] ) {
+         l_pool.inUse[i] = true;
+         l_pool.nOut++;
+         return( l_pool.bufs[i] );
+      }
+   }
+   return( NULL );
+}
+
+/******************************************************************************/
+static void handler( void *ctx, const CommFrameHdr_t *hdr, uint8_t *payload,
+      bool isValid )
+{
+   (void)ctx;
+   int i = (int)((payload - &l_pool.bufs[0][0]) / MAX_PAYLOAD);
+   HT_CHECK( i >= 0 && i < N_BUFS && l_pool.inUse[i] );
+   l_pool.inUse[i] = false;
+   l_pool.nOut--;
+
+   if ( !isValid ) {
+      return;
+   }
+
+   /* Real frames carry their seq in every payload byte and type 0x42 */
+   bool isReal = ( 0x42 == hdr->type );
+   for ( int k = 0; k < hdr->len && isReal; k++ ) {
+      isReal = ( payload[k] == (uint8_t)(hdr->seq * 7 + k) );
+   }
+   if ( isReal ) {
+      l_rx.seen[hdr->seq]++;
+      l_rx.nFrames++;
+   } else {
+      l_rx.nBogus++;
+   }
+}
+
+/******************************************************************************/
+static uint16_t realFrame( uint8_t *out, uint16_t seq, uint16_t len )
+{
+   uint8_t payload[MAX_PAYLOAD];
+   for ( int k = 0; k < len; k++ ) {
+      payload[k] = (uint8_t)(seq * 7 + k);
+   }
+   return( CommFrame_encode( out, MAX_PAYLOAD + COMM_FRAME_OVERHEAD, 0x42, seq,
+         payload, len ) );
+}
+
+/******************************************************************************/
+static void feedRandomly( CommFrameParser_t *p, const uint8_t *data, int len )
+{
+   for ( int pos = 0; pos < len; ) {
+      int n = 1 + (int)(HT_rand( &l_seed ) % 97);
+      if ( n > len - pos ) {
+         n = len - pos;
+      }
+      CommFrame_feed( p, &data[pos], (uint16_t)n );
+      pos += n;
+   }
+}
+
+/******************************************************************************/
+static void start( CommFrameParser_t *p )
+{
+   memset( &l_pool, 0, sizeof(l_pool) );
+   memset( &l_rx, 0, sizeof(l_rx) );
+   CommFrame_init( p, MAX_PAYLOAD, getBuffer, handler, NULL );
+}
+
+/******************************************************************************/
+static void test_clean( void )
+{
+   CommFrameParser_t p;
+   static uint8_t stream[STREAM_LEN];
+   int len = 0, n = 0;
+
+   start( &p );
+   while ( len + MAX_PAYLOAD + COMM_FRAME_OVERHEAD < STREAM_LEN ) {
+      len += realFrame( &stream[len], (uint16_t)n++,
+            (uint16_t)(HT_rand( &l_seed ) % (MAX_PAYLOAD + 1)) );
+   }
+   feedRandomly( &p, stream, len );
+   HT_CHECK( n == l_rx.nFrames && 0 == l_rx.nBogus );
+   HT_CHECK( 0 == p.nSkipped && 0 == p.nCrcErrors && 0 == p.nLenErrors );
+   HT_CHECK( (uint32_t)len == p.nBytes && 0 == l_pool.nOut );
+}
+
+/******************************************************************************/
+static void test_lenErrorResync( void )
+{
+   CommFrameParser_t p;
+   uint8_t stream[64];
+
+   /* The bogus header's len is FF A5, and the real frame starts at its A5 */
+   start( &p );
+   stream[0] = COMM_FRAME_SYNC0;
+   stream[1] = COMM_FRAME_SYNC1;
+   stream[2] = 0xFF;
+   uint16_t len = 3 + realFrame( &stream[3], 1, 4 );
+   for ( uint16_t i = 0; i < len; i++ ) {
+      CommFrame_feed( &p, &stream[i], 1 );
+   }
+   HT_CHECK( 1 == l_rx.seen[1] && 1 == p.nLenErrors );
+   HT_CHECK( 3 == p.nSkipped && 0 == l_pool.nOut );
+}
+
+/******************************************************************************/
+static void test_crcErrorResync( void )
+{
+   CommFrameParser_t p;
+   uint8_t stream[128];
+   uint16_t len;
+
+   /* A bogus header claims 5 bytes of payload, which are really the start of
+    * a frame that ends in the bogus crc and the bytes after it */
+   start( &p );
+   uint8_t bogus[] = { COMM_FRAME_SYNC0, COMM_FRAME_SYNC1, 5, 0, 0x42, 0, 0 };
+   memcpy( stream, bogus, sizeof(bogus) );
+   len = sizeof(bogus) + realFrame( &stream[sizeof(bogus)], 2, 20 );
+   CommFrame_feed( &p, stream, len );
+   HT_CHECK( 1 == l_rx.seen[2] && 1 == p.nCrcErrors );
+   HT_CHECK( 0 == l_pool.nOut );
+
+   /* A whole frame inside the payload of a bogus one, then another frame */
+   start( &p );
+   uint8_t bogus2[] = { COMM_FRAME_SYNC0, COMM_FRAME_SYNC1, 40, 0, 0x42, 0, 0 };
+   memcpy( stream, bogus2, sizeof(bogus2) );
+   len = sizeof(bogus2);
+   len += realFrame( &stream[len], 3, 10 );
+   len += realFrame( &stream[len], 4, 30 );
+   feedRandomly( &p, stream, len );
+   HT_CHECK( 1 == l_rx.seen[3] && 1 == l_rx.seen[4] && 2 == l_rx.nFrames );
+   HT_CHECK( 1 == p.nCrcErrors && 0 == l_pool.nOut );
+}
+
+/******************************************************************************/
+static void test_noise( void )
+{
+   CommFrameParser_t p;
+   static uint8_t stream[STREAM_LEN];
+   int len = 0, n = 0;
+
+   start( &p );
+   while ( len + 2 * (MAX_PAYLOAD + COMM_FRAME_OVERHEAD) < STREAM_LEN ) {
+      /* Noise full of sync markers and small or huge lens */
+      int nNoise = (int)(HT_rand( &l_seed ) % 24);
+      for ( int k = 0; k < nNoise; k++ ) {
+         uint32_t r = HT_rand( &l_seed );
+         if ( 0 == r % 4 && k + 1 < nNoise ) {
+            stream[len++] = COMM_FRAME_SYNC0;
+            stream[len++] = COMM_FRAME_SYNC1;
+            k++;
+         } else {
+            stream[len++] = (uint8_t)(r >> 8);
+         }
+      }
+      len += realFrame( &stream[len], (uint16_t)n++,
+            (uint16_t)(HT_rand( &l_seed ) % 64) );
+   }
+   feedRandomly( &p, stream, len );
+
+   int nMissing = 0;
+   for ( int i = 0; i < n; i++ ) {
+      nMissing += ( 1 != l_rx.seen[i] );
+   }
+   HT_CHECK_MSG( 0 == nMissing, "%d of %d frames lost", nMissing, n );
+   HT_CHECK( 0 == l_rx.nBogus );
+   HT_CHECK( p.nCrcErrors > 0 && p.nLenErrors > 0 );
+
+   CommFrame_reset( &p );
+   HT_CHECK( 0 == l_pool.nOut );
+}
+
+/******************************************************************************/
+static void test_noBuffer( void )
+{
+   CommFrameParser_t p;
+   uint8_t stream[2 * (MAX_PAYLOAD + COMM_FRAME_OVERHEAD)];
+
+   /* Frames that can't get a buffer are skipped without losing sync */
+   start( &p );
+   uint16_t len = realFrame( stream, 5, 100 );
+   l_pool.starve = true;
+   CommFrame_feed( &p, stream, len );
+   l_pool.starve = false;
+   len = realFrame( stream, 6, 100 );
+   CommFrame_feed( &p, stream, len );
+   HT_CHECK( 0 == l_rx.seen[5] && 1 == l_rx.seen[6] && 1 == p.nNoBuffer );
+   HT_CHECK( 0 == l_pool.nOut );
+}
+
+/******************************************************************************/
+static void test_ring( void )
+{
+   CommFrameParser_t p;
+   uint8_t ring[256];
+   uint8_t frame[MAX_PAYLOAD + COMM_FRAME_OVERHEAD];
+   uint16_t wr = 0, rd = 0;
+
+   start( &p );
+   for ( int n = 0; n < 500; n++ ) {
+      uint16_t len = realFrame( frame, (uint16_t)n,
+            (uint16_t)(HT_rand( &l_seed ) % 100) );
+      for ( uint16_t k = 0; k < len; k++ ) {
+         ring[wr] = frame[k];
+         wr = (uint16_t)((wr + 1) % sizeof(ring));
+      }
+      CommFrame_feedRing( &p, ring, sizeof(ring), rd, wr );
+      rd = wr;
+   }
+   HT_CHECK( 500 == l_rx.nFrames && 0 == l_pool.nOut );
+}
+
+/******************************************************************************/
+static void test_fuzz( void )
+{
+   CommFrameParser_t p;
+   static uint8_t stream[2048];
+   static char    text[B64S_ENCODED_LEN(sizeof(stream))];
+   uint8_t ring[256];
+   int nLost = 0, nTwice = 0, nMiscount = 0, nLeaked = 0;
+
+   /* A few frames mangled the ways a line mangles them, then a clean frame
+    * and enough zeros to finish off whatever the mangling left open.  The
+    * clean frame has to come out, nothing can come out twice, and every
+    * byte and every buffer has to be accounted for. */
+   for ( int iter = 0; iter < 20000; iter++ ) {
+      int len = 0;
+      start( &p );
+
+      int nFrames = (int)(HT_rand( &l_seed ) % 4);
+      for ( int f = 0; f < nFrames; f++ ) {
+         len += realFrame( &stream[len], (uint16_t)(100 + f),
+               (uint16_t)(HT_rand( &l_seed ) % 128) );
+      }
+
+      int nMutations = (int)(HT_rand( &l_seed ) % 6);
+      for ( int m = 0; m < nMutations && len > 0; m++ ) {
+         uint32_t r   = HT_rand( &l_seed );
+         int      pos = (int)((r >> 8) % (uint32_t)len);
+         switch ( r % 5 ) {
+            case 0:                                            /* Bit error */
+               stream[pos] ^= (uint8_t)(1u << ((r >> 4) % 8));
+               break;
+            case 1:                                       /* Extra byte */
+               memmove( &stream[pos + 1], &stream[pos], (size_t)(len - pos) );
+               stream[pos] = (uint8_t)(r >> 24);
+               len++;
+               break;
+            case 2:                                        /* Lost byte */
+               memmove( &stream[pos], &stream[pos + 1],
+                     (size_t)(len - pos - 1) );
+               len--;
+               break;
+            case 3:                                  /* Stray sync marker */
+               memmove( &stream[pos + 2], &stream[pos], (size_t)(len - pos) );
+               stream[pos]     = COMM_FRAME_SYNC0;
+               stream[pos + 1] = COMM_FRAME_SYNC1;
+               len += 2;
+               break;
+            default:                                       /* Cut short */
+               len = pos;
+               break;
+         }
+      }
+
+      len += realFrame( &stream[len], 0xBEEF,
+            (uint16_t)(HT_rand( &l_seed ) % 64) );
+      memset( &stream[len], 0, MAX_PAYLOAD + COMM_FRAME_OVERHEAD );
+      len += MAX_PAYLOAD + COMM_FRAME_OVERHEAD;
+
+      /* Through each way the firmware feeds the parser */
+      switch ( iter % 3 ) {
+         case 0:
+            feedRandomly( &p, stream, len );
+            break;
+         case 1: {
+            uint16_t rd = (uint16_t)(HT_rand( &l_seed ) % sizeof(ring));
+            for ( int pos = 0; pos < len; ) {
+               uint16_t wr = rd;
+               int n = 1 + (int)(HT_rand( &l_seed ) % (sizeof(ring) / 2));
+               for ( ; n > 0 && pos < len; n-- ) {
+                  ring[wr] = stream[pos++];
+                  wr = (uint16_t)((wr + 1) % sizeof(ring));
+               }
+               CommFrame_feedRing( &p, ring, sizeof(ring), rd, wr );
+               rd = wr;
+            }
+            break;
+         }
+         default: {
+            B64S_EncState enc;
+            B64S_DecState dec;
+            int consumed;
+            B64S_encodeInit( &enc );
+            int nText = B64S_encodeChunk( &enc, stream, len, text,
+                  sizeof(text), &consumed );
+            nText += B64S_encodeFinal( &enc, &text[nText] );
+            B64S_decodeInit( &dec );
+            for ( int pos = 0; pos < nText; ) {
+               int n = 1 + (int)(HT_rand( &l_seed ) % 97);
+               if ( n > nText - pos ) {
+                  n = nText - pos;
+               }
+               CommFrame_feedBase64( &p, &dec, &text[pos], (uint16_t)n );
+               pos += n;
+            }
+            break;
+         }
+      }
+
+      nLost     += ( 1 != l_rx.seen[0xBEEF] );
+      nMiscount += ( (uint32_t)len != p.nBytes );
+      for ( int f = 0; f < nFrames; f++ ) {
+         nTwice += ( l_rx.seen[100 + f] > 1 );
+      }
+      CommFrame_reset( &p );
+      nLeaked += ( 0 != l_pool.nOut );
+   }
+
+   HT_CHECK_MSG( 0 == nLost, "%d clean frames lost", nLost );
+   HT_CHECK_MSG( 0 == nTwice, "%d frames seen twice", nTwice );
+   HT_CHECK_MSG( 0 == nMiscount, "%d streams miscounted", nMiscount );
+   HT_CHECK_MSG( 0 == nLeaked, "%d streams leaked buffers", nLeaked );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_clean();
+   test_lenErrorResync();
+   test_crcErrorResync();
+   test_noise();
+   test_noBuffer();
+   test_ring();
+   test_fuzz();
+   return( HT_DONE( "comm_frame_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
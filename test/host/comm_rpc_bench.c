@@ -0,0 +1,559 @@
+/**
+ * @file   comm_rpc_bench.c
+ * @brief  Host benchmark of pipelined requests through the pending request
+ * table of comm.c.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * A client sends tagged requests over a loopback link with 1ms of latency
+ * each way.  They go through the real comm_frame.c parser and the real
+ * COMM_dispatchFrame(), COMM_handleRpcDone() and COMM_expireRpcs() of
+ * comm.c, on the real QP event pools, in simulated milliseconds.  The CPLR
+ * task is stood in for by one that serves its queue a request at a time,
+ * 1 to 3ms each, and echoes the request back.  It loses one request in 256
+ * and answers it after the request has timed out.
+ *
+ * The client keeps 1, 4, 16, 24 and 32 requests in flight and prints the
+ * throughput and how many were NAKed for a full table or for timing out.
+ * Every answer has to match the request with its seq, a full table has to
+ * NAK only past COMM_RPC_MAX_PENDING in flight, and a timed out slot has to
+ * be reused while its late answer is dropped.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "comm.h"
+#include "CommStackMgr.h"
+#include "LWIPMgr.h"                             /* For ETH_SYS_TCP_SEND_SIG */
+#include "i2c_dev.h"
+#include "cplr.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define RUN_MS                  20000  /**< Time the client keeps sending */
+#define DRAIN_MS                (COMM_RPC_TIMEOUT_MS + 1000)
+#define LINK_MS                 1               /**< Latency each way */
+#define LINK_LEN                256            /**< Frames the link holds */
+#define LOST_EVERY              256  /**< CPLR loses one request in this many */
+#define LATE_MS                 (COMM_RPC_TIMEOUT_MS + 500)
+#define MAX_REQ_PAYLOAD         32
+#define MAX_WINDOW              32
+#define CPLR_Q_LEN              (COMM_RPC_MAX_PENDING + 4)/**< Same as main.c */
+#define POOL_EVTS               64
+
+/* Private typedefs ----------------------------------------------------------*/
+/**< A frame on its way over the link */
+typedef struct {
+   uint32_t dueMs;
+   uint16_t len;
+   uint8_t  data[MAX_MSG_LEN];
+} LinkMsg_t;
+
+/**< One direction of the link */
+typedef struct {
+   LinkMsg_t msgs[LINK_LEN];
+   uint32_t  head;
+   uint32_t  tail;
+} Link_t;
+
+/**< A request the client is waiting on */
+typedef struct {
+   bool     isUsed;
+   uint16_t seq;
+   uint8_t  type;
+   uint8_t  len;
+   uint8_t  data[MAX_REQ_PAYLOAD];
+   uint32_t sentMs;
+} ClientReq_t;
+
+/**< A request the CPLR stand-in lost and answers late */
+typedef struct {
+   uint32_t dueMs;
+   uint16_t tag;
+   uint16_t len;
+   uint8_t  data[MAX_REQ_PAYLOAD];
+} LateReq_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0xC0117A6u;
+static uint32_t l_now;                            /**< Simulated milliseconds */
+
+static Link_t   l_toServer;
+static Link_t   l_toClient;
+
+static union {
+   CommRpcEvt rpc;
+   LrgDataEvt lrg;
+} l_poolSto[POOL_EVTS];
+
+/**< CommStackMgr, which handles what's posted to it right away */
+static bool mgrPost( QActive * const me, QEvt const * const e,
+      uint_fast16_t const margin );
+static QActiveVtbl const l_mgrVtbl = { { 0, 0 }, 0, &mgrPost, 0 };
+static QActive           l_mgr;
+QActive * const AO_CommStackMgr = &l_mgr;
+
+/**< The server end of the link */
+static CommFrameParser_t l_srvParser;
+static CommFrameEvt      l_srvEvt;
+
+/**< The client */
+static CommFrameParser_t l_cliParser;
+static uint8_t           l_cliBuf[COMM_FRAME_MAX_PAYLOAD];
+static struct {
+   ClientReq_t reqs[MAX_WINDOW];
+   uint16_t    nextSeq;
+   int         nInFlight;
+   uint32_t    nSent;
+   uint32_t    nOk;
+   uint32_t    nBusy;
+   uint32_t    nTimeout;
+   uint32_t    nOtherNak;
+   uint32_t    nMismatch;      /**< Answers that don't match their request */
+   uint64_t    latencyMs;
+} l_cli;
+
+/**< The CPLR task */
+QEQueue CPLR_evtQueue;
+static QEvt const *l_cplrQSto[CPLR_Q_LEN];
+static struct {
+   CommRpcEvt const *busy;                /**< Request being served now */
+   uint32_t          doneMs;
+   bool              isStalled;             /**< Doesn't take requests */
+   LateReq_t         late[COMM_RPC_MAX_PENDING * 2];
+   int               nLate;
+   uint32_t          nLost;
+   uint16_t          tags[COMM_RPC_MAX_PENDING * 2];    /**< Tags it took */
+   int               nTags;
+} l_cplr;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+void Q_onAssert( char_t const * const module, int_t location )
+{
+   fprintf( stderr, "assert %s:%d at %ums\n", module, (int)location, l_now );
+   exit( 1 );
+}
+
+/******************************************************************************/
+void * MEM_DataCopy( void * destination, const void * source, uint16_t num )
+{
+   return( memcpy( destination, source, num ) );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_readDevMemEVT( I2C_Dev_t iDev, uint16_t offset,
+      uint16_t bytesToRead, AccessType_t accType, QActive* callingAO,
+      uint8_t *pBuffer, uint16_t tag )
+{
+   return( ERR_COMM_UNIMPLEMENTED_MSG );          /* No I2C requests here */
+}
+
+/******************************************************************************/
+CBErrorCode I2C_writeDevMemEVT( I2C_Dev_t iDev, uint16_t offset,
+      uint16_t bytesToWrite, AccessType_t accType, QActive* callingAO,
+      uint8_t *pBuffer, uint16_t tag )
+{
+   return( ERR_COMM_UNIMPLEMENTED_MSG );
+}
+
+/******************************************************************************/
+void CPLR_wake( void )
+{
+}
+
+/******************************************************************************/
+static void linkSend( Link_t *link, const uint8_t *data, uint16_t len )
+{
+   HT_CHECK( link->head - link->tail < LINK_LEN );
+   LinkMsg_t *m = &link->msgs[link->head++ % LINK_LEN];
+   m->dueMs = l_now + LINK_MS;
+   m->len   = len;
+   memcpy( m->data, data, len );
+}
+
+/******************************************************************************/
+static void linkDeliver( Link_t *link, CommFrameParser_t *parser )
+{
+   while ( link->tail != link->head ) {
+      LinkMsg_t *m = &link->msgs[link->tail % LINK_LEN];
+      if ( m->dueMs > l_now ) {
+         break;
+      }
+      link->tail++;
+      CommFrame_feed( parser, m->data, m->len );
+   }
+}
+
+/******************************************************************************/
+void QF_publish_( QEvt const * const e )
+{
+   /* COMM_sendFrame() to ETH_PORT_SYS is the only publisher here */
+   HT_CHECK( ETH_SYS_TCP_SEND_SIG == e->sig );
+   LrgDataEvt const *lrg = (LrgDataEvt const *)e;
+   HT_CHECK( ETH_PORT_SYS == lrg->dst );
+   linkSend( &l_toClient, lrg->dataBuf, lrg->dataLen );
+   QF_gc( e );
+}
+
+/******************************************************************************/
+static bool mgrPost( QActive * const me, QEvt const * const e,
+      uint_fast16_t const margin )
+{
+   (void)me; (void)margin;
+   HT_CHECK( MSG_RPC_DONE_SIG == e->sig );
+   COMM_handleRpcDone( e );
+   QF_gc( e );
+   return( true );
+}
+
+/******************************************************************************/
+static uint8_t* srvGetBuffer( void *ctx, const CommFrameHdr_t *hdr )
+{
+   (void)ctx; (void)hdr;
+   return( l_srvEvt.dataBuf );
+}
+
+/******************************************************************************/
+static void srvHandler( void *ctx, const CommFrameHdr_t *hdr,
+      uint8_t *payload, bool isValid )
+{
+   (void)ctx; (void)payload;
+   HT_CHECK( isValid );
+   if ( !isValid ) {
+      return;
+   }
+
+   /* What the TCP server publishes and CommStackMgr dispatches */
+   l_srvEvt.super.sig = MSG_FRAME_RECEIVED_SIG;
+   l_srvEvt.src       = ETH_PORT_SYS;
+   l_srvEvt.type      = hdr->type;
+   l_srvEvt.seq       = hdr->seq;
+   l_srvEvt.dataLen   = hdr->len;
+   COMM_dispatchFrame( &l_srvEvt );
+}
+
+/******************************************************************************/
+static uint8_t* cliGetBuffer( void *ctx, const CommFrameHdr_t *hdr )
+{
+   (void)ctx; (void)hdr;
+   return( l_cliBuf );
+}
+
+/**
+ * @brief   Look up the request the client sent with a seq.
+ * @param [in] seq: uint16_t seq of the request.
+ * @return: ClientReq_t pointer to the request or NULL if none is in flight.
+ */
+static ClientReq_t* cliFind( uint16_t seq )
+{
+   /* Lost requests stay in flight until they time out, so seqs don't map to
+    * entries in any fixed way */
+   for ( int i = 0; i < MAX_WINDOW; i++ ) {
+      if ( l_cli.reqs[i].isUsed && seq == l_cli.reqs[i].seq ) {
+         return( &l_cli.reqs[i] );
+      }
+   }
+   return( NULL );
+}
+
+/******************************************************************************/
+static void cliHandler( void *ctx, const CommFrameHdr_t *hdr,
+      uint8_t *payload, bool isValid )
+{
+   (void)ctx;
+   HT_CHECK( isValid );
+   if ( !isValid ) {
+      return;
+   }
+
+   ClientReq_t *req = cliFind( hdr->seq );
+   if ( NULL == req ) {
+      l_cli.nMismatch++;
+      return;
+   }
+
+   if ( COMM_FRAME_TYPE_NAK == hdr->type && sizeof(uint32_t) == hdr->len ) {
+      uint32_t status = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8) |
+            ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24);
+      if ( ERR_COMM_RPC_BUSY == status ) {
+         l_cli.nBusy++;
+      } else if ( ERR_COMM_RPC_TIMEOUT == status ) {
+         l_cli.nTimeout++;
+      } else {
+         l_cli.nOtherNak++;
+      }
+   } else if ( (req->type | COMM_FRAME_RSP_BIT) == hdr->type &&
+         req->len == hdr->len && 0 == memcmp( payload, req->data, req->len ) ) {
+      l_cli.nOk++;
+      l_cli.latencyMs += l_now - req->sentMs;
+   } else {
+      l_cli.nMismatch++;
+   }
+
+   req->isUsed = false;
+   l_cli.nInFlight--;
+}
+
+/**
+ * @brief   Send one request from the client.
+ * @param [in] type: uint8_t CommFrameType_t of the request.
+ * @return: uint16_t seq of the request.
+ */
+static uint16_t cliSend( uint8_t type )
+{
+   uint8_t frame[MAX_REQ_PAYLOAD + COMM_FRAME_OVERHEAD];
+   uint16_t seq = l_cli.nextSeq++;
+   ClientReq_t *req = &l_cli.reqs[0];
+
+   while ( req->isUsed ) {
+      req++;
+   }
+   HT_CHECK( req < &l_cli.reqs[MAX_WINDOW] );
+   req->isUsed = true;
+   req->seq    = seq;
+   req->type   = type;
+   req->len    = (uint8_t)(HT_rand( &l_seed ) % (MAX_REQ_PAYLOAD + 1));
+   req->sentMs = l_now;
+   for ( int k = 0; k < req->len; k++ ) {
+      req->data[k] = (uint8_t)HT_rand( &l_seed );
+   }
+
+   uint16_t n = CommFrame_encode( frame, sizeof(frame), type, seq, req->data,
+         req->len );
+   linkSend( &l_toServer, frame, n );
+   l_cli.nInFlight++;
+   l_cli.nSent++;
+   return( seq );
+}
+
+/******************************************************************************/
+static void cplrStep( void )
+{
+   /* Lost requests get their answer long after they timed out */
+   for ( int i = 0; i < l_cplr.nLate; ) {
+      LateReq_t *late = &l_cplr.late[i];
+      if ( late->dueMs > l_now ) {
+         i++;
+         continue;
+      }
+      COMM_postRpcDone( late->tag, ERR_NONE, late->data, late->len, NULL );
+      *late = l_cplr.late[--l_cplr.nLate];
+   }
+
+   if ( NULL != l_cplr.busy && l_cplr.doneMs <= l_now ) {
+      CommRpcEvt const *req = l_cplr.busy;
+      COMM_postRpcDone( req->tag, ERR_NONE, req->dataBuf, req->dataLen, NULL );
+      QF_gc( (QEvt const *)req );
+      l_cplr.busy = NULL;
+   }
+
+   if ( NULL != l_cplr.busy || l_cplr.isStalled ) {
+      return;
+   }
+
+   CommRpcEvt const *req = (CommRpcEvt const *)QEQueue_get( &CPLR_evtQueue );
+   if ( NULL == req ) {
+      return;
+   }
+   HT_CHECK( CPLR_RPC_REQ_SIG == req->super.sig );
+   l_cplr.tags[l_cplr.nTags++ % (COMM_RPC_MAX_PENDING * 2)] = req->tag;
+
+   if ( 0 == HT_rand( &l_seed ) % LOST_EVERY &&
+         l_cplr.nLate < (int)(sizeof(l_cplr.late) / sizeof(l_cplr.late[0])) ) {
+      LateReq_t *late = &l_cplr.late[l_cplr.nLate++];
+      late->dueMs = l_now + LATE_MS;
+      late->tag   = req->tag;
+      late->len   = req->dataLen;
+      memcpy( late->data, req->dataBuf, req->dataLen );
+      l_cplr.nLost++;
+      QF_gc( (QEvt const *)req );
+      return;
+   }
+
+   l_cplr.busy   = req;
+   l_cplr.doneMs = l_now + 1 + HT_rand( &l_seed ) % 3;
+}
+
+/******************************************************************************/
+static void step( void )
+{
+   linkDeliver( &l_toServer, &l_srvParser );
+   cplrStep();
+   linkDeliver( &l_toClient, &l_cliParser );
+   if ( 0 == l_now % COMM_RPC_TICK_MS ) {
+      COMM_expireRpcs();                           /* MSG_RPC_TIMER_SIG */
+   }
+   l_now++;
+}
+
+/******************************************************************************/
+static void start( void )
+{
+   memset( &l_cli, 0, sizeof(l_cli) );
+   l_cli.nextSeq = 1;
+   l_cplr.nLost  = 0;
+   l_cplr.nTags  = 0;
+   CommFrame_init( &l_srvParser, COMM_FRAME_MAX_PAYLOAD, srvGetBuffer,
+         srvHandler, NULL );
+   CommFrame_init( &l_cliParser, COMM_FRAME_MAX_PAYLOAD, cliGetBuffer,
+         cliHandler, NULL );
+}
+
+/******************************************************************************/
+static void test_slots( void )
+{
+   uint16_t seqs[COMM_RPC_MAX_PENDING + 1];
+   uint16_t oldTags[COMM_RPC_MAX_PENDING];
+   CommRpcStats_t before = *COMM_getRpcStats();
+
+   /* With the CPLR task stuck, one request more than the table holds.  Only
+    * the last one is NAKed and it's NAKed right away. */
+   start();
+   l_cplr.isStalled = true;
+   for ( int i = 0; i <= COMM_RPC_MAX_PENDING; i++ ) {
+      seqs[i] = cliSend( COMM_FRAME_TYPE_CPLR_TEST );
+   }
+   for ( int t = 0; t < 2 * LINK_MS + 1; t++ ) {
+      step();
+   }
+   HT_CHECK( COMM_RPC_MAX_PENDING == COMM_getRpcStats()->nPending );
+   HT_CHECK( 1 == l_cli.nBusy && COMM_RPC_MAX_PENDING == l_cli.nInFlight );
+   HT_CHECK( NULL == cliFind( seqs[COMM_RPC_MAX_PENDING] ) );
+   HT_CHECK( before.nBusy + 1 == COMM_getRpcStats()->nBusy );
+
+   /* Every one of them times out, each NAK with its own seq */
+   CommRpcEvt const *req;
+   int n = 0;
+   while ( NULL != (req = (CommRpcEvt const *)QEQueue_get( &CPLR_evtQueue )) ) {
+      oldTags[n++] = req->tag;
+      QF_gc( (QEvt const *)req );
+   }
+   HT_CHECK( COMM_RPC_MAX_PENDING == n );
+   for ( int t = 0; t < COMM_RPC_TIMEOUT_MS + COMM_RPC_TICK_MS; t++ ) {
+      step();
+   }
+   HT_CHECK( COMM_RPC_MAX_PENDING == l_cli.nTimeout && 0 == l_cli.nInFlight );
+   HT_CHECK( 0 == COMM_getRpcStats()->nPending && 0 == l_cli.nMismatch );
+
+   /* Answers that show up now are dropped */
+   for ( int i = 0; i < n; i++ ) {
+      COMM_postRpcDone( oldTags[i], ERR_NONE, NULL, 0, NULL );
+   }
+   for ( int t = 0; t < 2 * LINK_MS + 1; t++ ) {
+      step();
+   }
+   HT_CHECK( before.nStale + n == COMM_getRpcStats()->nStale );
+   HT_CHECK( 0 == l_cli.nOk && 0 == l_cli.nMismatch );
+
+   /* The same slots take new requests, under new tags */
+   l_cplr.isStalled = false;
+   l_cplr.nTags     = 0;
+   for ( int i = 0; i < COMM_RPC_MAX_PENDING; i++ ) {
+      cliSend( COMM_FRAME_TYPE_CPLR_TEST );
+   }
+   for ( int t = 0; t < 100; t++ ) {
+      step();
+   }
+   HT_CHECK( COMM_RPC_MAX_PENDING == l_cli.nOk && 1 == l_cli.nBusy );
+   HT_CHECK( COMM_RPC_MAX_PENDING == l_cplr.nTags );
+
+   uint32_t slots = 0;
+   int nReused = 0;
+   for ( int i = 0; i < l_cplr.nTags; i++ ) {
+      slots |= 1UL << (l_cplr.tags[i] & (COMM_RPC_MAX_PENDING - 1));
+      for ( int k = 0; k < n; k++ ) {
+         nReused += ( oldTags[k] == l_cplr.tags[i] );
+      }
+   }
+   HT_CHECK( (1UL << COMM_RPC_MAX_PENDING) - 1 == slots && 0 == nReused );
+}
+
+/**
+ * @brief   Keep a number of requests in flight for a while and report.
+ * @param [in] window: int requests the client keeps in flight.
+ * @param [out] *reqPerSec: double pointer to the answered requests/s.
+ * @return: None
+ */
+static void runWindow( int window, double *reqPerSec )
+{
+   CommRpcStats_t before = *COMM_getRpcStats();
+   start();
+
+   uint64_t t0 = HT_nowNs();
+   for ( uint32_t t = 0; t < RUN_MS + DRAIN_MS; t++ ) {
+      while ( t < RUN_MS && l_cli.nInFlight < window ) {
+         /* Mostly requests for the CPLR task, some answered right away */
+         cliSend( ( 0 == HT_rand( &l_seed ) % 8 ) ? COMM_FRAME_TYPE_PING :
+               COMM_FRAME_TYPE_CPLR_TEST );
+      }
+      step();
+   }
+   uint64_t ns = HT_nowNs() - t0;
+
+   CommRpcStats_t const *st = COMM_getRpcStats();
+   uint32_t nStale = st->nStale - before.nStale;
+
+   HT_CHECK_MSG( 0 == l_cli.nMismatch, "window %d: %u answers mismatched",
+         window, l_cli.nMismatch );
+   HT_CHECK( 0 == l_cli.nInFlight && 0 == st->nPending );
+   HT_CHECK( 0 == l_cli.nOtherNak );
+   HT_CHECK( l_cli.nSent == l_cli.nOk + l_cli.nBusy + l_cli.nTimeout );
+   HT_CHECK( l_cli.nBusy == st->nBusy - before.nBusy );
+   HT_CHECK( l_cplr.nLost == l_cli.nTimeout && l_cplr.nLost == nStale );
+   HT_CHECK( st->nTimeouts - before.nTimeouts == l_cli.nTimeout );
+   if ( window <= COMM_RPC_MAX_PENDING ) {
+      /* Timed out slots came back or these would have been NAKed */
+      HT_CHECK_MSG( 0 == l_cli.nBusy, "window %d: %u busy", window,
+            l_cli.nBusy );
+   } else {
+      HT_CHECK( l_cli.nBusy > 0 && COMM_RPC_MAX_PENDING == st->maxPending );
+   }
+
+   *reqPerSec = (double)l_cli.nOk / (RUN_MS / 1000.0);
+   printf( "%6d | %7u | %8.0f | %6u | %7u | %5u | %7.2f | %7.0f\n",
+         window, l_cli.nOk, *reqPerSec, l_cli.nBusy, l_cli.nTimeout, nStale,
+         l_cli.nOk ? (double)l_cli.latencyMs / l_cli.nOk : 0.0,
+         (double)ns / l_cli.nSent );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   static int const windows[] = { 1, 4, 16, 24, 32 };
+   double reqPerSec[sizeof(windows) / sizeof(windows[0])];
+
+   l_mgr.super.vptr = &l_mgrVtbl.super;
+   QF_poolInit( l_poolSto, sizeof(l_poolSto), sizeof(l_poolSto[0]) );
+   QEQueue_init( &CPLR_evtQueue, l_cplrQSto, Q_DIM(l_cplrQSto) );
+
+   test_slots();
+
+   printf( "window |      ok |    req/s |   busy | timeout | stale |  lat ms |"
+         " host ns/req\n" );
+   for ( unsigned i = 0; i < sizeof(windows) / sizeof(windows[0]); i++ ) {
+      runWindow( windows[i], &reqPerSec[i] );
+   }
+
+   /* Pipelining is the point of the table */
+   HT_CHECK( reqPerSec[1] > 2.0 * reqPerSec[0] );
+   HT_CHECK( reqPerSec[2] >= reqPerSec[1] );
+   HT_CHECK( QF_getPoolMin( 1 ) > 0 );
+
+   return( HT_DONE( "comm_rpc_bench" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
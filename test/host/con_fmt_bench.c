@@ -0,0 +1,105 @@
+/**
+ * @file   con_fmt_bench.c
+ * @brief  Host benchmark of the console formatter against the C library
+ * snprintf.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Prints the cycles per call of both formatters for the kinds of lines the
+ * debug and menu output produce.  The absolute numbers are the host's; the
+ * ratio is what carries over to the target, where newlib's formatter is
+ * slower still.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "con_fmt.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_CALLS             200000
+#define BENCH_BUF_LEN           128              /**< Same as a log line */
+
+/* Private typedefs ----------------------------------------------------------*/
+typedef int (*SnprintfFn)( char *buf, size_t size, const char *fmt, ... );
+
+/* Private variables and Local objects ---------------------------------------*/
+static char l_buf[BENCH_BUF_LEN];
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static double bench_header( SnprintfFn fn )
+{
+   uint64_t t0 = HT_cycles();
+   for ( int i = 0; i < BENCH_CALLS; i++ ) {
+      fn( l_buf, sizeof(l_buf), "DBG-%02d:%02d:%02d.%03d-%s():%d:",
+            i % 24, i % 60, (i >> 6) % 60, i % 1000, "COMM_handleI2CWrite", 224 );
+   }
+   return( (double)(HT_cycles() - t0) / BENCH_CALLS );
+}
+
+/******************************************************************************/
+static double bench_hex( SnprintfFn fn )
+{
+   uint64_t t0 = HT_cycles();
+   for ( int i = 0; i < BENCH_CALLS; i++ ) {
+      fn( l_buf, sizeof(l_buf), "0x%08x 0x%08X %5u %-6s|",
+            (unsigned)i * 2654435761u, (unsigned)i, (unsigned)i & 0xFFFF, "rx" );
+   }
+   return( (double)(HT_cycles() - t0) / BENCH_CALLS );
+}
+
+/******************************************************************************/
+static double bench_string( SnprintfFn fn )
+{
+   uint64_t t0 = HT_cycles();
+   for ( int i = 0; i < BENCH_CALLS; i++ ) {
+      fn( l_buf, sizeof(l_buf), "%s %s %.*s",
+            "Ethernet link is", ( i & 1 ) ? "up" : "down", 8, "overflowed text" );
+   }
+   return( (double)(HT_cycles() - t0) / BENCH_CALLS );
+}
+
+/******************************************************************************/
+static double bench_truncated( SnprintfFn fn )
+{
+   uint64_t t0 = HT_cycles();
+   for ( int i = 0; i < BENCH_CALLS; i++ ) {
+      fn( l_buf, 24, "%d %d %d %d %d %d %d %d", i, -i, i, -i, i, -i, i, -i );
+   }
+   return( (double)(HT_cycles() - t0) / BENCH_CALLS );
+}
+
+/******************************************************************************/
+static void report( const char *name, double (*bench)( SnprintfFn ) )
+{
+   bench( FMT_snprintf );                                       /* Warm up */
+   double fmt  = bench( FMT_snprintf );
+   double libc = bench( snprintf );
+   printf( "%-10s FMT_snprintf %7.1f  snprintf %7.1f cycles/call   x%.2f\n",
+         name, fmt, libc, libc / fmt );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   report( "header", bench_header );
+   report( "hex", bench_hex );
+   report( "string", bench_string );
+   report( "truncated", bench_truncated );
+   return( HT_DONE( "con_fmt_bench" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,238 @@
+/**
+ * @file   con_fmt_test.c
+ * @brief  Host test of the console formatter against the C library snprintf.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Every supported conversion is run with random flags, widths, precisions
+ * (as digits and as '*'), and values, and the output has to match the host's
+ * vsnprintf() at every buffer size from 0 to past the end of the output.
+ * The one documented difference is the return value: FMT_vsnprintf() returns
+ * what it wrote, not what it would have written.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "con_fmt.h"
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_OUT                 160       /**< Longer than any output here */
+#define N_RANDOM                20000         /**< Random specs to compare */
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0xF0F0C0DEu;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void check( const char *fmt, ... )
+{
+   char ref[MAX_OUT];
+   char buf[MAX_OUT + 1];
+   va_list args, copy;
+
+   va_start( args, fmt );
+   va_copy( copy, args );
+   int full = vsnprintf( ref, sizeof(ref), fmt, copy );
+   va_end( copy );
+
+   for ( int size = 0; size <= full + 2 && size <= MAX_OUT; size++ ) {
+      memset( buf, '#', sizeof(buf) );
+      va_copy( copy, args );
+      int n = FMT_vsnprintf( buf, (size_t)size, fmt, copy );
+      va_end( copy );
+
+      int expect = ( 0 == size ) ? 0 : ( full < size ? full : size - 1 );
+      HT_CHECK_MSG( n == expect, "\"%s\" size %d: returned %d, expected %d",
+            fmt, size, n, expect );
+      if ( size > 0 ) {
+         HT_CHECK_MSG( 0 == memcmp( buf, ref, expect ) && '\0' == buf[expect],
+               "\"%s\" size %d: \"%.*s\" vs \"%.*s\"", fmt, size, n, buf,
+               expect, ref );
+      }
+      HT_CHECK_MSG( '#' == buf[size], "\"%s\" size %d: wrote past the end",
+            fmt, size );
+   }
+   va_end( args );
+}
+
+/******************************************************************************/
+static int rnd( int n )
+{
+   return( (int)(HT_rand( &l_seed ) % (uint32_t)n) );
+}
+
+/******************************************************************************/
+static int32_t rndInt( void )
+{
+   static const int32_t edges[] = {
+      0, 1, -1, 9, 10, -10, 255, 256, 0x7FFF, -0x8000, INT32_MAX, INT32_MIN
+   };
+   switch ( rnd( 3 ) ) {
+      case 0:  return( edges[rnd( sizeof(edges) / sizeof(edges[0]) )] );
+      case 1:  return( (int32_t)(HT_rand( &l_seed ) >> rnd( 32 )) * (rnd( 2 ) ? 1 : -1) );
+      default: return( (int32_t)HT_rand( &l_seed ) );
+   }
+}
+
+/******************************************************************************/
+static void test_random( void )
+{
+   static const char convs[]   = "diuxXocsp";
+   static const char *strs[]   = { "", "a", "hello", "0123456789abcdef", NULL };
+
+   for ( int i = 0; i < N_RANDOM; i++ ) {
+      char conv = convs[rnd( sizeof(convs) - 1 )];
+      bool isNum = ( NULL != strchr( "diuxXo", conv ) );
+      char fmt[32];
+      int  pos = 0;
+
+      if ( rnd( 2 ) ) {
+         pos += sprintf( &fmt[pos], "<" );
+      }
+      fmt[pos++] = '%';
+
+      /* '0' is only defined for the numeric conversions */
+      int flags = rnd( 4 );
+      if ( flags & 1 ) {
+         fmt[pos++] = '-';
+      }
+      if ( (flags & 2) && isNum ) {
+         fmt[pos++] = '0';
+      }
+
+      int starW = 0, starP = 0, w = 0, p = 0;
+      switch ( rnd( 3 ) ) {
+         case 1: pos += sprintf( &fmt[pos], "%d", 1 + rnd( 20 ) ); break;
+         case 2: fmt[pos++] = '*'; starW = 1; w = rnd( 41 ) - 20; break;
+         default: break;
+      }
+
+      /* No precision on %c and %p, where it's undefined */
+      if ( 'c' != conv && 'p' != conv ) {
+         switch ( rnd( 4 ) ) {
+            case 1: pos += sprintf( &fmt[pos], ".%d", rnd( 14 ) ); break;
+            case 2: pos += sprintf( &fmt[pos], "." ); break;
+            case 3: pos += sprintf( &fmt[pos], ".*" ); starP = 1; p = rnd( 20 ) - 4; break;
+            default: break;
+         }
+      }
+
+      /* Length modifiers only where the host agrees with the 32 bit target */
+      int32_t val = rndInt();
+      bool isLong = false;
+      if ( isNum ) {
+         switch ( rnd( 4 ) ) {
+            case 1: fmt[pos++] = 'l'; isLong = true; break;
+            case 2:
+               fmt[pos++] = 'h';
+               val = ( 'd' == conv || 'i' == conv ) ? (int16_t)val : (uint16_t)val;
+               break;
+            case 3:
+               fmt[pos++] = 'h'; fmt[pos++] = 'h';
+               val = ( 'd' == conv || 'i' == conv ) ? (int8_t)val : (uint8_t)val;
+               break;
+            default: break;
+         }
+      }
+      fmt[pos++] = conv;
+      if ( rnd( 2 ) ) {
+         pos += sprintf( &fmt[pos], ">" );
+      }
+      fmt[pos] = '\0';
+
+      /* Every combination of '*' arguments in front of the value */
+      #define CHECK_ARG( arg_ ) do {                                          \
+         if ( starW && starP )  check( fmt, w, p, arg_ );                    \
+         else if ( starW )      check( fmt, w, arg_ );                       \
+         else if ( starP )      check( fmt, p, arg_ );                       \
+         else                   check( fmt, arg_ );                          \
+      } while (0)
+
+      if ( 's' == conv ) {
+         const char *s = strs[rnd( sizeof(strs) / sizeof(strs[0]) - 1 )];
+         CHECK_ARG( s );
+      } else if ( 'p' == conv ) {
+         void *ptr = (void *)(uintptr_t)(1 + (HT_rand( &l_seed ) >> rnd( 32 )));
+         CHECK_ARG( ptr );
+      } else if ( 'c' == conv ) {
+         CHECK_ARG( ' ' + rnd( 95 ) );
+      } else if ( isLong ) {
+         long lval = ( 'd' == conv || 'i' == conv ) ? (long)val : (long)(uint32_t)val;
+         CHECK_ARG( lval );
+      } else {
+         CHECK_ARG( val );
+      }
+      #undef CHECK_ARG
+   }
+}
+
+/******************************************************************************/
+static void test_fixed( void )
+{
+   /* The kind of lines the debug and menu output produce */
+   check( "%s:%d: %02x %-8s|%5u|", "comm.c", 224, 0xA5, "I2C", 42u );
+   check( "DBG-%02d:%02d:%02d.%03d-%s():%d:", 1, 2, 3, 45, "main", 120 );
+   check( "%08X %08x %o %%", 0xDEADBEEFu, 0x1234u, 0777u );
+   check( "[%*s][%-*s][%.*s]", 6, "ab", 6, "cd", 2, "efgh" );
+   check( "%.0d|%.0x|%5.0u|%-5.0o|", 0, 0, 0u, 0u );
+   check( "%.3d|%08.3d|%-08d|%0-8d|", -7, -7, -7, -7 );
+   check( "%d %d", INT32_MIN, INT32_MAX );
+   check( "%s", (char *)NULL );
+   check( "%c%c%c", 'a', 'b', 'c' );
+   check( "%5c|%-5c|", 'x', 'y' );
+   check( "%zu %zx", (size_t)123, (size_t)0xabc );
+   check( "no conversions at all" );
+   check( "" );
+
+   /* Documented differences: unsupported conversions are copied as is */
+   char buf[32];
+   HT_CHECK( 5 == FMT_snprintf( buf, sizeof(buf), "a%qb%", 1 ) );
+   HT_CHECK( 0 == strcmp( buf, "a%qb%" ) );
+   HT_CHECK( 4 == FMT_snprintf( buf, sizeof(buf), "x%-5", 1 ) );
+   HT_CHECK( 0 == strcmp( buf, "x%-5" ) );
+   HT_CHECK( 2 == FMT_snprintf( buf, sizeof(buf), "%f", 1.0 ) );
+   HT_CHECK( 0 == strcmp( buf, "%f" ) );
+
+   /* The return value can always be added to a running index */
+   char line[16];
+   int  idx = 0;
+   for ( int i = 0; i < 10; i++ ) {
+      idx += FMT_snprintf( &line[idx], sizeof(line) - idx, "%d,", 1000 + i );
+   }
+   HT_CHECK( (int)sizeof(line) - 1 == idx );
+   HT_CHECK( 0 == strcmp( line, "1000,1001,1002," ) );
+
+   char hex[3] = { 0 };
+   for ( int b = 0; b < 256; b++ ) {
+      char ref[3];
+      snprintf( ref, sizeof(ref), "%02x", b );
+      FMT_byteToHex( hex, (uint8_t)b );
+      HT_CHECK( 0 == strcmp( hex, ref ) );
+   }
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_fixed();
+   test_random();
+   return( HT_DONE( "con_fmt_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
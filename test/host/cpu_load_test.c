@@ -0,0 +1,479 @@
+/**
+ * @file   cpu_load_test.c
+ * @brief  Host test of the per task CPU load accounting.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * cpu_load.c is built with CPU_LOAD_HOST_CLOCK against the firmware's own
+ * FreeRTOSConfig.h, forced in ahead of stub/FreeRTOS.h.  uxTaskGetSystemState()
+ * is a fake scheduler that hands out a run time counter and a total for every
+ * task that the test moves along, in microseconds, the way TIM2 counts:
+ *
+ * - The share of every task and of the idle task over a window, with the
+ *   polling task calling every 10 ms or late, and the busy load.
+ * - The average over the last CPU_LOAD_N_WINDOWS windows as they roll over
+ *   and the peak since boot, over random loads.
+ * - The run time counter and the task totals wrapping inside a window.
+ * - A window past CPU_LOAD_MAX_WINDOW_MS being thrown away, deleted tasks,
+ *   too many tasks and a total that ran ahead of the window.
+ * - portGET_RUN_TIME_COUNTER_VALUE() of the config counting microseconds of
+ *   the monotonic clock through CPU_LOAD_hostClock().
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "cpu_load.h"
+#include <string.h>
+#include <time.h>
+
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct FakeTask_t
+ * A task of the fake scheduler, what its handle points at.
+ */
+typedef struct FakeTasks
+{
+   const char *name;
+   uint32_t    total;                /**< Run time counter ticks it has run */
+   bool        bListed;     /**< In the list uxTaskGetSystemState() returns */
+} FakeTask_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define N_TASKS                 4           /**< Entries of the task table */
+#define IDLE                    N_TASKS     /**< Index of the idle task */
+#define N_FAKE                  ( CPU_LOAD_MAX_TASKS + 4 )
+#define STEP_MS                 10          /**< How often the poller runs */
+#define MAX_WINDOWS             64
+
+/* Private variables and Local objects ---------------------------------------*/
+static FakeTask_t l_fake[N_FAKE];
+static uint32_t   l_runTime;                 /**< The run time counter, us */
+static TickType_t l_tick;
+static int        l_nStateCalls;
+
+/**< Every closed window of every task and of the idle task, oldest first */
+static uint16_t   l_loads[N_TASKS + 1][MAX_WINDOWS];
+static int        l_nWindows;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+TickType_t xTaskGetTickCount( void )
+{
+   return( l_tick );
+}
+
+/******************************************************************************/
+TaskHandle_t xTaskGetIdleTaskHandle( void )
+{
+   return( &l_fake[IDLE] );
+}
+
+/******************************************************************************/
+UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
+      const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime )
+{
+   UBaseType_t n = 0;
+
+   l_nStateCalls++;
+   for ( int i = 0; i < N_FAKE; i++ ) {
+      n += l_fake[i].bListed;
+   }
+   if ( n > uxArraySize ) {
+      return( 0 );                             /* What FreeRTOS does too */
+   }
+
+   /* Listed in the reverse of their index, the order doesn't matter */
+   n = 0;
+   for ( int i = N_FAKE - 1; i >= 0; i-- ) {
+      if ( l_fake[i].bListed ) {
+         memset( &pxTaskStatusArray[n], 0, sizeof(pxTaskStatusArray[n]) );
+         pxTaskStatusArray[n].xHandle          = &l_fake[i];
+         pxTaskStatusArray[n].pcTaskName       = l_fake[i].name;
+         pxTaskStatusArray[n].xTaskNumber      = (UBaseType_t)i;
+         pxTaskStatusArray[n].eCurrentState    = eReady;
+         pxTaskStatusArray[n].ulRunTimeCounter = l_fake[i].total;
+         n++;
+      }
+   }
+   *pulTotalRunTime = l_runTime;
+   return( n );
+}
+
+/**
+ * @brief   Start over with the idle task and the first three of the table.
+ * @param [in] runTime: uint32_t the run time counter starts at.
+ * @param [in] tick: TickType_t the tick count starts at.
+ * @return: None
+ */
+static void start( uint32_t runTime, TickType_t tick )
+{
+   static const char * const names[N_FAKE] = {
+         "SerialMgr", "LWIPMgr", "CPLR", "notCreated", "IDLE",
+   };
+
+   memset( l_fake, 0, sizeof(l_fake) );
+   for ( int i = 0; i < N_FAKE; i++ ) {
+      l_fake[i].name = names[i];
+   }
+   l_runTime     = runTime;
+   l_tick        = tick;
+   l_nWindows    = 0;
+   l_nStateCalls = 0;
+
+   /* The idle task has run all along, the others are new */
+   l_fake[IDLE].bListed = true;
+   l_fake[IDLE].total   = runTime - 123456;
+
+   CPU_LOAD_init( N_TASKS );
+   for ( uint8_t i = 0; i < 3; i++ ) {
+      l_fake[i].bListed = true;
+      CPU_LOAD_attach( i, &l_fake[i], l_fake[i].name );
+   }
+}
+
+/**
+ * @brief   Let the tasks run, giving whatever is left over to the idle task.
+ * @param [in] ms: uint32_t time to run for.
+ * @param [in] *load: const uint16_t array of N_TASKS shares, in tenths of a
+ * percent, NULL for an idle CPU.
+ * @return: None
+ */
+static void runFor( uint32_t ms, const uint16_t *load )
+{
+   uint32_t us = ms * 1000;
+   uint32_t busy = 0;
+
+   for ( int i = 0; NULL != load && i < N_TASKS; i++ ) {
+      uint32_t ran = (uint32_t)( (uint64_t)us * load[i] / CPU_LOAD_FULL );
+      l_fake[i].total += ran;
+      busy += ran;
+   }
+   l_fake[IDLE].total += us - busy;
+   l_runTime += us;
+   l_tick    += ms;
+}
+
+/**
+ * @brief   Run a whole window with the poller called every STEP_MS.
+ * @param [in] *load: const uint16_t array of N_TASKS shares.
+ * @return: None
+ */
+static void window( const uint16_t *load )
+{
+   int calls = l_nStateCalls;
+
+   for ( int t = 0; t < CPU_LOAD_WINDOW_MS; t += STEP_MS ) {
+      runFor( STEP_MS, load );
+      CPU_LOAD_poll();
+   }
+   HT_CHECK( calls + 1 == l_nStateCalls );      /* Once it was time to */
+
+   uint16_t idle = CPU_LOAD_FULL;
+   for ( int i = 0; i < N_TASKS; i++ ) {
+      uint16_t l = ( 3 == i ) ? 0 : load[i];        /* Never created */
+      if ( l_nWindows < MAX_WINDOWS ) {
+         l_loads[i][l_nWindows] = l;
+      }
+      idle -= load[i];
+   }
+   if ( l_nWindows < MAX_WINDOWS ) {
+      l_loads[IDLE][l_nWindows] = idle;
+   }
+   l_nWindows++;
+}
+
+/**
+ * @brief   Compare a load with the windows recorded for it.
+ * @param [in] *pInfo: const CpuLoadInfo_t pointer to the load.
+ * @param [in] task: int index of the task in l_loads.
+ * @param [in] bBusy: bool the load is 1000 minus that of the task.
+ * @return: None
+ */
+static void checkLoad( const CpuLoadInfo_t *pInfo, int task, bool bBusy )
+{
+   int n = l_nWindows < CPU_LOAD_N_WINDOWS ? l_nWindows : CPU_LOAD_N_WINDOWS;
+   uint32_t sum = 0;
+   uint16_t peak = 0;
+
+   for ( int w = 0; w < l_nWindows; w++ ) {
+      uint16_t l = l_loads[task][w];
+      if ( w >= l_nWindows - n ) {
+         sum += l;
+      }
+      if ( bBusy ) {
+         l = CPU_LOAD_FULL - l;
+      }
+      if ( l > peak ) {
+         peak = l;
+      }
+   }
+   uint16_t last = l_loads[task][l_nWindows - 1];
+   uint16_t avg  = (uint16_t)( sum / n );
+   if ( bBusy ) {
+      last = CPU_LOAD_FULL - last;
+      avg  = CPU_LOAD_FULL - avg;
+   }
+
+   HT_CHECK_MSG( last == pInfo->last && avg == pInfo->avg &&
+         peak == pInfo->peak,
+         "window %d task %d: %u %u %u, not %u %u %u", l_nWindows, task,
+         pInfo->last, pInfo->avg, pInfo->peak, last, avg, peak );
+}
+
+/******************************************************************************/
+static void checkAll( void )
+{
+   CpuLoadInfo_t info;
+
+   for ( uint8_t i = 0; i < N_TASKS; i++ ) {
+      HT_CHECK( CPU_LOAD_getInfo( i, &info ) );
+      HT_CHECK( info.name == ( 3 == i ? NULL : l_fake[i].name ) );
+      HT_CHECK( info.bRunning == ( 3 != i ) );
+      checkLoad( &info, i, false );
+      HT_CHECK( info.last == CPU_LOAD_getLast( i ) );
+   }
+
+   int n = l_nWindows < CPU_LOAD_N_WINDOWS ? l_nWindows : CPU_LOAD_N_WINDOWS;
+   HT_CHECK( n == CPU_LOAD_getBusy( &info ) );
+   HT_CHECK( NULL == info.name && info.bRunning );
+   checkLoad( &info, IDLE, true );
+   HT_CHECK( info.last == CPU_LOAD_getBusyLast( 0 ) );
+}
+
+/**
+ * @brief   Shares of single windows, polled on time and late.
+ * @param   None
+ * @return: None
+ */
+static void test_shares( void )
+{
+   static const uint16_t load[N_TASKS] = { 300, 150, 25, 0 };
+   CpuLoadInfo_t info;
+
+   start( 5000000, 1000 );
+
+   /* Nothing is known until the first window closes */
+   CPU_LOAD_poll();
+   HT_CHECK( 1 == l_nStateCalls );
+   HT_CHECK( 0 == CPU_LOAD_getBusy( &info ) );
+   HT_CHECK( 0 == info.last && 0 == info.avg && 0 == info.peak );
+   HT_CHECK( 0 == CPU_LOAD_getBusyLast( 0 ) );
+   HT_CHECK( CPU_LOAD_getInfo( 0, &info ) && 0 == info.last );
+   HT_CHECK( N_TASKS == CPU_LOAD_getNTasks() );
+   HT_CHECK( !CPU_LOAD_getInfo( N_TASKS, &info ) );
+   HT_CHECK( 0 == CPU_LOAD_getLast( N_TASKS ) );
+
+   window( load );
+   checkAll();
+   HT_CHECK( 475 == CPU_LOAD_getBusyLast( 0 ) );
+   HT_CHECK( 300 == CPU_LOAD_getLast( 0 ) && 25 == CPU_LOAD_getLast( 2 ) );
+
+   /* Polled late, the shares are of the longer window */
+   static const uint16_t half[N_TASKS] = { 150, 75, 12, 0 };
+   runFor( 500, load );
+   runFor( 1000, half );
+   l_nStateCalls = 0;
+   CPU_LOAD_poll();
+   HT_CHECK( 1 == l_nStateCalls );
+   HT_CHECK( CPU_LOAD_getInfo( 0, &info ) && 200 == info.last );
+   HT_CHECK( 250 == info.avg && 300 == info.peak );
+   HT_CHECK( 100 == CPU_LOAD_getLast( 1 ) );
+   HT_CHECK( 16 == CPU_LOAD_getLast( 2 ) );           /* 16.33 rounds down */
+   HT_CHECK( 2 == CPU_LOAD_getBusy( &info ) );
+   HT_CHECK( 317 == info.last && 475 == info.peak );    /* Idle 683.67 */
+
+   /* An idle CPU */
+   start( 0, 0 );
+   CPU_LOAD_poll();
+   window( load );
+   static const uint16_t idle[N_TASKS] = { 0 };
+   window( idle );
+   checkAll();
+   HT_CHECK( 0 == CPU_LOAD_getBusyLast( 0 ) );
+}
+
+/**
+ * @brief   Random loads over more windows than are kept.
+ * @param   None
+ * @return: None
+ */
+static void test_rollover( void )
+{
+   uint32_t seed = 0xC0AD;
+
+   start( 0, 0 );
+   CPU_LOAD_poll();
+
+   for ( int w = 0; w < 4 * CPU_LOAD_N_WINDOWS + 3; w++ ) {
+      uint16_t load[N_TASKS] = { 0 };
+      uint32_t left = CPU_LOAD_FULL;
+
+      /* Sometimes one of them takes all of it */
+      if ( 0 == HT_rand( &seed ) % 8 ) {
+         load[HT_rand( &seed ) % 3] = CPU_LOAD_FULL;
+      } else {
+         for ( int i = 0; i < 3; i++ ) {
+            load[i] = (uint16_t)( HT_rand( &seed ) % ( left + 1 ) );
+            left -= load[i];
+         }
+      }
+      window( load );
+      checkAll();
+   }
+}
+
+/**
+ * @brief   The run time counter and the totals wrap inside a window.
+ * @param   None
+ * @return: None
+ */
+static void test_wrap( void )
+{
+   static const uint16_t load[N_TASKS] = { 400, 100, 500, 0 };
+   CpuLoadInfo_t info;
+
+   /* The counter wraps in the first window and the tick count in the last */
+   start( 0xFFFFFFFFu - 500000u, (TickType_t)0 - 2500 );
+   CPU_LOAD_poll();
+   window( load );
+   HT_CHECK( l_runTime < 1000000 );
+   checkAll();
+
+   /* Then the totals of two tasks, a window after they're moved up to it */
+   l_fake[0].total = 0xFFFFFFFFu - 100000u - 400000u;
+   l_fake[1].total = 0xFFFFFFFFu - 50000u - 100000u;
+   window( load );                           /* Not right, they jumped ahead */
+   window( load );
+   HT_CHECK( l_tick < CPU_LOAD_WINDOW_MS );
+   HT_CHECK( l_fake[0].total < 400000 && l_fake[1].total < 100000 );
+   HT_CHECK( 400 == CPU_LOAD_getLast( 0 ) && 100 == CPU_LOAD_getLast( 1 ) );
+   HT_CHECK( 500 == CPU_LOAD_getLast( 2 ) );
+   HT_CHECK( CPU_LOAD_FULL == CPU_LOAD_getBusyLast( 0 ) );   /* No idle */
+   HT_CHECK( 3 == CPU_LOAD_getBusy( &info ) );
+   HT_CHECK( 1000 == info.peak );
+}
+
+/**
+ * @brief   Windows thrown away, deleted tasks and a list that's too long.
+ * @param   None
+ * @return: None
+ */
+static void test_odd( void )
+{
+   static const uint16_t load[N_TASKS] = { 100, 200, 300, 0 };
+   static const uint16_t other[N_TASKS] = { 50, 50, 50, 0 };
+   CpuLoadInfo_t info;
+
+   start( 0, 0 );
+   CPU_LOAD_poll();
+   window( load );
+
+   /* The poller got starved for longer than a window may be */
+   runFor( CPU_LOAD_MAX_WINDOW_MS + 1, other );
+   CPU_LOAD_poll();
+   HT_CHECK( 1 == CPU_LOAD_getBusy( &info ) && 600 == info.last );
+   HT_CHECK( 100 == CPU_LOAD_getLast( 0 ) );
+   window( load );                          /* Only from the poll after it */
+   checkAll();
+
+   /* Just under the limit still counts */
+   runFor( CPU_LOAD_MAX_WINDOW_MS, other );
+   CPU_LOAD_poll();
+   HT_CHECK( 3 == CPU_LOAD_getBusy( &info ) && 150 == info.last );
+   HT_CHECK( 50 == CPU_LOAD_getLast( 2 ) );
+
+   /* A task that's being deleted is still counted, one that's gone isn't */
+   l_fake[1].bListed = false;
+   runFor( CPU_LOAD_WINDOW_MS, load );
+   CPU_LOAD_poll();
+   HT_CHECK( CPU_LOAD_getInfo( 1, &info ) && !info.bRunning );
+   HT_CHECK( 0 == info.last && 200 == info.peak );
+   HT_CHECK( 100 == CPU_LOAD_getLast( 0 ) && 300 == CPU_LOAD_getLast( 2 ) );
+
+   /* A handle that gets reused isn't taken for the old task */
+   l_fake[1].bListed = true;
+   runFor( CPU_LOAD_WINDOW_MS, load );
+   CPU_LOAD_poll();
+   HT_CHECK( CPU_LOAD_getInfo( 1, &info ) && !info.bRunning && 0 == info.last );
+
+   /* More tasks than there's room for leaves everything as it was */
+   for ( int i = IDLE + 1; i < N_FAKE; i++ ) {
+      l_fake[i].bListed = true;
+   }
+   runFor( CPU_LOAD_WINDOW_MS, other );
+   l_nStateCalls = 0;
+   CPU_LOAD_poll();
+   HT_CHECK( 1 == l_nStateCalls );
+   HT_CHECK( 5 == CPU_LOAD_getBusy( &info ) && 600 == info.last );
+   for ( int i = IDLE + 1; i < N_FAKE; i++ ) {
+      l_fake[i].bListed = false;
+   }
+   runFor( CPU_LOAD_WINDOW_MS, load );
+   CPU_LOAD_poll();                /* The next window takes in what it missed */
+   HT_CHECK( 6 == CPU_LOAD_getBusy( &info ) );
+   HT_CHECK( 75 == CPU_LOAD_getLast( 0 ) && 175 == CPU_LOAD_getLast( 2 ) );
+
+   /* A total that got ahead of the window, like the slice of the poller */
+   runFor( CPU_LOAD_WINDOW_MS, load );
+   l_fake[2].total += 5000;
+   CPU_LOAD_poll();
+   HT_CHECK( CPU_LOAD_getInfo( 2, &info ) && 305 == info.last );
+   runFor( CPU_LOAD_WINDOW_MS, NULL );
+   l_fake[2].total += 2 * CPU_LOAD_WINDOW_MS * 1000;
+   CPU_LOAD_poll();
+   HT_CHECK( CPU_LOAD_FULL == CPU_LOAD_getLast( 2 ) );
+
+   /* Past CPU_LOAD_MAX_TASKS entries of a table aren't accounted for */
+   CPU_LOAD_init( CPU_LOAD_MAX_TASKS + 3 );
+   HT_CHECK( CPU_LOAD_MAX_TASKS == CPU_LOAD_getNTasks() );
+   CPU_LOAD_attach( CPU_LOAD_MAX_TASKS, &l_fake[0], "extra" );
+   HT_CHECK( !CPU_LOAD_getInfo( CPU_LOAD_MAX_TASKS, &info ) );
+}
+
+/**
+ * @brief   The run time counter of the config is the monotonic clock in us.
+ * @param   None
+ * @return: None
+ */
+static void test_clock( void )
+{
+   const struct timespec nap = { 0, 20 * 1000 * 1000 };
+
+   portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
+   uint64_t ns0 = HT_nowNs();
+   uint32_t us0 = portGET_RUN_TIME_COUNTER_VALUE();
+   nanosleep( &nap, NULL );
+   uint32_t us1 = portGET_RUN_TIME_COUNTER_VALUE();
+   uint64_t ns1 = HT_nowNs();
+
+   uint32_t us = us1 - us0;
+   HT_CHECK_MSG( us >= 20000 && us <= ( ns1 - ns0 ) / 1000 + 1,
+         "%u us over %llu ns", us, (unsigned long long)( ns1 - ns0 ) );
+   HT_CHECK( (uint32_t)( us0 - (uint32_t)( ns0 / 1000 ) ) <= 1000 );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_shares();
+   test_rollover();
+   test_wrap();
+   test_odd();
+   test_clock();
+   return( HT_DONE( "cpu_load_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,702 @@
+/**
+ * @file   db_journal_test.c
+ * @brief  Host test of the journaled settings store against a simulated
+ * EEPROM.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The EEPROM counts every write of every byte.  It can lose power after any
+ * number of bytes of a write, fail a write outright, hold writes back the way
+ * the I2CDevMgr queue does for an AO, and wear bytes out after a set number
+ * of writes.  The store is set up the way db.c sets it up: 4 banks of 64
+ * bytes starting with bank 1.  Most tests use a key table with a few more
+ * keys than db.c has so a bank fills up quicker.  The wear tests use the
+ * table db.c has today.
+ *
+ * - A power cut at every byte of an append and of a compaction, followed by
+ *   a reboot, has to leave each key with either its old or its new value and
+ *   the store has to keep working after that.
+ * - An append whose write is still queued doesn't show up until it is
+ *   committed, and a failed one never does.
+ * - The rseq of a bank doesn't wrap however many appends fail, and the seq of
+ *   the banks can wrap.
+ * - A record or header with a bad crc doesn't count.
+ * - The banks wear evenly and the journal lasts many times longer than
+ *   writing the same bytes in place would.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "db_journal.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define BANK_SIZE               64             /**< DB_JOURNAL_BANK_SIZE */
+#define N_BANKS                 4              /**< DB_JOURNAL_N_BANKS */
+#define FIRST_BANK              1              /**< DB_JOURNAL_FIRST_BANK */
+#define COMPACT_FREE            ( DBJ_REC_OVERHEAD + DBJ_MAX_VAL_LEN )
+#define MEM_SIZE                ( BANK_SIZE * N_BANKS )
+#define SCHEMA                  2
+#define N_KEYS                  4
+#define N_UPDATES               3000       /**< Settings changes in wear test */
+#define ENDURANCE               1000   /**< Writes a byte survives (scaled) */
+#define MAX_QUEUED              8          /**< Writes held back at once */
+
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct Write_t
+ * A write held back until the test lets it through.
+ */
+typedef struct Write {
+   uint16_t addr;
+   uint16_t len;
+   uint8_t  data[DBJ_MAX_BANK_SIZE];
+} Write_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static const uint8_t l_defIp[4]   = { 172, 27, 0, 75 };
+static const uint8_t l_defMask[6] = { 1, 2, 3, 4, 5, 6 };
+static const uint8_t l_defPort[2] = { 0x50, 0x00 };
+
+/**< Key 0 isn't stored, like the elements that aren't in the main EEPROM */
+static const DBJ_Key_t l_keys[N_KEYS] = {
+      { 0, NULL },
+      { sizeof(l_defIp),   l_defIp },
+      { sizeof(l_defMask), l_defMask },
+      { sizeof(l_defPort), l_defPort },
+};
+
+static CBErrorCode eeRead( uint16_t addr, uint8_t *pBuf, uint16_t len );
+static CBErrorCode eeWrite( uint16_t addr, const uint8_t *pBuf, uint16_t len );
+
+static const DBJ_Cfg_t l_cfg = {
+      eeRead, eeWrite, 0, BANK_SIZE, N_BANKS, FIRST_BANK, COMPACT_FREE,
+      SCHEMA, l_keys, N_KEYS
+};
+
+/**< Key table of db.c today: only the IP address is in the journal */
+static const DBJ_Cfg_t l_dbCfg = {
+      eeRead, eeWrite, 0, BANK_SIZE, N_BANKS, FIRST_BANK, COMPACT_FREE,
+      SCHEMA, l_keys, 2
+};
+
+/**< Configuration reboot() and format() use */
+static const DBJ_Cfg_t *l_pCfg = &l_cfg;
+
+/**< The simulated EEPROM */
+static struct {
+   uint8_t  mem[MEM_SIZE];
+   uint32_t nWrites[MEM_SIZE];          /**< Times each byte was written */
+   uint32_t endurance;      /**< Writes a byte survives.  0 for forever */
+   uint32_t nWorn;                /**< Writes that went to a worn byte */
+   uint32_t nBytes;                   /**< Bytes written since reset */
+   long     cutAfter;  /**< Bytes written before the power goes.  -1: never */
+   bool     isDown;            /**< The power is out, nothing gets written */
+   int      nFail;                  /**< Writes to fail without writing */
+   bool     isQueued;         /**< Hold writes back, like an AO's requests */
+   Write_t  queue[MAX_QUEUED];
+   int      nQueued;
+} l_ee;
+
+static uint32_t l_seed = 0xDB10u;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void eeReset( void )
+{
+   memset( &l_ee, 0, sizeof(l_ee) );
+   memset( l_ee.mem, 0xFF, sizeof(l_ee.mem) );
+   l_ee.cutAfter = -1;
+}
+
+/******************************************************************************/
+static CBErrorCode eeRead( uint16_t addr, uint8_t *pBuf, uint16_t len )
+{
+   HT_CHECK( addr + len <= MEM_SIZE );
+   memcpy( pBuf, &l_ee.mem[addr], len );
+   return( ERR_NONE );
+}
+
+/**
+ * @brief   Write bytes into the memory the way the EEPROM does, one at a time
+ * until the power goes.  A worn out byte doesn't hold what was written.
+ * @return: CBErrorCode ERR_NONE if every byte was written.
+ */
+static CBErrorCode eePut( uint16_t addr, const uint8_t *pBuf, uint16_t len )
+{
+   HT_CHECK( addr + len <= MEM_SIZE );
+   for ( uint16_t i = 0; i < len; i++ ) {
+      if ( l_ee.isDown || 0 == l_ee.cutAfter ) {
+         l_ee.isDown = true;
+         return( ERR_I2CBUS_NACK );
+      }
+      if ( l_ee.cutAfter > 0 ) {
+         l_ee.cutAfter--;
+      }
+
+      uint16_t a = addr + i;
+      l_ee.mem[a] = pBuf[i];
+      if ( 0 != l_ee.endurance && ++l_ee.nWrites[a] > l_ee.endurance ) {
+         l_ee.mem[a] ^= 0x10;                    /* A bit that no longer sets */
+         l_ee.nWorn++;
+      } else if ( 0 == l_ee.endurance ) {
+         l_ee.nWrites[a]++;
+      }
+      l_ee.nBytes++;
+   }
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+static CBErrorCode eeWrite( uint16_t addr, const uint8_t *pBuf, uint16_t len )
+{
+   if ( l_ee.nFail > 0 ) {
+      l_ee.nFail--;
+      return( ERR_I2CBUS_NACK );
+   }
+
+   if ( l_ee.isQueued ) {
+      HT_CHECK( l_ee.nQueued < MAX_QUEUED && len <= DBJ_MAX_BANK_SIZE );
+      Write_t *w = &l_ee.queue[l_ee.nQueued++];
+      w->addr = addr;
+      w->len  = len;
+      memcpy( w->data, pBuf, len );
+      return( ERR_NONE );
+   }
+   return( eePut( addr, pBuf, len ) );
+}
+
+/**
+ * @brief   Let the held back writes through.
+ * @param [in] nBytes: long bytes to let through before the rest fail.  -1 for
+ * all of them.
+ * @return: bool true if all of them were written.
+ */
+static bool eeFlush( long nBytes )
+{
+   bool isOk = true;
+   l_ee.cutAfter = nBytes;
+   for ( int i = 0; i < l_ee.nQueued; i++ ) {
+      isOk &= ( ERR_NONE == eePut( l_ee.queue[i].addr, l_ee.queue[i].data,
+            l_ee.queue[i].len ) );
+   }
+   l_ee.nQueued  = 0;
+   l_ee.cutAfter = -1;
+   l_ee.isDown   = false;
+   return( isOk );
+}
+
+/**
+ * @brief   Latest value of a key in a mounted store, read from the memory.
+ * @return: const uint8_t pointer to the value or NULL if there isn't one.
+ */
+static const uint8_t *value( const DBJ_Store_t *s, uint8_t key )
+{
+   uint16_t addr;
+   if ( ERR_NONE != DBJ_locate( s, key, &addr ) ) {
+      return( NULL );
+   }
+   return( &l_ee.mem[addr] );
+}
+
+/**
+ * @brief   Check a key has a value.
+ * @return: bool true if it has *want.
+ */
+static bool hasValue( const DBJ_Store_t *s, uint8_t key, const uint8_t *want )
+{
+   const uint8_t *got = value( s, key );
+   return( NULL != got && 0 == memcmp( got, want, l_keys[key].len ) );
+}
+
+/**
+ * @brief   Power the EEPROM back up and mount the store from scratch like the
+ * FW does after a reset.
+ * @param [out] *s: DBJ_Store_t pointer to the store.
+ * @return: CBErrorCode of the mount.
+ */
+static CBErrorCode reboot( DBJ_Store_t *s )
+{
+   l_ee.cutAfter = -1;
+   l_ee.isDown   = false;
+   l_ee.nFail    = 0;
+   return( DBJ_mount( s, l_pCfg ) );
+}
+
+/**
+ * @brief   Set up an empty EEPROM the way db.c does when there's nothing to
+ * mount.
+ * @param [out] *s: DBJ_Store_t pointer to the store.
+ * @return: None
+ */
+static void format( DBJ_Store_t *s )
+{
+   HT_CHECK( ERR_DB_NOT_INIT == DBJ_mount( s, l_pCfg ) );
+   HT_CHECK( ERR_NONE == DBJ_format( s, l_pCfg, NULL, 0 ) );
+}
+
+/**
+ * @brief   Fill a value that is different on every call.
+ * @param [out] *buf: uint8_t pointer to the value.
+ * @param [in] len: uint8_t length of the value.
+ * @return: None
+ */
+static void newValue( uint8_t *buf, uint8_t len )
+{
+   for ( uint8_t i = 0; i < len; i++ ) {
+      buf[i] = (uint8_t)HT_rand( &l_seed );
+   }
+}
+
+/**
+ * @brief   What the CPLR task does every loop through DB_maintain().
+ * @param [in,out] *s: DBJ_Store_t pointer to the store.
+ * @return: None
+ */
+static void maintain( DBJ_Store_t *s )
+{
+   if ( DBJ_needsCompact( s ) ) {
+      HT_CHECK( ERR_NONE == DBJ_compact( s ) );
+   }
+}
+
+/**
+ * @brief   Cut the power at every byte of an append of two values, reboot,
+ * and check each value is either old or new and that the store still works.
+ * @return: None
+ */
+static void testTornAppend( void )
+{
+   static uint8_t snap[MEM_SIZE];
+   DBJ_Store_t s;
+   uint8_t ip[4], port[2];
+   uint8_t ip2[4];
+
+   eeReset();
+   format( &s );
+   memcpy( snap, l_ee.mem, sizeof(snap) );
+
+   const uint8_t *ipOld = l_defIp;
+   newValue( ip, sizeof(ip) );
+   newValue( port, sizeof(port) );
+   const DBJ_Val_t vals[2] = { { 1, ip, sizeof(ip) }, { 3, port, sizeof(port) } };
+   const long ipEnd = DBJ_REC_OVERHEAD + sizeof(ip);
+   const long total = ipEnd + DBJ_REC_OVERHEAD + sizeof(port);
+
+   for ( long cut = 0; cut <= total; cut++ ) {
+      for ( int isSameBoot = 0; isSameBoot < 2; isSameBoot++ ) {
+         memcpy( l_ee.mem, snap, sizeof(snap) );
+         HT_CHECK( ERR_NONE == reboot( &s ) );
+         l_ee.cutAfter = cut;
+         CBErrorCode status = DBJ_append( &s, vals, 2 );
+         HT_CHECK_MSG( ( cut < total ) == ( ERR_NONE != status ),
+               "cut %ld status 0x%08x", cut, status );
+
+         /* Without a reboot the store keeps going after the power comes back */
+         DBJ_Store_t *pS = &s;
+         DBJ_Store_t s2;
+         if ( !isSameBoot ) {
+            HT_CHECK( ERR_NONE == reboot( &s2 ) );
+            pS = &s2;
+            HT_CHECK_MSG( hasValue( pS, 1, cut >= ipEnd ? ip : ipOld ),
+                  "cut %ld ip", cut );
+            HT_CHECK_MSG( hasValue( pS, 3, cut >= total ? port : l_defPort ),
+                  "cut %ld port", cut );
+            HT_CHECK( hasValue( pS, 2, l_defMask ) );
+         } else {
+            l_ee.cutAfter = -1;
+            l_ee.isDown   = false;
+         }
+
+         newValue( ip2, sizeof(ip2) );
+         DBJ_Val_t next = { 1, ip2, sizeof(ip2) };
+         HT_CHECK_MSG( ERR_NONE == DBJ_append( pS, &next, 1 ), "cut %ld", cut );
+         HT_CHECK( ERR_NONE == reboot( &s2 ) );
+         HT_CHECK_MSG( hasValue( &s2, 1, ip2 ), "cut %ld same boot %d", cut,
+               isSameBoot );
+         HT_CHECK_MSG( hasValue( &s2, 3, cut >= total ? port : l_defPort ),
+               "cut %ld same boot %d", cut, isSameBoot );
+      }
+   }
+}
+
+/**
+ * @brief   Cut the power at every byte of a compaction, reboot, and check the
+ * values all survived in one bank or the other.
+ * @return: None
+ */
+static void testTornCompact( void )
+{
+   static uint8_t snap[MEM_SIZE];
+   DBJ_Store_t s;
+   uint8_t ip[4], mask[6], port[2];
+
+   eeReset();
+   format( &s );
+   while ( !DBJ_needsCompact( &s ) ) {
+      newValue( ip, sizeof(ip) );
+      newValue( mask, sizeof(mask) );
+      newValue( port, sizeof(port) );
+      DBJ_Val_t vals[3] = {
+            { 1, ip, sizeof(ip) }, { 2, mask, sizeof(mask) }, { 3, port, sizeof(port) }
+      };
+      uint8_t n = (uint8_t)( 1 + HT_rand( &l_seed ) % 3 );
+      HT_CHECK( ERR_NONE == DBJ_append( &s, vals, n ) );
+      if ( n < 3 ) {
+         memcpy( port, value( &s, 3 ), sizeof(port) );
+      }
+      if ( n < 2 ) {
+         memcpy( mask, value( &s, 2 ), sizeof(mask) );
+      }
+   }
+   uint8_t oldBank = s.bank;
+   memcpy( snap, l_ee.mem, sizeof(snap) );
+
+   uint32_t before = l_ee.nBytes;
+   HT_CHECK( ERR_NONE == DBJ_compact( &s ) );
+   long total = (long)( l_ee.nBytes - before );
+   HT_CHECK( total > DBJ_HDR_LEN );
+
+   for ( long cut = 0; cut <= total; cut++ ) {
+      memcpy( l_ee.mem, snap, sizeof(snap) );
+      HT_CHECK( ERR_NONE == reboot( &s ) );
+      l_ee.cutAfter = cut;
+      CBErrorCode status = DBJ_compact( &s );
+      HT_CHECK_MSG( ( cut < total ) == ( ERR_NONE != status ), "cut %ld", cut );
+
+      HT_CHECK( ERR_NONE == reboot( &s ) );
+      HT_CHECK_MSG( s.bank == ( cut < total ? oldBank : ( oldBank + 1 ) % N_BANKS ),
+            "cut %ld bank %d", cut, s.bank );
+      HT_CHECK_MSG( hasValue( &s, 1, ip ) && hasValue( &s, 2, mask ) &&
+            hasValue( &s, 3, port ), "cut %ld", cut );
+   }
+}
+
+/**
+ * @brief   Hold the writes of an append back like the I2CDevMgr queue does
+ * for an AO.  The index can only move once the data is in the EEPROM.
+ * @return: None
+ */
+static void testQueued( void )
+{
+   DBJ_Store_t s, s2;
+   uint8_t ip[4], ipOld[4], ip2[4];
+
+   eeReset();
+   format( &s );
+   memcpy( ipOld, l_defIp, sizeof(ipOld) );
+   uint16_t tail = s.tail;
+
+   /* Written: the new value only shows up after the commit */
+   l_ee.isQueued = true;
+   newValue( ip, sizeof(ip) );
+   DBJ_Val_t val = { 1, ip, sizeof(ip) };
+   HT_CHECK( ERR_NONE == DBJ_appendAsync( &s, &val, 1 ) );
+   HT_CHECK( 1 == l_ee.nQueued );
+   HT_CHECK( hasValue( &s, 1, ipOld ) );
+   HT_CHECK( tail == s.tail );
+   HT_CHECK( ERR_DB_BUSY == DBJ_append( &s, &val, 1 ) );
+   HT_CHECK( ERR_DB_BUSY == DBJ_compact( &s ) );
+   HT_CHECK( ERR_DB_BUSY == DBJ_format( &s, &l_cfg, NULL, 0 ) );
+   HT_CHECK( !DBJ_needsCompact( &s ) );
+   HT_CHECK( eeFlush( -1 ) );
+   DBJ_commit( &s, true );
+   HT_CHECK( hasValue( &s, 1, ip ) );
+   HT_CHECK( s.tail == tail + DBJ_REC_OVERHEAD + sizeof(ip) );
+   HT_CHECK( ERR_NONE == reboot( &s2 ) && hasValue( &s2, 1, ip ) );
+   memcpy( ipOld, ip, sizeof(ip) );
+   tail = s.tail;
+
+   /* Failed half way: the old value stays and the next append reuses the
+    * spot without the leftovers counting */
+   newValue( ip, sizeof(ip) );
+   HT_CHECK( ERR_NONE == DBJ_appendAsync( &s, &val, 1 ) );
+   HT_CHECK( !eeFlush( 3 ) );
+   DBJ_commit( &s, false );
+   HT_CHECK( hasValue( &s, 1, ipOld ) );
+   HT_CHECK( tail == s.tail );
+   DBJ_commit( &s, true );                         /* Nothing pending: no-op */
+   HT_CHECK( tail == s.tail );
+
+   l_ee.isQueued = false;
+   newValue( ip2, sizeof(ip2) );
+   DBJ_Val_t val2 = { 1, ip2, sizeof(ip2) };
+   HT_CHECK( ERR_NONE == DBJ_append( &s, &val2, 1 ) );
+   HT_CHECK( ERR_NONE == reboot( &s2 ) && hasValue( &s2, 1, ip2 ) );
+   HT_CHECK( s2.tail == s.tail );
+
+   /* Failed to even queue: nothing is pending */
+   l_ee.nFail = 1;
+   HT_CHECK( ERR_I2CBUS_NACK == DBJ_appendAsync( &s, &val, 1 ) );
+   HT_CHECK( !s.isPending );
+   HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+   HT_CHECK( ERR_NONE == reboot( &s2 ) && hasValue( &s2, 1, ip ) );
+}
+
+/**
+ * @brief   Fail appends until the rseqs of the bank run out.  They must not
+ * wrap into values that an older record would beat.
+ * @return: None
+ */
+static void testRseqRollover( void )
+{
+   DBJ_Store_t s, s2;
+   uint8_t ip[4];
+   int n;
+
+   eeReset();
+   format( &s );
+   newValue( ip, sizeof(ip) );
+   DBJ_Val_t val = { 1, ip, sizeof(ip) };
+   HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+   uint8_t bank = s.bank;
+
+   for ( n = 0; n < 300; n++ ) {
+      l_ee.nFail = 1;
+      CBErrorCode status = DBJ_append( &s, &val, 1 );
+      if ( ERR_DB_NO_SPACE == status ) {
+         break;
+      }
+      HT_CHECK( ERR_I2CBUS_NACK == status );
+   }
+   l_ee.nFail = 0;
+   HT_CHECK_MSG( n > 200 && n < 256, "ran out after %d", n );
+   HT_CHECK( DBJ_needsCompact( &s ) );
+
+   HT_CHECK( ERR_NONE == DBJ_compact( &s ) );
+   HT_CHECK( bank != s.bank );
+   newValue( ip, sizeof(ip) );
+   HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+   HT_CHECK( ERR_NONE == reboot( &s2 ) && hasValue( &s2, 1, ip ) );
+
+   /* Same thing with the failures mixed in between good appends, compacting
+    * when told to like DB_maintain() does */
+   for ( n = 0; n < 2000; n++ ) {
+      newValue( ip, sizeof(ip) );
+      l_ee.nFail = ( 0 != HT_rand( &l_seed ) % 4 );
+      CBErrorCode status = DBJ_append( &s, &val, 1 );
+      l_ee.nFail = 0;
+      if ( ERR_NONE != status ) {
+         maintain( &s );
+         HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+      }
+      if ( 0 == n % 50 ) {
+         HT_CHECK_MSG( ERR_NONE == reboot( &s2 ) && hasValue( &s2, 1, ip ),
+               "update %d", n );
+      }
+   }
+}
+
+/**
+ * @brief   Start the banks just before the seq wraps and keep compacting past
+ * it.  The newest bank has to win every time.
+ * @return: None
+ */
+static void testSeqRollover( void )
+{
+   DBJ_Store_t s, s2;
+   uint8_t ip[4];
+
+   /* Pretend the journal has already been around 4 billion times */
+   eeReset();
+   memset( &s, 0, sizeof(s) );
+   s.cfg       = &l_cfg;
+   s.isMounted = true;
+   s.seq       = 0xFFFFFFFAu;
+   HT_CHECK( ERR_NONE == DBJ_format( &s, &l_cfg, NULL, 0 ) );
+   HT_CHECK( ERR_NONE == reboot( &s2 ) && 0xFFFFFFFBu == s2.seq );
+
+   for ( int i = 0; i < 3 * N_BANKS; i++ ) {
+      newValue( ip, sizeof(ip) );
+      DBJ_Val_t val = { 1, ip, sizeof(ip) };
+      HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+      HT_CHECK( ERR_NONE == DBJ_compact( &s ) );
+
+      HT_CHECK( ERR_NONE == reboot( &s2 ) );
+      HT_CHECK_MSG( s2.seq == s.seq && s2.bank == s.bank && hasValue( &s2, 1, ip ),
+            "seq 0x%08x mounted 0x%08x", s.seq, s2.seq );
+   }
+   HT_CHECK( s.seq < 0x10 );
+}
+
+/**
+ * @brief   Flip every bit of the last record and of the header of the active
+ * bank.  A record that doesn't check out ends the log, and a bank whose
+ * header doesn't check out leaves the one before it active.
+ * @return: None
+ */
+static void testCrc( void )
+{
+   static uint8_t snap[MEM_SIZE];
+   DBJ_Store_t s, s2;
+   uint8_t ip[4], ipOld[4], ipBank[4];
+
+   eeReset();
+   format( &s );
+   newValue( ipBank, sizeof(ipBank) );
+   DBJ_Val_t val = { 1, ipBank, sizeof(ipBank) };
+   HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+   HT_CHECK( ERR_NONE == DBJ_compact( &s ) );
+   newValue( ipOld, sizeof(ipOld) );
+   val.pVal = ipOld;
+   HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+   uint16_t recAddr = (uint16_t)( s.bank * BANK_SIZE + s.tail );
+   newValue( ip, sizeof(ip) );
+   val.pVal = ip;
+   HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+   memcpy( snap, l_ee.mem, sizeof(snap) );
+
+   for ( uint16_t i = 0; i < DBJ_REC_OVERHEAD + sizeof(ip); i++ ) {
+      for ( int bit = 0; bit < 8; bit++ ) {
+         memcpy( l_ee.mem, snap, sizeof(snap) );
+         l_ee.mem[recAddr + i] ^= (uint8_t)( 1 << bit );
+         HT_CHECK( ERR_NONE == reboot( &s2 ) );
+         HT_CHECK_MSG( hasValue( &s2, 1, ipOld ) &&
+               s2.tail + s2.bank * BANK_SIZE == recAddr,
+               "record byte %d bit %d", i, bit );
+      }
+   }
+
+   uint16_t hdrAddr = (uint16_t)( s.bank * BANK_SIZE );
+   for ( uint16_t i = 0; i < DBJ_HDR_LEN; i++ ) {
+      for ( int bit = 0; bit < 8; bit++ ) {
+         memcpy( l_ee.mem, snap, sizeof(snap) );
+         l_ee.mem[hdrAddr + i] ^= (uint8_t)( 1 << bit );
+         HT_CHECK( ERR_NONE == reboot( &s2 ) );
+         HT_CHECK_MSG( s2.bank != s.bank && hasValue( &s2, 1, ipBank ),
+               "header byte %d bit %d", i, bit );
+      }
+   }
+
+   /* Leftovers of an earlier use of a bank sit past its tail with valid
+    * looking records.  The seq in their crc keeps them out. */
+   memcpy( l_ee.mem, snap, sizeof(snap) );
+   HT_CHECK( ERR_NONE == reboot( &s ) );
+   for ( int i = 0; i < N_BANKS; i++ ) {
+      HT_CHECK( ERR_NONE == DBJ_compact( &s ) );
+   }
+   HT_CHECK( ERR_NONE == reboot( &s2 ) );
+   HT_CHECK( s2.tail < recAddr - hdrAddr && hasValue( &s2, 1, ip ) );
+}
+
+/**
+ * @brief   Change a setting over and over, compacting like DB_maintain(), and
+ * look at how the writes spread over the banks.
+ * @return: None
+ */
+static void testWear( void )
+{
+   DBJ_Store_t s, s2;
+   uint8_t ip[4];
+
+   eeReset();
+   l_pCfg = &l_dbCfg;
+   format( &s );
+   uint32_t formatBytes = l_ee.nBytes;
+   memset( &s.stats, 0, sizeof(s.stats) );
+
+   for ( int n = 0; n < N_UPDATES; n++ ) {
+      newValue( ip, sizeof(ip) );
+      DBJ_Val_t val = { 1, ip, sizeof(ip) };
+      HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+      maintain( &s );
+   }
+   HT_CHECK( ERR_NONE == reboot( &s2 ) && hasValue( &s2, 1, ip ) );
+   HT_CHECK( s.stats.nBytesWritten + formatBytes == l_ee.nBytes );
+   HT_CHECK( N_UPDATES == s.stats.nAppends );
+
+   uint32_t maxByte = 0;
+   uint32_t minHdr = UINT32_MAX, maxHdr = 0;
+   printf( "bank | header writes | most writes of a byte | bytes written\n" );
+   for ( int b = 0; b < N_BANKS; b++ ) {
+      uint32_t bankMax = 0, bankTotal = 0;
+      for ( int i = 0; i < BANK_SIZE; i++ ) {
+         uint32_t w = l_ee.nWrites[b * BANK_SIZE + i];
+         bankTotal += w;
+         if ( w > bankMax ) {
+            bankMax = w;
+         }
+      }
+      uint32_t hdr = l_ee.nWrites[b * BANK_SIZE];
+      printf( "%-4d | %-13u | %-21u | %u\n", b, hdr, bankMax, bankTotal );
+      if ( bankMax > maxByte ) {
+         maxByte = bankMax;
+      }
+      if ( hdr < minHdr ) {
+         minHdr = hdr;
+      }
+      if ( hdr > maxHdr ) {
+         maxHdr = hdr;
+      }
+   }
+   printf( "%d updates, %u compactions, most writes of a byte %u (in place %d)\n",
+         N_UPDATES, s.stats.nCompactions, maxByte, N_UPDATES );
+
+   /* Round robin: the banks are started within one of each other and no byte
+    * gets anywhere near the writes it would get in place */
+   HT_CHECK_MSG( maxHdr - minHdr <= 1, "headers %u to %u", minHdr, maxHdr );
+   HT_CHECK_MSG( maxByte * 8 <= N_UPDATES, "most writes of a byte %u", maxByte );
+   l_pCfg = &l_cfg;
+}
+
+/**
+ * @brief   Give the bytes a short life and see how many changes the journal
+ * takes before the first byte wears out, against ENDURANCE in place.
+ * @return: None
+ */
+static void testEndurance( void )
+{
+   DBJ_Store_t s, s2;
+   uint8_t ip[4];
+   int n;
+
+   eeReset();
+   l_ee.endurance = ENDURANCE;
+   l_pCfg = &l_dbCfg;
+   format( &s );
+
+   for ( n = 0; n < 100 * ENDURANCE && 0 == l_ee.nWorn; n++ ) {
+      newValue( ip, sizeof(ip) );
+      DBJ_Val_t val = { 1, ip, sizeof(ip) };
+      HT_CHECK( ERR_NONE == DBJ_append( &s, &val, 1 ) );
+      maintain( &s );
+      if ( 0 == n % 97 && 0 == l_ee.nWorn ) {
+         HT_CHECK_MSG( ERR_NONE == reboot( &s2 ) && hasValue( &s2, 1, ip ),
+               "update %d", n );
+      }
+   }
+   printf( "bytes rated for %d writes last %d changes (%.1fx in place)\n",
+         ENDURANCE, n, (double)n / ENDURANCE );
+   l_pCfg = &l_cfg;
+   HT_CHECK_MSG( n >= 8 * ENDURANCE, "wore out after %d changes", n );
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main( void )
+{
+   testTornAppend();
+   testTornCompact();
+   testQueued();
+   testRseqRollover();
+   testSeqRollover();
+   testCrc();
+   testWear();
+   testEndurance();
+   return( HT_DONE( "db_journal_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
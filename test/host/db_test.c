@@ -0,0 +1,553 @@
+/**
+ * @file   db_test.c
+ * @brief  Host test of the batched settings DB accesses against a fake I2C
+ * device layer.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Runs the real db.c and db_journal.c on top of the I2C_*DevMem*() calls of
+ * i2c_dev.h, which are faked here with the memory of every device and a log
+ * of every transaction.  The tests count the transactions of each DB call:
+ *
+ * - Validating and resetting the DB, from a blank EEPROM and from the fixed
+ *   layout of older FW.  Once mounted, validating doesn't touch the bus.
+ * - Reading all 5 elements takes one read per device, in any order.
+ * - A batch with a read-only or a bad element is turned away without any
+ *   transaction.  A good one is a single write, also from an AO.
+ * - Elements on the same device are read together across a gap of up to
+ *   DB_READ_MAX_GAP bytes while the run fits in MAX_I2C_READ_LEN.  The board
+ *   has only one element per device, so db.c is built with DB_HOST_LAYOUT to
+ *   move one next to another.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "i2c_dev.h"
+#include "db.h"
+#include "ipAndMac.h"
+#include "task.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MEM_SIZE                256
+#define MAX_XFERS               16
+#define N_BANKS                 4         /**< DB_JOURNAL_N_BANKS */
+#define BANK_SIZE               64        /**< DB_JOURNAL_BANK_SIZE */
+#define READ_MAX_GAP            DBJ_REC_OVERHEAD  /**< DB_READ_MAX_GAP */
+#define MAC_OFFSET              2         /**< Of DB_MAC_ADDR on EUI_ROM */
+#define MAC_LEN                 6
+#define SN_LEN                  16
+#define N_ORDERS                200
+#define REPLY_AFTER_DELAYS      3
+
+/* Private typedefs ----------------------------------------------------------*/
+/**< One I2C transaction */
+typedef struct {
+   I2C_Dev_t    iDev;
+   uint16_t     offset;
+   uint16_t     len;
+   bool         isWrite;
+   AccessType_t accType;
+} Xfer_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0xDB0039u;
+
+static uint8_t  l_mem[MAX_I2C_DEV][MEM_SIZE];
+static Xfer_t   l_xfers[MAX_XFERS];
+static int      l_nXfers;
+static int      l_nReads;
+static int      l_nWrites;
+
+static uint8_t  l_nRepliesDue;    /**< AO writes not passed back to the DB */
+static uint32_t l_nDelays;
+
+static QActive  l_requester;                   /**< AO that makes requests */
+
+static const uint8_t l_defIp[4] = {
+      STATIC_IPADDR0, STATIC_IPADDR1, STATIC_IPADDR2, STATIC_IPADDR3
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+void Q_onAssert( char_t const * const module, int_t location )
+{
+   fprintf( stderr, "assert %s:%d\n", module, (int)location );
+   exit( 1 );
+}
+
+/******************************************************************************/
+void * MEM_DataCopy( void * destination, const void * source, uint16_t num )
+{
+   return( memcpy( destination, source, num ) );
+}
+
+/**
+ * @brief   Log a transaction and move its data to or from the device.
+ * @param [in] iDev: I2C_Dev_t device.
+ * @param [in] offset: uint16_t where on the device.
+ * @param [in,out] *pBuf: uint8_t pointer to the data.
+ * @param [in] len: uint16_t bytes.
+ * @param [in] isWrite: bool true for a write.
+ * @param [in] accType: AccessType_t of the call.
+ * @return CBErrorCode: ERR_NONE, or the error i2c_dev.c would return.
+ */
+static CBErrorCode xfer( I2C_Dev_t iDev, uint16_t offset, uint8_t *pBuf,
+      uint16_t len, bool isWrite, AccessType_t accType )
+{
+   if ( !IS_I2C_DEVICE( iDev ) ) {
+      return( ERR_I2C_DEV_INVALID_DEVICE );
+   }
+   if ( 0 == len || offset + len > MEM_SIZE ) {
+      return( ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY );
+   }
+
+   if ( l_nXfers < MAX_XFERS ) {
+      l_xfers[l_nXfers] = (Xfer_t){ iDev, offset, len, isWrite, accType };
+   }
+   l_nXfers++;
+
+   if ( isWrite ) {
+      memcpy( &l_mem[iDev][offset], pBuf, len );
+      l_nWrites++;
+   } else {
+      memcpy( pBuf, &l_mem[iDev][offset], len );
+      l_nReads++;
+   }
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_readDevMemBLK( I2C_Dev_t iDev, uint16_t offset,
+      uint16_t bytesToRead, AccessType_t accType, uint8_t* pBuffer,
+      uint8_t bufSize )
+{
+   if ( bytesToRead > bufSize ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+   return( xfer( iDev, offset, pBuffer, bytesToRead, false, accType ) );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_writeDevMemBLK( I2C_Dev_t iDev, uint16_t offset,
+      uint16_t bytesToWrite, AccessType_t accType, uint8_t* pBuffer,
+      uint8_t bufSize )
+{
+   if ( bytesToWrite > bufSize ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+   return( xfer( iDev, offset, pBuffer, bytesToWrite, true, accType ) );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_readDevMemFRT( I2C_Dev_t iDev, uint16_t offset,
+      uint8_t *pBuffer, uint16_t nBufferSize, uint16_t *pBytesRead,
+      uint16_t nBytesToRead )
+{
+   if ( nBytesToRead > nBufferSize ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+   CBErrorCode status = xfer( iDev, offset, pBuffer, nBytesToRead, false,
+         ACCESS_FREERTOS );
+   *pBytesRead = ( ERR_NONE == status ) ? nBytesToRead : 0;
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_writeDevMemFRT( I2C_Dev_t iDev, uint16_t offset,
+      uint8_t *pBuffer, uint16_t nBufferSize, uint16_t *pBytesWritten,
+      uint16_t nBytesToWrite )
+{
+   if ( nBytesToWrite > nBufferSize ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+   CBErrorCode status = xfer( iDev, offset, pBuffer, nBytesToWrite, true,
+         ACCESS_FREERTOS );
+   *pBytesWritten = ( ERR_NONE == status ) ? nBytesToWrite : 0;
+   return( status );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_readDevMemEVT( I2C_Dev_t iDev, uint16_t offset,
+      uint16_t bytesToRead, AccessType_t accType, QActive* callingAO,
+      uint8_t *pBuffer, uint16_t tag )
+{
+   uint8_t dataBuf[MAX_I2C_READ_LEN];
+
+   if ( bytesToRead > sizeof(dataBuf) ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+   return( xfer( iDev, offset, dataBuf, bytesToRead, false, accType ) );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_writeDevMemEVT( I2C_Dev_t iDev, uint16_t offset,
+      uint16_t bytesToWrite, AccessType_t accType, QActive* callingAO,
+      uint8_t *pBuffer, uint16_t tag )
+{
+   /* Lands right away, but the reply only comes back when the test says */
+   if ( bytesToWrite > MAX_I2C_WRITE_LEN ) {
+      return( ERR_MEM_BUFFER_LEN );
+   }
+   CBErrorCode status = xfer( iDev, offset, pBuffer, bytesToWrite, true,
+         accType );
+   if ( ERR_NONE == status ) {
+      l_nRepliesDue++;
+   }
+   return( status );
+}
+
+/******************************************************************************/
+static void replyAll( CBErrorCode status )
+{
+   while ( l_nRepliesDue > 0 ) {
+      l_nRepliesDue--;
+      DB_onWriteDoneEVT( status );
+   }
+}
+
+/******************************************************************************/
+void vTaskDelay( const TickType_t xTicksToDelay )
+{
+   /* The AO gets its replies while the thread waits for the DB */
+   if ( ++l_nDelays == REPLY_AFTER_DELAYS ) {
+      replyAll( ERR_NONE );
+   }
+}
+
+/******************************************************************************/
+static void clearXfers( void )
+{
+   l_nXfers  = 0;
+   l_nReads  = 0;
+   l_nWrites = 0;
+}
+
+/******************************************************************************/
+static bool isXfer( int i, I2C_Dev_t iDev, uint16_t offset, uint16_t len,
+      bool isWrite )
+{
+   return( i < l_nXfers && l_xfers[i].iDev == iDev &&
+         l_xfers[i].offset == offset && l_xfers[i].len == len &&
+         l_xfers[i].isWrite == isWrite );
+}
+
+/******************************************************************************/
+static void getIp( uint8_t ip[4] )
+{
+   HT_CHECK( ERR_NONE == DB_getElemBLK( DB_IP_ADDR, ip, 4, ACCESS_FREERTOS ) );
+}
+
+/**
+ * @brief   Validate and reset the DB, from a blank EEPROM and from the fixed
+ * layout older FW left behind.
+ * @param   None
+ * @return: None
+ */
+static void test_init( void )
+{
+   uint8_t ip[4];
+
+   /* Blank: a header read per bank and the old layout.  Nothing to move. */
+   memset( l_mem[EEPROM], 0xFF, MEM_SIZE );
+   clearXfers();
+   HT_CHECK( ERR_DB_NOT_INIT == DB_isValid( ACCESS_FREERTOS ) );
+   HT_CHECK_MSG( N_BANKS + 1 == l_nReads && 0 == l_nWrites, "%d reads %d "
+         "writes", l_nReads, l_nWrites );
+   for ( int bank = 0; bank < N_BANKS; bank++ ) {
+      HT_CHECK( isXfer( bank, EEPROM, (uint16_t)( bank * BANK_SIZE ), 10,
+            false ) );
+   }
+
+   /* The SettingsDB_t layout: magic, version 1, then the IP address */
+   static const uint8_t legacy[] = {
+         0xdb, 0xc8, 0xfe, 0xde, 0x01, 0x00, 10, 1, 2, 3
+   };
+   memcpy( l_mem[EEPROM], legacy, sizeof(legacy) );
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_isValid( ACCESS_FREERTOS ) );
+   HT_CHECK_MSG( N_BANKS + 1 == l_nReads && 2 == l_nWrites, "%d reads %d "
+         "writes", l_nReads, l_nWrites );
+   HT_CHECK( 1 == DB_getStats()->nMigrations );
+
+   /* The records go in with one write and the header with another */
+   HT_CHECK( isXfer( N_BANKS + 1, EEPROM, BANK_SIZE + 10, 9, true ) );
+   HT_CHECK( isXfer( N_BANKS + 2, EEPROM, BANK_SIZE, 10, true ) );
+   getIp( ip );
+   HT_CHECK( 10 == ip[0] && 1 == ip[1] && 2 == ip[2] && 3 == ip[3] );
+
+   /* Mounted, so nothing more to read */
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_isValid( ACCESS_BARE_METAL ) );
+   HT_CHECK( ERR_NONE == DB_isValid( ACCESS_FREERTOS ) );
+   HT_CHECK( 0 == l_nXfers );
+
+   /* Back to the default in the next bank */
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_initToDefault( ACCESS_FREERTOS ) );
+   HT_CHECK_MSG( 0 == l_nReads && 2 == l_nWrites, "%d reads %d writes",
+         l_nReads, l_nWrites );
+   HT_CHECK( isXfer( 0, EEPROM, 2 * BANK_SIZE + 10, 9, true ) );
+   HT_CHECK( isXfer( 1, EEPROM, 2 * BANK_SIZE, 10, true ) );
+   getIp( ip );
+   HT_CHECK( 0 == memcmp( ip, l_defIp, sizeof(ip) ) );
+
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_initToDefault( ACCESS_BARE_METAL ) );
+   HT_CHECK( 2 == l_nWrites && ACCESS_BARE_METAL == l_xfers[0].accType );
+
+   /* An AO can do neither */
+   clearXfers();
+   HT_CHECK( ERR_DB_WRONG_ACCESS_TYPE == DB_isValid( ACCESS_QPC ) );
+   HT_CHECK( ERR_DB_WRONG_ACCESS_TYPE == DB_initToDefault( ACCESS_QPC ) );
+   HT_CHECK( 0 == l_nXfers );
+}
+
+/**
+ * @brief   Read all the elements in many orders.  One read per device.
+ * @param   None
+ * @return: None
+ */
+static void test_readAll( void )
+{
+   uint8_t magic[4], version[2], mac[MAC_LEN], ip[4], sn[SN_LEN];
+   DB_ElemBuf_t elems[DB_MAX_ELEM] = {
+         { DB_MAGIC_WORD, magic,   sizeof(magic) },
+         { DB_VERSION,    version, sizeof(version) },
+         { DB_MAC_ADDR,   mac,     sizeof(mac) },
+         { DB_IP_ADDR,    ip,      sizeof(ip) },
+         { DB_SN,         sn,      sizeof(sn) },
+   };
+
+   for ( int k = 0; k < MEM_SIZE; k++ ) {
+      l_mem[SN_ROM][k]  = (uint8_t)( 0x40 + k );
+      l_mem[EUI_ROM][k] = (uint8_t)( 0x80 + k );
+   }
+
+   for ( int n = 0; n < N_ORDERS; n++ ) {
+      for ( int i = DB_MAX_ELEM - 1; i > 0; i-- ) {
+         int j = (int)( HT_rand( &l_seed ) % (uint32_t)( i + 1 ) );
+         DB_ElemBuf_t t = elems[i];
+         elems[i] = elems[j];
+         elems[j] = t;
+      }
+      memset( magic, 0, sizeof(magic) );
+      memset( version, 0, sizeof(version) );
+      memset( mac, 0, sizeof(mac) );
+      memset( ip, 0, sizeof(ip) );
+      memset( sn, 0, sizeof(sn) );
+
+      AccessType_t accType = ( n & 1 ) ? ACCESS_BARE_METAL : ACCESS_FREERTOS;
+      clearXfers();
+      HT_CHECK( ERR_NONE == DB_getElemsBLK( elems, DB_MAX_ELEM, accType ) );
+
+      /* By device, since they are sorted by location */
+      HT_CHECK_MSG( 3 == l_nXfers && 3 == l_nReads, "%d transfers",
+            l_nXfers );
+      HT_CHECK( isXfer( 0, EEPROM, l_xfers[0].offset, 4, false ) );
+      HT_CHECK( isXfer( 1, SN_ROM, 0, SN_LEN, false ) );
+      HT_CHECK( isXfer( 2, EUI_ROM, MAC_OFFSET, MAC_LEN, false ) );
+      HT_CHECK( accType == l_xfers[0].accType );
+
+      HT_CHECK( 0xdb == magic[0] && 0xc8 == magic[1] && 0xfe == magic[2] &&
+            0xde == magic[3] );
+      HT_CHECK( 0x02 == version[0] && 0x00 == version[1] );
+      HT_CHECK( 0 == memcmp( ip, l_defIp, sizeof(ip) ) );
+      HT_CHECK( 0 == memcmp( sn, &l_mem[SN_ROM][0], SN_LEN ) );
+      HT_CHECK( 0 == memcmp( mac, &l_mem[EUI_ROM][MAC_OFFSET], MAC_LEN ) );
+   }
+
+   /* The header elements are in RAM */
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_getElemBLK( DB_VERSION, version, sizeof(version),
+         ACCESS_FREERTOS ) );
+   HT_CHECK( 0 == l_nXfers );
+
+   /* An AO has to ask for one element at a time */
+   HT_CHECK( ERR_DB_WRONG_ACCESS_TYPE == DB_getElemsBLK( elems, DB_MAX_ELEM,
+         ACCESS_QPC ) );
+   HT_CHECK( ERR_NONE == DB_getElemEVT( DB_SN, &l_requester, 7 ) );
+   HT_CHECK( 1 == l_nXfers && isXfer( 0, SN_ROM, 0, SN_LEN, false ) );
+}
+
+/**
+ * @brief   Write batches.  A bad one writes nothing, a good one is a single
+ * write, also from an AO.
+ * @param   None
+ * @return: None
+ */
+static void test_write( void )
+{
+   uint8_t ip[4] = { 192, 168, 7, 7 };
+   uint8_t mac[MAC_LEN] = { 0 };
+   uint8_t got[4];
+   uint8_t nReplies = 0xAA;
+   const DBJ_Stats_t *stats = DB_getStats();
+   uint32_t nBytes = stats->nBytesWritten;
+
+   DB_ElemBuf_t readOnly[] = {
+         { DB_IP_ADDR,  ip,  sizeof(ip) },
+         { DB_MAC_ADDR, mac, sizeof(mac) },
+   };
+   DB_ElemBuf_t shortBuf[] = {
+         { DB_IP_ADDR,  ip,  sizeof(ip) },
+         { DB_IP_ADDR,  ip,  sizeof(ip) - 1 },
+   };
+   DB_ElemBuf_t badElem[] = {
+         { DB_IP_ADDR,  ip,  sizeof(ip) },
+         { DB_MAX_ELEM, ip,  sizeof(ip) },
+   };
+   DB_ElemBuf_t noBuf[] = {
+         { DB_IP_ADDR,  ip,  sizeof(ip) },
+         { DB_IP_ADDR,  NULL, sizeof(ip) },
+   };
+
+   clearXfers();
+   HT_CHECK( ERR_DB_ELEM_IS_READ_ONLY == DB_setElemsBLK( readOnly,
+         Q_DIM(readOnly), ACCESS_FREERTOS ) );
+   HT_CHECK( ERR_DB_ELEM_IS_READ_ONLY == DB_setElemsBLK( readOnly,
+         Q_DIM(readOnly), ACCESS_BARE_METAL ) );
+   HT_CHECK( ERR_DB_ELEM_IS_READ_ONLY == DB_setElemsEVT( readOnly,
+         Q_DIM(readOnly), &l_requester, 1, &nReplies ) );
+   HT_CHECK( 0 == nReplies );
+   HT_CHECK( ERR_MEM_BUFFER_LEN == DB_setElemsBLK( shortBuf,
+         Q_DIM(shortBuf), ACCESS_FREERTOS ) );
+   HT_CHECK( ERR_DB_ELEM_NOT_FOUND == DB_setElemsBLK( badElem,
+         Q_DIM(badElem), ACCESS_FREERTOS ) );
+   HT_CHECK( ERR_MEM_NULL_VALUE == DB_setElemsBLK( noBuf, Q_DIM(noBuf),
+         ACCESS_FREERTOS ) );
+   HT_CHECK( ERR_MEM_BUFFER_LEN == DB_setElemsBLK( readOnly, 0,
+         ACCESS_FREERTOS ) );
+   HT_CHECK( ERR_DB_WRONG_ACCESS_TYPE == DB_setElemsBLK( readOnly, 1,
+         ACCESS_QPC ) );
+   HT_CHECK( 0 == l_nXfers && nBytes == stats->nBytesWritten );
+   getIp( got );
+   HT_CHECK( 0 == memcmp( got, l_defIp, sizeof(got) ) );
+
+   /* Only the read of the IP address, no write */
+   HT_CHECK( 1 == l_nXfers && 0 == l_nWrites );
+
+   /* A thread appends the record with one write */
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_setElemsBLK( readOnly, 1, ACCESS_FREERTOS ) );
+   HT_CHECK( 1 == l_nWrites && 0 == l_nReads );
+   HT_CHECK( l_xfers[0].len == DBJ_REC_OVERHEAD + sizeof(ip) );
+   getIp( got );
+   HT_CHECK( 0 == memcmp( got, ip, sizeof(got) ) );
+
+   /* So does an AO, but the DB stays busy until the reply is in.  A thread
+    * that wants it in the meantime waits. */
+   ip[3] = 8;
+   clearXfers();
+   l_nDelays = 0;
+   HT_CHECK( ERR_NONE == DB_setElemsEVT( readOnly, 1, &l_requester, 2,
+         &nReplies ) );
+   HT_CHECK( 1 == nReplies && 1 == l_nWrites && 1 == l_nRepliesDue );
+   HT_CHECK( ERR_DB_BUSY == DB_setElemsEVT( readOnly, 1, &l_requester, 3,
+         &nReplies ) );
+   HT_CHECK( 1 == l_nWrites );
+   getIp( got );
+   HT_CHECK( REPLY_AFTER_DELAYS == l_nDelays && 0 == l_nRepliesDue );
+   HT_CHECK( 0 == memcmp( got, ip, sizeof(got) ) );
+
+   /* A failed write leaves the value it had */
+   ip[3] = 9;
+   HT_CHECK( ERR_NONE == DB_setElemsEVT( readOnly, 1, &l_requester, 4,
+         &nReplies ) );
+   replyAll( ERR_I2CBUS_XFER_TIMEOUT );
+   getIp( got );
+   HT_CHECK( 8 == got[3] );
+}
+
+/**
+ * @brief   Read two elements on the same device with a gap between them.
+ * @param   None
+ * @return: None
+ */
+static void test_gap( void )
+{
+   uint8_t mac[MAC_LEN], sn[MAX_I2C_READ_LEN];
+   uint16_t macEnd = MAC_OFFSET + MAC_LEN;
+   DB_ElemBuf_t elems[] = {
+         { DB_SN,       sn,  sizeof(sn) },
+         { DB_MAC_ADDR, mac, sizeof(mac) },
+   };
+
+   /* Right after it and up to the longest gap: one read over the gap */
+   for ( uint16_t gap = 0; gap <= READ_MAX_GAP; gap++ ) {
+      DB_hostPlaceElem( DB_SN, DB_MAC_ADDR, macEnd + gap, 4 );
+      clearXfers();
+      HT_CHECK( ERR_NONE == DB_getElemsBLK( elems, Q_DIM(elems),
+            ACCESS_FREERTOS ) );
+      HT_CHECK_MSG( 1 == l_nXfers && isXfer( 0, EUI_ROM, MAC_OFFSET,
+            MAC_LEN + gap + 4, false ), "gap %u: %d transfers", gap,
+            l_nXfers );
+      HT_CHECK( 0 == memcmp( mac, &l_mem[EUI_ROM][MAC_OFFSET], MAC_LEN ) );
+      HT_CHECK( 0 == memcmp( sn, &l_mem[EUI_ROM][macEnd + gap], 4 ) );
+   }
+
+   /* One more and it's cheaper to read them apart */
+   DB_hostPlaceElem( DB_SN, DB_MAC_ADDR, macEnd + READ_MAX_GAP + 1, 4 );
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_getElemsBLK( elems, Q_DIM(elems),
+         ACCESS_FREERTOS ) );
+   HT_CHECK( 2 == l_nXfers );
+   HT_CHECK( isXfer( 0, EUI_ROM, MAC_OFFSET, MAC_LEN, false ) );
+   HT_CHECK( isXfer( 1, EUI_ROM, macEnd + READ_MAX_GAP + 1, 4, false ) );
+
+   /* Overlapping, and in front of it */
+   DB_hostPlaceElem( DB_SN, DB_MAC_ADDR, MAC_OFFSET + 1, 2 );
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_getElemsBLK( elems, Q_DIM(elems),
+         ACCESS_BARE_METAL ) );
+   HT_CHECK( 1 == l_nXfers && isXfer( 0, EUI_ROM, MAC_OFFSET, MAC_LEN,
+         false ) );
+   HT_CHECK( 0 == memcmp( sn, &l_mem[EUI_ROM][MAC_OFFSET + 1], 2 ) );
+
+   DB_hostPlaceElem( DB_SN, DB_MAC_ADDR, 0, 1 );
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_getElemsBLK( elems, Q_DIM(elems),
+         ACCESS_FREERTOS ) );
+   HT_CHECK( 1 == l_nXfers && isXfer( 0, EUI_ROM, 0, macEnd, false ) );
+
+   /* Merged, the run would be longer than a read can be */
+   uint16_t len = MAX_I2C_READ_LEN - MAC_LEN - 1;
+   DB_hostPlaceElem( DB_SN, DB_MAC_ADDR, macEnd + 1, len );
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_getElemsBLK( elems, Q_DIM(elems),
+         ACCESS_FREERTOS ) );
+   HT_CHECK( 1 == l_nXfers && isXfer( 0, EUI_ROM, MAC_OFFSET,
+         MAX_I2C_READ_LEN, false ) );
+
+   DB_hostPlaceElem( DB_SN, DB_MAC_ADDR, macEnd + 1, len + 1 );
+   clearXfers();
+   HT_CHECK( ERR_NONE == DB_getElemsBLK( elems, Q_DIM(elems),
+         ACCESS_FREERTOS ) );
+   HT_CHECK( 2 == l_nXfers );
+   HT_CHECK( 0 == memcmp( sn, &l_mem[EUI_ROM][macEnd + 1], len + 1 ) );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_init();
+   test_readAll();
+   test_write();
+   test_gap();
+   return( HT_DONE( "db_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,561 @@
+/**
+ * @file   eth_driver_bench.c
+ * @brief  Host benchmark of how fairly and how cheaply eth_driver.c takes
+ * frames off the simulated MAC.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The real eth_driver.c runs on the simulated MAC with lwIP and LWIPMgr
+ * stood in for, in simulated time.  Frames come in on the clock and every bit
+ * of work moves it, so an RX burst holds up the 1ms tick event of the AO the
+ * way it would on the board.  Assumed costs: 8us lwIP input per frame, a 2us
+ * reply every 2nd frame, 1.5us ISR, 2us dispatch and 20us of tick work.
+ *
+ * - flood64: 64 byte frames back to back.  No poll takes more than
+ *   ETH_RX_BUDGET frames and the tick waits for at most one budget of them.
+ * - line256, burst128: at least ETH_RX_IRQ_FRAMES frames per interrupt.
+ * - sparse: a frame a millisecond.  The receive watchdog brings in the ones
+ *   that don't interrupt, ETH_RX_IRQ_USEC later.
+ * - tx: lwIP sends 12 frames with the wire busy.  They all go out once it
+ *   frees up, with one LWIP_TX_READY_SIG.
+ *
+ * The defaults the driver is tuned to (a budget of 8, and an interrupt every
+ * 4 frames or 50us) are checked too, so a change to them shows up here with
+ * the numbers to go with it.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "eth_host.h"
+#include "netif/eth_driver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define RX_NS                   8000           /**< lwIP input of one frame */
+#define TX_NS                   2000                /**< Sending a reply */
+#define ISR_NS                  1500
+#define DISPATCH_NS             2000
+#define TICK_NS                 20000           /**< Work of the tick event */
+#define TICK_PERIOD_NS          1000000
+#define REPLY_EVERY             2
+#define STEP_NS                 500           /**< Clock resolution */
+#define DRAIN_NS                20000000  /**< Run on after the last frame */
+#define AO_QUEUE_LEN            256                    /**< Power of 2 */
+#define MAX_PBUFS               16
+#define REPLY_LEN               62
+#define N_TX                    12
+#define TICK_SIG                1
+
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct Scenario_t
+ * Frames coming in evenly spaced, in bursts if burst isn't 0.
+ */
+typedef struct Scenarios {
+   const char *name;
+   uint16_t    len;                               /**< Bytes without FCS */
+   int         n;
+   uint64_t    gapNs;                          /**< Between frame starts */
+   int         burst;                          /**< Frames in a burst */
+   uint64_t    burstGapNs;                     /**< Between burst starts */
+} Scenario_t;
+
+/**
+ * \struct Run_t
+ * What happened in one scenario.
+ */
+typedef struct Runs {
+   int      nInput;                      /**< Frames that reached lwIP */
+   int      nDropped;              /**< Frames the MAC had no room for */
+   int      nReplies;
+   int      nTxWire;                        /**< Frames the MAC sent */
+   int      nPostRx;
+   int      nPostTx;
+   int      qMax;                          /**< Deepest the AO queue got */
+   int      maxPerPoll;         /**< Most frames one eth_driver_read() took */
+   double   latSum;            /**< Frame arrival to lwIP input, in ns */
+   uint64_t latMax;
+   uint64_t tickLatSum;          /**< Tick post to its dispatch, in ns */
+   uint64_t tickLatMax;
+   int      nTicks;
+   uint64_t busyNs;                      /**< AO time, ISR time not in it */
+   uint64_t isrNs;
+} Run_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static const Scenario_t l_scenarios[] = {
+   { "flood64",  60,  20000,   84 * 80,  0,  0       },
+   { "line256",  252, 5000,    276 * 80, 0,  0       },
+   { "burst128", 124, 64 * 20, 148 * 80, 64, 5000000 },
+   { "sparse",   124, 200,     1000000,  0,  0       },
+};
+
+static QEvt const    l_tickEvt = { TICK_SIG, 0U, 0U };
+static struct QActive { int unused; } l_ao;        /**< Stands in for LWIPMgr */
+static struct netif *l_pNetif;
+static Run_t         l_run;
+
+/**< The queue of the AO, with the time of every post */
+static QEvt const   *l_aoQ[AO_QUEUE_LEN];
+static uint64_t      l_aoQTime[AO_QUEUE_LEN];
+static int           l_aoQHead;
+static int           l_aoQTail;
+static int           l_aoQN;
+
+/**< Simulated time, and what's due on it */
+static uint64_t      l_now;
+static uint64_t      l_nextTick;
+static uint64_t      l_isrDebt;      /**< ISR time still to be added to now */
+static uint64_t     *l_arrivals;
+static int           l_nArrivals;
+static int           l_nextArrival;
+static uint16_t      l_arrivalLen;
+static int           l_nPbufs;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* What eth_driver.c needs from the firmware and lwIP */
+uint32_t SystemCoreClock = ETH_SIM_HCLK_HZ;
+struct stats_ lwip_stats;
+
+/* memcpy.S of the firmware is Thumb assembly */
+void *MEM_DataCopy( void *destination, const void *source, uint16_t num )
+{
+   return( memcpy( destination, source, num ) );
+}
+
+/******************************************************************************/
+void HOST_post( QActive *me, QEvt const *e )
+{
+   (void)me;
+   if ( AO_QUEUE_LEN == l_aoQN ) {
+      fprintf( stderr, "AO queue overflow\n" );
+      exit( 1 );
+   }
+   if ( LWIP_RX_READY_SIG == e->sig ) {
+      l_run.nPostRx++;
+   } else if ( LWIP_TX_READY_SIG == e->sig ) {
+      l_run.nPostTx++;
+   }
+   l_aoQ[l_aoQTail] = e;
+   l_aoQTime[l_aoQTail] = l_now;
+   l_aoQTail = ( l_aoQTail + 1 ) & ( AO_QUEUE_LEN - 1 );
+   if ( ++l_aoQN > l_run.qMax ) {
+      l_run.qMax = l_aoQN;
+   }
+}
+
+/**
+ * @brief   Put the frames that are due in the RX ring and post the tick.
+ * @param   None
+ * @return: None
+ */
+static void deliver( void )
+{
+   static uint8_t fr[ETH_SIM_MAX_FRAME_LEN];
+
+   while ( l_nextArrival < l_nArrivals && l_arrivals[l_nextArrival] <= l_now ) {
+      memset( fr, 0, l_arrivalLen );
+      memcpy( fr, l_pNetif->hwaddr, 6 );
+      fr[6]  = 0x02; fr[11] = 0x09;
+      fr[12] = 0x08;                                               /* IPv4 */
+      memcpy( &fr[14], &l_nextArrival, sizeof(l_nextArrival) );
+      if ( ERR_NONE != ETH_SIM_rxFrame( fr, l_arrivalLen ) ) {
+         l_run.nDropped++;
+      }
+      l_nextArrival++;
+   }
+   if ( l_now >= l_nextTick ) {
+      HOST_post( (QActive *)&l_ao, &l_tickEvt );
+      l_nextTick += TICK_PERIOD_NS;
+   }
+}
+
+/**
+ * @brief   Let simulated time pass, plus whatever the ISR takes meanwhile.
+ * @param [in] ns: uint64_t nanoseconds of work.
+ * @return: None
+ */
+static void advance( uint64_t ns )
+{
+   uint64_t until = l_now + ns;
+   while ( l_now < until ) {
+      uint64_t step = until - l_now < STEP_NS ? until - l_now : STEP_NS;
+      l_now += step;
+      ETH_SIM_elapse( (uint32_t)step );
+      deliver();
+      until += l_isrDebt;
+      l_isrDebt = 0;
+   }
+}
+
+/******************************************************************************/
+static void isr( void )
+{
+   l_isrDebt += ISR_NS;
+   l_run.isrNs += ISR_NS;
+   ETH_EventCallback();
+}
+
+/******************************************************************************/
+static void txFn( const uint8_t *frame, uint16_t len, void *arg )
+{
+   (void)frame; (void)len; (void)arg;
+   l_run.nTxWire++;
+}
+
+/* lwIP, down to what eth_driver.c calls */
+struct pbuf *pbuf_alloc( pbuf_layer layer, u16_t length, pbuf_type type )
+{
+   (void)layer; (void)type;
+   if ( MAX_PBUFS == l_nPbufs ) {
+      return( NULL );
+   }
+   struct pbuf *p = calloc( 1, sizeof(*p) + length );
+   p->payload = (uint8_t *)( p + 1 );
+   p->len = p->tot_len = length;
+   p->ref = 1;
+   l_nPbufs++;
+   return( p );
+}
+
+u8_t pbuf_free( struct pbuf *p )
+{
+   if ( 0 != --p->ref ) {
+      return( 0 );
+   }
+   free( p );
+   l_nPbufs--;
+   return( 1 );
+}
+
+void pbuf_ref( struct pbuf *p )
+{
+   p->ref++;
+}
+
+u8_t pbuf_header( struct pbuf *p, s16_t inc )
+{
+   p->payload = (uint8_t *)p->payload - inc;
+   p->len += inc;
+   p->tot_len += inc;
+   return( 0 );
+}
+
+/* Takes the frame and sends a short reply every REPLY_EVERY frames */
+err_t ethernet_input( struct pbuf *p, struct netif *netif )
+{
+   int seq;
+   memcpy( &seq, (uint8_t *)p->payload + ETH_PAD_SIZE + 14, sizeof(seq) );
+   uint64_t lat = l_now - l_arrivals[seq];
+   l_run.latSum += (double)lat;
+   if ( lat > l_run.latMax ) {
+      l_run.latMax = lat;
+   }
+   l_run.nInput++;
+   pbuf_free( p );
+   advance( RX_NS );
+   l_run.busyNs += RX_NS;
+
+   if ( 0 == l_run.nInput % REPLY_EVERY ) {
+      struct pbuf *r = pbuf_alloc( PBUF_RAW, REPLY_LEN, PBUF_RAM );
+      if ( NULL != r ) {
+         memset( r->payload, 0, REPLY_LEN );
+         netif->linkoutput( netif, r );
+         pbuf_free( r );
+         l_run.nReplies++;
+      }
+      advance( TX_NS );
+      l_run.busyNs += TX_NS;
+   }
+   return( ERR_OK );
+}
+
+err_t etharp_output( struct netif *netif, struct pbuf *p, ip_addr_t *ipaddr )
+{
+   (void)netif; (void)p; (void)ipaddr;
+   return( ERR_OK );
+}
+
+err_t ip_input( struct pbuf *p, struct netif *inp )
+{
+   (void)p; (void)inp;
+   return( ERR_OK );
+}
+
+void lwip_init( void ) {}
+void netif_set_default( struct netif *netif ) { (void)netif; }
+void netif_set_up( struct netif *netif ) { (void)netif; }
+
+struct netif *netif_add(
+      struct netif *netif,
+      ip_addr_t *ipaddr,
+      ip_addr_t *netmask,
+      ip_addr_t *gw,
+      void *state,
+      netif_init_fn init,
+      netif_input_fn input
+)
+{
+   (void)ipaddr; (void)netmask; (void)gw;
+   netif->state = state;
+   netif->input = input;
+   l_pNetif = netif;
+   init( netif );
+   return( netif );
+}
+
+/**
+ * @brief   Dispatch the oldest event of the AO the way LWIPMgr does.
+ * @param   None
+ * @return: None
+ */
+static void dispatchOne( void )
+{
+   QEvt const *e = l_aoQ[l_aoQHead];
+   uint64_t postedAt = l_aoQTime[l_aoQHead];
+   l_aoQHead = ( l_aoQHead + 1 ) & ( AO_QUEUE_LEN - 1 );
+   l_aoQN--;
+
+   advance( DISPATCH_NS );
+   l_run.busyNs += DISPATCH_NS;
+   switch ( e->sig ) {
+      case LWIP_RX_READY_SIG: {
+         int nBefore = l_run.nInput;
+         eth_driver_read();
+         if ( l_run.nInput - nBefore > l_run.maxPerPoll ) {
+            l_run.maxPerPoll = l_run.nInput - nBefore;
+         }
+         break;
+      }
+      case LWIP_TX_READY_SIG:
+         eth_driver_write();
+         break;
+      case TICK_SIG: {
+         uint64_t lat = l_now - postedAt;
+         l_run.tickLatSum += lat;
+         if ( lat > l_run.tickLatMax ) {
+            l_run.tickLatMax = lat;
+         }
+         l_run.nTicks++;
+         advance( TICK_NS );
+         l_run.busyNs += TICK_NS;
+         break;
+      }
+      default:
+         break;
+   }
+   ETH_SIM_poll();
+}
+
+/**
+ * @brief   Bring up the simulated MAC and the driver on it, as the BSP and
+ * LWIPMgr do.
+ * @param   None
+ * @return: None
+ */
+static void setup( void )
+{
+   memset( &l_run, 0, sizeof(l_run) );
+   l_aoQHead = l_aoQTail = l_aoQN = 0;
+   l_now = 0;
+   l_isrDebt = 0;
+   l_nextTick = TICK_PERIOD_NS / 2;
+   l_nArrivals = l_nextArrival = 0;
+
+   ETH_SIM_init( isr, txFn, NULL );
+   ETH_DMAITConfig( ETH_DMA_IT_NIS | ETH_DMA_IT_R, ENABLE );
+   uint8_t mac[NETIF_MAX_HWADDR_LEN];
+   memcpy( mac, EthHost_mac, sizeof(mac) );
+   eth_driver_init( (QActive *)&l_ao, mac );
+   ETH_SIM_poll();
+}
+
+/**
+ * @brief   Check the driver programs the defaults it's tuned to.
+ * @param   None
+ * @return: None
+ */
+static void test_defaults( void )
+{
+   HT_CHECK( 8 == ETH_RX_BUDGET );
+   HT_CHECK( 4 == ETH_RX_IRQ_FRAMES );
+   HT_CHECK( 50 == ETH_RX_IRQ_USEC );
+
+   setup();
+   int nIoc = 0;
+   for ( int i = 0; i < ETH_RXBUFNB; i++ ) {
+      if ( 0 == ( DMARxDscrTab[i].ControlBufferSize & ETH_DMARxDesc_DIC ) ) {
+         nIoc++;
+         HT_CHECK( 0 == ( i + 1 ) % ETH_RX_IRQ_FRAMES );
+      }
+   }
+   HT_CHECK( ETH_RXBUFNB / ETH_RX_IRQ_FRAMES == nIoc );
+
+   /* The watchdog counts 256 HCLK cycles, rounded up to the next one */
+   uint64_t wdtNs = (uint64_t)ETH->DMARSWTR * 256U * 1000000000ULL / ETH_SIM_HCLK_HZ;
+   HT_CHECK_MSG( wdtNs >= ETH_RX_IRQ_USEC * 1000U &&
+         wdtNs < ETH_RX_IRQ_USEC * 1000U + 256U * 1000000000ULL / ETH_SIM_HCLK_HZ,
+         "watchdog %u counts", (unsigned)ETH->DMARSWTR );
+}
+
+/**
+ * @brief   Run one scenario of frames coming in, print the numbers and check
+ * them.
+ * @param [in] *sc: const Scenario_t pointer to the scenario.
+ * @return: None
+ */
+static void runScenario( const Scenario_t *sc )
+{
+   setup();
+   l_arrivalLen = sc->len;
+   l_nArrivals = sc->n;
+   l_arrivals = malloc( sizeof(*l_arrivals) * sc->n );
+   uint64_t t = 10000;
+   for ( int i = 0; i < sc->n; i++ ) {
+      if ( 0 != sc->burst && 0 != i && 0 == i % sc->burst ) {
+         t = (uint64_t)( i / sc->burst ) * sc->burstGapNs + 10000;
+      }
+      l_arrivals[i] = t;
+      t += sc->gapNs;
+   }
+
+   EthSimStats_t sim0 = *ETH_SIM_getStats();
+   EthDriverStats_t drv0 = *eth_driver_getStats();
+   uint64_t end = l_arrivals[sc->n - 1] + DRAIN_NS;
+   while ( l_now < end ) {
+      if ( 0 != l_aoQN ) {
+         dispatchOne();
+      } else {
+         advance( STEP_NS );
+      }
+   }
+   const EthSimStats_t *sim = ETH_SIM_getStats();
+   const EthDriverStats_t *drv = eth_driver_getStats();
+   uint32_t irqs = drv->rxIrqs - drv0.rxIrqs;
+   uint32_t wdts = sim->rxWatchdog - sim0.rxWatchdog;
+   int nIn = 0 != l_run.nInput ? l_run.nInput : 1;
+   double framesPerIrq = 0 != irqs ? (double)l_run.nInput / irqs : 0.0;
+
+   printf( "%-8s | %5d | %5d | %4d | %5u | %4u | %4d | %7.2f | %6.2f | "
+         "%7.1f | %7.1f | %8.1f | %8.1f | %4d\n",
+         sc->name, sc->n, l_run.nInput, l_run.nDropped, irqs, wdts,
+         l_run.maxPerPoll, framesPerIrq,
+         (double)( l_run.busyNs + l_run.isrNs ) / nIn / 1000.0,
+         l_run.latSum / nIn / 1000.0, l_run.latMax / 1000.0,
+         (double)l_run.tickLatSum / ( l_run.nTicks ? l_run.nTicks : 1 ) / 1000.0,
+         l_run.tickLatMax / 1000.0, l_run.qMax );
+
+   /* Every frame made it to lwIP or was dropped by the MAC, and the driver
+    * went back to waiting on the interrupt with nothing held */
+   HT_CHECK_MSG( sc->n == l_run.nInput + l_run.nDropped, "%s: %d in, %d dropped",
+         sc->name, l_run.nInput, l_run.nDropped );
+   HT_CHECK( (int)( drv->rxFrames - drv0.rxFrames ) == l_run.nInput );
+   HT_CHECK( 0 != ( ETH->DMAIER & ETH_DMA_IT_R ) );
+   HT_CHECK( 0 == l_aoQN && 0 == l_nPbufs );
+   HT_CHECK( l_run.nReplies == l_run.nTxWire );
+
+   /* At most one LWIP_RX_READY_SIG waits in the queue at a time, and the
+    * budget is all one poll takes */
+   HT_CHECK( l_run.nPostRx == (int)( irqs + drv->rxResched - drv0.rxResched ) );
+   HT_CHECK_MSG( l_run.maxPerPoll <= ETH_RX_BUDGET, "%s: %d frames in a poll",
+         sc->name, l_run.maxPerPoll );
+
+   if ( 0 == strcmp( sc->name, "flood64" ) ) {
+      /* The ring never empties, so every poll takes the whole budget and the
+       * tick waits behind one poll at most */
+      uint64_t maxTickWait = (uint64_t)ETH_RX_BUDGET * ( RX_NS + TX_NS ) +
+            2U * DISPATCH_NS + 4U * ISR_NS;
+      HT_CHECK( ETH_RX_BUDGET == l_run.maxPerPoll );
+      HT_CHECK_MSG( l_run.tickLatMax <= maxTickWait, "tick waited %.1fus",
+            l_run.tickLatMax / 1000.0 );
+      HT_CHECK_MSG( l_run.qMax <= 3, "%d events queued", l_run.qMax );
+   } else if ( 0 == strcmp( sc->name, "sparse" ) ) {
+      /* Every frame is alone in the ring.  The ones in a descriptor that
+       * interrupts come straight in, the rest when the watchdog runs out. */
+      uint64_t wdtNs = (uint64_t)ETH->DMARSWTR * 256U * 1000000000ULL / ETH_SIM_HCLK_HZ;
+      HT_CHECK_MSG( (int)wdts >= sc->n - sc->n / ETH_RX_IRQ_FRAMES,
+            "%u of %d frames on the watchdog", wdts, sc->n );
+      HT_CHECK_MSG( (int)irqs == sc->n, "%u irqs for %d frames", irqs, sc->n );
+      HT_CHECK_MSG( l_run.latMax >= wdtNs &&
+            l_run.latMax <= wdtNs + ISR_NS + DISPATCH_NS + STEP_NS,
+            "latency %.1fus, watchdog %.1fus", l_run.latMax / 1000.0,
+            wdtNs / 1000.0 );
+   } else {
+      /* Moderation: an interrupt takes in ETH_RX_IRQ_FRAMES frames or more */
+      HT_CHECK_MSG( framesPerIrq >= ETH_RX_IRQ_FRAMES, "%s: %.2f frames per irq",
+            sc->name, framesPerIrq );
+      HT_CHECK( 0 == l_run.nDropped );
+   }
+
+   free( l_arrivals );
+   l_arrivals = NULL;
+}
+
+/**
+ * @brief   lwIP sends with every TX descriptor busy.
+ * @param   None
+ * @return: None
+ */
+static void test_txBusy( void )
+{
+   setup();
+   ETH_SIM_txHold( true );
+   int nOk = 0;
+   for ( int i = 0; i < N_TX; i++ ) {
+      struct pbuf *r = pbuf_alloc( PBUF_RAW, REPLY_LEN, PBUF_RAM );
+      memset( r->payload, 0, REPLY_LEN );
+      ((uint8_t *)r->payload)[20] = (uint8_t)i;
+      if ( ERR_OK == l_pNetif->linkoutput( l_pNetif, r ) ) {
+         nOk++;
+      }
+      pbuf_free( r );
+   }
+   ETH_SIM_poll();
+   int nHeld = l_run.nTxWire;
+   ETH_SIM_txHold( false );
+   while ( 0 != l_aoQN ) {
+      dispatchOne();
+   }
+
+   printf( "tx: %d of %d taken, %d sent while held, %d after, "
+         "%d LWIP_TX_READY_SIG\n", nOk, N_TX, nHeld, l_run.nTxWire, l_run.nPostTx );
+   HT_CHECK( N_TX == nOk );
+   HT_CHECK( 0 == nHeld );
+   HT_CHECK( N_TX == l_run.nTxWire );
+   HT_CHECK( 1 == l_run.nPostTx );
+   HT_CHECK( 0 == l_nPbufs );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_defaults();
+
+   printf( "budget %d, irq every %d frames or %dus\n", ETH_RX_BUDGET,
+         ETH_RX_IRQ_FRAMES, ETH_RX_IRQ_USEC );
+   printf( "scenario |    in |    up | drop |  irqs | wdts | poll | "
+         "  f/irq | us/frm | lat avg | lat max | tick avg | tick max | qMax\n" );
+   for ( size_t s = 0; s < sizeof(l_scenarios) / sizeof(l_scenarios[0]); s++ ) {
+      runScenario( &l_scenarios[s] );
+   }
+   test_txBusy();
+
+   return( HT_DONE( "eth_driver_bench" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,105 @@
+/**
+ * @file   eth_host.c
+ * @brief  Glue for running the ST Ethernet driver on the simulated MAC
+ * without lwIP.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "eth_host.h"
+#include "stm32f4xx_rcc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private variables and Local objects ---------------------------------------*/
+const uint8_t EthHost_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+/* Public functions ----------------------------------------------------------*/
+
+/* The RCC and assert calls the vendor driver makes.  There's no clock tree or
+ * reset line to touch on the host. */
+void RCC_AHB1PeriphResetCmd( uint32_t periph, FunctionalState state )
+{
+   (void)periph; (void)state;
+}
+
+void RCC_GetClocksFreq( RCC_ClocksTypeDef *clocks )
+{
+   memset( clocks, 0, sizeof(*clocks) );
+}
+
+void assert_failed( uint8_t *file, uint32_t line )
+{
+   fprintf( stderr, "%s:%u: assert_param failed\n", (char *)file, line );
+   exit( 1 );
+}
+
+/******************************************************************************/
+void EthHost_setup( ETH_SIM_IrqFn irqFn, ETH_SIM_TxFn txFn, void *txArg )
+{
+   ETH_SIM_init( irqFn, txFn, txArg );
+   ETH_MACAddressConfig( ETH_MAC_Address0, (uint8_t *)EthHost_mac );
+   ETH_DMATxDescChainInit( DMATxDscrTab, &Tx_Buff[0][0], ETH_TXBUFNB );
+   ETH_DMARxDescChainInit( DMARxDscrTab, &Rx_Buff[0][0], ETH_RXBUFNB );
+   for ( int i = 0; i < ETH_RXBUFNB; i++ ) {
+      ETH_DMARxDescReceiveITConfig( &DMARxDscrTab[i], ENABLE );
+   }
+   for ( int i = 0; i < ETH_TXBUFNB; i++ ) {
+      ETH_DMATxDescChecksumInsertionConfig( &DMATxDscrTab[i],
+            ETH_DMATxDesc_ChecksumTCPUDPICMPFull );
+   }
+   ETH_Start();
+   ETH_SIM_poll();
+   ETH_DMAITConfig( ETH_DMA_IT_NIS | ETH_DMA_IT_R, ENABLE );
+}
+
+/******************************************************************************/
+int EthHost_receive( uint8_t *out )
+{
+   FrameTypeDef frame = ETH_Get_Received_Frame_interrupt();
+   if ( 0 == frame.length ) {
+      return( -1 );
+   }
+
+   int len = frame.length;
+   int off = 0;
+   __IO ETH_DMADESCTypeDef *desc = DMA_RX_FRAME_infos->FS_Rx_Desc;
+   for ( uint32_t i = 0; i < DMA_RX_FRAME_infos->Seg_Count; i++ ) {
+      int n = len - off;
+      int bufSize = desc->ControlBufferSize & ETH_DMARxDesc_RBS1;
+      if ( n > bufSize ) {
+         n = bufSize;
+      }
+      memcpy( out + off, (uint8_t *)(uintptr_t)desc->Buffer1Addr, n );
+      off += n;
+      desc->Status = ETH_DMARxDesc_OWN;
+      desc = (ETH_DMADESCTypeDef *)(uintptr_t)desc->Buffer2NextDescAddr;
+   }
+   DMA_RX_FRAME_infos->Seg_Count = 0;
+   return( len );
+}
+
+/******************************************************************************/
+bool EthHost_send( const uint8_t *frame, uint16_t len )
+{
+   if ( DMATxDescToSet->Status & ETH_DMATxDesc_OWN ) {
+      return( false );
+   }
+   memcpy( (uint8_t *)(uintptr_t)DMATxDescToSet->Buffer1Addr, frame, len );
+   return( ETH_SUCCESS == ETH_Prepare_Transmit_Descriptors( len ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,78 @@
+/**
+ * @file   eth_host.h
+ * @brief  Glue for running the ST Ethernet driver on the simulated MAC
+ * without lwIP.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Build stm32f4x7_eth.c and eth_sim.c with -DETH_SIM and link with -no-pie
+ * so the descriptor tables land below 4GB (see eth_sim.h).  eth_host.c has
+ * the RCC calls the vendor driver makes and does what low_level_init() and
+ * low_level_receive() of eth_driver.c do, minus the pbufs.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ETH_HOST_H_
+#define ETH_HOST_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "stm32f4x7_eth.h"
+#include "netif/eth_sim.h"
+
+/* Exported defines ----------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+
+/* Descriptor tables and buffers of stm32f4x7_eth.c */
+extern ETH_DMADESCTypeDef DMARxDscrTab[ETH_RXBUFNB];
+extern ETH_DMADESCTypeDef DMATxDscrTab[ETH_TXBUFNB];
+extern uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE];
+extern uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE];
+extern ETH_DMADESCTypeDef *DMATxDescToSet;
+extern ETH_DMA_Rx_Frame_infos *DMA_RX_FRAME_infos;
+
+/**< MAC address the board gets */
+extern const uint8_t EthHost_mac[6];
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Reset the simulated MAC and bring the rings up like
+ * low_level_init() does, with the RX interrupt on.
+ * @param [in] irqFn: ETH_SIM_IrqFn for the interrupt.
+ * @param [in] txFn: ETH_SIM_TxFn for sent frames.
+ * @param [in] *txArg: void pointer passed to txFn.
+ * @return: None
+ */
+void EthHost_setup( ETH_SIM_IrqFn irqFn, ETH_SIM_TxFn txFn, void *txArg );
+
+/**
+ * @brief   Take the next frame out of the RX ring and give its descriptors
+ * back to the DMA.
+ * @param [out] *out: uint8_t pointer to at least ETH_MAX_PACKET_SIZE bytes.
+ * @return: int length of the frame or -1 if the ring is empty.
+ */
+int EthHost_receive( uint8_t *out );
+
+/**
+ * @brief   Send a frame through the TX ring like low_level_transmit() does.
+ * @param [in] *frame: const uint8_t pointer to the frame, without the FCS.
+ * @param [in] len: uint16_t length of the frame.
+ * @return: bool true if the driver took it.
+ */
+bool EthHost_send( const uint8_t *frame, uint16_t len );
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                          /* ETH_HOST_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
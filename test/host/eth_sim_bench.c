@@ -0,0 +1,136 @@
+/**
+ * @file   eth_sim_bench.c
+ * @brief  Host benchmark of the ST Ethernet driver's RX and TX paths on the
+ * simulated MAC.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Prints frames/sec for 64, 512 and 1514 byte frames going each way:
+ * - RX: ETH_SIM_rxFrame() fills the ring and raises the interrupt, then the
+ *   frame is copied out of the descriptors the way low_level_receive() does.
+ * - TX: the frame is copied into the ring and handed over with a poll demand
+ *   the way low_level_transmit() does, and the MAC checksums and sends it.
+ *
+ * The numbers measure the driver and the descriptor handling on the host, not
+ * the board, so compare them against each other and against earlier runs.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "eth_host.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_FRAMES            200000                 /**< Frames per size */
+
+/* Private variables and Local objects ---------------------------------------*/
+static const uint16_t l_sizes[] = { 64, 512, 1514 };
+static uint32_t l_nTx;
+static uint32_t l_txBytes;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void irq( void )
+{
+   ETH_DMAClearITPendingBit( ETH_DMA_IT_NIS | ETH_DMA_IT_R | ETH_DMA_IT_T );
+}
+
+/******************************************************************************/
+static void txFn( const uint8_t *frame, uint16_t len, void *arg )
+{
+   (void)frame; (void)arg;
+   l_nTx++;
+   l_txBytes += len;
+}
+
+/**
+ * @brief   Build a UDP frame to the board so the TX path has checksums to
+ * insert.
+ * @param [out] *fr: uint8_t pointer to the frame.
+ * @param [in] len: uint16_t length of the frame.
+ * @return: None
+ */
+static void mkFrame( uint8_t *fr, uint16_t len )
+{
+   uint16_t ipLen = (uint16_t)( len - 14 );
+   uint16_t udpLen = (uint16_t)( ipLen - 20 );
+   memset( fr, 0, len );
+   memcpy( fr, EthHost_mac, 6 );
+   fr[6]  = 0x02; fr[11] = 0x02;
+   fr[12] = 0x08;                                               /* IPv4 */
+   fr[14] = 0x45;
+   fr[16] = (uint8_t)( ipLen >> 8 ); fr[17] = (uint8_t)ipLen;
+   fr[22] = 64; fr[23] = 17;                                     /* UDP */
+   fr[26] = 192; fr[27] = 168; fr[28] = 1; fr[29] = 20;
+   fr[30] = 192; fr[31] = 168; fr[32] = 1; fr[33] = 10;
+   fr[34] = 0x13; fr[35] = 0x88; fr[36] = 0x13; fr[37] = 0x88;
+   fr[38] = (uint8_t)( udpLen >> 8 ); fr[39] = (uint8_t)udpLen;
+   for ( int i = 42; i < len; i++ ) {
+      fr[i] = (uint8_t)i;
+   }
+}
+
+/******************************************************************************/
+static double fps( uint64_t ns )
+{
+   return( (double)BENCH_FRAMES / ((double)ns / 1e9) );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   static uint8_t fr[ETH_SIM_MAX_FRAME_LEN];
+   static uint8_t out[ETH_MAX_PACKET_SIZE];
+   uint64_t t0;
+
+   printf( "frame | RX frames/s | RX MB/s | TX frames/s | TX MB/s\n" );
+   for ( size_t s = 0; s < sizeof(l_sizes) / sizeof(l_sizes[0]); s++ ) {
+      uint16_t len = l_sizes[s];
+      uint32_t nRx = 0;
+      mkFrame( fr, len );
+
+      EthHost_setup( irq, txFn, NULL );
+      t0 = HT_nowNs();
+      for ( int i = 0; i < BENCH_FRAMES; i++ ) {
+         if ( ERR_NONE == ETH_SIM_rxFrame( fr, len ) &&
+               len == EthHost_receive( out ) ) {
+            nRx++;
+         }
+      }
+      uint64_t rxNs = HT_nowNs() - t0;
+      HT_CHECK_MSG( BENCH_FRAMES == nRx, "%u byte RX got %u", len, nRx );
+      HT_CHECK( 0 == memcmp( out, fr, len ) );
+
+      EthHost_setup( irq, txFn, NULL );
+      l_nTx = 0;
+      l_txBytes = 0;
+      t0 = HT_nowNs();
+      for ( int i = 0; i < BENCH_FRAMES; i++ ) {
+         (void)EthHost_send( fr, len );
+      }
+      uint64_t txNs = HT_nowNs() - t0;
+      HT_CHECK_MSG( BENCH_FRAMES == l_nTx, "%u byte TX sent %u", len, l_nTx );
+      HT_CHECK( (uint32_t)len * BENCH_FRAMES == l_txBytes );
+
+      printf( "%-5u | %11.0f | %7.1f | %11.0f | %7.1f\n", len,
+            fps( rxNs ), fps( rxNs ) * len / 1e6,
+            fps( txNs ), fps( txNs ) * len / 1e6 );
+   }
+
+   return( HT_DONE( "eth_sim_bench" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
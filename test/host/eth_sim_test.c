@@ -0,0 +1,434 @@
+/**
+ * @file   eth_sim_test.c
+ * @brief  Host test of the simulated Ethernet MAC, the pcap reader/writer and
+ * the synthetic TCP client, driven through the ST Ethernet driver.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * - RX: frames land in the ring with the right status, the interrupt follows
+ *   RIE, a full ring drops and sets RBUS, and a frame bigger than a buffer is
+ *   spread over several descriptors.
+ * - TX: the poll demand sends what the driver queued, checksums get inserted,
+ *   and IC raises the TX interrupt.
+ * - pcap: what is written reads back, and a big endian file with nanosecond
+ *   stamps and an oversized record reads right.
+ * - TCP: the client answers ARP, connects, keeps to the window, ACKs and
+ *   delivers in order data only, retransmits, and closes.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "eth_host.h"
+#include "netif/eth_pcap.h"
+#include "netif/eth_sim_tcp.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_TX_CAP              16             /**< Sent frames kept around */
+
+/* Private macros ------------------------------------------------------------*/
+#define G16( p_ )               ( (uint16_t)( ( (p_)[0] << 8 ) | (p_)[1] ) )
+
+/* Private variables and Local objects ---------------------------------------*/
+static int l_nRxEvents;
+static int l_nTxEvents;
+
+static uint8_t  l_txCap[MAX_TX_CAP][ETH_SIM_MAX_FRAME_LEN];
+static uint16_t l_txCapLen[MAX_TX_CAP];
+static int      l_nTx;
+static SimTcp_t *l_pClient;
+
+static char l_got[64];
+static int  l_gotLen;
+
+static const uint8_t l_bIp[4]  = { 192, 168, 1, 10 };
+static const uint8_t l_cMac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static const uint8_t l_cIp[4]  = { 192, 168, 1, 20 };
+
+static char l_path[256];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief   What ETH_EventCallback() does with the interrupt, counted.
+ * @return: None
+ */
+static void irq( void )
+{
+   if ( SET == ETH_GetDMAFlagStatus( ETH_DMA_FLAG_R ) ) {
+      ETH_DMAClearITPendingBit( ETH_DMA_IT_NIS | ETH_DMA_IT_R );
+      l_nRxEvents++;
+      ETH_DMAITConfig( ETH_DMA_IT_R, DISABLE );
+   }
+   if ( SET == ETH_GetDMAFlagStatus( ETH_DMA_FLAG_T ) ) {
+      ETH_DMAClearITPendingBit( ETH_DMA_IT_NIS | ETH_DMA_IT_T );
+      l_nTxEvents++;
+   }
+   if ( ETH->DMASR & ETH_DMASR_RBUS ) {
+      ETH_DMASR_CLEAR( ETH_DMASR_RBUS );
+      ETH->DMARPDR = 0;
+   }
+}
+
+/******************************************************************************/
+static void txFn( const uint8_t *frame, uint16_t len, void *arg )
+{
+   (void)arg;
+   if ( l_nTx < MAX_TX_CAP ) {
+      memcpy( l_txCap[l_nTx], frame, len );
+      l_txCapLen[l_nTx] = len;
+   }
+   l_nTx++;
+   if ( NULL != l_pClient ) {
+      SIM_TCP_onFrame( l_pClient, frame, len );
+   }
+}
+
+/******************************************************************************/
+static void dataFn( const uint8_t *data, uint16_t len, void *arg )
+{
+   (void)arg;
+   memcpy( l_got + l_gotLen, data, len );
+   l_gotLen += len;
+}
+
+/******************************************************************************/
+static void setup( void )
+{
+   EthHost_setup( irq, txFn, NULL );
+   l_nRxEvents = 0;
+   l_nTxEvents = 0;
+   l_nTx       = 0;
+   l_pClient   = NULL;
+}
+
+/**
+ * @brief   Check the IP and TCP checksums of a frame.
+ * @return: bool true if both add up.
+ */
+static bool isTcpCsumOk( const uint8_t *frame )
+{
+   const uint8_t *ip = frame + 14;
+   int hl = ( ip[0] & 0x0F ) * 4;
+   int tl = G16( ip + 2 );
+   uint32_t sum = G16( ip + 12 ) + G16( ip + 14 ) + G16( ip + 16 ) +
+         G16( ip + 18 ) + ip[9] + ( tl - hl );
+   return( 0 == ETH_SIM_inetCsum( ip, hl, 0 ) &&
+         0 == ETH_SIM_inetCsum( ip + hl, tl - hl, sum ) );
+}
+
+/**
+ * @brief   Build a segment the board sends to the client.
+ * @return: uint16_t length of the frame.
+ */
+static uint16_t mkSeg( uint8_t *f, uint32_t seq, uint32_t ack, uint8_t flags,
+      const char *data, uint16_t win )
+{
+   uint16_t dl = ( NULL != data ) ? strlen( data ) : 0;
+   memset( f, 0, 54 );
+   memcpy( f, l_cMac, 6 );
+   memcpy( f + 6, EthHost_mac, 6 );
+   f[12] = 0x08;
+
+   uint8_t *ip = f + 14;
+   ip[0] = 0x45;
+   ip[2] = ( 40 + dl ) >> 8;
+   ip[3] = 40 + dl;
+   ip[8] = 64;
+   ip[9] = 6;
+   memcpy( ip + 12, l_bIp, 4 );
+   memcpy( ip + 16, l_cIp, 4 );
+
+   uint8_t *t = ip + 20;
+   t[1]  = 23;
+   t[2]  = 0xC0;
+   t[3]  = 0x01;
+   t[4]  = seq >> 24; t[5]  = seq >> 16; t[6]  = seq >> 8; t[7]  = seq;
+   t[8]  = ack >> 24; t[9]  = ack >> 16; t[10] = ack >> 8; t[11] = ack;
+   t[12] = 0x50;
+   t[13] = flags;
+   t[14] = win >> 8;
+   t[15] = win;
+   if ( dl > 0 ) {
+      memcpy( t + 20, data, dl );
+   }
+   return( 54 + dl );
+}
+
+/******************************************************************************/
+static void testRx( void )
+{
+   static uint8_t buf[ETH_MAX_PACKET_SIZE], fr[ETH_SIM_MAX_FRAME_LEN + 100];
+
+   setup();
+   for ( int i = 0; i < (int)sizeof(fr); i++ ) {
+      fr[i] = (uint8_t)( i * 7 );
+   }
+   fr[12] = 0x08;
+   fr[13] = 0x00;
+
+   /* The first frame interrupts and the callback turns RIE off */
+   HT_CHECK( ERR_NONE == ETH_SIM_rxFrame( fr, 60 ) );
+   HT_CHECK( 1 == l_nRxEvents );
+   HT_CHECK( 0 == ( ETH->DMAIER & ETH_DMAIER_RIE ) );
+   HT_CHECK( ERR_NONE == ETH_SIM_rxFrame( fr, 1514 ) );
+   HT_CHECK( 1 == l_nRxEvents );
+   HT_CHECK( 60 == EthHost_receive( buf ) && 0 == memcmp( buf, fr, 60 ) );
+   HT_CHECK( 1514 == EthHost_receive( buf ) && 0 == memcmp( buf, fr, 1514 ) );
+   HT_CHECK( -1 == EthHost_receive( buf ) );
+   HT_CHECK( ETH_DMARxDesc_OWN == DMARxDscrTab[0].Status );
+
+   /* Turning RIE back on with RS still set interrupts on the next poll */
+   ETH_DMAITConfig( ETH_DMA_IT_NIS | ETH_DMA_IT_R, ENABLE );
+   ETH_SIM_poll();
+   HT_CHECK( 2 == l_nRxEvents );
+   ETH_DMAITConfig( ETH_DMA_IT_NIS | ETH_DMA_IT_R, ENABLE );
+   ETH_SIM_poll();
+   HT_CHECK( 2 == l_nRxEvents );
+   HT_CHECK( ERR_ETH_SIM_FRAME_TOO_BIG ==
+         ETH_SIM_rxFrame( fr, ETH_SIM_MAX_FRAME_LEN + 1 ) );
+
+   /* Full ring */
+   for ( int i = 0; i < ETH_RXBUFNB; i++ ) {
+      HT_CHECK( ERR_NONE == ETH_SIM_rxFrame( fr, 100 + i ) );
+   }
+   HT_CHECK( ERR_ETH_SIM_NO_RX_DESC == ETH_SIM_rxFrame( fr, 64 ) );
+   HT_CHECK( 1 == ETH_SIM_getStats()->rxNoDesc );
+   HT_CHECK( 0 != ( ETH->DMASR & ETH_DMASR_RBUS ) );  /* AIS off: stays set */
+   for ( int i = 0; i < ETH_RXBUFNB; i++ ) {
+      HT_CHECK( 100 + i == EthHost_receive( buf ) );
+   }
+   ETH_DMAITConfig( ETH_DMA_IT_AIS | ETH_DMA_IT_RBU, ENABLE );
+   ETH_SIM_poll();
+   HT_CHECK( 0 == ( ETH->DMASR & ETH_DMASR_RBUS ) );      /* Callback cleared */
+   HT_CHECK( 1 == ETH_SIM_getStats()->irqStuck );    /* but never clears AIS */
+
+   /* A frame over several 256 byte buffers */
+   setup();
+   for ( int i = 0; i < ETH_RXBUFNB; i++ ) {
+      DMARxDscrTab[i].ControlBufferSize = ETH_DMARxDesc_RCH | 256;
+   }
+   HT_CHECK( ERR_NONE == ETH_SIM_rxFrame( fr, 600 ) );
+   HT_CHECK( ETH_DMARxDesc_FS == DMARxDscrTab[0].Status );
+   HT_CHECK( 0 == DMARxDscrTab[1].Status );
+   HT_CHECK( ( DMARxDscrTab[2].Status & ETH_DMARxDesc_LS ) &&
+         604 == ( ( DMARxDscrTab[2].Status & ETH_DMARxDesc_FL ) >> 16 ) );
+   HT_CHECK( 600 == EthHost_receive( buf ) && 0 == memcmp( buf, fr, 600 ) );
+   HT_CHECK( ERR_ETH_SIM_NO_RX_DESC == ETH_SIM_rxFrame( fr, 1500 ) );
+
+   /* RX DMA not started */
+   ETH_SIM_init( irq, txFn, NULL );
+   HT_CHECK( ERR_ETH_SIM_RX_STOPPED == ETH_SIM_rxFrame( fr, 60 ) );
+}
+
+/******************************************************************************/
+static void testTx( void )
+{
+   static uint8_t fr[ETH_SIM_MAX_FRAME_LEN];
+
+   setup();
+   uint16_t len = mkSeg( fr, 1000, 2000, 0x18, "hello world", 1000 );
+   HT_CHECK( EthHost_send( fr, len ) );
+   HT_CHECK( 1 == l_nTx && len == l_txCapLen[0] );
+   HT_CHECK( isTcpCsumOk( l_txCap[0] ) );
+   HT_CHECK( 0 == ( DMATxDscrTab[0].Status & ETH_DMATxDesc_OWN ) );
+   HT_CHECK( 0 != ( ETH->DMASR & ETH_DMASR_TBUS ) );           /* Suspended */
+   HT_CHECK( SET == ETH_GetDMAFlagStatus( ETH_DMA_FLAG_TBU ) );
+   for ( int k = 0; k < 12; k++ ) {                      /* Wraps the ring */
+      HT_CHECK( EthHost_send( fr, len ) );
+   }
+   HT_CHECK( 13 == l_nTx && 13 == ETH_SIM_getStats()->txFrames );
+
+   /* IC sets TS and raises the TX interrupt */
+   ETH_DMAITConfig( ETH_DMA_IT_T, ENABLE );
+   DMATxDescToSet->Status |= ETH_DMATxDesc_IC;
+   HT_CHECK( EthHost_send( fr, len ) );
+   HT_CHECK( 1 == l_nTxEvents );
+
+   /* A descriptor handed over without a poll demand waits for one */
+   memcpy( (uint8_t *)(uintptr_t)DMATxDescToSet->Buffer1Addr, fr, len );
+   DMATxDescToSet->ControlBufferSize = len;
+   DMATxDescToSet->Status |= ETH_DMATxDesc_OWN | ETH_DMATxDesc_FS | ETH_DMATxDesc_LS;
+   DMATxDescToSet = (ETH_DMADESCTypeDef *)(uintptr_t)DMATxDescToSet->Buffer2NextDescAddr;
+   ETH_SIM_poll();
+   HT_CHECK( 14 == l_nTx );
+   ETH_ResumeDMATransmission();
+   HT_CHECK( 15 == l_nTx );
+
+   /* Held frames stay owned by the DMA until the wire frees up */
+   ETH_SIM_txHold( true );
+   HT_CHECK( EthHost_send( fr, len ) );
+   HT_CHECK( 15 == l_nTx );
+   ETH_SIM_txHold( false );
+   HT_CHECK( 16 == l_nTx );
+}
+
+/******************************************************************************/
+static void testPcap( void )
+{
+   static uint8_t buf[ETH_SIM_MAX_FRAME_LEN];
+   EthPcap_t pc;
+   uint16_t len;
+   uint64_t ts;
+
+   HT_CHECK( ERR_NONE == PCAP_openWrite( &pc, l_path ) );
+   for ( int i = 0; i < 3; i++ ) {
+      HT_CHECK( ERR_NONE == PCAP_write( &pc, l_txCap[i], l_txCapLen[i],
+            1000000ull * i + 17 ) );
+   }
+   PCAP_close( &pc );
+
+   HT_CHECK( ERR_NONE == PCAP_openRead( &pc, l_path ) );
+   for ( int i = 0; i < 3; i++ ) {
+      HT_CHECK( ERR_NONE == PCAP_read( &pc, buf, sizeof(buf), &len, &ts ) );
+      HT_CHECK( len == l_txCapLen[i] && 0 == memcmp( buf, l_txCap[i], len ) &&
+            1000000ull * i + 17 == ts );
+   }
+   HT_CHECK( ERR_ETH_SIM_PCAP_END == PCAP_read( &pc, buf, sizeof(buf), &len, &ts ) );
+   PCAP_close( &pc );
+
+   /* Big endian, nanosecond stamps, and a record too big for the buffer */
+   static const uint8_t hdr[24] = {
+         0xA1, 0xB2, 0x3C, 0x4D, 0, 2, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0xFF, 0xFF, 0, 0, 0, 1
+   };
+   static const uint8_t r1[16] = { 0,0,0,2, 0,0,0x03,0xE8, 0,0,0,4,  0,0,0,4 };
+   static const uint8_t r2[16] = { 0,0,0,3, 0,0,0,0,       0,0,0,10, 0,0,0,10 };
+   static const uint8_t r3[16] = { 0,0,0,4, 0,0,0,0,       0,0,0,2,  0,0,0,2 };
+   FILE *f = fopen( l_path, "wb" );
+   HT_CHECK( NULL != f );
+   if ( NULL == f ) {
+      return;
+   }
+   fwrite( hdr, 1, sizeof(hdr), f );
+   fwrite( r1, 1, sizeof(r1), f );
+   fwrite( "abcd", 1, 4, f );
+   fwrite( r2, 1, sizeof(r2), f );
+   fwrite( "0123456789", 1, 10, f );
+   fwrite( r3, 1, sizeof(r3), f );
+   fwrite( "zz", 1, 2, f );
+   fclose( f );
+
+   HT_CHECK( ERR_NONE == PCAP_openRead( &pc, l_path ) );
+   HT_CHECK( pc.bSwapped && pc.bNanoSec );
+   HT_CHECK( ERR_NONE == PCAP_read( &pc, buf, 8, &len, &ts ) && 4 == len &&
+         2000001 == ts && 0 == memcmp( buf, "abcd", 4 ) );
+   HT_CHECK( ERR_ETH_SIM_FRAME_TOO_BIG == PCAP_read( &pc, buf, 8, &len, &ts ) );
+   HT_CHECK( ERR_NONE == PCAP_read( &pc, buf, 8, &len, &ts ) && 2 == len &&
+         4000000 == ts );
+   PCAP_close( &pc );
+
+   f = fopen( l_path, "wb" );
+   fwrite( "not a pcap file at all", 1, 22, f );
+   fclose( f );
+   HT_CHECK( ERR_ETH_SIM_PCAP_BAD_FORMAT == PCAP_openRead( &pc, l_path ) );
+   HT_CHECK( ERR_ETH_SIM_PCAP_OPEN_FAILED == PCAP_openRead( &pc, "/nonexistent/x" ) );
+   remove( l_path );
+}
+
+/******************************************************************************/
+static void testTcp( void )
+{
+   static uint8_t buf[ETH_MAX_PACKET_SIZE], fr[ETH_SIM_MAX_FRAME_LEN];
+   static uint8_t big[4000];
+   SimTcp_t c;
+   uint16_t len;
+
+   setup();
+   l_pClient = &c;
+   l_gotLen  = 0;
+   for ( int i = 0; i < (int)sizeof(big); i++ ) {
+      big[i] = 'a' + i % 26;
+   }
+
+   /* SYN with the MSS option */
+   SIM_TCP_ctor( &c, l_cMac, l_cIp, 0xC001, EthHost_mac, l_bIp, 23, dataFn, NULL );
+   HT_CHECK( ERR_NONE == SIM_TCP_connect( &c ) );
+   HT_CHECK( 58 == EthHost_receive( buf ) && 0x02 == buf[14 + 20 + 13] &&
+         isTcpCsumOk( buf ) );
+
+   /* The board asks who the client is */
+   static const uint8_t arp[42] = {
+         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 2, 0, 0, 0, 0, 1, 8, 6,
+         0, 1, 8, 0, 6, 4, 0, 1, 2, 0, 0, 0, 0, 1, 192, 168, 1, 10,
+         0, 0, 0, 0, 0, 0, 192, 168, 1, 20
+   };
+   SIM_TCP_onFrame( &c, arp, sizeof(arp) );
+   HT_CHECK( 42 == EthHost_receive( buf ) && 2 == buf[21] &&
+         0 == memcmp( buf, EthHost_mac, 6 ) && 0 == memcmp( buf + 22, l_cMac, 6 ) &&
+         0 == memcmp( buf + 32, EthHost_mac, 6 ) );
+
+   /* SYN-ACK from the board goes out through the MAC */
+   len = mkSeg( fr, 5000, 0x00010001, 0x12, NULL, 2920 );
+   HT_CHECK( EthHost_send( fr, len ) );
+   HT_CHECK( SIM_TCP_ESTABLISHED == c.state );
+   HT_CHECK( 54 == EthHost_receive( buf ) && 0x10 == buf[47] && isTcpCsumOk( buf ) );
+
+   /* Two full segments fill the 2920 byte window */
+   HT_CHECK( ERR_NONE == SIM_TCP_write( &c, big, sizeof(big) ) );
+   HT_CHECK( 54 + 1460 == EthHost_receive( buf ) &&
+         0 == memcmp( buf + 54, big, 1460 ) && isTcpCsumOk( buf ) );
+   HT_CHECK( 54 + 1460 == EthHost_receive( buf ) &&
+         0 == memcmp( buf + 54, big + 1460, 1460 ) );
+   HT_CHECK( -1 == EthHost_receive( buf ) );
+   HT_CHECK( ERR_ETH_SIM_TCP_NOT_READY == SIM_TCP_write( &c, big, 1 ) );
+
+   /* The board ACKs 1460 and sends "hi" */
+   len = mkSeg( fr, 5001, 0x00010001 + 1460, 0x18, "hi", 2920 );
+   SIM_TCP_onFrame( &c, fr, len );
+   HT_CHECK( 2 == l_gotLen && 0 == memcmp( l_got, "hi", 2 ) );
+   HT_CHECK( 54 == EthHost_receive( buf ) );                   /* ACK of hi */
+   HT_CHECK( 54 + 1080 == EthHost_receive( buf ) &&
+         0 == memcmp( buf + 54, big + 2920, 1080 ) );
+
+   /* Out of order data gets a duplicate ACK and isn't delivered */
+   len = mkSeg( fr, 5100, 0x00010001 + 1460, 0x18, "xx", 2920 );
+   SIM_TCP_onFrame( &c, fr, len );
+   HT_CHECK( 2 == l_gotLen );
+   HT_CHECK( 54 == EthHost_receive( buf ) && 0 == G16( buf + 42 ) &&
+         5003 == G16( buf + 44 ) );
+
+   /* Lost: everything not ACKed goes again */
+   SIM_TCP_retransmit( &c );
+   HT_CHECK( 54 + 1460 == EthHost_receive( buf ) &&
+         0 == memcmp( buf + 54, big + 1460, 1460 ) );
+   HT_CHECK( 54 + 1080 == EthHost_receive( buf ) );
+   len = mkSeg( fr, 5003, 0x00010001 + 4000, 0x10, NULL, 2920 );
+   SIM_TCP_onFrame( &c, fr, len );
+   HT_CHECK( SIM_TCP_isIdle( &c ) );
+
+   SIM_TCP_close( &c );
+   HT_CHECK( 54 == EthHost_receive( buf ) && 0x11 == buf[47] );
+   HT_CHECK( SIM_TCP_FIN_WAIT == c.state );
+   len = mkSeg( fr, 5003, 0x00010001 + 4001, 0x11, NULL, 2920 );
+   SIM_TCP_onFrame( &c, fr, len );
+   HT_CHECK( SIM_TCP_CLOSED == c.state );
+   HT_CHECK( 2 == c.rxBytes );
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+   (void)argc;
+   snprintf( l_path, sizeof(l_path), "%s.pcap", argv[0] );
+
+   testRx();
+   testTx();
+   testPcap();
+   testTcp();
+   return( HT_DONE( "eth_sim_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,534 @@
+/**
+ * @file   evt_replay_test.c
+ * @brief  Host test of recording AOs with evt_rec.c and replaying them with
+ * evt_replay.c.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Two AOs on the POSIX port of QP, built with QF_EVT_REC and EVT_REC_HOST,
+ * run on this thread: Ping turns every tick into a pool event for Pong, Pong
+ * acks every one of them with a static event, and every fifth ack makes Ping
+ * post itself a LIFO event.  Pong posts Ping a pool event from its initial
+ * transition, and commands carrying a payload come in from outside the AOs
+ * along with the ticks.
+ *
+ * - Record: the AOs are started and run to completion, highest priority
+ *   first, with every RTC step bracketed the way the FreeRTOS port does it,
+ *   and the ring is saved to a file.
+ * - Replay: fresh AOs replay the file.  Every dispatch and post matches, the
+ *   outside posts are made again, the steps hand back the recorded cycles and
+ *   the AOs end up where the recorded ones did.
+ * - Changed AOs: Ping sends different data once and Pong acks too often,
+ *   and the replay finds both.
+ * - Files that aren't a ring don't load.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#define QP_IMPL                              /* For QF_add_() and the pools */
+#include "host_test.h"
+#include "qp_port.h"
+#include "qf_pkg.h"
+#include "evt_rec.h"
+#include "evt_replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define N_TICKS                 200
+#define CMD_EVERY               7                 /**< Ticks between commands */
+#define QUEUE_LEN               16
+#define PING_PRIO               1
+#define PONG_PRIO               2
+#define CHANGED_TICK            40   /**< Tick the changed Ping sends bad data */
+#define HELLO                   0xABCDU
+
+/* Private typedefs ----------------------------------------------------------*/
+enum TestSignals {
+   TICK_SIG = Q_USER_SIG,
+   DATA_SIG,
+   ACK_SIG,
+   CMD_SIG,
+   HELLO_SIG,
+   SELF_SIG,
+};
+
+/**
+ * \struct DataEvt_t
+ * Pool event with a payload.  No pointers, so it digests the same on the
+ * 64 bit host as on the target.
+ */
+typedef struct DataEvts {
+   QEvt     super;
+   uint32_t n;
+   uint8_t  buf[10];
+} DataEvt_t;
+
+/**
+ * \struct Ping_t
+ */
+typedef struct Pings {
+   QActive  super;
+   uint32_t ticks;
+   uint32_t acks;
+   uint32_t self;
+   uint32_t hello;
+} Ping_t;
+
+/**
+ * \struct Pong_t
+ */
+typedef struct Pongs {
+   QActive  super;
+   uint32_t sum;
+   uint32_t cmds;
+} Pong_t;
+
+/**
+ * \struct EndState_t
+ * What the AOs counted, to compare a replay against the recording.
+ */
+typedef struct EndStates {
+   uint32_t ticks;
+   uint32_t acks;
+   uint32_t self;
+   uint32_t hello;
+   uint32_t sum;
+   uint32_t cmds;
+} EndState_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static Ping_t      l_ping;
+static Pong_t      l_pong;
+static QActive    *l_aos[] = { NULL, &l_ping.super, &l_pong.super };
+static QEvt const *l_pingQSto[QUEUE_LEN];
+static QEvt const *l_pongQSto[QUEUE_LEN];
+static DataEvt_t   l_poolSto[64];
+
+static QEvt const  l_tickEvt = { TICK_SIG, 0U, 0U };
+static QEvt const  l_ackEvt  = { ACK_SIG, 0U, 0U };
+static QEvt const  l_selfEvt = { SELF_SIG, 0U, 0U };
+
+static bool        l_isChanged;          /**< Replay into AOs that changed */
+
+static uint32_t    l_nSteps;             /**< Steps handed to onStep() */
+static uint32_t    l_nBadSteps;
+static uint32_t    l_nBadCycles;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* What the POSIX QF port needs from the application */
+void QF_onStartup( void ) {}
+void QF_onCleanup( void ) {}
+void QF_onClockTick( void ) {}
+
+void Q_onAssert( char const * const file, int_t const line )
+{
+   fprintf( stderr, "%s:%d: Q_onAssert\n", file, (int)line );
+   exit( 2 );
+}
+
+static QState Ping_initial( Ping_t *me, QEvt const *e );
+static QState Ping_running( Ping_t *me, QEvt const *e );
+static QState Pong_initial( Pong_t *me, QEvt const *e );
+static QState Pong_running( Pong_t *me, QEvt const *e );
+
+/******************************************************************************/
+static QState Ping_initial( Ping_t *me, QEvt const *e )
+{
+   (void)e;
+   return( Q_TRAN( &Ping_running ) );
+}
+
+/******************************************************************************/
+static QState Ping_running( Ping_t *me, QEvt const *e )
+{
+   switch ( e->sig ) {
+      case TICK_SIG: {
+         DataEvt_t *d = Q_NEW( DataEvt_t, DATA_SIG );
+         me->ticks++;
+         d->n = me->ticks;
+         if ( l_isChanged && CHANGED_TICK == me->ticks ) {
+            d->n++;
+         }
+         memset( d->buf, (int)me->ticks, me->ticks % sizeof(d->buf) );
+         QACTIVE_POST( &l_pong.super, &d->super, me );
+         return( Q_HANDLED() );
+      }
+      case ACK_SIG:
+         if ( 0 == ++me->acks % 5 ) {
+            QACTIVE_POST_LIFO( &me->super, &l_selfEvt );
+         }
+         return( Q_HANDLED() );
+      case SELF_SIG:
+         me->self++;
+         return( Q_HANDLED() );
+      case HELLO_SIG:
+         me->hello = ((DataEvt_t const *)e)->n;
+         return( Q_HANDLED() );
+   }
+   return( Q_SUPER( &QHsm_top ) );
+}
+
+/******************************************************************************/
+static QState Pong_initial( Pong_t *me, QEvt const *e )
+{
+   DataEvt_t *d = Q_NEW( DataEvt_t, HELLO_SIG );
+   (void)e;
+   d->n = HELLO;
+   QACTIVE_POST( &l_ping.super, &d->super, me );
+   return( Q_TRAN( &Pong_running ) );
+}
+
+/******************************************************************************/
+static QState Pong_running( Pong_t *me, QEvt const *e )
+{
+   switch ( e->sig ) {
+      case DATA_SIG:
+         me->sum += ((DataEvt_t const *)e)->n;
+         QACTIVE_POST( &l_ping.super, &l_ackEvt, me );
+         return( Q_HANDLED() );
+      case CMD_SIG:
+         me->cmds += ((DataEvt_t const *)e)->buf[3];
+         if ( l_isChanged && me->cmds > 100 ) {
+            QACTIVE_POST( &l_ping.super, &l_ackEvt, me );
+         }
+         return( Q_HANDLED() );
+   }
+   return( Q_SUPER( &QHsm_top ) );
+}
+
+/**
+ * @brief   Set up QF, the pool and freshly constructed AOs.
+ * @param   None
+ * @return: None
+ */
+static void setup( void )
+{
+   QF_init();
+   QF_maxPool_ = 0;                          /* Forget the pool of a last run */
+   QF_poolInit( l_poolSto, sizeof(l_poolSto), sizeof(l_poolSto[0]) );
+
+   memset( &l_ping, 0, sizeof(l_ping) );
+   memset( &l_pong, 0, sizeof(l_pong) );
+   QActive_ctor( &l_ping.super, Q_STATE_CAST( &Ping_initial ) );
+   QActive_ctor( &l_pong.super, Q_STATE_CAST( &Pong_initial ) );
+}
+
+/**
+ * @brief   Take the AOs out of QF and check nothing is left in the pool.
+ * @param   None
+ * @return: None
+ */
+static void teardown( void )
+{
+   QF_remove_( &l_ping.super );
+   QF_remove_( &l_pong.super );
+   HT_CHECK( QF_pool_[0].nFree == QF_pool_[0].nTot );
+}
+
+/**
+ * @brief   Add an AO to QF without a thread, as the replay does.
+ * @param [in|out] *me: QActive pointer to the AO.
+ * @param [in] prio: uint8_t priority.
+ * @param [in] *qSto[]: QEvt pointer array for its queue.
+ * @return: None
+ */
+static void add( QActive *me, uint8_t prio, QEvt const *qSto[] )
+{
+   QEQueue_init( &me->eQueue, qSto, QUEUE_LEN );
+   pthread_cond_init( &me->osObject, 0 );
+   me->prio = prio;
+   QF_add_( me );
+}
+
+/**
+ * @brief   Run the initial transition of an AO the way QActive_start_() of
+ * the FreeRTOS port does.
+ * @param [in|out] *me: QActive pointer to the AO.
+ * @return: None
+ */
+static void start( QActive *me )
+{
+   QF_onEvtDispatch( me, (QEvt const *)0 );
+   QMSM_INIT( &me->super, (QEvt const *)0 );
+   QF_onEvtDone( me, (QEvt const *)0, 0 );
+}
+
+/**
+ * @brief   Run the AOs until their queues are empty, highest priority first,
+ * the way the thread of the FreeRTOS port runs an RTC step.
+ *
+ * The cycles each step reports are made up from its signal so the replay can
+ * be checked for handing them back.
+ *
+ * @param   None
+ * @return: None
+ */
+static void runToCompletion( void )
+{
+   for ( ;; ) {
+      uint8_t p = PONG_PRIO;
+      while ( 0 != p && (QEvt const *)0 == l_aos[p]->eQueue.frontEvt ) {
+         p--;
+      }
+      if ( 0 == p ) {
+         return;
+      }
+
+      QEvt const *e = QActive_get_( l_aos[p] );
+      QF_onEvtDispatch( l_aos[p], e );
+      QMSM_DISPATCH( &l_aos[p]->super, e );
+      QF_onEvtDone( l_aos[p], e, 100U * e->sig + p );
+      QF_gc( e );
+   }
+}
+
+/******************************************************************************/
+static void endState( EndState_t *s )
+{
+   s->ticks = l_ping.ticks;
+   s->acks  = l_ping.acks;
+   s->self  = l_ping.self;
+   s->hello = l_ping.hello;
+   s->sum   = l_pong.sum;
+   s->cmds  = l_pong.cmds;
+}
+
+/******************************************************************************/
+static void onStep( const EvtReplayStep_t *pStep )
+{
+   l_nSteps++;
+   if ( !pStep->bMatch ) {
+      l_nBadSteps++;
+   }
+   if ( pStep->targetCycles != 100U * pStep->sig + pStep->prio ) {
+      l_nBadCycles++;
+   }
+}
+
+/**
+ * @brief   Record the AOs and save the ring.
+ * @param [in] *path: const char pointer to the file to save it to.
+ * @param [out] *pEnd: EndState_t pointer to where the AOs ended up.
+ * @param [out] *pStats: EvtReplayStats_t pointer to the counts a clean replay
+ * has to come up with.
+ * @return: None
+ */
+static void record( const char *path, EndState_t *pEnd, EvtReplayStats_t *pStats )
+{
+   uint32_t nInjected = 0;
+
+   setup();
+   add( &l_ping.super, PING_PRIO, l_pingQSto );
+   add( &l_pong.super, PONG_PRIO, l_pongQSto );
+   HT_CHECK( EVT_REC_start( EVT_REC_MODE_ONCE, 180000000U ) );
+   HT_CHECK( EVT_REC_isRecording() );
+   start( &l_ping.super );
+   start( &l_pong.super );
+
+   for ( uint32_t t = 1; t <= N_TICKS; t++ ) {
+      QACTIVE_POST( &l_ping.super, &l_tickEvt, (void *)0 );
+      nInjected++;
+      if ( 0 == t % CMD_EVERY ) {
+         DataEvt_t *c = Q_NEW( DataEvt_t, CMD_SIG );
+         c->n = t * 3;
+         c->buf[3] = (uint8_t)t;
+         QACTIVE_POST( &l_pong.super, &c->super, (void *)0 );
+         nInjected++;
+      }
+      runToCompletion();
+   }
+   EVT_REC_stop();
+   HT_CHECK( !EVT_REC_isRecording() );
+
+   endState( pEnd );
+   HT_CHECK( N_TICKS == pEnd->ticks && N_TICKS == pEnd->acks );
+   HT_CHECK( N_TICKS / 5 == pEnd->self && HELLO == pEnd->hello );
+
+   const EvtRecHdr_t *hdr = EVT_REC_getRing();
+   HT_CHECK( NULL != hdr );
+   if ( NULL == hdr ) {
+      return;
+   }
+   HT_CHECK( 0 == hdr->nLost && hdr->head < hdr->nSlots );
+
+   /* What each post, dispatch and step of the recording says */
+   uint32_t first;
+   uint32_t n = EVT_REC_span( hdr, &first );
+   uint32_t nInit = 0;
+   uint32_t nDone = 0;
+   memset( pStats, 0, sizeof(*pStats) );
+   HT_CHECK( 0 == first && hdr->head == n );
+   for ( uint32_t i = 0; i < n; i++ ) {
+      const EvtRec_t *r = &EVT_REC_slot( hdr, i )->rec;
+      switch ( r->kind ) {
+         case EVT_REC_INIT:
+            nInit++;
+            break;
+         case EVT_REC_DISPATCH:
+            pStats->nDispatched++;
+            break;
+         case EVT_REC_DONE:
+            nDone++;
+            HT_CHECK( 100U * r->sig + r->target == r->aux );
+            break;
+         case EVT_REC_POST:
+         case EVT_REC_POST_LIFO:
+            if ( EVT_REC_SENDER_TASK == r->sender ) {
+               HT_CHECK( EVT_REC_POST == r->kind );
+               HT_CHECK( TICK_SIG == r->sig || CMD_SIG == r->sig );
+            } else {
+               pStats->nPostsChecked++;
+               HT_CHECK( ( HELLO_SIG == r->sig || DATA_SIG == r->sig ||
+                     ACK_SIG == r->sig ) == ( EVT_REC_POST == r->kind ) );
+               HT_CHECK( ( PONG_PRIO == r->sender ) ==
+                     ( HELLO_SIG == r->sig || ACK_SIG == r->sig ) );
+            }
+            break;
+         default:
+            HT_CHECK( EVT_REC_DATA == r->kind );
+            break;
+      }
+   }
+   pStats->nInjected = nInjected;
+   HT_CHECK( 2 == nInit );
+   HT_CHECK( pStats->nDispatched == nDone );
+   HT_CHECK_MSG( nInjected + pStats->nPostsChecked == pStats->nDispatched,
+         "%u posts, %u dispatches", nInjected + pStats->nPostsChecked,
+         pStats->nDispatched );
+
+   FILE *f = fopen( path, "wb" );
+   HT_CHECK( NULL != f );
+   if ( NULL != f ) {
+      HT_CHECK( 1 == fwrite( hdr, sizeof(*hdr) +
+            (size_t)hdr->nSlots * sizeof(EvtRecSlot_t), 1, f ) );
+      fclose( f );
+   }
+   teardown();
+}
+
+/**
+ * @brief   Replay the saved ring into fresh AOs.
+ * @param [in] *path: const char pointer to the file.
+ * @param [out] *pEnd: EndState_t pointer to where the AOs ended up.
+ * @param [out] *pStats: EvtReplayStats_t pointer to how it went.
+ * @return: bool true if it ran.
+ */
+static bool replay( const char *path, EndState_t *pEnd, EvtReplayStats_t *pStats )
+{
+   setup();
+   EVT_REPLAY_init();
+   EVT_REPLAY_addAO( &l_ping.super, PING_PRIO, l_pingQSto, QUEUE_LEN, NULL );
+   EVT_REPLAY_addAO( &l_pong.super, PONG_PRIO, l_pongQSto, QUEUE_LEN, NULL );
+
+   const EvtRecHdr_t *hdr = EVT_REPLAY_load( path );
+   HT_CHECK( NULL != hdr );
+   if ( NULL == hdr ) {
+      return( false );
+   }
+
+   l_nSteps = 0;
+   l_nBadSteps = 0;
+   l_nBadCycles = 0;
+   bool bRan = EVT_REPLAY_run( hdr, onStep, pStats );
+   free( (void *)hdr );
+
+   endState( pEnd );
+   teardown();
+   return( bRan );
+}
+
+/******************************************************************************/
+static void test_roundTrip( const char *path )
+{
+   EndState_t rec;
+   EndState_t rep;
+   EvtReplayStats_t want;
+   EvtReplayStats_t st;
+
+   record( path, &rec, &want );
+
+   HT_CHECK( replay( path, &rep, &st ) );
+   HT_CHECK_MSG( st.nDispatched == want.nDispatched, "dispatched %u of %u",
+         st.nDispatched, want.nDispatched );
+   HT_CHECK_MSG( st.nInjected == want.nInjected, "injected %u of %u",
+         st.nInjected, want.nInjected );
+   HT_CHECK_MSG( st.nPostsChecked == want.nPostsChecked, "checked %u of %u",
+         st.nPostsChecked, want.nPostsChecked );
+   HT_CHECK( 0 == st.nPostMismatches && 0 == st.nDispatchMismatches );
+   HT_CHECK( 0 == st.nUnexpected && 0 == st.nMissing );
+   HT_CHECK( st.nDispatched == l_nSteps );
+   HT_CHECK( 0 == l_nBadSteps && 0 == l_nBadCycles );
+   HT_CHECK( 0 == memcmp( &rec, &rep, sizeof(rec) ) );
+
+   /* Same recording into AOs that changed */
+   l_isChanged = true;
+   HT_CHECK( replay( path, &rep, &st ) );
+   l_isChanged = false;
+   HT_CHECK_MSG( 1 == st.nDispatchMismatches && 1 == l_nBadSteps,
+         "%u dispatch mismatches", st.nDispatchMismatches );
+   HT_CHECK_MSG( 0 != st.nUnexpected + st.nPostMismatches,
+         "%u unexpected, %u mismatched posts", st.nUnexpected,
+         st.nPostMismatches );
+   HT_CHECK( rec.sum + 1 == rep.sum );
+}
+
+/******************************************************************************/
+static void test_badFiles( const char *path )
+{
+   static const uint8_t junk[64] = { 1, 2, 3 };
+
+   HT_CHECK( NULL == EVT_REPLAY_load( "/nonexistent/evt_rec.bin" ) );
+
+   FILE *f = fopen( path, "wb" );
+   HT_CHECK( NULL != f );
+   if ( NULL != f ) {
+      fwrite( junk, sizeof(junk), 1, f );
+      fclose( f );
+      HT_CHECK( NULL == EVT_REPLAY_load( path ) );
+   }
+
+   /* A real header without the slots it says follow */
+   EVT_REC_start( EVT_REC_MODE_ONCE, 180000000U );
+   EVT_REC_stop();
+   f = fopen( path, "wb" );
+   HT_CHECK( NULL != f );
+   if ( NULL != f ) {
+      fwrite( EVT_REC_getRing(), sizeof(EvtRecHdr_t) + sizeof(EvtRecSlot_t), 1, f );
+      fclose( f );
+      HT_CHECK( NULL == EVT_REPLAY_load( path ) );
+   }
+}
+
+/******************************************************************************/
+int main( void )
+{
+   char path[] = "/tmp/evt_replay_testXXXXXX";
+   int fd = mkstemp( path );
+   if ( fd < 0 ) {
+      perror( "mkstemp" );
+      return( 1 );
+   }
+   close( fd );
+
+   test_roundTrip( path );
+   test_badFiles( path );
+
+   remove( path );
+   return( HT_DONE( "evt_replay_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
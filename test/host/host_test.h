@@ -0,0 +1,112 @@
+/**
+ * @file   host_test.h
+ * @brief  Checks and timing shared by the host tests and benchmarks.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Every test program includes this once.  HT_CHECK() counts and reports a
+ * failed check without stopping, so one run shows everything that broke, and
+ * HT_DONE() turns the count into the exit code make looks at.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Exported defines ----------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+
+/**< Check a condition, report it with its location if it fails */
+#define HT_CHECK( cond_ ) do {                                                \
+   ht_nChecks++;                                                              \
+   if ( !(cond_) ) {                                                          \
+      ht_nFailed++;                                                           \
+      fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,      \
+            #cond_ );                                                         \
+   }                                                                          \
+} while (0)
+
+/**< Same as HT_CHECK() but also prints a formatted explanation */
+#define HT_CHECK_MSG( cond_, ... ) do {                                       \
+   ht_nChecks++;                                                              \
+   if ( !(cond_) ) {                                                          \
+      ht_nFailed++;                                                           \
+      fprintf( stderr, "%s:%d: check failed: %s: ", __FILE__, __LINE__,      \
+            #cond_ );                                                         \
+      fprintf( stderr, __VA_ARGS__ );                                         \
+      fputc( '\n', stderr );                                                  \
+   }                                                                          \
+} while (0)
+
+/**< Print the totals and give main() its return value */
+#define HT_DONE( name_ )                                                      \
+   ( printf( "%-16s %6u checks, %u failed\n", (name_), ht_nChecks,           \
+         ht_nFailed ), ( 0 == ht_nFailed ) ? 0 : 1 )
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+static unsigned ht_nChecks;
+static unsigned ht_nFailed;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Monotonic time for the benchmarks.
+ * @param   None
+ * @return: uint64_t nanoseconds since some fixed point.
+ */
+static inline uint64_t HT_nowNs( void )
+{
+   struct timespec ts;
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return( (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec );
+}
+
+/**
+ * @brief   Cycle counter of the host, where it has one.
+ * @param   None
+ * @return: uint64_t cycles, or nanoseconds on hosts without a cycle counter.
+ */
+static inline uint64_t HT_cycles( void )
+{
+#if defined(__x86_64__) || defined(__i386__)
+   return( __builtin_ia32_rdtsc() );
+#else
+   return( HT_nowNs() );
+#endif
+}
+
+/**
+ * @brief   Small deterministic pseudo random generator so every run of a test
+ * sees the same data.
+ * @param [in,out] *state: uint32_t pointer to the state.  Any non zero seed.
+ * @return: uint32_t next value.
+ */
+static inline uint32_t HT_rand( uint32_t *state )
+{
+   uint32_t x = *state;
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   *state = x;
+   return( x );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                         /* HOST_TEST_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,513 @@
+/**
+ * @file   i2c_dev_test.c
+ * @brief  Host test of the routing of I2C device requests to the bus they're
+ * on.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Runs the real i2c_dev.c with two buses (stub/i2c_dev/i2c_defs.h) and the
+ * device registry laid out over both of them.  Each AO_I2CDevMgr[] instance
+ * is a stand-in that queues what's posted to it, keeps its own counters, and
+ * serves reads and writes out of the memory of the devices on its own bus
+ * when a FreeRTOS thread waits in vTaskDelay().  A request that went to the
+ * wrong bus ends up in the wrong queue, the wrong counters and the wrong
+ * memory.  Also checks what I2C_checkDevAccess() turns away (nothing gets
+ * posted for those) and the blocking calls.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "i2c_dev.h"
+#include "i2c.h"
+#include "I2CDevMgr.h"
+#include "cplr.h"
+#include "task.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define BUS_Q_LEN               32
+#define POOL_EVTS               32
+#define N_ROUTED                20000
+#define LONG_LEN                40   /**< Past what fits in the events */
+
+/* Private typedefs ----------------------------------------------------------*/
+/**< Counters of one bus */
+typedef struct {
+   uint32_t nPosts;
+   uint32_t nReads;
+   uint32_t nWrites;
+   uint32_t nBytesRead;
+   uint32_t nBytesWritten;
+} BusStats_t;
+
+/**< The I2CDevMgr AO of one bus and the devices on that bus */
+typedef struct {
+   QActive      ao;
+   QEvt const  *q[BUS_Q_LEN];
+   int          nQueued;
+   BusStats_t   stats;
+   uint8_t      mem[256][256];           /**< [device address][memory address] */
+} Bus_t;
+
+/**< Last call made to the blocking bus driver */
+typedef struct {
+   I2C_Bus_t iBus;
+   uint8_t   devAddr;
+   uint16_t  memAddr;
+   uint16_t  bytes;
+   bool      isWrite;
+} BlkCall_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0x12CDE7u;
+
+/**< The registry, with the EEPROM on the second bus */
+static I2C_DevSettings_t const l_devs[MAX_I2C_DEV] = {
+   { EEPROM,  I2CBus2, 1, 0xA0, 1, 0x00, 0x00, 0xFF, EEPROM_PAGE_SIZE,     false },
+   { SN_ROM,  I2CBus1, 1, 0xB0, 1, 0x80, 0x80, 0x8F, EEPROM_PAGE_SIZE,     true  },
+   { EUI_ROM, I2CBus1, 1, 0xB0, 1, 0x98, 0x98, 0x9F, EEPROM_PAGE_SIZE / 2, false },
+};
+
+static bool mgrPost( QActive * const me, QEvt const * const e,
+      uint_fast16_t const margin );
+static void mgrPostLIFO( QActive * const me, QEvt const * const e );
+static QActiveVtbl const l_mgrVtbl = { { 0, 0 }, 0, &mgrPost, &mgrPostLIFO };
+
+static Bus_t l_bus[MAX_I2C_BUS];
+QActive * const AO_I2CDevMgr[MAX_I2C_BUS] = {
+   &l_bus[I2CBus1].ao,
+   &l_bus[I2CBus2].ao,
+};
+static QActive l_requester;                /**< AO that makes the requests */
+
+QEQueue CPLR_evtQueue;
+static QEvt const *l_cplrQSto[8];
+
+static union {
+   I2CReadReqEvt   rdReq;
+   I2CWriteReqEvt  wrReq;
+   I2CReadDoneEvt  rdDone;
+   I2CWriteDoneEvt wrDone;
+   I2CCancelEvt    cancel;
+} l_poolSto[POOL_EVTS];
+
+static BlkCall_t l_blk;
+static uint32_t  l_nDelays;
+
+/* Declared by the registry owner only */
+extern I2C_DevSettings_t s_I2C_Dev[MAX_I2C_DEV];
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+void Q_onAssert( char_t const * const module, int_t location )
+{
+   fprintf( stderr, "assert %s:%d\n", module, (int)location );
+   exit( 1 );
+}
+
+/******************************************************************************/
+void assert_failed( uint8_t* file, uint32_t line )
+{
+   /* Same as the board, which stops in Q_onAssert() */
+   Q_onAssert( (char_t const *)file, (int_t)line );
+}
+
+/******************************************************************************/
+void * MEM_DataCopy( void * destination, const void * source, uint16_t num )
+{
+   return( memcpy( destination, source, num ) );
+}
+
+/******************************************************************************/
+char* I2C_busToStr( I2C_Bus_t iBus )
+{
+   /* Same check as i2c.c */
+   assert_param( IS_I2C_BUS( iBus ) );
+   return( ( I2CBus1 == iBus ) ? "I2CBus1" : "I2CBus2" );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_readBufferBLK( I2C_Bus_t iBus, uint8_t i2cDevAddr,
+      uint16_t i2cMemAddr, uint8_t i2cMemAddrSize, uint8_t* pBuffer,
+      uint16_t bytesToRead )
+{
+   l_blk = (BlkCall_t){ iBus, i2cDevAddr, i2cMemAddr, bytesToRead, false };
+   memcpy( pBuffer, &l_bus[iBus].mem[i2cDevAddr][i2cMemAddr], bytesToRead );
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+CBErrorCode I2C_writeBufferBLK( I2C_Bus_t iBus, uint8_t i2cDevAddr,
+      uint16_t i2cMemAddr, uint8_t i2cMemAddrSize, uint8_t* pBuffer,
+      uint16_t bytesToWrite, uint16_t pageSize )
+{
+   l_blk = (BlkCall_t){ iBus, i2cDevAddr, i2cMemAddr, bytesToWrite, true };
+   memcpy( &l_bus[iBus].mem[i2cDevAddr][i2cMemAddr], pBuffer, bytesToWrite );
+   return( ERR_NONE );
+}
+
+/******************************************************************************/
+static bool mgrPost( QActive * const me, QEvt const * const e,
+      uint_fast16_t const margin )
+{
+   (void)margin;
+   Bus_t *bus = (Bus_t *)me;
+
+   HT_CHECK( bus->nQueued < BUS_Q_LEN );
+   bus->q[bus->nQueued++] = e;
+   bus->stats.nPosts++;
+   if ( I2C_DEV_RAW_MEM_READ_SIG == e->sig ) {
+      bus->stats.nReads++;
+      bus->stats.nBytesRead += ((I2CReadReqEvt const *)e)->bytes;
+   } else if ( I2C_DEV_RAW_MEM_WRITE_SIG == e->sig ) {
+      bus->stats.nWrites++;
+      bus->stats.nBytesWritten += ((I2CWriteReqEvt const *)e)->bytes;
+   } else {
+      HT_CHECK_MSG( false, "sig %d posted", e->sig );
+   }
+   return( true );
+}
+
+/******************************************************************************/
+static void mgrPostLIFO( QActive * const me, QEvt const * const e )
+{
+   /* Only cancels come this way and nothing here times out */
+   HT_CHECK_MSG( false, "sig %d posted LIFO", e->sig );
+   QF_gc( e );
+}
+
+/******************************************************************************/
+static void busDrop( Bus_t *bus )
+{
+   for ( int i = 0; i < bus->nQueued; i++ ) {
+      QF_gc( bus->q[i] );
+   }
+   bus->nQueued = 0;
+}
+
+/**
+ * @brief   Serve what's queued on one bus out of the memory of its devices.
+ *
+ * Requests from FreeRTOS threads are answered at the front of CPLR_evtQueue
+ * the way the real I2CDevMgr AO does.  The rest are just dropped.
+ *
+ * @param [in] *bus: Bus_t pointer to the bus.
+ * @return: None
+ */
+static void busServe( Bus_t *bus )
+{
+   for ( int i = 0; i < bus->nQueued; i++ ) {
+      QEvt const *e = bus->q[i];
+
+      if ( I2C_DEV_RAW_MEM_READ_SIG == e->sig ) {
+         I2CReadReqEvt const *req = (I2CReadReqEvt const *)e;
+         uint8_t *src = &bus->mem[I2C_getDevAddr( req->i2cDev )][req->addr];
+         if ( ACCESS_FREERTOS == req->accessType ) {
+            I2CReadDoneEvt *done = Q_NEW( I2CReadDoneEvt, I2C_DEV_READ_DONE_SIG );
+            done->bytes  = req->bytes;
+            done->status = ERR_NONE;
+            done->i2cDev = req->i2cDev;
+            done->tag    = req->tag;
+            done->pBuf   = req->pBuf;
+            memcpy( ( NULL != req->pBuf ) ? req->pBuf : done->dataBuf, src,
+                  req->bytes );
+            QEQueue_postLIFO( &CPLR_evtQueue, (QEvt *)done );
+         }
+      } else {
+         I2CWriteReqEvt const *req = (I2CWriteReqEvt const *)e;
+         memcpy( &bus->mem[I2C_getDevAddr( req->i2cDev )][req->addr],
+               ( NULL != req->pBuf ) ? req->pBuf : req->dataBuf, req->bytes );
+         if ( ACCESS_FREERTOS == req->accessType ) {
+            I2CWriteDoneEvt *done = Q_NEW( I2CWriteDoneEvt, I2C_DEV_WRITE_DONE_SIG );
+            done->bytes  = req->bytes;
+            done->status = ERR_NONE;
+            done->i2cDev = req->i2cDev;
+            done->tag    = req->tag;
+            QEQueue_postLIFO( &CPLR_evtQueue, (QEvt *)done );
+         }
+      }
+   }
+   busDrop( bus );
+}
+
+/******************************************************************************/
+void vTaskDelay( const TickType_t xTicksToDelay )
+{
+   /* Every I2CDevMgr AO gets to run while the thread waits */
+   l_nDelays++;
+   for ( int b = 0; b < MAX_I2C_BUS; b++ ) {
+      busServe( &l_bus[b] );
+   }
+}
+
+/******************************************************************************/
+static uint32_t nPostsAll( void )
+{
+   uint32_t n = 0;
+   for ( int b = 0; b < MAX_I2C_BUS; b++ ) {
+      n += l_bus[b].stats.nPosts;
+   }
+   return( n );
+}
+
+/******************************************************************************/
+static void resetBuses( void )
+{
+   for ( int b = 0; b < MAX_I2C_BUS; b++ ) {
+      busDrop( &l_bus[b] );
+      memset( &l_bus[b].stats, 0, sizeof(l_bus[b].stats) );
+   }
+}
+
+/******************************************************************************/
+static void test_registry( void )
+{
+   for ( int d = 0; d < MAX_I2C_DEV; d++ ) {
+      HT_CHECK( l_devs[d].i2c_bus == I2C_getBus( (I2C_Dev_t)d ) );
+      HT_CHECK( l_devs[d].i2c_dev_addr == I2C_getDevAddr( (I2C_Dev_t)d ) );
+      HT_CHECK( l_devs[d].i2c_mem_addr == I2C_getMemAddr( (I2C_Dev_t)d ) );
+      HT_CHECK( l_devs[d].i2c_mem_max_addr == I2C_getMaxMemAddr( (I2C_Dev_t)d ) );
+   }
+}
+
+/**
+ * @brief   Random requests from an AO to every device.  Each one has to land
+ * in the queue of its own bus, as it was asked for, and only there.
+ * @param   None
+ * @return: None
+ */
+static void test_routing( void )
+{
+   BusStats_t exp[MAX_I2C_BUS];
+   uint8_t data[MAX_I2C_WRITE_LEN];
+
+   resetBuses();
+   memset( exp, 0, sizeof(exp) );
+
+   for ( uint32_t i = 0; i < N_ROUTED; i++ ) {
+      I2C_Dev_t dev = (I2C_Dev_t)(HT_rand( &l_seed ) % MAX_I2C_DEV);
+      I2C_DevSettings_t const *cfg = &l_devs[dev];
+      Bus_t *bus = &l_bus[cfg->i2c_bus];
+      Bus_t *other = &l_bus[( I2CBus1 == cfg->i2c_bus ) ? I2CBus2 : I2CBus1];
+      bool isWrite = !cfg->i2c_mem_read_only && ( HT_rand( &l_seed ) & 1 );
+
+      uint16_t room = cfg->i2c_mem_max_addr + 1 - cfg->i2c_mem_addr;
+      uint16_t maxLen = isWrite ? MAX_I2C_WRITE_LEN : MAX_I2C_READ_LEN;
+      uint16_t bytes = 1 + HT_rand( &l_seed ) % ( room < maxLen ? room : maxLen );
+      uint16_t offset = HT_rand( &l_seed ) % ( room - bytes + 1 );
+      uint16_t tag = (uint16_t)i;
+      for ( int k = 0; k < bytes; k++ ) {
+         data[k] = (uint8_t)HT_rand( &l_seed );
+      }
+
+      int nOther = other->nQueued;
+      CBErrorCode status = isWrite ?
+            I2C_writeDevMemEVT( dev, offset, bytes, ACCESS_QPC, &l_requester,
+                  data, tag ) :
+            I2C_readDevMemEVT( dev, offset, bytes, ACCESS_QPC, &l_requester,
+                  NULL, tag );
+      HT_CHECK( ERR_NONE == status );
+      HT_CHECK_MSG( 1 == bus->nQueued && nOther == other->nQueued,
+            "dev %d went to the wrong bus", dev );
+      if ( 1 != bus->nQueued ) {
+         resetBuses();
+         continue;
+      }
+
+      if ( isWrite ) {
+         I2CWriteReqEvt const *req = (I2CWriteReqEvt const *)bus->q[0];
+         HT_CHECK( I2C_DEV_RAW_MEM_WRITE_SIG == req->super.sig );
+         HT_CHECK( dev == req->i2cDev && bytes == req->bytes );
+         HT_CHECK( cfg->i2c_mem_addr + offset == req->addr );
+         HT_CHECK( tag == req->tag && &l_requester == req->requester );
+         HT_CHECK( NULL == req->pBuf && 0 == memcmp( req->dataBuf, data, bytes ) );
+         exp[cfg->i2c_bus].nWrites++;
+         exp[cfg->i2c_bus].nBytesWritten += bytes;
+      } else {
+         I2CReadReqEvt const *req = (I2CReadReqEvt const *)bus->q[0];
+         HT_CHECK( I2C_DEV_RAW_MEM_READ_SIG == req->super.sig );
+         HT_CHECK( dev == req->i2cDev && bytes == req->bytes );
+         HT_CHECK( cfg->i2c_mem_addr + offset == req->addr );
+         HT_CHECK( tag == req->tag && &l_requester == req->requester );
+         HT_CHECK( NULL == req->pBuf && ACCESS_QPC == req->accessType );
+         exp[cfg->i2c_bus].nReads++;
+         exp[cfg->i2c_bus].nBytesRead += bytes;
+      }
+      exp[cfg->i2c_bus].nPosts++;
+      busDrop( bus );
+   }
+
+   /* The counters of each bus only saw its own devices */
+   for ( int b = 0; b < MAX_I2C_BUS; b++ ) {
+      HT_CHECK_MSG( 0 == memcmp( &exp[b], &l_bus[b].stats, sizeof(exp[b]) ),
+            "bus %d: %u/%u reads %u/%u writes", b + 1, l_bus[b].stats.nReads,
+            exp[b].nReads, l_bus[b].stats.nWrites, exp[b].nWrites );
+      HT_CHECK( exp[b].nReads > 0 );
+   }
+   HT_CHECK( exp[I2CBus1].nWrites > 0 && exp[I2CBus2].nWrites > 0 );
+   HT_CHECK( QF_getPoolMin( 1 ) > 0 );
+}
+
+/**
+ * @brief   Requests the registry turns away never get posted anywhere.
+ * @param   None
+ * @return: None
+ */
+static void test_access( void )
+{
+   uint8_t buf[LONG_LEN] = { 0 };
+
+   resetBuses();
+   HT_CHECK( ERR_I2C_DEV_INVALID_DEVICE == I2C_readDevMemEVT( MAX_I2C_DEV, 0, 1,
+         ACCESS_QPC, &l_requester, NULL, 1 ) );
+   HT_CHECK( ERR_I2C_DEV_INVALID_DEVICE == I2C_writeDevMemEVT( MAX_I2C_DEV, 0, 1,
+         ACCESS_QPC, &l_requester, buf, 1 ) );
+   HT_CHECK( ERR_I2C_DEV_IS_READ_ONLY == I2C_writeDevMemEVT( SN_ROM, 0, 1,
+         ACCESS_QPC, &l_requester, buf, 1 ) );
+
+   /* Right up to the end of the memory and one past it, on both buses */
+   HT_CHECK( ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY == I2C_readDevMemEVT( EUI_ROM,
+         1, 8, ACCESS_QPC, &l_requester, NULL, 1 ) );
+   HT_CHECK( ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY == I2C_writeDevMemEVT( EEPROM,
+         0xF0, 17, ACCESS_QPC, &l_requester, buf, 1 ) );
+   HT_CHECK( ERR_I2C_DEV_EEPROM_MEM_ADDR_BOUNDARY == I2C_readDevMemBLK( SN_ROM,
+         15, 2, ACCESS_BARE_METAL, buf, sizeof(buf) ) );
+
+   /* Long reads have to bring their own buffer */
+   HT_CHECK( ERR_MEM_BUFFER_LEN == I2C_readDevMemEVT( EEPROM, 0,
+         MAX_I2C_READ_LEN + 1, ACCESS_QPC, &l_requester, NULL, 1 ) );
+   HT_CHECK( ERR_MEM_BUFFER_LEN == I2C_readDevMemBLK( EEPROM, 0, 8,
+         ACCESS_BARE_METAL, buf, 4 ) );
+
+   /* A device on a bus that doesn't exist */
+   s_I2C_Dev[EUI_ROM].i2c_bus = MAX_I2C_BUS;
+   HT_CHECK( ERR_I2C_DEV_INVALID_DEVICE == I2C_readDevMemEVT( EUI_ROM, 0, 1,
+         ACCESS_QPC, &l_requester, NULL, 1 ) );
+   HT_CHECK( ERR_I2C_DEV_INVALID_DEVICE == I2C_writeDevMemBLK( EUI_ROM, 0, 1,
+         ACCESS_BARE_METAL, buf, sizeof(buf) ) );
+   s_I2C_Dev[EUI_ROM].i2c_bus = l_devs[EUI_ROM].i2c_bus;
+   HT_CHECK( 0 == nPostsAll() );
+
+   HT_CHECK( ERR_NONE == I2C_readDevMemEVT( EUI_ROM, 0, 8, ACCESS_QPC,
+         &l_requester, NULL, 1 ) );
+   HT_CHECK( ERR_NONE == I2C_writeDevMemEVT( EEPROM, 0xF0, 16, ACCESS_QPC,
+         &l_requester, buf, 1 ) );
+   HT_CHECK( ERR_NONE == I2C_readDevMemEVT( EEPROM, 0, LONG_LEN, ACCESS_QPC,
+         &l_requester, buf, 1 ) );
+   HT_CHECK( 1 == l_bus[I2CBus1].nQueued && 2 == l_bus[I2CBus2].nQueued );
+   HT_CHECK( buf == ((I2CReadReqEvt const *)l_bus[I2CBus2].q[1])->pBuf );
+   resetBuses();
+}
+
+/**
+ * @brief   FreeRTOS thread reads and writes, served by the AO of each bus out
+ * of the memory of that bus only.
+ * @param   None
+ * @return: None
+ */
+static void test_frt( void )
+{
+   uint8_t wr[LONG_LEN], rd[LONG_LEN];
+   uint16_t n;
+
+   resetBuses();
+   for ( int k = 0; k < LONG_LEN; k++ ) {
+      wr[k] = (uint8_t)(0x40 + k);
+   }
+
+   /* Short writes go in the event, long ones out of the caller's buffer */
+   HT_CHECK( ERR_NONE == I2C_writeDevMemFRT( EEPROM, 0x10, wr, sizeof(wr), &n,
+         LONG_LEN ) && LONG_LEN == n );
+   HT_CHECK( ERR_NONE == I2C_writeDevMemFRT( EUI_ROM, 0, wr, sizeof(wr), &n,
+         8 ) && 8 == n );
+   HT_CHECK( 0 == memcmp( &l_bus[I2CBus2].mem[0xA0][0x10], wr, LONG_LEN ) );
+   HT_CHECK( 0 == memcmp( &l_bus[I2CBus1].mem[0xB0][0x98], wr, 8 ) );
+
+   /* Nothing landed on the other bus at the same addresses */
+   static uint8_t const zeros[256];
+   HT_CHECK( 0 == memcmp( l_bus[I2CBus1].mem[0xA0], zeros, sizeof(zeros) ) );
+   HT_CHECK( 0 == memcmp( l_bus[I2CBus2].mem[0xB0], zeros, sizeof(zeros) ) );
+
+   /* A late reply to an old request is thrown away on the way */
+   I2CReadDoneEvt *late = Q_NEW( I2CReadDoneEvt, I2C_DEV_READ_DONE_SIG );
+   late->tag    = 0xFFFF;
+   late->bytes  = 0;
+   late->status = ERR_NONE;
+   QEQueue_postLIFO( &CPLR_evtQueue, (QEvt *)late );
+
+   memset( rd, 0, sizeof(rd) );
+   HT_CHECK( ERR_NONE == I2C_readDevMemFRT( EEPROM, 0x14, rd, sizeof(rd), &n,
+         MAX_I2C_READ_LEN ) && MAX_I2C_READ_LEN == n );
+   HT_CHECK( 0 == memcmp( rd, &wr[4], MAX_I2C_READ_LEN ) );
+   memset( rd, 0, sizeof(rd) );
+   HT_CHECK( ERR_NONE == I2C_readDevMemFRT( EEPROM, 0x10, rd, sizeof(rd), &n,
+         LONG_LEN ) && LONG_LEN == n );
+   HT_CHECK( 0 == memcmp( rd, wr, LONG_LEN ) );
+   memset( rd, 0, sizeof(rd) );
+   HT_CHECK( ERR_NONE == I2C_readDevMemFRT( EUI_ROM, 0, rd, sizeof(rd), &n, 8 ) );
+   HT_CHECK( 0 == memcmp( rd, wr, 8 ) );
+   HT_CHECK( NULL == QEQueue_get( &CPLR_evtQueue ) );
+
+   HT_CHECK( 1 == l_bus[I2CBus1].stats.nWrites && 1 == l_bus[I2CBus1].stats.nReads );
+   HT_CHECK( 1 == l_bus[I2CBus2].stats.nWrites && 2 == l_bus[I2CBus2].stats.nReads );
+   HT_CHECK( LONG_LEN + MAX_I2C_READ_LEN == l_bus[I2CBus2].stats.nBytesRead );
+   HT_CHECK( 8 == l_bus[I2CBus1].stats.nBytesWritten );
+   HT_CHECK( l_nDelays > 0 );
+}
+
+/**
+ * @brief   The blocking calls go straight to the driver of the device's bus.
+ * @param   None
+ * @return: None
+ */
+static void test_blk( void )
+{
+   uint8_t buf[16];
+
+   HT_CHECK( ERR_NONE == I2C_readDevMemBLK( EEPROM, 0x12, 4, ACCESS_BARE_METAL,
+         buf, sizeof(buf) ) );
+   HT_CHECK( I2CBus2 == l_blk.iBus && 0xA0 == l_blk.devAddr && !l_blk.isWrite );
+   HT_CHECK( 0x12 == l_blk.memAddr && 4 == l_blk.bytes );
+   HT_CHECK( 0 == memcmp( buf, &l_bus[I2CBus2].mem[0xA0][0x12], 4 ) );
+
+   HT_CHECK( ERR_NONE == I2C_writeDevMemBLK( EUI_ROM, 2, 6, ACCESS_BARE_METAL,
+         buf, sizeof(buf) ) );
+   HT_CHECK( I2CBus1 == l_blk.iBus && 0xB0 == l_blk.devAddr && l_blk.isWrite );
+   HT_CHECK( 0x9A == l_blk.memAddr && 6 == l_blk.bytes );
+   HT_CHECK( 0 == nPostsAll() );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   memcpy( s_I2C_Dev, l_devs, sizeof(l_devs) );
+   for ( int b = 0; b < MAX_I2C_BUS; b++ ) {
+      l_bus[b].ao.super.vptr = &l_mgrVtbl.super;
+   }
+   QF_poolInit( l_poolSto, sizeof(l_poolSto), sizeof(l_poolSto[0]) );
+   QEQueue_init( &CPLR_evtQueue, l_cplrQSto, Q_DIM(l_cplrQSto) );
+
+   test_registry();
+   test_routing();
+   test_access();
+   test_frt();
+   resetBuses();
+   test_blk();
+
+   return( HT_DONE( "i2c_dev_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,291 @@
+/**
+ * @file   i2c_multibus_test.c
+ * @brief  Host test of several I2C buses running transfers at the same time.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The firmware runs one I2CBusMgr and one I2CDevMgr per bus, each with its
+ * own queue, so transfers on different buses overlap.  The board only has
+ * one bus today (MAX_I2C_BUS is 1), so this test builds the multi-bus setup
+ * on the host instead: 2 to 4 simulated peripherals, each with its own
+ * EEPROM, transfer descriptor, and request queue, all driven by the real
+ * i2c_xfer.c engine.
+ *
+ * Every tick is one byte time on all buses, since they clock independently.
+ * Between ticks the CPU runs the pending event and error ISRs of every bus in
+ * a random order, the way the NVIC would interleave them.  The same requests
+ * are run once with a single manager that owns all the buses, starting one
+ * transfer at a time, and once with a manager per bus.  Both have to move
+ * every byte correctly, and the per bus managers have to overlap the buses
+ * and finish in about the time a single bus takes.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "i2c_sim.h"
+#include "i2c_xfer.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define DEV_ADDR                0xA0          /**< EEPROM on every bus */
+#define MAX_BUSES               4
+#define N_REQS                  24            /**< Requests queued per bus */
+#define MAX_LEN                 40            /**< Also the stride between requests */
+#define N_SEEDS                 20
+#define MAX_TICKS               1000000       /**< Hang guard per run */
+
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct Bus_t
+ * One bus: the peripheral, its queue of requests, and the transfer running.
+ */
+typedef struct Bus {
+   SimI2C_t    hw;
+   I2C_Xfer_t  xfer;
+   bool        isBusy;               /**< A transfer of this bus is running */
+   int         nStarted;                     /**< Requests taken off queue */
+   int         nDone;                        /**< Requests that finished */
+   int         nErrors;                  /**< Requests that didn't work */
+
+   /* The queue */
+   uint16_t    memAddr[N_REQS];
+   uint16_t    len[N_REQS];
+   bool        isRead[N_REQS];
+   uint8_t     buf[N_REQS][MAX_LEN];
+} Bus_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static Bus_t    l_bus[MAX_BUSES];
+static uint32_t l_seed;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief   Expected contents of an EEPROM location before anything is written.
+ * @param [in] iBus: int which bus.
+ * @param [in] addr: uint16_t address in the EEPROM.
+ * @return: uint8_t byte at that address.
+ */
+static uint8_t fill( int iBus, uint16_t addr )
+{
+   return( (uint8_t)(addr * 13 + iBus * 71) );
+}
+
+/**
+ * @brief   Reset the buses and queue the same requests on every run.
+ * @param [in] nBuses: int number of buses to set up.
+ * @return: None
+ */
+static void setup( int nBuses )
+{
+   for ( int b = 0; b < nBuses; b++ ) {
+      Bus_t *bus = &l_bus[b];
+      memset( bus, 0, sizeof(*bus) );
+      SimI2C_init( &bus->hw, DEV_ADDR, 2 );
+      for ( int a = 0; a < SIM_I2C_MEM_SIZE; a++ ) {
+         bus->hw.mem[a] = fill( b, (uint16_t)a );
+      }
+
+      /* Requests don't overlap so every read checks against the fill */
+      for ( int i = 0; i < N_REQS; i++ ) {
+         bus->len[i]     = (uint16_t)( 1 + (i * 7 + b * 3) % MAX_LEN );
+         bus->memAddr[i] = (uint16_t)( i * MAX_LEN + b * 3 );
+         bus->isRead[i]  = i & 1;
+         if ( !bus->isRead[i] ) {
+            for ( int j = 0; j < bus->len[i]; j++ ) {
+               bus->buf[i][j] = (uint8_t)( (b << 5) ^ i ^ j );
+            }
+         }
+      }
+   }
+}
+
+/**
+ * @brief   What an I2CDevMgr does when its bus frees up: take the next request
+ * off the queue and start it.
+ * @param [in,out] *bus: Bus_t pointer to the bus.
+ * @return: bool true if a transfer was started.
+ */
+static bool startNext( Bus_t *bus )
+{
+   if ( bus->isBusy || bus->nStarted >= N_REQS ) {
+      return( false );
+   }
+   int i = bus->nStarted++;
+   bus->xfer = (I2C_Xfer_t){
+      .devAddr = DEV_ADDR, .memAddrSize = 2, .memAddr = bus->memAddr[i],
+      .isRead = bus->isRead[i], .buf = bus->buf[i], .len = bus->len[i],
+   };
+   HT_CHECK( ERR_NONE == I2CXfer_start( &bus->xfer, &bus->hw ) );
+   bus->isBusy = true;
+   return( true );
+}
+
+/**
+ * @brief   Run every queued request on every bus.
+ * @param [in] nBuses: int number of buses.
+ * @param [in] isShared: bool one manager owns all the buses and only runs one
+ * transfer at a time.  Otherwise each bus has its own manager.
+ * @param [out] *maxBusy: int pointer to the most buses seen busy at once.
+ * @return: long number of byte times it took.
+ */
+static long run( int nBuses, bool isShared, int *maxBusy )
+{
+   int  nBusy = 0;
+   long t;
+   *maxBusy = 0;
+
+   for ( t = 0; t < MAX_TICKS; t++ ) {
+      bool isAllDone = true;
+      for ( int b = 0; b < nBuses; b++ ) {
+         isAllDone &= ( N_REQS == l_bus[b].nDone );
+      }
+      if ( isAllDone ) {
+         break;
+      }
+
+      /* The managers.  A shared one waits for the transfer it has running. */
+      for ( int b = 0; b < nBuses; b++ ) {
+         if ( !( isShared && nBusy > 0 ) && startNext( &l_bus[b] ) ) {
+            nBusy++;
+         }
+      }
+      if ( nBusy > *maxBusy ) {
+         *maxBusy = nBusy;
+      }
+
+      /* The ISRs of all buses, in random order, until none are pending */
+      bool isPending;
+      do {
+         int order[MAX_BUSES];
+         isPending = false;
+         for ( int b = 0; b < nBuses; b++ ) {
+            order[b] = b;
+         }
+         for ( int b = nBuses - 1; b > 0; b-- ) {
+            int j = HT_rand( &l_seed ) % (b + 1);
+            int tmp = order[b];
+            order[b] = order[j];
+            order[j] = tmp;
+         }
+         for ( int k = 0; k < nBuses; k++ ) {
+            Bus_t *bus = &l_bus[order[k]];
+            bool isDone = false;
+            if ( SimI2C_erIrq( &bus->hw ) ) {
+               isDone = I2CXfer_onError( &bus->xfer, &bus->hw );
+               isPending = true;
+            } else if ( SimI2C_evIrq( &bus->hw ) ) {
+               isDone = I2CXfer_onEvent( &bus->xfer, &bus->hw );
+               isPending = true;
+            }
+            if ( isDone ) {
+               bus->isBusy = false;
+               bus->nDone++;
+               nBusy--;
+               if ( ERR_NONE != bus->xfer.errorCode ) {
+                  bus->nErrors++;
+               }
+            }
+         }
+      } while ( isPending );
+
+      for ( int b = 0; b < nBuses; b++ ) {
+         (void)SimI2C_step( &l_bus[b].hw );
+      }
+   }
+   HT_CHECK_MSG( t < MAX_TICKS, "%d buses %s hung", nBuses,
+         isShared ? "shared" : "per bus" );
+   return( t );
+}
+
+/**
+ * @brief   Check every request moved the right bytes and nothing else moved.
+ * @param [in] nBuses: int number of buses.
+ * @return: None
+ */
+static void verify( int nBuses )
+{
+   for ( int b = 0; b < nBuses; b++ ) {
+      Bus_t *bus = &l_bus[b];
+      HT_CHECK( 0 == bus->nErrors );
+      HT_CHECK( 0 == bus->hw.nViolations );
+      HT_CHECK( N_REQS == bus->hw.nStops );
+      HT_CHECK( SIM_I2C_BUS_IDLE == bus->hw.bus );
+      for ( int i = 0; i < N_REQS; i++ ) {
+         for ( int j = 0; j < bus->len[i]; j++ ) {
+            uint16_t a = (uint16_t)( bus->memAddr[i] + j );
+            uint8_t  want = bus->isRead[i] ? fill( b, a ) : bus->buf[i][j];
+            uint8_t  got  = bus->isRead[i] ? bus->buf[i][j] : bus->hw.mem[a];
+            HT_CHECK_MSG( want == got, "bus %d req %d byte %d", b, i, j );
+         }
+      }
+   }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main( void )
+{
+   long tOne = 0;
+
+   printf( "buses | one manager for all | one manager per bus | speedup\n" );
+   for ( int nBuses = 1; nBuses <= MAX_BUSES; nBuses++ ) {
+      long tShared = 0;
+      long tPerBus = 0;
+      int  maxShared = 0;
+      int  maxPerBus = 0;
+
+      for ( uint32_t s = 1; s <= N_SEEDS; s++ ) {
+         int maxBusy;
+
+         l_seed = s;
+         setup( nBuses );
+         tShared += run( nBuses, true, &maxBusy );
+         verify( nBuses );
+         if ( maxBusy > maxShared ) {
+            maxShared = maxBusy;
+         }
+
+         l_seed = s;
+         setup( nBuses );
+         tPerBus += run( nBuses, false, &maxBusy );
+         verify( nBuses );
+         if ( maxBusy > maxPerBus ) {
+            maxPerBus = maxBusy;
+         }
+      }
+      tShared /= N_SEEDS;
+      tPerBus /= N_SEEDS;
+      if ( 1 == nBuses ) {
+         tOne = tPerBus;
+      }
+      printf( "%-5d | %-19ld | %-19ld | %.2f\n", nBuses, tShared, tPerBus,
+            (double)tShared / tPerBus );
+
+      /* The shared manager never overlaps, the per bus ones always do and
+       * shouldn't take much longer than one bus alone. */
+      HT_CHECK( 1 == maxShared );
+      HT_CHECK( nBuses == maxPerBus );
+      HT_CHECK_MSG( tPerBus * 10 <= tOne * 11, "%d buses took %ld vs %ld",
+            nBuses, tPerBus, tOne );
+      HT_CHECK_MSG( tShared * 10 >= tPerBus * nBuses * 9,
+            "%d buses shared %ld per bus %ld", nBuses, tShared, tPerBus );
+   }
+
+   return( HT_DONE( "i2c_multibus_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
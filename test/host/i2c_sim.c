@@ -0,0 +1,350 @@
+/**
+ * @file   i2c_sim.c
+ * @brief  Simulated STM32F4 I2C master peripheral with an EEPROM on the bus.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "i2c_sim.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+
+/**< SR1 error flags.  Cleared by writing 0, other bits ignore writes. */
+#define SIM_I2C_SR1_ERRORS \
+   ( I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR )
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void SimI2C_start( SimI2C_t *hw )
+{
+   hw->CR1     &= (uint16_t)~I2C_CR1_START;
+   hw->SR1     &= (uint16_t)~(I2C_SR1_TXE | I2C_SR1_BTF);
+   hw->SR1     |= I2C_SR1_SB;
+   hw->sr1Read  = false;
+   hw->shiftFull = false;
+   hw->bus      = SIM_I2C_BUS_SB;
+   hw->nStarts++;
+}
+
+/******************************************************************************/
+static void SimI2C_stop( SimI2C_t *hw )
+{
+   if ( SIM_I2C_BUS_RX == hw->bus && hw->nRxBytes > 0 && !hw->lastWasNack ) {
+      hw->nViolations++;      /* The last byte of a read has to be NACKed */
+   }
+   if ( SIM_I2C_BUS_TX == hw->bus
+         && ( hw->shiftFull || !(hw->SR1 & I2C_SR1_TXE) ) ) {
+      hw->nViolations++;                          /* Data left unsent */
+   }
+
+   /* Received bytes stay in DR and the shift register until they're read */
+   if ( SIM_I2C_BUS_RX != hw->bus ) {
+      hw->shiftFull = false;
+      hw->SR1 &= (uint16_t)~(I2C_SR1_TXE | I2C_SR1_BTF);
+   }
+   hw->SR1 &= (uint16_t)~(I2C_SR1_SB | I2C_SR1_ADDR);
+   hw->CR1 &= (uint16_t)~I2C_CR1_STOP;
+   hw->bus  = SIM_I2C_BUS_IDLE;
+   hw->nStops++;
+}
+
+/******************************************************************************/
+static bool SimI2C_stopOrRestart( SimI2C_t *hw )
+{
+   if ( hw->CR1 & I2C_CR1_STOP ) {
+      SimI2C_stop( hw );
+      return( true );
+   }
+   if ( hw->CR1 & I2C_CR1_START ) {
+      if ( SIM_I2C_BUS_RX == hw->bus && !hw->lastWasNack ) {
+         hw->nViolations++;
+      }
+      SimI2C_start( hw );
+      return( true );
+   }
+   return( false );
+}
+
+/******************************************************************************/
+static bool SimI2C_slaveWrite( SimI2C_t *hw, uint8_t b )
+{
+   if ( hw->nAddrBytes < hw->memAddrSize ) {
+      hw->ptr = ( 0 == hw->nAddrBytes ) ? b : (uint16_t)(hw->ptr << 8 | b);
+      hw->nAddrBytes++;
+      return( true );
+   }
+   if ( (int32_t)hw->nDataBytes == hw->nackDataByte ) {
+      return( false );
+   }
+   hw->mem[hw->ptr++ % SIM_I2C_MEM_SIZE] = b;
+   hw->nDataBytes++;
+   return( true );
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/******************************************************************************/
+void SimI2C_init( SimI2C_t *hw, uint8_t slaveAddr, uint8_t memAddrSize )
+{
+   memset( hw, 0, sizeof(*hw) );
+   hw->slaveAddr    = slaveAddr;
+   hw->memAddrSize  = memAddrSize;
+   hw->nackDataByte = -1;
+}
+
+/******************************************************************************/
+bool SimI2C_evIrq( const SimI2C_t *hw )
+{
+   if ( !(hw->CR2 & I2C_CR2_ITEVTEN) ) {
+      return( false );
+   }
+   if ( hw->SR1 & (I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_BTF) ) {
+      return( true );
+   }
+   return( (hw->CR2 & I2C_CR2_ITBUFEN)
+         && (hw->SR1 & (I2C_SR1_TXE | I2C_SR1_RXNE)) );
+}
+
+/******************************************************************************/
+bool SimI2C_erIrq( const SimI2C_t *hw )
+{
+   return( (hw->CR2 & I2C_CR2_ITERREN) && (hw->SR1 & SIM_I2C_SR1_ERRORS) );
+}
+
+/******************************************************************************/
+bool SimI2C_step( SimI2C_t *hw )
+{
+   switch ( hw->bus ) {
+      case SIM_I2C_BUS_IDLE:
+         if ( hw->CR1 & I2C_CR1_START ) {
+            SimI2C_start( hw );
+            return( true );
+         }
+         hw->CR1 &= (uint16_t)~I2C_CR1_STOP;   /* No effect on a free bus */
+         return( false );
+
+      case SIM_I2C_BUS_SB:                        /* Stretched until DR write */
+      case SIM_I2C_BUS_ADDR_ACKED:             /* Stretched until ADDR clears */
+      case SIM_I2C_BUS_NACKED:
+         return( SimI2C_stopOrRestart( hw ) );
+
+      case SIM_I2C_BUS_ADDR:
+         hw->nBytesOnWire++;
+         if ( (hw->addrByte & 0xFE) == hw->slaveAddr && !hw->isAbsent ) {
+            hw->isRx        = hw->addrByte & 0x01;
+            hw->SR1        |= I2C_SR1_ADDR;
+            hw->sr1Read     = false;
+            hw->ackNext     = hw->CR1 & I2C_CR1_ACK;
+            hw->nRxBytes    = 0;
+            hw->lastWasNack = false;
+            if ( !hw->isRx ) {
+               hw->nAddrBytes = 0;
+               hw->nDataBytes = 0;
+            }
+            hw->bus = SIM_I2C_BUS_ADDR_ACKED;
+         } else {
+            hw->SR1 |= I2C_SR1_AF;
+            hw->bus  = SIM_I2C_BUS_NACKED;
+         }
+         return( true );
+
+      case SIM_I2C_BUS_TX:
+         if ( !hw->shiftFull ) {
+            if ( !(hw->SR1 & I2C_SR1_TXE) ) {   /* DR written while stretched */
+               hw->shift     = (uint8_t)hw->DR;
+               hw->shiftFull = true;
+               hw->SR1      |= I2C_SR1_TXE;
+               hw->SR1      &= (uint16_t)~I2C_SR1_BTF;
+               return( true );
+            }
+            if ( SimI2C_stopOrRestart( hw ) ) {
+               return( true );
+            }
+            if ( hw->SR1 & I2C_SR1_BTF ) {
+               return( false );
+            }
+            hw->SR1 |= I2C_SR1_BTF;
+            return( true );
+         }
+
+         hw->nBytesOnWire++;
+         hw->shiftFull = false;
+         if ( !SimI2C_slaveWrite( hw, hw->shift ) ) {
+            hw->SR1 |= I2C_SR1_AF;
+            hw->SR1 &= (uint16_t)~(I2C_SR1_TXE | I2C_SR1_BTF);
+            hw->bus  = SIM_I2C_BUS_NACKED;
+            return( true );
+         }
+         if ( SimI2C_stopOrRestart( hw ) ) {
+            return( true );
+         }
+         if ( !(hw->SR1 & I2C_SR1_TXE) ) {
+            hw->shift     = (uint8_t)hw->DR;
+            hw->shiftFull = true;
+            hw->SR1      |= I2C_SR1_TXE;
+         } else {
+            hw->SR1 |= I2C_SR1_BTF;                  /* Stretched, DR empty */
+         }
+         return( true );
+
+      case SIM_I2C_BUS_RX: {
+         if ( hw->shiftFull ) {                         /* Stretched at BTF */
+            return( SimI2C_stopOrRestart( hw ) );
+         }
+         if ( hw->lastWasNack ) {
+            hw->nViolations++;         /* Clocking a slave that was let go */
+         }
+
+         /* With POS the ACK bit was latched at the end of the byte before */
+         bool ack = ( hw->CR1 & I2C_CR1_POS ) ? hw->ackNext
+                                              : ( hw->CR1 & I2C_CR1_ACK );
+         hw->ackNext     = hw->CR1 & I2C_CR1_ACK;
+         hw->lastWasNack = !ack;
+         hw->nBytesOnWire++;
+         hw->nRxBytes++;
+
+         uint8_t b = hw->mem[hw->ptr++ % SIM_I2C_MEM_SIZE];
+         if ( !(hw->SR1 & I2C_SR1_RXNE) ) {
+            hw->DR   = b;
+            hw->SR1 |= I2C_SR1_RXNE;
+         } else {
+            hw->shift     = b;
+            hw->shiftFull = true;
+            hw->SR1      |= I2C_SR1_BTF;
+         }
+         (void)SimI2C_stopOrRestart( hw );
+         return( true );
+      }
+
+      default:
+         return( false );
+   }
+}
+
+/******************************************************************************/
+void SimI2C_arbLost( SimI2C_t *hw )
+{
+   hw->SR1 |= I2C_SR1_ARLO;
+   hw->SR1 &= (uint16_t)~(I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_TXE
+         | I2C_SR1_BTF | I2C_SR1_RXNE);
+   hw->CR1 &= (uint16_t)~I2C_CR1_START;
+   hw->shiftFull = false;
+   hw->bus       = SIM_I2C_BUS_IDLE;
+}
+
+/******************************************************************************/
+uint16_t SimI2C_rd_CR1( SimI2C_t *hw )
+{
+   return( hw->CR1 );
+}
+
+/******************************************************************************/
+uint16_t SimI2C_rd_CR2( SimI2C_t *hw )
+{
+   return( hw->CR2 );
+}
+
+/******************************************************************************/
+uint16_t SimI2C_rd_SR1( SimI2C_t *hw )
+{
+   hw->sr1Read = true;
+   return( hw->SR1 );
+}
+
+/******************************************************************************/
+uint16_t SimI2C_rd_SR2( SimI2C_t *hw )
+{
+   if ( (hw->SR1 & I2C_SR1_ADDR) && hw->sr1Read ) {
+      hw->SR1 &= (uint16_t)~I2C_SR1_ADDR;
+      if ( hw->isRx ) {
+         hw->bus = SIM_I2C_BUS_RX;
+      } else {
+         hw->bus  = SIM_I2C_BUS_TX;
+         hw->SR1 |= I2C_SR1_TXE;
+      }
+   }
+   hw->sr1Read = false;
+   return( SIM_I2C_BUS_IDLE == hw->bus ? 0x0000 : 0x0003 );    /* BUSY|MSL */
+}
+
+/******************************************************************************/
+uint16_t SimI2C_rd_DR( SimI2C_t *hw )
+{
+   uint16_t val = hw->DR;
+   if ( hw->shiftFull ) {
+      hw->DR        = hw->shift;
+      hw->shiftFull = false;
+      hw->SR1      &= (uint16_t)~I2C_SR1_BTF;
+   } else {
+      hw->SR1 &= (uint16_t)~(I2C_SR1_RXNE | I2C_SR1_BTF);
+   }
+   return( val );
+}
+
+/******************************************************************************/
+void SimI2C_wr_CR1( SimI2C_t *hw, uint16_t val )
+{
+   hw->CR1 = val;
+
+   /* A receiver stretched at BTF has no byte in progress, so STOP goes out
+    * right away and nothing more is clocked in (RM0090 two byte read) */
+   if ( (val & I2C_CR1_STOP) && SIM_I2C_BUS_RX == hw->bus && hw->shiftFull ) {
+      SimI2C_stop( hw );
+   }
+}
+
+/******************************************************************************/
+void SimI2C_wr_CR2( SimI2C_t *hw, uint16_t val )
+{
+   hw->CR2 = val;
+}
+
+/******************************************************************************/
+void SimI2C_wr_SR1( SimI2C_t *hw, uint16_t val )
+{
+   hw->SR1 &= (uint16_t)(val | ~SIM_I2C_SR1_ERRORS);
+}
+
+/******************************************************************************/
+void SimI2C_wr_DR( SimI2C_t *hw, uint16_t val )
+{
+   if ( hw->SR1 & I2C_SR1_SB ) {
+      if ( !hw->sr1Read ) {
+         hw->nViolations++;       /* SB only clears on SR1 read, DR write */
+      }
+      hw->SR1     &= (uint16_t)~I2C_SR1_SB;
+      hw->addrByte = (uint8_t)val;
+      hw->bus      = SIM_I2C_BUS_ADDR;
+      return;
+   }
+
+   if ( SIM_I2C_BUS_TX == hw->bus && !hw->shiftFull
+         && (hw->SR1 & I2C_SR1_TXE) ) {
+      /* Goes straight on to the shift register so DR stays empty */
+      hw->shift     = (uint8_t)val;
+      hw->shiftFull = true;
+   } else {
+      if ( !(hw->SR1 & I2C_SR1_TXE) ) {
+         hw->nViolations++;                 /* Overwrote a byte not sent yet */
+      }
+      hw->DR   = val;
+      hw->SR1 &= (uint16_t)~I2C_SR1_TXE;
+   }
+   hw->SR1 &= (uint16_t)~I2C_SR1_BTF;
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,181 @@
+/**
+ * @file   i2c_sim.h
+ * @brief  Simulated STM32F4 I2C master peripheral with an EEPROM on the bus,
+ * for running the I2C transfer engine on a host.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Build i2c_xfer.c with "-include i2c_sim.h" so its I2C_XFER_RD() and
+ * I2C_XFER_WR() register accesses land here instead of on the hardware.
+ *
+ * The model follows the master transmitter and receiver sequences of RM0090
+ * one byte time at a time: SB, ADDR, TXE, RXNE, and BTF set and clear the way
+ * the reference manual describes, including the SR1 then SR2 read that clears
+ * ADDR, clock stretching while BTF is set, and the (N)ACK rules with and
+ * without POS.  STOP and START take effect at the end of the byte that is on
+ * the wire.  The EEPROM ACKs its address, takes 0 to 2 bytes of memory
+ * address, and then stores or sends data.  It can be told to be absent or to
+ * NACK a given data byte.
+ *
+ * Anything that would be a protocol error on a real bus, such as the master
+ * ACKing a byte past the end of a read or leaving the bus without a STOP, is
+ * counted in nViolations so tests can check for it.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef I2C_SIM_H_
+#define I2C_SIM_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported defines ----------------------------------------------------------*/
+
+/* Register bits the transfer engine uses, same values as stm32f4xx.h */
+#define I2C_CR1_START                                          ((uint16_t)0x0100)
+#define I2C_CR1_STOP                                           ((uint16_t)0x0200)
+#define I2C_CR1_ACK                                            ((uint16_t)0x0400)
+#define I2C_CR1_POS                                            ((uint16_t)0x0800)
+#define I2C_CR2_ITERREN                                        ((uint16_t)0x0100)
+#define I2C_CR2_ITEVTEN                                        ((uint16_t)0x0200)
+#define I2C_CR2_ITBUFEN                                        ((uint16_t)0x0400)
+#define I2C_SR1_SB                                             ((uint16_t)0x0001)
+#define I2C_SR1_ADDR                                           ((uint16_t)0x0002)
+#define I2C_SR1_BTF                                            ((uint16_t)0x0004)
+#define I2C_SR1_RXNE                                           ((uint16_t)0x0040)
+#define I2C_SR1_TXE                                            ((uint16_t)0x0080)
+#define I2C_SR1_BERR                                           ((uint16_t)0x0100)
+#define I2C_SR1_ARLO                                           ((uint16_t)0x0200)
+#define I2C_SR1_AF                                             ((uint16_t)0x0400)
+#define I2C_SR1_OVR                                            ((uint16_t)0x0800)
+
+/**< Size of the simulated EEPROM.  Addresses wrap. */
+#define SIM_I2C_MEM_SIZE                                                  1024
+
+/**< Register block the transfer engine drives */
+#define I2C_XFER_HW_T                                                 SimI2C_t
+
+/**< Register accesses of the transfer engine go to the model */
+#define I2C_XFER_RD( hw, reg )                         SimI2C_rd_##reg( (hw) )
+#define I2C_XFER_WR( hw, reg, val )   SimI2C_wr_##reg( (hw), (uint16_t)(val) )
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * \enum SimI2CBus_t
+ * What the master is doing on the wire.
+ */
+typedef enum SimI2CBus {
+   SIM_I2C_BUS_IDLE = 0,                          /**< No START, bus released */
+   SIM_I2C_BUS_SB,                    /**< START sent, waiting for the address */
+   SIM_I2C_BUS_ADDR,                      /**< Address byte waiting to go out */
+   SIM_I2C_BUS_ADDR_ACKED,          /**< ADDR set, stretched until it's cleared */
+   SIM_I2C_BUS_TX,                         /**< Master transmitting data bytes */
+   SIM_I2C_BUS_RX,                           /**< Master receiving data bytes */
+   SIM_I2C_BUS_NACKED,              /**< Slave NACKed, waiting for STOP/START */
+} SimI2CBus_t;
+
+/**
+ * \struct SimI2C_t
+ * One I2C peripheral and the EEPROM on its bus.
+ */
+typedef struct SimI2C {
+   /* Registers */
+   uint16_t    CR1;
+   uint16_t    CR2;
+   uint16_t    SR1;
+   uint16_t    DR;
+
+   /* Master side of the model */
+   SimI2CBus_t bus;
+   bool        sr1Read;          /**< SR1 read since ADDR/SB/BTF was set */
+   bool        isRx;                /**< Address byte had the read bit */
+   uint8_t     addrByte;              /**< Address byte written to DR */
+   bool        shiftFull;          /**< Byte in the shift register */
+   uint8_t     shift;                         /**< Shift register */
+   bool        ackNext;        /**< POS: (N)ACK latched for the next byte */
+   uint32_t    nRxBytes;          /**< Bytes received in this transfer */
+
+   /* The EEPROM */
+   uint8_t     slaveAddr;           /**< 8 bit (shifted) address it answers */
+   bool        isAbsent;                   /**< NACK its own address */
+   int32_t     nackDataByte;   /**< NACK this written data byte, -1 for none */
+   uint8_t     memAddrSize;           /**< Bytes of memory address it takes */
+   uint8_t     mem[SIM_I2C_MEM_SIZE];
+   uint16_t    ptr;                            /**< Memory address pointer */
+   uint8_t     nAddrBytes;       /**< Memory address bytes got this write */
+   uint32_t    nDataBytes;              /**< Data bytes got this write */
+   bool        lastWasNack;     /**< Master NACKed the last byte it read */
+
+   /* What happened on the wire */
+   uint32_t    nStarts;
+   uint32_t    nStops;
+   uint32_t    nBytesOnWire;
+   uint32_t    nViolations;          /**< Things a real bus wouldn't allow */
+} SimI2C_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Reset the peripheral and put an EEPROM on the bus.
+ * @param [out] *hw: SimI2C_t pointer to the model.
+ * @param [in] slaveAddr: uint8_t 8 bit address of the EEPROM.
+ * @param [in] memAddrSize: uint8_t bytes of memory address it takes.
+ * @return: None
+ */
+void SimI2C_init( SimI2C_t *hw, uint8_t slaveAddr, uint8_t memAddrSize );
+
+/**
+ * @brief   Check if the event ISR would be running right now.
+ * @param [in] *hw: SimI2C_t pointer to the model.
+ * @return: bool true if an enabled event interrupt is pending.
+ */
+bool SimI2C_evIrq( const SimI2C_t *hw );
+
+/**
+ * @brief   Check if the error ISR would be running right now.
+ * @param [in] *hw: SimI2C_t pointer to the model.
+ * @return: bool true if an enabled error interrupt is pending.
+ */
+bool SimI2C_erIrq( const SimI2C_t *hw );
+
+/**
+ * @brief   Let one byte time go by on the bus.
+ * @param [in,out] *hw: SimI2C_t pointer to the model.
+ * @return: bool true if anything happened, false if the bus is idle or
+ * stretched waiting on the CPU.
+ */
+bool SimI2C_step( SimI2C_t *hw );
+
+/**
+ * @brief   Have another master win arbitration.  The peripheral sets ARLO and
+ * drops out of master mode without a STOP, like the real one does.
+ * @param [in,out] *hw: SimI2C_t pointer to the model.
+ * @return: None
+ */
+void SimI2C_arbLost( SimI2C_t *hw );
+
+uint16_t SimI2C_rd_CR1( SimI2C_t *hw );
+uint16_t SimI2C_rd_CR2( SimI2C_t *hw );
+uint16_t SimI2C_rd_SR1( SimI2C_t *hw );
+uint16_t SimI2C_rd_SR2( SimI2C_t *hw );
+uint16_t SimI2C_rd_DR( SimI2C_t *hw );
+void SimI2C_wr_CR1( SimI2C_t *hw, uint16_t val );
+void SimI2C_wr_CR2( SimI2C_t *hw, uint16_t val );
+void SimI2C_wr_SR1( SimI2C_t *hw, uint16_t val );
+void SimI2C_wr_DR( SimI2C_t *hw, uint16_t val );
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                          /* I2C_SIM_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,337 @@
+/**
+ * @file   i2c_xfer_test.c
+ * @brief  Host test of the interrupt driven I2C transfer engine against a
+ * simulated STM32F4 I2C peripheral.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Every combination of 0 to 2 memory address bytes and 1 to 40 data bytes is
+ * written to and read back from the simulated EEPROM, once with the ISRs
+ * running as soon as their flag sets and once with them held off for random
+ * byte times.  Each transfer has to move exactly its bytes, NACK the last
+ * byte it reads, end with a STOP, and leave the peripheral ready for the
+ * next one.  NACKs, lost arbitration, aborts, and bad descriptors are checked
+ * too.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "i2c_sim.h"
+#include "i2c_xfer.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define DEV_ADDR                0xA0          /**< EEPROM on the target */
+#define MAX_LEN                 40
+#define MAX_STEPS               100000        /**< Hang guard per transfer */
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0x12C0FFEEu;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief   Run the ISRs and the bus until nothing more happens.
+ * @param [in,out] *xfer: I2C_Xfer_t pointer to the transfer.
+ * @param [in,out] *hw: SimI2C_t pointer to the peripheral.
+ * @param [in] isLate: bool hold the ISRs off for random byte times.
+ * @return: int number of times the engine reported the transfer finished.
+ */
+static int run( I2C_Xfer_t *xfer, SimI2C_t *hw, bool isLate )
+{
+   int nDone = 0;
+   int n;
+   for ( n = 0; n < MAX_STEPS; n++ ) {
+      bool isIrq = SimI2C_erIrq( hw ) || SimI2C_evIrq( hw );
+      if ( isIrq && !( isLate && 0 == HT_rand( &l_seed ) % 3 ) ) {
+         if ( SimI2C_erIrq( hw ) ) {
+            nDone += I2CXfer_onError( xfer, hw );
+         } else {
+            nDone += I2CXfer_onEvent( xfer, hw );
+         }
+      } else if ( !SimI2C_step( hw ) && !isIrq ) {
+         break;
+      }
+   }
+   HT_CHECK_MSG( n < MAX_STEPS, "hung in phase %d", xfer->phase );
+   return( nDone );
+}
+
+/**
+ * @brief   Check the peripheral was left free and ready for the next transfer.
+ * @param [in] *hw: SimI2C_t pointer to the peripheral.
+ * @return: None
+ */
+static void checkIdle( const SimI2C_t *hw )
+{
+   HT_CHECK( SIM_I2C_BUS_IDLE == hw->bus );
+   HT_CHECK( 0 == (hw->SR1 & ~I2C_SR1_ARLO) );
+   HT_CHECK( 0 == (hw->CR1 & (I2C_CR1_START | I2C_CR1_STOP | I2C_CR1_POS)) );
+   HT_CHECK( hw->CR1 & I2C_CR1_ACK );
+   HT_CHECK( I2C_CR2_ITERREN == hw->CR2 );
+}
+
+/**
+ * @brief   Write then read back one block and check everything on the way.
+ * @param [in,out] *hw: SimI2C_t pointer to the peripheral.
+ * @param [in] memAddr: uint16_t where in the EEPROM.
+ * @param [in] len: uint16_t number of data bytes.
+ * @param [in] isLate: bool hold the ISRs off for random byte times.
+ * @return: None
+ */
+static void writeRead( SimI2C_t *hw, uint16_t memAddr, uint16_t len,
+      bool isLate )
+{
+   uint8_t data[MAX_LEN];
+   uint8_t back[MAX_LEN + 1];
+   uint8_t m = hw->memAddrSize;
+   for ( int i = 0; i < len; i++ ) {
+      data[i] = (uint8_t)HT_rand( &l_seed );
+   }
+
+   /* Write.  A device without memory address bytes writes at its pointer. */
+   hw->ptr = memAddr;
+   hw->nStarts = hw->nStops = hw->nBytesOnWire = hw->nViolations = 0;
+   I2C_Xfer_t xfer = {
+      .devAddr = DEV_ADDR, .memAddrSize = m, .memAddr = memAddr,
+      .isRead = false, .buf = data, .len = len,
+   };
+   HT_CHECK( ERR_NONE == I2CXfer_start( &xfer, hw ) );
+   HT_CHECK( 1 == run( &xfer, hw, isLate ) );
+   HT_CHECK( I2C_XFER_DONE == xfer.phase && ERR_NONE == xfer.errorCode );
+   HT_CHECK( len == xfer.idx );
+   HT_CHECK( 1 == hw->nStarts && 1 == hw->nStops );
+   HT_CHECK( (uint32_t)(1 + m + len) == hw->nBytesOnWire );
+   HT_CHECK( 0 == hw->nViolations );
+   if ( !isLate ) {
+      HT_CHECK_MSG( xfer.nIrqs <= m + len + 3, "write m=%u len=%u took %u",
+            m, len, xfer.nIrqs );
+   }
+   for ( int i = 0; i < len; i++ ) {
+      HT_CHECK( data[i] == hw->mem[(memAddr + i) % SIM_I2C_MEM_SIZE] );
+   }
+   checkIdle( hw );
+
+   /* Read it back.  The extra byte has to stay untouched. */
+   memset( back, 0x5C, sizeof(back) );
+   hw->ptr = memAddr + 0x155;     /* Only the memory address may move it */
+   if ( 0 == m ) {
+      hw->ptr = memAddr;
+   }
+   hw->nStarts = hw->nStops = hw->nBytesOnWire = hw->nViolations = 0;
+   xfer = (I2C_Xfer_t){
+      .devAddr = DEV_ADDR, .memAddrSize = m, .memAddr = memAddr,
+      .isRead = true, .buf = back, .len = len,
+   };
+   HT_CHECK( ERR_NONE == I2CXfer_start( &xfer, hw ) );
+   HT_CHECK( 1 == run( &xfer, hw, isLate ) );
+   HT_CHECK( I2C_XFER_DONE == xfer.phase && ERR_NONE == xfer.errorCode );
+   HT_CHECK( len == xfer.idx );
+   HT_CHECK_MSG( 0 == memcmp( data, back, len ), "read m=%u len=%u late=%d",
+         m, len, isLate );
+   HT_CHECK( 0x5C == back[len] );
+   HT_CHECK( (uint32_t)( m > 0 ? 2 : 1 ) == hw->nStarts );
+   HT_CHECK( 1 == hw->nStops );
+   HT_CHECK_MSG( (uint32_t)( (m > 0 ? 1 + m : 0) + 1 + len )
+         == hw->nBytesOnWire, "read m=%u len=%u clocked %u bytes",
+         m, len, hw->nBytesOnWire );
+   HT_CHECK( hw->lastWasNack );
+   HT_CHECK_MSG( 0 == hw->nViolations, "read m=%u len=%u late=%d",
+         m, len, isLate );
+   if ( !isLate ) {
+      HT_CHECK_MSG( xfer.nIrqs <= m + len + 5, "read m=%u len=%u took %u",
+            m, len, xfer.nIrqs );
+   }
+   checkIdle( hw );
+}
+
+/**
+ * @brief   Address and data NACKs have to fail the transfer and free the bus.
+ * @param   None
+ * @return: None
+ */
+static void testNack( void )
+{
+   SimI2C_t hw;
+   uint8_t  data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+   /* Nobody at the address, for both directions */
+   for ( int isRead = 0; isRead < 2; isRead++ ) {
+      SimI2C_init( &hw, DEV_ADDR, 2 );
+      hw.isAbsent = true;
+      I2C_Xfer_t xfer = {
+         .devAddr = DEV_ADDR, .memAddrSize = 2, .memAddr = 0x10,
+         .isRead = isRead, .buf = data, .len = sizeof(data),
+      };
+      HT_CHECK( ERR_NONE == I2CXfer_start( &xfer, &hw ) );
+      HT_CHECK( 1 == run( &xfer, &hw, false ) );
+      HT_CHECK( ERR_I2CBUS_NACK == xfer.errorCode );
+      HT_CHECK( 1 == hw.nStops && 1 == hw.nBytesOnWire );
+      checkIdle( &hw );
+   }
+
+   /* The EEPROM refuses the 5th data byte, e.g. write protected page */
+   SimI2C_init( &hw, DEV_ADDR, 1 );
+   hw.nackDataByte = 4;
+   I2C_Xfer_t xfer = {
+      .devAddr = DEV_ADDR, .memAddrSize = 1, .memAddr = 0x20,
+      .isRead = false, .buf = data, .len = sizeof(data),
+   };
+   HT_CHECK( ERR_NONE == I2CXfer_start( &xfer, &hw ) );
+   HT_CHECK( 1 == run( &xfer, &hw, false ) );
+   HT_CHECK( ERR_I2CBUS_NACK == xfer.errorCode );
+   HT_CHECK( 4 == hw.nDataBytes );
+   HT_CHECK( 0 == memcmp( &hw.mem[0x20], data, 4 ) && 0 == hw.mem[0x24] );
+   HT_CHECK( 1 == hw.nStops );
+   checkIdle( &hw );
+}
+
+/**
+ * @brief   Losing arbitration fails the transfer without a STOP of our own.
+ * @param   None
+ * @return: None
+ */
+static void testArbLost( void )
+{
+   SimI2C_t hw;
+   uint8_t  buf[16];
+   SimI2C_init( &hw, DEV_ADDR, 2 );
+   I2C_Xfer_t xfer = {
+      .devAddr = DEV_ADDR, .memAddrSize = 2, .memAddr = 0,
+      .isRead = true, .buf = buf, .len = sizeof(buf),
+   };
+   HT_CHECK( ERR_NONE == I2CXfer_start( &xfer, &hw ) );
+   for ( int i = 0; i < 4; i++ ) {
+      (void)SimI2C_step( &hw );
+      if ( SimI2C_evIrq( &hw ) ) {
+         (void)I2CXfer_onEvent( &xfer, &hw );
+      }
+   }
+   SimI2C_arbLost( &hw );
+   HT_CHECK( 1 == run( &xfer, &hw, false ) );
+   HT_CHECK( ERR_I2CBUS_ARB_LOST == xfer.errorCode );
+   HT_CHECK( 0 == hw.nStops );
+   checkIdle( &hw );
+}
+
+/**
+ * @brief   Aborting at any point has to free the bus and leave the engine done.
+ * @param   None
+ * @return: None
+ */
+static void testAbort( void )
+{
+   uint8_t buf[12];
+   for ( int at = 0; at < 40; at++ ) {
+      SimI2C_t hw;
+      SimI2C_init( &hw, DEV_ADDR, 2 );
+      I2C_Xfer_t xfer = {
+         .devAddr = DEV_ADDR, .memAddrSize = 2, .memAddr = 0x40,
+         .isRead = (at & 1), .buf = buf, .len = sizeof(buf),
+      };
+      HT_CHECK( ERR_NONE == I2CXfer_start( &xfer, &hw ) );
+
+      /* Run part of the way, ISRs on time */
+      bool isDone = false;
+      for ( int i = 0; i < at && !isDone; i++ ) {
+         if ( SimI2C_evIrq( &hw ) ) {
+            isDone = I2CXfer_onEvent( &xfer, &hw );
+         } else {
+            (void)SimI2C_step( &hw );
+         }
+      }
+
+      bool wasRunning = I2CXfer_abort( &xfer, &hw, ERR_I2CBUS_XFER_TIMEOUT );
+      HT_CHECK( wasRunning == !isDone );
+      HT_CHECK( I2C_XFER_DONE == xfer.phase );
+      HT_CHECK( !I2CXfer_abort( &xfer, &hw, ERR_I2CBUS_XFER_TIMEOUT ) );
+      HT_CHECK( 0 == run( &xfer, &hw, false ) );
+      if ( wasRunning ) {
+         HT_CHECK( ERR_I2CBUS_XFER_TIMEOUT == xfer.errorCode );
+      }
+
+      /* Whatever was left in DR from a cut off read isn't an event anymore */
+      (void)SimI2C_rd_DR( &hw );
+      (void)SimI2C_rd_DR( &hw );
+      HT_CHECK( hw.nStops == hw.nStarts - (hw.nStarts > 1) );
+      checkIdle( &hw );
+   }
+}
+
+/**
+ * @brief   Bad descriptors never touch the bus.
+ * @param   None
+ * @return: None
+ */
+static void testInvalid( void )
+{
+   static const struct { uint8_t m; bool isRead; uint16_t len; } bad[] = {
+      { 3, false, 4 }, { 3, true, 4 }, { 1, true, 0 }, { 0, true, 0 },
+      { 0, false, 0 },
+   };
+   uint8_t buf[4];
+   for ( unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); i++ ) {
+      SimI2C_t hw;
+      SimI2C_init( &hw, DEV_ADDR, 2 );
+      I2C_Xfer_t xfer = {
+         .devAddr = DEV_ADDR, .memAddrSize = bad[i].m,
+         .isRead = bad[i].isRead, .buf = buf, .len = bad[i].len,
+      };
+      HT_CHECK( ERR_I2CBUS_INVALID_XFER == I2CXfer_start( &xfer, &hw ) );
+      HT_CHECK( !SimI2C_step( &hw ) && 0 == hw.nStarts );
+      HT_CHECK( 0 == hw.CR1 && 0 == hw.CR2 );
+   }
+
+   /* A memory address only write just moves the EEPROM's pointer */
+   SimI2C_t hw;
+   SimI2C_init( &hw, DEV_ADDR, 2 );
+   I2C_Xfer_t xfer = {
+      .devAddr = DEV_ADDR, .memAddrSize = 2, .memAddr = 0x123,
+      .isRead = false, .buf = NULL, .len = 0,
+   };
+   HT_CHECK( ERR_NONE == I2CXfer_start( &xfer, &hw ) );
+   HT_CHECK( 1 == run( &xfer, &hw, false ) );
+   HT_CHECK( ERR_NONE == xfer.errorCode && 0x123 == hw.ptr );
+   HT_CHECK( 0 == hw.nViolations );
+   checkIdle( &hw );
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/******************************************************************************/
+int main( void )
+{
+   for ( int isLate = 0; isLate < 2; isLate++ ) {
+      for ( uint8_t m = 0; m <= 2; m++ ) {
+         SimI2C_t hw;
+         SimI2C_init( &hw, DEV_ADDR, m );
+         for ( uint16_t len = 1; len <= MAX_LEN; len++ ) {
+            uint16_t memAddr = (uint16_t)(HT_rand( &l_seed ) % 0x400);
+            if ( 1 == m ) {
+               memAddr &= 0xFF;
+            }
+            writeRead( &hw, memAddr, len, isLate );
+         }
+      }
+   }
+
+   testNack();
+   testArbLost();
+   testAbort();
+   testInvalid();
+
+   return( HT_DONE( "i2c_xfer_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,241 @@
+/**
+ * @file   log_fanout_bench.c
+ * @brief  Host benchmark of the log fan-out ring with several clients that
+ * read at different speeds.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Simulates 10 s of logging at about 113 KB/s into the 8 KB ring that
+ * LWIPMgr uses, with one client per open slot:
+ *
+ *    - a fast client that takes 1 MB/s,
+ *    - a 100 KB/s client,
+ *    - a 10 KB/s client,
+ *    - a 10 KB/s client that only wants WRN and up from one module.
+ *
+ * Every millisecond one record is written and every client is given its
+ * byte budget, the way its TCP send buffer drains.  Each client checks that
+ * the records it gets are whole and in order, and that sent, filtered,
+ * dropped, and still queued add up to everything written.  Then the cost of
+ * a write, with and without draining the clients, is timed.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "log_fanout.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define RING_SIZE               8192        /**< LWIP_LOG_RING_SIZE */
+#define SIM_MS                  10000           /**< Simulated time */
+#define MIN_REC_LEN             64
+#define MAX_REC_LEN             160
+#define TIMED_WRITES            1000000
+
+/* Private typedefs ----------------------------------------------------------*/
+typedef struct {
+   const char *name;
+   uint32_t    bytesPerSec;                       /**< How fast it drains */
+   DBG_LEVEL_T minLvl;
+   uint32_t    modlMask;
+
+   uint8_t     id;
+   uint32_t    budget;                   /**< Bytes it can take right now */
+   int32_t     lastSeq;                      /**< Seq of the last record */
+   uint32_t    nEligible;               /**< Records the filter lets in */
+} SimClient_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint8_t  l_ring[RING_SIZE] __attribute__((aligned(8)));
+static uint32_t l_seed = 0x106FA000u;
+
+static SimClient_t l_clients[] = {
+   { "fast 1MB/s",   1000000, DBG, LOG_FANOUT_ALL_MODULES },
+   { "100KB/s",       100000, DBG, LOG_FANOUT_ALL_MODULES },
+   { "10KB/s",         10000, DBG, LOG_FANOUT_ALL_MODULES },
+   { "10KB/s WRN+",    10000, WRN, DBG_MODL_I2C },
+};
+#define N_CLIENTS   ( sizeof(l_clients) / sizeof(l_clients[0]) )
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static uint16_t makeRecord( uint8_t *buf, uint32_t seq, DBG_LEVEL_T *lvl,
+      uint32_t *modl )
+{
+   uint32_t r  = HT_rand( &l_seed );
+   uint16_t len = (uint16_t)(MIN_REC_LEN + r % (MAX_REC_LEN - MIN_REC_LEN + 1));
+
+   /* Mostly DBG and LOG, a few warnings and errors, from any module */
+   static const DBG_LEVEL_T lvls[16] = {
+      DBG, DBG, DBG, DBG, DBG, DBG, LOG, LOG, LOG, LOG, LOG, LOG, LOG, WRN, WRN, ERR
+   };
+   *lvl  = lvls[(r >> 8) & 0xF];
+   *modl = 1UL << ((r >> 12) % 12);
+
+   memcpy( buf, &seq, sizeof(seq) );
+   for ( uint16_t i = sizeof(seq); i < len; i++ ) {
+      buf[i] = (uint8_t)(seq + i);
+   }
+   return( len );
+}
+
+/******************************************************************************/
+static bool checkRecord( const uint8_t *rec, uint16_t len, uint32_t *pSeq )
+{
+   uint32_t seq;
+   memcpy( &seq, rec, sizeof(seq) );
+   for ( uint16_t i = sizeof(seq); i < len; i++ ) {
+      if ( rec[i] != (uint8_t)(seq + i) ) {
+         return( false );
+      }
+   }
+   *pSeq = seq;
+   return( true );
+}
+
+/******************************************************************************/
+static void drain( LogFanout_t *fan, SimClient_t *c, bool unlimited )
+{
+   const uint8_t *rec;
+   uint16_t len;
+
+   while ( NULL != (rec = LogFanout_peek( fan, c->id, &len )) ) {
+      if ( !unlimited && len > c->budget ) {
+         break;
+      }
+      uint32_t seq = 0;
+      HT_CHECK( checkRecord( rec, len, &seq ) );
+      HT_CHECK_MSG( (int32_t)seq > c->lastSeq, "%s: %u after %d", c->name,
+            seq, c->lastSeq );
+      c->lastSeq = (int32_t)seq;
+      if ( !unlimited ) {
+         c->budget -= len;
+      }
+      LogFanout_next( fan, c->id );
+   }
+}
+
+/******************************************************************************/
+static void simulate( void )
+{
+   LogFanout_t fan;
+   uint8_t rec[MAX_REC_LEN];
+   uint64_t nBytes = 0;
+
+   LogFanout_init( &fan, l_ring, sizeof(l_ring) );
+   for ( unsigned i = 0; i < N_CLIENTS; i++ ) {
+      SimClient_t *c = &l_clients[i];
+      c->id      = LogFanout_open( &fan, c );
+      c->lastSeq = -1;
+      LogFanout_setFilter( &fan, c->id, c->minLvl, c->modlMask );
+   }
+   HT_CHECK( LOG_FANOUT_NO_CLIENT == LogFanout_open( &fan, NULL ) );
+
+   for ( uint32_t ms = 0; ms < SIM_MS; ms++ ) {
+      DBG_LEVEL_T lvl;
+      uint32_t modl;
+      uint16_t len = makeRecord( rec, ms, &lvl, &modl );
+      LogFanout_write( &fan, rec, len, lvl, modl, LOG_FANOUT_ALL_CLIENTS );
+      nBytes += len;
+
+      for ( unsigned i = 0; i < N_CLIENTS; i++ ) {
+         SimClient_t *c = &l_clients[i];
+         if ( lvl >= c->minLvl && (modl & c->modlMask) ) {
+            c->nEligible++;
+         }
+
+         /* Unused budget doesn't pile up past one send buffer */
+         c->budget += c->bytesPerSec / 1000;
+         if ( c->budget > 2 * 1460 ) {
+            c->budget = 2 * 1460;
+         }
+         drain( &fan, c, false );
+      }
+   }
+
+   printf( "producer %.1f KB/s, %u records, %u evicted from a %u byte ring\n",
+         (double)nBytes / SIM_MS, fan.nWritten, fan.nEvicted, RING_SIZE );
+
+   for ( unsigned i = 0; i < N_CLIENTS; i++ ) {
+      SimClient_t *c = &l_clients[i];
+      LogFanoutClient_t *fc = &fan.clients[c->id];
+
+      /* Whatever the client would still get if it kept reading */
+      uint32_t nSentBefore = fc->nSent;
+      drain( &fan, c, true );
+      uint32_t nQueued = fc->nSent - nSentBefore;
+
+      printf( "  %-12s sent %5u  dropped %5u  filtered %5u  queued %3u"
+            "  (of %u wanted)\n", c->name, nSentBefore, fc->nDropped,
+            fc->nFiltered, nQueued, c->nEligible );
+      HT_CHECK( fc->nSent + fc->nDropped + fc->nFiltered == fan.nWritten );
+      HT_CHECK( fc->nSent + fc->nDropped == c->nEligible );
+   }
+
+   /* The fast client keeps up, and the filtered slow one gets all it wants */
+   HT_CHECK( 0 == fan.clients[l_clients[0].id].nDropped );
+   HT_CHECK( 0 == fan.clients[l_clients[3].id].nDropped );
+}
+
+/******************************************************************************/
+static void timing( void )
+{
+   LogFanout_t fan;
+   uint8_t rec[MAX_REC_LEN];
+   DBG_LEVEL_T lvl;
+   uint32_t modl;
+   uint16_t len = makeRecord( rec, 0, &lvl, &modl );
+
+   /* Nobody reads, so every write evicts */
+   LogFanout_init( &fan, l_ring, sizeof(l_ring) );
+   for ( unsigned i = 0; i < N_CLIENTS; i++ ) {
+      LogFanout_open( &fan, NULL );
+   }
+   uint64_t t0 = HT_nowNs();
+   for ( uint32_t i = 0; i < TIMED_WRITES; i++ ) {
+      LogFanout_write( &fan, rec, len, LOG, DBG_MODL_ETH, LOG_FANOUT_ALL_CLIENTS );
+   }
+   double evictNs = (double)(HT_nowNs() - t0) / TIMED_WRITES;
+
+   /* Every client reads every record right away */
+   LogFanout_init( &fan, l_ring, sizeof(l_ring) );
+   for ( unsigned i = 0; i < N_CLIENTS; i++ ) {
+      LogFanout_open( &fan, NULL );
+   }
+   t0 = HT_nowNs();
+   for ( uint32_t i = 0; i < TIMED_WRITES; i++ ) {
+      LogFanout_write( &fan, rec, len, LOG, DBG_MODL_ETH, LOG_FANOUT_ALL_CLIENTS );
+      for ( uint8_t id = 0; id < N_CLIENTS; id++ ) {
+         uint16_t n;
+         if ( NULL != LogFanout_peek( &fan, id, &n ) ) {
+            LogFanout_next( &fan, id );
+         }
+      }
+   }
+   double drainNs = (double)(HT_nowNs() - t0) / TIMED_WRITES;
+
+   printf( "%.1f ns per write when evicting, %.1f ns per write plus a drain"
+         " of %u clients\n", evictNs, drainNs, (unsigned)N_CLIENTS );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   simulate();
+   timing();
+   return( HT_DONE( "log_fanout_bench" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
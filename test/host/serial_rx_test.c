@@ -0,0 +1,516 @@
+/**
+ * @file   serial_rx_test.c
+ * @brief  Host test of the serial receive line assembler on a fake RX DMA.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The fake DMA writes into the ring and counts NDTR down the way DMA2
+ * Stream5 does in circular mode, raising the half and full transfer
+ * interrupts as it goes.  Those run a few bytes late, the way they do when
+ * another interrupt is in the way, so lines get split across the end of
+ * the ring both before and after they are consumed.  The test raises the USART IDLE interrupt whenever
+ * the sender pauses.  All three run what Serial_RxProcess() runs, and the
+ * line handler routes lines the way Serial_UART1LineHandler() does, so
+ * base64 lines go through the real CommFrame_feedBase64().  serial.c itself
+ * needs the ST peripherals so those two are copied here.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "serial_rx.h"
+#include "comm_frame.h"
+#include "base64_stream.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define RING_SIZE               256   /**< UART1_RX_DMA_BUF_LEN in serial.c */
+#define MAX_PAYLOAD             291          /**< COMM_FRAME_MAX_PAYLOAD */
+#define LINE_MAX                                                              \
+   (B64S_ENCODED_LEN(MAX_PAYLOAD + COMM_FRAME_OVERHEAD) + 1)
+#define OUT_MAX                 (512 * 1024)
+
+#define FRAME_PREFIX            "pV"        /**< SERIAL_B64_FRAME_PREFIX */
+#define FRAME_PREFIX_LEN        2
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t l_seed = 0x5E41A1u;
+
+/**< The ring, the DMA that fills it and the interrupts it raises */
+static struct {
+   uint8_t  ring[RING_SIZE];
+   uint16_t ndtr;                   /**< Bytes left until the DMA wraps */
+   int      maxLatency;     /**< Most bytes that arrive before an ISR runs */
+   int      nUntilIsr;  /**< Bytes until the pending DMA ISR runs, or -1 */
+   int      nHt;
+   int      nTc;
+   int      nIdle;
+   int      nLate;      /**< Interrupts that left a finished line behind */
+   int      nWrapped;              /**< Lines that straddled the ring end */
+} l_dma;
+
+static SerialRxParser_t l_parser;
+static char             l_line[LINE_MAX];
+
+/**< What should come out, and what did */
+static struct {
+   char     exp[OUT_MAX];
+   int      expLen;           /**< Finished lines sent so far, CRs removed */
+   char     out[OUT_MAX];
+   int      outLen;
+   int      nMenu;
+} l_text;
+
+static CommFrameParser_t l_frame;
+static B64S_DecState     l_frameB64;
+static uint8_t           l_frameBuf[MAX_PAYLOAD];
+
+static struct {
+   bool     isExpected[1024];          /**< Sent whole and uncorrupted */
+   uint8_t  seen[1024];
+   int      nFrames;
+   int      nBogus;
+} l_rx;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+static void lineHandler( const char *line, uint16_t len )
+{
+   HT_CHECK( len > 0 && '\n' == line[len - 1] );
+
+   if ( len > FRAME_PREFIX_LEN &&
+         0 == memcmp( line, FRAME_PREFIX, FRAME_PREFIX_LEN ) ) {
+      B64S_decodeInit( &l_frameB64 );
+      CommFrame_feedBase64( &l_frame, &l_frameB64, line, len );
+      CommFrame_reset( &l_frame );
+      return;
+   }
+
+   HT_CHECK( l_text.outLen + len <= OUT_MAX );
+   memcpy( &l_text.out[l_text.outLen], line, len );
+   l_text.outLen += len;
+   l_text.nMenu++;
+}
+
+/******************************************************************************/
+static uint8_t* getBuffer( void *ctx, const CommFrameHdr_t *hdr )
+{
+   (void)ctx; (void)hdr;
+   return( l_frameBuf );
+}
+
+/******************************************************************************/
+static void frameHandler( void *ctx, const CommFrameHdr_t *hdr,
+      uint8_t *payload, bool isValid )
+{
+   (void)ctx;
+   if ( !isValid ) {
+      return;
+   }
+
+   bool isReal = ( 0x42 == hdr->type && hdr->seq < sizeof(l_rx.seen) );
+   for ( int k = 0; k < hdr->len && isReal; k++ ) {
+      isReal = ( payload[k] == (uint8_t)(hdr->seq * 7 + k) );
+   }
+   if ( isReal ) {
+      l_rx.seen[hdr->seq]++;
+      l_rx.nFrames++;
+   } else {
+      l_rx.nBogus++;
+   }
+}
+
+/******************************************************************************/
+static void rxProcess( void )
+{
+   /* Same as Serial_RxProcess() */
+   uint16_t writePos = (uint16_t)(RING_SIZE - l_dma.ndtr);
+   SerialRx_process( &l_parser, writePos );
+
+   /* Every line that ended before now has to be out already */
+   if ( l_text.outLen != l_text.expLen ) {
+      l_dma.nLate++;
+   }
+}
+
+/******************************************************************************/
+static void uartIdle( void )
+{
+   l_dma.nIdle++;
+   l_dma.nUntilIsr = -1;               /* A pending DMA ISR finds nothing */
+   rxProcess();
+}
+
+/******************************************************************************/
+static void dmaEvent( void )
+{
+   /* The ISR runs a few bytes late, and by then the DMA has moved on and may
+    * have wrapped.  A second event while one is pending is the same ISR. */
+   if ( l_dma.nUntilIsr < 0 ) {
+      l_dma.nUntilIsr = (int)(HT_rand( &l_seed ) % (l_dma.maxLatency + 1));
+   }
+}
+
+/******************************************************************************/
+static void uartRx( uint8_t c )
+{
+   l_dma.ring[RING_SIZE - l_dma.ndtr] = c;
+   l_dma.ndtr--;
+   if ( RING_SIZE / 2 == l_dma.ndtr ) {
+      l_dma.nHt++;
+      dmaEvent();
+   }
+   if ( 0 == l_dma.ndtr ) {
+      l_dma.ndtr = RING_SIZE;                /* Circular mode reloads NDTR */
+      l_dma.nTc++;
+      dmaEvent();
+   }
+   if ( 0 == l_dma.nUntilIsr ) {
+      rxProcess();
+   }
+   if ( l_dma.nUntilIsr >= 0 ) {
+      l_dma.nUntilIsr--;
+   }
+}
+
+/**
+ * @brief   Send one line and note what the handler should get for it.
+ * @param [in] *text: const char pointer to the line, without its end.
+ * @param [in] len: int length of the text.
+ * @param [in] nSent: int bytes of the text that were already sent.
+ * @param [in] isCrLf: bool true to end it with "\r\n", else "\n".
+ * @param [in] isMenu: bool true if it should come out as a text line.
+ * @return: None
+ */
+static void sendRest( const char *text, int len, int nSent, bool isCrLf,
+      bool isMenu )
+{
+   uint16_t start = (uint16_t)(RING_SIZE - l_dma.ndtr);
+
+   /* The expected output goes in first since the '\n' may be handled before
+    * this returns */
+   int nKept = 0;
+   if ( isMenu ) {
+      for ( int i = 0; i < len; i++ ) {
+         if ( '\r' != text[i] ) {
+            l_text.exp[l_text.expLen + nKept++] = text[i];
+         }
+      }
+   }
+
+   for ( int i = nSent; i < len; i++ ) {
+      uartRx( (uint8_t)text[i] );
+   }
+   if ( isCrLf ) {
+      uartRx( '\r' );
+   }
+   if ( nKept > 0 ) {
+      l_text.exp[l_text.expLen + nKept++] = '\n';
+      l_text.expLen += nKept;
+   }
+   uartRx( '\n' );
+
+   if ( (uint16_t)(RING_SIZE - l_dma.ndtr) < start ) {
+      l_dma.nWrapped++;
+   }
+}
+
+/******************************************************************************/
+static void sendLine( const char *text, int len, bool isCrLf, bool isMenu )
+{
+   sendRest( text, len, 0, isCrLf, isMenu );
+}
+
+/******************************************************************************/
+static void start( void )
+{
+   memset( &l_dma, 0, sizeof(l_dma) );
+   memset( &l_text, 0, sizeof(l_text) );
+   memset( &l_rx, 0, sizeof(l_rx) );
+   l_dma.ndtr       = RING_SIZE;
+   l_dma.maxLatency = 8;
+   l_dma.nUntilIsr  = -1;
+   SerialRx_init( &l_parser, l_dma.ring, RING_SIZE, l_line, LINE_MAX,
+         lineHandler );
+   CommFrame_init( &l_frame, MAX_PAYLOAD, getBuffer, frameHandler, NULL );
+}
+
+/******************************************************************************/
+static void randomText( char *text, int len )
+{
+   for ( int i = 0; i < len; i++ ) {
+      text[i] = (char)('!' + HT_rand( &l_seed ) % 90);
+   }
+   if ( 'p' == text[0] ) {
+      text[0] = 'q';                /* Never looks like the start of a frame */
+   }
+}
+
+/******************************************************************************/
+static bool outMatches( void )
+{
+   return( l_text.outLen == l_text.expLen &&
+         0 == memcmp( l_text.out, l_text.exp, (size_t)l_text.expLen ) );
+}
+
+/******************************************************************************/
+static void test_wrap( void )
+{
+   char text[LINE_MAX];
+   uint32_t nSent = 0;
+
+   /* Lines of every length in bursts that stop on line ends and in the
+    * middle of lines, so plenty of them straddle the end of the ring */
+   start();
+   for ( int n = 0; n < 3000; n++ ) {
+      int len = 1 + (int)(HT_rand( &l_seed ) % 150);
+      bool isCrLf = ( 0 == HT_rand( &l_seed ) % 2 );
+      randomText( text, len );
+
+      int split = (int)(HT_rand( &l_seed ) % (len + 1));
+      if ( 0 == HT_rand( &l_seed ) % 4 ) {
+         /* Pause in the middle of the line, which must not finish it */
+         for ( int i = 0; i < split; i++ ) {
+            uartRx( (uint8_t)text[i] );
+         }
+         uartIdle();
+         HT_CHECK( l_text.outLen == l_text.expLen );
+         sendRest( text, len, split, isCrLf, true );
+      } else {
+         sendLine( text, len, isCrLf, true );
+      }
+      nSent += (uint32_t)(len + 1 + isCrLf);
+
+      if ( 0 == HT_rand( &l_seed ) % 3 ) {
+         uartIdle();
+      }
+   }
+   uartIdle();
+
+   HT_CHECK( outMatches() );
+   HT_CHECK( 3000 == l_text.nMenu && 3000 == l_parser.nLines );
+   HT_CHECK( nSent == l_parser.nBytes && 0 == l_parser.nOverflows );
+   HT_CHECK( 0 == l_dma.nLate );
+   HT_CHECK_MSG( l_dma.nWrapped > 100, "only %d lines wrapped",
+         l_dma.nWrapped );
+}
+
+/******************************************************************************/
+static void test_triggers( void )
+{
+   char text[LINE_MAX];
+   uint32_t nSent = 0;
+
+   /* A sender that never pauses.  The half and full transfer interrupts
+    * alone have to keep every line moving. */
+   start();
+   for ( int n = 0; n < 500; n++ ) {
+      int len = 1 + (int)(HT_rand( &l_seed ) % 200);
+      randomText( text, len );
+      sendLine( text, len, false, true );
+      nSent += (uint32_t)(len + 1);
+   }
+   HT_CHECK( 0 == l_dma.nIdle && 0 == l_dma.nLate );
+   HT_CHECK( (int)(nSent / RING_SIZE) == l_dma.nTc );
+   HT_CHECK( l_dma.nHt == l_dma.nTc || l_dma.nHt == l_dma.nTc + 1 );
+
+   /* Whatever came after the last of them waits for the line to go idle */
+   uartIdle();
+   HT_CHECK( outMatches() && 500 == l_text.nMenu );
+
+   /* NDTR has already reloaded when the full transfer interrupt runs, so
+    * the write position is back at the start of the ring.  A write position
+    * right at the end of the ring means the same thing. */
+   start();
+   l_dma.maxLatency = 0;
+   memset( text, 'x', RING_SIZE - 1 );
+   sendLine( text, RING_SIZE - 1, false, true );
+   HT_CHECK( 1 == l_dma.nHt && 1 == l_dma.nTc && RING_SIZE == l_dma.ndtr );
+   HT_CHECK( 0 == l_parser.ringPos && outMatches() );
+   HT_CHECK( 0 == SerialRx_process( &l_parser, RING_SIZE ) );
+
+   /* A short line that doesn't reach the next half waits for the idle */
+   sendLine( "abc", 3, false, true );
+   HT_CHECK( l_text.outLen < l_text.expLen );
+   uartIdle();
+   HT_CHECK( outMatches() && 0 == l_dma.nLate );
+}
+
+/******************************************************************************/
+static void test_overflow( void )
+{
+   char text[3 * RING_SIZE];
+
+   /* The longest line that fits, and one byte more */
+   start();
+   memset( text, 'a', sizeof(text) );
+   sendLine( text, LINE_MAX - 1, true, true );
+   uartIdle();
+   HT_CHECK( outMatches() && 0 == l_parser.nOverflows );
+   HT_CHECK( 1 == l_text.nMenu && LINE_MAX == l_text.outLen );
+
+   sendLine( text, LINE_MAX, true, false );
+   uartIdle();
+   HT_CHECK( 1 == l_parser.nOverflows && outMatches() );
+
+   /* A line longer than the ring, with carriage returns in it, and the next
+    * line has to come through whole */
+   for ( int i = 0; i < (int)sizeof(text); i += 37 ) {
+      text[i] = '\r';
+   }
+   sendLine( text, sizeof(text), true, false );
+   sendLine( "ok", 2, true, true );
+   uartIdle();
+   HT_CHECK( 2 == l_parser.nOverflows && outMatches() );
+   HT_CHECK( 2 == l_text.nMenu );
+
+   /* The end of an overflowed line in a later burst */
+   memset( text, 'b', sizeof(text) );
+   for ( int i = 0; i < LINE_MAX + 10; i++ ) {
+      uartRx( (uint8_t)text[i] );
+   }
+   uartIdle();
+   HT_CHECK( 3 == l_parser.nOverflows && l_parser.isDiscarding );
+   sendLine( "still the long one", 18, false, false );
+   sendLine( "next", 4, false, true );
+   uartIdle();
+   HT_CHECK( !l_parser.isDiscarding && outMatches() );
+   HT_CHECK( 3 == l_text.nMenu && 3 == l_parser.nOverflows );
+   HT_CHECK( 0 == l_dma.nLate );
+}
+
+/******************************************************************************/
+static void test_carriageReturns( void )
+{
+   /* Carriage returns are dropped wherever they are and lines left empty
+    * are not lines at all */
+   start();
+   sendLine( "a\rb", 3, true, true );
+   sendLine( "\r\r", 2, true, false );
+   sendLine( "", 0, true, false );
+   sendLine( "", 0, false, false );
+   sendLine( "\rcd\r", 4, false, true );
+   uartIdle();
+   HT_CHECK( outMatches() && 2 == l_text.nMenu );
+   HT_CHECK( 0 == memcmp( l_text.out, "ab\ncd\n", 6 ) );
+   HT_CHECK( 2 == l_parser.nLines && 0 == l_dma.nLate );
+}
+
+/**
+ * @brief   Encode a real frame as one base64 line.
+ * @param [out] *text: char pointer to LINE_MAX bytes.
+ * @param [in] seq: uint16_t seq of the frame.
+ * @param [in] len: uint16_t payload length.
+ * @return: int number of characters, without the line end.
+ */
+static int frameLine( char *text, uint16_t seq, uint16_t len )
+{
+   uint8_t payload[MAX_PAYLOAD];
+   uint8_t frame[MAX_PAYLOAD + COMM_FRAME_OVERHEAD];
+   B64S_EncState enc;
+   int consumed;
+
+   for ( int k = 0; k < len; k++ ) {
+      payload[k] = (uint8_t)(seq * 7 + k);
+   }
+   uint16_t n = CommFrame_encode( frame, sizeof(frame), 0x42, seq, payload,
+         len );
+   B64S_encodeInit( &enc );
+   int nText = B64S_encodeChunk( &enc, frame, n, text, LINE_MAX, &consumed );
+   nText += B64S_encodeFinal( &enc, &text[nText] );
+   return( nText );
+}
+
+/******************************************************************************/
+static void test_base64Frames( void )
+{
+   char text[LINE_MAX];
+   int nReal = 0, nCorrupt = 0, nMenu = 0;
+
+   start();
+   HT_CHECK( LINE_MAX - 1 == frameLine( text, 0, MAX_PAYLOAD ) );
+   HT_CHECK( 0 == memcmp( text, FRAME_PREFIX, FRAME_PREFIX_LEN ) );
+
+   for ( uint16_t seq = 0; seq < 1000; seq++ ) {
+      uint32_t r = HT_rand( &l_seed );
+      uint16_t len = ( 0 == r % 10 ) ? MAX_PAYLOAD
+            : (uint16_t)(r % (MAX_PAYLOAD + 1));
+      int n = frameLine( text, seq, len );
+      uint32_t kind = (r >> 8) % 8;
+      if ( 0 == kind && len < 6 ) {
+         kind = 2;                        /* Nothing past the header to hit */
+      }
+
+      switch ( kind ) {
+         case 0: {
+            /* A character past the header changed, which the crc catches.
+             * The last few are left alone since they may be padding. */
+            int i = 12 + (int)((r >> 12) % (uint32_t)(n - 15));
+            text[i] = ( 'A' == text[i] ) ? 'B' : 'A';
+            nCorrupt++;
+            break;
+         }
+         case 1:
+            /* Cut short.  The rest of it must not spill into the next. */
+            n = FRAME_PREFIX_LEN + 1 + (int)((r >> 12) % (n / 2));
+            break;
+         default:
+            nReal++;
+            l_rx.isExpected[seq] = true;
+            break;
+      }
+      sendLine( text, n, 0 == (r & 0x10000), false );
+
+      if ( 0 == (r >> 20) % 3 ) {
+         sendLine( "help", 4, true, true );
+         nMenu++;
+      }
+      if ( 0 == (r >> 24) % 2 ) {
+         uartIdle();
+      }
+   }
+   uartIdle();
+
+   int nMissing = 0;
+   for ( int i = 0; i < 1000; i++ ) {
+      nMissing += ( l_rx.isExpected[i] != ( 1 == l_rx.seen[i] ) );
+   }
+   HT_CHECK_MSG( 0 == nMissing, "%d of %d frames lost", nMissing, nReal );
+   HT_CHECK( nReal == l_rx.nFrames && 0 == l_rx.nBogus );
+   HT_CHECK( (uint32_t)nCorrupt == l_frame.nCrcErrors );
+   HT_CHECK( nMenu == l_text.nMenu && outMatches() );
+   HT_CHECK( 0 == l_parser.nOverflows && 0 == l_dma.nLate );
+
+   /* Starts like a frame but isn't base64 */
+   uint32_t nSkipped = l_frame.nSkipped;
+   sendLine( "pV!!", 4, true, false );
+   uartIdle();
+   HT_CHECK( l_frame.nSkipped > nSkipped && nReal == l_rx.nFrames );
+   sendLine( text, frameLine( text, 1000, 8 ), true, false );
+   uartIdle();
+   HT_CHECK( nReal + 1 == l_rx.nFrames );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_wrap();
+   test_triggers();
+   test_overflow();
+   test_carriageReturns();
+   test_base64Frames();
+   return( HT_DONE( "serial_rx_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
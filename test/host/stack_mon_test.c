@@ -0,0 +1,354 @@
+/**
+ * @file   stack_mon_test.c
+ * @brief  Host test of the task stack high-water monitor.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * stack_mon.c is built against stub/FreeRTOS.h and stub/task.h.  The task
+ * handles are fake tasks that say how many words of their stack still hold
+ * the fill byte, and the test moves the tick count:
+ *
+ * - The deepest use of a stack only ever goes up, whatever order the samples
+ *   come in, and never goes past the configured size.
+ * - The recommended size is the deepest use plus STK_MON_MARGIN_PCT, rounded
+ *   up to STK_MON_ROUND_BYTES and never below STK_MON_MIN_BYTES, for every use
+ *   a stack can have.
+ * - STK_MON_poll() looks at one attached task per call and at all of them
+ *   once per STK_MON_PERIOD_MS, across the wrap of the tick count.
+ * - STK_MON_retire() samples the calling task, through a NULL handle, and
+ *   nothing looks at that task after it.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_test.h"
+#include "stack_mon.h"
+#include <string.h>
+
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct FakeTask_t
+ * What a task handle points at on the host.
+ */
+typedef struct FakeTasks
+{
+   UBaseType_t freeWords;           /**< Words that still hold the fill byte */
+} FakeTask_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define N_TASKS                 5
+#define MAX_QUERIES             64
+#define WORD                    ( (uint32_t)sizeof(StackType_t) )
+
+/* Private variables and Local objects ---------------------------------------*/
+static StackCfg_t l_cfg[STK_MON_MAX_TASKS + 2] = {
+      { "SerialMgr",  2048 },
+      { "LWIPMgr",    4096 },
+      { "notCreated", 1024 },
+      { "CPLR",       3072 },
+      { "DbgMgr",     1536 },
+};
+
+static FakeTask_t   l_tasks[N_TASKS];
+static FakeTask_t  *l_current;               /**< The task that's running */
+static TickType_t   l_tick;
+static TaskHandle_t l_queried[MAX_QUERIES];     /**< Handles asked about */
+static int          l_nQueries;
+
+/* Private functions ---------------------------------------------------------*/
+
+/******************************************************************************/
+TickType_t xTaskGetTickCount( void )
+{
+   return( l_tick );
+}
+
+/******************************************************************************/
+UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+{
+   if ( l_nQueries < MAX_QUERIES ) {
+      l_queried[l_nQueries] = xTask;
+   }
+   l_nQueries++;
+
+   FakeTask_t *task = ( NULL == xTask ) ? l_current : (FakeTask_t *)xTask;
+   HT_CHECK( NULL != task );
+   return( NULL == task ? 0 : task->freeWords );
+}
+
+/******************************************************************************/
+static void setUsed( int idx, uint32_t used )
+{
+   l_tasks[idx].freeWords = ( l_cfg[idx].size - used ) / WORD;
+}
+
+/******************************************************************************/
+static StackInfo_t info( uint8_t idx )
+{
+   StackInfo_t i;
+   memset( &i, 0xA5, sizeof(i) );
+   HT_CHECK( STK_MON_getInfo( idx, &i ) );
+   return( i );
+}
+
+/******************************************************************************/
+static void startAll( uint8_t nTasks )
+{
+   memset( l_tasks, 0, sizeof(l_tasks) );
+   for ( int i = 0; i < N_TASKS; i++ ) {
+      setUsed( i, 0 );
+   }
+   l_tick = 0;
+   l_current = NULL;
+   l_nQueries = 0;
+
+   STK_MON_init( l_cfg, nTasks );
+   for ( uint8_t i = 0; i < N_TASKS; i++ ) {
+      if ( 2 != i ) {                        /* One that never got created */
+         STK_MON_attach( i, &l_tasks[i] );
+      }
+   }
+}
+
+/**
+ * @brief   Samples in any order only ever raise the deepest use.
+ * @param   None
+ * @return: None
+ */
+static void test_deepest( void )
+{
+   uint32_t seed = 0x57AC;
+   uint32_t deepest[N_TASKS] = { 0 };
+
+   startAll( N_TASKS );
+   for ( int i = 0; i < N_TASKS; i++ ) {
+      StackInfo_t si = info( (uint8_t)i );
+      HT_CHECK( 0 == strcmp( l_cfg[i].name, si.name ) );
+      HT_CHECK( l_cfg[i].size == si.size );
+      HT_CHECK( 0 == si.used && 0 == si.recommended );
+      HT_CHECK( ( 2 != i ) == si.bRunning );
+   }
+
+   for ( int n = 0; n < 2000; n++ ) {
+      int idx = (int)( HT_rand( &seed ) % N_TASKS );
+      uint32_t used = HT_rand( &seed ) % ( l_cfg[idx].size / WORD + 1 ) * WORD;
+      setUsed( idx, used );
+      if ( 2 != idx && used > deepest[idx] ) {
+         deepest[idx] = used;
+      }
+
+      if ( HT_rand( &seed ) & 1 ) {
+         STK_MON_sampleAll();
+      } else {
+         l_tick += STK_MON_PERIOD_MS;
+         for ( int k = 0; k < N_TASKS; k++ ) {
+            STK_MON_poll();
+         }
+      }
+
+      for ( int i = 0; i < N_TASKS; i++ ) {
+         HT_CHECK_MSG( deepest[i] == info( (uint8_t)i ).used,
+               "%d: task %d used %u, deepest %u", n, i,
+               info( (uint8_t)i ).used, deepest[i] );
+         HT_CHECK( deepest[i] == STK_MON_getUsed( (uint32_t)i ) );
+      }
+   }
+
+   /* A high-water mark past the configured size counts as nothing used */
+   startAll( N_TASKS );
+   l_tasks[0].freeWords = l_cfg[0].size / WORD + 10;
+   STK_MON_sampleAll();
+   HT_CHECK( 0 == info( 0 ).used );
+}
+
+/**
+ * @brief   The recommended size for every use a stack can have.
+ * @param   None
+ * @return: None
+ */
+static void test_recommend( void )
+{
+   HT_CHECK( 1024 == STK_MON_MIN_BYTES );
+
+   for ( uint32_t used = 1; used <= 0xFFFF; used++ ) {
+      l_cfg[0].size = (uint16_t)used;            /* Every byte of it used */
+      STK_MON_init( l_cfg, 1 );
+      STK_MON_attach( 0, &l_tasks[0] );
+      l_tasks[0].freeWords = 0;
+      STK_MON_sampleAll();
+
+      StackInfo_t si = info( 0 );
+      HT_CHECK( used == si.used );
+
+      /* The margin is rounded up to a whole byte, then to 64 */
+      uint32_t withMargin = used + ( used * STK_MON_MARGIN_PCT + 99 ) / 100;
+      HT_CHECK( withMargin * 100 >= used * ( 100 + STK_MON_MARGIN_PCT ) );
+      uint32_t rec = withMargin;
+      if ( 0 != rec % STK_MON_ROUND_BYTES ) {
+         rec += STK_MON_ROUND_BYTES - rec % STK_MON_ROUND_BYTES;
+      }
+      if ( rec < STK_MON_MIN_BYTES ) {
+         rec = STK_MON_MIN_BYTES;
+      }
+      if ( rec > 0xFFFF ) {
+         rec = 0xFFFF;
+      }
+      HT_CHECK_MSG( rec == si.recommended, "used %u: recommended %u, not %u",
+            used, si.recommended, rec );
+      HT_CHECK( si.recommended >= used );
+   }
+
+   /* A few worked out by hand */
+   static const struct {
+      uint16_t used;
+      uint16_t recommended;
+   } cases[] = {
+      { 1,     1024 },                  /* The floor */
+      { 819,   1024 },                  /* 1023.75 -> 1024 */
+      { 820,   1088 },                  /* 1025, just past the floor */
+      { 1000,  1280 },                  /* 1250 */
+      { 1024,  1280 },                  /* 1280 exactly */
+      { 1025,  1344 },                  /* 1281.25 */
+      { 2048,  2560 },
+      { 52000, 65024 },                 /* 65000 */
+      { 52400, 0xFFFF },                /* 65500 rounds past 16 bits */
+      { 0xFFFF, 0xFFFF },
+   };
+   for ( int i = 0; i < (int)( sizeof(cases) / sizeof(cases[0]) ); i++ ) {
+      l_cfg[0].size = cases[i].used;
+      STK_MON_init( l_cfg, 1 );
+      STK_MON_attach( 0, &l_tasks[0] );
+      l_tasks[0].freeWords = 0;
+      STK_MON_sampleAll();
+      HT_CHECK_MSG( cases[i].recommended == info( 0 ).recommended,
+            "used %u: recommended %u", cases[i].used, info( 0 ).recommended );
+   }
+   l_cfg[0].size = 2048;
+}
+
+/**
+ * @brief   One task per poll, one sweep per period, across the tick wrap.
+ * @param   None
+ * @return: None
+ */
+static void test_poll( void )
+{
+   startAll( N_TASKS );
+
+   /* The first sweep starts right away, skipping the task not created */
+   for ( int i = 0; i < N_TASKS; i++ ) {
+      STK_MON_poll();
+   }
+   HT_CHECK( 4 == l_nQueries );
+   HT_CHECK( &l_tasks[0] == l_queried[0] && &l_tasks[1] == l_queried[1] &&
+         &l_tasks[3] == l_queried[2] && &l_tasks[4] == l_queried[3] );
+
+   /* Then nothing until the period is up */
+   l_tick = STK_MON_PERIOD_MS / portTICK_PERIOD_MS - 1;
+   for ( int i = 0; i < 3 * N_TASKS; i++ ) {
+      STK_MON_poll();
+   }
+   HT_CHECK( 4 == l_nQueries );
+
+   l_tick++;
+   STK_MON_poll();
+   HT_CHECK( 5 == l_nQueries && &l_tasks[0] == l_queried[4] );
+
+   for ( int i = 0; i < N_TASKS - 1; i++ ) {
+      STK_MON_poll();
+   }
+   HT_CHECK( 8 == l_nQueries );
+
+   /* A sweep started just before the tick count wraps */
+   l_tick = (TickType_t)0 - 10;
+   for ( int i = 0; i < N_TASKS; i++ ) {
+      STK_MON_poll();
+   }
+   HT_CHECK( 12 == l_nQueries && &l_tasks[0] == l_queried[8] );
+   l_tick = STK_MON_PERIOD_MS / portTICK_PERIOD_MS - 11;
+   STK_MON_poll();
+   HT_CHECK( 12 == l_nQueries );
+   l_tick++;
+   STK_MON_poll();
+   HT_CHECK( 13 == l_nQueries && &l_tasks[0] == l_queried[12] );
+
+   /* Only up to STK_MON_MAX_TASKS of a table are watched */
+   STK_MON_init( l_cfg, STK_MON_MAX_TASKS + 2 );
+   HT_CHECK( STK_MON_MAX_TASKS == STK_MON_getNTasks() );
+   StackInfo_t si;
+   HT_CHECK( !STK_MON_getInfo( STK_MON_MAX_TASKS, &si ) );
+   HT_CHECK( 0 == STK_MON_getUsed( STK_MON_MAX_TASKS ) );
+   STK_MON_attach( STK_MON_MAX_TASKS, &l_tasks[0] );
+   l_nQueries = 0;
+   STK_MON_sampleAll();
+   HT_CHECK( 0 == l_nQueries );
+}
+
+/**
+ * @brief   A task retiring itself is sampled through a NULL handle.
+ * @param   None
+ * @return: None
+ */
+static void test_retire( void )
+{
+   startAll( N_TASKS );
+   setUsed( 3, 1000 );
+   STK_MON_sampleAll();
+   HT_CHECK( 1000 == info( 3 ).used );
+
+   /* It goes deeper on its way out, after the last sample by the idle task */
+   setUsed( 3, 1800 );
+   l_current = &l_tasks[3];
+   l_nQueries = 0;
+   STK_MON_retire( 3 );
+   HT_CHECK( 1 == l_nQueries && NULL == l_queried[0] );
+   HT_CHECK( 1800 == info( 3 ).used );
+   HT_CHECK( !info( 3 ).bRunning );
+   HT_CHECK( 2304 == info( 3 ).recommended );        /* 2250 rounded up */
+
+   /* Gone now: nothing asks about it and its deepest use stays */
+   l_current = NULL;
+   setUsed( 3, 3000 );
+   l_nQueries = 0;
+   for ( int n = 0; n < 3; n++ ) {
+      l_tick += STK_MON_PERIOD_MS;
+      for ( int i = 0; i < N_TASKS; i++ ) {
+         STK_MON_poll();
+      }
+      STK_MON_sampleAll();
+   }
+   HT_CHECK( 3 * 2 * 3 == l_nQueries );
+   for ( int i = 0; i < l_nQueries && i < MAX_QUERIES; i++ ) {
+      HT_CHECK( &l_tasks[3] != l_queried[i] && NULL != l_queried[i] );
+   }
+   HT_CHECK( 1800 == info( 3 ).used );
+
+   /* Out of range does nothing */
+   l_nQueries = 0;
+   STK_MON_retire( N_TASKS );
+   STK_MON_retire( 0xFF );
+   HT_CHECK( 0 == l_nQueries );
+}
+
+/******************************************************************************/
+int main( void )
+{
+   test_deepest();
+   test_recommend();
+   test_poll();
+   test_retire();
+   return( HT_DONE( "stack_mon_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,67 @@
+/**
+ * @file   FreeRTOS.h
+ * @brief  Host stand-in for the FreeRTOS master include.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Just the types, config and port macros the QF port and the tickless idle
+ * use.  There is a single thread and no interrupts on the host, so the
+ * critical sections do nothing.  The task calls they make are declared in
+ * task.h and provided by each test.
+ *
+ * A test that needs the firmware's own FreeRTOSConfig.h forces it in with
+ * -include and gets its config in place of the one here.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FREERTOS_H_
+#define FREERTOS_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported defines ----------------------------------------------------------*/
+#define pdFALSE                                     ( (BaseType_t)0 )
+#define pdTRUE                                      ( (BaseType_t)1 )
+#define pdPASS                                              ( pdTRUE )
+#define tskIDLE_PRIORITY                           ( (UBaseType_t)0U )
+
+#ifndef FREERTOS_CONFIG_H
+#define configUSE_TICKLESS_IDLE                                     1
+#define configUSE_IDLE_HOOK                                         1
+#define configUSE_TICK_HOOK                                         1
+#define configCHECK_FOR_STACK_OVERFLOW                              0
+#define configMINIMAL_STACK_SIZE                 ( ( unsigned short ) 256 )
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY                5
+#endif                                                  /* FREERTOS_CONFIG_H */
+
+/* Exported macros -----------------------------------------------------------*/
+#define portSET_INTERRUPT_MASK_FROM_ISR()                          0U
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x_ )              ((void)(x_))
+#define portDISABLE_INTERRUPTS()                             ((void)0)
+#define portENABLE_INTERRUPTS()                              ((void)0)
+#define portTICK_PERIOD_MS                                 ( (TickType_t)1 )
+
+/* Exported types ------------------------------------------------------------*/
+typedef uint32_t      TickType_t;
+typedef long          BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t      StackType_t;
+typedef void *        TaskHandle_t;
+
+#define portBASE_TYPE                                            long
+#define portSTACK_TYPE                                    StackType_t
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                         /* FREERTOS_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
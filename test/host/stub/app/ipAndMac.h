@@ -0,0 +1,33 @@
+/**
+ * @file   ipAndMac.h
+ * @brief  Host stand-in for the addresses the firmware build generates for
+ * each board.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The default IP address the settings DB starts out with.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef IPANDMAC_H_
+#define IPANDMAC_H_
+
+/* Exported defines ----------------------------------------------------------*/
+#define STATIC_IPADDR0 172
+#define STATIC_IPADDR1 27
+#define STATIC_IPADDR2 0
+#define STATIC_IPADDR3 75
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                       /* IPANDMAC_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
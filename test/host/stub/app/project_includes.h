@@ -0,0 +1,57 @@
+/**
+ * @file   project_includes.h
+ * @brief  Host stand-in for the project wide includes, for application
+ * modules built against the real QP headers.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Pulls in the same shared declarations the real one does but leaves out
+ * the console, whose output macros do nothing here.  ERR_COND_OUTPUT() still
+ * evaluates its arguments since those look things up that can fail.  MEM_DataCopy() has to
+ * be provided by the program.  Put this directory ahead of stub/ on the
+ * quote include path.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PROJECT_INCLUDES_H_
+#define PROJECT_INCLUDES_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "mem_datacopy.h"      /* Very fast STM32 specific MEMCPY declaration */
+#include "CBSignals.h"                                /* Signal declarations. */
+#include "CBTimeouts.h"                             /* Timeouts declarations. */
+#include "CBErrors.h"                         /* For system-wide error codes. */
+
+/* Exported macros -----------------------------------------------------------*/
+#define DBG_DEFINE_THIS_MODULE( name_ )
+#define DBG_printf( ... )
+#define LOG_printf( ... )
+#define WRN_printf( ... )
+#define ERR_printf( ... )
+#define dbg_slow_printf( ... )
+#define wrn_slow_printf( ... )
+#define isr_dbg_slow_printf( ... )
+
+/**< Formats into nothing, so the arguments still get evaluated and checked */
+#define ERR_COND_OUTPUT( status, accessType, fmt, ... ) do { \
+      if ( ERR_NONE != (status) ) {                             \
+         (void)snprintf( NULL, 0, fmt, ##__VA_ARGS__ );         \
+      }                                                         \
+   } while (0)
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                  /* PROJECT_INCLUDES_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,28 @@
+/**
+ * @file   stm32f4xx_it.h
+ * @brief  Host stand-in for the interrupt handler declarations.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The handlers are declared with __attribute__((__interrupt__)), which gcc
+ * doesn't take for x86 functions without arguments.  Nothing the host builds
+ * calls them.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef STM32F4XX_IT_H_
+#define STM32F4XX_IT_H_
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                     /* STM32F4XX_IT_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,37 @@
+/**
+ * @file   boot_prof_now.h
+ * @brief  Host stand-in for the cycle counter of the boot time profiler.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Force it in with -include so boot_prof.h finds BOOT_PROF_NOW() already
+ * defined and leaves the DWT out.  The test owns the counter and moves it.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef BOOT_PROF_NOW_H_
+#define BOOT_PROF_NOW_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported defines ----------------------------------------------------------*/
+/**< Read the fake cycle counter */
+#define BOOT_PROF_NOW()                                          ( BOOT_hostNow )
+
+/* Exported constants --------------------------------------------------------*/
+extern volatile uint32_t BOOT_hostNow;             /**< Defined by the test */
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                    /* BOOT_PROF_NOW_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
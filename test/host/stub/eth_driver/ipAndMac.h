@@ -0,0 +1,22 @@
+/**
+ * @file   ipAndMac.h
+ * @brief  Host stand-in for the addresses the firmware build generates for
+ * each board.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Empty, so lwipopts.h falls back on its default IP and MAC addresses.
+ */
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,65 @@
+/**
+ * @file   qp_port.h
+ * @brief  Host stand-in for QP, for building eth_driver.c without it.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * eth_driver.c only posts static events to LWIPMgr and takes a critical
+ * section.  Posts go to HOST_post(), which the program provides, and there's
+ * no interrupt to lock out since the simulated MAC runs its ISR in line.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef QP_PORT_H_
+#define QP_PORT_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported defines ----------------------------------------------------------*/
+#define DEV_DRIVER_SIG                             ( (QSignal)( 0xFFFFU - 32U ) )
+
+/* Exported macros -----------------------------------------------------------*/
+#define QACTIVE_POST( me_, e_, sender_ )       HOST_post( (me_), (e_) )
+#define QF_CRIT_STAT_TYPE                                                    int
+#define QF_CRIT_ENTRY( stat_ )                               ( (stat_) = 0 )
+#define QF_CRIT_EXIT( stat_ )                                ( (void)(stat_) )
+#define Q_DIM( array_ )             ( sizeof(array_) / sizeof((array_)[0]) )
+#define QS_OBJ_DICTIONARY( obj_ )
+
+/* Exported types ------------------------------------------------------------*/
+typedef uint16_t QSignal;
+
+typedef struct QEvt {
+   QSignal          sig;
+   uint8_t          poolId_;
+   uint8_t volatile refCtr_;
+} QEvt;
+
+typedef QEvt QEvent;
+
+typedef struct QActive QActive;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief   Post an event to an AO.  Provided by the program.
+ * @param [in] *me: QActive pointer to the AO.
+ * @param [in] *e: const QEvt pointer to the event.
+ * @return: None
+ */
+void HOST_post( QActive *me, QEvt const *e );
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                          /* QP_PORT_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
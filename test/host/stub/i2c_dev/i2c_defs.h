@@ -0,0 +1,95 @@
+/**
+ * @file   i2c_defs.h
+ * @brief  Host stand-in for the I2C definitions, with two I2C buses.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The board only has I2CBus1, so this adds a second bus to try the routing of
+ * i2c_dev.c with.  Force it in with -include ahead of everything else, since
+ * the real one sits next to i2c_dev.c and would be found first.  The guard is
+ * the same so the real one is skipped.  The device settings aren't const
+ * here so the test can lay the devices out over both buses.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef I2C_DEFS_H_
+#define I2C_DEFS_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported defines ----------------------------------------------------------*/
+#define MAX_I2C_WRITE_LEN     20  /**< Max size of the I2C buffer for writing */
+#define MAX_I2C_READ_LEN      20  /**< Max size of the I2C buffer for reading */
+
+#define EEPROM_PAGE_SIZE   16    /**< Size of the page in bytes on the EEPROM */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * I2C Operations available on the system.
+ */
+typedef enum I2C_Operations {
+   I2C_OP_NONE  = 0,                                /**< No current operation */
+   I2C_OP_MEM_READ,                    /**< Reading from an I2C device memory */
+   I2C_OP_MEM_WRITE,                     /**< Writing to an I2C device memory */
+   I2C_OP_REG_READ,                  /**< Reading from an I2C device register */
+   I2C_OP_REG_WRITE,                   /**< Writing to an I2C device register */
+} I2C_Operation_t;
+
+/**
+ * \enum I2C_Bus_t
+ * I2C Busses of the host test.
+ */
+typedef enum I2C_Busses {
+   I2CBus1  = 0,                                        /**< I2C Bus 1 (I2C1) */
+   I2CBus2,                                             /**< I2C Bus 2 (I2C2) */
+   MAX_I2C_BUS
+} I2C_Bus_t;
+
+/**
+ * @brief I2C_Device_t
+ * Same devices as the board.
+ */
+typedef enum I2C_Devices {
+   EEPROM  = 0,
+   SN_ROM,
+   EUI_ROM,
+   MAX_I2C_DEV
+} I2C_Dev_t;
+
+/**
+ * @brief I2C_DeviceSettings_t
+ * Same fields as the board, none of them const.
+ */
+typedef struct I2C_DeviceSettings
+{
+   I2C_Dev_t               i2c_dev;
+   I2C_Bus_t               i2c_bus;
+   uint16_t                i2c_dev_addr_size;
+   uint16_t                i2c_dev_addr;
+   uint8_t                 i2c_mem_addr_size;
+   uint16_t                i2c_mem_addr;
+   uint16_t                i2c_mem_min_addr;
+   uint16_t                i2c_mem_max_addr;
+   uint8_t                 i2c_mem_page_size;
+   bool                    i2c_mem_read_only;
+} I2C_DevSettings_t;
+
+/* Exported macros -----------------------------------------------------------*/
+#define IS_I2C_DEVICE( DEV )                  ( (uint32_t)(DEV) < MAX_I2C_DEV )
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                         /* I2C_DEFS_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
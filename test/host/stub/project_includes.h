@@ -0,0 +1,33 @@
+/**
+ * @file   project_includes.h
+ * @brief  Host stand-in for the project wide includes of the firmware.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * The real one pulls in QP, FreeRTOS and the debug console.  Vendor drivers
+ * built for the host only need the debug macros from it, which do nothing
+ * here.  Put this directory ahead of src/ on the include path.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PROJECT_INCLUDES_H_
+#define PROJECT_INCLUDES_H_
+
+/* Exported macros -----------------------------------------------------------*/
+#define DBG_DEFINE_THIS_MODULE( name_ )
+#define DBG_printf( ... )
+#define dbg_slow_printf( ... )
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                  /* PROJECT_INCLUDES_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,73 @@
+/**
+ * @file   task.h
+ * @brief  Host stand-in for the FreeRTOS task API.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * Only declares the calls the QF port, the tickless idle, the I2C device
+ * layer, the stack monitor and the CPU load accounting make.  A test defines the ones it links in, so
+ * it decides what the scheduler does.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TASK_H_
+#define TASK_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include "FreeRTOS.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*TaskFunction_t)( void *pvParameters );
+
+typedef enum
+{
+   eRunning = 0,
+   eReady,
+   eBlocked,
+   eSuspended,
+   eDeleted
+} eTaskState;
+
+/* Same as FreeRTOS v8.1.2 */
+typedef struct xTASK_STATUS
+{
+   TaskHandle_t xHandle;
+   const char *pcTaskName;
+   UBaseType_t xTaskNumber;
+   eTaskState eCurrentState;
+   UBaseType_t uxCurrentPriority;
+   UBaseType_t uxBasePriority;
+   uint32_t ulRunTimeCounter;
+   uint16_t usStackHighWaterMark;
+} TaskStatus_t;
+
+/* Exported functions --------------------------------------------------------*/
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName,
+      uint16_t usStackDepth, void * const pvParameters,
+      UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask );
+void vTaskDelete( TaskHandle_t xTaskToDelete );
+void vTaskStartScheduler( void );
+void vTaskSuspend( TaskHandle_t xTaskToSuspend );
+void vTaskResume( TaskHandle_t xTaskToResume );
+BaseType_t xTaskResumeFromISR( TaskHandle_t xTaskToResume );
+void vTaskStepTick( TickType_t xTicksToJump );
+void vTaskDelay( const TickType_t xTicksToDelay );
+TickType_t xTaskGetTickCount( void );
+UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask );
+TaskHandle_t xTaskGetIdleTaskHandle( void );
+UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
+      const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime );
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+#endif                                                             /* TASK_H_ */
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,472 @@
+/**
+ * @file   tickless_test.c
+ * @brief  Host test of the tickless idle keeping QF time events on time.
+ *
+ * @date   10/18/2026
+ * @author Harry Rostovtsev
+ * @email  rost0031@gmail.com
+ * Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+ *
+ * @addtogroup groupHostTest
+ * @{
+ *
+ * tickless.c is built with TICKLESS_SIM, so only TICKLESS_sleepTicks() and
+ * TICKLESS_step() are in, and runs against the real qf_tick.c, qte_*.c and
+ * the QF_ticksToExpiryX()/QF_tickStepX() of the FreeRTOS QF port.  The test
+ * stands in for the SysTick: a sleep of n ticks steps n - 1 ticks and then
+ * calls QF_TICK_X() for the tick that ends it, and an interrupt that wakes
+ * the core k ticks into a sleep steps k ticks and then runs its ISR in what
+ * is left of the current tick.
+ *
+ * - Long sleeps: one shot and periodic time events much longer than one
+ *   sleep post on exactly the tick they were armed for.
+ * - Early wakes: an ISR mid sleep arms, rearms or disarms a time event, and
+ *   both it and the one the sleep was headed for post on time.
+ * - Catch up: QF_ticksToExpiryX() sees events armed since the last tick and
+ *   ignores disarmed ones, QF_tickStepX() takes the skipped ticks off every
+ *   counter, and stepping as far as an expiry asserts.
+ * - Random: random arms, rearms, disarms, FreeRTOS delays and early wakes
+ *   post the same events on the same ticks as a plain tick does.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#define QP_IMPL
+#include "host_test.h"
+#include "qp_port.h"
+#include "qf_pkg.h"
+#include "tickless.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_SLEEP_TICKS         745      /**< SysTick from HCLK/8 at 180MHz */
+#define N_TE                    12
+#define MAX_POSTS               40000
+#define N_RAND_TICKS            200000UL
+#define N_RAND_SEEDS            4
+#define FOREVER                 0xFFFFFFFFUL   /**< No FreeRTOS task delayed */
+#define SIG_BASE                10
+
+/* Private typedefs ----------------------------------------------------------*/
+
+/**
+ * \struct Post_t
+ * A time event that got posted and the tick it got posted on.
+ */
+typedef struct Post {
+   uint32_t tick;
+   uint16_t sig;
+} Post_t;
+
+/* Private variables and Local objects ---------------------------------------*/
+static uint32_t  l_now;                  /**< Ticks FreeRTOS has counted */
+static uint32_t  l_freertosWake;         /**< Next task to unblock, or FOREVER */
+static uint32_t  l_nRealTicks;           /**< QF_TICK_X() calls */
+static QActive   l_ao;
+static QActiveVtbl l_vtbl;
+static QTimeEvt  l_te[N_TE];
+
+static Post_t    l_posts[2][MAX_POSTS];
+static int       l_nPosts[2];
+static int       l_run;                  /**< Which l_posts[] to log to */
+
+static jmp_buf   l_assertJmp;
+static bool      l_isAssertExpected;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* What the QF port and the tickless idle need from FreeRTOS and QF */
+void vTaskStepTick( TickType_t n )
+{
+   HT_CHECK_MSG( FOREVER == l_freertosWake || l_now + n < l_freertosWake,
+         "stepped %u ticks at %u past the FreeRTOS wake at %u", n, l_now,
+         l_freertosWake );
+   l_now += n;
+}
+void vTaskSuspend( TaskHandle_t t ) { (void)t; }
+void vTaskResume( TaskHandle_t t ) { (void)t; }
+BaseType_t xTaskResumeFromISR( TaskHandle_t t ) { (void)t; return( pdFALSE ); }
+void vTaskDelete( TaskHandle_t t ) { (void)t; }
+void vTaskStartScheduler( void ) { }
+BaseType_t xTaskCreate( TaskFunction_t fn, const char * const name,
+      uint16_t depth, void * const arg, UBaseType_t prio, TaskHandle_t * const pTask )
+{
+   (void)fn; (void)name; (void)depth; (void)arg; (void)prio; (void)pTask;
+   return( pdFALSE );
+}
+void QF_onStartup( void ) { }
+void QF_onCleanup( void ) { }
+
+void Q_onAssert( char_t const * const module, int_t location )
+{
+   if ( l_isAssertExpected ) {
+      longjmp( l_assertJmp, 1 );
+   }
+   fprintf( stderr, "assert %s:%d at tick %u\n", module, (int)location, l_now );
+   exit( 1 );
+}
+
+/******************************************************************************/
+bool QActive_post_( QActive * const me, QEvt const * const e,
+      uint_fast16_t const margin )
+{
+   (void)me; (void)margin;
+   if ( l_nPosts[l_run] < MAX_POSTS ) {
+      l_posts[l_run][l_nPosts[l_run]++] = (Post_t){ l_now, e->sig };
+   }
+   return( true );
+}
+
+/**
+ * @brief   The tick interrupt: count the tick and run the QF tick.
+ * @return: None
+ */
+static void tick( void )
+{
+   l_now++;
+   l_nRealTicks++;
+   QF_TICK_X( 0U, &l_ao );
+}
+
+/**
+ * @brief   What vPortSuppressTicksAndSleep() does, with the SysTick and WFI
+ * simulated.
+ * @param [in] expected: uint32_t ticks until a FreeRTOS task has to run.
+ * @param [in] wakeAfter: uint32_t whole ticks into the sleep some other
+ * interrupt comes in, or FOREVER for none.
+ * @return: bool true if the interrupt woke the core early.  The caller runs
+ * its ISR, in the tick after the l_now whole ones.
+ */
+static bool idle( uint32_t expected, uint32_t wakeAfter )
+{
+   TickType_t n = TICKLESS_sleepTicks( expected, MAX_SLEEP_TICKS );
+   if ( n < 2 ) {
+      if ( 0 == wakeAfter ) {
+         return( true );
+      }
+      tick();
+      return( false );
+   }
+   if ( wakeAfter < n ) {
+      TICKLESS_step( wakeAfter );
+      return( true );
+   }
+   TICKLESS_step( n - 1 );
+   tick();                                    /* The tick that ends the sleep */
+   return( false );
+}
+
+/**
+ * @brief   Start over with every time event disarmed and nothing posted.
+ * @return: None
+ */
+static void reset( void )
+{
+   memset( l_te, 0, sizeof(l_te) );
+   memset( QF_timeEvtHead_, 0, sizeof(QF_timeEvtHead_) );
+   for ( int i = 0; i < N_TE; i++ ) {
+      QTimeEvt_ctorX( &l_te[i], &l_ao, (QSignal)( SIG_BASE + i ), 0U );
+   }
+   l_now          = 0;
+   l_nRealTicks   = 0;
+   l_freertosWake = FOREVER;
+   l_nPosts[0]    = 0;
+   l_nPosts[1]    = 0;
+   l_run          = 0;
+}
+
+/******************************************************************************/
+static void testLongSleeps( void )
+{
+   static const uint16_t timeouts[] = {
+      2, 3, 100, MAX_SLEEP_TICKS - 1, MAX_SLEEP_TICKS, MAX_SLEEP_TICKS + 1,
+      2 * MAX_SLEEP_TICKS, 5000, 20011, 65535
+   };
+   int32_t maxErr = 0;
+
+   for ( size_t i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++ ) {
+      uint16_t t = timeouts[i];
+      reset();
+      l_now = 1000 + (uint32_t)i;            /* Doesn't start on a round tick */
+      uint32_t armed = l_now;
+      QTimeEvt_armX( &l_te[0], t, 0U );
+      while ( 0 == l_nPosts[0] && l_now < armed + t + 10 ) {
+         (void)idle( FOREVER, FOREVER );
+      }
+      HT_CHECK_MSG( 1 == l_nPosts[0], "%u tick timeout posted %d times", t,
+            l_nPosts[0] );
+      int32_t err = (int32_t)( l_posts[0][0].tick - ( armed + t ) );
+      HT_CHECK_MSG( 0 == err, "%u tick timeout posted %d ticks late", t, err );
+      if ( abs( err ) > abs( maxErr ) ) {
+         maxErr = err;
+      }
+
+      /* Only the tick that ends each sleep was a real one */
+      uint32_t nSleeps = ( t + MAX_SLEEP_TICKS - 1 ) / MAX_SLEEP_TICKS;
+      HT_CHECK_MSG( nSleeps == l_nRealTicks, "%u tick timeout took %u ticks",
+            t, l_nRealTicks );
+   }
+
+   /* Periodic, with the period longer than a sleep, and one off its phase */
+   reset();
+   QTimeEvt_armX( &l_te[0], 1000, 1000 );
+   QTimeEvt_armX( &l_te[1], 333, 1777 );
+   while ( l_now < 50000 ) {
+      (void)idle( FOREVER, FOREVER );
+   }
+   int n0 = 0, n1 = 0;
+   for ( int i = 0; i < l_nPosts[0]; i++ ) {
+      const Post_t *p = &l_posts[0][i];
+      if ( SIG_BASE == p->sig ) {
+         n0++;
+         HT_CHECK_MSG( (uint32_t)n0 * 1000 == p->tick, "period 1000 #%d at %u",
+               n0, p->tick );
+      } else {
+         HT_CHECK_MSG( 333 + (uint32_t)n1 * 1777 == p->tick,
+               "period 1777 #%d at %u", n1, p->tick );
+         n1++;
+      }
+   }
+   HT_CHECK( 50 == n0 && 28 == n1 );
+   HT_CHECK( l_nRealTicks < 50000 / 10 );
+
+   printf( "long sleeps: worst error %d ticks, %u real ticks of 50000\n",
+         maxErr, l_nRealTicks );
+}
+
+/******************************************************************************/
+static void testEarlyWake( void )
+{
+   /* 0: ISR arms a second event.  1: rearms the first one sooner.
+    * 2: rearms it later.  3: disarms it. */
+   for ( int what = 0; what < 4; what++ ) {
+      for ( uint32_t k = 0; k < MAX_SLEEP_TICKS; k += 37 ) {
+         reset();
+         QTimeEvt_armX( &l_te[0], 3000, 0U );
+         HT_CHECK( idle( FOREVER, k ) );
+         HT_CHECK( k == l_now && 0 == l_nRealTicks );
+
+         /* The ISR, in tick k + 1 */
+         uint32_t wake = l_now;
+         uint32_t want0 = 3000;
+         uint32_t want1 = 0;
+         switch ( what ) {
+            case 0: QTimeEvt_armX( &l_te[1], 25, 0U ); want1 = wake + 25; break;
+            case 1: QTimeEvt_rearm( &l_te[0], 10 ); want0 = wake + 10; break;
+            case 2: QTimeEvt_rearm( &l_te[0], 4000 ); want0 = wake + 4000; break;
+            default: QTimeEvt_disarm( &l_te[0] ); want0 = 0; break;
+         }
+
+         while ( l_now < 8000 ) {
+            (void)idle( FOREVER, FOREVER );
+         }
+         int nWant = ( 0 != want0 ) + ( 0 != want1 );
+         HT_CHECK_MSG( nWant == l_nPosts[0], "case %d wake %u: %d posts", what,
+               k, l_nPosts[0] );
+         for ( int i = 0; i < l_nPosts[0]; i++ ) {
+            const Post_t *p = &l_posts[0][i];
+            uint32_t want = ( SIG_BASE == p->sig ) ? want0 : want1;
+            HT_CHECK_MSG( want == p->tick, "case %d wake %u: sig %u at %u not %u",
+                  what, k, p->sig, p->tick, want );
+         }
+      }
+   }
+
+   /* A FreeRTOS delay ends the sleep before the time event does */
+   reset();
+   QTimeEvt_armX( &l_te[0], 600, 0U );
+   l_freertosWake = 200;
+   HT_CHECK( 200 == TICKLESS_sleepTicks( l_freertosWake - l_now, MAX_SLEEP_TICKS ) );
+   (void)idle( l_freertosWake - l_now, FOREVER );
+   HT_CHECK( 200 == l_now && 1 == l_nRealTicks );
+   l_freertosWake = FOREVER;
+   while ( 0 == l_nPosts[0] ) {
+      (void)idle( FOREVER, FOREVER );
+   }
+   HT_CHECK( 600 == l_posts[0][0].tick );
+}
+
+/******************************************************************************/
+static void testCatchUp( void )
+{
+   const TicklessStats_t *stats = TICKLESS_getStats();
+
+   reset();
+   HT_CHECK( 0 == QF_ticksToExpiryX( 0U ) );
+   HT_CHECK( 50 == TICKLESS_sleepTicks( 50, MAX_SLEEP_TICKS ) );
+   HT_CHECK( MAX_SLEEP_TICKS == TICKLESS_sleepTicks( FOREVER, MAX_SLEEP_TICKS ) );
+
+   /* Armed since the last tick, so still on the list of new arms */
+   QTimeEvt_armX( &l_te[0], 100, 0U );
+   QTimeEvt_armX( &l_te[1], 40, 0U );
+   HT_CHECK( (QTimeEvt *)0 == QF_timeEvtHead_[0].next );
+   HT_CHECK( 40 == QF_ticksToExpiryX( 0U ) );
+   HT_CHECK( 40 == TICKLESS_sleepTicks( FOREVER, MAX_SLEEP_TICKS ) );
+   HT_CHECK( 30 == TICKLESS_sleepTicks( 30, MAX_SLEEP_TICKS ) );
+   HT_CHECK( 20 == TICKLESS_sleepTicks( FOREVER, 20 ) );
+
+   uint32_t skipped = stats->nTicksSkipped;
+   TICKLESS_step( 39 );
+   HT_CHECK( 39 == l_now && skipped + 39 == stats->nTicksSkipped );
+   HT_CHECK( 61 == l_te[0].ctr && 1 == l_te[1].ctr );
+   HT_CHECK( 1 == QF_ticksToExpiryX( 0U ) );
+   tick();
+   HT_CHECK( 1 == l_nPosts[0] && 40 == l_posts[0][0].tick );
+
+   /* Now on the main list.  A disarmed one doesn't count. */
+   HT_CHECK( (QTimeEvt *)0 != QF_timeEvtHead_[0].next );
+   HT_CHECK( 60 == QF_ticksToExpiryX( 0U ) );
+   QTimeEvt_armX( &l_te[2], 5, 0U );
+   HT_CHECK( 5 == QF_ticksToExpiryX( 0U ) );
+   QTimeEvt_disarm( &l_te[2] );
+   HT_CHECK( 60 == QF_ticksToExpiryX( 0U ) );
+   TICKLESS_step( 0 );
+   HT_CHECK( 40 == l_now && 60 == l_te[0].ctr );
+   TICKLESS_step( 59 );
+   HT_CHECK( 1 == l_te[0].ctr && 0 == l_te[2].ctr );
+   tick();
+   HT_CHECK( 2 == l_nPosts[0] && 100 == l_posts[0][1].tick );
+   HT_CHECK( 0 == QF_ticksToExpiryX( 0U ) );
+
+   /* Stepping as far as an expiry would lose the post, so it asserts */
+   QTimeEvt_armX( &l_te[0], 10, 0U );
+   l_isAssertExpected = true;
+   if ( 0 == setjmp( l_assertJmp ) ) {
+      QF_tickStepX( 0U, 10 );
+      HT_CHECK_MSG( false, "stepping onto an expiry didn't assert" );
+   }
+   l_isAssertExpected = false;
+}
+
+/**
+ * @brief   A random arm, rearm or disarm, the same on both runs.
+ * @param [in] k: uint32_t what to do.
+ * @return: None
+ */
+static void action( uint32_t k )
+{
+   uint32_t r = ( k * 2654435761u ) ^ ( k >> 7 );
+   QTimeEvt *t = &l_te[r % N_TE];
+   QTimeEvtCtr n = (QTimeEvtCtr)( 1 + ( r >> 8 ) % ( ( ( r >> 20 ) & 1 ) ? 2000 : 60 ) );
+   switch ( ( r >> 4 ) % 4 ) {
+      case 0:
+         QTimeEvt_disarm( t );
+         break;
+      case 1:
+         QTimeEvt_rearm( t, n );
+         break;
+      default:
+         QTimeEvt_disarm( t );
+         QTimeEvt_armX( t, n, ( 0 == ( ( r >> 6 ) & 3 ) ) ? n : 0U );
+         break;
+   }
+}
+
+/******************************************************************************/
+static int cmpPost( const void *a, const void *b )
+{
+   const Post_t *x = a;
+   const Post_t *y = b;
+   if ( x->tick != y->tick ) {
+      return( x->tick < y->tick ? -1 : 1 );
+   }
+   return( (int)x->sig - (int)y->sig );
+}
+
+/**
+ * @brief   Run random arms and FreeRTOS delays once with a plain tick and once
+ * tickless, and compare what got posted on which tick.
+ * @param [in] seed: uint32_t seed of the run.
+ * @return: uint32_t ticks the tickless run skipped.
+ */
+static uint32_t testRandom( uint32_t seed )
+{
+   uint32_t skipped = 0;
+
+   reset();
+   for ( l_run = 0; l_run < 2; l_run++ ) {
+      memset( l_te, 0, sizeof(l_te) );
+      memset( QF_timeEvtHead_, 0, sizeof(QF_timeEvtHead_) );
+      for ( int i = 0; i < N_TE; i++ ) {
+         QTimeEvt_ctorX( &l_te[i], &l_ao, (QSignal)( SIG_BASE + i ), 0U );
+      }
+      uint32_t rnd = seed;
+      uint32_t nextAct = 1 + HT_rand( &rnd ) % 900;
+      uint32_t nAct = 0;
+      l_now = 0;
+      l_nRealTicks = 0;
+      l_freertosWake = 1 + HT_rand( &rnd ) % 3000;
+
+      while ( l_now < N_RAND_TICKS ) {
+         if ( l_now >= l_freertosWake ) {
+            l_freertosWake = l_now + 1 + HT_rand( &rnd ) % 3000;
+         }
+         if ( 0 == l_run ) {
+            if ( nextAct == l_now ) {
+               action( nAct++ );
+               nextAct = l_now + 1 + HT_rand( &rnd ) % 900;
+            }
+            tick();
+         } else if ( idle( l_freertosWake - l_now,
+               nextAct > l_now ? nextAct - l_now : 0 ) ) {
+            action( nAct++ );                  /* The ISR that woke the core */
+            nextAct = l_now + 1 + HT_rand( &rnd ) % 900;
+         }
+      }
+      if ( 1 == l_run ) {
+         skipped = l_now - l_nRealTicks;
+      }
+   }
+
+   /* Posts of one tick come in list order, which depends on when the arms
+    * got merged into the list, so only compare what got posted on which tick.
+    * The last sleep may run past the end of the plain run. */
+   for ( int r = 0; r < 2; r++ ) {
+      qsort( l_posts[r], l_nPosts[r], sizeof(Post_t), cmpPost );
+      while ( l_nPosts[r] > 0 && l_posts[r][l_nPosts[r] - 1].tick > N_RAND_TICKS ) {
+         l_nPosts[r]--;
+      }
+   }
+   HT_CHECK( l_nPosts[0] < MAX_POSTS );
+   HT_CHECK_MSG( l_nPosts[0] == l_nPosts[1], "seed %u: %d posts vs %d", seed,
+         l_nPosts[0], l_nPosts[1] );
+   for ( int i = 0; i < l_nPosts[0] && i < l_nPosts[1]; i++ ) {
+      const Post_t *a = &l_posts[0][i];
+      const Post_t *b = &l_posts[1][i];
+      if ( a->tick != b->tick || a->sig != b->sig ) {
+         HT_CHECK_MSG( false, "seed %u post %d: tick %u sig %u vs tick %u sig %u",
+               seed, i, a->tick, a->sig, b->tick, b->sig );
+         break;
+      }
+   }
+   return( skipped );
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main( void )
+{
+   l_vtbl.post = &QActive_post_;
+   l_ao.super.vptr = &l_vtbl.super;
+
+   testLongSleeps();
+   testEarlyWake();
+   testCatchUp();
+
+   for ( uint32_t s = 1; s <= N_RAND_SEEDS; s++ ) {
+      uint32_t skipped = testRandom( s * 4700 );
+      printf( "random seed %u: %d posts, %.1f%% of ticks skipped\n", s,
+            l_nPosts[0], 100.0 * skipped / N_RAND_TICKS );
+   }
+
+   return( HT_DONE( "tickless_test" ) );
+}
+
+/**
+ * @}
+ * end addtogroup groupHostTest
+ */
+
+/******** Copyright (C) 2026 Harry Rostovtsev. All rights reserved *****END OF FILE****/
@@ -0,0 +1,30 @@
+#!/usr/bin/env python
+
+# Captures the QS trace streamed by a spy build (make CONF=spy) over UDP into a
+# binary file that can then be decoded with "qspy -f<file>".  Any datagram sent
+# to the QSPY port tells the board where to stream the trace.
+
+import socket
+import sys
+
+UDP_IP = '172.27.0.3'
+UDP_PORT = 6601
+BUFFER_SIZE = 2048
+OUT_FILE = sys.argv[1] if len(sys.argv) > 1 else 'qs_trace.bin'
+
+s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+s.sendto("QSPY", (UDP_IP, UDP_PORT))
+
+f = open(OUT_FILE, 'wb')
+total = 0
+try:
+    while True:
+        data = s.recv(BUFFER_SIZE)
+        f.write(data)
+        total += len(data)
+except KeyboardInterrupt:
+    pass
+f.close()
+s.close()
+
+print "captured", total, "bytes of QS trace into", OUT_FILE
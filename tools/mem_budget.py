@@ -0,0 +1,499 @@
+#!/usr/bin/env python3
+#
+# @file   mem_budget.py
+# @brief  Static RAM/flash budget of a build, per subsystem, from the map file.
+#
+# @date   10/18/2026
+# @author Harry Rostovtsev
+# @email  rost0031@gmail.com
+# Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+#
+# Everything is compiled with -ffunction-sections -fdata-sections so the
+# "Linker script and memory map" part of the GNU ld map has an input section,
+# with its size, for every function and variable that was linked in.  That works
+# for the stripped rel and spy builds as well as dbg.  Input sections without
+# a symbol in their name (.bss, .data, COMMON, ...) are split between the
+# symbols listed under them by address.  Linker padding and space reserved by
+# the linker script itself (._user_heap_stack) show up as their own entries.
+#
+# Each symbol is put in the first category of mem_budget.cfg that matches it
+# and its size is added up per memory region of the linker script.  .data and
+# .ccmram count in RAM/CCMRAM and again in FLASH where their initial values are
+# kept.  ld gives .bss and ._user_heap_stack a load address in FLASH as well,
+# because they follow .data in RAM, but with nothing in them to load they only
+# count in RAM.
+#
+# Given a baseline (a --json file saved from an earlier build) it prints how
+# much every region, category and the symbols that moved the most grew or
+# shrank.  It exits with 1 when any limit in the config is broken, so a build
+# that runs it fails on a memory regression.
+#
+# Usage:
+#   mem_budget.py -c mem_budget.cfg [-b baseline.json] [-j out.json]
+#                 [-t N] [-v] [-w] dbg/coupler_board.map
+#
+
+from __future__ import print_function
+
+import sys
+import re
+import json
+import fnmatch
+import argparse
+
+try:
+    import configparser
+except ImportError:
+    import ConfigParser as configparser
+
+
+# Name of the category for symbols no rule in the config matches
+OTHER_CATEGORY = 'other'
+
+# Prefixes of input sections whose name is <prefix><symbol>
+SYM_SECTION_RE = re.compile(r'^\.(?:text|rodata|data|bss|ccmram|sdram)\.(.+)$')
+
+# Input sections that have no bytes in the image, only a size
+NOBITS_RE = re.compile(r'^(?:\.bss|\.noinit|COMMON$|fill$)')
+
+# Lines of the memory map
+OUT_SEC_RE  = re.compile(r'^(\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)'
+                         r'(?:\s+load address 0x([0-9a-fA-F]+))?)?\s*$')
+IN_SEC_RE   = re.compile(r'^ (\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)'
+                         r'(?:\s+(.+?))?)?\s*$')
+ADDR_LEN_RE = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)'
+                         r'(?:\s+load address 0x([0-9a-fA-F]+)|\s+(.+?))?\s*$')
+SYM_RE      = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)\s*$')
+MEM_RE      = re.compile(r'^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+
+
+class MapError(Exception):
+    pass
+
+
+class Region(object):
+    """A MEMORY region of the linker script."""
+    def __init__(self, name, origin, length):
+        self.name   = name
+        self.origin = origin
+        self.length = length
+        self.used   = 0
+
+    def holds(self, addr):
+        return self.origin <= addr < self.origin + self.length
+
+
+class Symbol(object):
+    """Something that takes up memory: a function, a variable or padding."""
+    def __init__(self, name, obj, outSec, size, regions):
+        self.name    = name
+        self.obj     = obj
+        self.outSec  = outSec
+        self.size    = size
+        self.regions = regions         # Regions it takes size bytes in
+        self.category = OTHER_CATEGORY
+
+
+def parse_map(path):
+    """Read a GNU ld map file.  Returns a list of Region and one of Symbol."""
+    try:
+        with open(path) as f:
+            lines = f.read().splitlines()
+    except IOError as e:
+        raise MapError("can't read %s: %s" % (path, e))
+
+    regions = []
+    i = 0
+    while i < len(lines) and lines[i].strip() != 'Memory Configuration':
+        i += 1
+    while i < len(lines) and lines[i].strip() != 'Linker script and memory map':
+        m = MEM_RE.match(lines[i])
+        if m and m.group(1) not in ('Name', '*default*'):
+            regions.append(Region(m.group(1), int(m.group(2), 16),
+                                  int(m.group(3), 16)))
+        i += 1
+    if not regions or i == len(lines):
+        raise MapError('%s is not a GNU ld map file' % path)
+
+    def region_of(addr):
+        for r in regions:
+            if r.holds(addr):
+                return r
+        return None
+
+    symbols = []
+    outSec  = None    # [name, vma region, lma region, size, size of inputs,
+                      #  its symbols, whether anything in it is loaded]
+    inSec   = None    # [name, addr, size, obj, [(addr, sym)]]
+    pending = None    # Name of a section whose numbers are on the next line
+
+    def close_in_sec():
+        if inSec is None or outSec is None or outSec[1] is None:
+            return
+        name, addr, size, obj, syms = inSec
+        if not NOBITS_RE.match(name):
+            outSec[6] = True
+        m = SYM_SECTION_RE.match(name)
+        if m or not syms:
+            sym = m.group(1) if m else '<%s>' % name
+            if sym.startswith('str1.'):
+                sym = '<strings>'
+            outSec[5].append(Symbol(sym, obj, outSec[0], size, [outSec[1]]))
+            return
+        # Whole .bss/.data/COMMON of a file: split it up by symbol address
+        syms.sort()
+        if syms[0][0] > addr:
+            syms.insert(0, (addr, '<%s>' % name))
+        for k, (a, s) in enumerate(syms):
+            end = syms[k + 1][0] if k + 1 < len(syms) else addr + size
+            if end > a:
+                outSec[5].append(Symbol(s, obj, outSec[0], end - a,
+                                        [outSec[1]]))
+
+    def close_out_sec():
+        if outSec is None or outSec[1] is None:
+            return
+        # Space the linker script reserved itself, like the main stack
+        if outSec[3] > outSec[4]:
+            outSec[5].append(Symbol('<%s>' % outSec[0], '(linker script)',
+                                    outSec[0], outSec[3] - outSec[4],
+                                    [outSec[1]]))
+        where = [outSec[1]]
+        if outSec[6] and outSec[2] is not None and outSec[2] != outSec[1]:
+            where.append(outSec[2])
+        for r in where:
+            r.used += outSec[3]
+        for sym in outSec[5]:
+            sym.regions = where
+        symbols.extend(outSec[5])
+
+    for line in lines[i + 1:]:
+        if line.startswith('OUTPUT(') or line.startswith('Cross Reference'):
+            break
+        if not line.strip() or line.startswith('LOAD ') or \
+                line.startswith('START GROUP') or line.startswith('END GROUP'):
+            continue
+
+        if pending is not None:
+            m = ADDR_LEN_RE.match(line)
+            pendName, pendIsOut = pending
+            pending = None
+            if m:
+                if pendIsOut:
+                    close_in_sec(); inSec = None
+                    close_out_sec()
+                    addr = int(m.group(1), 16)
+                    lma = int(m.group(3), 16) if m.group(3) else None
+                    outSec = [pendName, region_of(addr),
+                              region_of(lma) if lma is not None else None,
+                              int(m.group(2), 16), 0, [], False]
+                else:
+                    close_in_sec()
+                    inSec = [pendName, int(m.group(1), 16),
+                             int(m.group(2), 16), (m.group(4) or '').strip(),
+                             []]
+                    if outSec is not None:
+                        outSec[4] += inSec[2]
+                continue
+
+        if not line[0].isspace():
+            m = OUT_SEC_RE.match(line)
+            if not m or '=' in line:
+                continue
+            close_in_sec(); inSec = None
+            if m.group(2) is None:
+                close_out_sec(); outSec = None
+                pending = (m.group(1), True)
+                continue
+            close_out_sec()
+            addr = int(m.group(2), 16)
+            lma = int(m.group(4), 16) if m.group(4) else None
+            outSec = [m.group(1), region_of(addr),
+                      region_of(lma) if lma is not None else None,
+                      int(m.group(3), 16), 0, [], False]
+            continue
+
+        m = SYM_RE.match(line)
+        if m:
+            if inSec is not None:
+                inSec[4].append((int(m.group(1), 16), m.group(2)))
+            continue
+
+        m = IN_SEC_RE.match(line)
+        if m and (m.group(1)[0] == '.' or
+                  m.group(1) in ('COMMON', '*fill*')):
+            name = m.group(1)
+            if m.group(2) is None:
+                close_in_sec(); inSec = None
+                pending = (name, False)
+                continue
+            close_in_sec()
+            size = int(m.group(3), 16)
+            obj  = (m.group(4) or '').strip()
+            if name == '*fill*':
+                name, obj = 'fill', '(padding)'
+            inSec = [name, int(m.group(2), 16), size, obj, []]
+            if outSec is not None:
+                outSec[4] += size
+            continue
+
+    close_in_sec()
+    close_out_sec()
+    return regions, [s for s in symbols if s.size > 0]
+
+
+class Category(object):
+    """A subsystem: the rules for its symbols and its limits."""
+    def __init__(self, name):
+        self.name     = name
+        self.symbols  = []
+        self.objects  = []
+        self.sections = []
+        self.limits   = {}         # Option name from the config -> value
+        self.sizes    = {}         # Region name -> bytes
+
+    def matches(self, sym):
+        # lib.a(member.o) matches both lib.a and member.o
+        names = [sym.obj.replace('\\', '/').split('/')[-1]]
+        if names[0].endswith(')') and '(' in names[0]:
+            names = names[0][:-1].split('(', 1)
+        return any(fnmatch.fnmatchcase(sym.name, p) for p in self.symbols) or \
+               any(fnmatch.fnmatchcase(n, p)
+                   for n in names for p in self.objects) or \
+               any(fnmatch.fnmatchcase(sym.outSec, p) for p in self.sections)
+
+
+def load_config(path):
+    """Read the categories and the limits.  Returns (categories, limits)."""
+    cp = configparser.RawConfigParser()
+    if not cp.read(path):
+        raise MapError("can't read %s" % path)
+    categories = []
+    limits = {}
+    for sec in cp.sections():
+        if sec == 'limits':
+            limits = dict(cp.items(sec))
+            continue
+        if not sec.startswith('category '):
+            raise MapError('%s: unknown section [%s]' % (path, sec))
+        cat = Category(sec.split(None, 1)[1].strip())
+        for key, val in cp.items(sec):
+            if key in ('symbols', 'objects', 'sections'):
+                getattr(cat, key).extend(val.split())
+            else:
+                cat.limits[key] = val
+        categories.append(cat)
+    if not any(c.name == OTHER_CATEGORY for c in categories):
+        categories.append(Category(OTHER_CATEGORY))
+    return categories, limits
+
+
+def categorize(categories, symbols):
+    byName = dict((c.name, c) for c in categories)
+    for sym in symbols:
+        for cat in categories:
+            if cat.matches(sym):
+                sym.category = cat.name
+                break
+        cat = byName[sym.category]
+        for r in sym.regions:
+            cat.sizes[r.name] = cat.sizes.get(r.name, 0) + sym.size
+
+
+def symbol_sizes(symbols):
+    """Bytes per symbol and region, keyed the same way as in the json."""
+    out = {}
+    for s in symbols:
+        key = '%s %s' % (s.name, s.obj.replace('\\', '/').split('/')[-1])
+        d = out.setdefault(key, {})
+        for r in s.regions:
+            d[r.name] = d.get(r.name, 0) + s.size
+    return out
+
+
+def to_json(regions, categories, symbols):
+    return {
+        'regions': dict((r.name, {'used': r.used, 'size': r.length})
+                        for r in regions),
+        'categories': dict((c.name, c.sizes) for c in categories),
+        'symbols': symbol_sizes(symbols),
+    }
+
+
+def parse_limit(text, size):
+    """A limit in bytes, or in % of size.  Accepts 1234, 0x400, 12K, 95%."""
+    text = text.strip()
+    if text.endswith('%'):
+        return int(size * float(text[:-1]) / 100)
+    mult = 1
+    if text[-1:] in ('k', 'K'):
+        mult, text = 1024, text[:-1]
+    return int(text, 0) * mult
+
+
+def check_limits(regions, categories, limits, base):
+    """Returns the list of broken limits as strings."""
+    errors = []
+    regByName = dict((r.name.lower(), r) for r in regions)
+
+    def check(what, key, val, now, was):
+        region, _, kind = key.partition('.')
+        r = regByName.get(region)
+        if r is None:
+            errors.append('limit %s of %s is for a region not in the map' %
+                          (key, what))
+            return
+        try:
+            lim = parse_limit(val, r.length)
+        except ValueError:
+            errors.append('bad limit %s = %s for %s' % (key, val, what))
+            return
+        if kind == 'max':
+            if now(r) > lim:
+                errors.append('%s uses %d bytes of %s, limit is %d' %
+                              (what, now(r), r.name, lim))
+        elif kind == 'max_growth':
+            if was is not None and now(r) - was(r) > lim:
+                errors.append('%s grew by %d bytes in %s, limit is %d' %
+                              (what, now(r) - was(r), r.name, lim))
+        else:
+            errors.append('unknown limit %s for %s' % (key, what))
+
+    for key, val in sorted(limits.items()):
+        check('region', key, val, lambda r: r.used,
+              None if base is None else
+              lambda r: base['regions'].get(r.name, {}).get('used', 0))
+
+    for cat in categories:
+        for key, val in sorted(cat.limits.items()):
+            check(cat.name, key, val, lambda r: cat.sizes.get(r.name, 0),
+                  None if base is None else
+                  lambda r: base['categories'].get(cat.name, {}).get(r.name, 0))
+    return errors
+
+
+def fmt_delta(now, was):
+    if was is None:
+        return ''
+    return '%+d' % (now - was) if now != was else ''
+
+
+def report(mapPath, regions, categories, symbols, base, top, verbose):
+    shown = [r for r in regions if r.used or
+             any(c.sizes.get(r.name) for c in categories)]
+    out = []
+    out.append('Memory budget of %s%s' %
+               (mapPath, ', against baseline' if base else ''))
+    out.append('')
+    out.append('%-10s %10s %10s %7s %9s' %
+               ('Region', 'Used', 'Size', 'Used%', 'Delta'))
+    for r in shown:
+        was = None
+        if base is not None:
+            was = base['regions'].get(r.name, {}).get('used', 0)
+        out.append('%-10s %10d %10d %6.1f%% %9s' %
+                   (r.name, r.used, r.length, 100.0 * r.used / r.length,
+                    fmt_delta(r.used, was)))
+
+    out.append('')
+    hdr = '%-18s' % 'Category'
+    for r in shown:
+        hdr += ' %9s %8s' % (r.name, '')
+    out.append(hdr.rstrip())
+    for cat in categories:
+        if not cat.sizes and (base is None or
+                              not base['categories'].get(cat.name)):
+            continue
+        line = '%-18s' % cat.name
+        for r in shown:
+            was = None
+            if base is not None:
+                was = base['categories'].get(cat.name, {}).get(r.name, 0)
+            line += ' %9d %8s' % (cat.sizes.get(r.name, 0),
+                                  fmt_delta(cat.sizes.get(r.name, 0), was))
+        out.append(line.rstrip())
+
+        mine = [s for s in symbols if s.category == cat.name]
+        mine.sort(key=lambda s: -s.size)
+        for s in mine if verbose else mine[:top]:
+            out.append('    %-40s %8d  %s  %s' %
+                       (s.name, s.size, '+'.join(r.name for r in s.regions),
+                        s.obj.replace('\\', '/').split('/')[-1]))
+
+    if base is not None and top:
+        now = symbol_sizes(symbols)
+        was = base.get('symbols', {})
+        moved = []
+        for key in set(now) | set(was):
+            a, b = now.get(key, {}), was.get(key, {})
+            for reg in set(a) | set(b):
+                d = a.get(reg, 0) - b.get(reg, 0)
+                if d:
+                    moved.append((-abs(d), key, reg, d))
+        if moved:
+            out.append('')
+            out.append('Biggest changes since the baseline:')
+            for _, key, reg, d in sorted(moved)[:top]:
+                out.append('    %-50s %-7s %+8d' % (key, reg, d))
+    return '\n'.join(out)
+
+
+def main(argv):
+    ap = argparse.ArgumentParser(
+        description='Static RAM/flash budget of a build from its map file.')
+    ap.add_argument('map', help='map file written by the linker')
+    ap.add_argument('-c', '--config', required=True,
+                    help='categories and limits')
+    ap.add_argument('-b', '--baseline',
+                    help='json saved by an earlier run to compare against')
+    ap.add_argument('-j', '--json', help='save the budget as json here')
+    ap.add_argument('-t', '--top', type=int, default=3,
+                    help='biggest symbols to list per category')
+    ap.add_argument('-v', '--verbose', action='store_true',
+                    help='list every symbol of every category')
+    ap.add_argument('-w', '--warn-only', action='store_true',
+                    help='report broken limits but exit with 0')
+    args = ap.parse_args(argv)
+
+    try:
+        regions, symbols = parse_map(args.map)
+        categories, limits = load_config(args.config)
+    except MapError as e:
+        print('mem_budget: %s' % e, file=sys.stderr)
+        return 2
+
+    base = None
+    if args.baseline:
+        try:
+            with open(args.baseline) as f:
+                base = json.load(f)
+        except IOError:
+            print('mem_budget: no baseline %s yet, not comparing' %
+                  args.baseline)
+        except ValueError as e:
+            print('mem_budget: bad baseline %s: %s' % (args.baseline, e),
+                  file=sys.stderr)
+            return 2
+
+    categorize(categories, symbols)
+    print(report(args.map, regions, categories, symbols, base, args.top,
+                 args.verbose))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(to_json(regions, categories, symbols), f, indent=1,
+                      sort_keys=True)
+
+    errors = check_limits(regions, categories, limits, base)
+    if errors:
+        print('')
+        for e in errors:
+            print('mem_budget: %s: %s' %
+                  ('WARNING' if args.warn_only else 'ERROR', e))
+        if not args.warn_only:
+            return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
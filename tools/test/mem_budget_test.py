@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+#
+# @file   mem_budget_test.py
+# @brief  Test of mem_budget.py on a hand written map file.
+#
+# @date   10/18/2026
+# @author Harry Rostovtsev
+# @email  rost0031@gmail.com
+# Copyright (C) 2026 Harry Rostovtsev. All rights reserved.
+#
+# mem_budget_test.map is laid out like the map of the firmware with its own
+# linker script and mem_budget.cfg, and has every kind of line the parser has
+# to get right:
+#
+# - Section names too long for their line, with the numbers on the next one,
+#   for input sections and for ._user_heap_stack.
+# - A COMMON and a whole .bss and .data of a file, split up by symbol address,
+#   and linker padding (*fill*).
+# - .data and .ccmram with a load address in FLASH, and .bss and
+#   ._user_heap_stack with one they take no FLASH at.
+# - The NOLOAD .sdram, sections outside of every region and discarded ones.
+#
+# It runs the script the way the build does and checks the json it saves and
+# its exit code, against a baseline that breaks a max_growth and with -w.
+#
+# Usage:
+#   mem_budget_test.py          (make host_test runs it)
+#
+
+import os
+import sys
+import json
+import shutil
+import tempfile
+import subprocess
+
+HERE    = os.path.dirname(os.path.abspath(__file__))
+SCRIPT  = os.path.join(HERE, '..', 'mem_budget.py')
+CONFIG  = os.path.join(HERE, '..', 'mem_budget.cfg')
+MAP     = os.path.join(HERE, 'mem_budget_test.map')
+
+nChecks = 0
+nFailed = 0
+
+
+def check(cond, what):
+    global nChecks, nFailed
+    nChecks += 1
+    if not cond:
+        nFailed += 1
+        print('%s: check failed: %s' % (os.path.basename(__file__), what),
+              file=sys.stderr)
+
+
+def run(tmp, *args):
+    """Run mem_budget.py on the map.  Returns (exit code, stdout, json)."""
+    out = os.path.join(tmp, 'out.json')
+    if os.path.exists(out):
+        os.remove(out)
+    p = subprocess.run([sys.executable, SCRIPT, '-c', CONFIG, '-j', out] +
+                       list(args) + [MAP], stdout=subprocess.PIPE,
+                       stderr=subprocess.STDOUT, universal_newlines=True)
+    budget = None
+    if os.path.exists(out):
+        with open(out) as f:
+            budget = json.load(f)
+    return p.returncode, p.stdout, budget
+
+
+def save(tmp, budget):
+    path = os.path.join(tmp, 'base.json')
+    with open(path, 'w') as f:
+        json.dump(budget, f)
+    return path
+
+
+def test_parse(tmp):
+    """Sizes of every region, symbol and category the map adds up to."""
+    rc, text, b = run(tmp)
+    check(0 == rc, 'exit code %d\n%s' % (rc, text))
+    check(b is not None, 'no json')
+    if b is None:
+        return
+
+    used = dict((k, v['used']) for k, v in b['regions'].items())
+    check({'FLASH':  0x1ac + 0x1000 + 0x150 + 0x20 + 0x400,
+           'RAM':    0x20 + 0x5100 + 0x2000,
+           'CCMRAM': 0x400,
+           'SDRAM':  0x11c50} == used, 'regions %s' % used)
+
+    expected = {
+        # Numbers on the next line
+        'CommStackMgr_Active_processRequestEVT CommStackMgr.o':
+            {'FLASH': 0x300},
+        'l_CommStackMgrQueueSto main.o':        {'RAM': 0x80},
+        '<._user_heap_stack> (linker script)':  {'RAM': 0x2000},
+        # Split by the symbols under them
+        'g_pfnVectors startup_stm32f429_439xx.o': {'FLASH': 0x1ac},
+        'l_serialMgr SerialMgr.o':              {'RAM': 0x40},
+        'l_serialRxBuf SerialMgr.o':            {'RAM': 0xc0},
+        'netif_default lwip.o':                 {'RAM': 0x40},
+        'ram_heap lwip.o':                      {'RAM': 0xf40},
+        '_impure_ptr libc_nano.a(lib_a-impure.o)': {'RAM': 4, 'FLASH': 4},
+        'impure_data libc_nano.a(lib_a-impure.o)': {'RAM': 0xc, 'FLASH': 0xc},
+        '<fill> (padding)':                     {'FLASH': 0x10},
+        '<strings> main.o':                     {'FLASH': 0x50},
+        # Load address in FLASH, with and without anything to load
+        'l_counter main.o':                     {'RAM': 4, 'FLASH': 4},
+        'dbgCntrlSettings dbg_cntrl.o':         {'RAM': 0xc, 'FLASH': 0xc},
+        'l_evtRecBuf evt_rec.o':                {'CCMRAM': 0x400,
+                                                 'FLASH': 0x400},
+        'ucHeap heap_4.o':                      {'RAM': 0x4000},
+        # NOLOAD
+        'sdRamTestBuffer sdram.o':              {'SDRAM': 0x9c40},
+        'EVT_REC_ring evt_rec.o':               {'SDRAM': 0x8010},
+        # Members of libraries
+        'memcpy libc_nano.a(lib_a-memcpy.o)':   {'FLASH': 0x40},
+        'QActive_post_ libqp_cortex-m4f.a(qf_actq.o)': {'FLASH': 0x9b0},
+        'main main.o':                          {'FLASH': 0x100},
+        'I2C1DevMgr_ctor I2C1DevMgr.o':         {'FLASH': 0x200},
+        'l_commCmdTbl CommStackMgr.o':          {'FLASH': 0x100},
+    }
+    for key in sorted(set(expected) | set(b['symbols'])):
+        check(expected.get(key) == b['symbols'].get(key),
+              '%s is %s, not %s' % (key, b['symbols'].get(key),
+                                    expected.get(key)))
+
+    # Everything in a region is some symbol
+    total = {}
+    for sizes in b['symbols'].values():
+        for r, n in sizes.items():
+            total[r] = total.get(r, 0) + n
+    check(total == used, 'symbols add up to %s' % total)
+
+    cats = dict((k, v) for k, v in b['categories'].items() if v)
+    check({'qp_evt_queues': {'RAM': 0x80},
+           'rtos_heap':     {'RAM': 0x4000},
+           'main_stack':    {'RAM': 0x2000},
+           'lwip_heap':     {'RAM': 0xf40},
+           'serial':        {'RAM': 0x100},
+           'lwip':          {'RAM': 0x40},
+           'i2c':           {'FLASH': 0x200},
+           'comm':          {'FLASH': 0x400},
+           'debug_log':     {'RAM': 0xc, 'FLASH': 0x40c, 'CCMRAM': 0x400,
+                             'SDRAM': 0x8010},
+           'qp':            {'FLASH': 0x9b0},
+           'bsp':           {'FLASH': 0x1ac, 'SDRAM': 0x9c40},
+           'libc':          {'FLASH': 0x50, 'RAM': 0x10},
+           'other':         {'FLASH': 0x164, 'RAM': 4}} == cats,
+          'categories %s' % cats)
+    return b
+
+
+def test_baseline(tmp, b):
+    """Growth against a baseline, the exit code and -w."""
+    rc, text, _ = run(tmp, '-b', os.path.join(tmp, 'none.json'))
+    check(0 == rc and 'no baseline' in text, 'missing baseline: %d' % rc)
+
+    rc, text, _ = run(tmp, '-b', save(tmp, b))
+    check(0 == rc, 'same as the baseline: %d\n%s' % (rc, text))
+    check('Biggest changes' not in text, 'changes listed\n%s' % text)
+
+    # Growing by what a limit lets it is fine
+    was = json.loads(json.dumps(b))
+    was['regions']['RAM']['used'] -= 2048
+    rc, text, _ = run(tmp, '-b', save(tmp, was))
+    check(0 == rc, 'RAM grew by 2K: %d\n%s' % (rc, text))
+
+    # One more byte than that, and an event queue that grew at all
+    was['regions']['RAM']['used'] -= 1
+    was['categories']['qp_evt_queues']['RAM'] -= 16
+    was['symbols']['l_CommStackMgrQueueSto main.o']['RAM'] -= 16
+    base = save(tmp, was)
+    rc, text, _ = run(tmp, '-b', base)
+    check(1 == rc, 'over the limits: %d' % rc)
+    check('ERROR: region grew by 2049 bytes in RAM, limit is 2048' in text,
+          'no region error\n%s' % text)
+    check('ERROR: qp_evt_queues grew by 16 bytes in RAM, limit is 0' in text,
+          'no category error\n%s' % text)
+    check('l_CommStackMgrQueueSto main.o' in
+          text[text.find('Biggest changes'):], 'not listed\n%s' % text)
+
+    rc, text, out = run(tmp, '-b', base, '-w')
+    check(0 == rc, '-w exit code %d' % rc)
+    check('WARNING: qp_evt_queues grew by 16 bytes in RAM' in text and
+          'ERROR' not in text, '-w\n%s' % text)
+    check(b == out, '-w saved a different json')
+
+    with open(base, 'w') as f:
+        f.write('{ not json')
+    rc, text, _ = run(tmp, '-b', base)
+    check(2 == rc, 'bad baseline: %d' % rc)
+
+
+def main():
+    tmp = tempfile.mkdtemp()
+    try:
+        b = test_parse(tmp)
+        if b is not None:
+            test_baseline(tmp, b)
+    finally:
+        shutil.rmtree(tmp)
+    print('%-16s %6u checks, %u failed' % ('mem_budget_test', nChecks,
+                                           nFailed))
+    return 1 if nFailed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())